@@ -15,6 +15,15 @@
 // DEFAULT_CONFIG_FILE
 /// Default configuration file
 #define DEFAULT_CONFIG_FILE PROJECT_ROOT_PATH L"\\" PROJECT_SAFE_NAME L"\\" PROJECT_SAFE_NAME L".XML"
+// CONFIG_STREAM_BLOCK_SIZE
+/// Default size, in bytes, of the blocks read when loading configuration from a file
+#define CONFIG_STREAM_BLOCK_SIZE 0x1000
+// CONFIG_BPLIST_MAGIC
+/// The signature at the start of a binary property list
+#define CONFIG_BPLIST_MAGIC "bplist00"
+// CONFIG_BPLIST_MAGIC_SIZE
+/// The size, in bytes, of the binary property list signature
+#define CONFIG_BPLIST_MAGIC_SIZE 8
 
 // CONFIG_TYPE
 /// Configuration value type
@@ -111,6 +120,23 @@ ConfigLoad (
   IN EFI_FILE_HANDLE  Root OPTIONAL,
   IN CHAR16          *Path OPTIONAL
 );
+// ConfigLoadStream
+/// Load configuration information from an open file handle by parsing fixed size blocks
+/// @param Handle    The file handle from which to read the configuration
+/// @param BlockSize The size, in bytes, of each block to read or zero for CONFIG_STREAM_BLOCK_SIZE
+/// @param Source    The unique source name
+/// @return Whether the configuration was loaded successfully or not
+/// @retval EFI_INVALID_PARAMETER If Handle is NULL or BlockSize is less than CONFIG_BPLIST_MAGIC_SIZE
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_NOT_FOUND         If the configuration file was empty
+/// @retval EFI_SUCCESS           If the configuration file was loaded successfully
+EFI_STATUS
+EFIAPI
+ConfigLoadStream (
+  IN EFI_FILE_HANDLE  Handle,
+  IN UINTN            BlockSize OPTIONAL,
+  IN CHAR16          *Source OPTIONAL
+);
 // ConfigParse
 /// Parse configuration information from string
 /// @param Size   The size, in bytes, of the configuration string
@@ -139,6 +165,87 @@ ConfigParseXml (
   IN XML_TREE *Tree,
   IN CHAR16   *Source OPTIONAL
 );
+// ConfigParsePlist
+/// Parse configuration information from an XML or binary property list
+/// @param Size   The size, in bytes, of the property list
+/// @param Plist  The property list to parse
+/// @param Source The unique source name
+/// @return Whether the configuration was parsed successfully or not
+/// @retval EFI_INVALID_PARAMETER If Plist is NULL, Size is zero, or the property list is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the property list was parsed successfully
+EFI_STATUS
+EFIAPI
+ConfigParsePlist (
+  IN UINTN   Size,
+  IN VOID   *Plist,
+  IN CHAR16 *Source OPTIONAL
+);
+// ConfigParsePlistXml
+/// Parse configuration information from an XML property list document tree
+/// @param Tree   The XML document tree to parse, the root node must be plist
+/// @param Source The unique source name
+/// @return Whether the configuration was parsed successfully or not
+/// @retval EFI_INVALID_PARAMETER If Tree is NULL or the property list is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the property list was parsed successfully
+EFI_STATUS
+EFIAPI
+ConfigParsePlistXml (
+  IN XML_TREE *Tree,
+  IN CHAR16   *Source OPTIONAL
+);
+// ConfigParseBinaryPlist
+/// Parse configuration information from a binary property list, objects are decoded in place through the offset table
+/// @param Size   The size, in bytes, of the binary property list
+/// @param Plist  The binary property list to parse
+/// @param Source The unique source name
+/// @return Whether the configuration was parsed successfully or not
+/// @retval EFI_INVALID_PARAMETER If Plist is NULL or the binary property list is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the binary property list was parsed successfully
+EFI_STATUS
+EFIAPI
+ConfigParseBinaryPlist (
+  IN UINTN   Size,
+  IN VOID   *Plist,
+  IN CHAR16 *Source OPTIONAL
+);
+// ConfigParseJson
+/// Parse configuration information from JSON in a single pass without building a document,
+///  object members are paths and array members are indexed like configuration groups, no values are set
+///  unless the whole JSON is valid
+/// @param Size   The size, in bytes, of the JSON
+/// @param Json   The JSON to parse
+/// @param Source The unique source name
+/// @return Whether the configuration was parsed successfully or not
+/// @retval EFI_INVALID_PARAMETER If Json is NULL, Size is zero, or the JSON is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the JSON was parsed successfully
+EFI_STATUS
+EFIAPI
+ConfigParseJson (
+  IN UINTN   Size,
+  IN VOID   *Json,
+  IN CHAR16 *Source OPTIONAL
+);
+// ConfigParseIni
+/// Parse configuration information from INI, sections are paths and values are typed by their text, no
+///  values are set unless the whole INI is valid
+/// @param Size   The size, in bytes, of the INI
+/// @param Ini    The INI to parse
+/// @param Source The unique source name
+/// @return Whether the configuration was parsed successfully or not
+/// @retval EFI_INVALID_PARAMETER If Ini is NULL, Size is zero, or the INI is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the INI was parsed successfully
+EFI_STATUS
+EFIAPI
+ConfigParseIni (
+  IN UINTN   Size,
+  IN VOID   *Ini,
+  IN CHAR16 *Source OPTIONAL
+);
 
 // ConfigFree
 /// Free all configuration values
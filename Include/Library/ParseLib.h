@@ -42,6 +42,19 @@
 // LANG_TOKEN_MAX_COUNT
 /// The maximum token count per state rule
 #define LANG_TOKEN_MAX_COUNT 0x10
+// LANG_DECODE_MAX_SEQUENCE
+/// The maximum size, in bytes, of an encoded character sequence that may be split across buffers
+#define LANG_DECODE_MAX_SEQUENCE 4
+// LANG_MESSAGE_MAX_COUNT
+/// The maximum count of messages retained by a parser, the oldest messages are dropped first
+#define LANG_MESSAGE_MAX_COUNT 32
+
+// LANG_MESSAGE_ERROR
+/// Language error message
+#define LANG_MESSAGE_ERROR 1
+// LANG_MESSAGE_WARNING
+/// Language warning message
+#define LANG_MESSAGE_WARNING 2
 
 // DECL_LANG_RULE
 /// Declare a static state rule
@@ -88,6 +101,23 @@ typedef struct _LANG_STATE LANG_STATE;
 /// Language parser
 typedef struct _LANG_PARSER LANG_PARSER;
 
+// LANG_POSITION
+/// Language parser input position
+typedef struct _LANG_POSITION LANG_POSITION;
+struct _LANG_POSITION {
+
+  // Offset
+  /// The offset of the character in the decoded input in characters
+  UINTN Offset;
+  // Line
+  /// The line of the character, starting at one
+  UINTN Line;
+  // Column
+  /// The column of the character in the line, starting at one
+  UINTN Column;
+
+};
+
 // LANG_CALLBACK
 /// Token parsed callback
 /// @param Parser  The language parser
@@ -103,6 +133,22 @@ typedef EFI_STATUS
   IN     CHAR16      *Token,
   IN     VOID        *Context OPTIONAL
 );
+// LANG_DECODE
+/// Character decoder, decodes characters from an encoded buffer in bulk
+/// @param Size       The size, in bytes, of the encoded buffer
+/// @param Buffer     The encoded buffer
+/// @param Used       On output, the size, in bytes, of the buffer that was used, any remaining bytes are an incomplete character sequence
+/// @param Count      On input, the maximum count of characters to decode, on output, the count of characters decoded
+/// @param Characters On output, the decoded characters
+typedef VOID
+(EFIAPI
+*LANG_DECODE) (
+  IN     UINTN   Size,
+  IN     UINT8  *Buffer,
+  OUT    UINTN  *Used,
+  IN OUT UINTN  *Count,
+  OUT    UINT32 *Characters
+);
 
 // LANG_STATIC_RULE
 /// Static information for state rule
@@ -182,8 +228,8 @@ Parse (
   IN     BOOLEAN      SwapBytes,
   IN     VOID        *Context OPTIONAL
 );
-// ParseUtf8
-/// Parse a UTF-8 string for tokens
+// ParseEncoding
+/// Parse an encoded string for tokens
 /// @param Parser   The language parser to use in parsing
 /// @param Count    The count of characters in the string or NULL if the string is null-terminated
 /// @param String   The string to parse
@@ -204,16 +250,16 @@ ParseEncoding (
   IN     VOID        *Context OPTIONAL
 );
 // ParseBuffer
-/// Parse a buffer for tokens
+/// Parse a buffer for tokens, a character sequence split at the end of the buffer is retained to be completed by the next buffer
 /// @param Parser   The language parser to use in parsing
 /// @param Size     The size, in bytes, of the buffer
 /// @param Buffer   The buffer to parse
-/// @param Encoding The encoding of the buffer or NULL to try detecting the encoding
+/// @param Encoding The encoding of the buffer or NULL to use the current parser encoding, which is detected if not yet set
 /// @param Context  The parse context
 /// @return Whether the buffer was parsed or not
 /// @retval EFI_INVALID_PARAMETER If Parser or Buffer is NULL or Size is zero
 /// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
-/// @retval EFI_UNSUPPORTED       If the encoding of the buffer could not be determined
+/// @retval EFI_UNSUPPORTED       If the encoding of the buffer is unsupported
 /// @retval EFI_SUCCESS           If the buffer was parsed successfully
 EFI_STATUS
 EFIAPI
@@ -224,6 +270,79 @@ ParseBuffer (
   IN     CHAR8       *Encoding OPTIONAL,
   IN     VOID        *Context OPTIONAL
 );
+// ParseFinish
+/// Finish parsing, discarding any character sequence or surrogate pair left incomplete by the last buffer
+/// @param Parser The language parser used in parsing
+/// @return Whether the parser finished with complete character sequences or not
+/// @retval EFI_INVALID_PARAMETER If Parser is NULL
+/// @retval EFI_END_OF_FILE       If an incomplete character sequence was discarded
+/// @retval EFI_SUCCESS           If the parser finished successfully
+EFI_STATUS
+EFIAPI
+ParseFinish (
+  IN OUT LANG_PARSER *Parser
+);
+
+// ParseRegisterDecoder
+/// Register a character decoder for an encoding
+/// @param Encoding The name of the encoding
+/// @param Decode   The character decoder
+/// @return Whether the character decoder was registered or not
+/// @retval EFI_INVALID_PARAMETER If Encoding or Decode is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the character decoder was registered successfully
+EFI_STATUS
+EFIAPI
+ParseRegisterDecoder (
+  IN CHAR8       *Encoding,
+  IN LANG_DECODE  Decode
+);
+// ParseDetectEncoding
+/// Detect the encoding of a buffer from a byte order mark or the leading characters
+/// @param Size     The size, in bytes, of the buffer
+/// @param Buffer   The buffer of which to detect the encoding
+/// @param Encoding On output, the detected encoding, which should not be freed
+/// @param BomSize  On output, the size, in bytes, of the byte order mark
+/// @return Whether the encoding was detected or not
+/// @retval EFI_INVALID_PARAMETER If Buffer or Encoding is NULL or Size is zero
+/// @retval EFI_NOT_FOUND         If the encoding could not be detected and UTF-8 was assumed
+/// @retval EFI_SUCCESS           If the encoding was detected successfully
+EFI_STATUS
+EFIAPI
+ParseDetectEncoding (
+  IN  UINTN   Size,
+  IN  VOID   *Buffer,
+  OUT CHAR8 **Encoding,
+  OUT UINTN  *BomSize OPTIONAL
+);
+// ParseSetEncoding
+/// Set the encoding used to decode buffers, which may be changed while parsing
+/// @param Parser   The language parser
+/// @param Encoding The encoding used to decode buffers
+/// @return Whether the encoding was set or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Encoding is NULL
+/// @retval EFI_UNSUPPORTED       If there is no character decoder for the encoding
+/// @retval EFI_SUCCESS           If the encoding was set successfully
+EFI_STATUS
+EFIAPI
+ParseSetEncoding (
+  IN OUT LANG_PARSER *Parser,
+  IN     CHAR8       *Encoding
+);
+// ParseGetEncoding
+/// Get the encoding used to decode buffers
+/// @param Parser   The language parser
+/// @param Encoding On output, the encoding used to decode buffers, which should not be freed
+/// @return Whether the encoding was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Encoding is NULL
+/// @retval EFI_NOT_FOUND         If no encoding has been set
+/// @retval EFI_SUCCESS           If the encoding was retrieved successfully
+EFI_STATUS
+EFIAPI
+ParseGetEncoding (
+  IN  LANG_PARSER  *Parser,
+  OUT CHAR8       **Encoding
+);
 
 // ParseMessage
 /// Add a parser message
@@ -260,6 +379,84 @@ ParseVMessage (
   IN     CHAR16      *MessageDesc,
   IN     VA_LIST      Args
 );
+// ParseGetMessageCount
+/// Get the count of retained parser messages
+/// @param Parser  The language parser
+/// @param Count   On output, the count of retained messages
+/// @param Dropped On output, the count of messages dropped because too many messages were added
+/// @return Whether the count of messages was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Count is NULL
+/// @retval EFI_SUCCESS           If the count of messages was retrieved successfully
+EFI_STATUS
+EFIAPI
+ParseGetMessageCount (
+  IN  LANG_PARSER *Parser,
+  OUT UINTN       *Count,
+  OUT UINTN       *Dropped OPTIONAL
+);
+// ParseGetMessage
+/// Get a retained parser message
+/// @param Parser   The language parser
+/// @param Index    The index of the message, from the oldest retained message
+/// @param Flags    On output, the message flags
+/// @param Position On output, the input position at which the message was added
+/// @param Message  On output, the message, which must not be freed and is valid until the message is dropped or cleared
+/// @return Whether the message was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Message is NULL
+/// @retval EFI_NOT_FOUND         If Index is not less than the count of retained messages
+/// @retval EFI_SUCCESS           If the message was retrieved successfully
+EFI_STATUS
+EFIAPI
+ParseGetMessage (
+  IN  LANG_PARSER    *Parser,
+  IN  UINTN           Index,
+  OUT UINTN          *Flags OPTIONAL,
+  OUT LANG_POSITION  *Position OPTIONAL,
+  OUT CHAR16        **Message
+);
+// ParseClearMessages
+/// Clear the parser messages
+/// @param Parser The language parser
+/// @return Whether the messages were cleared or not
+/// @retval EFI_INVALID_PARAMETER If Parser is NULL
+/// @retval EFI_SUCCESS           If the messages were cleared successfully
+EFI_STATUS
+EFIAPI
+ParseClearMessages (
+  IN OUT LANG_PARSER *Parser
+);
+// ParseGetPosition
+/// Get the input position of the character last parsed
+/// @param Parser   The language parser
+/// @param Position On output, the input position of the character last parsed
+/// @return Whether the position was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Position is NULL
+/// @retval EFI_NOT_FOUND         If no character has been parsed
+/// @retval EFI_SUCCESS           If the position was retrieved successfully
+EFI_STATUS
+EFIAPI
+ParseGetPosition (
+  IN  LANG_PARSER   *Parser,
+  OUT LANG_POSITION *Position
+);
+// ParseLogProfile
+/// Log the token and state transition profile of a language parser, profiling is only compiled into debug builds
+/// @param Parser The language parser
+/// @param Name   The name of the parsed language
+#if defined(PROJECT_DEBUG)
+
+VOID
+EFIAPI
+ParseLogProfile (
+  IN LANG_PARSER *Parser,
+  IN CHAR16      *Name OPTIONAL
+);
+
+#else
+
+#define ParseLogProfile(Parser, Name)
+
+#endif
 
 // ParseError
 /// Add a parser error
@@ -401,7 +598,7 @@ SetParseStates (
 /// Get the current states of a parser
 /// @param Parser The language parser
 /// @param Count  On output, the count of parser states
-/// @param States On output, the states of the parser
+/// @param States On output, the states of the parser, which may be shared with other parsers and must not be modified
 /// @return Whether the parser states were retrieved or not
 /// @retval EFI_INVALID_PARAMETER If Parser, Count, or States is NULL
 /// @retval EFI_NOT_FOUND         If the language parser has no states
@@ -487,7 +684,7 @@ CreateParseState (
 /// @param Count        The count of parser states
 /// @param StaticStates The static parser states
 /// @return Whether the parser states were created or not
-/// @retval EFI_INVALID_PARAMETER If States or StaticStates is NULL or *States is not NULL or Count is zero
+/// @retval EFI_INVALID_PARAMETER If States or StaticStates is NULL or *States is not NULL or Count is zero or a static state is invalid
 /// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the states
 /// @retval EFI_SUCCESS           If the parser states were created successfully
 EFI_STATUS
@@ -557,7 +754,8 @@ CreateParserWithStates (
   IN  LANG_STATE    **States
 );
 // CreateParserFromStates
-/// Create a language parser with static parser states
+/// Create a language parser with static parser states, the static states are compiled once and then shared
+///  by every parser created from them, so they must not be modified until the parse library is finished
 /// @param Parser   On output, the created language parser, which must be freed with FreeParser
 /// @param Callback The token parsed callback
 /// @param Id       The identifier of the state to set for the parser
@@ -565,7 +763,8 @@ CreateParserWithStates (
 /// @param States   The static parser states to set for the language parser
 /// @return Whether the language parser was created or not
 /// @retval EFI_INVALID_PARAMETER If Parser or States is NULL or Count is zero
-/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the parser
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the parser or the static states are invalid
+/// @retval EFI_NOT_FOUND         If the parser state identifier was not found
 /// @retval EFI_SUCCESS           If the language parser was created successfully
 EFI_STATUS
 EFIAPI
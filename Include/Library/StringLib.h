@@ -25,6 +25,148 @@
 // STR_SEARCH_CASE_INSENSITIVE
 /// Compare strings case insensitively when searching for strings
 #define STR_SEARCH_CASE_INSENSITIVE 0x10
+// STR_LIST_HASHED
+/// Use a hash set to check for duplicates in a string list object, only valid with STR_LIST_NO_DUPLICATES
+#define STR_LIST_HASHED 0x20
+
+// STR_BUILDER_MIN_SIZE
+/// The minimum allocated size, in characters, of a string builder
+#define STR_BUILDER_MIN_SIZE 16
+
+// STR_BUILDER
+/// Growable string builder, a zeroed builder is empty and the allocated size is retained when the builder is reset
+typedef struct _STR_BUILDER STR_BUILDER;
+struct _STR_BUILDER {
+
+  // Count
+  /// The count of characters in the string
+  UINTN   Count;
+  // Size
+  /// The allocated size, in characters, of the string, including the null-terminator
+  UINTN   Size;
+  // Buffer
+  /// The null-terminated string or NULL if nothing has been allocated
+  CHAR16 *Buffer;
+
+};
+
+// STR_VIEW
+/// String view, a count of characters of a string that is not owned by the view and not necessarily null-terminated
+typedef struct _STR_VIEW STR_VIEW;
+struct _STR_VIEW {
+
+  // Count
+  /// The count of characters in the view
+  UINTN   Count;
+  // String
+  /// The first character of the view or NULL for an empty view
+  CHAR16 *String;
+
+};
+
+// STR_SMALL_SIZE
+/// The size, in characters, of the inline buffer of a small string, including the null-terminator
+#define STR_SMALL_SIZE 32
+// STR_SMALL_BUFFER
+/// Get the null-terminated string of a small string
+#define STR_SMALL_BUFFER(Small) (((Small)->Buffer != NULL) ? (Small)->Buffer : (Small)->Inline)
+
+// STR_SMALL
+/// String with an inline buffer so short strings are not allocated, a zeroed small string is empty
+typedef struct _STR_SMALL STR_SMALL;
+struct _STR_SMALL {
+
+  // Count
+  /// The count of characters in the string
+  UINTN   Count;
+  // Size
+  /// The allocated size, in characters, of the string, including the null-terminator, or zero if inline
+  UINTN   Size;
+  // Buffer
+  /// The allocated string or NULL if the string is in the inline buffer
+  CHAR16 *Buffer;
+  // Inline
+  /// The inline buffer for strings that fit
+  CHAR16  Inline[STR_SMALL_SIZE];
+
+};
+
+// STR_LIST_MIN_SIZE
+/// The minimum allocated size, in strings, of a string list object
+#define STR_LIST_MIN_SIZE 8
+
+// STR_LIST
+/// Growable string list object, a zeroed list is empty, the options must be set before adding strings
+typedef struct _STR_LIST STR_LIST;
+struct _STR_LIST {
+
+  // Options
+  /// The options for adding strings to the list
+  UINTN    Options;
+  // Count
+  /// The count of strings in the list
+  UINTN    Count;
+  // Size
+  /// The allocated size, in strings, of the list
+  UINTN    Size;
+  // Strings
+  /// The strings or NULL if nothing has been allocated
+  CHAR16 **Strings;
+  // HashSize
+  /// The count of slots in the hash set, a power of two, or zero if there is no hash set
+  UINTN    HashSize;
+  // Hashes
+  /// The hash set slots, each the string in the list or NULL if the slot is unused
+  CHAR16 **Hashes;
+
+};
+// ASCII_STR_LIST
+/// Growable ASCII string list object, a zeroed list is empty, the options must be set before adding strings
+typedef struct _ASCII_STR_LIST ASCII_STR_LIST;
+struct _ASCII_STR_LIST {
+
+  // Options
+  /// The options for adding strings to the list
+  UINTN   Options;
+  // Count
+  /// The count of strings in the list
+  UINTN   Count;
+  // Size
+  /// The allocated size, in strings, of the list
+  UINTN   Size;
+  // Strings
+  /// The strings or NULL if nothing has been allocated
+  CHAR8 **Strings;
+  // HashSize
+  /// The count of slots in the hash set, a power of two, or zero if there is no hash set
+  UINTN   HashSize;
+  // Hashes
+  /// The hash set slots, each the string in the list or NULL if the slot is unused
+  CHAR8 **Hashes;
+
+};
+
+// META_PATTERN
+/// Compiled pattern for case-insensitive matching
+typedef struct _META_PATTERN META_PATTERN;
+
+// BASE64_ENCODED_LENGTH
+/// Get the count of Base64 characters, including padding, needed to encode data
+#define BASE64_ENCODED_LENGTH(Size) ((((Size) + 2) / 3) * 4)
+
+// BASE64_CONTEXT
+/// Incremental Base64 encoder or decoder context, a zeroed context is at the start of the data
+typedef struct _BASE64_CONTEXT BASE64_CONTEXT;
+struct _BASE64_CONTEXT {
+
+  // Bits
+  /// The pending bits of the partial group
+  UINT32 Bits;
+  // Count
+  /// The count of pending bytes of the partial group when encoding or characters when decoding
+  UINTN  Count;
+
+};
 
 // IsUnicodeCharacter
 /// Check if character is valid unicode code point
@@ -112,6 +254,44 @@ MetaiMatch (
   IN CHAR16 *String,
   IN CHAR16 *Pattern
 );
+// MetaiCompile
+/// Compile a pattern string for repeated case-insensitive matching
+/// @param Compiled On output, the compiled pattern, which must be freed with MetaiFreeCompiled
+/// @param Pattern  The pattern string
+/// @return Whether the pattern was compiled or not
+/// @retval EFI_INVALID_PARAMETER If Compiled or Pattern is NULL, *Compiled is not NULL, or a character set has a syntax problem
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the compiled pattern
+/// @retval EFI_SUCCESS           If the pattern was compiled successfully
+EFI_STATUS
+EFIAPI
+MetaiCompile (
+  OUT META_PATTERN **Compiled,
+  IN  CHAR16        *Pattern
+);
+// MetaiMatchCompiled
+/// Performs a case-insensitive comparison of a compiled pattern and a string in time linear in the string length
+///  for each segment between stars
+/// @param Compiled The compiled pattern
+/// @param String   A pointer to a string
+/// @retval TRUE  Pattern was found in String
+/// @retval FALSE Pattern was not found in String
+BOOLEAN
+EFIAPI
+MetaiMatchCompiled (
+  IN META_PATTERN *Compiled,
+  IN CHAR16       *String
+);
+// MetaiFreeCompiled
+/// Free a compiled pattern
+/// @param Compiled The compiled pattern to free
+/// @return Whether the compiled pattern was freed or not
+/// @retval EFI_INVALID_PARAMETER If Compiled is NULL
+/// @retval EFI_SUCCESS           If the compiled pattern was freed successfully
+EFI_STATUS
+EFIAPI
+MetaiFreeCompiled (
+  IN META_PATTERN *Compiled
+);
 
 // StrLwr
 /// Converts all the characters in a string to lower case characters
@@ -181,6 +361,279 @@ StrAppend (
   IN     UINT32   Character
 );
 
+// StrBuilderReserve
+/// Reserve space in a string builder, the allocated size at least doubles when it grows
+/// @param Builder The string builder
+/// @param Count   The count of characters that must fit after the current string, excluding the null-terminator
+/// @return Whether the space was reserved or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the space was reserved successfully
+EFI_STATUS
+EFIAPI
+StrBuilderReserve (
+  IN OUT STR_BUILDER *Builder,
+  IN     UINTN        Count
+);
+// StrBuilderAppend
+/// Append characters to a string builder
+/// @param Builder The string builder
+/// @param String  The characters to append
+/// @param Count   The count of characters to append
+/// @return Whether the characters were appended or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL or String is NULL and Count is not zero
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the characters were appended successfully
+EFI_STATUS
+EFIAPI
+StrBuilderAppend (
+  IN OUT STR_BUILDER *Builder,
+  IN     CHAR16      *String,
+  IN     UINTN        Count
+);
+// StrBuilderAppendCharacter
+/// Append a character to a string builder, characters outside the basic multilingual plane are appended as surrogate pairs
+/// @param Builder   The string builder
+/// @param Character The character to append
+/// @return Whether the character was appended or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL or Character is invalid
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the character was appended successfully
+EFI_STATUS
+EFIAPI
+StrBuilderAppendCharacter (
+  IN OUT STR_BUILDER *Builder,
+  IN     UINT32       Character
+);
+// StrBuilderAppendVSPrint
+/// Append formatted text to a string builder
+/// @param Builder The string builder
+/// @param Format  The format specifier for formatting the text
+/// @param Args    The variable arguments list for formatting
+/// @return Whether the formatted text was appended or not
+/// @retval EFI_INVALID_PARAMETER If Builder or Format is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the formatted text was appended successfully
+EFI_STATUS
+EFIAPI
+StrBuilderAppendVSPrint (
+  IN OUT STR_BUILDER *Builder,
+  IN     CHAR16      *Format,
+  IN     VA_LIST      Args
+);
+// StrBuilderAppendSPrint
+/// Append formatted text to a string builder
+/// @param Builder The string builder
+/// @param Format  The format specifier for formatting the text
+/// @param ...     The parameters for the format string
+/// @return Whether the formatted text was appended or not
+/// @retval EFI_INVALID_PARAMETER If Builder or Format is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the formatted text was appended successfully
+EFI_STATUS
+EFIAPI
+StrBuilderAppendSPrint (
+  IN OUT STR_BUILDER *Builder,
+  IN     CHAR16      *Format,
+  ...
+);
+// StrBuilderRemove
+/// Remove leading characters from a string builder
+/// @param Builder The string builder
+/// @param Count   The count of leading characters to remove, the string is emptied if this is not less than the string length
+/// @return Whether the characters were removed or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL
+/// @retval EFI_SUCCESS           If the characters were removed successfully
+EFI_STATUS
+EFIAPI
+StrBuilderRemove (
+  IN OUT STR_BUILDER *Builder,
+  IN     UINTN        Count
+);
+// StrBuilderReset
+/// Empty a string builder and retain the allocated size for reuse
+/// @param Builder The string builder
+/// @return Whether the string builder was reset or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL
+/// @retval EFI_SUCCESS           If the string builder was reset successfully
+EFI_STATUS
+EFIAPI
+StrBuilderReset (
+  IN OUT STR_BUILDER *Builder
+);
+// StrBuilderFree
+/// Free the string of a string builder, the builder is empty afterwards and may be reused
+/// @param Builder The string builder
+/// @return Whether the string was freed or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL
+/// @retval EFI_SUCCESS           If the string was freed successfully
+EFI_STATUS
+EFIAPI
+StrBuilderFree (
+  IN OUT STR_BUILDER *Builder
+);
+
+// StrViewFromString
+/// Set a string view to an entire string
+/// @param View   On output, the string view
+/// @param String The string to view or NULL for an empty view
+/// @return Whether the string view was set or not
+/// @retval EFI_INVALID_PARAMETER If View is NULL
+/// @retval EFI_SUCCESS           If the string view was set successfully
+EFI_STATUS
+EFIAPI
+StrViewFromString (
+  OUT STR_VIEW *View,
+  IN  CHAR16   *String OPTIONAL
+);
+// StrViewSplit
+/// Get the next token of a string view without allocating, the token is followed by any of the delimiter characters
+///  or the end of the view, empty tokens between consecutive delimiters are returned but a trailing delimiter does not
+///  produce an empty token
+/// @param View       The string view, which is advanced past the token and its delimiter
+/// @param Delimiters The delimiter characters
+/// @param Token      On output, the string view of the token
+/// @retval TRUE  If a token was returned
+/// @retval FALSE If there are no more tokens or a parameter is NULL
+BOOLEAN
+EFIAPI
+StrViewSplit (
+  IN OUT STR_VIEW *View,
+  IN     CHAR16   *Delimiters,
+  OUT    STR_VIEW *Token
+);
+// StrViewFind
+/// Find the first occurrence of a string in a string view
+/// @param View         The string view to search
+/// @param SearchString The string to search for
+/// @param Options      STR_SEARCH_CASE_INSENSITIVE to compare the characters case insensitively, otherwise zero
+/// @return The first occurrence of the search string in the string view or NULL if not found
+CHAR16 *
+EFIAPI
+StrViewFind (
+  IN STR_VIEW *View,
+  IN CHAR16   *SearchString,
+  IN UINTN     Options
+);
+// StrViewTrim
+/// Trim the leading and trailing whitespace of a string view without modifying the string
+/// @param View The string view to trim
+/// @return Whether the string view was trimmed or not
+/// @retval EFI_INVALID_PARAMETER If View is NULL
+/// @retval EFI_SUCCESS           If the string view was trimmed successfully
+EFI_STATUS
+EFIAPI
+StrViewTrim (
+  IN OUT STR_VIEW *View
+);
+// StrViewCmp
+/// Performs a comparison of a string view and a string
+/// @param View   The string view to compare
+/// @param String The string to compare
+/// @retval 0  The string view is identical to the string
+/// @retval >0 The string view is lexically greater than the string
+/// @retval <0 The string view is lexically less than the string
+INTN
+EFIAPI
+StrViewCmp (
+  IN STR_VIEW *View,
+  IN CHAR16   *String
+);
+// StrViewiCmp
+/// Performs a case-insensitive comparison of a string view and a string, ordered the same as StriCmp
+/// @param View   The string view to compare
+/// @param String The string to compare
+/// @retval 0  The string view is identical to the string
+/// @retval >0 The string view is lexically greater than the string
+/// @retval <0 The string view is lexically less than the string
+INTN
+EFIAPI
+StrViewiCmp (
+  IN STR_VIEW *View,
+  IN CHAR16   *String
+);
+// StrViewDup
+/// Duplicate the characters of a string view as a string
+/// @param View The string view to duplicate
+/// @return The duplicated string which needs freed or NULL if the string could not be duplicated
+CHAR16 *
+EFIAPI
+StrViewDup (
+  IN STR_VIEW *View
+);
+// StrSmallSet
+/// Set the string of a small string, strings that do not fit in the inline buffer are allocated and the allocation
+///  is reused until the small string is freed
+/// @param Small  The small string
+/// @param String The characters to copy, which do not need to be null-terminated
+/// @param Count  The count of characters to copy
+/// @return Whether the string was set or not
+/// @retval EFI_INVALID_PARAMETER If Small is NULL or String is NULL and Count is not zero
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the string was set successfully
+EFI_STATUS
+EFIAPI
+StrSmallSet (
+  IN OUT STR_SMALL *Small,
+  IN     CHAR16    *String OPTIONAL,
+  IN     UINTN      Count
+);
+// StrSmallFree
+/// Free the allocated string of a small string, the small string is empty afterwards and may be reused
+/// @param Small The small string
+/// @return Whether the string was freed or not
+/// @retval EFI_INVALID_PARAMETER If Small is NULL
+/// @retval EFI_SUCCESS           If the string was freed successfully
+EFI_STATUS
+EFIAPI
+StrSmallFree (
+  IN OUT STR_SMALL *Small
+);
+
+// StrListAdd
+/// Add a string to a string list object, the list grows geometrically so adding is amortized constant time
+/// @param List   The string list object
+/// @param Str    The string to add to the list
+/// @param Length The maximum length of the string or zero to use the entire string
+/// @return Whether the string was added to the list or not
+/// @retval EFI_INVALID_PARAMETER If List or Str is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If the memory for the list could not be allocated
+/// @retval EFI_ACCESS_DENIED     If STR_LIST_NO_DUPLICATES was used and the string already exists
+/// @retval EFI_SUCCESS           If the string was added to the list successfully
+EFI_STATUS
+EFIAPI
+StrListAdd (
+  IN OUT STR_LIST *List,
+  IN     CHAR16   *Str,
+  IN     UINTN     Length
+);
+// StrListDetach
+/// Detach the strings from a string list object, the list is empty afterwards and may be reused
+/// @param List    The string list object
+/// @param Strings On output, the string list, which must be freed with StrListFree, or NULL if the list was empty
+/// @param Count   On output, the count of strings in the list
+/// @return Whether the strings were detached or not
+/// @retval EFI_INVALID_PARAMETER If List, Strings, or Count is NULL or *Strings is not NULL
+/// @retval EFI_SUCCESS           If the strings were detached successfully
+EFI_STATUS
+EFIAPI
+StrListDetach (
+  IN OUT STR_LIST   *List,
+  OUT    CHAR16   ***Strings,
+  OUT    UINTN      *Count
+);
+// StrListClear
+/// Free the strings of a string list object, the list is empty afterwards and may be reused
+/// @param List The string list object
+/// @return Whether the strings were freed or not
+/// @retval EFI_INVALID_PARAMETER If List is NULL
+/// @retval EFI_SUCCESS           If the strings were freed successfully
+EFI_STATUS
+EFIAPI
+StrListClear (
+  IN OUT STR_LIST *List
+);
+
 // StrSplit
 /// Split a string into a list
 /// @param List    On output, the string list, which must be freed with StrListFree
@@ -299,6 +752,33 @@ AsciiMetaiMatch (
   IN CHAR8 *String,
   IN CHAR8 *Pattern
 );
+// AsciiMetaiCompile
+/// Compile an ASCII pattern string for repeated case-insensitive matching
+/// @param Compiled On output, the compiled pattern, which must be freed with MetaiFreeCompiled
+/// @param Pattern  The pattern string
+/// @return Whether the pattern was compiled or not
+/// @retval EFI_INVALID_PARAMETER If Compiled or Pattern is NULL, *Compiled is not NULL, or a character set has a syntax problem
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the compiled pattern
+/// @retval EFI_SUCCESS           If the pattern was compiled successfully
+EFI_STATUS
+EFIAPI
+AsciiMetaiCompile (
+  OUT META_PATTERN **Compiled,
+  IN  CHAR8         *Pattern
+);
+// AsciiMetaiMatchCompiled
+/// Performs a case-insensitive comparison of a compiled pattern and an ASCII string in time linear in the string
+///  length for each segment between stars
+/// @param Compiled The compiled pattern
+/// @param String   A pointer to a string
+/// @retval TRUE  Pattern was found in String
+/// @retval FALSE Pattern was not found in String
+BOOLEAN
+EFIAPI
+AsciiMetaiMatchCompiled (
+  IN META_PATTERN *Compiled,
+  IN CHAR8        *String
+);
 
 // AsciiLwr
 /// Converts all the characters in a string to lower case characters
@@ -365,6 +845,50 @@ AsciiStriStr (
   IN CHAR8 *SearchString
 );
 
+// AsciiStrListAdd
+/// Add a string to a string list object, the list grows geometrically so adding is amortized constant time
+/// @param List   The string list object
+/// @param Str    The string to add to the list
+/// @param Length The maximum length of the string or zero to use the entire string
+/// @return Whether the string was added to the list or not
+/// @retval EFI_INVALID_PARAMETER If List or Str is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If the memory for the list could not be allocated
+/// @retval EFI_ACCESS_DENIED     If STR_LIST_NO_DUPLICATES was used and the string already exists
+/// @retval EFI_SUCCESS           If the string was added to the list successfully
+EFI_STATUS
+EFIAPI
+AsciiStrListAdd (
+  IN OUT ASCII_STR_LIST *List,
+  IN     CHAR8          *Str,
+  IN     UINTN           Length
+);
+// AsciiStrListDetach
+/// Detach the strings from a string list object, the list is empty afterwards and may be reused
+/// @param List    The string list object
+/// @param Strings On output, the string list, which must be freed with AsciiStrListFree, or NULL if the list was empty
+/// @param Count   On output, the count of strings in the list
+/// @return Whether the strings were detached or not
+/// @retval EFI_INVALID_PARAMETER If List, Strings, or Count is NULL or *Strings is not NULL
+/// @retval EFI_SUCCESS           If the strings were detached successfully
+EFI_STATUS
+EFIAPI
+AsciiStrListDetach (
+  IN OUT ASCII_STR_LIST   *List,
+  OUT    CHAR8          ***Strings,
+  OUT    UINTN           *Count
+);
+// AsciiStrListClear
+/// Free the strings of a string list object, the list is empty afterwards and may be reused
+/// @param List The string list object
+/// @return Whether the strings were freed or not
+/// @retval EFI_INVALID_PARAMETER If List is NULL
+/// @retval EFI_SUCCESS           If the strings were freed successfully
+EFI_STATUS
+EFIAPI
+AsciiStrListClear (
+  IN OUT ASCII_STR_LIST *List
+);
+
 // AsciiStrSplit
 /// Split a string into a list
 /// @param List    On output, the string list, which must be freed with AsciiStrListFree
@@ -424,7 +948,7 @@ AsciiStrListFree (
 // ToAscii
 /// Convert string to ASCII
 /// @param String The string to convert
-/// @return The converted string or NULL if there was an error
+/// @return The converted string or NULL if there was an error or a character is not latin-1
 CHAR8 *
 EFIAPI
 ToAscii (
@@ -439,6 +963,61 @@ EFIAPI
 FromAscii (
   IN CHAR8 *String
 );
+// Utf16ToUtf8
+/// Convert UTF-16 characters to UTF-8 characters in a caller buffer, surrogate pairs are combined and unpaired surrogates are invalid
+/// @param Count  The count of UTF-16 characters to convert
+/// @param String The UTF-16 characters to convert
+/// @param Size   On input, the size, in bytes, of the buffer, on output, the exact size, in bytes, of the UTF-8 characters
+/// @param Utf8   The buffer for the UTF-8 characters, which is not null-terminated
+/// @return Whether the characters were converted or not
+/// @retval EFI_INVALID_PARAMETER If Size is NULL, String is NULL and Count is not zero, or there is an unpaired surrogate
+/// @retval EFI_BUFFER_TOO_SMALL  If Utf8 is NULL or the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the characters were converted successfully
+EFI_STATUS
+EFIAPI
+Utf16ToUtf8 (
+  IN     UINTN   Count,
+  IN     CHAR16 *String,
+  IN OUT UINTN  *Size,
+  OUT    CHAR8  *Utf8 OPTIONAL
+);
+// Utf8ToUtf16
+/// Convert UTF-8 characters to UTF-16 characters in a caller buffer, truncated, overlong and surrogate sequences
+///  and code points above the unicode range are invalid
+/// @param Size   The size, in bytes, of the UTF-8 characters to convert
+/// @param Utf8   The UTF-8 characters to convert
+/// @param Count  On input, the size, in characters, of the buffer, on output, the exact count of UTF-16 characters
+/// @param String The buffer for the UTF-16 characters, which is not null-terminated
+/// @return Whether the characters were converted or not
+/// @retval EFI_INVALID_PARAMETER If Count is NULL, Utf8 is NULL and Size is not zero, or there is an invalid sequence
+/// @retval EFI_BUFFER_TOO_SMALL  If String is NULL or the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the characters were converted successfully
+EFI_STATUS
+EFIAPI
+Utf8ToUtf16 (
+  IN     UINTN   Size,
+  IN     CHAR8  *Utf8,
+  IN OUT UINTN  *Count,
+  OUT    CHAR16 *String OPTIONAL
+);
+// ToUtf8
+/// Convert string to UTF-8
+/// @param String The string to convert
+/// @return The converted string, which must be freed, or NULL if there was an error or an unpaired surrogate
+CHAR8 *
+EFIAPI
+ToUtf8 (
+  IN CHAR16 *String
+);
+// FromUtf8
+/// Convert string from UTF-8
+/// @param String The string to convert
+/// @return The converted string, which must be freed, or NULL if there was an error or an invalid sequence
+CHAR16 *
+EFIAPI
+FromUtf8 (
+  IN CHAR8 *String
+);
 
 // SetLanguage
 /// Set the language
@@ -496,6 +1075,61 @@ ToBase64 (
   OUT UINTN   *Count OPTIONAL,
   OUT CHAR16 **Base64
 );
+// ToBase64Buffer
+/// Convert data to Base64 encoded string in a caller buffer
+/// @param Size   The size, in bytes, of the data to encode
+/// @param Data   The data to encode
+/// @param Count  On input, the size, in characters, of the buffer, on output, the size, in characters, of the encoded string including the null-terminator
+/// @param Base64 The buffer for the Base64 encoded string, which must have room for BASE64_ENCODED_LENGTH(Size) + 1 characters
+/// @return Whether the data was converted to Base64 or not
+/// @retval EFI_INVALID_PARAMETER If Data or Count is NULL or Size is zero
+/// @retval EFI_BUFFER_TOO_SMALL  If Base64 is NULL or the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the data was converted to Base64 successfully
+EFI_STATUS
+EFIAPI
+ToBase64Buffer (
+  IN     UINTN   Size,
+  IN     VOID   *Data,
+  IN OUT UINTN  *Count,
+  OUT    CHAR16 *Base64 OPTIONAL
+);
+// ToBase64Update
+/// Encode the next chunk of data to Base64 characters, only whole groups of characters are encoded and the
+///  remaining bytes are kept in the context until the next chunk or ToBase64Final
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Size    The size, in bytes, of the data to encode
+/// @param Data    The data to encode
+/// @param Count   On input, the size, in characters, of the buffer, on output, the count of characters encoded
+/// @param Base64  The buffer for the Base64 characters, which is not null-terminated
+/// @return Whether the data was encoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Count is NULL or Data is NULL and Size is not zero
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the data was encoded successfully
+EFI_STATUS
+EFIAPI
+ToBase64Update (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Size,
+  IN     VOID           *Data,
+  IN OUT UINTN          *Count,
+  OUT    CHAR16         *Base64 OPTIONAL
+);
+// ToBase64Final
+/// Encode the remaining bytes of the data to Base64 characters with padding and reset the context
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Count   On input, the size, in characters, of the buffer, on output, the count of characters encoded
+/// @param Base64  The buffer for the Base64 characters, which is not null-terminated
+/// @return Whether the remaining bytes were encoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Count is NULL
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the remaining bytes were encoded successfully
+EFI_STATUS
+EFIAPI
+ToBase64Final (
+  IN OUT BASE64_CONTEXT *Context,
+  IN OUT UINTN          *Count,
+  OUT    CHAR16         *Base64 OPTIONAL
+);
 // FromBase64
 /// Convert Base64 encoded string to data
 /// @param Base64 The Base64 encoded string to convert
@@ -512,6 +1146,60 @@ FromBase64 (
   OUT UINTN   *Size,
   OUT VOID   **Data
 );
+// FromBase64Buffer
+/// Convert Base64 encoded string to data in a caller buffer
+/// @param Base64 The Base64 encoded string to convert
+/// @param Size   On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the data
+/// @param Data   The buffer for the decoded data
+/// @return Whether the Base64 encoded string was converted to data or not
+/// @retval EFI_INVALID_PARAMETER If Base64 or Size is NULL or the Base64 encoded string is invalid
+/// @retval EFI_BUFFER_TOO_SMALL  If Data is NULL or the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the Base64 string was converted to data successfully
+EFI_STATUS
+EFIAPI
+FromBase64Buffer (
+  IN     CHAR16 *Base64,
+  IN OUT UINTN  *Size,
+  OUT    VOID   *Data OPTIONAL
+);
+// FromBase64Update
+/// Decode the next chunk of Base64 encoded characters, characters that are not Base64 are skipped and only
+///  whole groups are decoded, the remaining characters are kept in the context until the next chunk or FromBase64Final
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Length  The count of characters to decode
+/// @param Base64  The Base64 encoded characters to decode
+/// @param Size    On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the decoded data
+/// @param Data    The buffer for the decoded data, which needs at most ((Context->Count + Length) / 4) * 3 bytes
+/// @return Whether the characters were decoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Size is NULL or Base64 is NULL and Length is not zero
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the characters were decoded successfully
+EFI_STATUS
+EFIAPI
+FromBase64Update (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Length,
+  IN     CHAR16         *Base64,
+  IN OUT UINTN          *Size,
+  OUT    VOID           *Data OPTIONAL
+);
+// FromBase64Final
+/// Decode the remaining Base64 characters of the partial group and reset the context, padding is implied by the
+///  count of characters in the partial group
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Size    On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the decoded data
+/// @param Data    The buffer for the decoded data, which needs at most two bytes
+/// @return Whether the remaining characters were decoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Size is NULL or there is only one character in the partial group
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the remaining characters were decoded successfully
+EFI_STATUS
+EFIAPI
+FromBase64Final (
+  IN OUT BASE64_CONTEXT *Context,
+  IN OUT UINTN          *Size,
+  OUT    VOID           *Data OPTIONAL
+);
 // AsciiToBase64
 /// Convert data to Base64 encoded ASCII string
 /// @param Size   The size, in bytes, of the data to encode
@@ -530,6 +1218,61 @@ AsciiToBase64 (
   OUT UINTN  *Count OPTIONAL,
   OUT CHAR8 **Base64
 );
+// AsciiToBase64Buffer
+/// Convert data to Base64 encoded ASCII string in a caller buffer
+/// @param Size   The size, in bytes, of the data to encode
+/// @param Data   The data to encode
+/// @param Count  On input, the size, in characters, of the buffer, on output, the size, in characters, of the encoded string including the null-terminator
+/// @param Base64 The buffer for the Base64 encoded ASCII string, which must have room for BASE64_ENCODED_LENGTH(Size) + 1 characters
+/// @return Whether the data was converted to Base64 or not
+/// @retval EFI_INVALID_PARAMETER If Data or Count is NULL or Size is zero
+/// @retval EFI_BUFFER_TOO_SMALL  If Base64 is NULL or the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the data was converted to Base64 successfully
+EFI_STATUS
+EFIAPI
+AsciiToBase64Buffer (
+  IN     UINTN  Size,
+  IN     VOID  *Data,
+  IN OUT UINTN *Count,
+  OUT    CHAR8 *Base64 OPTIONAL
+);
+// AsciiToBase64Update
+/// Encode the next chunk of data to Base64 ASCII characters, only whole groups of characters are encoded and the
+///  remaining bytes are kept in the context until the next chunk or AsciiToBase64Final
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Size    The size, in bytes, of the data to encode
+/// @param Data    The data to encode
+/// @param Count   On input, the size, in characters, of the buffer, on output, the count of characters encoded
+/// @param Base64  The buffer for the Base64 ASCII characters, which is not null-terminated
+/// @return Whether the data was encoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Count is NULL or Data is NULL and Size is not zero
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the data was encoded successfully
+EFI_STATUS
+EFIAPI
+AsciiToBase64Update (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Size,
+  IN     VOID           *Data,
+  IN OUT UINTN          *Count,
+  OUT    CHAR8          *Base64 OPTIONAL
+);
+// AsciiToBase64Final
+/// Encode the remaining bytes of the data to Base64 ASCII characters with padding and reset the context
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Count   On input, the size, in characters, of the buffer, on output, the count of characters encoded
+/// @param Base64  The buffer for the Base64 ASCII characters, which is not null-terminated
+/// @return Whether the remaining bytes were encoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Count is NULL
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the remaining bytes were encoded successfully
+EFI_STATUS
+EFIAPI
+AsciiToBase64Final (
+  IN OUT BASE64_CONTEXT *Context,
+  IN OUT UINTN          *Count,
+  OUT    CHAR8          *Base64 OPTIONAL
+);
 // AsciiFromBase64
 /// Convert Base64 encoded ASCII string to data
 /// @param Base64 The Base64 encoded ASCII string to convert
@@ -546,5 +1289,42 @@ AsciiFromBase64 (
   OUT UINTN  *Size,
   OUT VOID  **Data
 );
+// AsciiFromBase64Buffer
+/// Convert Base64 encoded ASCII string to data in a caller buffer
+/// @param Base64 The Base64 encoded ASCII string to convert
+/// @param Size   On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the data
+/// @param Data   The buffer for the decoded data
+/// @return Whether the Base64 encoded ASCII string was converted to data or not
+/// @retval EFI_INVALID_PARAMETER If Base64 or Size is NULL or the Base64 encoded ASCII string is invalid
+/// @retval EFI_BUFFER_TOO_SMALL  If Data is NULL or the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the Base64 ASCII string was converted to data successfully
+EFI_STATUS
+EFIAPI
+AsciiFromBase64Buffer (
+  IN     CHAR8 *Base64,
+  IN OUT UINTN *Size,
+  OUT    VOID  *Data OPTIONAL
+);
+// AsciiFromBase64Update
+/// Decode the next chunk of Base64 encoded ASCII characters, characters that are not Base64 are skipped and only
+///  whole groups are decoded, the remaining characters are kept in the context until the next chunk or FromBase64Final
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Length  The count of characters to decode
+/// @param Base64  The Base64 encoded ASCII characters to decode
+/// @param Size    On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the decoded data
+/// @param Data    The buffer for the decoded data, which needs at most ((Context->Count + Length) / 4) * 3 bytes
+/// @return Whether the characters were decoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Size is NULL or Base64 is NULL and Length is not zero
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the characters were decoded successfully
+EFI_STATUS
+EFIAPI
+AsciiFromBase64Update (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Length,
+  IN     CHAR8          *Base64,
+  IN OUT UINTN          *Size,
+  OUT    VOID           *Data OPTIONAL
+);
 
 #endif // __STRING_LIBRARY_HEADER__
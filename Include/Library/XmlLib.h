@@ -10,6 +10,8 @@
 
 #include <Library/ParseLib.h>
 
+#include <Protocol/SimpleFileSystem.h>
+
 // XML_ATTRIBUTE
 /// XML document tree node attribute
 typedef struct _XML_ATTRIBUTE XML_ATTRIBUTE;
@@ -35,6 +37,9 @@ typedef struct _XML_DOCUMENT XML_DOCUMENT;
 // XML_PARSER
 /// XML parser
 typedef struct _XML_PARSER XML_PARSER;
+// XML_QUERY
+/// XML compiled query
+typedef struct _XML_QUERY XML_QUERY;
 
 // XML_INSPECT
 /// XML document tree inspection callback
@@ -44,9 +49,9 @@ typedef struct _XML_PARSER XML_PARSER;
 /// @param TagName        The tree node tag name
 /// @param Value          The tree node value
 /// @param AttributeCount The tree node attribute count
-/// @param Attributes     The tree node attributes
+/// @param Attributes     The tree node attributes view
 /// @param ChildCount     The tree node child count
-/// @param Children       The tree node children
+/// @param Children       The tree node children view
 /// @param Context        The context passed when inspection started
 /// @retval TRUE  If the inspection should continue
 /// @retval FALSE If the inspection should stop
@@ -59,11 +64,64 @@ typedef BOOLEAN
   IN CHAR16         *TagName,
   IN CHAR16         *Value OPTIONAL,
   IN UINTN           AttributeCount,
-  IN XML_ATTRIBUTE **Attributes OPTIONAL,
+  IN XML_ATTRIBUTE  *Attributes OPTIONAL,
   IN UINTN           ChildCount,
   IN XML_TREE      **Children OPTIONAL,
   IN VOID           *Context OPTIONAL
 );
+// XML_WALK
+/// XML document tree walk callback, child nodes are accessed from the first child by XmlTreeGetNextSibling
+/// @param Tree           The document tree node
+/// @param Level          The level of generation of tree nodes, zero for the root
+/// @param LevelIndex     The index of the tree node relative to the previous level
+/// @param TagName        The tree node tag name
+/// @param Value          The tree node value
+/// @param AttributeCount The tree node attribute count
+/// @param Attributes     The tree node attributes view
+/// @param FirstChild     The tree node first child
+/// @param Context        The context passed when the walk started
+/// @retval TRUE  If the walk should continue
+/// @retval FALSE If the walk should stop
+typedef BOOLEAN
+(EFIAPI
+*XML_WALK) (
+  IN XML_TREE      *Tree,
+  IN UINTN          Level,
+  IN UINTN          LevelIndex,
+  IN CHAR16        *TagName,
+  IN CHAR16        *Value OPTIONAL,
+  IN UINTN          AttributeCount,
+  IN XML_ATTRIBUTE *Attributes OPTIONAL,
+  IN XML_TREE      *FirstChild OPTIONAL,
+  IN VOID          *Context OPTIONAL
+);
+// XML_WRITE
+/// XML serialization sink callback
+/// @param Size    The size, in bytes, of the buffer to write
+/// @param Buffer  The buffer to write
+/// @param Context The context passed when serialization started
+/// @return Whether the buffer was written or not, serialization stops on error
+typedef EFI_STATUS
+(EFIAPI
+*XML_WRITE) (
+  IN UINTN  Size,
+  IN VOID  *Buffer,
+  IN VOID  *Context OPTIONAL
+);
+// XML_QUERY_MATCH
+/// XML query match callback
+/// @param Tree    The matched document tree node view
+/// @param Index   The index of the match
+/// @param Context The context passed when the query started
+/// @retval TRUE  If the query should continue
+/// @retval FALSE If the query should stop
+typedef BOOLEAN
+(EFIAPI
+*XML_QUERY_MATCH) (
+  IN XML_TREE *Tree,
+  IN UINTN     Index,
+  IN VOID     *Context OPTIONAL
+);
 
 // XmlCreate
 /// Create an XML parser
@@ -192,9 +250,10 @@ XmlDocumentInspect (
 /// @param LevelIndex The index of the tree node relative to the previous level
 /// @param Inspector  The inspection callback
 /// @param Context    The context to pass to the inspection callback
-/// @param Recursive Whether the inspection should include child nodes
+/// @param Recursive  Whether the inspection should include child nodes
 /// @return Whether the inspection finished or not
 /// @retval EFI_INVALID_PARAMETER If Tree or Inspector is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_ABORTED           If inspection was aborted by the callback
 /// @retval EFI_SUCCESS           If inspection finished
 EFI_STATUS
@@ -208,6 +267,240 @@ XmlTreeInspect (
   IN BOOLEAN      Recursive
 );
 
+// XmlWalk
+/// Walk the XML document tree without recursion
+/// @param Parser    The XML parser
+/// @param Walker    The walk callback
+/// @param Context   The context to pass to the walk callback
+/// @param Recursive Whether the walk should include child nodes
+/// @return Whether the walk finished or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Walker is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_ABORTED           If the walk was aborted by the callback
+/// @retval EFI_SUCCESS           If the walk finished
+EFI_STATUS
+EFIAPI
+XmlWalk (
+  IN XML_PARSER *Parser,
+  IN XML_WALK    Walker,
+  IN VOID       *Context OPTIONAL,
+  IN BOOLEAN     Recursive
+);
+// XmlDocumentWalk
+/// Walk the XML document tree without recursion
+/// @param Document  The XML document
+/// @param Walker    The walk callback
+/// @param Context   The context to pass to the walk callback
+/// @param Recursive Whether the walk should include child nodes
+/// @return Whether the walk finished or not
+/// @retval EFI_INVALID_PARAMETER If Document or Walker is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_ABORTED           If the walk was aborted by the callback
+/// @retval EFI_SUCCESS           If the walk finished
+EFI_STATUS
+EFIAPI
+XmlDocumentWalk (
+  IN XML_DOCUMENT *Document,
+  IN XML_WALK      Walker,
+  IN VOID         *Context OPTIONAL,
+  IN BOOLEAN       Recursive
+);
+// XmlTreeWalk
+/// Walk the XML document tree without recursion
+/// @param Tree       The XML document tree node
+/// @param Level      The level of generation of tree nodes, zero for the root
+/// @param LevelIndex The index of the tree node relative to the previous level
+/// @param Walker     The walk callback
+/// @param Context    The context to pass to the walk callback
+/// @param Recursive  Whether the walk should include child nodes
+/// @return Whether the walk finished or not
+/// @retval EFI_INVALID_PARAMETER If Tree or Walker is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_ABORTED           If the walk was aborted by the callback
+/// @retval EFI_SUCCESS           If the walk finished
+EFI_STATUS
+EFIAPI
+XmlTreeWalk (
+  IN XML_TREE *Tree,
+  IN UINTN     Level,
+  IN UINTN     LevelIndex,
+  IN XML_WALK  Walker,
+  IN VOID     *Context OPTIONAL,
+  IN BOOLEAN   Recursive
+);
+
+// XmlWrite
+/// Serialize the XML document of an XML parser
+/// @param Parser   The XML parser
+/// @param Encoding The output encoding or NULL for the document encoding
+/// @param Indent   The count of spaces to indent each level or zero for no formatting
+/// @param Write    The sink callback
+/// @param Context  The context to pass to the sink callback
+/// @return Whether the XML document was serialized or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Write is NULL
+/// @retval EFI_UNSUPPORTED       If the encoding is not supported
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the XML document was serialized successfully
+EFI_STATUS
+EFIAPI
+XmlWrite (
+  IN XML_PARSER *Parser,
+  IN CHAR8      *Encoding OPTIONAL,
+  IN UINTN       Indent,
+  IN XML_WRITE   Write,
+  IN VOID       *Context OPTIONAL
+);
+// XmlDocumentSerialize
+/// Serialize an XML document in one pass through a reused output buffer
+/// @param Document The XML document
+/// @param Encoding The output encoding or NULL for the document encoding
+/// @param Indent   The count of spaces to indent each level or zero for no formatting
+/// @param Write    The sink callback
+/// @param Context  The context to pass to the sink callback
+/// @return Whether the XML document was serialized or not
+/// @retval EFI_INVALID_PARAMETER If Document or Write is NULL
+/// @retval EFI_UNSUPPORTED       If the encoding is not supported
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the XML document was serialized successfully
+EFI_STATUS
+EFIAPI
+XmlDocumentSerialize (
+  IN XML_DOCUMENT *Document,
+  IN CHAR8        *Encoding OPTIONAL,
+  IN UINTN         Indent,
+  IN XML_WRITE     Write,
+  IN VOID         *Context OPTIONAL
+);
+// XmlTreeSerialize
+/// Serialize an XML document tree node and its child nodes in one pass through a reused output buffer
+/// @param Tree     The XML document tree node
+/// @param Encoding The output encoding or NULL for UTF-8
+/// @param Indent   The count of spaces to indent each level or zero for no formatting
+/// @param Write    The sink callback
+/// @param Context  The context to pass to the sink callback
+/// @return Whether the XML document tree node was serialized or not
+/// @retval EFI_INVALID_PARAMETER If Tree or Write is NULL
+/// @retval EFI_UNSUPPORTED       If the encoding is not supported
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the XML document tree node was serialized successfully
+EFI_STATUS
+EFIAPI
+XmlTreeSerialize (
+  IN XML_TREE  *Tree,
+  IN CHAR8     *Encoding OPTIONAL,
+  IN UINTN      Indent,
+  IN XML_WRITE  Write,
+  IN VOID      *Context OPTIONAL
+);
+// XmlDocumentSerializeToBuffer
+/// Serialize an XML document to memory
+/// @param Document The XML document
+/// @param Encoding The output encoding or NULL for the document encoding
+/// @param Indent   The count of spaces to indent each level or zero for no formatting
+/// @param Size     On output, the size, in bytes, of the serialized document
+/// @param Buffer   On output, the serialized document, which must be freed
+/// @return Whether the XML document was serialized or not
+/// @retval EFI_INVALID_PARAMETER If Document, Size, or Buffer is NULL or *Buffer is not NULL
+/// @retval EFI_UNSUPPORTED       If the encoding is not supported
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the XML document was serialized successfully
+EFI_STATUS
+EFIAPI
+XmlDocumentSerializeToBuffer (
+  IN  XML_DOCUMENT  *Document,
+  IN  CHAR8         *Encoding OPTIONAL,
+  IN  UINTN          Indent,
+  OUT UINTN         *Size,
+  OUT VOID         **Buffer
+);
+// XmlDocumentSerializeToFile
+/// Serialize an XML document to a file with buffered writes
+/// @param Document The XML document
+/// @param Encoding The output encoding or NULL for the document encoding
+/// @param Indent   The count of spaces to indent each level or zero for no formatting
+/// @param Handle   The file handle opened for writing at the position to write
+/// @return Whether the XML document was serialized or not
+/// @retval EFI_INVALID_PARAMETER If Document or Handle is NULL
+/// @retval EFI_UNSUPPORTED       If the encoding is not supported
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_VOLUME_FULL       If the file could not be completely written
+/// @retval EFI_SUCCESS           If the XML document was serialized successfully
+EFI_STATUS
+EFIAPI
+XmlDocumentSerializeToFile (
+  IN XML_DOCUMENT    *Document,
+  IN CHAR8           *Encoding OPTIONAL,
+  IN UINTN            Indent,
+  IN EFI_FILE_HANDLE  Handle
+);
+
+// XmlQueryCompile
+/// Compile an XML query that can be reused for any number of runs
+/// @param Path  The query path, steps are separated by / for child steps or // for descendant steps, each step is a tag name or * and
+///               may be followed by predicates [@name], [@name='value'], or [index], a leading / starts at the tree node itself
+/// @param Query On output, the compiled query, which must be freed with XmlQueryFree
+/// @return Whether the query was compiled or not
+/// @retval EFI_INVALID_PARAMETER If Path or Query is NULL, *Query is not NULL, or the query is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the query was compiled successfully
+EFI_STATUS
+EFIAPI
+XmlQueryCompile (
+  IN  CHAR16     *Path,
+  OUT XML_QUERY **Query
+);
+// XmlQueryFree
+/// Free a compiled XML query
+/// @param Query The compiled query to free
+/// @return Whether the compiled query was freed or not
+/// @retval EFI_INVALID_PARAMETER If Query is NULL
+/// @retval EFI_SUCCESS           If the compiled query was freed successfully
+EFI_STATUS
+EFIAPI
+XmlQueryFree (
+  IN XML_QUERY *Query
+);
+// XmlQueryRun
+/// Run a compiled XML query, matches are found in document order and are views that must not be freed
+/// @param Query    The compiled query, which must not be run by more than one caller at the same time
+/// @param Tree     The tree node where the query starts
+/// @param Callback The callback for each matched tree node
+/// @param Context  The context to pass to the callback
+/// @return Whether the query found matches or not
+/// @retval EFI_INVALID_PARAMETER If Query, Tree, or Callback is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_NOT_FOUND         If no tree nodes matched the query
+/// @retval EFI_ABORTED           If the query was stopped by the callback
+/// @retval EFI_SUCCESS           If the query finished with matches
+EFI_STATUS
+EFIAPI
+XmlQueryRun (
+  IN XML_QUERY       *Query,
+  IN XML_TREE        *Tree,
+  IN XML_QUERY_MATCH  Callback,
+  IN VOID            *Context OPTIONAL
+);
+// XmlQuerySelect
+/// Run a compiled XML query and return the matches in a caller supplied array
+/// @param Query   The compiled query, which must not be run by more than one caller at the same time
+/// @param Tree    The tree node where the query starts
+/// @param Count   On input, the count of tree nodes that fit in Matches, on output, the count of matched tree nodes
+/// @param Matches On output, the matched tree nodes in document order, which are views that must not be freed
+/// @return Whether the query found matches or not
+/// @retval EFI_INVALID_PARAMETER If Query, Tree, or Count is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_NOT_FOUND         If no tree nodes matched the query
+/// @retval EFI_BUFFER_TOO_SMALL  If there were more matches than fit in Matches, which was filled
+/// @retval EFI_SUCCESS           If the matches were returned successfully
+EFI_STATUS
+EFIAPI
+XmlQuerySelect (
+  IN     XML_QUERY  *Query,
+  IN     XML_TREE   *Tree,
+  IN OUT UINTN      *Count,
+  OUT    XML_TREE  **Matches OPTIONAL
+);
+
 // XmlGetDocument
 /// Get XML document
 /// @param Parser   An XML parser
@@ -247,6 +540,41 @@ XmlGetTree (
   IN  XML_PARSER  *Parser,
   OUT XML_TREE   **Tree
 );
+// XmlGetMessageCount
+/// Get the count of retained XML parser errors and warnings
+/// @param Parser  An XML parser
+/// @param Count   On output, the count of retained messages
+/// @param Dropped On output, the count of messages dropped because too many messages were added
+/// @return Whether the count of messages was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Count is NULL
+/// @retval EFI_SUCCESS           If the count of messages was retrieved successfully
+EFI_STATUS
+EFIAPI
+XmlGetMessageCount (
+  IN  XML_PARSER *Parser,
+  OUT UINTN      *Count,
+  OUT UINTN      *Dropped OPTIONAL
+);
+// XmlGetMessage
+/// Get a retained XML parser error or warning
+/// @param Parser   An XML parser
+/// @param Index    The index of the message, from the oldest retained message
+/// @param Flags    On output, the message flags, LANG_MESSAGE_ERROR or LANG_MESSAGE_WARNING
+/// @param Position On output, the input position at which the message was added
+/// @param Message  On output, the message, which must not be freed and is valid until the parser is reset or freed
+/// @return Whether the message was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Message is NULL
+/// @retval EFI_NOT_FOUND         If Index is not less than the count of retained messages
+/// @retval EFI_SUCCESS           If the message was retrieved successfully
+EFI_STATUS
+EFIAPI
+XmlGetMessage (
+  IN  XML_PARSER     *Parser,
+  IN  UINTN           Index,
+  OUT UINTN          *Flags OPTIONAL,
+  OUT LANG_POSITION  *Position OPTIONAL,
+  OUT CHAR16        **Message
+);
 
 // XmlDocumentGetEncoding
 /// Get XML document encoding
@@ -333,6 +661,7 @@ XmlTreeGetTag (
 /// @param Tag  The XML document tree tag name to set
 /// @return Whether the XML document tree tag name was set or not
 /// @retval EFI_INVALID_PARAMETER If Tree or Tag is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_SUCCESS           If the XML document tree tag name was set successfully
 EFI_STATUS
 EFIAPI
@@ -359,6 +688,7 @@ XmlTreeGetValue (
 /// @param Value The XML document tree node value to set
 /// @return Whether the XML document tree node value was set or not
 /// @retval EFI_INVALID_PARAMETER If Tree or Value is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_SUCCESS           If the XML document tree node value was set successfully
 EFI_STATUS
 EFIAPI
@@ -377,14 +707,43 @@ EFIAPI
 XmlTreeHasChildren (
   IN  XML_TREE *Tree
 );
+// XmlTreeGetFirstChild
+/// Get XML document tree node first child node
+/// @param Tree  An XML document tree node
+/// @param Child On output, the XML document tree node first child node
+/// @return Whether the XML document tree node first child node was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Tree or Child is NULL
+/// @retval EFI_NOT_FOUND         If there are no XML document tree child nodes
+/// @retval EFI_SUCCESS           If the XML document tree node first child node was retrieved successfully
+EFI_STATUS
+EFIAPI
+XmlTreeGetFirstChild (
+  IN  XML_TREE  *Tree,
+  OUT XML_TREE **Child
+);
+// XmlTreeGetNextSibling
+/// Get XML document tree node next sibling node
+/// @param Tree    An XML document tree node
+/// @param Sibling On output, the XML document tree node next sibling node
+/// @return Whether the XML document tree node next sibling node was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Tree or Sibling is NULL
+/// @retval EFI_NOT_FOUND         If there are no more XML document tree sibling nodes
+/// @retval EFI_SUCCESS           If the XML document tree node next sibling node was retrieved successfully
+EFI_STATUS
+EFIAPI
+XmlTreeGetNextSibling (
+  IN  XML_TREE  *Tree,
+  OUT XML_TREE **Sibling
+);
 // XmlTreeGetChildren
 /// Get XML document tree node child nodes
 /// @param Tree     An XML document tree
-/// @param Children On output, the XML document tree node child nodes, which must be freed
+/// @param Children On output, the XML document tree node child nodes view, which must not be freed and is valid until the parser is reset or freed
 /// @param Count    On output, the count of children
 /// @return Whether the XML document tree child nodes were retrieved or not
-/// @retval EFI_INVALID_PARAMETER If Tree, Children, or Count is NULL or *Children is not NULL
+/// @retval EFI_INVALID_PARAMETER If Tree, Children, or Count is NULL
 /// @retval EFI_NOT_FOUND         If there are no XML document tree child nodes
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_SUCCESS           If the XML document tree child nodes were retrieved successfully
 EFI_STATUS
 EFIAPI
@@ -396,18 +755,18 @@ XmlTreeGetChildren (
 // XmlTreeGetAttributes
 /// Get XML document tree node attributes
 /// @param Tree       An XML document tree
-/// @param Attributes On output, the XML document tree node attributes, which must be freed
+/// @param Attributes On output, the XML document tree node attributes view, which must not be freed and is valid until the tree node attributes change
 /// @param Count      On output, the count of attributes
 /// @return Whether the XML document tree attributes were retrieved or not
-/// @retval EFI_INVALID_PARAMETER If Tree, Attributes, or Count is NULL or *Attributes is not NULL
+/// @retval EFI_INVALID_PARAMETER If Tree, Attributes, or Count is NULL
 /// @retval EFI_NOT_FOUND         If there are no XML document tree attibutes
 /// @retval EFI_SUCCESS           If the XML document tree attributes were retrieved successfully
 EFI_STATUS
 EFIAPI
 XmlTreeGetAttributes (
-  IN  XML_TREE        *Tree,
-  OUT XML_ATTRIBUTE ***Attributes,
-  OUT UINTN           *Count
+  IN  XML_TREE       *Tree,
+  OUT XML_ATTRIBUTE **Attributes,
+  OUT UINTN          *Count
 );
 // XmlTreeGetAttribute
 /// Get an XML document tree node attribute
@@ -431,7 +790,8 @@ XmlTreeGetAttribute (
 /// @param Name      The XML document tree node attribute name
 /// @param Attribute The XML document tree attribute to set
 /// @return Whether the XML document tree attribute was set or not
-/// @retval EFI_INVALID_PARAMETER If Tree, Name, or Attribute is NULL
+/// @retval EFI_INVALID_PARAMETER If Tree, Name, Attribute, or Attribute->Name is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_SUCCESS           If the XML document tree attribute was set successfully
 EFI_STATUS
 EFIAPI
@@ -446,6 +806,7 @@ XmlTreeSetAttribute (
 /// @param Name The name of the XML document tree node attribute to remove
 /// @return Whether the XML document tree attribute was removed or not
 /// @retval EFI_INVALID_PARAMETER If Tree or Name is NULL
+/// @retval EFI_NOT_FOUND         If the XML document tree attibute was not found
 /// @retval EFI_SUCCESS           If the XML document tree attribute was removed successfully
 EFI_STATUS
 EFIAPI
@@ -0,0 +1,167 @@
+//
+/// @file Library/ConfigLib/ConfigIni.c
+///
+/// Configuration INI front end
+///
+
+#include "ConfigText.h"
+
+// mConfigIniStates
+/// Static INI states
+DECL_LANG_STATES(mConfigIniStates)
+  // CONFIG_INI_STATE_LINE
+  DECL_LANG_STATE(CONFIG_INI_STATE_LINE, 4)
+    DECL_LANG_RULE(LANG_RULE_TOKEN, CONFIG_INI_STATE_SECTION, 1, L"["),
+    DECL_LANG_RULE(LANG_RULE_TOKEN, CONFIG_INI_STATE_COMMENT, 2, L";", L"#"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN, CONFIG_INI_STATE_VALUE, 1, L"="),
+    DECL_LANG_RULE(LANG_RULE_TOKEN, CONFIG_INI_STATE_LINE, 1, L"\n"),
+  END_LANG_STATE(),
+  // CONFIG_INI_STATE_SECTION
+  DECL_LANG_STATE(CONFIG_INI_STATE_SECTION, 2)
+    DECL_LANG_RULE(LANG_RULE_TOKEN, CONFIG_INI_STATE_COMMENT, 1, L"]"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN, CONFIG_INI_STATE_LINE, 1, L"\n"),
+  END_LANG_STATE(),
+  // CONFIG_INI_STATE_VALUE
+  DECL_LANG_STATE(CONFIG_INI_STATE_VALUE, 1)
+    DECL_LANG_RULE(LANG_RULE_TOKEN, CONFIG_INI_STATE_LINE, 1, L"\n"),
+  END_LANG_STATE(),
+  // CONFIG_INI_STATE_COMMENT
+  DECL_LANG_STATE(CONFIG_INI_STATE_COMMENT, 1)
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP_TOKEN | LANG_RULE_SKIP, CONFIG_INI_STATE_LINE, 1, L"\n"),
+  END_LANG_STATE(),
+END_LANG_STATES();
+
+// ConfigIniCallback
+/// INI token parsed callback
+/// @param Parser  The language parser
+/// @param StateId The current language parser state identifier
+/// @param Token   The parsed token
+/// @param Context The configuration text parser
+/// @return Whether the token was valid or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigIniCallback (
+  IN OUT LANG_PARSER *Parser,
+  IN     UINTN        StateId,
+  IN     CHAR16      *Token,
+  IN     VOID        *Context
+) {
+  EFI_STATUS   Status;
+  CONFIG_TEXT *Text = (CONFIG_TEXT *)Context;
+  CHAR16      *Path;
+  UINTN        TokenLength;
+  if (Text == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Token == NULL) {
+    return EFI_SUCCESS;
+  }
+  TokenLength = StrLen(Token);
+  if (TokenLength == 0) {
+    return EFI_SUCCESS;
+  }
+  switch (StateId) {
+    case CONFIG_INI_STATE_LINE:
+      if (StrCmp(Token, L"=") == 0) {
+        // Start the value of the key
+        if (Text->Key == NULL) {
+          ParseError(Parser, L"Missing key");
+          return EFI_INVALID_PARAMETER;
+        }
+        StrBuilderReset(&(Text->Value));
+        return EFI_SUCCESS;
+      }
+      if ((StrCmp(Token, L"[") == 0) || (StrCmp(Token, L";") == 0) ||
+          (StrCmp(Token, L"#") == 0) || (StrCmp(Token, L"\n") == 0)) {
+        // Sections, comments and line breaks must not follow a key
+        if (Text->Key != NULL) {
+          ParseError(Parser, L"Expected \"=\" after key \"%s\"", Text->Key);
+          return EFI_INVALID_PARAMETER;
+        }
+        // A new section starts at the root
+        if ((*Token == L'[') && (Text->Section != NULL)) {
+          FreePool(Text->Section);
+          Text->Section = NULL;
+        }
+        return EFI_SUCCESS;
+      }
+      // Key, whitespace between lines is ignored
+      Token = ConfigTextTrim(Token);
+      if (*Token == L'\0') {
+        return EFI_SUCCESS;
+      }
+      Text->Key = StrDup(Token);
+      return (Text->Key == NULL) ? EFI_OUT_OF_RESOURCES : EFI_SUCCESS;
+
+    case CONFIG_INI_STATE_SECTION:
+      if (StrCmp(Token, L"]") == 0) {
+        return EFI_SUCCESS;
+      }
+      if (StrCmp(Token, L"\n") == 0) {
+        ParseError(Parser, L"Unterminated section");
+        return EFI_INVALID_PARAMETER;
+      }
+      // Section path, an empty section is the root
+      Token = ConfigTextTrim(Token);
+      if (*Token == L'\0') {
+        return EFI_SUCCESS;
+      }
+      Text->Section = FileMakePath(NULL, Token);
+      return (Text->Section == NULL) ? EFI_OUT_OF_RESOURCES : EFI_SUCCESS;
+
+    case CONFIG_INI_STATE_VALUE:
+      if (StrCmp(Token, L"\n") != 0) {
+        // Value text
+        return StrBuilderAppend(&(Text->Value), Token, TokenLength);
+      }
+      // Set the value at the end of the line
+      if (Text->Key == NULL) {
+        return EFI_NOT_FOUND;
+      }
+      Path = FileMakePath(Text->Section, Text->Key);
+      FreePool(Text->Key);
+      Text->Key = NULL;
+      if (Path == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      Status = ConfigTextSetValue(Text, Path, (Text->Value.Count == 0) ? L"" : ConfigTextTrim(Text->Value.Buffer));
+      FreePool(Path);
+      StrBuilderReset(&(Text->Value));
+      return Status;
+
+    default:
+      break;
+  }
+  return EFI_NOT_FOUND;
+}
+
+// ConfigIniCreateParser
+/// Create a language parser for INI configuration
+/// @param Parser On output, the language parser, which must be freed with FreeParser
+/// @return Whether the language parser was created or not
+EFI_STATUS
+EFIAPI
+ConfigIniCreateParser (
+  OUT LANG_PARSER **Parser
+) {
+  return CreateParserFromStates(Parser, ConfigIniCallback, CONFIG_INI_STATE_LINE, ARRAY_SIZE(mConfigIniStates), mConfigIniStates);
+}
+// ConfigIniFinish
+/// Check an INI configuration did not end inside a section name
+/// @param Text The configuration text parser
+/// @return Whether the INI configuration was complete or not
+/// @retval EFI_INVALID_PARAMETER If the INI configuration is incomplete
+/// @retval EFI_SUCCESS           If the INI configuration was complete
+EFI_STATUS
+EFIAPI
+ConfigIniFinish (
+  IN OUT CONFIG_TEXT *Text
+) {
+  UINTN StateId = CONFIG_INI_STATE_LINE;
+  GetParseState(Text->Parser, &StateId);
+  if ((StateId == CONFIG_INI_STATE_SECTION) || (Text->Key != NULL)) {
+    ParseError(Text->Parser, L"Unexpected end of configuration");
+    return EFI_INVALID_PARAMETER;
+  }
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,449 @@
+//
+/// @file Library/ConfigLib/ConfigJson.c
+///
+/// Configuration JSON front end
+///
+
+#include "ConfigText.h"
+
+// mConfigJsonStates
+/// Static JSON states, structure is checked by the callback so no document is built
+DECL_LANG_STATES(mConfigJsonStates)
+  // CONFIG_JSON_STATE_VALUE
+  DECL_LANG_STATE(CONFIG_JSON_STATE_VALUE, 3)
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_PUSH, CONFIG_JSON_STATE_STRING, 1, L"\""),
+    DECL_LANG_RULE(LANG_RULE_TOKEN, CONFIG_JSON_STATE_VALUE, 6, L"{", L"}", L"[", L"]", L":", L","),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP, CONFIG_JSON_STATE_VALUE, 4, L" ", L"\t", L"\r", L"\n"),
+  END_LANG_STATE(),
+  // CONFIG_JSON_STATE_STRING
+  DECL_LANG_STATE(CONFIG_JSON_STATE_STRING, 3)
+    DECL_LANG_RULE(LANG_RULE_TOKEN, LANG_STATE_PREVIOUS, 1, L"\""),
+    DECL_LANG_RULE(LANG_RULE_TOKEN, CONFIG_JSON_STATE_STRING, 9, L"\\\"", L"\\\\", L"\\/", L"\\b", L"\\f", L"\\n", L"\\r", L"\\t", L"\\u"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN, CONFIG_JSON_STATE_STRING, 1, L"\\"),
+  END_LANG_STATE(),
+END_LANG_STATES();
+
+// ConfigJsonMemberPath
+/// Create the configuration path of the next member of the innermost open container
+/// @param Text The configuration text parser
+/// @param Path On output, the configuration path, which must be freed, or NULL for the root value
+/// @return Whether the configuration path was created or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the configuration path was created successfully
+STATIC EFI_STATUS
+EFIAPI
+ConfigJsonMemberPath (
+  IN OUT CONFIG_TEXT  *Text,
+  OUT    CHAR16      **Path
+) {
+  CONFIG_TEXT_LEVEL *Level;
+  *Path = NULL;
+  if (Text->Depth == 0) {
+    return EFI_SUCCESS;
+  }
+  // Array members are indexed like configuration groups and object members are named by their keys
+  Level = Text->Levels + (Text->Depth - 1);
+  Level->Empty = FALSE;
+  if (Level->Array) {
+    *Path = CatSPrint(NULL, L"%s\\%u", (Level->Path == NULL) ? L"" : Level->Path, Level->Index++);
+  } else if (Text->Key != NULL) {
+    *Path = FileMakePath(Level->Path, Text->Key);
+    FreePool(Text->Key);
+    Text->Key = NULL;
+  }
+  return (*Path == NULL) ? EFI_OUT_OF_RESOURCES : EFI_SUCCESS;
+}
+// ConfigJsonValueDone
+/// Finish a value, the next token separates or closes the container
+/// @param Text The configuration text parser
+STATIC VOID
+EFIAPI
+ConfigJsonValueDone (
+  IN OUT CONFIG_TEXT *Text
+) {
+  Text->Expect = (Text->Depth == 0) ? CONFIG_JSON_EXPECT_END : CONFIG_JSON_EXPECT_NEXT;
+}
+// ConfigJsonOpen
+/// Open an object or array container
+/// @param Text  The configuration text parser
+/// @param Array Whether the container is an array or an object
+/// @return Whether the container was opened or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigJsonOpen (
+  IN OUT CONFIG_TEXT *Text,
+  IN     BOOLEAN      Array
+) {
+  EFI_STATUS         Status;
+  CONFIG_TEXT_LEVEL *Level;
+  CHAR16            *Path = NULL;
+  if (Text->Depth >= CONFIG_TEXT_MAX_DEPTH) {
+    ParseError(Text->Parser, L"Containers nested too deeply");
+    return EFI_INVALID_PARAMETER;
+  }
+  Status = ConfigJsonMemberPath(Text, &Path);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Push the container
+  Level = Text->Levels + (Text->Depth++);
+  Level->Path = Path;
+  Level->Index = 0;
+  Level->Array = Array;
+  Level->Empty = TRUE;
+  Text->Expect = Array ? CONFIG_JSON_EXPECT_VALUE : CONFIG_JSON_EXPECT_KEY;
+  return EFI_SUCCESS;
+}
+// ConfigJsonClose
+/// Close the innermost open container
+/// @param Text  The configuration text parser
+/// @param Array Whether the closing token closes an array or an object
+/// @return Whether the container was closed or not
+/// @retval EFI_NOT_FOUND If the closing token was unexpected
+/// @retval EFI_SUCCESS   If the container was closed successfully
+STATIC EFI_STATUS
+EFIAPI
+ConfigJsonClose (
+  IN OUT CONFIG_TEXT *Text,
+  IN     BOOLEAN      Array
+) {
+  CONFIG_TEXT_LEVEL *Level;
+  if (Text->Depth == 0) {
+    return EFI_NOT_FOUND;
+  }
+  // Containers close after a member or when still empty, trailing separators are not allowed
+  Level = Text->Levels + (Text->Depth - 1);
+  if ((Level->Array != Array) ||
+      ((Text->Expect != CONFIG_JSON_EXPECT_NEXT) &&
+       (!Level->Empty || (Text->Expect != (Array ? CONFIG_JSON_EXPECT_VALUE : CONFIG_JSON_EXPECT_KEY))))) {
+    return EFI_NOT_FOUND;
+  }
+  // Pop the container
+  if (Level->Path != NULL) {
+    FreePool(Level->Path);
+    Level->Path = NULL;
+  }
+  --(Text->Depth);
+  ConfigJsonValueDone(Text);
+  return EFI_SUCCESS;
+}
+// ConfigJsonLiteral
+/// Set a configuration value from a JSON literal
+/// @param Text  The configuration text parser
+/// @param Token The literal
+/// @return Whether the literal was valid or not
+/// @retval EFI_NOT_FOUND If the literal was unexpected or invalid
+STATIC EFI_STATUS
+EFIAPI
+ConfigJsonLiteral (
+  IN OUT CONFIG_TEXT *Text,
+  IN     CHAR16      *Token
+) {
+  EFI_STATUS  Status;
+  CHAR16     *Path = NULL;
+  // Literals are only members of containers
+  if ((Text->Expect != CONFIG_JSON_EXPECT_VALUE) || (Text->Depth == 0)) {
+    return EFI_NOT_FOUND;
+  }
+  Status = ConfigJsonMemberPath(Text, &Path);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  if (StrCmp(Token, L"true") == 0) {
+    Status = ConfigTextSetBoolean(Text, Path, TRUE);
+  } else if (StrCmp(Token, L"false") == 0) {
+    Status = ConfigTextSetBoolean(Text, Path, FALSE);
+  } else if (StrCmp(Token, L"null") == 0) {
+    // Null members have no value
+    Status = EFI_SUCCESS;
+  } else {
+    Status = ConfigTextSetNumber(Text, Path, Token, FALSE);
+  }
+  FreePool(Path);
+  if (!EFI_ERROR(Status)) {
+    ConfigJsonValueDone(Text);
+  }
+  return Status;
+}
+// ConfigJsonUnicode
+/// Append the character of a JSON unicode escape, surrogate pairs are combined
+/// @param Text   The configuration text parser
+/// @param Token  The text following the unicode escape, which starts with four hexadecimal digits
+/// @param Length On output, the count of characters used from the text
+/// @return Whether the unicode escape was valid or not
+/// @retval EFI_NOT_FOUND If the unicode escape was invalid
+STATIC EFI_STATUS
+EFIAPI
+ConfigJsonUnicode (
+  IN OUT CONFIG_TEXT *Text,
+  IN     CHAR16      *Token,
+  OUT    UINTN       *Length
+) {
+  CHAR16 Buffer[2];
+  UINT32 Character = 0;
+  UINTN  Index;
+  // Decode the four hexadecimal digits
+  for (Index = 0; Index < 4; ++Index) {
+    CHAR16 Digit = Token[Index];
+    Character <<= 4;
+    if ((Digit >= L'0') && (Digit <= L'9')) {
+      Character |= (UINT32)(Digit - L'0');
+    } else if ((Digit >= L'a') && (Digit <= L'f')) {
+      Character |= (UINT32)(Digit - L'a' + 10);
+    } else if ((Digit >= L'A') && (Digit <= L'F')) {
+      Character |= (UINT32)(Digit - L'A' + 10);
+    } else {
+      return EFI_NOT_FOUND;
+    }
+  }
+  *Length = 4;
+  Text->Unicode = FALSE;
+  // High surrogates wait for the low surrogate of the next escape
+  if ((Character >= 0xD800) && (Character <= 0xDBFF)) {
+    if (Text->Surrogate != 0) {
+      return EFI_NOT_FOUND;
+    }
+    Text->Surrogate = Character;
+    return EFI_SUCCESS;
+  }
+  if ((Character >= 0xDC00) && (Character <= 0xDFFF)) {
+    if (Text->Surrogate == 0) {
+      return EFI_NOT_FOUND;
+    }
+    Buffer[0] = (CHAR16)Text->Surrogate;
+    Buffer[1] = (CHAR16)Character;
+    Text->Surrogate = 0;
+    return StrBuilderAppend(&(Text->Value), Buffer, 2);
+  }
+  if ((Text->Surrogate != 0) || (Character == 0)) {
+    return EFI_NOT_FOUND;
+  }
+  Buffer[0] = (CHAR16)Character;
+  return StrBuilderAppend(&(Text->Value), Buffer, 1);
+}
+// ConfigJsonString
+/// Parse a JSON string token
+/// @param Text        The configuration text parser
+/// @param Token       The string token
+/// @param TokenLength The length of the string token
+/// @return Whether the string token was valid or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigJsonString (
+  IN OUT CONFIG_TEXT *Text,
+  IN     CHAR16      *Token,
+  IN     UINTN        TokenLength
+) {
+  EFI_STATUS  Status;
+  CHAR16     *Path = NULL;
+  CHAR16      Character;
+  UINTN       Length = 0;
+  // End of string
+  if ((TokenLength == 1) && (*Token == L'"')) {
+    if (Text->Unicode || (Text->Surrogate != 0)) {
+      return EFI_NOT_FOUND;
+    }
+    if (Text->Expect == CONFIG_JSON_EXPECT_KEY) {
+      // Object member key, empty keys have no path
+      if (Text->Value.Count == 0) {
+        ParseError(Text->Parser, L"Empty key");
+        return EFI_INVALID_PARAMETER;
+      }
+      Text->Key = StrnDup(Text->Value.Buffer, Text->Value.Count);
+      if (Text->Key == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      Text->Expect = CONFIG_JSON_EXPECT_COLON;
+      return EFI_SUCCESS;
+    }
+    // String value
+    Status = ConfigJsonMemberPath(Text, &Path);
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+    Status = ConfigTextSetString(Text, Path, (Text->Value.Count == 0) ? L"" : Text->Value.Buffer);
+    FreePool(Path);
+    if (!EFI_ERROR(Status)) {
+      ConfigJsonValueDone(Text);
+    }
+    return Status;
+  }
+  // Escape sequence
+  if (*Token == L'\\') {
+    if (Text->Unicode || (TokenLength != 2)) {
+      return EFI_NOT_FOUND;
+    }
+    if (Token[1] == L'u') {
+      Text->Unicode = TRUE;
+      return EFI_SUCCESS;
+    }
+    if (Text->Surrogate != 0) {
+      return EFI_NOT_FOUND;
+    }
+    switch (Token[1]) {
+      case L'b':
+        Character = L'\b';
+        break;
+
+      case L'f':
+        Character = L'\f';
+        break;
+
+      case L'n':
+        Character = L'\n';
+        break;
+
+      case L'r':
+        Character = L'\r';
+        break;
+
+      case L't':
+        Character = L'\t';
+        break;
+
+      default:
+        Character = Token[1];
+        break;
+    }
+    return StrBuilderAppend(&(Text->Value), &Character, 1);
+  }
+  // Text, which starts with the digits of a unicode escape if one is pending
+  if (Text->Unicode) {
+    if (TokenLength < 4) {
+      return EFI_NOT_FOUND;
+    }
+    Status = ConfigJsonUnicode(Text, Token, &Length);
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+  }
+  if (Length >= TokenLength) {
+    return EFI_SUCCESS;
+  }
+  if (Text->Surrogate != 0) {
+    return EFI_NOT_FOUND;
+  }
+  return StrBuilderAppend(&(Text->Value), Token + Length, TokenLength - Length);
+}
+// ConfigJsonCallback
+/// JSON token parsed callback
+/// @param Parser  The language parser
+/// @param StateId The current language parser state identifier
+/// @param Token   The parsed token
+/// @param Context The configuration text parser
+/// @return Whether the token was valid or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigJsonCallback (
+  IN OUT LANG_PARSER *Parser,
+  IN     UINTN        StateId,
+  IN     CHAR16      *Token,
+  IN     VOID        *Context
+) {
+  CONFIG_TEXT *Text = (CONFIG_TEXT *)Context;
+  UINTN        TokenLength;
+  if (Text == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Token == NULL) {
+    return EFI_SUCCESS;
+  }
+  TokenLength = StrLen(Token);
+  if (TokenLength == 0) {
+    return EFI_SUCCESS;
+  }
+  switch (StateId) {
+    case CONFIG_JSON_STATE_STRING:
+      return ConfigJsonString(Text, Token, TokenLength);
+
+    case CONFIG_JSON_STATE_VALUE:
+      if (TokenLength == 1) {
+        switch (*Token) {
+          case L'{':
+          case L'[':
+            // Open a container
+            if (Text->Expect != CONFIG_JSON_EXPECT_VALUE) {
+              return EFI_NOT_FOUND;
+            }
+            return ConfigJsonOpen(Text, (*Token == L'['));
+
+          case L'}':
+          case L']':
+            // Close a container
+            return ConfigJsonClose(Text, (*Token == L']'));
+
+          case L':':
+            // Separate an object member key and value
+            if (Text->Expect != CONFIG_JSON_EXPECT_COLON) {
+              return EFI_NOT_FOUND;
+            }
+            Text->Expect = CONFIG_JSON_EXPECT_VALUE;
+            return EFI_SUCCESS;
+
+          case L',':
+            // Separate container members
+            if ((Text->Expect != CONFIG_JSON_EXPECT_NEXT) || (Text->Depth == 0)) {
+              return EFI_NOT_FOUND;
+            }
+            Text->Expect = Text->Levels[Text->Depth - 1].Array ? CONFIG_JSON_EXPECT_VALUE : CONFIG_JSON_EXPECT_KEY;
+            return EFI_SUCCESS;
+
+          case L'"':
+            // Start a key or string value, root values must be containers
+            if (((Text->Expect != CONFIG_JSON_EXPECT_VALUE) && (Text->Expect != CONFIG_JSON_EXPECT_KEY)) ||
+                (Text->Depth == 0)) {
+              return EFI_NOT_FOUND;
+            }
+            StrBuilderReset(&(Text->Value));
+            Text->Unicode = FALSE;
+            Text->Surrogate = 0;
+            return EFI_SUCCESS;
+
+          default:
+            break;
+        }
+      }
+      // Literal
+      return ConfigJsonLiteral(Text, Token);
+
+    default:
+      break;
+  }
+  return EFI_NOT_FOUND;
+}
+
+// ConfigJsonCreateParser
+/// Create a language parser for JSON configuration
+/// @param Parser On output, the language parser, which must be freed with FreeParser
+/// @return Whether the language parser was created or not
+EFI_STATUS
+EFIAPI
+ConfigJsonCreateParser (
+  OUT LANG_PARSER **Parser
+) {
+  return CreateParserFromStates(Parser, ConfigJsonCallback, CONFIG_JSON_STATE_VALUE, ARRAY_SIZE(mConfigJsonStates), mConfigJsonStates);
+}
+// ConfigJsonFinish
+/// Check a JSON configuration is complete and release the open containers
+/// @param Text The configuration text parser
+/// @return Whether the JSON configuration was complete or not
+/// @retval EFI_INVALID_PARAMETER If the JSON configuration is incomplete
+/// @retval EFI_SUCCESS           If the JSON configuration was complete
+EFI_STATUS
+EFIAPI
+ConfigJsonFinish (
+  IN OUT CONFIG_TEXT *Text
+) {
+  UINTN StateId = CONFIG_JSON_STATE_VALUE;
+  // Check the root container was closed outside of a string
+  GetParseState(Text->Parser, &StateId);
+  if (StateId == CONFIG_JSON_STATE_STRING) {
+    ParseError(Text->Parser, L"Unterminated string");
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Text->Expect != CONFIG_JSON_EXPECT_END) {
+    ParseError(Text->Parser, (Text->Depth == 0) ? L"Missing root object or array" : L"Unterminated object or array");
+    return EFI_INVALID_PARAMETER;
+  }
+  return EFI_SUCCESS;
+}
@@ -4,7 +4,7 @@
 /// Configuration library
 ///
 
-#include <Library/ConfigLib.h>
+#include "ConfigText.h"
 
 #include <Library/LogLib.h>
 #include <Library/SmBiosLib.h>
@@ -151,6 +151,12 @@ struct _CONFIG_TREE {
 // CFGXML_INSPECT_AUTO_GROUP
 /// This configuration key must always be grouped, any children will be placed inside of group zero if not grouped
 #define CFGXML_INSPECT_AUTO_GROUP 0x1
+// CFGXML_INSPECT_SKIP
+/// The children of this tree node are not configuration values
+#define CFGXML_INSPECT_SKIP 0x2
+// CFGXML_WALK_SIZE
+/// The initial count of levels in the configuration XML walk
+#define CFGXML_WALK_SIZE 16
 
 // CFGXML_INSPECT
 /// Configuration XML inspection callback data
@@ -167,6 +173,25 @@ struct _CFGXML_INSPECT {
   /// The options for the configuration value
   UINTN   Options;
 
+};
+// CFGXML_WALK
+/// Configuration XML walk callback data, the inspection data of each level replaces recursion
+typedef struct _CFGXML_WALK CFGXML_WALK;
+struct _CFGXML_WALK {
+
+  // Levels
+  /// The inspection data of the tree nodes from the root to the parent of the next tree node
+  CFGXML_INSPECT *Levels;
+  // Count
+  /// The count of levels in use
+  UINTN           Count;
+  // Size
+  /// The count of levels allocated
+  UINTN           Size;
+  // Status
+  /// The status of the walk
+  EFI_STATUS      Status;
+
 };
 
 // CONFIG_LINK
@@ -223,8 +248,8 @@ ConfigFind2 (
   OUT CONFIG_TREE ***Tree
 ) {
   CONFIG_TREE **Node;
-  CHAR16       *Next;
-  CHAR16       *Name;
+  STR_VIEW      Remaining;
+  STR_VIEW      Name;
   // Check parameters
   if (Tree == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -252,41 +277,27 @@ ConfigFind2 (
     while (*Path == L'\\') {
       ++Path;
     }
-    // Iterate through the configuration tree nodes
-    while (*Path != L'\0') {
+    // Iterate through the configuration tree nodes, the node names are viewed in the path so only created nodes
+    //  allocate their names
+    StrViewFromString(&Remaining, Path);
+    while (StrViewSplit(&Remaining, L"\\", &Name)) {
       // Check if there are any children
       if (!Create && ((*Node)->Children == NULL)) {
-        if (StriCmp(Path, (*Node)->Name) == 0) {
+        if (StriCmp(Name.String, (*Node)->Name) == 0) {
           break;
         }
         // Not found
         return EFI_NOT_FOUND;
       }
-      // Get the next node start
-      Next = StrStr(Path, L"\\");
-      if (Next == NULL) {
-        // Get the node name for which to search
-        Name = StrDup(Path);
-        // Set to end of path if not found
-        Path += StrLen(Path);
-      } else if (Next == Path) {
-        // Skip consecutive separators
-        ++Path;
+      // Skip consecutive separators
+      if (Name.Count == 0) {
         continue;
-      } else {
-        // Get the node name for which to search
-        Name = StrnDup(Path, Next - Path);
-        // Set to after the separator
-        Path = Next + 1;
-      }
-      if (Name == NULL) {
-        return EFI_OUT_OF_RESOURCES;
       }
       // Iterate through children for name
       for (Node = &((*Node)->Children); *Node != NULL; Node = &((*Node)->Next)) {
         // Try to match child name
         if ((*Node)->Name != NULL) {
-          INTN Result = StriCmp(Name, (*Node)->Name);
+          INTN Result = StrViewiCmp(&Name, (*Node)->Name);
           if (Result == 0) {
             // Found the node
             break;
@@ -294,20 +305,21 @@ ConfigFind2 (
             CONFIG_TREE *Next;
             if (!Create) {
               // Not found
-              FreePool(Name);
               return EFI_NOT_FOUND;
             }
             // Insert another node
             Next = (CONFIG_TREE *)AllocateZeroPool(sizeof(CONFIG_TREE));
             if (Next == NULL) {
-              FreePool(Name);
+              return EFI_OUT_OF_RESOURCES;
+            }
+            Next->Name = StrViewDup(&Name);
+            if (Next->Name == NULL) {
+              FreePool(Next);
               return EFI_OUT_OF_RESOURCES;
             }
             Next->Next = *Node;
             Next->Children = NULL;
             Next->Type = CONFIG_TYPE_LIST;
-            // Need to duplicate name here since it will be freed later
-            Next->Name = StrDup(Name);
             *Node = Next;
             break;
           }
@@ -315,24 +327,24 @@ ConfigFind2 (
       }
       // Check if found
       if (*Node == NULL) {
-        if (Create) {
-          // Create new node if needed
-          *Node = (CONFIG_TREE *)AllocateZeroPool(sizeof(CONFIG_TREE));
-          if (*Node == NULL) {
-            FreePool(Name);
-            return EFI_OUT_OF_RESOURCES;
-          }
-          (*Node)->Next = NULL;
-          (*Node)->Children = NULL;
-          (*Node)->Type = CONFIG_TYPE_LIST;
-          (*Node)->Name = Name;
-        } else {
+        if (!Create) {
           // Not found
-          FreePool(Name);
           return EFI_NOT_FOUND;
         }
-      } else {
-        FreePool(Name);
+        // Create new node if needed
+        *Node = (CONFIG_TREE *)AllocateZeroPool(sizeof(CONFIG_TREE));
+        if (*Node == NULL) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+        (*Node)->Name = StrViewDup(&Name);
+        if ((*Node)->Name == NULL) {
+          FreePool(*Node);
+          *Node = NULL;
+          return EFI_OUT_OF_RESOURCES;
+        }
+        (*Node)->Next = NULL;
+        (*Node)->Children = NULL;
+        (*Node)->Type = CONFIG_TYPE_LIST;
       }
     }
   }
@@ -435,6 +447,7 @@ ConfigLoad (
 ) {
   EFI_STATUS      Status;
   EFI_FILE_HANDLE Handle = NULL;
+  CHAR16         *FileName = NULL;
   // Check parameters
   if ((Root == NULL) && (Path == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -444,41 +457,248 @@ ConfigLoad (
     Status = FileHandleOpen(&Handle, Root, Path, EFI_FILE_MODE_READ, 0);
   } else {
     // Get file name of file handle
-    Status = FileHandleGetFileName(Root, &Path);
-    if (!EFI_ERROR(Status) && (Path != NULL)) {
+    Status = FileHandleGetFileName(Root, &FileName);
+    if (!EFI_ERROR(Status) && (FileName != NULL)) {
       // Open configuration file handle
-      Status = FileHandleOpen(&Handle, Root, Path, EFI_FILE_MODE_READ, 0);
-      FreePool(Path);
+      Status = FileHandleOpen(&Handle, Root, FileName, EFI_FILE_MODE_READ, 0);
+      Path = FileName;
     }
   }
   // If file handle is open parse configuration
   if (!EFI_ERROR(Status) && (Handle != NULL)) {
-    UINT64 FileSize = 0;
-    UINTN  Size = 0;
-    // Get file size to read the configuration
-    Status = FileHandleGetSize(Handle, &FileSize);
+    // Parse the configuration in blocks
+    Status = ConfigLoadStream(Handle, 0, Path);
+    // Close the file handle
+    FileHandleClose(Handle);
+  }
+  if (FileName != NULL) {
+    FreePool(FileName);
+  }
+  return Status;
+}
+// ConfigLogXmlMessages
+/// Log the errors and warnings of an XML parser with their input positions
+/// @param Parser The XML parser
+/// @param Source The unique source name
+STATIC VOID
+EFIAPI
+ConfigLogXmlMessages (
+  IN XML_PARSER *Parser,
+  IN CHAR16     *Source OPTIONAL
+) {
+  LANG_POSITION  Position;
+  CHAR16        *Message;
+  UINTN          Flags;
+  UINTN          Count = 0;
+  UINTN          Dropped = 0;
+  UINTN          Index;
+  if (EFI_ERROR(XmlGetMessageCount(Parser, &Count, &Dropped)) || (Count == 0)) {
+    return;
+  }
+  if (Source == NULL) {
+    Source = L"configuration";
+  }
+  // Log each retained message
+  if (Dropped != 0) {
+    LOG(L"%s: %u earlier messages dropped\n", Source, Dropped);
+  }
+  for (Index = 0; Index < Count; ++Index) {
+    if (!EFI_ERROR(XmlGetMessage(Parser, Index, &Flags, &Position, &Message))) {
+      LOG(L"%s(%u:%u): %s: %s\n", Source, Position.Line, Position.Column, (Flags == LANG_MESSAGE_ERROR) ? L"error" : L"warning", Message);
+    }
+  }
+}
+// ConfigLoadBinaryPlist
+/// Load configuration information from an open binary property list file handle
+/// @param Handle The file handle from which to read the rest of the binary property list
+/// @param Size   The size, in bytes, of the first block already read
+/// @param Block  The first block already read
+/// @param Source The unique source name
+/// @return Whether the configuration was loaded successfully or not
+/// @retval EFI_INVALID_PARAMETER If the binary property list is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the binary property list was loaded successfully
+STATIC EFI_STATUS
+EFIAPI
+ConfigLoadBinaryPlist (
+  IN EFI_FILE_HANDLE  Handle,
+  IN UINTN            Size,
+  IN VOID            *Block,
+  IN CHAR16          *Source OPTIONAL
+) {
+  EFI_STATUS  Status;
+  UINT64      FileSize = 0;
+  UINT8      *Buffer;
+  UINTN       Remaining;
+  // Binary property lists are decoded through the offset table at the end so the whole file is needed
+  Status = FileHandleGetSize(Handle, &FileSize);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  if ((FileSize < Size) || (FileSize > MAX_UINTN)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  Buffer = (UINT8 *)AllocatePool((UINTN)FileSize);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Read the rest of the file after the first block
+  CopyMem(Buffer, Block, Size);
+  Remaining = (UINTN)FileSize - Size;
+  if (Remaining > 0) {
+    Status = FileHandleRead(Handle, &Remaining, Buffer + Size);
+  }
+  if (!EFI_ERROR(Status)) {
+    // Parse the binary property list
+    Status = ConfigParseBinaryPlist(Size + Remaining, Buffer, Source);
+  }
+  FreePool(Buffer);
+  return Status;
+}
+// ConfigLoadTextStream
+/// Load configuration text from an open file handle by parsing fixed size blocks
+/// @param Handle    The file handle from which to read the rest of the configuration text
+/// @param Format    The configuration text format
+/// @param BlockSize The size, in bytes, of each block
+/// @param Size      The size, in bytes, of the first block already read
+/// @param Block     The block buffer, which contains the first block
+/// @param Source    The unique source name
+/// @return Whether the configuration was loaded successfully or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigLoadTextStream (
+  IN EFI_FILE_HANDLE  Handle,
+  IN CONFIG_FORMAT    Format,
+  IN UINTN            BlockSize,
+  IN UINTN            Size,
+  IN VOID            *Block,
+  IN CHAR16          *Source OPTIONAL
+) {
+  EFI_STATUS   Status;
+  CONFIG_TEXT *Text = NULL;
+  // Create the configuration text parser
+  Status = ConfigTextCreate(&Text, Format);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Parse each block, values are staged as they are parsed and only set when finished
+  do {
+    Status = ConfigTextParse(Text, Size, Block);
+    if (EFI_ERROR(Status)) {
+      break;
+    }
+    Size = BlockSize;
+    Status = FileHandleRead(Handle, &Size, Block);
+  } while (!EFI_ERROR(Status) && (Size != 0));
+  // Finish the configuration text
+  if (!EFI_ERROR(Status)) {
+    Status = ConfigTextFinish(Text);
+  }
+  // Log the parser errors and warnings then free the parser
+  ConfigTextLogMessages(Text, Source);
+  ConfigTextFree(Text);
+  return Status;
+}
+// ConfigLoadStream
+/// Load configuration information from an open file handle by parsing fixed size blocks
+/// @param Handle    The file handle from which to read the configuration
+/// @param BlockSize The size, in bytes, of each block to read or zero for CONFIG_STREAM_BLOCK_SIZE
+/// @param Source    The unique source name
+/// @return Whether the configuration was loaded successfully or not
+/// @retval EFI_INVALID_PARAMETER If Handle is NULL or BlockSize is less than CONFIG_BPLIST_MAGIC_SIZE
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_NOT_FOUND         If the configuration file was empty
+/// @retval EFI_SUCCESS           If the configuration file was loaded successfully
+EFI_STATUS
+EFIAPI
+ConfigLoadStream (
+  IN EFI_FILE_HANDLE  Handle,
+  IN UINTN            BlockSize OPTIONAL,
+  IN CHAR16          *Source OPTIONAL
+) {
+  EFI_STATUS     Status;
+  XML_PARSER    *Parser = NULL;
+  VOID          *Block;
+  UINTN          Size;
+  UINTN          ReadSize;
+  CONFIG_FORMAT  Format;
+  // Check parameters
+  if (BlockSize == 0) {
+    BlockSize = CONFIG_STREAM_BLOCK_SIZE;
+  }
+  if ((Handle == NULL) || (BlockSize < CONFIG_BPLIST_MAGIC_SIZE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Allocate the block buffer, which is the only buffer needed no matter the file size
+  Block = AllocatePool(BlockSize);
+  if (Block == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Read the first block to detect the format, reads may be short so keep reading until there are enough bytes
+  //  for the binary property list magic and any byte order mark or the file ends
+  Size = 0;
+  do {
+    ReadSize = BlockSize - Size;
+    Status = FileHandleRead(Handle, &ReadSize, ((UINT8 *)Block) + Size);
+    if (EFI_ERROR(Status)) {
+      break;
+    }
+    Size += ReadSize;
+  } while ((ReadSize != 0) && (Size < CONFIG_BPLIST_MAGIC_SIZE));
+  if (EFI_ERROR(Status) || (Size == 0)) {
+    FreePool(Block);
+    // Assume not found if no file contents
+    return EFI_ERROR(Status) ? Status : EFI_NOT_FOUND;
+  }
+  Format = ConfigTextDetectFormat(Size, Block, Source);
+  if (Format != CONFIG_FORMAT_XML) {
+    if (Format == CONFIG_FORMAT_BINARY_PLIST) {
+      // Binary property lists are not text
+      Status = ConfigLoadBinaryPlist(Handle, Size, Block, Source);
+    } else {
+      // JSON and INI are parsed in blocks without a document
+      Status = ConfigLoadTextStream(Handle, Format, BlockSize, Size, Block, Source);
+    }
+    FreePool(Block);
+    return Status;
+  }
+  // Create XML parser
+  Status = XmlCreate(&Parser);
+  if (EFI_ERROR(Status)) {
+    FreePool(Block);
+    return Status;
+  }
+  if (Parser == NULL) {
+    FreePool(Block);
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Parse the first block then read and parse each next block
+  Status = XmlParseStart(Parser, Size, Block);
+  while (!EFI_ERROR(Status)) {
+    Size = BlockSize;
+    Status = FileHandleRead(Handle, &Size, Block);
+    if (EFI_ERROR(Status) || (Size == 0)) {
+      break;
+    }
+    Status = XmlParseNext(Parser, Size, Block);
+  }
+  FreePool(Block);
+  // Finish the XML document
+  if (!EFI_ERROR(Status)) {
+    Status = XmlParseFinish(Parser);
     if (!EFI_ERROR(Status)) {
-      if (FileSize == 0) {
-        // Assume not found if no file size
-        Status = EFI_NOT_FOUND;
-      } else {
-        // Allocate buffer to hold configuration string
-        VOID *Config = (VOID *)AllocateZeroPool(Size = (UINTN)FileSize);
-        if (Config == NULL) {
-          Status = EFI_OUT_OF_RESOURCES;
-        } else {
-          // Read configuration string from file
-          Status = FileHandleRead(Handle, &Size, (VOID *)Config);
-          if (!EFI_ERROR(Status)) {
-            Status = ConfigParse(Size, Config, Path);
-          }
-          FreePool(Config);
-        }
+      XML_TREE *Tree = NULL;
+      // Get the XML document tree root node
+      Status = XmlGetTree(Parser, &Tree);
+      if (!EFI_ERROR(Status)) {
+        // Parse the configuration
+        Status = ConfigParseXml(Tree, Source);
       }
     }
-    // Close the file handle
-    FileHandleClose(Handle);
   }
+  // Log the parser errors and warnings then free the XML parser
+  ConfigLogXmlMessages(Parser, Source);
+  XmlFree(Parser);
   return Status;
 }
 // ConfigParse
@@ -502,6 +722,20 @@ ConfigParse (
   if ((Config == NULL) || (Size == 0)) {
     return EFI_INVALID_PARAMETER;
   }
+  // Binary property lists are decoded without text parsing and JSON and INI without a document
+  switch (ConfigTextDetectFormat(Size, Config, Source)) {
+    case CONFIG_FORMAT_BINARY_PLIST:
+      return ConfigParseBinaryPlist(Size, Config, Source);
+
+    case CONFIG_FORMAT_JSON:
+      return ConfigParseJson(Size, Config, Source);
+
+    case CONFIG_FORMAT_INI:
+      return ConfigParseIni(Size, Config, Source);
+
+    default:
+      break;
+  }
   // Create XML parser
   Status = XmlCreate(&Parser);
   if (EFI_ERROR(Status)) {
@@ -521,73 +755,66 @@ ConfigParse (
       Status = ConfigParseXml(Tree, Source);
     }
   }
-  // Free the XML parser
+  // Log the parser errors and warnings then free the XML parser
+  ConfigLogXmlMessages(Parser, Source);
   XmlFree(Parser);
   return Status;
 }
 
-// ConfigXmlInspector
-/// Configuration XML document tree inspection callback
-/// @param Tree           The document tree node
+// ConfigXmlVisit
+/// Visit a configuration XML document tree node
+/// @param Parent         The inspection data of the parent tree node
+/// @param This           On output, the inspection data of this tree node, the path must be freed if the children are visited
 /// @param Level          The level of generation of tree nodes, zero for the root
 /// @param LevelIndex     The index of the tree node relative to the previous level
 /// @param TagName        The tree node tag name
 /// @param Value          The tree node value
 /// @param AttributeCount The tree node attribute count
-/// @param Attributes     The tree node attributes
-/// @param ChildCount     The tree node child count
-/// @param Children       The tree node children
-/// @param Context        The context passed when inspection started
-/// @retval TRUE  If the inspection should continue
-/// @retval FALSE If the inspection should stop
+/// @param Attributes     The tree node attributes view
+/// @param HasChildren    Whether the tree node has children
+/// @retval TRUE  If the children of the tree node should be visited
+/// @retval FALSE If the children of the tree node should be skipped
 STATIC BOOLEAN
 EFIAPI
-ConfigXmlInspector (
-  IN XML_TREE       *Tree,
-  IN UINTN           Level,
-  IN UINTN           LevelIndex,
-  IN CHAR16         *TagName,
-  IN CHAR16         *Value OPTIONAL,
-  IN UINTN           AttributeCount,
-  IN XML_ATTRIBUTE **Attributes OPTIONAL,
-  IN UINTN           ChildCount,
-  IN XML_TREE      **Children OPTIONAL,
-  IN VOID           *Context OPTIONAL
-) {
-  CFGXML_INSPECT *Parent = (CFGXML_INSPECT *)Context;
-  CFGXML_INSPECT  This = { NULL, NULL, 0 };
-  UINTN           Index;
-  // Check parameters
-  if ((Tree == NULL) || (TagName == NULL)) {
-    return TRUE;
-  }
-  if (Parent != NULL) {
-    This.Source = Parent->Source;
-  }
+ConfigXmlVisit (
+  IN  CFGXML_INSPECT *Parent,
+  OUT CFGXML_INSPECT *This,
+  IN  UINTN           Level,
+  IN  UINTN           LevelIndex,
+  IN  CHAR16         *TagName,
+  IN  CHAR16         *Value OPTIONAL,
+  IN  UINTN           AttributeCount,
+  IN  XML_ATTRIBUTE  *Attributes OPTIONAL,
+  IN  BOOLEAN         HasChildren
+) {
+  UINTN Index;
+  This->Source = Parent->Source;
+  This->Path = NULL;
+  This->Options = 0;
   // Get attributes
   if ((Attributes != NULL) && (AttributeCount > 0)) {
     // Iterate through attributes
     for (Index = 0; Index < AttributeCount; ++Index) {
-      if ((Attributes[Index] != NULL) && (Attributes[Index]->Name != NULL)) {
-        if (StriCmp(Attributes[Index]->Name, L"arch") == 0) {
+      if (Attributes[Index].Name != NULL) {
+        if (StriCmp(Attributes[Index].Name, L"arch") == 0) {
           // Check architectures match
-          if ((Attributes[Index]->Value == NULL) || (StriCmp(Attributes[Index]->Value, PROJECT_ARCH) != 0)) {
+          if ((Attributes[Index].Value == NULL) || (StriCmp(Attributes[Index].Value, PROJECT_ARCH) != 0)) {
             // Skip this tree node since it's intended for a different architecture
-            return TRUE;
+            return FALSE;
           }
-        } else if (StriCmp(Attributes[Index]->Name, L"manufacturer") == 0) {
+        } else if (StriCmp(Attributes[Index].Name, L"manufacturer") == 0) {
           // Check manufacturer matches
           CHAR16 *Manufacturer = ConfigGetStringWithDefault(L"\\System\\Manufacturer", NULL);
-          if ((Manufacturer == NULL) || (Attributes[Index]->Value == NULL) || (StriStr(Manufacturer, Attributes[Index]->Value) != NULL)) {
+          if ((Manufacturer == NULL) || (Attributes[Index].Value == NULL) || (StriStr(Manufacturer, Attributes[Index].Value) != NULL)) {
             // Skip this tree node since it's intended for a different manufacturer
-            return TRUE;
+            return FALSE;
           }
-        } else if (StriCmp(Attributes[Index]->Name, L"product") == 0) {
+        } else if (StriCmp(Attributes[Index].Name, L"product") == 0) {
           // Check product matches
           CHAR16 *ProductName = ConfigGetStringWithDefault(L"\\System\\ProductName", NULL);
-          if ((ProductName == NULL) || (Attributes[Index]->Value == NULL) || (StriStr(ProductName, Attributes[Index]->Value) != NULL)) {
+          if ((ProductName == NULL) || (Attributes[Index].Value == NULL) || (StriStr(ProductName, Attributes[Index].Value) != NULL)) {
             // Skip this tree node since it's intended for a different product
-            return TRUE;
+            return FALSE;
           }
         }
       }
@@ -595,60 +822,57 @@ ConfigXmlInspector (
   }
   // Check for group type
   if (StriCmp(TagName, L"group") == 0) {
-    if ((ChildCount == 0) || (Children == NULL)) {
-      return TRUE;
+    if (!HasChildren) {
+      return FALSE;
     }
     // Create the index of this group
-    This.Path = CatSPrint(NULL, L"%s\\%u", (Parent == NULL) ? L"" : Parent->Path, LevelIndex);
-  } else if ((Level == 1) && (ChildCount == 0) && (Value != NULL) && (StriCmp(TagName, L"include") == 0)) {
+    This->Path = CatSPrint(NULL, L"%s\\%u", (Parent->Path == NULL) ? L"" : Parent->Path, LevelIndex);
+  } else if ((Level == 1) && !HasChildren && (Value != NULL) && (StriCmp(TagName, L"include") == 0)) {
     // Include another configuration but don't include self
-    if ((Parent != NULL) && (StriCmp(Value, Parent->Source) != 0)) {
+    if ((Parent->Source == NULL) || (StriCmp(Value, Parent->Source) != 0)) {
       ConfigLoad(NULL, Value);
     }
-    return TRUE;
-  } else if ((Parent != NULL) && ((Parent->Options & CFGXML_INSPECT_AUTO_GROUP) != 0)) {
+    return FALSE;
+  } else if ((Parent->Options & CFGXML_INSPECT_AUTO_GROUP) != 0) {
     // Auto group this partial path
-    This.Path = CatSPrint(NULL, L"%s\\0\\%s", (Parent == NULL) ? L"" : Parent->Path, TagName);
+    This->Path = CatSPrint(NULL, L"%s\\0\\%s", (Parent->Path == NULL) ? L"" : Parent->Path, TagName);
   } else {
     // Create full path
-    This.Path = FileMakePath((Parent == NULL) ? NULL : Parent->Path, TagName);
+    This->Path = FileMakePath(Parent->Path, TagName);
   }
-  if (This.Path == NULL) {
-    return TRUE;
+  if (This->Path == NULL) {
+    return FALSE;
   }
   // Check if this path is linked
   for (Index = 0; Index < ARRAY_SIZE(mConfigLinks); ++Index) {
     // The path can match a pattern
-    if ((mConfigLinks[Index].Path != NULL) && MetaiMatch(This.Path, mConfigLinks[Index].Path)) {
+    if ((mConfigLinks[Index].Path != NULL) && MetaiMatch(This->Path, mConfigLinks[Index].Path)) {
       // Free the old path
-      FreePool(This.Path);
+      FreePool(This->Path);
+      This->Path = NULL;
       // Check if this is forbid population link
       if (mConfigLinks[Index].Link == NULL) {
-        return TRUE;
+        return FALSE;
       }
       // Duplicate the linked path
-      This.Path = StrDup(mConfigLinks[Index].Link);
-      if (This.Path == NULL) {
-        return TRUE;
+      This->Path = StrDup(mConfigLinks[Index].Link);
+      if (This->Path == NULL) {
+        return FALSE;
       }
       // Found a match and created the linked path
       break;
     }
   }
-  // Get children
-  if ((Children != NULL) && (ChildCount > 0)) {
+  // Visit the children
+  if (HasChildren) {
     // Check if this key is auto grouped
     for (Index = 0; Index < ARRAY_SIZE(mConfigAutoGroups); ++Index) {
-      if (MetaiMatch(This.Path, mConfigAutoGroups[Index])) {
-        This.Options |= CFGXML_INSPECT_AUTO_GROUP;
+      if (MetaiMatch(This->Path, mConfigAutoGroups[Index])) {
+        This->Options |= CFGXML_INSPECT_AUTO_GROUP;
         break;
       }
     }
-    // Iterate through children
-    for (Index = 0; Index < ChildCount; ++Index) {
-      // Inspect each child
-      XmlTreeInspect(Children[Index], Level + 1, Index, ConfigXmlInspector, (VOID *)&This, FALSE);
-    }
+    return TRUE;
   } else if (StriCmp(TagName, L"integer") == 0) {
     // Integer value
     if (Value != NULL) {
@@ -659,72 +883,143 @@ ConfigXmlInspector (
       }
       if ((*Value == L'0') && ((Value[1] == L'x') || (Value[1] == L'X'))) {
         Integer *= (INTN)StrHexToUintn(Value + 2);
-        LOG(L"  %s=0x%0*X\n", This.Path, sizeof(UINTN) << 1, Integer);
+        LOG(L"  %s=0x%0*X\n", This->Path, sizeof(UINTN) << 1, Integer);
       } else {
         Integer *= (INTN)StrDecimalToUintn(Value);
-        LOG(L"  %s=%d\n", This.Path, Integer);
+        LOG(L"  %s=%d\n", This->Path, Integer);
       }
-      ConfigSetInteger(This.Path, Integer, TRUE);
+      ConfigSetInteger(This->Path, Integer, TRUE);
     }
-    FreePool(This.Path);
-    return TRUE;
+    FreePool(This->Path);
+    This->Path = NULL;
+    return FALSE;
   } else if (StriCmp(TagName, L"unsigned") == 0) {
     // Unsigned integer value
     if (Value != NULL) {
       UINTN Unsigned;
       if ((*Value == L'0') && ((Value[1] == L'x') || (Value[1] == L'X'))) {
         Unsigned = StrHexToUintn(Value + 2);
-        LOG(L"  %s=0x%0*X\n", This.Path, sizeof(UINTN) << 1, Unsigned);
+        LOG(L"  %s=0x%0*X\n", This->Path, sizeof(UINTN) << 1, Unsigned);
       } else {
         Unsigned = StrDecimalToUintn(Value);
-        LOG(L"  %s=%u\n", This.Path, Unsigned);
+        LOG(L"  %s=%u\n", This->Path, Unsigned);
       }
-      ConfigSetUnsigned(This.Path, Unsigned, TRUE);
+      ConfigSetUnsigned(This->Path, Unsigned, TRUE);
     }
-    FreePool(This.Path);
-    return TRUE;
+    FreePool(This->Path);
+    This->Path = NULL;
+    return FALSE;
   } else if (StriCmp(TagName, L"data") == 0) {
     // Data base64 value
     UINTN  Size = 0;
     VOID  *Data = NULL;
     if (!EFI_ERROR(FromBase64(Value, &Size, &Data)) && (Data != NULL)) {
       if (Size > 0) {
-        LOG(L"  %s=%s\n", This.Path, Value);
-        ConfigSetData(This.Path, Size, Data, TRUE);
+        LOG(L"  %s=%s\n", This->Path, Value);
+        ConfigSetData(This->Path, Size, Data, TRUE);
       }
       FreePool(Data);
     }
-    FreePool(This.Path);
-    return TRUE;
+    FreePool(This->Path);
+    This->Path = NULL;
+    return FALSE;
   } else if (StriCmp(TagName, L"boolean") == 0) {
     // Boolean value
     if (Value != NULL) {
       BOOLEAN Boolean = ((StriCmp(Value, L"true") == 0) || (StriCmp(Value, L"on") == 0) || (StriCmp(Value, L"yes") == 0) ||
                          ((*Value == L'0') && ((Value[1] == L'x') || (Value[1] == L'X')) && (StrHexToUintn(Value + 2) != 0)) ||
                          (StrDecimalToUintn(Value) != 0));
-      LOG(L"  %s=%s\n", This.Path, Boolean ? L"true" : L"false");
-      ConfigSetBoolean(This.Path, Boolean, TRUE);
+      LOG(L"  %s=%s\n", This->Path, Boolean ? L"true" : L"false");
+      ConfigSetBoolean(This->Path, Boolean, TRUE);
     }
-    FreePool(This.Path);
-    return TRUE;
+    FreePool(This->Path);
+    This->Path = NULL;
+    return FALSE;
   } else if (StriCmp(TagName, L"true") == 0) {
     // True
-    LOG(L"  %s=true\n", This.Path);
-    ConfigSetBoolean(This.Path, TRUE, TRUE);
-    FreePool(This.Path);
-    return TRUE;
+    LOG(L"  %s=true\n", This->Path);
+    ConfigSetBoolean(This->Path, TRUE, TRUE);
+    FreePool(This->Path);
+    This->Path = NULL;
+    return FALSE;
   } else if (StriCmp(TagName, L"false") == 0) {
     // False
-    LOG(L"  %s=false\n", This.Path);
-    ConfigSetBoolean(This.Path, FALSE, TRUE);
-    FreePool(This.Path);
-    return TRUE;
+    LOG(L"  %s=false\n", This->Path);
+    ConfigSetBoolean(This->Path, FALSE, TRUE);
+    FreePool(This->Path);
+    This->Path = NULL;
+    return FALSE;
   } else if (Value != NULL) {
     // Value
-    LOG(L"  %s=\"%s\"\n", This.Path, Value);
-    ConfigSetString(This.Path, Value, TRUE);
+    LOG(L"  %s=\"%s\"\n", This->Path, Value);
+    ConfigSetString(This->Path, Value, TRUE);
+  }
+  FreePool(This->Path);
+  This->Path = NULL;
+  return FALSE;
+}
+// ConfigXmlWalker
+/// Configuration XML document tree walk callback
+/// @param Tree           The document tree node
+/// @param Level          The level of generation of tree nodes, zero for the root
+/// @param LevelIndex     The index of the tree node relative to the previous level
+/// @param TagName        The tree node tag name
+/// @param Value          The tree node value
+/// @param AttributeCount The tree node attribute count
+/// @param Attributes     The tree node attributes view
+/// @param FirstChild     The tree node first child
+/// @param Context        The configuration XML walk data
+/// @retval TRUE  If the walk should continue
+/// @retval FALSE If the walk should stop
+STATIC BOOLEAN
+EFIAPI
+ConfigXmlWalker (
+  IN XML_TREE      *Tree,
+  IN UINTN          Level,
+  IN UINTN          LevelIndex,
+  IN CHAR16        *TagName,
+  IN CHAR16        *Value OPTIONAL,
+  IN UINTN          AttributeCount,
+  IN XML_ATTRIBUTE *Attributes OPTIONAL,
+  IN XML_TREE      *FirstChild OPTIONAL,
+  IN VOID          *Context OPTIONAL
+) {
+  CFGXML_WALK    *Walk = (CFGXML_WALK *)Context;
+  CFGXML_INSPECT *Levels;
+  CFGXML_INSPECT *This;
+  // The root is the configuration tree node which is already level zero
+  if ((Walk == NULL) || (Level == 0) || (Level > Walk->Count)) {
+    return TRUE;
+  }
+  // Free the levels of the previous tree nodes that are not ancestors
+  while (Walk->Count > Level) {
+    This = Walk->Levels + --(Walk->Count);
+    if (This->Path != NULL) {
+      FreePool(This->Path);
+    }
+  }
+  // Grow the levels if needed
+  if (Walk->Count >= Walk->Size) {
+    Levels = (CFGXML_INSPECT *)ReallocatePool(Walk->Size * sizeof(CFGXML_INSPECT), (Walk->Size << 1) * sizeof(CFGXML_INSPECT), Walk->Levels);
+    if (Levels == NULL) {
+      Walk->Status = EFI_OUT_OF_RESOURCES;
+      return FALSE;
+    }
+    Walk->Levels = Levels;
+    Walk->Size <<= 1;
+  }
+  This = Walk->Levels + (Walk->Count)++;
+  // The tree nodes below a skipped tree node are skipped
+  if ((TagName == NULL) || ((Walk->Levels[Level - 1].Options & CFGXML_INSPECT_SKIP) != 0)) {
+    This->Source = Walk->Levels[Level - 1].Source;
+    This->Path = NULL;
+    This->Options = CFGXML_INSPECT_SKIP;
+    return TRUE;
+  }
+  // Visit the tree node and skip its children if they are not configuration values
+  if (!ConfigXmlVisit(Walk->Levels + (Level - 1), This, Level, LevelIndex, TagName, Value, AttributeCount, Attributes, (FirstChild != NULL))) {
+    This->Options = CFGXML_INSPECT_SKIP;
   }
-  FreePool(This.Path);
   return TRUE;
 }
 // ConfigParseXml
@@ -740,37 +1035,51 @@ ConfigParseXml (
   IN XML_TREE *Tree,
   IN CHAR16   *Source OPTIONAL
 ) {
-  CFGXML_INSPECT   Root = { NULL, NULL, 0 };
-  XML_TREE       **Children = NULL;
-  CHAR16          *Name = NULL;
-  UINTN            Count = 0;
-  UINTN            Index;
+  EFI_STATUS   Status;
+  CFGXML_WALK  Walk;
+  CHAR16      *Name = NULL;
   // Check parameters
   if (Tree == NULL) {
     return EFI_INVALID_PARAMETER;
   }
+  if (EFI_ERROR(XmlTreeGetTag(Tree, &Name)) || (Name == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Property lists are mapped through the configuration values so they also reach the configuration protocol
+  if (StriCmp(Name, L"plist") == 0) {
+    return ConfigParsePlistXml(Tree, Source);
+  }
   // Use configuration protocol if present
   if ((mConfig != NULL) && (mConfig->Parse != NULL)) {
     return mConfig->Parse(Tree, Source);
   }
-  if (EFI_ERROR(XmlTreeGetTag(Tree, &Name)) || (Name == NULL) || (StriCmp(Name, L"configuration") != 0)) {
+  if (StriCmp(Name, L"configuration") != 0) {
     return EFI_INVALID_PARAMETER;
   }
-  // Inspect the XML tree
-  if (!EFI_ERROR(XmlTreeGetChildren(Tree, &Children, &Count)) && (Children != NULL) && (Count > 0)) {
-    Root.Source = Source;
-    for (Index = 0; Index < Count; ++Index) {
-      EFI_STATUS Status = XmlTreeInspect(Children[Index], 1, Index, ConfigXmlInspector, &Root, FALSE);
-      if (EFI_ERROR(Status)) {
-        FreePool(Children);
-        return Status;
-      }
-    }
+  // Walk the XML tree with the root as level zero, the levels replace recursion so nesting depth is only limited by memory
+  Walk.Levels = (CFGXML_INSPECT *)AllocatePool(CFGXML_WALK_SIZE * sizeof(CFGXML_INSPECT));
+  if (Walk.Levels == NULL) {
+    return EFI_OUT_OF_RESOURCES;
   }
-  if (Children != NULL) {
-    FreePool(Children);
+  Walk.Levels[0].Source = Source;
+  Walk.Levels[0].Path = NULL;
+  Walk.Levels[0].Options = 0;
+  Walk.Count = 1;
+  Walk.Size = CFGXML_WALK_SIZE;
+  Walk.Status = EFI_SUCCESS;
+  Status = XmlTreeWalk(Tree, 0, 0, ConfigXmlWalker, &Walk, TRUE);
+  if (EFI_ERROR(Walk.Status)) {
+    Status = Walk.Status;
+  }
+  // Free the levels left by the last tree nodes
+  while (Walk.Count > 0) {
+    --(Walk.Count);
+    if (Walk.Levels[Walk.Count].Path != NULL) {
+      FreePool(Walk.Levels[Walk.Count].Path);
+    }
   }
-  return EFI_SUCCESS;
+  FreePool(Walk.Levels);
+  return Status;
 }
 
 // ConfigFree
@@ -834,12 +1143,16 @@ ConfigVPartialFree (
   // Use configuration protocol if present
   if ((mConfig != NULL) && (mConfig->Free != NULL)) {
     Status = mConfig->Free(FullPath);
-    FreePool(FullPath);
+    if (FullPath != NULL) {
+      FreePool(FullPath);
+    }
     return Status;
   }
   // Find the address of the configuration tree node
   Status = ConfigFind2(FullPath, FALSE, &Tree);
-  FreePool(FullPath);
+  if (FullPath != NULL) {
+    FreePool(FullPath);
+  }
   if (EFI_ERROR(Status) || (Tree == NULL) || (*Tree == NULL)) {
     return (Status == EFI_NOT_FOUND) ? EFI_SUCCESS : Status;
   }
@@ -899,6 +1212,7 @@ ConfigVExists (
   }
   // Try to find the configuration key
   Status = ConfigFind(FullPath, FALSE, &Tree);
+  FreePool(FullPath);
   if (EFI_ERROR(Status)) {
     return Status;
   }
@@ -1120,6 +1434,7 @@ ConfigVGetList (
   EFI_STATUS   Status;
   CHAR16      *FullPath;
   CONFIG_TREE *Node = NULL;
+  STR_LIST     Names = { STR_LIST_NO_DUPLICATES | STR_LIST_CASE_INSENSITIVE | STR_LIST_SORTED | STR_LIST_HASHED, 0, 0, NULL, 0, NULL };
   // Check parameters
   if ((Path == NULL) || (List == NULL) || (*List != NULL) || (Count == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -1145,12 +1460,16 @@ ConfigVGetList (
     return EFI_NOT_FOUND;
   }
   // Add the child node names to the list
-  *Count = 0;
   for (Node = Node->Children; Node != NULL; Node = Node->Next) {
-    if (Node->Name != NULL) {
-      StrList(List, Count, Node->Name, 0, STR_LIST_NO_DUPLICATES | STR_LIST_CASE_INSENSITIVE | STR_LIST_SORTED);
+    if ((Node->Name != NULL) && (StrListAdd(&Names, Node->Name, 0) == EFI_OUT_OF_RESOURCES)) {
+      StrListClear(&Names);
+      return EFI_OUT_OF_RESOURCES;
     }
   }
+  Status = StrListDetach(&Names, List, Count);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
   if ((*Count == 0) || (*List == NULL)) {
     return EFI_NOT_FOUND;
   }
@@ -2202,6 +2521,13 @@ ConfigVSetValue (
   if (Node->Children != NULL) {
     return EFI_ACCESS_DENIED;
   }
+  // Free the previous value
+  if ((Node->Type == CONFIG_TYPE_STRING) && (Node->Value.String != NULL)) {
+    FreePool(Node->Value.String);
+  } else if ((Node->Type == CONFIG_TYPE_DATA) && (Node->Value.Data.Data != NULL)) {
+    FreePool(Node->Value.Data.Data);
+  }
+  ZeroMem(&(Node->Value), sizeof(CONFIG_VALUE));
   // Set type and value
   Node->Type = Type;
   if (Type == CONFIG_TYPE_STRING) {
@@ -2282,7 +2608,7 @@ ConfigVSetBoolean (
   }
   // Set the value
   Value.Boolean = Boolean;
-  Status = ConfigSetValue(FullPath, CONFIG_TYPE_BOOLEAN, &Value, Overwrite);
+  Status = ConfigSetValue(L"%s", CONFIG_TYPE_BOOLEAN, &Value, Overwrite, FullPath);
   FreePool(FullPath);
   return Status;
 }
@@ -2344,7 +2670,7 @@ ConfigVSetInteger (
   }
   // Set the value
   Value.Integer = Integer;
-  Status = ConfigSetValue(FullPath, CONFIG_TYPE_INTEGER, &Value, Overwrite);
+  Status = ConfigSetValue(L"%s", CONFIG_TYPE_INTEGER, &Value, Overwrite, FullPath);
   FreePool(FullPath);
   return Status;
 }
@@ -2406,7 +2732,7 @@ ConfigVSetUnsigned (
   }
   // Set the value
   Value.Unsigned = Unsigned;
-  Status = ConfigSetValue(FullPath, CONFIG_TYPE_UNSIGNED, &Value, Overwrite);
+  Status = ConfigSetValue(L"%s", CONFIG_TYPE_UNSIGNED, &Value, Overwrite, FullPath);
   FreePool(FullPath);
   return Status;
 }
@@ -2468,7 +2794,7 @@ ConfigVSetString (
   }
   // Set the value
   Value.String = String;
-  Status = ConfigSetValue(FullPath, CONFIG_TYPE_STRING, &Value, Overwrite);
+  Status = ConfigSetValue(L"%s", CONFIG_TYPE_STRING, &Value, Overwrite, FullPath);
   FreePool(FullPath);
   return Status;
 }
@@ -2535,7 +2861,7 @@ ConfigVSetData (
   // Set the value
   Value.Data.Size = Size;
   Value.Data.Data = Data;
-  Status = ConfigSetValue(FullPath, CONFIG_TYPE_DATA, &Value, Overwrite);
+  Status = ConfigSetValue(L"%s", CONFIG_TYPE_DATA, &Value, Overwrite, FullPath);
   FreePool(FullPath);
   return Status;
 }
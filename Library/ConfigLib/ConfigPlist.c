@@ -0,0 +1,814 @@
+//
+/// @file Library/ConfigLib/ConfigPlist.c
+///
+/// Configuration property list front end
+///
+
+#include <Library/ConfigLib.h>
+
+#include <Library/LogLib.h>
+
+// CONFIG_PLIST_MAX_DEPTH
+/// The maximum nesting depth of property list containers
+#define CONFIG_PLIST_MAX_DEPTH 32
+
+// CONFIG_PLIST_DATE_MIN
+/// The seconds since 2001-01-01 of the earliest date with a four digit year, 0001-01-01T00:00:00Z
+#define CONFIG_PLIST_DATE_MIN -63113904000LL
+// CONFIG_PLIST_DATE_MAX
+/// The seconds since 2001-01-01 of the latest date with a four digit year, 9999-12-31T23:59:59Z
+#define CONFIG_PLIST_DATE_MAX 252423993599LL
+// CONFIG_PLIST_DATE_DAYS
+/// The days from 0000-03-01 to 2001-01-01, the days are counted from March so leap days end each year
+#define CONFIG_PLIST_DATE_DAYS 730791
+
+// CONFIG_BPLIST_TRAILER_SIZE
+/// The size, in bytes, of the binary property list trailer
+#define CONFIG_BPLIST_TRAILER_SIZE 32
+
+// CONFIG_BPLIST
+/// Binary property list decoder
+typedef struct _CONFIG_BPLIST CONFIG_BPLIST;
+struct _CONFIG_BPLIST {
+
+  // Buffer
+  /// The binary property list
+  UINT8  *Buffer;
+  // End
+  /// The end of the objects, which is the start of the offset table
+  UINT8  *End;
+  // OffsetTable
+  /// The offset table, one offset for each object
+  UINT8  *OffsetTable;
+  // OffsetSize
+  /// The size, in bytes, of each offset in the offset table
+  UINTN   OffsetSize;
+  // ReferenceSize
+  /// The size, in bytes, of each object reference in containers
+  UINTN   ReferenceSize;
+  // ObjectCount
+  /// The count of objects
+  UINT64  ObjectCount;
+  // Containers
+  /// The count of containers that may still be decoded, which stops shared containers from expanding endlessly
+  UINT64  Containers;
+
+};
+
+// ConfigPlistPath
+/// Create the configuration path of a property list container member
+/// @param Path  The configuration path of the container or NULL for root
+/// @param Key   The dictionary key or NULL for an array member
+/// @param Index The array index
+/// @return The configuration path, which must be freed, or NULL if memory could not be allocated
+STATIC CHAR16 *
+EFIAPI
+ConfigPlistPath (
+  IN CHAR16 *Path OPTIONAL,
+  IN CHAR16 *Key OPTIONAL,
+  IN UINTN   Index
+) {
+  if (Key != NULL) {
+    return FileMakePath(Path, Key);
+  }
+  return CatSPrint(NULL, L"%s\\%u", (Path == NULL) ? L"" : Path, Index);
+}
+// ConfigPlistSetBoolean
+/// Set a boolean configuration value from a property list
+/// @param Path    The configuration path
+/// @param Boolean The boolean value
+/// @return Whether the configuration value was set or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigPlistSetBoolean (
+  IN CHAR16  *Path OPTIONAL,
+  IN BOOLEAN  Boolean
+) {
+  if (Path == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  LOG(L"  %s=%s\n", Path, Boolean ? L"true" : L"false");
+  return ConfigSetBoolean(L"%s", Boolean, TRUE, Path);
+}
+// ConfigPlistSetInteger
+/// Set an integer configuration value from a property list
+/// @param Path    The configuration path
+/// @param Integer The integer value
+/// @return Whether the configuration value was set or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigPlistSetInteger (
+  IN CHAR16 *Path OPTIONAL,
+  IN INTN    Integer
+) {
+  if (Path == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  LOG(L"  %s=%d\n", Path, Integer);
+  return ConfigSetInteger(L"%s", Integer, TRUE, Path);
+}
+// ConfigPlistSetUnsigned
+/// Set an unsigned integer configuration value from a property list
+/// @param Path     The configuration path
+/// @param Unsigned The unsigned integer value
+/// @return Whether the configuration value was set or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigPlistSetUnsigned (
+  IN CHAR16 *Path OPTIONAL,
+  IN UINTN   Unsigned
+) {
+  if (Path == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  LOG(L"  %s=%u\n", Path, Unsigned);
+  return ConfigSetUnsigned(L"%s", Unsigned, TRUE, Path);
+}
+// ConfigPlistSetString
+/// Set a string configuration value from a property list
+/// @param Path   The configuration path
+/// @param String The string value
+/// @return Whether the configuration value was set or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigPlistSetString (
+  IN CHAR16 *Path OPTIONAL,
+  IN CHAR16 *String
+) {
+  if (Path == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  LOG(L"  %s=\"%s\"\n", Path, String);
+  return ConfigSetString(L"%s", String, TRUE, Path);
+}
+// ConfigPlistSetData
+/// Set a data configuration value from a property list, empty data is not set
+/// @param Path The configuration path
+/// @param Size The size, in bytes, of the data
+/// @param Data The data
+/// @return Whether the configuration value was set or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigPlistSetData (
+  IN CHAR16 *Path OPTIONAL,
+  IN UINTN   Size,
+  IN VOID   *Data
+) {
+  if (Path == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Size == 0) {
+    return EFI_SUCCESS;
+  }
+  LOG(L"  %s=<%u bytes>\n", Path, Size);
+  return ConfigSetData(L"%s", Size, Data, TRUE, Path);
+}
+// ConfigPlistSetDate
+/// Set a date configuration value from a property list, dates are strings in the same form as property list XML dates
+/// @param Path    The configuration path
+/// @param Seconds The seconds since 2001-01-01T00:00:00Z, which saturate to a four digit year
+/// @return Whether the configuration value was set or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigPlistSetDate (
+  IN CHAR16 *Path OPTIONAL,
+  IN INTN    Seconds
+) {
+  EFI_STATUS  Status;
+  CHAR16     *Date;
+  INTN        Days;
+  INTN        Era;
+  INTN        DayOfEra;
+  INTN        YearOfEra;
+  INTN        DayOfYear;
+  INTN        MonthIndex;
+  INTN        Year;
+  INTN        Month;
+  if (Path == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if ((INT64)Seconds < CONFIG_PLIST_DATE_MIN) {
+    Seconds = (INTN)CONFIG_PLIST_DATE_MIN;
+  } else if ((INT64)Seconds > CONFIG_PLIST_DATE_MAX) {
+    Seconds = (INTN)CONFIG_PLIST_DATE_MAX;
+  }
+  // Split the days from the seconds of the day, rounding toward the earlier day
+  Days = Seconds / 86400;
+  Seconds %= 86400;
+  if (Seconds < 0) {
+    Seconds += 86400;
+    --Days;
+  }
+  // Convert the days to a civil date through four hundred year eras that start in March
+  Days += CONFIG_PLIST_DATE_DAYS;
+  Era = Days / 146097;
+  DayOfEra = Days - (Era * 146097);
+  YearOfEra = (DayOfEra - (DayOfEra / 1460) + (DayOfEra / 36524) - (DayOfEra / 146096)) / 365;
+  DayOfYear = DayOfEra - ((365 * YearOfEra) + (YearOfEra / 4) - (YearOfEra / 100));
+  MonthIndex = ((5 * DayOfYear) + 2) / 153;
+  Month = (MonthIndex < 10) ? (MonthIndex + 3) : (MonthIndex - 9);
+  Year = YearOfEra + (Era * 400) + ((Month <= 2) ? 1 : 0);
+  Date = CatSPrint(NULL, L"%04d-%02d-%02dT%02d:%02d:%02dZ", (INT32)Year, (INT32)Month,
+                   (INT32)(DayOfYear - (((153 * MonthIndex) + 2) / 5) + 1), (INT32)(Seconds / 3600),
+                   (INT32)((Seconds / 60) % 60), (INT32)(Seconds % 60));
+  if (Date == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Status = ConfigPlistSetString(Path, Date);
+  FreePool(Date);
+  return Status;
+}
+// ConfigPlistRealToInteger
+/// Convert an IEEE 754 real to an integer by truncating toward zero
+/// @param Bits The bits of the real
+/// @param Size The size, in bytes, of the real, either four or eight
+/// @return The integer, which saturates if the real is out of range
+STATIC INTN
+EFIAPI
+ConfigPlistRealToInteger (
+  IN UINT64 Bits,
+  IN UINTN  Size
+) {
+  UINT64  Mantissa;
+  UINTN   Exponent;
+  UINTN   Bias;
+  UINTN   Fraction;
+  UINTN   Magnitude;
+  BOOLEAN Negative;
+  // Split the real into sign, exponent and mantissa
+  if (Size == sizeof(UINT32)) {
+    Negative = ((Bits & 0x80000000) != 0);
+    Exponent = (UINTN)RShiftU64(Bits, 23) & 0xFF;
+    Mantissa = Bits & 0x7FFFFF;
+    Bias = 127;
+    Fraction = 23;
+  } else {
+    Negative = ((Bits & 0x8000000000000000ULL) != 0);
+    Exponent = (UINTN)RShiftU64(Bits, 52) & 0x7FF;
+    Mantissa = Bits & 0xFFFFFFFFFFFFFULL;
+    Bias = 1023;
+    Fraction = 52;
+  }
+  // Magnitudes less than one truncate to zero
+  if (Exponent < Bias) {
+    return 0;
+  }
+  Exponent -= Bias;
+  // Saturate magnitudes that do not fit, including infinity and not a number
+  if (Exponent >= ((sizeof(INTN) << 3) - 1)) {
+    return Negative ? -MAX_INTN : MAX_INTN;
+  }
+  // Shift the mantissa with the implicit leading one to drop the fraction
+  Mantissa |= LShiftU64(1, Fraction);
+  if (Exponent >= Fraction) {
+    Magnitude = (UINTN)LShiftU64(Mantissa, Exponent - Fraction);
+  } else {
+    Magnitude = (UINTN)RShiftU64(Mantissa, Fraction - Exponent);
+  }
+  return Negative ? -(INTN)Magnitude : (INTN)Magnitude;
+}
+
+// ConfigPlistXmlValue
+/// Parse a property list XML value into configuration values
+/// @param Tree  The XML document tree node of the value
+/// @param Path  The configuration path of the value or NULL for root
+/// @param Depth The nesting depth of the value
+/// @return Whether the value was parsed or not
+/// @retval EFI_INVALID_PARAMETER If the value is malformed or nested too deeply
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the value was parsed successfully
+STATIC EFI_STATUS
+EFIAPI
+ConfigPlistXmlValue (
+  IN XML_TREE *Tree,
+  IN CHAR16   *Path OPTIONAL,
+  IN UINTN     Depth
+) {
+  EFI_STATUS  Status;
+  XML_TREE   *Child = NULL;
+  CHAR16     *Tag = NULL;
+  CHAR16     *Value = NULL;
+  CHAR16     *ChildPath;
+  UINTN       Index;
+  // Get the value type and text
+  if (EFI_ERROR(XmlTreeGetTag(Tree, &Tag)) || (Tag == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  XmlTreeGetValue(Tree, &Value);
+  if (StriCmp(Tag, L"dict") == 0) {
+    // Dictionary members are key elements each followed by a value element
+    if (Depth >= CONFIG_PLIST_MAX_DEPTH) {
+      return EFI_INVALID_PARAMETER;
+    }
+    Status = XmlTreeGetFirstChild(Tree, &Child);
+    while (!EFI_ERROR(Status) && (Child != NULL)) {
+      XML_TREE *Member = NULL;
+      CHAR16   *Key = NULL;
+      if (EFI_ERROR(XmlTreeGetTag(Child, &Tag)) || (Tag == NULL) || (StriCmp(Tag, L"key") != 0) ||
+          EFI_ERROR(XmlTreeGetNextSibling(Child, &Member)) || (Member == NULL)) {
+        return EFI_INVALID_PARAMETER;
+      }
+      // Skip members with empty keys since they have no path
+      XmlTreeGetValue(Child, &Key);
+      if ((Key != NULL) && (*Key != L'\0')) {
+        ChildPath = ConfigPlistPath(Path, Key, 0);
+        if (ChildPath == NULL) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+        Status = ConfigPlistXmlValue(Member, ChildPath, Depth + 1);
+        FreePool(ChildPath);
+        if (EFI_ERROR(Status)) {
+          return Status;
+        }
+      }
+      Child = NULL;
+      Status = XmlTreeGetNextSibling(Member, &Child);
+    }
+    return EFI_SUCCESS;
+  } else if (StriCmp(Tag, L"array") == 0) {
+    // Array members are indexed like configuration groups
+    if (Depth >= CONFIG_PLIST_MAX_DEPTH) {
+      return EFI_INVALID_PARAMETER;
+    }
+    Index = 0;
+    Status = XmlTreeGetFirstChild(Tree, &Child);
+    while (!EFI_ERROR(Status) && (Child != NULL)) {
+      ChildPath = ConfigPlistPath(Path, NULL, Index++);
+      if (ChildPath == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      Status = ConfigPlistXmlValue(Child, ChildPath, Depth + 1);
+      FreePool(ChildPath);
+      if (EFI_ERROR(Status)) {
+        return Status;
+      }
+      Status = XmlTreeGetNextSibling(Child, &Child);
+    }
+    return EFI_SUCCESS;
+  } else if ((StriCmp(Tag, L"integer") == 0) || (StriCmp(Tag, L"real") == 0)) {
+    // Integer value, reals are truncated since there is no real configuration type
+    UINTN   Magnitude = 0;
+    BOOLEAN Negative = FALSE;
+    if (Value != NULL) {
+      if ((*Value == L'-') || (*Value == L'+')) {
+        Negative = (*Value++ == L'-');
+      }
+      if ((*Value == L'0') && ((Value[1] == L'x') || (Value[1] == L'X'))) {
+        Magnitude = StrHexToUintn(Value + 2);
+      } else {
+        Magnitude = StrDecimalToUintn(Value);
+      }
+    }
+    if (Negative) {
+      // Magnitudes beyond the smallest integer saturate
+      return ConfigPlistSetInteger(Path, (Magnitude > (UINTN)MAX_INTN) ? MIN_INTN : -(INTN)Magnitude);
+    }
+    if (Magnitude > (UINTN)MAX_INTN) {
+      // Integers too large for an integer are unsigned the same as sixteen byte binary integers and reals saturate
+      //  the same as binary reals
+      if (StriCmp(Tag, L"integer") == 0) {
+        return ConfigPlistSetUnsigned(Path, Magnitude);
+      }
+      return ConfigPlistSetInteger(Path, MAX_INTN);
+    }
+    return ConfigPlistSetInteger(Path, (INTN)Magnitude);
+  } else if ((StriCmp(Tag, L"string") == 0) || (StriCmp(Tag, L"date") == 0)) {
+    // String value, dates are kept as written, which is the form binary dates are converted to
+    return ConfigPlistSetString(Path, (Value == NULL) ? L"" : Value);
+  } else if (StriCmp(Tag, L"data") == 0) {
+    // Data base64 value, empty data has nothing to decode
+    UINTN  Size = 0;
+    VOID  *Data = NULL;
+    Status = EFI_SUCCESS;
+    if ((Value != NULL) && !EFI_ERROR(FromBase64(Value, &Size, &Data)) && (Data != NULL)) {
+      Status = ConfigPlistSetData(Path, Size, Data);
+      FreePool(Data);
+    }
+    return Status;
+  } else if (StriCmp(Tag, L"true") == 0) {
+    // True
+    return ConfigPlistSetBoolean(Path, TRUE);
+  } else if (StriCmp(Tag, L"false") == 0) {
+    // False
+    return ConfigPlistSetBoolean(Path, FALSE);
+  }
+  return EFI_INVALID_PARAMETER;
+}
+
+// ConfigBplistUnsigned
+/// Read a big endian unsigned integer from a binary property list
+/// @param Ptr  The start of the integer
+/// @param Size The size, in bytes, of the integer, up to eight
+/// @return The unsigned integer
+STATIC UINT64
+EFIAPI
+ConfigBplistUnsigned (
+  IN UINT8 *Ptr,
+  IN UINTN  Size
+) {
+  UINT64 Unsigned = 0;
+  while (Size-- > 0) {
+    Unsigned = LShiftU64(Unsigned, 8) | *Ptr++;
+  }
+  return Unsigned;
+}
+// ConfigBplistObject
+/// Find an object in a binary property list through the offset table
+/// @param Bplist    The binary property list decoder
+/// @param Reference The object reference
+/// @param Object    On output, the object marker
+/// @return Whether the object was found or not
+/// @retval EFI_INVALID_PARAMETER If the reference or its offset is out of range
+/// @retval EFI_SUCCESS           If the object was found successfully
+STATIC EFI_STATUS
+EFIAPI
+ConfigBplistObject (
+  IN  CONFIG_BPLIST  *Bplist,
+  IN  UINT64          Reference,
+  OUT UINT8         **Object
+) {
+  UINT64 Offset;
+  if (Reference >= Bplist->ObjectCount) {
+    return EFI_INVALID_PARAMETER;
+  }
+  Offset = ConfigBplistUnsigned(Bplist->OffsetTable + ((UINTN)Reference * Bplist->OffsetSize), Bplist->OffsetSize);
+  if ((Offset < CONFIG_BPLIST_MAGIC_SIZE) || (Offset >= (UINT64)(Bplist->End - Bplist->Buffer))) {
+    return EFI_INVALID_PARAMETER;
+  }
+  *Object = Bplist->Buffer + (UINTN)Offset;
+  return EFI_SUCCESS;
+}
+// ConfigBplistLength
+/// Get the count of elements of a variable length object in a binary property list
+/// @param Bplist The binary property list decoder
+/// @param Object The object marker
+/// @param Unit   The size, in bytes, of each element
+/// @param Length On output, the count of elements
+/// @param Data   On output, the first element
+/// @return Whether the count of elements was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If the elements are not within the objects
+/// @retval EFI_SUCCESS           If the count of elements was retrieved successfully
+STATIC EFI_STATUS
+EFIAPI
+ConfigBplistLength (
+  IN  CONFIG_BPLIST  *Bplist,
+  IN  UINT8          *Object,
+  IN  UINTN           Unit,
+  OUT UINTN          *Length,
+  OUT UINT8         **Data
+) {
+  UINT64  Count = (Object[0] & 0xF);
+  UINT8  *Ptr = Object + 1;
+  // Long lengths follow the marker as an integer object
+  if (Count == 0xF) {
+    UINTN Size;
+    if ((Ptr >= Bplist->End) || ((*Ptr & 0xF0) != 0x10)) {
+      return EFI_INVALID_PARAMETER;
+    }
+    Size = (UINTN)1 << (*Ptr & 0xF);
+    if ((Size > sizeof(UINT64)) || (Size >= (UINTN)(Bplist->End - Ptr))) {
+      return EFI_INVALID_PARAMETER;
+    }
+    Count = ConfigBplistUnsigned(Ptr + 1, Size);
+    Ptr += Size + 1;
+  }
+  // Check the elements are within the objects
+  if (Count > (UINT64)((Bplist->End - Ptr) / Unit)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  *Length = (UINTN)Count;
+  *Data = Ptr;
+  return EFI_SUCCESS;
+}
+// ConfigBplistString
+/// Decode a string object in a binary property list
+/// @param Bplist The binary property list decoder
+/// @param Object The object marker
+/// @param String On output, the decoded string, which must be freed
+/// @return Whether the string was decoded or not
+/// @retval EFI_INVALID_PARAMETER If the object is not a string or is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the string was decoded successfully
+STATIC EFI_STATUS
+EFIAPI
+ConfigBplistString (
+  IN  CONFIG_BPLIST  *Bplist,
+  IN  UINT8          *Object,
+  OUT CHAR16        **String
+) {
+  EFI_STATUS  Status;
+  UINT8      *Data = NULL;
+  CHAR16     *Ptr;
+  UINTN       Length = 0;
+  UINTN       Index;
+  UINTN       Unit;
+  // ASCII strings have one byte characters and Unicode strings have big endian UTF-16 characters
+  switch (Object[0] >> 4) {
+    case 0x5:
+      Unit = sizeof(CHAR8);
+      break;
+
+    case 0x6:
+      Unit = sizeof(CHAR16);
+      break;
+
+    default:
+      return EFI_INVALID_PARAMETER;
+  }
+  Status = ConfigBplistLength(Bplist, Object, Unit, &Length, &Data);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Convert the characters
+  Ptr = (CHAR16 *)AllocatePool((Length + 1) * sizeof(CHAR16));
+  if (Ptr == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  for (Index = 0; Index < Length; ++Index) {
+    if (Unit == sizeof(CHAR8)) {
+      Ptr[Index] = (CHAR16)Data[Index];
+    } else {
+      Ptr[Index] = (CHAR16)((Data[Index << 1] << 8) | Data[(Index << 1) + 1]);
+    }
+  }
+  Ptr[Length] = L'\0';
+  *String = Ptr;
+  return EFI_SUCCESS;
+}
+// ConfigBplistValue
+/// Decode a binary property list object into configuration values
+/// @param Bplist    The binary property list decoder
+/// @param Reference The object reference
+/// @param Path      The configuration path of the object or NULL for root
+/// @param Depth     The nesting depth of the object
+/// @return Whether the object was decoded or not
+/// @retval EFI_INVALID_PARAMETER If the object is malformed or nested too deeply
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the object was decoded successfully
+STATIC EFI_STATUS
+EFIAPI
+ConfigBplistValue (
+  IN CONFIG_BPLIST *Bplist,
+  IN UINT64         Reference,
+  IN CHAR16        *Path OPTIONAL,
+  IN UINTN          Depth
+) {
+  EFI_STATUS  Status;
+  UINT8      *Object = NULL;
+  UINT8      *Data = NULL;
+  CHAR16     *String = NULL;
+  CHAR16     *ChildPath;
+  UINT64      Integer;
+  UINTN       Length = 0;
+  UINTN       Size;
+  UINTN       Index;
+  // Find the object
+  Status = ConfigBplistObject(Bplist, Reference, &Object);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  switch (Object[0] >> 4) {
+    case 0x0:
+      // Boolean, null and fill objects have no data
+      if ((Object[0] == 0x08) || (Object[0] == 0x09)) {
+        return ConfigPlistSetBoolean(Path, (BOOLEAN)(Object[0] == 0x09));
+      }
+      return EFI_SUCCESS;
+
+    case 0x1:
+      // Integers are big endian, only eight byte integers are signed and sixteen byte integers are unsigned integers
+      //  too large for an eight byte integer when the high eight bytes are zero or otherwise keep the low eight bytes
+      Size = (UINTN)1 << (Object[0] & 0xF);
+      if ((Size > (sizeof(UINT64) << 1)) || (Size >= (UINTN)(Bplist->End - Object))) {
+        return EFI_INVALID_PARAMETER;
+      }
+      if (Size > sizeof(UINT64)) {
+        Integer = ConfigBplistUnsigned(Object + 1 + sizeof(UINT64), sizeof(UINT64));
+        if ((ConfigBplistUnsigned(Object + 1, sizeof(UINT64)) == 0) && (Integer > (UINT64)MAX_INTN)) {
+          return ConfigPlistSetUnsigned(Path, (UINTN)Integer);
+        }
+      } else {
+        Integer = ConfigBplistUnsigned(Object + 1, Size);
+      }
+      return ConfigPlistSetInteger(Path, (INTN)(INT64)Integer);
+
+    case 0x2:
+      // Reals are truncated since there is no real configuration type
+      Size = (UINTN)1 << (Object[0] & 0xF);
+      if (((Size != sizeof(UINT32)) && (Size != sizeof(UINT64))) || (Size >= (UINTN)(Bplist->End - Object))) {
+        return EFI_INVALID_PARAMETER;
+      }
+      return ConfigPlistSetInteger(Path, ConfigPlistRealToInteger(ConfigBplistUnsigned(Object + 1, Size), Size));
+
+    case 0x3:
+      // Dates are eight byte reals of seconds since 2001-01-01 and are set as strings the same as property list XML dates
+      if ((Object[0] != 0x33) || (sizeof(UINT64) >= (UINTN)(Bplist->End - Object))) {
+        return EFI_INVALID_PARAMETER;
+      }
+      return ConfigPlistSetDate(Path, ConfigPlistRealToInteger(ConfigBplistUnsigned(Object + 1, sizeof(UINT64)), sizeof(UINT64)));
+
+    case 0x4:
+      // Data
+      Status = ConfigBplistLength(Bplist, Object, sizeof(UINT8), &Length, &Data);
+      if (EFI_ERROR(Status)) {
+        return Status;
+      }
+      return ConfigPlistSetData(Path, Length, Data);
+
+    case 0x5:
+    case 0x6:
+      // String
+      Status = ConfigBplistString(Bplist, Object, &String);
+      if (EFI_ERROR(Status)) {
+        return Status;
+      }
+      Status = ConfigPlistSetString(Path, String);
+      FreePool(String);
+      return Status;
+
+    case 0x8:
+      // Unique identifier
+      Size = (UINTN)(Object[0] & 0xF) + 1;
+      if ((Size > sizeof(UINT64)) || (Size >= (UINTN)(Bplist->End - Object))) {
+        return EFI_INVALID_PARAMETER;
+      }
+      return ConfigPlistSetUnsigned(Path, (UINTN)ConfigBplistUnsigned(Object + 1, Size));
+
+    case 0xA:
+    case 0xC:
+    case 0xD:
+      // Containers are references to other objects, dictionaries have all key references before all value references
+      if ((Depth >= CONFIG_PLIST_MAX_DEPTH) || (Bplist->Containers == 0)) {
+        return EFI_INVALID_PARAMETER;
+      }
+      --(Bplist->Containers);
+      Status = ConfigBplistLength(Bplist, Object, Bplist->ReferenceSize * (((Object[0] >> 4) == 0xD) ? 2 : 1), &Length, &Data);
+      if (EFI_ERROR(Status)) {
+        return Status;
+      }
+      for (Index = 0; Index < Length; ++Index) {
+        UINT8 *Key = NULL;
+        if ((Object[0] >> 4) == 0xD) {
+          // Get the key string for this member
+          Status = ConfigBplistObject(Bplist, ConfigBplistUnsigned(Data + (Index * Bplist->ReferenceSize), Bplist->ReferenceSize), &Key);
+          if (EFI_ERROR(Status)) {
+            return Status;
+          }
+          String = NULL;
+          Status = ConfigBplistString(Bplist, Key, &String);
+          if (EFI_ERROR(Status)) {
+            return Status;
+          }
+          // Skip members with empty keys since they have no path
+          if (*String == L'\0') {
+            FreePool(String);
+            continue;
+          }
+          ChildPath = ConfigPlistPath(Path, String, 0);
+          FreePool(String);
+          Reference = ConfigBplistUnsigned(Data + ((Length + Index) * Bplist->ReferenceSize), Bplist->ReferenceSize);
+        } else {
+          ChildPath = ConfigPlistPath(Path, NULL, Index);
+          Reference = ConfigBplistUnsigned(Data + (Index * Bplist->ReferenceSize), Bplist->ReferenceSize);
+        }
+        if (ChildPath == NULL) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+        Status = ConfigBplistValue(Bplist, Reference, ChildPath, Depth + 1);
+        FreePool(ChildPath);
+        if (EFI_ERROR(Status)) {
+          return Status;
+        }
+      }
+      return EFI_SUCCESS;
+
+    default:
+      break;
+  }
+  return EFI_INVALID_PARAMETER;
+}
+
+// ConfigParsePlist
+/// Parse configuration information from an XML or binary property list
+/// @param Size   The size, in bytes, of the property list
+/// @param Plist  The property list to parse
+/// @param Source The unique source name
+/// @return Whether the configuration was parsed successfully or not
+/// @retval EFI_INVALID_PARAMETER If Plist is NULL, Size is zero, or the property list is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the property list was parsed successfully
+EFI_STATUS
+EFIAPI
+ConfigParsePlist (
+  IN UINTN   Size,
+  IN VOID   *Plist,
+  IN CHAR16 *Source OPTIONAL
+) {
+  EFI_STATUS  Status;
+  XML_PARSER *Parser = NULL;
+  // Check parameters
+  if ((Plist == NULL) || (Size == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Binary property lists are decoded without text parsing
+  if ((Size >= CONFIG_BPLIST_MAGIC_SIZE) && (CompareMem(Plist, CONFIG_BPLIST_MAGIC, CONFIG_BPLIST_MAGIC_SIZE) == 0)) {
+    return ConfigParseBinaryPlist(Size, Plist, Source);
+  }
+  // Create XML parser
+  Status = XmlCreate(&Parser);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  if (Parser == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Parse the XML buffer
+  Status = XmlParse(Parser, Size, Plist);
+  if (!EFI_ERROR(Status)) {
+    XML_TREE *Tree = NULL;
+    // Get the XML document tree root node
+    Status = XmlGetTree(Parser, &Tree);
+    if (!EFI_ERROR(Status)) {
+      // Parse the property list
+      Status = ConfigParsePlistXml(Tree, Source);
+    }
+  }
+  // Free the XML parser
+  XmlFree(Parser);
+  return Status;
+}
+// ConfigParsePlistXml
+/// Parse configuration information from an XML property list document tree
+/// @param Tree   The XML document tree to parse, the root node must be plist
+/// @param Source The unique source name
+/// @return Whether the configuration was parsed successfully or not
+/// @retval EFI_INVALID_PARAMETER If Tree is NULL or the property list is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the property list was parsed successfully
+EFI_STATUS
+EFIAPI
+ConfigParsePlistXml (
+  IN XML_TREE *Tree,
+  IN CHAR16   *Source OPTIONAL
+) {
+  XML_TREE *Child = NULL;
+  CHAR16   *Name = NULL;
+  // Check parameters
+  if (Tree == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (EFI_ERROR(XmlTreeGetTag(Tree, &Name)) || (Name == NULL) || (StriCmp(Name, L"plist") != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // An empty property list has no configuration
+  if (EFI_ERROR(XmlTreeGetFirstChild(Tree, &Child)) || (Child == NULL)) {
+    return EFI_SUCCESS;
+  }
+  // The root value maps to the configuration root
+  return ConfigPlistXmlValue(Child, NULL, 0);
+}
+// ConfigParseBinaryPlist
+/// Parse configuration information from a binary property list, objects are decoded in place through the offset table
+/// @param Size   The size, in bytes, of the binary property list
+/// @param Plist  The binary property list to parse
+/// @param Source The unique source name
+/// @return Whether the configuration was parsed successfully or not
+/// @retval EFI_INVALID_PARAMETER If Plist is NULL or the binary property list is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the binary property list was parsed successfully
+EFI_STATUS
+EFIAPI
+ConfigParseBinaryPlist (
+  IN UINTN   Size,
+  IN VOID   *Plist,
+  IN CHAR16 *Source OPTIONAL
+) {
+  CONFIG_BPLIST  Bplist;
+  UINT8         *Trailer;
+  UINT64         TopObject;
+  UINT64         TableOffset;
+  // Check parameters
+  if ((Plist == NULL) || (Size < (CONFIG_BPLIST_MAGIC_SIZE + CONFIG_BPLIST_TRAILER_SIZE)) ||
+      (CompareMem(Plist, CONFIG_BPLIST_MAGIC, CONFIG_BPLIST_MAGIC_SIZE) != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Read the trailer
+  Trailer = ((UINT8 *)Plist) + Size - CONFIG_BPLIST_TRAILER_SIZE;
+  Bplist.Buffer = (UINT8 *)Plist;
+  Bplist.OffsetSize = Trailer[6];
+  Bplist.ReferenceSize = Trailer[7];
+  Bplist.ObjectCount = ConfigBplistUnsigned(Trailer + 8, sizeof(UINT64));
+  TopObject = ConfigBplistUnsigned(Trailer + 16, sizeof(UINT64));
+  TableOffset = ConfigBplistUnsigned(Trailer + 24, sizeof(UINT64));
+  if ((Bplist.OffsetSize == 0) || (Bplist.OffsetSize > sizeof(UINT64)) ||
+      (Bplist.ReferenceSize == 0) || (Bplist.ReferenceSize > sizeof(UINT64)) ||
+      (TableOffset < CONFIG_BPLIST_MAGIC_SIZE) || (TableOffset > (UINT64)(Size - CONFIG_BPLIST_TRAILER_SIZE)) ||
+      (Bplist.ObjectCount > DivU64x32((UINT64)(Size - CONFIG_BPLIST_TRAILER_SIZE) - TableOffset, (UINT32)Bplist.OffsetSize))) {
+    return EFI_INVALID_PARAMETER;
+  }
+  Bplist.End = Bplist.Buffer + (UINTN)TableOffset;
+  Bplist.OffsetTable = Bplist.End;
+  Bplist.Containers = Bplist.ObjectCount;
+  // Decode the top object into the configuration root
+  return ConfigBplistValue(&Bplist, TopObject, NULL, 0);
+}
@@ -0,0 +1,729 @@
+//
+/// @file Library/ConfigLib/ConfigText.c
+///
+/// Configuration text front ends
+///
+
+#include "ConfigText.h"
+
+// ConfigTextHasExtension
+/// Check whether a source name ends with an extension
+/// @param Source    The unique source name
+/// @param Extension The extension, including the period
+/// @retval TRUE  If the source name ends with the extension
+/// @retval FALSE If the source name does not end with the extension
+STATIC BOOLEAN
+EFIAPI
+ConfigTextHasExtension (
+  IN CHAR16 *Source,
+  IN CHAR16 *Extension
+) {
+  UINTN Length = StrLen(Source);
+  UINTN ExtensionLength = StrLen(Extension);
+  return ((Length > ExtensionLength) && (StriCmp(Source + (Length - ExtensionLength), Extension) == 0));
+}
+// ConfigTextDetectFormat
+/// Detect the format of configuration from the source name extension or the leading characters
+/// @param Size   The size, in bytes, of the leading buffer
+/// @param Buffer The leading buffer of the configuration
+/// @param Source The unique source name
+/// @return The detected configuration format, XML if the format could not be detected
+CONFIG_FORMAT
+EFIAPI
+ConfigTextDetectFormat (
+  IN UINTN   Size,
+  IN VOID   *Buffer,
+  IN CHAR16 *Source OPTIONAL
+) {
+  UINT8 *Bytes = (UINT8 *)Buffer;
+  UINT8 *End;
+  // Binary property lists are recognized by their magic whatever their name
+  if ((Buffer == NULL) || (Size == 0)) {
+    return CONFIG_FORMAT_XML;
+  }
+  if ((Size >= CONFIG_BPLIST_MAGIC_SIZE) && (CompareMem(Buffer, CONFIG_BPLIST_MAGIC, CONFIG_BPLIST_MAGIC_SIZE) == 0)) {
+    return CONFIG_FORMAT_BINARY_PLIST;
+  }
+  // Choose by the source name extension
+  if (Source != NULL) {
+    if (ConfigTextHasExtension(Source, L".json")) {
+      return CONFIG_FORMAT_JSON;
+    }
+    if (ConfigTextHasExtension(Source, L".ini") || ConfigTextHasExtension(Source, L".cfg")) {
+      return CONFIG_FORMAT_INI;
+    }
+    if (ConfigTextHasExtension(Source, L".xml") || ConfigTextHasExtension(Source, L".plist")) {
+      return CONFIG_FORMAT_XML;
+    }
+  }
+  // Sniff the first significant character, byte order marks and the zero bytes of UTF-16 are skipped
+  End = Bytes + Size;
+  while ((Bytes < End) && ((*Bytes == 0) || (*Bytes == 0xEF) || (*Bytes == 0xBB) || (*Bytes == 0xBF) ||
+                           (*Bytes == 0xFE) || (*Bytes == 0xFF) || (*Bytes == ' ') || (*Bytes == '\t') ||
+                           (*Bytes == '\r') || (*Bytes == '\n'))) {
+    ++Bytes;
+  }
+  if (Bytes >= End) {
+    return CONFIG_FORMAT_XML;
+  }
+  switch (*Bytes) {
+    case '<':
+      return CONFIG_FORMAT_XML;
+
+    case '{':
+      return CONFIG_FORMAT_JSON;
+
+    case '[':
+      // A JSON array starts with a value but an INI section starts with a name
+      do {
+        ++Bytes;
+      } while ((Bytes < End) && ((*Bytes == 0) || (*Bytes == ' ') || (*Bytes == '\t') || (*Bytes == '\r') || (*Bytes == '\n')));
+      if ((Bytes < End) && ((*Bytes == '{') || (*Bytes == '[') || (*Bytes == ']') || (*Bytes == '"') ||
+                            (*Bytes == '-') || ((*Bytes >= '0') && (*Bytes <= '9')))) {
+        return CONFIG_FORMAT_JSON;
+      }
+      return CONFIG_FORMAT_INI;
+
+    default:
+      break;
+  }
+  return CONFIG_FORMAT_INI;
+}
+
+// ConfigTextStage
+/// Stage a configuration value to be set once the whole configuration text was parsed
+/// @param Text  The configuration text parser
+/// @param Path  The configuration path
+/// @param Type  The configuration value type
+/// @param Value The configuration value, strings are duplicated
+/// @return Whether the configuration value was staged or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the configuration value was staged successfully
+STATIC EFI_STATUS
+EFIAPI
+ConfigTextStage (
+  IN OUT CONFIG_TEXT  *Text,
+  IN     CHAR16       *Path,
+  IN     CONFIG_TYPE   Type,
+  IN     CONFIG_VALUE *Value
+) {
+  CONFIG_TEXT_PENDING *Pending;
+  Pending = (CONFIG_TEXT_PENDING *)AllocateZeroPool(sizeof(CONFIG_TEXT_PENDING));
+  if (Pending == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Pending->Path = StrDup(Path);
+  Pending->Type = Type;
+  CopyMem(&(Pending->Value), Value, sizeof(CONFIG_VALUE));
+  if (Type == CONFIG_TYPE_STRING) {
+    Pending->Value.String = StrDup(Value->String);
+  }
+  if ((Pending->Path == NULL) || ((Type == CONFIG_TYPE_STRING) && (Pending->Value.String == NULL))) {
+    if (Pending->Path != NULL) {
+      FreePool(Pending->Path);
+    }
+    FreePool(Pending);
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Append to keep the parsed order so later duplicate keys still replace earlier ones
+  *(Text->PendingLast) = Pending;
+  Text->PendingLast = &(Pending->Next);
+  return EFI_SUCCESS;
+}
+// ConfigTextCommit
+/// Set the staged configuration values in parsed order, the staged values are freed whether or not set
+/// @param Text   The configuration text parser
+/// @param Commit Whether to set the staged values or only free them
+/// @return Whether the configuration values were set or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigTextCommit (
+  IN OUT CONFIG_TEXT *Text,
+  IN     BOOLEAN      Commit
+) {
+  EFI_STATUS           Status = EFI_SUCCESS;
+  CONFIG_TEXT_PENDING *Pending;
+  while (Text->Pending != NULL) {
+    Pending = Text->Pending;
+    Text->Pending = Pending->Next;
+    if (Commit && !EFI_ERROR(Status)) {
+      switch (Pending->Type) {
+        case CONFIG_TYPE_BOOLEAN:
+          LOG(L"  %s=%s\n", Pending->Path, Pending->Value.Boolean ? L"true" : L"false");
+          break;
+
+        case CONFIG_TYPE_INTEGER:
+          LOG(L"  %s=%d\n", Pending->Path, Pending->Value.Integer);
+          break;
+
+        case CONFIG_TYPE_UNSIGNED:
+          LOG(L"  %s=%u\n", Pending->Path, Pending->Value.Unsigned);
+          break;
+
+        case CONFIG_TYPE_STRING:
+          LOG(L"  %s=\"%s\"\n", Pending->Path, Pending->Value.String);
+          break;
+
+        default:
+          break;
+      }
+      Status = ConfigSetValue(L"%s", Pending->Type, &(Pending->Value), TRUE, Pending->Path);
+    }
+    if (Pending->Type == CONFIG_TYPE_STRING) {
+      FreePool(Pending->Value.String);
+    }
+    FreePool(Pending->Path);
+    FreePool(Pending);
+  }
+  Text->PendingLast = &(Text->Pending);
+  return Status;
+}
+
+// ConfigTextCreate
+/// Create a configuration text parser
+/// @param Text   On output, the configuration text parser, which must be freed with ConfigTextFree
+/// @param Format The configuration text format, either JSON or INI
+/// @return Whether the configuration text parser was created or not
+/// @retval EFI_INVALID_PARAMETER If Text is NULL or *Text is not NULL
+/// @retval EFI_UNSUPPORTED       If Format is not a text format
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the configuration text parser was created successfully
+EFI_STATUS
+EFIAPI
+ConfigTextCreate (
+  OUT CONFIG_TEXT   **Text,
+  IN  CONFIG_FORMAT   Format
+) {
+  EFI_STATUS   Status;
+  CONFIG_TEXT *Ptr;
+  // Check parameters
+  if ((Text == NULL) || (*Text != NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if ((Format != CONFIG_FORMAT_JSON) && (Format != CONFIG_FORMAT_INI)) {
+    return EFI_UNSUPPORTED;
+  }
+  // Allocate the configuration text parser
+  Ptr = (CONFIG_TEXT *)AllocateZeroPool(sizeof(CONFIG_TEXT));
+  if (Ptr == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Ptr->Format = Format;
+  Ptr->PendingLast = &(Ptr->Pending);
+  // Create the language parser from the static states of the format
+  if (Format == CONFIG_FORMAT_JSON) {
+    Status = ConfigJsonCreateParser(&(Ptr->Parser));
+  } else {
+    Status = ConfigIniCreateParser(&(Ptr->Parser));
+  }
+  if (EFI_ERROR(Status)) {
+    FreePool(Ptr);
+    return Status;
+  }
+  // Return the configuration text parser
+  *Text = Ptr;
+  return EFI_SUCCESS;
+}
+// ConfigTextParseLeading
+/// Detect the encoding from the buffered leading bytes and parse them
+/// @param Text The configuration text parser
+/// @return Whether the leading bytes were parsed or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigTextParseLeading (
+  IN OUT CONFIG_TEXT *Text
+) {
+  EFI_STATUS  Status;
+  CHAR8      *Encoding = NULL;
+  UINTN       BomSize = 0;
+  Text->Started = TRUE;
+  if (Text->LeadingSize == 0) {
+    return EFI_SUCCESS;
+  }
+  // Detect the encoding from the byte order mark or the leading characters
+  ParseDetectEncoding(Text->LeadingSize, Text->Leading, &Encoding, &BomSize);
+  Status = ParseSetEncoding(Text->Parser, Encoding);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Skip the byte order mark
+  if (BomSize >= Text->LeadingSize) {
+    return EFI_SUCCESS;
+  }
+  return ParseBuffer(Text->Parser, Text->LeadingSize - BomSize, Text->Leading + BomSize, NULL, Text);
+}
+// ConfigTextParse
+/// Parse the next buffer of configuration text, the first buffer may contain a leading byte order mark and buffers may be
+///  split at any byte boundary
+/// @param Text   The configuration text parser
+/// @param Size   The size, in bytes, of the buffer
+/// @param Buffer The buffer to parse
+/// @return Whether the buffer was parsed or not
+EFI_STATUS
+EFIAPI
+ConfigTextParse (
+  IN OUT CONFIG_TEXT *Text,
+  IN     UINTN        Size,
+  IN     VOID        *Buffer
+) {
+  EFI_STATUS Status;
+  UINTN      Count;
+  // Check parameters
+  if ((Text == NULL) || (Buffer == NULL) || (Size == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (!Text->Started) {
+    // Buffer the leading bytes until there are enough to detect the encoding
+    Count = MIN(Size, CONFIG_TEXT_LEADING_SIZE - Text->LeadingSize);
+    CopyMem(Text->Leading + Text->LeadingSize, Buffer, Count);
+    Text->LeadingSize += Count;
+    if (Text->LeadingSize < CONFIG_TEXT_LEADING_SIZE) {
+      return EFI_SUCCESS;
+    }
+    Status = ConfigTextParseLeading(Text);
+    if (EFI_ERROR(Status) || (Count == Size)) {
+      return Status;
+    }
+    Buffer = ((UINT8 *)Buffer) + Count;
+    Size -= Count;
+  }
+  return ParseBuffer(Text->Parser, Size, Buffer, NULL, Text);
+}
+// ConfigTextFinish
+/// Finish parsing configuration text and set the staged values if the configuration text was complete
+/// @param Text The configuration text parser
+/// @return Whether the configuration text was complete or not
+/// @retval EFI_INVALID_PARAMETER If Text is NULL or the configuration text is incomplete
+/// @retval EFI_SUCCESS           If the configuration text was finished successfully
+EFI_STATUS
+EFIAPI
+ConfigTextFinish (
+  IN OUT CONFIG_TEXT *Text
+) {
+  EFI_STATUS Status;
+  UINT32     Separator;
+  // Check parameters
+  if (Text == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Parse the leading bytes of configuration text shorter than the bytes needed to detect the encoding
+  if (!Text->Started) {
+    Status = ConfigTextParseLeading(Text);
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+  }
+  // Discard any character left incomplete by the last buffer
+  ParseFinish(Text->Parser);
+  // Parse two final separators since a match is only completed by the character after it
+  Separator = (Text->Format == CONFIG_FORMAT_JSON) ? L' ' : L'\n';
+  Status = ParseCharacter(Text->Parser, Separator, Text);
+  if (!EFI_ERROR(Status)) {
+    Status = ParseCharacter(Text->Parser, Separator, Text);
+  }
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Check the format is complete
+  if (Text->Format == CONFIG_FORMAT_JSON) {
+    Status = ConfigJsonFinish(Text);
+  } else {
+    Status = ConfigIniFinish(Text);
+  }
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Set the staged values now that the whole configuration text was parsed
+  return ConfigTextCommit(Text, TRUE);
+}
+// ConfigTextLogMessages
+/// Log the errors and warnings of a configuration text parser with their input positions
+/// @param Text   The configuration text parser
+/// @param Source The unique source name
+VOID
+EFIAPI
+ConfigTextLogMessages (
+  IN CONFIG_TEXT *Text,
+  IN CHAR16      *Source OPTIONAL
+) {
+  LANG_POSITION  Position;
+  CHAR16        *Message;
+  UINTN          Flags;
+  UINTN          Count = 0;
+  UINTN          Dropped = 0;
+  UINTN          Index;
+  if ((Text == NULL) || EFI_ERROR(ParseGetMessageCount(Text->Parser, &Count, &Dropped)) || (Count == 0)) {
+    return;
+  }
+  if (Source == NULL) {
+    Source = L"configuration";
+  }
+  // Log each retained message
+  if (Dropped != 0) {
+    LOG(L"%s: %u earlier messages dropped\n", Source, Dropped);
+  }
+  for (Index = 0; Index < Count; ++Index) {
+    if (!EFI_ERROR(ParseGetMessage(Text->Parser, Index, &Flags, &Position, &Message))) {
+      LOG(L"%s(%u:%u): %s: %s\n", Source, Position.Line, Position.Column, (Flags == LANG_MESSAGE_ERROR) ? L"error" : L"warning", Message);
+    }
+  }
+}
+// ConfigTextFree
+/// Free a configuration text parser
+/// @param Text The configuration text parser to free
+/// @return Whether the configuration text parser was freed or not
+/// @retval EFI_INVALID_PARAMETER If Text is NULL
+/// @retval EFI_SUCCESS           If the configuration text parser was freed successfully
+EFI_STATUS
+EFIAPI
+ConfigTextFree (
+  IN CONFIG_TEXT *Text
+) {
+  // Check parameters
+  if (Text == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Free any values staged by incomplete configuration text
+  ConfigTextCommit(Text, FALSE);
+  // Free the paths of any containers left open
+  while (Text->Depth > 0) {
+    CONFIG_TEXT_LEVEL *Level = Text->Levels + (--(Text->Depth));
+    if (Level->Path != NULL) {
+      FreePool(Level->Path);
+    }
+  }
+  StrBuilderFree(&(Text->Value));
+  if (Text->Key != NULL) {
+    FreePool(Text->Key);
+  }
+  if (Text->Section != NULL) {
+    FreePool(Text->Section);
+  }
+  if (Text->Parser != NULL) {
+    // Log the parser profile in debug builds
+    ParseLogProfile(Text->Parser, (Text->Format == CONFIG_FORMAT_JSON) ? L"JSON" : L"INI");
+    FreeParser(Text->Parser);
+  }
+  FreePool(Text);
+  return EFI_SUCCESS;
+}
+
+// ConfigTextTrim
+/// Trim the leading and trailing whitespace of a string in place
+/// @param String The string to trim
+/// @return The trimmed string
+CHAR16 *
+EFIAPI
+ConfigTextTrim (
+  IN OUT CHAR16 *String
+) {
+  UINTN Length;
+  while ((*String == L' ') || (*String == L'\t') || (*String == L'\r') || (*String == L'\n')) {
+    ++String;
+  }
+  Length = StrLen(String);
+  while ((Length > 0) && ((String[Length - 1] == L' ') || (String[Length - 1] == L'\t') ||
+                          (String[Length - 1] == L'\r') || (String[Length - 1] == L'\n'))) {
+    String[--Length] = L'\0';
+  }
+  return String;
+}
+
+// ConfigTextSetBoolean
+/// Stage a boolean configuration value from configuration text
+/// @param Text    The configuration text parser
+/// @param Path    The configuration path
+/// @param Boolean The boolean value
+/// @return Whether the configuration value was staged or not
+EFI_STATUS
+EFIAPI
+ConfigTextSetBoolean (
+  IN OUT CONFIG_TEXT *Text,
+  IN     CHAR16      *Path,
+  IN     BOOLEAN      Boolean
+) {
+  CONFIG_VALUE Value;
+  Value.Boolean = Boolean;
+  return ConfigTextStage(Text, Path, CONFIG_TYPE_BOOLEAN, &Value);
+}
+// ConfigTextSetString
+/// Stage a string configuration value from configuration text
+/// @param Text  The configuration text parser
+/// @param Path  The configuration path
+/// @param Value The string value
+/// @return Whether the configuration value was staged or not
+EFI_STATUS
+EFIAPI
+ConfigTextSetString (
+  IN OUT CONFIG_TEXT *Text,
+  IN     CHAR16      *Path,
+  IN     CHAR16      *Value
+) {
+  CONFIG_VALUE String;
+  String.String = Value;
+  return ConfigTextStage(Text, Path, CONFIG_TYPE_STRING, &String);
+}
+// ConfigTextSetNumber
+/// Stage an integer configuration value from a number, fractions are truncated toward zero and magnitudes
+///  that do not fit saturate, non-negative numbers that only fit unsigned are set as unsigned integers
+/// @param Text        The configuration text parser
+/// @param Path        The configuration path
+/// @param Value       The number, a JSON number or a hexadecimal number if allowed
+/// @param Hexadecimal Whether hexadecimal numbers with a 0x prefix are allowed
+/// @return Whether the configuration value was staged or not
+/// @retval EFI_NOT_FOUND If Value is not a number
+EFI_STATUS
+EFIAPI
+ConfigTextSetNumber (
+  IN OUT CONFIG_TEXT *Text,
+  IN     CHAR16      *Path,
+  IN     CHAR16      *Value,
+  IN     BOOLEAN      Hexadecimal
+) {
+  CONFIG_VALUE  Number;
+  CHAR16       *Ptr = Value;
+  CHAR16       *Integer;
+  CHAR16  *Fraction = NULL;
+  UINTN    IntegerCount = 0;
+  UINTN    FractionCount = 0;
+  UINTN    Exponent = 0;
+  UINTN    Point;
+  UINTN    Magnitude = 0;
+  UINTN    Index;
+  BOOLEAN  Negative = FALSE;
+  BOOLEAN  NegativeExponent = FALSE;
+  // Sign
+  if (*Ptr == L'-') {
+    Negative = TRUE;
+    ++Ptr;
+  }
+  // Hexadecimal numbers
+  if (Hexadecimal && (*Ptr == L'0') && ((Ptr[1] == L'x') || (Ptr[1] == L'X'))) {
+    for (Index = 2; Ptr[Index] != L'\0'; ++Index) {
+      if (!(((Ptr[Index] >= L'0') && (Ptr[Index] <= L'9')) || ((Ptr[Index] >= L'a') && (Ptr[Index] <= L'f')) ||
+            ((Ptr[Index] >= L'A') && (Ptr[Index] <= L'F')))) {
+        return EFI_NOT_FOUND;
+      }
+    }
+    if (Index == 2) {
+      return EFI_NOT_FOUND;
+    }
+    Magnitude = StrHexToUintn(Ptr + 2);
+    if (!Negative) {
+      Number.Unsigned = Magnitude;
+      return ConfigTextStage(Text, Path, CONFIG_TYPE_UNSIGNED, &Number);
+    }
+  } else {
+    // Integer digits
+    Integer = Ptr;
+    while ((*Ptr >= L'0') && (*Ptr <= L'9')) {
+      ++IntegerCount;
+      ++Ptr;
+    }
+    if (IntegerCount == 0) {
+      return EFI_NOT_FOUND;
+    }
+    // Fraction digits
+    if (*Ptr == L'.') {
+      Fraction = ++Ptr;
+      while ((*Ptr >= L'0') && (*Ptr <= L'9')) {
+        ++FractionCount;
+        ++Ptr;
+      }
+      if (FractionCount == 0) {
+        return EFI_NOT_FOUND;
+      }
+    }
+    // Exponent, large exponents are clamped since they saturate anyway
+    if ((*Ptr == L'e') || (*Ptr == L'E')) {
+      ++Ptr;
+      if ((*Ptr == L'-') || (*Ptr == L'+')) {
+        NegativeExponent = (*Ptr++ == L'-');
+      }
+      if ((*Ptr < L'0') || (*Ptr > L'9')) {
+        return EFI_NOT_FOUND;
+      }
+      while ((*Ptr >= L'0') && (*Ptr <= L'9')) {
+        if (Exponent < 0x100) {
+          Exponent = (Exponent * 10) + (*Ptr - L'0');
+        }
+        ++Ptr;
+      }
+    }
+    if (*Ptr != L'\0') {
+      return EFI_NOT_FOUND;
+    }
+    // Accumulate the digits before the decimal point after applying the exponent
+    if (NegativeExponent) {
+      Point = (Exponent < IntegerCount) ? (IntegerCount - Exponent) : 0;
+    } else {
+      Point = IntegerCount + Exponent;
+    }
+    for (Index = 0; Index < Point; ++Index) {
+      UINTN Digit = 0;
+      if (Index < IntegerCount) {
+        Digit = Integer[Index] - L'0';
+      } else if ((Index - IntegerCount) < FractionCount) {
+        Digit = Fraction[Index - IntegerCount] - L'0';
+      }
+      if (Magnitude > ((MAX_UINTN - Digit) / 10)) {
+        Magnitude = MAX_UINTN;
+        break;
+      }
+      Magnitude = (Magnitude * 10) + Digit;
+    }
+    // Non-negative numbers too large for an integer are unsigned
+    if (!Negative && (Magnitude > (UINTN)MAX_INTN)) {
+      Number.Unsigned = Magnitude;
+      return ConfigTextStage(Text, Path, CONFIG_TYPE_UNSIGNED, &Number);
+    }
+  }
+  // Integer value
+  if (Negative) {
+    Number.Integer = (Magnitude > (UINTN)MAX_INTN) ? -MAX_INTN : -(INTN)Magnitude;
+  } else {
+    Number.Integer = (INTN)Magnitude;
+  }
+  return ConfigTextStage(Text, Path, CONFIG_TYPE_INTEGER, &Number);
+}
+// ConfigTextIsInteger
+/// Check whether untyped configuration text is a decimal integer or a hexadecimal integer with a 0x prefix
+/// @param Value The configuration text value
+/// @retval TRUE  If the value is an integer
+/// @retval FALSE If the value is not an integer
+STATIC BOOLEAN
+EFIAPI
+ConfigTextIsInteger (
+  IN CHAR16 *Value
+) {
+  BOOLEAN Hexadecimal = FALSE;
+  if (*Value == L'-') {
+    ++Value;
+  }
+  if ((Value[0] == L'0') && ((Value[1] == L'x') || (Value[1] == L'X'))) {
+    Hexadecimal = TRUE;
+    Value += 2;
+  }
+  if (*Value == L'\0') {
+    return FALSE;
+  }
+  for (; *Value != L'\0'; ++Value) {
+    if (((*Value < L'0') || (*Value > L'9')) &&
+        (!Hexadecimal || (((*Value < L'a') || (*Value > L'f')) && ((*Value < L'A') || (*Value > L'F'))))) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+// ConfigTextSetValue
+/// Stage a configuration value from untyped configuration text, quoted values are strings, booleans and
+///  decimal or hexadecimal integers are recognized, anything else, including numbers with a fraction or
+///  exponent, is a string
+/// @param Text  The configuration text parser
+/// @param Path  The configuration path
+/// @param Value The configuration text value, which may be modified
+/// @return Whether the configuration value was staged or not
+EFI_STATUS
+EFIAPI
+ConfigTextSetValue (
+  IN OUT CONFIG_TEXT *Text,
+  IN     CHAR16      *Path,
+  IN OUT CHAR16      *Value
+) {
+  UINTN Length = StrLen(Value);
+  // Quoted strings
+  if ((Length >= 2) && (((Value[0] == L'"') && (Value[Length - 1] == L'"')) ||
+                        ((Value[0] == L'\'') && (Value[Length - 1] == L'\'')))) {
+    Value[Length - 1] = L'\0';
+    return ConfigTextSetString(Text, Path, Value + 1);
+  }
+  // Booleans
+  if ((StriCmp(Value, L"true") == 0) || (StriCmp(Value, L"yes") == 0) || (StriCmp(Value, L"on") == 0)) {
+    return ConfigTextSetBoolean(Text, Path, TRUE);
+  }
+  if ((StriCmp(Value, L"false") == 0) || (StriCmp(Value, L"no") == 0) || (StriCmp(Value, L"off") == 0)) {
+    return ConfigTextSetBoolean(Text, Path, FALSE);
+  }
+  // Integers, numbers with a fraction or exponent such as versions stay strings
+  if (ConfigTextIsInteger(Value)) {
+    return ConfigTextSetNumber(Text, Path, Value, TRUE);
+  }
+  // Anything else is a string
+  return ConfigTextSetString(Text, Path, Value);
+}
+
+// ConfigTextParseBuffer
+/// Parse configuration text from a buffer
+/// @param Format The configuration text format
+/// @param Size   The size, in bytes, of the buffer
+/// @param Buffer The buffer to parse
+/// @param Source The unique source name
+/// @return Whether the configuration was parsed successfully or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigTextParseBuffer (
+  IN CONFIG_FORMAT  Format,
+  IN UINTN          Size,
+  IN VOID          *Buffer,
+  IN CHAR16        *Source OPTIONAL
+) {
+  EFI_STATUS   Status;
+  CONFIG_TEXT *Text = NULL;
+  // Check parameters
+  if ((Buffer == NULL) || (Size == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Create the configuration text parser
+  Status = ConfigTextCreate(&Text, Format);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Parse and finish the configuration text
+  Status = ConfigTextParse(Text, Size, Buffer);
+  if (!EFI_ERROR(Status)) {
+    Status = ConfigTextFinish(Text);
+  }
+  // Log the parser errors and warnings then free the parser
+  ConfigTextLogMessages(Text, Source);
+  ConfigTextFree(Text);
+  return Status;
+}
+// ConfigParseJson
+/// Parse configuration information from JSON in a single pass without building a document,
+///  object members are paths and array members are indexed like configuration groups, no values are set
+///  unless the whole JSON is valid
+/// @param Size   The size, in bytes, of the JSON
+/// @param Json   The JSON to parse
+/// @param Source The unique source name
+/// @return Whether the configuration was parsed successfully or not
+/// @retval EFI_INVALID_PARAMETER If Json is NULL, Size is zero, or the JSON is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the JSON was parsed successfully
+EFI_STATUS
+EFIAPI
+ConfigParseJson (
+  IN UINTN   Size,
+  IN VOID   *Json,
+  IN CHAR16 *Source OPTIONAL
+) {
+  return ConfigTextParseBuffer(CONFIG_FORMAT_JSON, Size, Json, Source);
+}
+// ConfigParseIni
+/// Parse configuration information from INI, sections are paths and values are typed by their text, no
+///  values are set unless the whole INI is valid
+/// @param Size   The size, in bytes, of the INI
+/// @param Ini    The INI to parse
+/// @param Source The unique source name
+/// @return Whether the configuration was parsed successfully or not
+/// @retval EFI_INVALID_PARAMETER If Ini is NULL, Size is zero, or the INI is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the INI was parsed successfully
+EFI_STATUS
+EFIAPI
+ConfigParseIni (
+  IN UINTN   Size,
+  IN VOID   *Ini,
+  IN CHAR16 *Source OPTIONAL
+) {
+  return ConfigTextParseBuffer(CONFIG_FORMAT_INI, Size, Ini, Source);
+}
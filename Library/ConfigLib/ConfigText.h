@@ -0,0 +1,344 @@
+//
+/// @file Library/ConfigLib/ConfigText.h
+///
+/// Configuration text front ends
+///
+
+#pragma once
+#ifndef __CONFIG_LIBRARY_TEXT_HEADER__
+#define __CONFIG_LIBRARY_TEXT_HEADER__
+
+#include <Library/ConfigLib.h>
+
+#include <Library/LogLib.h>
+
+// CONFIG_FORMAT
+/// Configuration source format
+typedef enum _CONFIG_FORMAT CONFIG_FORMAT;
+enum _CONFIG_FORMAT {
+
+  CONFIG_FORMAT_XML = 0,
+  CONFIG_FORMAT_BINARY_PLIST,
+  CONFIG_FORMAT_JSON,
+  CONFIG_FORMAT_INI,
+
+};
+
+// CONFIG_JSON_STATE
+/// JSON parser state identifiers
+typedef enum _CONFIG_JSON_STATE CONFIG_JSON_STATE;
+enum _CONFIG_JSON_STATE {
+
+  CONFIG_JSON_STATE_VALUE = 0,
+  CONFIG_JSON_STATE_STRING,
+
+};
+// CONFIG_INI_STATE
+/// INI parser state identifiers
+typedef enum _CONFIG_INI_STATE CONFIG_INI_STATE;
+enum _CONFIG_INI_STATE {
+
+  CONFIG_INI_STATE_LINE = 0,
+  CONFIG_INI_STATE_SECTION,
+  CONFIG_INI_STATE_VALUE,
+  CONFIG_INI_STATE_COMMENT,
+
+};
+// CONFIG_JSON_EXPECT
+/// The next JSON token expected by the parser
+typedef enum _CONFIG_JSON_EXPECT CONFIG_JSON_EXPECT;
+enum _CONFIG_JSON_EXPECT {
+
+  CONFIG_JSON_EXPECT_VALUE = 0,
+  CONFIG_JSON_EXPECT_KEY,
+  CONFIG_JSON_EXPECT_COLON,
+  CONFIG_JSON_EXPECT_NEXT,
+  CONFIG_JSON_EXPECT_END,
+
+};
+
+// CONFIG_TEXT_MAX_DEPTH
+/// The maximum nesting depth of JSON containers
+#define CONFIG_TEXT_MAX_DEPTH 32
+// CONFIG_TEXT_LEADING_SIZE
+/// The count of leading bytes buffered to detect the encoding, enough for any byte order mark and two UTF-16 characters
+#define CONFIG_TEXT_LEADING_SIZE 4
+
+// CONFIG_TEXT_LEVEL
+/// JSON container nesting level
+typedef struct _CONFIG_TEXT_LEVEL CONFIG_TEXT_LEVEL;
+struct _CONFIG_TEXT_LEVEL {
+
+  // Path
+  /// The configuration path of the container or NULL for root
+  CHAR16  *Path;
+  // Index
+  /// The index of the next array member
+  UINTN    Index;
+  // Array
+  /// Whether the container is an array or an object
+  BOOLEAN  Array;
+  // Empty
+  /// Whether the container has no members yet
+  BOOLEAN  Empty;
+
+};
+// CONFIG_TEXT_PENDING
+/// Configuration value parsed from configuration text but not yet set
+typedef struct _CONFIG_TEXT_PENDING CONFIG_TEXT_PENDING;
+struct _CONFIG_TEXT_PENDING {
+
+  // Next
+  /// The next pending value in parsed order
+  CONFIG_TEXT_PENDING *Next;
+  // Path
+  /// The configuration path
+  CHAR16              *Path;
+  // Type
+  /// The configuration value type
+  CONFIG_TYPE          Type;
+  // Value
+  /// The configuration value, strings are owned by the pending value
+  CONFIG_VALUE         Value;
+
+};
+// CONFIG_TEXT
+/// Configuration text parser, values are staged while parsing without building a document and only set once
+///  the whole configuration text was parsed
+typedef struct _CONFIG_TEXT CONFIG_TEXT;
+struct _CONFIG_TEXT {
+
+  // Parser
+  /// The language parser
+  LANG_PARSER           *Parser;
+  // Format
+  /// The text format
+  CONFIG_FORMAT          Format;
+  // Started
+  /// Whether the encoding has been detected from the leading bytes
+  BOOLEAN                Started;
+  // Leading
+  /// The leading bytes buffered until there are enough to detect the encoding
+  UINT8                  Leading[CONFIG_TEXT_LEADING_SIZE];
+  // LeadingSize
+  /// The size, in bytes, of the buffered leading bytes
+  UINTN                  LeadingSize;
+  // Value
+  /// The current string value or INI value
+  STR_BUILDER            Value;
+  // Key
+  /// The current JSON object member key or INI key
+  CHAR16                *Key;
+  // Section
+  /// The current INI section path or NULL for root
+  CHAR16                *Section;
+  // Expect
+  /// The next JSON token expected
+  CONFIG_JSON_EXPECT     Expect;
+  // Unicode
+  /// Whether a JSON unicode escape is waiting for its hexadecimal digits
+  BOOLEAN                Unicode;
+  // Surrogate
+  /// The pending high surrogate of a JSON unicode escape pair or zero if none
+  UINT32                 Surrogate;
+  // Depth
+  /// The count of open JSON containers
+  UINTN                  Depth;
+  // Levels
+  /// The open JSON containers
+  CONFIG_TEXT_LEVEL      Levels[CONFIG_TEXT_MAX_DEPTH];
+  // Pending
+  /// The values parsed but not yet set
+  CONFIG_TEXT_PENDING   *Pending;
+  // PendingLast
+  /// The link to the next pending value after the last pending value
+  CONFIG_TEXT_PENDING  **PendingLast;
+
+};
+
+// ConfigTextDetectFormat
+/// Detect the format of configuration from the source name extension or the leading characters
+/// @param Size   The size, in bytes, of the leading buffer
+/// @param Buffer The leading buffer of the configuration
+/// @param Source The unique source name
+/// @return The detected configuration format, XML if the format could not be detected
+CONFIG_FORMAT
+EFIAPI
+ConfigTextDetectFormat (
+  IN UINTN   Size,
+  IN VOID   *Buffer,
+  IN CHAR16 *Source OPTIONAL
+);
+// ConfigTextCreate
+/// Create a configuration text parser
+/// @param Text   On output, the configuration text parser, which must be freed with ConfigTextFree
+/// @param Format The configuration text format, either JSON or INI
+/// @return Whether the configuration text parser was created or not
+/// @retval EFI_INVALID_PARAMETER If Text is NULL or *Text is not NULL
+/// @retval EFI_UNSUPPORTED       If Format is not a text format
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the configuration text parser was created successfully
+EFI_STATUS
+EFIAPI
+ConfigTextCreate (
+  OUT CONFIG_TEXT   **Text,
+  IN  CONFIG_FORMAT   Format
+);
+// ConfigTextParse
+/// Parse the next buffer of configuration text, the first buffer may contain a leading byte order mark and buffers may be
+///  split at any byte boundary
+/// @param Text   The configuration text parser
+/// @param Size   The size, in bytes, of the buffer
+/// @param Buffer The buffer to parse
+/// @return Whether the buffer was parsed or not
+EFI_STATUS
+EFIAPI
+ConfigTextParse (
+  IN OUT CONFIG_TEXT *Text,
+  IN     UINTN        Size,
+  IN     VOID        *Buffer
+);
+// ConfigTextFinish
+/// Finish parsing configuration text and set the staged values if the configuration text was complete
+/// @param Text The configuration text parser
+/// @return Whether the configuration text was complete or not
+/// @retval EFI_INVALID_PARAMETER If Text is NULL or the configuration text is incomplete
+/// @retval EFI_SUCCESS           If the configuration text was finished successfully
+EFI_STATUS
+EFIAPI
+ConfigTextFinish (
+  IN OUT CONFIG_TEXT *Text
+);
+// ConfigTextLogMessages
+/// Log the errors and warnings of a configuration text parser with their input positions
+/// @param Text   The configuration text parser
+/// @param Source The unique source name
+VOID
+EFIAPI
+ConfigTextLogMessages (
+  IN CONFIG_TEXT *Text,
+  IN CHAR16      *Source OPTIONAL
+);
+// ConfigTextFree
+/// Free a configuration text parser
+/// @param Text The configuration text parser to free
+/// @return Whether the configuration text parser was freed or not
+/// @retval EFI_INVALID_PARAMETER If Text is NULL
+/// @retval EFI_SUCCESS           If the configuration text parser was freed successfully
+EFI_STATUS
+EFIAPI
+ConfigTextFree (
+  IN CONFIG_TEXT *Text
+);
+
+// ConfigTextTrim
+/// Trim the leading and trailing whitespace of a string in place
+/// @param String The string to trim
+/// @return The trimmed string
+CHAR16 *
+EFIAPI
+ConfigTextTrim (
+  IN OUT CHAR16 *String
+);
+
+// ConfigTextSetBoolean
+/// Stage a boolean configuration value from configuration text
+/// @param Text    The configuration text parser
+/// @param Path    The configuration path
+/// @param Boolean The boolean value
+/// @return Whether the configuration value was staged or not
+EFI_STATUS
+EFIAPI
+ConfigTextSetBoolean (
+  IN OUT CONFIG_TEXT *Text,
+  IN     CHAR16      *Path,
+  IN     BOOLEAN      Boolean
+);
+// ConfigTextSetString
+/// Stage a string configuration value from configuration text
+/// @param Text  The configuration text parser
+/// @param Path  The configuration path
+/// @param Value The string value
+/// @return Whether the configuration value was staged or not
+EFI_STATUS
+EFIAPI
+ConfigTextSetString (
+  IN OUT CONFIG_TEXT *Text,
+  IN     CHAR16      *Path,
+  IN     CHAR16      *Value
+);
+// ConfigTextSetNumber
+/// Stage an integer configuration value from a number, fractions are truncated toward zero and magnitudes
+///  that do not fit saturate, non-negative numbers that only fit unsigned are set as unsigned integers
+/// @param Text        The configuration text parser
+/// @param Path        The configuration path
+/// @param Value       The number, a JSON number or a hexadecimal number if allowed
+/// @param Hexadecimal Whether hexadecimal numbers with a 0x prefix are allowed
+/// @return Whether the configuration value was staged or not
+/// @retval EFI_NOT_FOUND If Value is not a number
+EFI_STATUS
+EFIAPI
+ConfigTextSetNumber (
+  IN OUT CONFIG_TEXT *Text,
+  IN     CHAR16      *Path,
+  IN     CHAR16      *Value,
+  IN     BOOLEAN      Hexadecimal
+);
+// ConfigTextSetValue
+/// Stage a configuration value from untyped configuration text, quoted values are strings, booleans and
+///  decimal or hexadecimal integers are recognized, anything else, including numbers with a fraction or
+///  exponent, is a string
+/// @param Text  The configuration text parser
+/// @param Path  The configuration path
+/// @param Value The configuration text value, which may be modified
+/// @return Whether the configuration value was staged or not
+EFI_STATUS
+EFIAPI
+ConfigTextSetValue (
+  IN OUT CONFIG_TEXT *Text,
+  IN     CHAR16      *Path,
+  IN OUT CHAR16      *Value
+);
+
+// ConfigJsonCreateParser
+/// Create a language parser for JSON configuration
+/// @param Parser On output, the language parser, which must be freed with FreeParser
+/// @return Whether the language parser was created or not
+EFI_STATUS
+EFIAPI
+ConfigJsonCreateParser (
+  OUT LANG_PARSER **Parser
+);
+// ConfigJsonFinish
+/// Check a JSON configuration is complete and release the open containers
+/// @param Text The configuration text parser
+/// @return Whether the JSON configuration was complete or not
+/// @retval EFI_INVALID_PARAMETER If the JSON configuration is incomplete
+/// @retval EFI_SUCCESS           If the JSON configuration was complete
+EFI_STATUS
+EFIAPI
+ConfigJsonFinish (
+  IN OUT CONFIG_TEXT *Text
+);
+// ConfigIniCreateParser
+/// Create a language parser for INI configuration
+/// @param Parser On output, the language parser, which must be freed with FreeParser
+/// @return Whether the language parser was created or not
+EFI_STATUS
+EFIAPI
+ConfigIniCreateParser (
+  OUT LANG_PARSER **Parser
+);
+// ConfigIniFinish
+/// Check an INI configuration did not end inside a section name
+/// @param Text The configuration text parser
+/// @return Whether the INI configuration was complete or not
+/// @retval EFI_INVALID_PARAMETER If the INI configuration is incomplete
+/// @retval EFI_SUCCESS           If the INI configuration was complete
+EFI_STATUS
+EFIAPI
+ConfigIniFinish (
+  IN OUT CONFIG_TEXT *Text
+);
+
+#endif // __CONFIG_LIBRARY_TEXT_HEADER__
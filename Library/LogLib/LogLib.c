@@ -115,6 +115,15 @@ STATIC LOG_CHUNK    *mLogChunks = NULL;
 // mLogChunk
 /// Log current contents chunk
 STATIC LOG_CHUNK    *mLogChunk = NULL;
+// mLogLine
+/// Log prefixed line, the allocated size is retained between lines
+STATIC STR_BUILDER   mLogLine = { 0, 0, NULL };
+// mLogText
+/// Log UTF-8 text for serial and file output, the allocated size is retained between lines
+STATIC CHAR8        *mLogText = NULL;
+// mLogTextSize
+/// The allocated size, in bytes, of the log UTF-8 text
+STATIC UINTN         mLogTextSize = 0;
 // mLogHandle
 /// Log protocol handle
 STATIC EFI_HANDLE    mLogHandle = NULL;
@@ -185,6 +194,38 @@ Log3 (
   VA_END(Args);
   return Count;
 }
+// LogToUtf8
+/// Convert log text to UTF-8 in the retained log text buffer
+/// @param Count The count of characters of log text
+/// @param Text  The log text
+/// @param Size  On output, the size, in bytes, of the UTF-8 text
+/// @return The UTF-8 text, which must not be freed, or NULL if the log text could not be converted
+STATIC CHAR8 *
+EFIAPI
+LogToUtf8 (
+  IN  UINTN   Count,
+  IN  CHAR16 *Text,
+  OUT UINTN  *Size
+) {
+  EFI_STATUS Status;
+  *Size = mLogTextSize;
+  Status = Utf16ToUtf8(Count, Text, Size, mLogText);
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    // Grow the buffer to the size needed
+    if (mLogText != NULL) {
+      FreePool(mLogText);
+    }
+    mLogTextSize = ALIGN_VALUE(*Size, 0x400);
+    mLogText = (CHAR8 *)AllocatePool(mLogTextSize);
+    if (mLogText == NULL) {
+      mLogTextSize = 0;
+      return NULL;
+    }
+    *Size = mLogTextSize;
+    Status = Utf16ToUtf8(Count, Text, Size, mLogText);
+  }
+  return EFI_ERROR(Status) ? NULL : mLogText;
+}
 // LogVPrint
 /// Print to the log with variable arguments list
 /// @param Outputs The log output methods to use for printing
@@ -237,9 +278,8 @@ LogVPrint (
     Buffer = mLogChunk->Text + (mLogChunk->Size / sizeof(CHAR16));
     Count = UnicodeVSPrint(Buffer, LOG_CHUNK_SIZE - mLogChunk->Size, Format, Args);
     if (Count > 0) {
-      CHAR8 *Text = ToAscii(Buffer);
+      CHAR8 *Text = LogToUtf8(Count, Buffer, &Size);
       if (Text != NULL) {
-        Size = AsciiStrLen(Text) * sizeof(CHAR8);
 
 #if defined(PROJECT_DEBUG)
 
@@ -268,7 +308,6 @@ LogVPrint (
             (*Outputs) &= ~LOG_OUTPUT_FILE;
           }
         }
-        FreePool(Text);
       }
       // Print to console
       if (((*Outputs) & LOG_OUTPUT_CONSOLE) != 0) {
@@ -335,6 +374,14 @@ VLog3 (
   VA_LIST  Args
 ) {
   UINTN Count = 0;
+  // Format the prefix and text as one line so the log outputs are only written once
+  if ((Prefix != NULL) && (Format != NULL)) {
+    StrBuilderReset(&mLogLine);
+    if (!EFI_ERROR(StrBuilderAppendSPrint(&mLogLine, L"%- *s ", Width, Prefix)) &&
+        !EFI_ERROR(StrBuilderAppendVSPrint(&mLogLine, Format, Args))) {
+      return Log(L"%s", mLogLine.Buffer);
+    }
+  }
   if (Prefix != NULL) {
     Count += Log(L"%- *s ", Width, Prefix);
   }
@@ -597,11 +644,10 @@ LogSaveLog (
       // Write each chunk to log file
       while (Chunk != NULL) {
         // Write this chunk to log file
-        CHAR8 *Text = ToAscii(Chunk->Text);
-        if (Text != NULL) {
-          UINTN Size = AsciiStrLen(Text) * sizeof(CHAR8);
+        UINTN  Size = 0;
+        CHAR8 *Text = LogToUtf8(Chunk->Size / sizeof(CHAR16), Chunk->Text, &Size);
+        if ((Text != NULL) && (Size != 0)) {
           Status = FileHandleWrite(Handle, &Size, (VOID *)Text);
-          FreePool(Text);
           if (EFI_ERROR(Status)) {
             break;
           }
@@ -877,6 +923,14 @@ LogLibFinish (
     FreePool(mLogPath);
     mLogPath = NULL;
   }
+  // Free the log line
+  StrBuilderFree(&mLogLine);
+  // Free the log text
+  if (mLogText != NULL) {
+    FreePool(mLogText);
+    mLogText = NULL;
+  }
+  mLogTextSize = 0;
   // Free all the log chunks
   while (mLogChunks != NULL) {
     mLogChunk = mLogChunks;
@@ -8,27 +8,22 @@
 
 #include <Library/PlatformLib.h>
 
-// LANG_MESSAGE_ERROR
-/// Language error message
-#define LANG_MESSAGE_ERROR 1
-// LANG_MESSAGE_WARNING
-/// Language warning message
-#define LANG_MESSAGE_WARNING 2
+#include <Library/TimerLib.h>
 
 // LANG_MESSAGE
 /// Language message
 typedef struct _LANG_MESSAGE LANG_MESSAGE;
 struct _LANG_MESSAGE {
 
-  // Next
-  /// The next message
-  LANG_MESSAGE *Next;
   // Flags
   /// The message flags
-  UINTN         Flags;
+  UINTN          Flags;
+  // Position
+  /// The input position at which the message was added
+  LANG_POSITION  Position;
   // Message
   /// The message
-  CHAR16       *Message;
+  CHAR16        *Message;
 
 };
 // LANG_LIST
@@ -43,6 +38,22 @@ struct _LANG_LIST {
   /// The state
   LANG_STATE *State;
 
+};
+// LANG_DECODER
+/// Language character decoder
+typedef struct _LANG_DECODER LANG_DECODER;
+struct _LANG_DECODER {
+
+  // Next
+  /// The next registered character decoder
+  LANG_DECODER *Next;
+  // Encoding
+  /// The name of the encoding
+  CHAR8        *Encoding;
+  // Decode
+  /// The character decoder
+  LANG_DECODE   Decode;
+
 };
 // LANG_RULE
 /// Language state rule
@@ -63,6 +74,9 @@ struct _LANG_RULE {
   // Tokens
   /// The set of token strings
   CHAR16        **Tokens;
+  // MaxLength
+  /// The length of the longest token string in the set
+  UINTN           MaxLength;
 
 };
 // LANG_STATE
@@ -86,25 +100,75 @@ struct _LANG_STATE {
   LANG_RULE     **Rules;
 
 };
+// LANG_SHARED_STATES
+/// Language parser states compiled once from static states and shared by every parser created from them
+typedef struct _LANG_SHARED_STATES LANG_SHARED_STATES;
+struct _LANG_SHARED_STATES {
+
+  // Next
+  /// The next compiled shared states
+  LANG_SHARED_STATES  *Next;
+  // StaticStates
+  /// The static states from which these states were compiled
+  LANG_STATIC_STATE   *StaticStates;
+  // Count
+  /// The count of parser states
+  UINTN                Count;
+  // States
+  /// The parser states, which reference the static token strings
+  LANG_STATE         **States;
+
+};
+
+#if defined(PROJECT_DEBUG)
+
+// LANG_PROFILE
+/// Language parser state profile
+typedef struct _LANG_PROFILE LANG_PROFILE;
+struct _LANG_PROFILE {
+
+  // Id
+  /// The language state identifier
+  UINTN   Id;
+  // Characters
+  /// The count of characters consumed in this state
+  UINTN   Characters;
+  // Checks
+  /// The count of rules checked in this state
+  UINTN   Checks;
+  // Matches
+  /// The count of rules satisfied in this state
+  UINTN   Matches;
+  // Callbacks
+  /// The count of token parsed callbacks in this state
+  UINTN   Callbacks;
+  // Ticks
+  /// The performance counter ticks spent parsing characters in this state
+  UINT64  Ticks;
+
+};
+
+#endif
+
 // LANG_PARSER
 /// Language parser
 struct _LANG_PARSER {
 
-  // DecodeCount
-  /// Decoded character expected remaining character count
-  UINT32          DecodeCount;
-  // DecodedCharacter
-  /// Decoded character
-  UINT32          DecodedCharacter;
-  // TokenCount
-  /// The current parsed token count of characters
-  UINTN           TokenCount;
-  // TokenSize
-  /// The current parsed token maximum count of characters, including null-terminator
-  UINTN           TokenSize;
+  // Decoder
+  /// The character decoder used to decode buffers
+  LANG_DECODER   *Decoder;
+  // PendingSize
+  /// The size, in bytes, of the incomplete character sequence retained from the previous buffer
+  UINTN           PendingSize;
+  // Pending
+  /// The incomplete character sequence retained from the previous buffer
+  UINT8           Pending[LANG_DECODE_MAX_SEQUENCE];
+  // Surrogate
+  /// The pending high surrogate of a surrogate pair or zero if none
+  UINT32          Surrogate;
   // Token
-  /// The current parsed token
-  CHAR16         *Token;
+  /// The current parsed token, the allocated size is retained between tokens
+  STR_BUILDER     Token;
   // Callback
   /// Token parsed callback
   LANG_CALLBACK   Callback;
@@ -120,12 +184,317 @@ struct _LANG_PARSER {
   // States
   /// The parser states
   LANG_STATE    **States;
+  // SharedStates
+  /// Whether the parser states are shared and must not be freed by the parser
+  BOOLEAN         SharedStates;
+  // Position
+  /// The input position of the character last parsed
+  LANG_POSITION   Position;
+  // NextPosition
+  /// The input position of the next character to parse
+  LANG_POSITION   NextPosition;
+  // MessageFirst
+  /// The index of the oldest retained message in the message ring
+  UINTN           MessageFirst;
+  // MessageCount
+  /// The count of retained messages
+  UINTN           MessageCount;
+  // MessageDropped
+  /// The count of messages dropped because the message ring was full
+  UINTN           MessageDropped;
   // Messages
-  /// The parser messages
+  /// The parser message ring, allocated when the first message is added
   LANG_MESSAGE   *Messages;
 
+#if defined(PROJECT_DEBUG)
+
+  // Reallocations
+  /// The count of token buffer reallocations
+  UINTN           Reallocations;
+  // ProfileCount
+  /// The count of state profiles
+  UINTN           ProfileCount;
+  // Profiles
+  /// The state profiles in the order the states were first entered
+  LANG_PROFILE   *Profiles;
+  // Profile
+  /// The profile of the state in which the current character is parsed
+  LANG_PROFILE   *Profile;
+
+#endif
+
 };
 
+// DecodeUtf8
+/// Decode UTF-8 characters, invalid and overlong sequences are skipped
+/// @param Size       The size, in bytes, of the encoded buffer
+/// @param Buffer     The encoded buffer
+/// @param Used       On output, the size, in bytes, of the buffer that was used, any remaining bytes are an incomplete character sequence
+/// @param Count      On input, the maximum count of characters to decode, on output, the count of characters decoded
+/// @param Characters On output, the decoded characters
+STATIC VOID
+EFIAPI
+DecodeUtf8 (
+  IN     UINTN   Size,
+  IN     UINT8  *Buffer,
+  OUT    UINTN  *Used,
+  IN OUT UINTN  *Count,
+  OUT    UINT32 *Characters
+) {
+  UINTN Index = 0;
+  UINTN Decoded = 0;
+  while ((Index < Size) && (Decoded < *Count)) {
+    UINT32 Character = Buffer[Index];
+    UINT32 Minimum;
+    UINTN  Length;
+    UINTN  Trail;
+    // ASCII characters
+    if (Character < 0x80) {
+      Characters[Decoded++] = Character;
+      ++Index;
+      continue;
+    }
+    // Header character
+    if ((Character & 0xE0) == 0xC0) {
+      Length = 2;
+      Minimum = 0x80;
+      Character &= 0x1F;
+    } else if ((Character & 0xF0) == 0xE0) {
+      Length = 3;
+      Minimum = 0x800;
+      Character &= 0x0F;
+    } else if ((Character & 0xF8) == 0xF0) {
+      Length = 4;
+      Minimum = 0x10000;
+      Character &= 0x07;
+    } else {
+      // Invalid character sequence
+      ++Index;
+      continue;
+    }
+    // Trailing characters
+    for (Trail = 1; (Trail < Length) && ((Index + Trail) < Size); ++Trail) {
+      if ((Buffer[Index + Trail] & 0xC0) != 0x80) {
+        break;
+      }
+      Character = ((Character << 6) | (Buffer[Index + Trail] & 0x3F));
+    }
+    if (Trail < Length) {
+      if ((Index + Trail) == Size) {
+        // Incomplete character sequence at the end of the buffer
+        break;
+      }
+      // Invalid character sequence
+      Index += Trail;
+      continue;
+    }
+    Index += Length;
+    // Check for overlong sequences, surrogates and characters outside the unicode range
+    if ((Character < Minimum) || (Character > 0x10FFFF) ||
+        ((Character >= 0xD800) && (Character < 0xE000))) {
+      continue;
+    }
+    Characters[Decoded++] = Character;
+  }
+  *Used = Index;
+  *Count = Decoded;
+}
+// DecodeUtf16
+/// Decode UTF-16 characters, unpaired surrogates are skipped
+/// @param Size       The size, in bytes, of the encoded buffer
+/// @param Buffer     The encoded buffer
+/// @param Used       On output, the size, in bytes, of the buffer that was used, any remaining bytes are an incomplete character sequence
+/// @param Count      On input, the maximum count of characters to decode, on output, the count of characters decoded
+/// @param Characters On output, the decoded characters
+/// @param BigEndian  Whether the byte order is big endian or little endian
+STATIC VOID
+EFIAPI
+DecodeUtf16 (
+  IN     UINTN    Size,
+  IN     UINT8   *Buffer,
+  OUT    UINTN   *Used,
+  IN OUT UINTN   *Count,
+  OUT    UINT32  *Characters,
+  IN     BOOLEAN  BigEndian
+) {
+  UINTN Index = 0;
+  UINTN Decoded = 0;
+  UINTN High = (BigEndian ? 0 : 1);
+  UINTN Low = (BigEndian ? 1 : 0);
+  while (((Index + 1) < Size) && (Decoded < *Count)) {
+    UINT32 Character = (((UINT32)Buffer[Index + High] << 8) | Buffer[Index + Low]);
+    if ((Character >= 0xD800) && (Character < 0xDC00)) {
+      // High surrogate
+      UINT32 Surrogate;
+      if ((Index + 3) >= Size) {
+        // Incomplete surrogate pair at the end of the buffer
+        break;
+      }
+      Surrogate = (((UINT32)Buffer[Index + 2 + High] << 8) | Buffer[Index + 2 + Low]);
+      if ((Surrogate < 0xDC00) || (Surrogate >= 0xE000)) {
+        // Invalid surrogate pair
+        Index += 2;
+        continue;
+      }
+      Character = ((((Character & 0x3FF) << 10) | (Surrogate & 0x3FF)) + 0x10000);
+      Index += 4;
+    } else if ((Character >= 0xDC00) && (Character < 0xE000)) {
+      // Invalid low surrogate
+      Index += 2;
+      continue;
+    } else {
+      Index += 2;
+    }
+    Characters[Decoded++] = Character;
+  }
+  *Used = Index;
+  *Count = Decoded;
+}
+// DecodeUtf16LE
+/// Decode UTF-16 little endian characters
+/// @param Size       The size, in bytes, of the encoded buffer
+/// @param Buffer     The encoded buffer
+/// @param Used       On output, the size, in bytes, of the buffer that was used, any remaining bytes are an incomplete character sequence
+/// @param Count      On input, the maximum count of characters to decode, on output, the count of characters decoded
+/// @param Characters On output, the decoded characters
+STATIC VOID
+EFIAPI
+DecodeUtf16LE (
+  IN     UINTN   Size,
+  IN     UINT8  *Buffer,
+  OUT    UINTN  *Used,
+  IN OUT UINTN  *Count,
+  OUT    UINT32 *Characters
+) {
+  DecodeUtf16(Size, Buffer, Used, Count, Characters, FALSE);
+}
+// DecodeUtf16BE
+/// Decode UTF-16 big endian characters
+/// @param Size       The size, in bytes, of the encoded buffer
+/// @param Buffer     The encoded buffer
+/// @param Used       On output, the size, in bytes, of the buffer that was used, any remaining bytes are an incomplete character sequence
+/// @param Count      On input, the maximum count of characters to decode, on output, the count of characters decoded
+/// @param Characters On output, the decoded characters
+STATIC VOID
+EFIAPI
+DecodeUtf16BE (
+  IN     UINTN   Size,
+  IN     UINT8  *Buffer,
+  OUT    UINTN  *Used,
+  IN OUT UINTN  *Count,
+  OUT    UINT32 *Characters
+) {
+  DecodeUtf16(Size, Buffer, Used, Count, Characters, TRUE);
+}
+// DecodeLatin1
+/// Decode ISO-8859-1 characters
+/// @param Size       The size, in bytes, of the encoded buffer
+/// @param Buffer     The encoded buffer
+/// @param Used       On output, the size, in bytes, of the buffer that was used
+/// @param Count      On input, the maximum count of characters to decode, on output, the count of characters decoded
+/// @param Characters On output, the decoded characters
+STATIC VOID
+EFIAPI
+DecodeLatin1 (
+  IN     UINTN   Size,
+  IN     UINT8  *Buffer,
+  OUT    UINTN  *Used,
+  IN OUT UINTN  *Count,
+  OUT    UINT32 *Characters
+) {
+  UINTN Index;
+  if (Size > *Count) {
+    Size = *Count;
+  }
+  for (Index = 0; Index < Size; ++Index) {
+    Characters[Index] = Buffer[Index];
+  }
+  *Used = Size;
+  *Count = Size;
+}
+// DecodeAscii
+/// Decode ASCII characters
+/// @param Size       The size, in bytes, of the encoded buffer
+/// @param Buffer     The encoded buffer
+/// @param Used       On output, the size, in bytes, of the buffer that was used
+/// @param Count      On input, the maximum count of characters to decode, on output, the count of characters decoded
+/// @param Characters On output, the decoded characters
+STATIC VOID
+EFIAPI
+DecodeAscii (
+  IN     UINTN   Size,
+  IN     UINT8  *Buffer,
+  OUT    UINTN  *Used,
+  IN OUT UINTN  *Count,
+  OUT    UINT32 *Characters
+) {
+  UINTN Index;
+  if (Size > *Count) {
+    Size = *Count;
+  }
+  for (Index = 0; Index < Size; ++Index) {
+    Characters[Index] = (Buffer[Index] & 0x7F);
+  }
+  *Used = Size;
+  *Count = Size;
+}
+
+// LANG_DECODE_BLOCK_COUNT
+/// The count of characters decoded at a time
+#define LANG_DECODE_BLOCK_COUNT 0x40
+
+// mLangDecoders
+/// The built-in character decoders
+STATIC LANG_DECODER mLangDecoders[] = {
+  { NULL, "UTF-8", DecodeUtf8 },
+  { NULL, "UTF-16LE", DecodeUtf16LE },
+  { NULL, "UTF-16BE", DecodeUtf16BE },
+  { NULL, "ISO-8859-1", DecodeLatin1 },
+  { NULL, "ISO-Latin-1", DecodeLatin1 },
+  { NULL, "Latin-1", DecodeLatin1 },
+  { NULL, "US-ASCII", DecodeAscii },
+  { NULL, "ASCII", DecodeAscii },
+};
+// mLangRegisteredDecoders
+/// The registered character decoders
+STATIC LANG_DECODER *mLangRegisteredDecoders = NULL;
+// mLangSharedStates
+/// The parser states compiled from static states
+STATIC LANG_SHARED_STATES *mLangSharedStates = NULL;
+
+// FindDecoder
+/// Find a character decoder by encoding name
+/// @param Encoding The name of the encoding
+/// @return The character decoder or NULL if no decoder was found for the encoding
+STATIC LANG_DECODER *
+EFIAPI
+FindDecoder (
+  IN CHAR8 *Encoding
+) {
+  LANG_DECODER *Decoder;
+  UINTN         Index;
+  // Check parameters
+  if (Encoding == NULL) {
+    return NULL;
+  }
+  // UTF-16 without byte order is the same as the CPU
+  if (AsciiStriCmp(Encoding, "UTF-16") == 0) {
+    Encoding = (IsCPUBigEndian() ? "UTF-16BE" : "UTF-16LE");
+  }
+  // Registered decoders override built-in decoders
+  for (Decoder = mLangRegisteredDecoders; Decoder != NULL; Decoder = Decoder->Next) {
+    if (AsciiStriCmp(Decoder->Encoding, Encoding) == 0) {
+      return Decoder;
+    }
+  }
+  for (Index = 0; Index < ARRAY_SIZE(mLangDecoders); ++Index) {
+    if (AsciiStriCmp(mLangDecoders[Index].Encoding, Encoding) == 0) {
+      return mLangDecoders + Index;
+    }
+  }
+  return NULL;
+}
+
 // ParseMessage
 /// Add a parser message
 /// @param Parser      The language parser to which to add a message
@@ -169,35 +538,188 @@ ParseVMessage (
   IN     VA_LIST      Args
 ) {
   LANG_MESSAGE *Message;
+  CHAR16       *Text;
   // Check parameters
   if ((Parser == NULL) || (MessageDesc == NULL) || (*MessageDesc == L'\0')) {
     return EFI_INVALID_PARAMETER;
   }
-  // Allocate a new message
-  Message = (LANG_MESSAGE *)AllocateZeroPool(sizeof(LANG_MESSAGE));
-  if (Message == NULL) {
+  // Allocate the message ring
+  if (Parser->Messages == NULL) {
+    Parser->Messages = (LANG_MESSAGE *)AllocateZeroPool(LANG_MESSAGE_MAX_COUNT * sizeof(LANG_MESSAGE));
+    if (Parser->Messages == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+  // Print the message
+  Text = CatVSPrint(NULL, MessageDesc, Args);
+  if (Text == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
+  // Add the message to the ring, replacing the oldest message if the ring is full
+  if (Parser->MessageCount < LANG_MESSAGE_MAX_COUNT) {
+    Message = Parser->Messages + ((Parser->MessageFirst + Parser->MessageCount) % LANG_MESSAGE_MAX_COUNT);
+    ++(Parser->MessageCount);
+  } else {
+    Message = Parser->Messages + Parser->MessageFirst;
+    Parser->MessageFirst = (Parser->MessageFirst + 1) % LANG_MESSAGE_MAX_COUNT;
+    ++(Parser->MessageDropped);
+    FreePool(Message->Message);
+  }
   // Set message
-  Message->Next = NULL;
   Message->Flags = Flags;
-  Message->Message = CatVSPrint(NULL, MessageDesc, Args);
-  if (Message->Message == NULL) {
-    FreePool(Message);
-    return EFI_OUT_OF_RESOURCES;
+  CopyMem(&(Message->Position), &(Parser->Position), sizeof(LANG_POSITION));
+  Message->Message = Text;
+  return EFI_SUCCESS;
+}
+// ParseGetMessageCount
+/// Get the count of retained parser messages
+/// @param Parser  The language parser
+/// @param Count   On output, the count of retained messages
+/// @param Dropped On output, the count of messages dropped because too many messages were added
+/// @return Whether the count of messages was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Count is NULL
+/// @retval EFI_SUCCESS           If the count of messages was retrieved successfully
+EFI_STATUS
+EFIAPI
+ParseGetMessageCount (
+  IN  LANG_PARSER *Parser,
+  OUT UINTN       *Count,
+  OUT UINTN       *Dropped OPTIONAL
+) {
+  // Check parameters
+  if ((Parser == NULL) || (Count == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
-  // Add the message
-  if (Parser->Messages == NULL) {
-    Parser->Messages = Message;
-  } else {
-    LANG_MESSAGE *Ptr = Parser->Messages;
-    while (Ptr->Next != NULL) {
-      Ptr = Ptr->Next;
-    }
-    Ptr->Next = Message;
+  *Count = Parser->MessageCount;
+  if (Dropped != NULL) {
+    *Dropped = Parser->MessageDropped;
   }
   return EFI_SUCCESS;
 }
+// ParseGetMessage
+/// Get a retained parser message
+/// @param Parser   The language parser
+/// @param Index    The index of the message, from the oldest retained message
+/// @param Flags    On output, the message flags
+/// @param Position On output, the input position at which the message was added
+/// @param Message  On output, the message, which must not be freed and is valid until the message is dropped or cleared
+/// @return Whether the message was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Message is NULL
+/// @retval EFI_NOT_FOUND         If Index is not less than the count of retained messages
+/// @retval EFI_SUCCESS           If the message was retrieved successfully
+EFI_STATUS
+EFIAPI
+ParseGetMessage (
+  IN  LANG_PARSER    *Parser,
+  IN  UINTN           Index,
+  OUT UINTN          *Flags OPTIONAL,
+  OUT LANG_POSITION  *Position OPTIONAL,
+  OUT CHAR16        **Message
+) {
+  LANG_MESSAGE *Ptr;
+  // Check parameters
+  if ((Parser == NULL) || (Message == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Index >= Parser->MessageCount) {
+    return EFI_NOT_FOUND;
+  }
+  // Get the message from the ring
+  Ptr = Parser->Messages + ((Parser->MessageFirst + Index) % LANG_MESSAGE_MAX_COUNT);
+  if (Flags != NULL) {
+    *Flags = Ptr->Flags;
+  }
+  if (Position != NULL) {
+    CopyMem(Position, &(Ptr->Position), sizeof(LANG_POSITION));
+  }
+  *Message = Ptr->Message;
+  return EFI_SUCCESS;
+}
+// ParseClearMessages
+/// Clear the parser messages
+/// @param Parser The language parser
+/// @return Whether the messages were cleared or not
+/// @retval EFI_INVALID_PARAMETER If Parser is NULL
+/// @retval EFI_SUCCESS           If the messages were cleared successfully
+EFI_STATUS
+EFIAPI
+ParseClearMessages (
+  IN OUT LANG_PARSER *Parser
+) {
+  UINTN Index;
+  // Check parameters
+  if (Parser == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Free the retained messages, the ring is kept for reuse
+  for (Index = 0; Index < Parser->MessageCount; ++Index) {
+    LANG_MESSAGE *Message = Parser->Messages + ((Parser->MessageFirst + Index) % LANG_MESSAGE_MAX_COUNT);
+    FreePool(Message->Message);
+    Message->Message = NULL;
+  }
+  Parser->MessageFirst = 0;
+  Parser->MessageCount = 0;
+  Parser->MessageDropped = 0;
+  return EFI_SUCCESS;
+}
+// ParseGetPosition
+/// Get the input position of the character last parsed
+/// @param Parser   The language parser
+/// @param Position On output, the input position of the character last parsed
+/// @return Whether the position was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Position is NULL
+/// @retval EFI_NOT_FOUND         If no character has been parsed
+/// @retval EFI_SUCCESS           If the position was retrieved successfully
+EFI_STATUS
+EFIAPI
+ParseGetPosition (
+  IN  LANG_PARSER   *Parser,
+  OUT LANG_POSITION *Position
+) {
+  // Check parameters
+  if ((Parser == NULL) || (Position == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Parser->Position.Line == 0) {
+    return EFI_NOT_FOUND;
+  }
+  CopyMem(Position, &(Parser->Position), sizeof(LANG_POSITION));
+  return EFI_SUCCESS;
+}
+
+#if defined(PROJECT_DEBUG)
+
+// ParseLogProfile
+/// Log the token and state transition profile of a language parser
+/// @param Parser The language parser
+/// @param Name   The name of the parsed language
+VOID
+EFIAPI
+ParseLogProfile (
+  IN LANG_PARSER *Parser,
+  IN CHAR16      *Name OPTIONAL
+) {
+  UINTN Characters = 0;
+  UINTN Index;
+  // Check parameters
+  if ((Parser == NULL) || (Parser->Profiles == NULL)) {
+    return;
+  }
+  if (Name == NULL) {
+    Name = L"Parser";
+  }
+  for (Index = 0; Index < Parser->ProfileCount; ++Index) {
+    Characters += Parser->Profiles[Index].Characters;
+  }
+  LOG(L"%s profile: %u characters, %u token reallocations\n", Name, Characters, Parser->Reallocations);
+  for (Index = 0; Index < Parser->ProfileCount; ++Index) {
+    LANG_PROFILE *Profile = Parser->Profiles + Index;
+    LOG(L"  State %u: %u characters, %u checks, %u matches, %u callbacks, %lu ns\n", Profile->Id, Profile->Characters,
+        Profile->Checks, Profile->Matches, Profile->Callbacks, GetTimeInNanoSecond(Profile->Ticks));
+  }
+}
+
+#endif
 
 // ParseError
 /// Add a parser error
@@ -294,9 +816,13 @@ FindParseState (
 ) {
   UINTN Index;
   // Check parameters
-  if (Parser == NULL) {
+  if ((Parser == NULL) || (Parser->States == NULL)) {
     return NULL;
   }
+  // States are usually declared in the order of their identifiers
+  if ((Id < Parser->Count) && (Parser->States[Id] != NULL) && (Parser->States[Id]->Id == Id)) {
+    return Parser->States[Id];
+  }
   for (Index = 0; Index < Parser->Count; ++Index) {
     if (Parser->States[Index] != NULL) {
       // Check if identifier matches
@@ -363,6 +889,44 @@ SetNextParseState (
   // State not found
   return EFI_NOT_FOUND;
 }
+#if defined(PROJECT_DEBUG)
+
+// FindParseProfile
+/// Find or add the profile of a parser state
+/// @param Parser The language parser
+/// @param State  The parser state
+/// @return The parser state profile or NULL if there was an error
+STATIC LANG_PROFILE *
+EFIAPI
+FindParseProfile (
+  IN OUT LANG_PARSER *Parser,
+  IN     LANG_STATE  *State
+) {
+  LANG_PROFILE *Profiles;
+  UINTN         Index;
+  // The current character is usually parsed in the same state as the last
+  if ((Parser->Profile != NULL) && (Parser->Profile->Id == State->Id)) {
+    return Parser->Profile;
+  }
+  for (Index = 0; Index < Parser->ProfileCount; ++Index) {
+    if (Parser->Profiles[Index].Id == State->Id) {
+      return Parser->Profiles + Index;
+    }
+  }
+  // Add a profile for a state entered for the first time
+  Profiles = (LANG_PROFILE *)ReallocatePool(Parser->ProfileCount * sizeof(LANG_PROFILE), (Parser->ProfileCount + 1) * sizeof(LANG_PROFILE), Parser->Profiles);
+  if (Profiles == NULL) {
+    return NULL;
+  }
+  Parser->Profiles = Profiles;
+  Profiles += Parser->ProfileCount++;
+  ZeroMem(Profiles, sizeof(LANG_PROFILE));
+  Profiles->Id = State->Id;
+  return Profiles;
+}
+
+#endif
+
 // ParseCheckRules
 /// Check whether a rule matching is satisfied
 /// @param Parser  The language parser used for parsing
@@ -389,48 +953,60 @@ ParseCheckRules (
   UINTN      MatchIndex = (UINTN)-1;
   UINTN      MatchOffset = (UINTN)-1;
   UINTN      MatchLength = 0;
-  // The token comparison function
-  CHAR16 *(EFIAPI *Search) (CHAR16 *, CHAR16 *);
-  INTN (EFIAPI *Compare)(CHAR16 *, CHAR16 *, UINTN);
+  UINTN      MaxLength = 0;
+  UINTN      Window;
+  BOOLEAN    Insensitive;
   // Check parameters
   if ((Parser == NULL) || (Rules == NULL) || (Count == 0) ||
-      (Parser->Token == NULL) || (Parser->TokenCount == 0)) {
+      (Parser->Token.Buffer == NULL) || (Parser->Token.Count == 0)) {
     return EFI_INVALID_PARAMETER;
   }
+#if defined(PROJECT_DEBUG)
+
+  if (Parser->Profile != NULL) {
+    Parser->Profile->Checks += Count;
+  }
+
+#endif
+
+  // A match is deferred while the whole parser token is the start of a longer token string, so it may end before
+  //  the last character but never starts before the longest token string and the last character
+  for (RuleIndex = 0; RuleIndex < Count; ++RuleIndex) {
+    if ((Rules[RuleIndex] != NULL) && (Rules[RuleIndex]->MaxLength > MaxLength)) {
+      MaxLength = Rules[RuleIndex]->MaxLength;
+    }
+  }
+  Window = (Parser->Token.Count > (MaxLength + 1)) ? (Parser->Token.Count - (MaxLength + 1)) : 0;
   // Iterate through all the rules
   for (RuleIndex = 0; RuleIndex < Count; ++RuleIndex) {
     Rule = Rules[RuleIndex];
     if (Rule == NULL) {
       continue;
     }
-    // Set the comparison function
-    if ((Rule->Options & LANG_RULE_INSENSITIVE) != 0) {
-      Search = StriStr;
-      Compare = StrniCmp;
-    } else {
-      Search = StrStr;
-      Compare = StrnCmp;
-    }
+    // Check if the rule compares tokens case-insensitively
+    Insensitive = ((Rule->Options & LANG_RULE_INSENSITIVE) != 0);
     // Check if the token matches
     for (Index = 0; Index < Rule->Count; ++Index) {
       CHAR16 *Ptr;
       UINTN   Offset;
       UINTN   Length = StrLen(Rule->Tokens[Index]);
-      // Try to find a match of this token somewhere in the parser token
-      Ptr = Search(Parser->Token, Rule->Tokens[Index]);
+      // Any other match was already satisfied, so only search the end of the parser token, otherwise long tokens are
+      //  searched again for every character
+      Ptr = Insensitive ? StriStr(Parser->Token.Buffer + Window, Rule->Tokens[Index]) : StrStr(Parser->Token.Buffer + Window, Rule->Tokens[Index]);
       if (Ptr == NULL) {
         // Check if the rule allows tokens before match
-        if ((Compare(Parser->Token, Rule->Tokens[Index], Parser->TokenCount) == 0) ||
-            (((Rule->Options & LANG_RULE_TOKEN) != 0) && (MatchOffset > Parser->TokenCount))) {
+        if (((Insensitive ? StrniCmp(Parser->Token.Buffer, Rule->Tokens[Index], Parser->Token.Count) :
+                            StrnCmp(Parser->Token.Buffer, Rule->Tokens[Index], Parser->Token.Count)) == 0) ||
+            (((Rule->Options & LANG_RULE_TOKEN) != 0) && (MatchOffset > Parser->Token.Count))) {
           // Assume this is a valid token in the future
           MatchRule = RuleIndex;
           MatchIndex = Index;
           MatchLength = 0;
-          MatchOffset = Parser->TokenCount;
+          MatchOffset = Parser->Token.Count;
         }
       } else {
         // Found a match
-        Offset = (UINTN)(Ptr - Parser->Token);
+        Offset = (UINTN)(Ptr - Parser->Token.Buffer);
         if ((MatchOffset > Offset) || ((MatchOffset == Offset) && (Length > MatchLength))) {
           MatchRule = RuleIndex;
           MatchIndex = Index;
@@ -445,13 +1021,21 @@ ParseCheckRules (
     Rule = Rules[MatchRule];
     // Check if token was matched
     if ((Rule != NULL) && (MatchIndex < Rule->Count)) {
-      CHAR16        *Match;
-      CHAR16        *Token;
+      STR_SMALL      Match = { 0, 0, NULL, { 0 } };
+      STR_SMALL      Token = { 0, 0, NULL, { 0 } };
       LANG_CALLBACK  Callback;
       // Check if this is a token before a match
-      if ((MatchLength == 0) || ((MatchOffset + MatchLength) >= Parser->TokenCount)) {
+      if ((MatchLength == 0) || ((MatchOffset + MatchLength) >= Parser->Token.Count)) {
         return EFI_SUCCESS;
       }
+#if defined(PROJECT_DEBUG)
+
+      if (Parser->Profile != NULL) {
+        ++(Parser->Profile->Matches);
+      }
+
+#endif
+
       // Check if this is a previous state pop
       if ((Rule->Options & LANG_RULE_POP) != 0) {
         // Set previous parser state
@@ -471,51 +1055,62 @@ ParseCheckRules (
       if (Callback == NULL) {
         return EFI_NOT_READY;
       }
-      // Get the current token from the parser token
-      Token = StrnDup(Parser->Token, MatchOffset);
-      if ((MatchOffset != 0) && (Token == NULL)) {
-        return EFI_OUT_OF_RESOURCES;
-      }
-      // Get the mismatch token from the parser state
-      Match = StrnDup(Parser->Token + MatchOffset, MatchLength);
-      if (Match == NULL) {
-        FreePool(Token);
+      // Get the current token and the mismatch token from the parser token, most tokens fit in the inline buffers
+      if (EFI_ERROR(StrSmallSet(&Token, Parser->Token.Buffer, MatchOffset)) ||
+          EFI_ERROR(StrSmallSet(&Match, Parser->Token.Buffer + MatchOffset, MatchLength))) {
+        StrSmallFree(&Token);
         return EFI_OUT_OF_RESOURCES;
       }
       // Change parser token to the part that belongs to the next token
-      Parser->TokenCount -= (MatchOffset + MatchLength);
-      CopyMem(Parser->Token, Parser->Token + (MatchOffset + MatchLength), Parser->TokenCount);
-      ZeroMem(Parser->Token + Parser->TokenCount, MatchOffset + MatchLength);
+      StrBuilderRemove(&(Parser->Token), MatchOffset + MatchLength);
       // Callback for token
       if ((MatchOffset != 0) && ((Rule->Options & LANG_RULE_SKIP_TOKEN) == 0)) {
-        Status = Callback(Parser, Parser->State->Id, Token, Context);
+
+#if defined(PROJECT_DEBUG)
+
+        if (Parser->Profile != NULL) {
+          ++(Parser->Profile->Callbacks);
+        }
+
+#endif
+
+        Status = Callback(Parser, Parser->State->Id, STR_SMALL_BUFFER(&Token), Context);
         if (EFI_ERROR(Status)) {
           if (Status == EFI_NOT_READY) {
-            ParseError(Parser, L"Unexpected termination \"%s\"", Parser, Token);
+            ParseError(Parser, L"Unexpected termination \"%s\"", STR_SMALL_BUFFER(&Token));
           } else if (Status == EFI_NOT_FOUND) {
-            ParseError(Parser, L"Unexpected token \"%s\"", Parser, Token);
+            ParseError(Parser, L"Unexpected token \"%s\"", STR_SMALL_BUFFER(&Token));
           }
-          FreePool(Token);
-          FreePool(Match);
+          StrSmallFree(&Token);
+          StrSmallFree(&Match);
           return Status;
         }
       }
-      FreePool(Token);
+      StrSmallFree(&Token);
       // Callback for match
       if (((Rule->Options & LANG_RULE_SKIP) == 0) &&
           (((Rule->Options & LANG_RULE_SKIP_EMPTY) == 0) || (MatchOffset > 0))) {
-        Status = Callback(Parser, Parser->State->Id, Match, Context);
+
+#if defined(PROJECT_DEBUG)
+
+        if (Parser->Profile != NULL) {
+          ++(Parser->Profile->Callbacks);
+        }
+
+#endif
+
+        Status = Callback(Parser, Parser->State->Id, STR_SMALL_BUFFER(&Match), Context);
         if (EFI_ERROR(Status)) {
           if (Status == EFI_NOT_READY) {
-            ParseError(Parser, L"Unexpected termination \"%s\"", Match);
+            ParseError(Parser, L"Unexpected termination \"%s\"", STR_SMALL_BUFFER(&Match));
           } else if (Status == EFI_NOT_FOUND) {
-            ParseError(Parser, L"Unexpected token \"%s\"", Match);
+            ParseError(Parser, L"Unexpected token \"%s\"", STR_SMALL_BUFFER(&Match));
           }
-          FreePool(Match);
+          StrSmallFree(&Match);
           return Status;
         }
       }
-      FreePool(Match);
+      StrSmallFree(&Match);
       // Check if this is a previous state pop
       if (((Rule->Options & LANG_RULE_POP) != 0) && (Rule->NextState == LANG_STATE_PREVIOUS)) {
         // The state change already happened
@@ -545,7 +1140,16 @@ ParseCharacter (
   IN     UINT32       Character,
   IN     VOID        *Context OPTIONAL
 ) {
-  EFI_STATUS Status;
+  EFI_STATUS    Status;
+
+#if defined(PROJECT_DEBUG)
+
+  LANG_PROFILE *Profile;
+  UINT64        Start = GetPerformanceCounter();
+  UINTN         TokenSize;
+
+#endif
+
   // Check parameters
   if (Parser == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -559,21 +1163,61 @@ ParseCharacter (
     ParseError(Parser, L"Invalid parser state");
     return EFI_NOT_FOUND;
   }
+  // Track the input position of the character
+  CopyMem(&(Parser->Position), &(Parser->NextPosition), sizeof(LANG_POSITION));
+  ++(Parser->NextPosition.Offset);
+  if (Character == L'\n') {
+    ++(Parser->NextPosition.Line);
+    Parser->NextPosition.Column = 1;
+  } else {
+    ++(Parser->NextPosition.Column);
+  }
+
+#if defined(PROJECT_DEBUG)
+
+  // Profile the character in the state in which it is parsed
+  TokenSize = Parser->Token.Size;
+  Profile = Parser->Profile = FindParseProfile(Parser, Parser->State);
+  if (Profile != NULL) {
+    ++(Profile->Characters);
+  }
+
+#endif
+
   // Append the character to the token
-  Status = StrAppend(&(Parser->Token), &(Parser->TokenCount), &(Parser->TokenSize), Character);
+  Status = StrBuilderAppendCharacter(&(Parser->Token), Character);
   if (EFI_ERROR(Status)) {
     return Status;
   }
-  if ((Parser->Token == NULL) || (Parser->TokenCount == 0)) {
+  if ((Parser->Token.Buffer == NULL) || (Parser->Token.Count == 0)) {
     ParseError(Parser, L"Invalid token");
     return EFI_INVALID_PARAMETER;
   }
+
+#if defined(PROJECT_DEBUG)
+
+  if (Parser->Token.Size != TokenSize) {
+    ++(Parser->Reallocations);
+  }
+
+#endif
+
   // Check each rule
-  return ParseCheckRules(Parser, Parser->State->Count, Parser->State->Rules, Context);
+  Status = ParseCheckRules(Parser, Parser->State->Count, Parser->State->Rules, Context);
+
+#if defined(PROJECT_DEBUG)
+
+  if (Profile != NULL) {
+    Profile->Ticks += (GetPerformanceCounter() - Start);
+  }
+
+#endif
+
+  return Status;
 }
 
 // DecodeSurrogates
-/// Decode surrogate pair
+/// Decode surrogate pair, the high surrogate is retained in the parser so a pair may be split across buffers
 /// @param Parser    The language parser
 /// @param Character On input, the initial character point, On output, the decoded code point
 /// @retval TRUE  If the character was invalid or used as a first surrogate in a pair
@@ -586,27 +1230,19 @@ DecodeSurrogates (
 ) {
   if ((*Character >= 0xD800) && (*Character < 0xDC00)) {
     // High surrogate
-    Parser->DecodedCharacter = (*Character & 0x3FF);
-    Parser->DecodeCount = 1;
+    Parser->Surrogate = *Character;
     return TRUE;
   } else if ((*Character >= 0xDC00) && (*Character < 0xE000)) {
     // Low surrogate
-    if (Parser->DecodeCount != 1) {
-      Parser->DecodedCharacter = 0;
-      Parser->DecodeCount = 0;
+    if (Parser->Surrogate == 0) {
+      // Invalid surrogate pair
       return TRUE;
     }
     // Decode charcter
-    Parser->DecodeCount = 0;
-    Parser->DecodedCharacter <<= 10;
-    Parser->DecodedCharacter |= (*Character & 0x3FF);
-    *Character = (Parser->DecodedCharacter + 0x100000);
-    Parser->DecodedCharacter = 0;
-  } else {
-    // Reset decoding
-    Parser->DecodedCharacter = 0;
-    Parser->DecodeCount = 0;
+    *Character = ((((Parser->Surrogate & 0x3FF) << 10) | (*Character & 0x3FF)) + 0x10000);
   }
+  // Reset decoding
+  Parser->Surrogate = 0;
   return FALSE;
 }
 // Parse
@@ -646,7 +1282,7 @@ Parse (
     // Iterate through buffer
     while ((*String != '\0') && (Count-- > 0)) {
       // Parse each character and swap byte order
-      UINT32 Character = (UINT32)(((*String >> 8) & 0x0F) | ((*String << 8) & 0xF0));
+      UINT32 Character = (UINT32)(((*String >> 8) & 0x00FF) | ((*String << 8) & 0xFF00));
       ++String;
       if (DecodeSurrogates(Parser, &Character)) {
         continue;
@@ -674,8 +1310,129 @@ Parse (
   }
   return Status;
 }
-// ParseUtf8
-/// Parse a UTF-8 string for tokens
+// ParseDecodeBlock
+/// Decode characters from a buffer and parse them, switching decoders if the encoding is changed while parsing
+/// @param Parser  The language parser to use in parsing
+/// @param Size    The size, in bytes, of the buffer
+/// @param Buffer  The buffer to decode
+/// @param Used    On output, the size, in bytes, of the buffer that was used, any remaining bytes are an incomplete character sequence
+/// @param Context The parse context
+/// @return Whether the buffer was parsed or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_UNSUPPORTED      If there is no character decoder
+/// @retval EFI_SUCCESS          If the buffer was parsed successfully
+STATIC EFI_STATUS
+EFIAPI
+ParseDecodeBlock (
+  IN OUT LANG_PARSER *Parser,
+  IN     UINTN        Size,
+  IN     UINT8       *Buffer,
+  OUT    UINTN       *Used,
+  IN     VOID        *Context OPTIONAL
+) {
+  EFI_STATUS Status;
+  UINT32     Characters[LANG_DECODE_BLOCK_COUNT];
+  *Used = 0;
+  while (*Used < Size) {
+    LANG_DECODER *Decoder = Parser->Decoder;
+    UINTN         Count = LANG_DECODE_BLOCK_COUNT;
+    UINTN         BlockUsed = 0;
+    UINTN         Index;
+    if (Decoder == NULL) {
+      return EFI_UNSUPPORTED;
+    }
+    // Decode a block of characters
+    Decoder->Decode(Size - *Used, Buffer + *Used, &BlockUsed, &Count, Characters);
+    if (BlockUsed == 0) {
+      // Incomplete character sequence
+      break;
+    }
+    // Parse each decoded character
+    for (Index = 0; Index < Count; ++Index) {
+      if (Characters[Index] == 0) {
+        continue;
+      }
+      Status = ParseCharacter(Parser, Characters[Index], Context);
+      if (EFI_ERROR(Status)) {
+        return Status;
+      }
+      // Check if the encoding was changed while parsing this block
+      if ((Parser->Decoder != Decoder) && ((Index + 1) < Count)) {
+        // Only use the part of the block that was already parsed, the rest is decoded again
+        Count = Index + 1;
+        Decoder->Decode(Size - *Used, Buffer + *Used, &BlockUsed, &Count, Characters);
+        break;
+      }
+    }
+    *Used += BlockUsed;
+  }
+  return EFI_SUCCESS;
+}
+// ParseDecode
+/// Decode characters from a buffer and parse them, retaining any incomplete character sequence for the next buffer
+/// @param Parser  The language parser to use in parsing
+/// @param Size    The size, in bytes, of the buffer
+/// @param Buffer  The buffer to decode
+/// @param Context The parse context
+/// @return Whether the buffer was parsed or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_UNSUPPORTED      If there is no character decoder
+/// @retval EFI_SUCCESS          If the buffer was parsed successfully
+STATIC EFI_STATUS
+EFIAPI
+ParseDecode (
+  IN OUT LANG_PARSER *Parser,
+  IN     UINTN        Size,
+  IN     UINT8       *Buffer,
+  IN     VOID        *Context OPTIONAL
+) {
+  EFI_STATUS Status;
+  UINTN      Used;
+  // Complete a character sequence split from the previous buffer
+  while ((Parser->PendingSize != 0) && (Size != 0)) {
+    UINTN Previous = Parser->PendingSize;
+    UINTN Append = MIN(Size, LANG_DECODE_MAX_SEQUENCE - Previous);
+    CopyMem(Parser->Pending + Previous, Buffer, Append);
+    Used = 0;
+    Status = ParseDecodeBlock(Parser, Previous + Append, Parser->Pending, &Used, Context);
+    if (EFI_ERROR(Status)) {
+      Parser->PendingSize = 0;
+      return Status;
+    }
+    if (Used >= Previous) {
+      // The character sequence was completed
+      Parser->PendingSize = 0;
+      Buffer += (Used - Previous);
+      Size -= (Used - Previous);
+    } else if ((Used == 0) && (Append == Size) && ((Previous + Append) < LANG_DECODE_MAX_SEQUENCE)) {
+      // The whole buffer is part of the incomplete character sequence
+      Parser->PendingSize = Previous + Append;
+      return EFI_SUCCESS;
+    } else {
+      // Discard the used bytes or the invalid leading byte
+      if (Used == 0) {
+        Used = 1;
+      }
+      Parser->PendingSize = Previous - Used;
+      CopyMem(Parser->Pending, Parser->Pending + Used, Parser->PendingSize);
+    }
+  }
+  if (Size == 0) {
+    return EFI_SUCCESS;
+  }
+  // Decode the buffer
+  Used = 0;
+  Status = ParseDecodeBlock(Parser, Size, Buffer, &Used, Context);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Retain any incomplete character sequence
+  Parser->PendingSize = MIN(Size - Used, LANG_DECODE_MAX_SEQUENCE);
+  CopyMem(Parser->Pending, Buffer + (Size - Parser->PendingSize), Parser->PendingSize);
+  return EFI_SUCCESS;
+}
+// ParseEncoding
+/// Parse an encoded string for tokens
 /// @param Parser   The language parser to use in parsing
 /// @param Count    The count of characters in the string or NULL if the string is null-terminated
 /// @param String   The string to parse
@@ -695,7 +1452,6 @@ ParseEncoding (
   IN     CHAR8       *Encoding OPTIONAL,
   IN     VOID        *Context OPTIONAL
 ) {
-  EFI_STATUS Status = EFI_SUCCESS;
   // Check parameters
   if ((Parser == NULL) || (String == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -707,93 +1463,20 @@ ParseEncoding (
   if (Count == 0) {
     return EFI_SUCCESS;
   }
-  // Decode character from buffer
-  if ((Encoding == NULL) || (AsciiStriCmp(Encoding, "UTF-8") == 0)) {
-    // UTF-8
-    while ((*String != '\0') && (Count-- > 0)) {
-      // Iterate through buffer
-      UINT32 Character = (UINT32)*String++;
-      if ((Character & 0x80) == 0) {
-        // ASCII character
-        Parser->DecodedCharacter = 0;
-        Parser->DecodeCount = 0;
-      } else if ((Character & 0x40) != 0) {
-        // Trailing character
-        if (Parser->DecodeCount == 0) {
-          // Invalid character sequence
-          Parser->DecodedCharacter = 0;
-          continue;
-        }
-        // Decode character part
-        Parser->DecodedCharacter <<= 6;
-        Parser->DecodedCharacter |= (Character & 0x3F);
-        // If there are still characters left then decode them
-        if (--(Parser->DecodeCount) > 0) {
-          continue;
-        }
-        // Character decoded so parse it
-        Character = Parser->DecodedCharacter;
-        Parser->DecodedCharacter = 0;
-      } else {
-        CHAR16 Counter = 0x20;
-        // Header character
-        Parser->DecodeCount = 1;
-        while ((Counter != 0) && ((Character & Counter) != 0)) {
-          ++(Parser->DecodeCount);
-          Counter >>= 1;
-        }
-        if (Parser->DecodeCount > 6) {
-          // Invalid character sequence
-          Parser->DecodedCharacter = 0;
-          Parser->DecodeCount = 0;
-          continue;
-        }
-        // Decode initial character sequence
-        Parser->DecodedCharacter = (Character & (--Counter));
-        continue;
-      }
-      // Parse each character
-      Status = ParseCharacter(Parser, Character, Context);
-      if (EFI_ERROR(Status)) {
-        break;
-      }
-    }
-  } else if ((AsciiStriCmp(Encoding, "ISO-8859-1") == 0) ||
-             (AsciiStriCmp(Encoding, "ISO-Latin-1") == 0)) {
-    // Latin-1
-    while ((*String != '\0') && (Count-- > 0)) {
-      // Parse each character
-      Status = ParseCharacter(Parser, (UINT32)*String++, Context);
-      if (EFI_ERROR(Status)) {
-        break;
-      }
-    }
-  } else if (AsciiStriCmp(Encoding, "ASCII") == 0) {
-    // ASCII
-    while ((*String != '\0') && (Count-- > 0)) {
-      // Parse each character
-      Status = ParseCharacter(Parser, (UINT32)(*String++ & 0x7F), Context);
-      if (EFI_ERROR(Status)) {
-        break;
-      }
-    }
-  } else {
-    return EFI_UNSUPPORTED;
-  }
-  return Status;
+  // Parse the encoded string
+  return ParseBuffer(Parser, Count, String, (Encoding == NULL) ? "UTF-8" : Encoding, Context);
 }
 // ParseBuffer
-/// Parse a buffer for tokens
+/// Parse a buffer for tokens, a character sequence split at the end of the buffer is retained to be completed by the next buffer
 /// @param Parser   The language parser to use in parsing
 /// @param Size     The size, in bytes, of the buffer
 /// @param Buffer   The buffer to parse
-/// @param Encoding The encoding of the buffer or NULL to try detecting the encoding
+/// @param Encoding The encoding of the buffer or NULL to use the current parser encoding, which is detected if not yet set
 /// @param Context  The parse context
 /// @return Whether the buffer was parsed or not
 /// @retval EFI_INVALID_PARAMETER If Parser or Buffer is NULL or Size is zero
 /// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
-/// @retval EFI_BAD_BUFFER_SIZE   If the buffer size is not a multiple of the encoding character size
-/// @retval EFI_UNSUPPORTED       If the encoding of the buffer could not be determined
+/// @retval EFI_UNSUPPORTED       If the encoding of the buffer is unsupported
 /// @retval EFI_SUCCESS           If the buffer was parsed successfully
 EFI_STATUS
 EFIAPI
@@ -804,73 +1487,237 @@ ParseBuffer (
   IN     CHAR8       *Encoding OPTIONAL,
   IN     VOID        *Context OPTIONAL
 ) {
-  BOOLEAN SwapBytes = FALSE;
+  EFI_STATUS Status;
   // Check parameters
-  if ((Parse == NULL) || (Buffer == NULL) || (Size == 0)) {
+  if ((Parser == NULL) || (Buffer == NULL) || (Size == 0)) {
     return EFI_INVALID_PARAMETER;
   }
-  // Check for encoding
   if (Encoding != NULL) {
-    // Check for UTF-16 encoding
-    if (AsciiStrniCmp(Encoding, "UTF-16", 6) == 0) {
-      // Check to make sure buffer size is good
-      if ((Size % sizeof(CHAR16)) != 0) {
-        return EFI_BAD_BUFFER_SIZE;
-      }
-      // Check if bytes need swapped
-      if (AsciiStrCmp(Encoding + 6, "LE") == 0) {
-        // Little endian
-        SwapBytes = IsCPUBigEndian();
-      } else if (AsciiStrCmp(Encoding + 6, "BE") == 0) {
-        // Big endian
-        SwapBytes = IsCPULittleEndian();
-      } else {
-        // NOTE: Maybe check if encoding endianness matches system here?
-        return EFI_UNSUPPORTED;
-      }
-      // Parse UTF-16 string
-      return Parse(Parser, Size / sizeof(CHAR16), (CHAR16 *)Buffer, SwapBytes, Context);
+    // Set the encoding
+    Status = ParseSetEncoding(Parser, Encoding);
+    if (EFI_ERROR(Status)) {
+      return Status;
     }
-    // Check to make sure buffer size is good
-    if ((Size % sizeof(CHAR8)) != 0) {
-      return EFI_BAD_BUFFER_SIZE;
+  } else if (Parser->Decoder == NULL) {
+    UINTN BomSize = 0;
+    // Try to detect the encoding
+    ParseDetectEncoding(Size, Buffer, &Encoding, &BomSize);
+    Status = ParseSetEncoding(Parser, Encoding);
+    if (EFI_ERROR(Status)) {
+      return Status;
     }
-    // Parse encoded string
-    return ParseEncoding(Parser, Size / sizeof(CHAR8), (CHAR8 *)Buffer, Encoding, Context);
-  }
-  // Try to determine UTF-16 from byte order mark
-  switch (*((CHAR16 *)Buffer)) {
-    case 0xFFEF:
-      // Parse UTF-16 string with byte order swapped
-      SwapBytes = TRUE;
-
-    case 0xFEFF:
-      // Check to make sure buffer size is good
-      if ((Size % sizeof(CHAR16)) != 0) {
-        return EFI_BAD_BUFFER_SIZE;
-      }
-      // Parse UTF-16 string
-      return Parse(Parser, Size / sizeof(CHAR16), (CHAR16 *)Buffer, SwapBytes, Context);
+    // Skip the byte order mark
+    Buffer = (VOID *)(((UINT8 *)Buffer) + BomSize);
+    Size -= BomSize;
+  }
+  // Decode and parse the buffer
+  return ParseDecode(Parser, Size, (UINT8 *)Buffer, Context);
+}
+// ParseFinish
+/// Finish parsing, discarding any character sequence or surrogate pair left incomplete by the last buffer
+/// @param Parser The language parser used in parsing
+/// @return Whether the parser finished with complete character sequences or not
+/// @retval EFI_INVALID_PARAMETER If Parser is NULL
+/// @retval EFI_END_OF_FILE       If an incomplete character sequence was discarded
+/// @retval EFI_SUCCESS           If the parser finished successfully
+EFI_STATUS
+EFIAPI
+ParseFinish (
+  IN OUT LANG_PARSER *Parser
+) {
+  BOOLEAN Incomplete;
+  // Check parameters
+  if (Parser == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Check for incomplete character sequence
+  Incomplete = ((Parser->PendingSize != 0) || (Parser->Surrogate != 0));
+  // Reset decoding
+  Parser->PendingSize = 0;
+  Parser->Surrogate = 0;
+  if (Incomplete) {
+    ParseWarn(Parser, L"Incomplete character sequence at end of input");
+    return EFI_END_OF_FILE;
+  }
+  return EFI_SUCCESS;
+}
 
-    default:
-      break;
+// ParseRegisterDecoder
+/// Register a character decoder for an encoding
+/// @param Encoding The name of the encoding
+/// @param Decode   The character decoder
+/// @return Whether the character decoder was registered or not
+/// @retval EFI_INVALID_PARAMETER If Encoding or Decode is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the character decoder was registered successfully
+EFI_STATUS
+EFIAPI
+ParseRegisterDecoder (
+  IN CHAR8       *Encoding,
+  IN LANG_DECODE  Decode
+) {
+  LANG_DECODER *Decoder;
+  // Check parameters
+  if ((Encoding == NULL) || (*Encoding == '\0') || (Decode == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
-  // Try to determine UTF-8 from byte order mark
-  if (Size >= (sizeof(CHAR8) * 3)) {
-    CHAR8 *Ptr = (CHAR8 *)Buffer;
-    if ((*Ptr++ == 0xEF) && (*Ptr++ == 0xBB) && (*Ptr++ == 0xBF)) {
-      // Check to make sure buffer size is good
-      if ((Size % sizeof(CHAR8)) != 0) {
-        return EFI_BAD_BUFFER_SIZE;
-      }
-      // Parse encoded string
-      return ParseEncoding(Parser, Size / sizeof(CHAR8), (CHAR8 *)Buffer, "UTF-8", Context);
+  // Allocate the character decoder
+  Decoder = (LANG_DECODER *)AllocateZeroPool(sizeof(LANG_DECODER));
+  if (Decoder == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Decoder->Encoding = AsciiStrDup(Encoding);
+  if (Decoder->Encoding == NULL) {
+    FreePool(Decoder);
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Decoder->Decode = Decode;
+  // Add the character decoder to the front so it overrides previous decoders
+  Decoder->Next = mLangRegisteredDecoders;
+  mLangRegisteredDecoders = Decoder;
+  return EFI_SUCCESS;
+}
+// ParseDetectEncoding
+/// Detect the encoding of a buffer from a byte order mark or the leading characters
+/// @param Size     The size, in bytes, of the buffer
+/// @param Buffer   The buffer of which to detect the encoding
+/// @param Encoding On output, the detected encoding, which should not be freed
+/// @param BomSize  On output, the size, in bytes, of the byte order mark
+/// @return Whether the encoding was detected or not
+/// @retval EFI_INVALID_PARAMETER If Buffer or Encoding is NULL or Size is zero
+/// @retval EFI_NOT_FOUND         If the encoding could not be detected and UTF-8 was assumed
+/// @retval EFI_SUCCESS           If the encoding was detected successfully
+EFI_STATUS
+EFIAPI
+ParseDetectEncoding (
+  IN  UINTN   Size,
+  IN  VOID   *Buffer,
+  OUT CHAR8 **Encoding,
+  OUT UINTN  *BomSize OPTIONAL
+) {
+  UINT8 *Bytes = (UINT8 *)Buffer;
+  // Check parameters
+  if ((Buffer == NULL) || (Encoding == NULL) || (Size == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (BomSize != NULL) {
+    *BomSize = 0;
+  }
+  // Try to determine from byte order mark
+  if ((Size >= 3) && (Bytes[0] == 0xEF) && (Bytes[1] == 0xBB) && (Bytes[2] == 0xBF)) {
+    *Encoding = "UTF-8";
+    if (BomSize != NULL) {
+      *BomSize = 3;
     }
+    return EFI_SUCCESS;
+  }
+  if ((Size >= 2) && (Bytes[0] == 0xFF) && (Bytes[1] == 0xFE)) {
+    *Encoding = "UTF-16LE";
+    if (BomSize != NULL) {
+      *BomSize = 2;
+    }
+    return EFI_SUCCESS;
+  }
+  if ((Size >= 2) && (Bytes[0] == 0xFE) && (Bytes[1] == 0xFF)) {
+    *Encoding = "UTF-16BE";
+    if (BomSize != NULL) {
+      *BomSize = 2;
+    }
+    return EFI_SUCCESS;
+  }
+  // Try to determine UTF-16 from a leading ASCII character
+  if ((Size >= 2) && (Bytes[0] != 0) && (Bytes[1] == 0)) {
+    *Encoding = "UTF-16LE";
+    return EFI_SUCCESS;
+  }
+  if ((Size >= 2) && (Bytes[0] == 0) && (Bytes[1] != 0)) {
+    *Encoding = "UTF-16BE";
+    return EFI_SUCCESS;
+  }
+  // Detection failed so assume UTF-8, which includes ASCII
+  *Encoding = "UTF-8";
+  return EFI_NOT_FOUND;
+}
+// ParseSetEncoding
+/// Set the encoding used to decode buffers, which may be changed while parsing
+/// @param Parser   The language parser
+/// @param Encoding The encoding used to decode buffers
+/// @return Whether the encoding was set or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Encoding is NULL
+/// @retval EFI_UNSUPPORTED       If there is no character decoder for the encoding
+/// @retval EFI_SUCCESS           If the encoding was set successfully
+EFI_STATUS
+EFIAPI
+ParseSetEncoding (
+  IN OUT LANG_PARSER *Parser,
+  IN     CHAR8       *Encoding
+) {
+  LANG_DECODER *Decoder;
+  // Check parameters
+  if ((Parser == NULL) || (Encoding == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
-  // NOTE: Detection failed because no byte order mark - assume UTF-8 or Latin-1 here?
-  return ParseEncoding(Parser, Size / sizeof(CHAR8), (CHAR8 *)Buffer, "ASCII", Context);
+  // Check if the encoding is already set
+  if ((Parser->Decoder != NULL) && (AsciiStriCmp(Parser->Decoder->Encoding, Encoding) == 0)) {
+    return EFI_SUCCESS;
+  }
+  // Find the character decoder
+  Decoder = FindDecoder(Encoding);
+  if (Decoder == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+  Parser->Decoder = Decoder;
+  return EFI_SUCCESS;
+}
+// ParseGetEncoding
+/// Get the encoding used to decode buffers
+/// @param Parser   The language parser
+/// @param Encoding On output, the encoding used to decode buffers, which should not be freed
+/// @return Whether the encoding was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Encoding is NULL
+/// @retval EFI_NOT_FOUND         If no encoding has been set
+/// @retval EFI_SUCCESS           If the encoding was retrieved successfully
+EFI_STATUS
+EFIAPI
+ParseGetEncoding (
+  IN  LANG_PARSER  *Parser,
+  OUT CHAR8       **Encoding
+) {
+  // Check parameters
+  if ((Parser == NULL) || (Encoding == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Parser->Decoder == NULL) {
+    return EFI_NOT_FOUND;
+  }
+  *Encoding = Parser->Decoder->Encoding;
+  return EFI_SUCCESS;
 }
 
+// GetParseRuleMaxLength
+/// Get the length of the longest token string of a parser state rule
+/// @param Count  The count of token strings
+/// @param Tokens The token strings
+/// @return The length of the longest token string
+STATIC UINTN
+EFIAPI
+GetParseRuleMaxLength (
+  IN UINTN    Count,
+  IN CHAR16 **Tokens
+) {
+  UINTN MaxLength = 0;
+  UINTN Length;
+  UINTN Index;
+  for (Index = 0; Index < Count; ++Index) {
+    if (Tokens[Index] != NULL) {
+      Length = StrLen(Tokens[Index]);
+      if (Length > MaxLength) {
+        MaxLength = Length;
+      }
+    }
+  }
+  return MaxLength;
+}
 // DuplicateParseRule
 /// Duplicate parser state rule
 /// @param The parser state rule to duplicate
@@ -894,6 +1741,7 @@ DuplicateParseRule (
     Duplicate->NextState = Rule->NextState;
     Duplicate->Tokens = NULL;
     StrListDup(&(Duplicate->Tokens), Duplicate->Count = Rule->Count, Rule->Tokens);
+    Duplicate->MaxLength = Rule->MaxLength;
   }
   return Duplicate;
 }
@@ -968,6 +1816,7 @@ CreateParseRule (
     FreeParseRule(Ptr);
     return Status;
   }
+  Ptr->MaxLength = GetParseRuleMaxLength(Count, Tokens);
   // Return state rule
   *Rule = Ptr;
   return EFI_SUCCESS;
@@ -1116,7 +1965,7 @@ CreateParseState (
 /// @param Count        The count of parser states
 /// @param StaticStates The static parser states
 /// @return Whether the parser states were created or not
-/// @retval EFI_INVALID_PARAMETER If States or StaticStates is NULL or *States is not NULL or Count is zero
+/// @retval EFI_INVALID_PARAMETER If States or StaticStates is NULL or *States is not NULL or Count is zero or a static state is invalid
 /// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the states
 /// @retval EFI_SUCCESS           If the parser states were created successfully
 EFI_STATUS
@@ -1130,7 +1979,7 @@ CreateParseStates (
   LANG_STATE **Ptr;
   UINTN        Index;
   // Check parameters
-  if ((States == NULL) || (StaticStates == NULL) || (Count == 0)) {
+  if ((States == NULL) || (*States != NULL) || (StaticStates == NULL) || (Count == 0)) {
     return EFI_INVALID_PARAMETER;
   }
   // Allocate parser states array
@@ -1140,28 +1989,38 @@ CreateParseStates (
   }
   // Create parser states
   for (Index = 0; Index < Count; ++Index) {
-    LANG_RULE **Rules;
+    LANG_STATE *State;
     UINTN       RuleIndex;
+    if ((StaticStates[Index].Count == 0) || (StaticStates[Index].Count > LANG_RULE_MAX_COUNT) ||
+        (StaticStates[Index].Id == LANG_STATE_PREVIOUS)) {
+      FreeParseStates(Count, Ptr);
+      return EFI_INVALID_PARAMETER;
+    }
+    // Allocate each parser state
+    State = Ptr[Index] = (LANG_STATE *)AllocateZeroPool(sizeof(LANG_STATE));
+    if (State == NULL) {
+      FreeParseStates(Count, Ptr);
+      return EFI_OUT_OF_RESOURCES;
+    }
+    State->Callback = StaticStates[Index].Callback;
+    State->Id = StaticStates[Index].Id;
     // Allocate buffer for the state rules
-    Rules = (LANG_RULE **)AllocateZeroPool(StaticStates[Index].Count * sizeof(LANG_RULE *));
-    if (Rules == NULL) {
+    State->Rules = (LANG_RULE **)AllocateZeroPool(StaticStates[Index].Count * sizeof(LANG_RULE *));
+    if (State->Rules == NULL) {
+      FreeParseStates(Count, Ptr);
       return EFI_OUT_OF_RESOURCES;
     }
+    State->Count = StaticStates[Index].Count;
     // Create parser state rules
     for (RuleIndex = 0; RuleIndex < StaticStates[Index].Count; ++RuleIndex) {
       // Create each parser state rule
       LANG_STATIC_RULE *Rule = StaticStates[Index].Rules + RuleIndex;
-      Status = CreateParseRule(Rules + RuleIndex, Rule->Callback, Rule->Options, Rule->NextState, Rule->Count, Rule->Tokens);
+      Status = CreateParseRule(State->Rules + RuleIndex, Rule->Callback, Rule->Options, Rule->NextState, Rule->Count, Rule->Tokens);
       if (EFI_ERROR(Status)) {
-        FreePool(Rules);
+        FreeParseStates(Count, Ptr);
         return Status;
       }
     }
-    // Create each parser state
-    Status = CreateParseState(Ptr + Index, StaticStates[Index].Callback, StaticStates[Index].Id, StaticStates[Index].Count, Rules);
-    if (EFI_ERROR(Status)) {
-      return Status;
-    }
   }
   // Return parser states
   *States = Ptr;
@@ -1212,9 +2071,98 @@ FreeParseStates (
       FreeParseState(States[Index]);
     }
   }
+  FreePool(States);
   return EFI_SUCCESS;
 }
 
+// CompileSharedStates
+/// Compile parser states from static states into a single allocation that references the static token strings
+/// @param Count        The count of static parser states
+/// @param StaticStates The static parser states, which must not change while the library is in use
+/// @return The compiled shared states or NULL if there was an error
+STATIC LANG_SHARED_STATES *
+EFIAPI
+CompileSharedStates (
+  IN UINTN              Count,
+  IN LANG_STATIC_STATE *StaticStates
+) {
+  LANG_SHARED_STATES  *Shared;
+  LANG_STATE          *States;
+  LANG_RULE          **RuleList;
+  LANG_RULE           *Rules;
+  UINTN                RuleCount = 0;
+  UINTN                Index;
+  // Count the rules of all states
+  for (Index = 0; Index < Count; ++Index) {
+    if ((StaticStates[Index].Count == 0) || (StaticStates[Index].Count > LANG_RULE_MAX_COUNT) ||
+        (StaticStates[Index].Id == LANG_STATE_PREVIOUS)) {
+      return NULL;
+    }
+    RuleCount += StaticStates[Index].Count;
+  }
+  // Allocate the states, rules and their lists together
+  Shared = (LANG_SHARED_STATES *)AllocateZeroPool(sizeof(LANG_SHARED_STATES) +
+                                                  (Count * (sizeof(LANG_STATE *) + sizeof(LANG_STATE))) +
+                                                  (RuleCount * (sizeof(LANG_RULE *) + sizeof(LANG_RULE))));
+  if (Shared == NULL) {
+    return NULL;
+  }
+  Shared->StaticStates = StaticStates;
+  Shared->Count = Count;
+  Shared->States = (LANG_STATE **)(Shared + 1);
+  States = (LANG_STATE *)(Shared->States + Count);
+  RuleList = (LANG_RULE **)(States + Count);
+  Rules = (LANG_RULE *)(RuleList + RuleCount);
+  // Build each state from the static state
+  for (Index = 0; Index < Count; ++Index) {
+    UINTN RuleIndex;
+    Shared->States[Index] = States;
+    States->Callback = StaticStates[Index].Callback;
+    States->Id = StaticStates[Index].Id;
+    States->Count = StaticStates[Index].Count;
+    States->Rules = RuleList;
+    // Build each rule, the token strings are not duplicated
+    for (RuleIndex = 0; RuleIndex < StaticStates[Index].Count; ++RuleIndex) {
+      LANG_STATIC_RULE *Rule = StaticStates[Index].Rules + RuleIndex;
+      Rules->Callback = Rule->Callback;
+      Rules->Options = Rule->Options;
+      Rules->NextState = Rule->NextState;
+      Rules->Count = Rule->Count;
+      Rules->Tokens = Rule->Tokens;
+      Rules->MaxLength = GetParseRuleMaxLength(Rule->Count, Rule->Tokens);
+      *RuleList++ = Rules++;
+    }
+    ++States;
+  }
+  return Shared;
+}
+// FindSharedStates
+/// Find or compile the shared parser states for static states
+/// @param Count        The count of static parser states
+/// @param StaticStates The static parser states
+/// @return The shared parser states or NULL if there was an error
+STATIC LANG_SHARED_STATES *
+EFIAPI
+FindSharedStates (
+  IN UINTN              Count,
+  IN LANG_STATIC_STATE *StaticStates
+) {
+  LANG_SHARED_STATES *Shared;
+  // Check if these static states were already compiled
+  for (Shared = mLangSharedStates; Shared != NULL; Shared = Shared->Next) {
+    if ((Shared->StaticStates == StaticStates) && (Shared->Count == Count)) {
+      return Shared;
+    }
+  }
+  // Compile the static states once for all parsers
+  Shared = CompileSharedStates(Count, StaticStates);
+  if (Shared != NULL) {
+    Shared->Next = mLangSharedStates;
+    mLangSharedStates = Shared;
+  }
+  return Shared;
+}
+
 // SetParseCallback
 /// Set the parser token parsed callback
 /// @param Parser   The language parser
@@ -1332,8 +2280,12 @@ SetParseStates (
     return EFI_INVALID_PARAMETER;
   }
   // Free old states
-  FreeParseStates(Parser->Count, Parser->States);
-  Parser->Count =  0;
+  if (!Parser->SharedStates) {
+    FreeParseStates(Parser->Count, Parser->States);
+  }
+  Parser->SharedStates = FALSE;
+  Parser->States = NULL;
+  Parser->Count = 0;
   // Duplicate new states
   Parser->States = DuplicateParseStates(Count, States);
   if (Parser->States == NULL) {
@@ -1352,7 +2304,7 @@ SetParseStates (
 /// Get the current states of a parser
 /// @param Parser The language parser
 /// @param Count  On output, the count of parser states
-/// @param States On output, the states of the parser
+/// @param States On output, the states of the parser, which may be shared with other parsers and must not be modified
 /// @return Whether the parser states were retrieved or not
 /// @retval EFI_INVALID_PARAMETER If Parser, Count, or States is NULL
 /// @retval EFI_NOT_FOUND         If the language parser has no states
@@ -1400,6 +2352,9 @@ CreateParser (
   }
   // Set parsed token callback
   Ptr->Callback = Callback;
+  // Start at the first line and column
+  Ptr->NextPosition.Line = 1;
+  Ptr->NextPosition.Column = 1;
   // Return language parser
   *Parser = Ptr;
   return EFI_SUCCESS;
@@ -1449,7 +2404,8 @@ CreateParserWithStates (
   return EFI_SUCCESS;
 }
 // CreateParserFromStates
-/// Create a language parser with static parser states
+/// Create a language parser with static parser states, the static states are compiled once and then shared
+///  by every parser created from them, so they must not be modified until the parse library is finished
 /// @param Parser   On output, the created language parser, which must be freed with FreeParser
 /// @param Callback The token parsed callback
 /// @param Id       The identifier of the state to set for the parser
@@ -1457,7 +2413,8 @@ CreateParserWithStates (
 /// @param States   The static parser states to set for the language parser
 /// @return Whether the language parser was created or not
 /// @retval EFI_INVALID_PARAMETER If Parser or States is NULL or Count is zero
-/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the parser
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the parser or the static states are invalid
+/// @retval EFI_NOT_FOUND         If the parser state identifier was not found
 /// @retval EFI_SUCCESS           If the language parser was created successfully
 EFI_STATUS
 EFIAPI
@@ -1468,8 +2425,9 @@ CreateParserFromStates (
   IN  UINTN              Count,
   IN  LANG_STATIC_STATE *States
 ) {
-  EFI_STATUS   Status;
-  LANG_PARSER *Ptr;
+  EFI_STATUS          Status;
+  LANG_PARSER        *Ptr;
+  LANG_SHARED_STATES *Shared;
   // Check parameters
   if ((Parser == NULL) || (States == NULL) || (Count == 0)) {
     return EFI_INVALID_PARAMETER;
@@ -1483,17 +2441,21 @@ CreateParserFromStates (
   if (Ptr == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
-  // Create the parser states
-  Status = CreateParseStates(&(Ptr->States), Ptr->Count = Count, States);
-  if (EFI_ERROR(Status)) {
+  // Reference the shared parser states compiled from the static states
+  Shared = FindSharedStates(Count, States);
+  if (Shared == NULL) {
     FreeParser(Ptr);
-    return Status;
+    return EFI_OUT_OF_RESOURCES;
   }
+  Ptr->States = Shared->States;
+  Ptr->Count = Shared->Count;
+  Ptr->SharedStates = TRUE;
   // Find initial state by identifier
-  Ptr->Count = Count;
   Ptr->State = FindParseState(Ptr, Id);
-  // Check if identifier found for initial state
-  Status = (Ptr->State == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+  if (Ptr->State == NULL) {
+    FreeParser(Ptr);
+    return EFI_NOT_FOUND;
+  }
   // Return parser
   *Parser = Ptr;
   return EFI_SUCCESS;
@@ -1514,22 +2476,43 @@ FreeParser (
     return EFI_INVALID_PARAMETER;
   }
   // Free the parser token
-  if (Parser->Token != NULL) {
-    FreePool(Parser->Token);
-    Parser->Token = NULL;
-  }
-  // Free the parser states
-  if (Parser->States != NULL) {
+  StrBuilderFree(&(Parser->Token));
+  // Free the parser states unless they are shared
+  if ((Parser->States != NULL) && !Parser->SharedStates) {
     FreeParseStates(Parser->Count, Parser->States);
-    Parser->States = NULL;
   }
+  Parser->States = NULL;
+  Parser->SharedStates = FALSE;
+  // Free the previous states
+  while (Parser->PreviousStates != NULL) {
+    LANG_LIST *List = Parser->PreviousStates;
+    Parser->PreviousStates = List->Previous;
+    FreePool(List);
+  }
+  // Free the parser messages
+  if (Parser->Messages != NULL) {
+    ParseClearMessages(Parser);
+    FreePool(Parser->Messages);
+    Parser->Messages = NULL;
+  }
+#if defined(PROJECT_DEBUG)
+
+  // Free the parser profiles
+  if (Parser->Profiles != NULL) {
+    FreePool(Parser->Profiles);
+    Parser->Profiles = NULL;
+  }
+  Parser->Profile = NULL;
+  Parser->ProfileCount = 0;
+
+#endif
+
   // Set rest of parser to zeros
   Parser->State = NULL;
   Parser->Count = 0;
-  Parser->DecodeCount = 0;
-  Parser->DecodedCharacter = 0;
-  Parser->TokenCount = 0;
-  Parser->TokenSize = 0;
+  Parser->Decoder = NULL;
+  Parser->PendingSize = 0;
+  Parser->Surrogate = 0;
   // Free the parser
   FreePool(Parser);
   return EFI_SUCCESS;
@@ -1556,5 +2539,18 @@ EFIAPI
 ParseLibFinish (
   VOID
 ) {
+  // Free the registered character decoders
+  while (mLangRegisteredDecoders != NULL) {
+    LANG_DECODER *Decoder = mLangRegisteredDecoders;
+    mLangRegisteredDecoders = Decoder->Next;
+    FreePool(Decoder->Encoding);
+    FreePool(Decoder);
+  }
+  // Free the shared parser states, no parser may still reference them
+  while (mLangSharedStates != NULL) {
+    LANG_SHARED_STATES *Shared = mLangSharedStates;
+    mLangSharedStates = Shared->Next;
+    FreePool(Shared);
+  }
   return EFI_SUCCESS;
 }
@@ -4,127 +4,633 @@
 /// String library Base64
 ///
 
-#include "Unicode.h"
+#include <Library/StringLib.h>
+
+// BASE64_INVALID
+/// The decoded value of a character that is not Base64
+#define BASE64_INVALID 0xFF
+// BASE64_VALUE
+/// Get the decoded 6bit value of a character or BASE64_INVALID if the character is not Base64
+#define BASE64_VALUE(Character) (((Character) < 0x100) ? (UINT32)mBase64Values[(Character)] : BASE64_INVALID)
+// BASE64_CHARACTER
+/// Get a character of a Base64 string that is either ASCII or unicode
+#define BASE64_CHARACTER(Base64, Index, Ascii) ((Ascii) ? (UINT32)(UINT8)(((CHAR8 *)(Base64))[Index]) : (UINT32)(((CHAR16 *)(Base64))[Index]))
 
 // mBase64Dict
 /// Base64 dictionary
 STATIC CHAR8 mBase64Dict[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+// mBase64Values
+/// Base64 decoded 6bit values of characters, BASE64_INVALID if the character is not Base64
+STATIC UINT8 mBase64Values[0x100] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+  0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+  0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+  0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
 
-// IsBase64Character
-/// Check if character is Base64 character
-/// @param Character The character to check is Base64
-/// @retval TRUE  The character is Base64
-/// @retval FALSE The character is not Base64
-STATIC BOOLEAN
+// Base64EncodeGroup
+/// Encode a group of three bytes as four Base64 characters
+/// @param Base64 The Base64 string that is either ASCII or unicode
+/// @param Index  The index in the string of the first character
+/// @param Bits   The group of three bytes, the first byte in the highest bits
+/// @param Count  The count of characters to encode, the remaining characters are padding
+/// @param Ascii  Whether the string is ASCII or unicode
+STATIC VOID
+EFIAPI
+Base64EncodeGroup (
+  OUT VOID    *Base64,
+  IN  UINTN    Index,
+  IN  UINT32   Bits,
+  IN  UINTN    Count,
+  IN  BOOLEAN  Ascii
+) {
+  CHAR8 Characters[4];
+  UINTN Offset;
+  Characters[0] = mBase64Dict[(Bits >> 18) & 0x3F];
+  Characters[1] = mBase64Dict[(Bits >> 12) & 0x3F];
+  Characters[2] = (Count > 2) ? mBase64Dict[(Bits >> 6) & 0x3F] : '=';
+  Characters[3] = (Count > 3) ? mBase64Dict[Bits & 0x3F] : '=';
+  if (Ascii) {
+    CopyMem(((CHAR8 *)Base64) + Index, Characters, sizeof(Characters));
+  } else {
+    for (Offset = 0; Offset < 4; ++Offset) {
+      ((CHAR16 *)Base64)[Index + Offset] = (CHAR16)Characters[Offset];
+    }
+  }
+}
+// ToBase64UpdateInternal
+/// Encode the next chunk of data to Base64, only whole groups of characters are encoded and the remaining bytes are kept in the context
+/// @param Context The Base64 context
+/// @param Size    The size, in bytes, of the data to encode
+/// @param Data    The data to encode
+/// @param Base64  The Base64 string that is either ASCII or unicode, which must have room for BASE64_ENCODED_LENGTH(Context->Count + Size) characters
+/// @param Ascii   Whether the string is ASCII or unicode
+/// @return The count of characters encoded
+STATIC UINTN
 EFIAPI
-IsBase64Character (
-  IN UINT32 Character
+ToBase64UpdateInternal (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Size,
+  IN     VOID           *Data,
+  OUT    VOID           *Base64,
+  IN     BOOLEAN         Ascii
 ) {
-  return (((Character >= 'A') && (Character <= 'Z')) ||
-          ((Character >= 'a') && (Character <= 'z')) ||
-          ((Character >= '0') && (Character <= '9')) ||
-          (Character == '+') || (Character == '/'));
+  UINT8 *Ptr = (UINT8 *)Data;
+  UINTN  Index = 0;
+  // Complete the partial group
+  if (Context->Count != 0) {
+    while ((Context->Count < 3) && (Size > 0)) {
+      Context->Bits = ((Context->Bits << 8) | *Ptr++);
+      ++(Context->Count);
+      --Size;
+    }
+    if (Context->Count < 3) {
+      return 0;
+    }
+    Base64EncodeGroup(Base64, Index, Context->Bits, 4, Ascii);
+    Index += 4;
+    Context->Bits = 0;
+    Context->Count = 0;
+  }
+  // Encode whole groups directly from the data, the loops are separate so the character size is not checked for each group
+  if (Ascii) {
+    CHAR8 *Str = ((CHAR8 *)Base64) + Index;
+    for (; Size >= 3; Size -= 3, Ptr += 3) {
+      *Str++ = mBase64Dict[Ptr[0] >> 2];
+      *Str++ = mBase64Dict[((Ptr[0] & 0x03) << 4) | (Ptr[1] >> 4)];
+      *Str++ = mBase64Dict[((Ptr[1] & 0x0F) << 2) | (Ptr[2] >> 6)];
+      *Str++ = mBase64Dict[Ptr[2] & 0x3F];
+    }
+    Index = (UINTN)(Str - (CHAR8 *)Base64);
+  } else {
+    CHAR16 *Str = ((CHAR16 *)Base64) + Index;
+    for (; Size >= 3; Size -= 3, Ptr += 3) {
+      *Str++ = mBase64Dict[Ptr[0] >> 2];
+      *Str++ = mBase64Dict[((Ptr[0] & 0x03) << 4) | (Ptr[1] >> 4)];
+      *Str++ = mBase64Dict[((Ptr[1] & 0x0F) << 2) | (Ptr[2] >> 6)];
+      *Str++ = mBase64Dict[Ptr[2] & 0x3F];
+    }
+    Index = (UINTN)(Str - (CHAR16 *)Base64);
+  }
+  // Keep the remaining bytes for the next group
+  while (Size-- > 0) {
+    Context->Bits = ((Context->Bits << 8) | *Ptr++);
+    ++(Context->Count);
+  }
+  return Index;
 }
-// FromBase64Character
-/// Get 6bit value from 8bit encoded character
-/// @param Character The character to decode
-/// @return The decoded 6bit value
-STATIC UINT32
+// ToBase64FinalInternal
+/// Encode the remaining bytes of the partial group with padding and reset the context
+/// @param Context The Base64 context
+/// @param Base64  The Base64 string that is either ASCII or unicode, which must have room for four characters
+/// @param Ascii   Whether the string is ASCII or unicode
+/// @return The count of characters encoded
+STATIC UINTN
 EFIAPI
-FromBase64Character (
-  IN UINT32 Character
+ToBase64FinalInternal (
+  IN OUT BASE64_CONTEXT *Context,
+  OUT    VOID           *Base64,
+  IN     BOOLEAN         Ascii
 ) {
-  UINT32 Result = 0;
-  if ((Character >= 'A') && (Character <= 'Z')) {
-    Result = (Character - 'A');
-  } else if ((Character >= 'a') && (Character <= 'z')) {
-    Result = ((Character - 'a') + 26);
-  } else if ((Character >= '0') && (Character <= '9')) {
-    Result = ((Character - '0') + 52);
-  } else if (Character == '+') {
-    Result = 62;
-  } else if (Character == '/') {
-    Result = 63;
+  UINTN Count = Context->Count;
+  if (Count == 0) {
+    return 0;
   }
-  return Result;
+  // One byte is two characters and two bytes are three characters
+  Base64EncodeGroup(Base64, 0, (Context->Bits << ((3 - Count) << 3)), Count + 1, Ascii);
+  Context->Bits = 0;
+  Context->Count = 0;
+  return 4;
 }
-
-// ToBase64
-/// Convert data to Base64 encoded string
+// ToBase64UpdateChecked
+/// Encode the next chunk of data to Base64 into a caller buffer
+/// @param Context The Base64 context
+/// @param Size    The size, in bytes, of the data to encode
+/// @param Data    The data to encode
+/// @param Count   On input, the size, in characters, of the buffer, on output, the count of characters encoded or the size needed
+/// @param Base64  The buffer for the Base64 characters that is either ASCII or unicode, which is not null-terminated
+/// @param Ascii   Whether the buffer is ASCII or unicode
+/// @return Whether the data was encoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Count is NULL or Data is NULL and Size is not zero
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the data was encoded successfully
+STATIC EFI_STATUS
+EFIAPI
+ToBase64UpdateChecked (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Size,
+  IN     VOID           *Data,
+  IN OUT UINTN          *Count,
+  OUT    VOID           *Base64 OPTIONAL,
+  IN     BOOLEAN         Ascii
+) {
+  UINTN Length;
+  // Check parameters
+  if ((Context == NULL) || (Count == NULL) || ((Data == NULL) && (Size != 0)) || (Context->Count > 2)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Check the buffer is large enough for the whole groups
+  Length = (((Context->Count + Size) / 3) * 4);
+  if ((*Count < Length) || ((Base64 == NULL) && (Length != 0))) {
+    *Count = Length;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  *Count = ToBase64UpdateInternal(Context, Size, Data, Base64, Ascii);
+  return EFI_SUCCESS;
+}
+// ToBase64FinalChecked
+/// Encode the remaining bytes with padding into a caller buffer and reset the context
+/// @param Context The Base64 context
+/// @param Count   On input, the size, in characters, of the buffer, on output, the count of characters encoded or the size needed
+/// @param Base64  The buffer for the Base64 characters that is either ASCII or unicode, which is not null-terminated
+/// @param Ascii   Whether the buffer is ASCII or unicode
+/// @return Whether the remaining bytes were encoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Count is NULL
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the remaining bytes were encoded successfully
+STATIC EFI_STATUS
+EFIAPI
+ToBase64FinalChecked (
+  IN OUT BASE64_CONTEXT *Context,
+  IN OUT UINTN          *Count,
+  OUT    VOID           *Base64 OPTIONAL,
+  IN     BOOLEAN         Ascii
+) {
+  // Check parameters
+  if ((Context == NULL) || (Count == NULL) || (Context->Count > 2)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Check the buffer is large enough for the padded group
+  if ((Context->Count != 0) && ((*Count < 4) || (Base64 == NULL))) {
+    *Count = 4;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  *Count = ToBase64FinalInternal(Context, Base64, Ascii);
+  return EFI_SUCCESS;
+}
+// ToBase64BufferInternal
+/// Convert data to a Base64 encoded string in a caller buffer
+/// @param Size   The size, in bytes, of the data to encode
+/// @param Data   The data to encode
+/// @param Count  On input, the size, in characters, of the buffer, on output, the size, in characters, of the encoded string including the null-terminator
+/// @param Base64 The buffer for the Base64 encoded string that is either ASCII or unicode
+/// @param Ascii  Whether the buffer is ASCII or unicode
+/// @return Whether the data was converted to Base64 or not
+/// @retval EFI_INVALID_PARAMETER If Data or Count is NULL or Size is zero
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the data was converted to Base64 successfully
+STATIC EFI_STATUS
+EFIAPI
+ToBase64BufferInternal (
+  IN     UINTN    Size,
+  IN     VOID    *Data,
+  IN OUT UINTN   *Count,
+  OUT    VOID    *Base64 OPTIONAL,
+  IN     BOOLEAN  Ascii
+) {
+  BASE64_CONTEXT Context = { 0, 0 };
+  UINTN          Length;
+  // Check parameters
+  if ((Data == NULL) || (Count == NULL) || (Size == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Check the buffer is large enough for the encoded string
+  Length = BASE64_ENCODED_LENGTH(Size);
+  if ((*Count <= Length) || (Base64 == NULL)) {
+    *Count = Length + 1;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  // Encode the whole groups and then the padded group
+  Length = ToBase64UpdateInternal(&Context, Size, Data, Base64, Ascii);
+  Length += ToBase64FinalInternal(&Context, Ascii ? (VOID *)((CHAR8 *)Base64 + Length) : (VOID *)((CHAR16 *)Base64 + Length), Ascii);
+  if (Ascii) {
+    ((CHAR8 *)Base64)[Length] = '\0';
+  } else {
+    ((CHAR16 *)Base64)[Length] = L'\0';
+  }
+  *Count = Length + 1;
+  return EFI_SUCCESS;
+}
+// ToBase64Internal
+/// Convert data to an allocated Base64 encoded string
 /// @param Size   The size, in bytes, of the data to encode
 /// @param Data   The data to encode
 /// @param Count  On output, the count of characters encoded
-/// @param Base64 On output, the Base64 encoded string, which must be freed
+/// @param Base64 On output, the Base64 encoded string that is either ASCII or unicode, which must be freed
+/// @param Ascii  Whether the string is ASCII or unicode
 /// @return Whether the data was converted to Base64 or not
 /// @retval EFI_INVALID_PARAMETER If Data or Base64 is NULL or *Base64 is not NULL or Size is zero
 /// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_SUCCESS           If the data was converted to Base64 successfully
-EFI_STATUS
+STATIC EFI_STATUS
 EFIAPI
-ToBase64 (
+ToBase64Internal (
   IN  UINTN    Size,
   IN  VOID    *Data,
   OUT UINTN   *Count OPTIONAL,
-  OUT CHAR16 **Base64
+  OUT VOID   **Base64,
+  IN  BOOLEAN  Ascii
 ) {
-  CHAR16 *Str;
-  CHAR16 *Result;
-  UINT8  *Ptr;
-  UINTN   Length;
-  UINTN   Offset;
-  UINTN   Index;
+  EFI_STATUS  Status;
+  VOID       *Result;
+  UINTN       Length;
   // Check parameters
   if ((Data == NULL) || (Base64 == NULL) || (*Base64 != NULL) || (Size == 0)) {
     return EFI_INVALID_PARAMETER;
   }
-  // Get the length of the encoded string
-  Length =  (((Size + 2) / 3 ) * 4);
-  if (Length == 0) {
-    return EFI_INVALID_PARAMETER;
-  }
   // Allocate a buffer for the string
-  Result = (CHAR16 *)AllocateZeroPool((Length + 1) * sizeof(CHAR16));
+  Length = BASE64_ENCODED_LENGTH(Size) + 1;
+  Result = AllocateZeroPool(Length * (Ascii ? sizeof(CHAR8) : sizeof(CHAR16)));
   if (Result == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
-  // Check if the data is multiple of three 
-  Offset = Size % 3;
-  Size -= Offset;
   // Convert the data to Base64
-  Index = 0;
-  Str = Result;
-  Ptr = (UINT8 *)Data;
-  while (Index < Size) {
-    UINT8 Tmp;
-    *Str++ = mBase64Dict[(Ptr[Index] >> 2) & 0x3F];
-    Tmp = (Ptr[Index++] & 0x03) << 4;
-    *Str++ = mBase64Dict[Tmp | ((Ptr[Index] >> 4) & 0x0F)];
-    Tmp = (Ptr[Index++] & 0x0F) << 2;
-    *Str++ = mBase64Dict[Tmp | ((Ptr[Index] >> 6) & 0x03)];
-    *Str++ = mBase64Dict[Ptr[Index++] & 0x3F];
+  Status = ToBase64BufferInternal(Size, Data, &Length, Result, Ascii);
+  if (EFI_ERROR(Status)) {
+    FreePool(Result);
+    return Status;
   }
-  // Add padding
-  if (Offset == 1) {
-    *Str++ = mBase64Dict[(Ptr[Index] >> 2) & 0x3F];
-    *Str++ = mBase64Dict[(Ptr[Index] & 0x03) << 4];
-    *Str++ = '=';
-    *Str++ = '=';
-  } else if (Offset == 2) {
-    UINT8 Tmp;
-    *Str++ = mBase64Dict[(Ptr[Index] >> 2) & 0x3F];
-    Tmp = (Ptr[Index++] & 0x03) << 4;
-    *Str++ = mBase64Dict[Tmp | ((Ptr[Index] >> 4) & 0x0F)];
-    *Str++ = mBase64Dict[(Ptr[Index] & 0x0F) << 2];
-    *Str++ = '=';
-  }
-  *Str = '\0';
   // Return Base64 encoded string and count if requested
   if (Count != NULL) {
-    *Count = Length;
+    *Count = Length - 1;
   }
   *Base64 = Result;
   return EFI_SUCCESS;
 }
+
+// FromBase64UpdateInternal
+/// Decode the next chunk of a Base64 encoded string, characters that are not Base64 are skipped and only whole groups are decoded
+/// @param Context The Base64 context
+/// @param Length  The count of characters to decode
+/// @param Base64  The Base64 encoded string that is either ASCII or unicode
+/// @param Data    The buffer for the decoded data, which must have room for ((Context->Count + Length) / 4) * 3 bytes
+/// @param Ascii   Whether the string is ASCII or unicode
+/// @return The size, in bytes, of the decoded data
+STATIC UINTN
+EFIAPI
+FromBase64UpdateInternal (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Length,
+  IN     VOID           *Base64,
+  OUT    UINT8          *Data,
+  IN     BOOLEAN         Ascii
+) {
+  UINT8  *Ptr = Data;
+  UINTN   Index = 0;
+  UINTN   Count = Context->Count;
+  UINT32  Bits = Context->Bits;
+  UINT32  Value;
+  UINT32  Value1;
+  UINT32  Value2;
+  UINT32  Value3;
+  while (Index < Length) {
+    // Decode a whole group of four characters at once when none of the characters need to be skipped, the
+    //  invalid value has bits above the 6bit values so only one check is needed for the group
+    if ((Count == 0) && ((Length - Index) >= 4)) {
+      Value = BASE64_VALUE(BASE64_CHARACTER(Base64, Index, Ascii));
+      Value1 = BASE64_VALUE(BASE64_CHARACTER(Base64, Index + 1, Ascii));
+      Value2 = BASE64_VALUE(BASE64_CHARACTER(Base64, Index + 2, Ascii));
+      Value3 = BASE64_VALUE(BASE64_CHARACTER(Base64, Index + 3, Ascii));
+      if ((Value | Value1 | Value2 | Value3) < 0x40) {
+        Bits = ((Value << 18) | (Value1 << 12) | (Value2 << 6) | Value3);
+        *Ptr++ = (UINT8)(Bits >> 16);
+        *Ptr++ = (UINT8)(Bits >> 8);
+        *Ptr++ = (UINT8)Bits;
+        Index += 4;
+        continue;
+      }
+    }
+    // Decode one character at a time, skipping characters that are not Base64
+    Value = BASE64_VALUE(BASE64_CHARACTER(Base64, Index, Ascii));
+    ++Index;
+    if (Value == BASE64_INVALID) {
+      continue;
+    }
+    Bits = ((Bits << 6) | Value);
+    if (++Count == 4) {
+      *Ptr++ = (UINT8)(Bits >> 16);
+      *Ptr++ = (UINT8)(Bits >> 8);
+      *Ptr++ = (UINT8)Bits;
+      Bits = 0;
+      Count = 0;
+    }
+  }
+  Context->Bits = ((Count == 0) ? 0 : Bits);
+  Context->Count = Count;
+  return (UINTN)(Ptr - Data);
+}
+// FromBase64FinalInternal
+/// Decode the characters of the partial group, padding is implied by the count of characters, and reset the context
+/// @param Context The Base64 context
+/// @param Data    The buffer for the decoded data, which must have room for two bytes
+/// @return The size, in bytes, of the decoded data
+STATIC UINTN
+EFIAPI
+FromBase64FinalInternal (
+  IN OUT BASE64_CONTEXT *Context,
+  OUT    UINT8          *Data
+) {
+  UINTN Size = 0;
+  if (Context->Count == 2) {
+    Data[Size++] = (UINT8)(Context->Bits >> 4);
+  } else if (Context->Count == 3) {
+    Data[Size++] = (UINT8)(Context->Bits >> 10);
+    Data[Size++] = (UINT8)(Context->Bits >> 2);
+  }
+  Context->Bits = 0;
+  Context->Count = 0;
+  return Size;
+}
+// FromBase64UpdateChecked
+/// Decode the next chunk of a Base64 encoded string into a caller buffer
+/// @param Context The Base64 context
+/// @param Length  The count of characters to decode
+/// @param Base64  The Base64 encoded characters that are either ASCII or unicode
+/// @param Size    On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the decoded data or the size needed
+/// @param Data    The buffer for the decoded data
+/// @param Ascii   Whether the characters are ASCII or unicode
+/// @return Whether the characters were decoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Size is NULL or Base64 is NULL and Length is not zero
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the characters were decoded successfully
+STATIC EFI_STATUS
+EFIAPI
+FromBase64UpdateChecked (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Length,
+  IN     VOID           *Base64,
+  IN OUT UINTN          *Size,
+  OUT    VOID           *Data OPTIONAL,
+  IN     BOOLEAN         Ascii
+) {
+  UINTN DataSize;
+  // Check parameters
+  if ((Context == NULL) || (Size == NULL) || ((Base64 == NULL) && (Length != 0)) || (Context->Count > 3)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Check the buffer is large enough for the whole groups if every character is Base64
+  DataSize = (((Context->Count + Length) / 4) * 3);
+  if ((*Size < DataSize) || ((Data == NULL) && (DataSize != 0))) {
+    *Size = DataSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  *Size = FromBase64UpdateInternal(Context, Length, Base64, (UINT8 *)Data, Ascii);
+  return EFI_SUCCESS;
+}
+// FromBase64Length
+/// Get the length of a Base64 encoded string and the size of the decoded data
+/// @param Base64 The Base64 encoded string that is either ASCII or unicode
+/// @param Length On output, the count of characters in the string
+/// @param Size   On output, the size, in bytes, of the decoded data
+/// @param Ascii  Whether the string is ASCII or unicode
+/// @return Whether the Base64 encoded string is valid or not
+/// @retval EFI_INVALID_PARAMETER If there are no Base64 characters or there is only one character in the last group
+/// @retval EFI_SUCCESS           If the Base64 encoded string is valid
+STATIC EFI_STATUS
+EFIAPI
+FromBase64Length (
+  IN  VOID    *Base64,
+  OUT UINTN   *Length,
+  OUT UINTN   *Size,
+  IN  BOOLEAN  Ascii
+) {
+  UINTN  Index = 0;
+  UINTN  Count = 0;
+  UINT32 Character;
+  // Get the string length and count of Base64 characters, padding is implied by the count of characters in the last group
+  while ((Character = BASE64_CHARACTER(Base64, Index, Ascii)) != 0) {
+    if (BASE64_VALUE(Character) != BASE64_INVALID) {
+      ++Count;
+    }
+    ++Index;
+  }
+  if ((Count == 0) || ((Count % 4) == 1)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  *Length = Index;
+  *Size = (((Count / 4) * 3) + (((Count % 4) != 0) ? ((Count % 4) - 1) : 0));
+  return EFI_SUCCESS;
+}
+// FromBase64BufferInternal
+/// Convert Base64 encoded string to data in a caller buffer
+/// @param Base64 The Base64 encoded string that is either ASCII or unicode
+/// @param Size   On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the data
+/// @param Data   The buffer for the decoded data
+/// @param Ascii  Whether the string is ASCII or unicode
+/// @return Whether the Base64 encoded string was converted to data or not
+/// @retval EFI_INVALID_PARAMETER If Base64 or Size is NULL or the Base64 encoded string is invalid
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the Base64 encoded string was converted to data successfully
+STATIC EFI_STATUS
+EFIAPI
+FromBase64BufferInternal (
+  IN     VOID    *Base64,
+  IN OUT UINTN   *Size,
+  OUT    VOID    *Data OPTIONAL,
+  IN     BOOLEAN  Ascii
+) {
+  EFI_STATUS     Status;
+  BASE64_CONTEXT Context = { 0, 0 };
+  UINTN          DataSize;
+  UINTN          Length;
+  // Check parameters
+  if ((Base64 == NULL) || (Size == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Get the exact size of the data
+  Status = FromBase64Length(Base64, &Length, &DataSize, Ascii);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  if ((*Size < DataSize) || (Data == NULL)) {
+    *Size = DataSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  // Decode the whole groups and then the partial group
+  Length = FromBase64UpdateInternal(&Context, Length, Base64, (UINT8 *)Data, Ascii);
+  FromBase64FinalInternal(&Context, ((UINT8 *)Data) + Length);
+  *Size = DataSize;
+  return EFI_SUCCESS;
+}
+// FromBase64Internal
+/// Convert Base64 encoded string to allocated data
+/// @param Base64 The Base64 encoded string that is either ASCII or unicode
+/// @param Size   On output, the size, in bytes, of the data
+/// @param Data   On output, the decoded data, which must be freed
+/// @param Ascii  Whether the string is ASCII or unicode
+/// @return Whether the Base64 encoded string was converted to data or not
+/// @retval EFI_INVALID_PARAMETER If Base64, Size, or Data is NULL or *Data is not NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the Base64 string was converted to data successfully
+STATIC EFI_STATUS
+EFIAPI
+FromBase64Internal (
+  IN  VOID    *Base64,
+  OUT UINTN   *Size,
+  OUT VOID   **Data,
+  IN  BOOLEAN  Ascii
+) {
+  EFI_STATUS      Status;
+  BASE64_CONTEXT  Context = { 0, 0 };
+  UINTN           DataSize;
+  UINTN           Length;
+  UINT8          *Buffer;
+  // Check parameters
+  if ((Base64 == NULL) || (Size == NULL) || (Data == NULL) || (*Data != NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Get the size of the data, the string is decoded in place without a corrected copy
+  Status = FromBase64Length(Base64, &Length, &DataSize, Ascii);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Allocate the data buffer with padding to align to 16 bytes
+  Buffer = (UINT8 *)AllocateZeroPool(DataSize + (0x10 - (DataSize & 0x7)));
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Decode the whole groups and then the partial group
+  Length = FromBase64UpdateInternal(&Context, Length, Base64, Buffer, Ascii);
+  FromBase64FinalInternal(&Context, Buffer + Length);
+  // Return the data
+  *Size = DataSize;
+  *Data = Buffer;
+  return EFI_SUCCESS;
+}
+
+// ToBase64
+/// Convert data to Base64 encoded string
+/// @param Size   The size, in bytes, of the data to encode
+/// @param Data   The data to encode
+/// @param Count  On output, the count of characters encoded
+/// @param Base64 On output, the Base64 encoded string, which must be freed
+/// @return Whether the data was converted to Base64 or not
+/// @retval EFI_INVALID_PARAMETER If Data or Base64 is NULL or *Base64 is not NULL or Size is zero
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the data was converted to Base64 successfully
+EFI_STATUS
+EFIAPI
+ToBase64 (
+  IN  UINTN    Size,
+  IN  VOID    *Data,
+  OUT UINTN   *Count OPTIONAL,
+  OUT CHAR16 **Base64
+) {
+  return ToBase64Internal(Size, Data, Count, (VOID **)Base64, FALSE);
+}
+// ToBase64Buffer
+/// Convert data to Base64 encoded string in a caller buffer
+/// @param Size   The size, in bytes, of the data to encode
+/// @param Data   The data to encode
+/// @param Count  On input, the size, in characters, of the buffer, on output, the size, in characters, of the encoded string including the null-terminator
+/// @param Base64 The buffer for the Base64 encoded string, which must have room for BASE64_ENCODED_LENGTH(Size) + 1 characters
+/// @return Whether the data was converted to Base64 or not
+/// @retval EFI_INVALID_PARAMETER If Data or Count is NULL or Size is zero
+/// @retval EFI_BUFFER_TOO_SMALL  If Base64 is NULL or the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the data was converted to Base64 successfully
+EFI_STATUS
+EFIAPI
+ToBase64Buffer (
+  IN     UINTN   Size,
+  IN     VOID   *Data,
+  IN OUT UINTN  *Count,
+  OUT    CHAR16 *Base64 OPTIONAL
+) {
+  return ToBase64BufferInternal(Size, Data, Count, (VOID *)Base64, FALSE);
+}
+// ToBase64Update
+/// Encode the next chunk of data to Base64 characters, only whole groups of characters are encoded and the
+///  remaining bytes are kept in the context until the next chunk or ToBase64Final
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Size    The size, in bytes, of the data to encode
+/// @param Data    The data to encode
+/// @param Count   On input, the size, in characters, of the buffer, on output, the count of characters encoded
+/// @param Base64  The buffer for the Base64 characters, which is not null-terminated
+/// @return Whether the data was encoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Count is NULL or Data is NULL and Size is not zero
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the data was encoded successfully
+EFI_STATUS
+EFIAPI
+ToBase64Update (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Size,
+  IN     VOID           *Data,
+  IN OUT UINTN          *Count,
+  OUT    CHAR16         *Base64 OPTIONAL
+) {
+  return ToBase64UpdateChecked(Context, Size, Data, Count, (VOID *)Base64, FALSE);
+}
+// ToBase64Final
+/// Encode the remaining bytes of the data to Base64 characters with padding and reset the context
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Count   On input, the size, in characters, of the buffer, on output, the count of characters encoded
+/// @param Base64  The buffer for the Base64 characters, which is not null-terminated
+/// @return Whether the remaining bytes were encoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Count is NULL
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the remaining bytes were encoded successfully
+EFI_STATUS
+EFIAPI
+ToBase64Final (
+  IN OUT BASE64_CONTEXT *Context,
+  IN OUT UINTN          *Count,
+  OUT    CHAR16         *Base64 OPTIONAL
+) {
+  return ToBase64FinalChecked(Context, Count, (VOID *)Base64, FALSE);
+}
 // FromBase64
 /// Convert Base64 encoded string to data
 /// @param Base64 The Base64 encoded string to convert
@@ -141,95 +647,83 @@ FromBase64 (
   OUT UINTN   *Size,
   OUT VOID   **Data
 ) {
-  UINTN   DataSize;
-  UINTN   Length;
-  UINTN   Offset;
-  UINTN   Index;
-  VOID   *Buffer;
-  UINT8  *Ptr;
-  CHAR16 *NewBase64;
-  CHAR16 *String;
-  CHAR16 *Str;
-  UINT32  Character;
+  return FromBase64Internal((VOID *)Base64, Size, Data, FALSE);
+}
+// FromBase64Buffer
+/// Convert Base64 encoded string to data in a caller buffer
+/// @param Base64 The Base64 encoded string to convert
+/// @param Size   On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the data
+/// @param Data   The buffer for the decoded data
+/// @return Whether the Base64 encoded string was converted to data or not
+/// @retval EFI_INVALID_PARAMETER If Base64 or Size is NULL or the Base64 encoded string is invalid
+/// @retval EFI_BUFFER_TOO_SMALL  If Data is NULL or the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the Base64 string was converted to data successfully
+EFI_STATUS
+EFIAPI
+FromBase64Buffer (
+  IN     CHAR16 *Base64,
+  IN OUT UINTN  *Size,
+  OUT    VOID   *Data OPTIONAL
+) {
+  return FromBase64BufferInternal((VOID *)Base64, Size, Data, FALSE);
+}
+// FromBase64Update
+/// Decode the next chunk of Base64 encoded characters, characters that are not Base64 are skipped and only
+///  whole groups are decoded, the remaining characters are kept in the context until the next chunk or FromBase64Final
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Length  The count of characters to decode
+/// @param Base64  The Base64 encoded characters to decode
+/// @param Size    On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the decoded data
+/// @param Data    The buffer for the decoded data, which needs at most ((Context->Count + Length) / 4) * 3 bytes
+/// @return Whether the characters were decoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Size is NULL or Base64 is NULL and Length is not zero
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the characters were decoded successfully
+EFI_STATUS
+EFIAPI
+FromBase64Update (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Length,
+  IN     CHAR16         *Base64,
+  IN OUT UINTN          *Size,
+  OUT    VOID           *Data OPTIONAL
+) {
+  return FromBase64UpdateChecked(Context, Length, (VOID *)Base64, Size, Data, FALSE);
+}
+// FromBase64Final
+/// Decode the remaining Base64 characters of the partial group and reset the context, padding is implied by the
+///  count of characters in the partial group
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Size    On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the decoded data
+/// @param Data    The buffer for the decoded data, which needs at most two bytes
+/// @return Whether the remaining characters were decoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Size is NULL or there is only one character in the partial group
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the remaining characters were decoded successfully
+EFI_STATUS
+EFIAPI
+FromBase64Final (
+  IN OUT BASE64_CONTEXT *Context,
+  IN OUT UINTN          *Size,
+  OUT    VOID           *Data OPTIONAL
+) {
+  UINTN DataSize;
   // Check parameters
-  if ((Base64 == NULL) || (Size == NULL) || (Data == NULL) || (*Data != NULL)) {
+  if ((Context == NULL) || (Size == NULL) || (Context->Count > 3)) {
     return EFI_INVALID_PARAMETER;
   }
-  // Get the string length
-  Length = 0;
-  Offset = 0;
-  Str = Base64;
-  while (*Str != '\0') {
-    if (*Str == '=') {
-      ++Offset;
-    } else if (IsBase64Character(*Str)) {
-      ++Length;
-      Offset = 0;
-    }
-    ++Str;
-  }
-  if (Offset > 2) {
-    Offset = 0;
-  }
-  Length -= (4 - Offset);
-  Offset = (3 - Offset);
-  if ((Length == 0) || ((Length % 4) != 0)) {
+  if (Context->Count == 1) {
+    Context->Bits = 0;
+    Context->Count = 0;
     return EFI_INVALID_PARAMETER;
   }
-  // Make a copy of the corrected Base64
-  NewBase64 = (CHAR16 *)AllocateZeroPool((Length + 1) * sizeof(CHAR16));
-  if (NewBase64 == NULL) {
-    return EFI_OUT_OF_RESOURCES;
+  // Check the buffer is large enough for the partial group
+  DataSize = ((Context->Count != 0) ? (Context->Count - 1) : 0);
+  if ((*Size < DataSize) || ((Data == NULL) && (DataSize != 0))) {
+    *Size = DataSize;
+    return EFI_BUFFER_TOO_SMALL;
   }
-  Str = Base64;
-  String = NewBase64;
-  while (*Str != '\0') {
-    Character = *Str++;
-    if (IsBase64Character(Character)) {
-      *String++ = (CHAR16)Character;
-    }
-  }
-  *String = '\0';
-  // Get the size needed and add padding to align to 16 bytes
-  DataSize = (((Length + Offset + 3) / 4) * 3);
-  DataSize += (0x10 - (DataSize & 0x7));
-  // Allocate the data buffer
-  Buffer = AllocateZeroPool(DataSize);
-  if (Buffer == NULL) {
-    FreePool(NewBase64);
-    return EFI_OUT_OF_RESOURCES;
-  }
-  // Iterate through the encoded string to decode the data
-  Index = 0;
-  Str = NewBase64;
-  Ptr = (UINT8 *)Buffer;
-  while (Index < Length) {
-    *Ptr = ((FromBase64Character(Str[Index++]) & 0x3F) << 2);
-    Character = FromBase64Character(Str[Index++]);
-    *Ptr++ |= ((Character >> 4) & 0x03);
-    *Ptr = ((Character & 0xF) << 4);
-    Character = FromBase64Character(Str[Index++]);
-    *Ptr++ |= ((Character >> 2) & 0xF);
-    *Ptr = ((Character & 0x3) << 6);
-    *Ptr++ |= (FromBase64Character(Str[Index++]) & 0x3F);
-  }
-  // Decode the extra offset bytes
-  if (Offset == 1) {
-    *Ptr = ((FromBase64Character(Str[Index++]) & 0x3F) << 2);
-    Character = FromBase64Character(Str[Index++]);
-    *Ptr |= ((Character >> 4) & 0x03);
-  } else if (Offset == 2) {
-    *Ptr = ((FromBase64Character(Str[Index++]) & 0x3F) << 2);
-    Character = FromBase64Character(Str[Index++]);
-    *Ptr++ |= ((Character >> 4) & 0x03);
-    *Ptr = ((Character & 0x0F) << 4);
-    Character = FromBase64Character(Str[Index++]);
-    *Ptr |= ((Character >> 2) & 0xF);
-  }
-  FreePool(NewBase64);
-  // Return the data
-  *Size = (((Length / 4) * 3) + Offset);
-  *Data = Buffer;
+  *Size = FromBase64FinalInternal(Context, (UINT8 *)Data);
   return EFI_SUCCESS;
 }
 // AsciiToBase64
@@ -250,63 +744,68 @@ AsciiToBase64 (
   OUT UINTN  *Count OPTIONAL,
   OUT CHAR8 **Base64
 ) {
-  CHAR8 *Str;
-  CHAR8 *Result;
-  UINT8 *Ptr;
-  UINTN  Length;
-  UINTN  Offset;
-  UINTN  Index;
-  // Check parameters
-  if ((Data == NULL) || (Base64 == NULL) || (*Base64 != NULL) || (Size == 0)) {
-    return EFI_INVALID_PARAMETER;
-  }
-  // Get the length of the encoded string
-  Length =  (((Size + 2) / 3 ) * 4);
-  if (Length == 0) {
-    return EFI_INVALID_PARAMETER;
-  }
-  // Allocate a buffer for the string
-  Result = (CHAR8 *)AllocateZeroPool((Length + 1) * sizeof(CHAR8));
-  if (Result == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-  // Check if the data is multiple of three 
-  Offset = Size % 3;
-  Size -= Offset;
-  // Convert the data to Base64
-  Index = 0;
-  Str = Result;
-  Ptr = (UINT8 *)Data;
-  while (Index < Size) {
-    UINT8 Tmp;
-    *Str++ = mBase64Dict[(Ptr[Index] >> 2) & 0x3F];
-    Tmp = (Ptr[Index++] & 0x03) << 4;
-    *Str++ = mBase64Dict[Tmp | ((Ptr[Index] >> 4) & 0x0F)];
-    Tmp = (Ptr[Index++] & 0x0F) << 2;
-    *Str++ = mBase64Dict[Tmp | ((Ptr[Index] >> 6) & 0x03)];
-    *Str++ = mBase64Dict[Ptr[Index++] & 0x3F];
-  }
-  // Add padding
-  if (Offset == 1) {
-    *Str++ = mBase64Dict[(Ptr[Index] >> 2) & 0x3F];
-    *Str++ = mBase64Dict[(Ptr[Index] & 0x03) << 4];
-    *Str++ = '=';
-    *Str++ = '=';
-  } else if (Offset == 2) {
-    UINT8 Tmp;
-    *Str++ = mBase64Dict[(Ptr[Index] >> 2) & 0x3F];
-    Tmp = (Ptr[Index++] & 0x03) << 4;
-    *Str++ = mBase64Dict[Tmp | ((Ptr[Index] >> 4) & 0x0F)];
-    *Str++ = mBase64Dict[(Ptr[Index++] & 0x0F) << 2];
-    *Str++ = '=';
-  }
-  *Str = '\0';
-  // Return Base64 encoded string and count if requested
-  if (Count != NULL) {
-    *Count = Length;
-  }
-  *Base64 = Result;
-  return EFI_SUCCESS;
+  return ToBase64Internal(Size, Data, Count, (VOID **)Base64, TRUE);
+}
+// AsciiToBase64Buffer
+/// Convert data to Base64 encoded ASCII string in a caller buffer
+/// @param Size   The size, in bytes, of the data to encode
+/// @param Data   The data to encode
+/// @param Count  On input, the size, in characters, of the buffer, on output, the size, in characters, of the encoded string including the null-terminator
+/// @param Base64 The buffer for the Base64 encoded ASCII string, which must have room for BASE64_ENCODED_LENGTH(Size) + 1 characters
+/// @return Whether the data was converted to Base64 or not
+/// @retval EFI_INVALID_PARAMETER If Data or Count is NULL or Size is zero
+/// @retval EFI_BUFFER_TOO_SMALL  If Base64 is NULL or the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the data was converted to Base64 successfully
+EFI_STATUS
+EFIAPI
+AsciiToBase64Buffer (
+  IN     UINTN  Size,
+  IN     VOID  *Data,
+  IN OUT UINTN *Count,
+  OUT    CHAR8 *Base64 OPTIONAL
+) {
+  return ToBase64BufferInternal(Size, Data, Count, (VOID *)Base64, TRUE);
+}
+// AsciiToBase64Update
+/// Encode the next chunk of data to Base64 ASCII characters, only whole groups of characters are encoded and the
+///  remaining bytes are kept in the context until the next chunk or AsciiToBase64Final
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Size    The size, in bytes, of the data to encode
+/// @param Data    The data to encode
+/// @param Count   On input, the size, in characters, of the buffer, on output, the count of characters encoded
+/// @param Base64  The buffer for the Base64 ASCII characters, which is not null-terminated
+/// @return Whether the data was encoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Count is NULL or Data is NULL and Size is not zero
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the data was encoded successfully
+EFI_STATUS
+EFIAPI
+AsciiToBase64Update (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Size,
+  IN     VOID           *Data,
+  IN OUT UINTN          *Count,
+  OUT    CHAR8          *Base64 OPTIONAL
+) {
+  return ToBase64UpdateChecked(Context, Size, Data, Count, (VOID *)Base64, TRUE);
+}
+// AsciiToBase64Final
+/// Encode the remaining bytes of the data to Base64 ASCII characters with padding and reset the context
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Count   On input, the size, in characters, of the buffer, on output, the count of characters encoded
+/// @param Base64  The buffer for the Base64 ASCII characters, which is not null-terminated
+/// @return Whether the remaining bytes were encoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Count is NULL
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the remaining bytes were encoded successfully
+EFI_STATUS
+EFIAPI
+AsciiToBase64Final (
+  IN OUT BASE64_CONTEXT *Context,
+  IN OUT UINTN          *Count,
+  OUT    CHAR8          *Base64 OPTIONAL
+) {
+  return ToBase64FinalChecked(Context, Count, (VOID *)Base64, TRUE);
 }
 // AsciiFromBase64
 /// Convert Base64 encoded ASCII string to data
@@ -324,94 +823,46 @@ AsciiFromBase64 (
   OUT UINTN  *Size,
   OUT VOID  **Data
 ) {
-  UINTN   DataSize;
-  UINTN   Length;
-  UINTN   Offset;
-  UINTN   Index;
-  VOID   *Buffer;
-  UINT8  *Ptr;
-  CHAR8  *NewBase64;
-  CHAR8  *String;
-  CHAR8  *Str;
-  UINT32  Character;
-  // Check parameters
-  if ((Base64 == NULL) || (Size == NULL) || (Data == NULL) || (*Data != NULL)) {
-    return EFI_INVALID_PARAMETER;
-  }
-  // Get the string length
-  Length = 0;
-  Offset = 0;
-  Str = Base64;
-  while (*Str != '\0') {
-    if (*Str == '=') {
-      ++Offset;
-    } else if (IsBase64Character(*Str)) {
-      ++Length;
-      Offset = 0;
-    }
-    ++Str;
-  }
-  if (Offset > 2) {
-    Offset = 0;
-  }
-  Length -= (4 - Offset);
-  Offset = (3 - Offset);
-  if ((Length == 0) || ((Length % 4) != 0)) {
-    return EFI_INVALID_PARAMETER;
-  }
-  // Make a copy of the corrected Base64
-  NewBase64 = (CHAR8 *)AllocateZeroPool((Length + 1) * sizeof(CHAR8));
-  if (NewBase64 == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-  Str = Base64;
-  String = NewBase64;
-  while (*Str != '\0') {
-    Character = *Str++;
-    if (IsBase64Character(Character)) {
-      *String++ = (CHAR8)Character;
-    }
-  }
-  *String = '\0';
-  // Get the size needed and add padding to align to 16 bytes
-  DataSize = (((Length + 3) / 4) * 3);
-  DataSize += (0x10 - (DataSize & 0x7));
-  // Allocate the data buffer
-  Buffer = AllocateZeroPool(DataSize);
-  if (Buffer == NULL) {
-    FreePool(NewBase64);
-    return EFI_OUT_OF_RESOURCES;
-  }
-  // Iterate through the encoded string to decode the data
-  Index = 0;
-  Str = NewBase64;
-  Ptr = (UINT8 *)Buffer;
-  while (Index < Length) {
-    *Ptr = ((FromBase64Character(Str[Index++]) & 0x3F) << 2);
-    Character = FromBase64Character(Str[Index++]);
-    *Ptr++ |= ((Character >> 4) & 0x03);
-    *Ptr = ((Character & 0x3C) << 2);
-    Character = FromBase64Character(Str[Index++]);
-    *Ptr++ |= ((Character >> 2) & 0xF);
-    *Ptr = ((Character & 0x3) << 6);
-    *Ptr++ |= (FromBase64Character(Str[Index++]) & 0x3F);
-  }
-  // Decode the extra offset bytes
-  if (Offset == 1) {
-    *Ptr = ((FromBase64Character(Str[Index++]) & 0x3F) << 2);
-    Character = FromBase64Character(Str[Index++]);
-    *Ptr |= ((Character >> 4) & 0x03);
-  } else if (Offset == 2) {
-    *Ptr = ((FromBase64Character(Str[Index++]) & 0x3F) << 2);
-    Character = FromBase64Character(Str[Index++]);
-    *Ptr++ |= ((Character >> 4) & 0x03);
-    *Ptr = ((Character & 0x3C) << 2);
-    Character = FromBase64Character(Str[Index++]);
-    *Ptr |= ((Character >> 2) & 0xF);
-  }
-  FreePool(NewBase64);
-  // Return the data
-  *Size = (((Length / 4) * 3) + Offset);
-  *Data = Buffer;
-  return EFI_SUCCESS;
+  return FromBase64Internal((VOID *)Base64, Size, Data, TRUE);
+}
+// AsciiFromBase64Buffer
+/// Convert Base64 encoded ASCII string to data in a caller buffer
+/// @param Base64 The Base64 encoded ASCII string to convert
+/// @param Size   On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the data
+/// @param Data   The buffer for the decoded data
+/// @return Whether the Base64 encoded ASCII string was converted to data or not
+/// @retval EFI_INVALID_PARAMETER If Base64 or Size is NULL or the Base64 encoded ASCII string is invalid
+/// @retval EFI_BUFFER_TOO_SMALL  If Data is NULL or the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the Base64 ASCII string was converted to data successfully
+EFI_STATUS
+EFIAPI
+AsciiFromBase64Buffer (
+  IN     CHAR8 *Base64,
+  IN OUT UINTN *Size,
+  OUT    VOID  *Data OPTIONAL
+) {
+  return FromBase64BufferInternal((VOID *)Base64, Size, Data, TRUE);
+}
+// AsciiFromBase64Update
+/// Decode the next chunk of Base64 encoded ASCII characters, characters that are not Base64 are skipped and only
+///  whole groups are decoded, the remaining characters are kept in the context until the next chunk or FromBase64Final
+/// @param Context The Base64 context, a zeroed context is at the start of the data
+/// @param Length  The count of characters to decode
+/// @param Base64  The Base64 encoded ASCII characters to decode
+/// @param Size    On input, the size, in bytes, of the buffer, on output, the size, in bytes, of the decoded data
+/// @param Data    The buffer for the decoded data, which needs at most ((Context->Count + Length) / 4) * 3 bytes
+/// @return Whether the characters were decoded or not
+/// @retval EFI_INVALID_PARAMETER If Context or Size is NULL or Base64 is NULL and Length is not zero
+/// @retval EFI_BUFFER_TOO_SMALL  If the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the characters were decoded successfully
+EFI_STATUS
+EFIAPI
+AsciiFromBase64Update (
+  IN OUT BASE64_CONTEXT *Context,
+  IN     UINTN           Length,
+  IN     CHAR8          *Base64,
+  IN OUT UINTN          *Size,
+  OUT    VOID           *Data OPTIONAL
+) {
+  return FromBase64UpdateChecked(Context, Length, (VOID *)Base64, Size, Data, TRUE);
 }
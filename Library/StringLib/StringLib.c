@@ -5,11 +5,13 @@
 ///
 
 #include "Unicode.h"
+#include "CaseFolding.h"
 
 #include <Guid/GlobalVariable.h>
 
 #include <Protocol/UnicodeCollation.h>
 
+#include <Library/PrintLib.h>
 #include <Library/UefiLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/UefiBootServicesTableLib.h>
@@ -22,23 +24,98 @@
 #define MAP_TABLE_SIZE 0x100
 // TO_UPPER
 /// Convert character to upper case
-#define TO_UPPER(a) (CHAR16)(((a) <= 0xFF) ? mEngUpperMap[a] : (a))
+#define TO_UPPER(a) (CHAR16)(((a) <= 0xFF) ? mEngUpperMap[(a) & 0xFF] : (a))
 // TO_LOWER
 // Convert character to lower case
-#define TO_LOWER(a) (CHAR16)(((a) <= 0xFF) ? mEngLowerMap[a] : (a))
+#define TO_LOWER(a) (CHAR16)(((a) <= 0xFF) ? mEngLowerMap[(a) & 0xFF] : (a))
+// TO_FOLDED
+/// Fold the case of a character for case-insensitive comparison with simple case folding, which does not need a table for
+///  basic latin, every language folds the same way so sorted lists and hashes do not depend on the current language
+#define TO_FOLDED(a) (CHAR16)(((CHAR16)(a) < 0x80) ? ((((CHAR16)(a) >= L'A') && ((CHAR16)(a) <= L'Z')) ? ((a) | 0x20) : (a)) : CASE_FOLD(a))
+// ASCII_TO_FOLDED
+/// Fold the case of an ASCII character for case-insensitive comparison, characters above 0x7F are latin-1
+#define ASCII_TO_FOLDED(a) TO_FOLDED((UINT8)(a))
+// STR_WORD_ACCESS
+/// Whether strings of unknown length are read a word at a time, aligned words never cross a page but may be read past the
+///  null-terminator, which is outside the object and reported by the sanitizers so characters are read one at a time instead
+#if !defined(STR_WORD_ACCESS)
+# if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#  define STR_WORD_ACCESS 0
+# elif defined(__has_feature)
+#  if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer) || __has_feature(thread_sanitizer)
+#   define STR_WORD_ACCESS 0
+#  endif
+# endif
+# if !defined(STR_WORD_ACCESS)
+#  define STR_WORD_ACCESS 1
+# endif
+#endif
+// STR_WORD_MASK
+/// The mask of the address bits below word alignment
+#define STR_WORD_MASK (sizeof(UINTN) - 1)
+// STR_WORD_CHARS
+/// The count of characters in a word
+#define STR_WORD_CHARS (sizeof(UINTN) / sizeof(CHAR16))
+// STR_WORD_ONES
+/// A word with the value one in every character
+#define STR_WORD_ONES (MAX_UINTN / 0xFFFF)
+// STR_WORD_HAS_NULL
+/// Check whether a word has a null character
+#define STR_WORD_HAS_NULL(Word) ((((Word) - STR_WORD_ONES) & ~(Word) & (STR_WORD_ONES << 15)) != 0)
+// STR_WORD_IS_LATIN1
+/// Check whether every character in a word is latin-1
+#define STR_WORD_IS_LATIN1(Word) (((Word) & (STR_WORD_ONES * 0xFF00)) == 0)
+// STR_WORD_IS_ASCII
+/// Check whether every character in a word is ASCII
+#define STR_WORD_IS_ASCII(Word) (((Word) & (STR_WORD_ONES * 0xFF80)) == 0)
+// ASCII_WORD_CHARS
+/// The count of ASCII characters in a word
+#define ASCII_WORD_CHARS sizeof(UINTN)
+// ASCII_WORD_ONES
+/// A word with the value one in every ASCII character
+#define ASCII_WORD_ONES (MAX_UINTN / 0xFF)
+// ASCII_WORD_HAS_NULL
+/// Check whether a word has a null ASCII character
+#define ASCII_WORD_HAS_NULL(Word) ((((Word) - ASCII_WORD_ONES) & ~(Word) & (ASCII_WORD_ONES << 7)) != 0)
+// ASCII_WORD_IS_ASCII
+/// Check whether every character in a word is seven bit ASCII
+#define ASCII_WORD_IS_ASCII(Word) (((Word) & (ASCII_WORD_ONES * 0x80)) == 0)
 // DEFAULT_LANGUAGE
 /// Default language - English
 #define DEFAULT_LANGUAGE "en"
 
+// COLLATION_LANGUAGE
+/// Collation protocol discovered for a language
+typedef struct _COLLATION_LANGUAGE COLLATION_LANGUAGE;
+struct _COLLATION_LANGUAGE {
+
+  // Next
+  /// The next collation language
+  COLLATION_LANGUAGE             *Next;
+  // Language
+  /// The requested language code
+  CHAR8                          *Language;
+  // Protocol
+  /// The collation protocol that supports the language
+  EFI_UNICODE_COLLATION_PROTOCOL *Protocol;
+
+};
+
 // mCollationProtocol
 /// Unicode collation protocol
 STATIC EFI_UNICODE_COLLATION_PROTOCOL *mCollationProtocol = NULL;
+// mCollationLanguages
+/// The collation protocols already discovered for requested languages
+STATIC COLLATION_LANGUAGE             *mCollationLanguages = NULL;
+// mPlatformLanguages
+/// The cached supported platform languages or NULL if not retrieved yet
+STATIC CHAR8                          *mPlatformLanguages = NULL;
 // mEngUpperMap
 /// Character map used for converting to upper case
-STATIC CHAR8  mEngUpperMap[MAP_TABLE_SIZE];
+STATIC UINT8  mEngUpperMap[MAP_TABLE_SIZE];
 // mEngLowerMap
 /// Character map used for converting to lower case
-STATIC CHAR8  mEngLowerMap[MAP_TABLE_SIZE];
+STATIC UINT8  mEngLowerMap[MAP_TABLE_SIZE];
 // mEngInfoMap
 /// Character map used for FAT conversion
 STATIC CHAR8  mEngInfoMap[MAP_TABLE_SIZE];
@@ -101,6 +178,65 @@ IsUnicodeCharacter (
   return FALSE;
 }
 
+// StrWordLength
+/// Get the length of a string, a word of characters at a time once the string is aligned if word access is enabled
+/// @param String The string
+/// @return The count of characters in the string
+STATIC UINTN
+EFIAPI
+StrWordLength (
+  IN CHAR16 *String
+) {
+  CHAR16 *Start = String;
+#if STR_WORD_ACCESS
+  // Count characters until the string is aligned
+  while (((UINTN)String & STR_WORD_MASK) != 0) {
+    if (*String == L'\0') {
+      return (UINTN)(String - Start);
+    }
+    ++String;
+  }
+  // Skip words without a null-terminator
+  while (!STR_WORD_HAS_NULL(*(UINTN *)String)) {
+    String += STR_WORD_CHARS;
+  }
+#endif
+  // Find the null-terminator
+  while (*String != L'\0') {
+    ++String;
+  }
+  return (UINTN)(String - Start);
+}
+// AsciiStrWordLength
+/// Get the length of a string, a word of characters at a time once the string is aligned if word access is enabled
+/// @param String The string
+/// @return The count of characters in the string
+STATIC UINTN
+EFIAPI
+AsciiStrWordLength (
+  IN CHAR8 *String
+) {
+  CHAR8 *Start = String;
+#if STR_WORD_ACCESS
+  // Count characters until the string is aligned
+  while (((UINTN)String & STR_WORD_MASK) != 0) {
+    if (*String == '\0') {
+      return (UINTN)(String - Start);
+    }
+    ++String;
+  }
+  // Skip words without a null-terminator
+  while (!ASCII_WORD_HAS_NULL(*(UINTN *)String)) {
+    String += ASCII_WORD_CHARS;
+  }
+#endif
+  // Find the null-terminator
+  while (*String != '\0') {
+    ++String;
+  }
+  return (UINTN)(String - Start);
+}
+
 // StrDup
 /// Duplicate a string
 /// @param Str The string to duplicate
@@ -184,20 +320,28 @@ StriCmp (
   } else if (Str2 == NULL) {
     return 1;
   }
-  // Use collation protocol if present
-  if ((mCollationProtocol != NULL) && (mCollationProtocol->StriColl != NULL)) {
-    return mCollationProtocol->StriColl(mCollationProtocol, Str1, Str2);
-  }
-  // Fallback to english collation
+  // Compare the folded characters
   while (*Str1 != 0) {
-    if (TO_UPPER(*Str1) != TO_UPPER(*Str2)) {
+#if STR_WORD_ACCESS
+    // Skip words of identical characters while both strings are aligned
+    if ((((UINTN)Str1 | (UINTN)Str2) & STR_WORD_MASK) == 0) {
+      while ((*(UINTN *)Str1 == *(UINTN *)Str2) && !STR_WORD_HAS_NULL(*(UINTN *)Str1)) {
+        Str1 += STR_WORD_CHARS;
+        Str2 += STR_WORD_CHARS;
+      }
+      if (*Str1 == 0) {
+        break;
+      }
+    }
+#endif
+    if (TO_FOLDED(*Str1) != TO_FOLDED(*Str2)) {
       break;
     }
 
     ++Str1;
     ++Str2;
   }
-  return TO_UPPER(*Str1) - TO_UPPER(*Str2);
+  return TO_FOLDED(*Str1) - TO_FOLDED(*Str2);
 }
 // StrniCmp
 /// Performs a case-insensitive comparison of two strings
@@ -226,11 +370,27 @@ StrniCmp (
   } else if (Str2 == NULL) {
     return 1;
   }
-  while ((*Str1 != L'\0') && (TO_UPPER(*Str1) == TO_UPPER(*Str2)) && (Count-- > 1)) {
+  while (*Str1 != L'\0') {
+#if STR_WORD_ACCESS
+    // Skip words of identical characters while both strings are aligned
+    if ((((UINTN)Str1 | (UINTN)Str2) & STR_WORD_MASK) == 0) {
+      while ((Count > STR_WORD_CHARS) && (*(UINTN *)Str1 == *(UINTN *)Str2) && !STR_WORD_HAS_NULL(*(UINTN *)Str1)) {
+        Str1 += STR_WORD_CHARS;
+        Str2 += STR_WORD_CHARS;
+        Count -= STR_WORD_CHARS;
+      }
+      if (*Str1 == L'\0') {
+        break;
+      }
+    }
+#endif
+    if ((TO_FOLDED(*Str1) != TO_FOLDED(*Str2)) || (Count-- <= 1)) {
+      break;
+    }
     ++Str1;
     ++Str2;
   }
-  return TO_UPPER(*Str1) - TO_UPPER(*Str2);
+  return TO_FOLDED(*Str1) - TO_FOLDED(*Str2);
 }
 
 // StriColl
@@ -246,6 +406,7 @@ StriColl (
   IN CHAR16 *Str1,
   IN CHAR16 *Str2
 ) {
+  INTN Result;
   if (Str1 == NULL) {
     if (Str2 == NULL) {
       return 0;
@@ -254,25 +415,60 @@ StriColl (
   } else if (Str2 == NULL) {
     return 1;
   }
-  // Use collation protocol if present
-  if ((mCollationProtocol != NULL) && (mCollationProtocol->StriColl != NULL)) {
-    INTN Result = mCollationProtocol->StriColl(mCollationProtocol, Str1, Str2);
-    if (Result == 0) {
-      Result = StrCmp(Str1, Str2);
-    }
-    return Result;
+  // Order by the folded characters first so strings equal to StriCmp are adjacent
+  Result = StriCmp(Str1, Str2);
+  if (Result == 0) {
+    Result = StrCmp(Str1, Str2);
   }
-  // Fallback to english collation
-  while (*Str1 != 0) {
-    if ((TO_UPPER(*Str1) != TO_UPPER(*Str2)) || (*Str1 != *Str2)) {
+  return Result;
+}
+// MetaiMatchSet
+/// Match a character against a pattern character set
+/// @param Character The character to match
+/// @param Pattern   On input, the pattern after the opening bracket, on output, the pattern after the set
+/// @return Whether the character is in the set or not, a set with a syntax problem matches no character
+STATIC BOOLEAN
+EFIAPI
+MetaiMatchSet (
+  IN     CHAR16   Character,
+  IN OUT CHAR16 **Pattern
+) {
+  CHAR16  *Ptr = *Pattern;
+  CHAR16   CharP;
+  CHAR16   Previous = 0;
+  BOOLEAN  Match = FALSE;
+  // Check each character or range of the set
+  while ((CharP = *Ptr) != 0) {
+    ++Ptr;
+    if (CharP == ']') {
       break;
     }
-
-    ++Str1;
-    ++Str2;
+    if (CharP == '-') {
+      // If range of chars, get high range
+      CharP = *Ptr;
+      if ((CharP == 0) || (CharP == ']')) {
+        // Syntax problem
+        Match = FALSE;
+        break;
+      }
+      if ((TO_FOLDED(Character) >= TO_FOLDED(Previous)) && (TO_FOLDED(Character) <= TO_FOLDED(CharP))) {
+        // If in range, it's a match
+        Match = TRUE;
+      }
+      ++Ptr;
+    }
+    Previous = CharP;
+    if (TO_FOLDED(Character) == TO_FOLDED(CharP)) {
+      // If char matches
+      Match = TRUE;
+    }
   }
-
-  return *Str1 - *Str2;
+  // An unterminated set is a syntax problem
+  if (CharP == 0) {
+    Match = FALSE;
+  }
+  *Pattern = Ptr;
+  return Match;
 }
 // MetaiMatch
 /// Performs a case-insensitive comparison of a pattern string and a string
@@ -286,118 +482,365 @@ MetaiMatch (
   IN CHAR16 *String,
   IN CHAR16 *Pattern
 ) {
-  CHAR16  CharC;
-  CHAR16  CharP;
-  CHAR16  Index3;
+  CHAR16  *StarPattern = NULL;
+  CHAR16  *StarString = NULL;
+  CHAR16   CharP;
+  BOOLEAN  Match;
 
   if ((String == NULL) || (Pattern == NULL)) {
     return FALSE;
   }
 
-  // Use collation protocol if present
-  if ((mCollationProtocol != NULL) && (mCollationProtocol->MetaiMatch != NULL)) {
-    return mCollationProtocol->MetaiMatch(mCollationProtocol, String, Pattern);
-  }
-  // Fallback to english collation
-  while ((CharP = *Pattern++) != '\0') {
-
-    switch (CharP) {
-
-    case '*':
-      //
+  // Compare the folded characters, remember the last star and where it started matching in the string so a
+  //  mismatch only retries the last star with one more character instead of recursing for every star
+  while (TRUE) {
+    CharP = *Pattern;
+    if (CharP == '*') {
       // Match zero or more chars
-      //
-      while (*String != 0) {
-        if (MetaiMatch(String, Pattern)) {
-          return TRUE;
-        }
-
-        ++String;
-      }
-
-      return MetaiMatch(String, Pattern);
-
-    case '?':
-      //
+      StarPattern = ++Pattern;
+      StarString = String;
+      continue;
+    }
+    if (CharP == 0) {
+      Match = (*String == 0);
+    } else if (*String == 0) {
+      Match = FALSE;
+    } else if (CharP == '?') {
       // Match any one char
-      //
-      if (*String == 0) {
-        return FALSE;
+      Match = TRUE;
+      ++Pattern;
+    } else if (CharP == '[') {
+      // Match char set
+      ++Pattern;
+      Match = MetaiMatchSet(*String, &Pattern);
+    } else {
+      Match = (TO_FOLDED(*String) == TO_FOLDED(CharP));
+      ++Pattern;
+    }
+    if (Match) {
+      if (CharP == 0) {
+        return TRUE;
       }
-
       ++String;
-      break;
+      continue;
+    }
+    // Retry the last star with one more character
+    if ((StarPattern == NULL) || (*StarString == 0)) {
+      return FALSE;
+    }
+    Pattern = StarPattern;
+    String = ++StarString;
+  }
+}
 
-    case '[':
-      //
-      // Match char set
-      //
-      CharC = *String;
-      if (CharC == 0) {
-        //
-        // syntax problem
-        //
-        return FALSE;
-      }
+// META_ELEMENT_CHARACTER
+/// Compiled pattern element that matches a folded character
+#define META_ELEMENT_CHARACTER 0
+// META_ELEMENT_ANY
+/// Compiled pattern element that matches any character
+#define META_ELEMENT_ANY 1
+// META_ELEMENT_SET
+/// Compiled pattern element that matches a character in a set of folded ranges
+#define META_ELEMENT_SET 2
+// META_CHARACTER
+/// Get a character of a string that is either ASCII or unicode
+#define META_CHARACTER(String, Index, Ascii) ((Ascii) ? (CHAR16)(UINT8)(((CHAR8 *)(String))[Index]) : ((CHAR16 *)(String))[Index])
+
+// META_ELEMENT
+/// Compiled pattern element
+typedef struct _META_ELEMENT META_ELEMENT;
+struct _META_ELEMENT {
+
+  // Type
+  /// The type of element
+  UINTN  Type;
+  // Character
+  /// The folded character for a character element
+  CHAR16 Character;
+  // Start
+  /// The index of the first range of a set element
+  UINTN  Start;
+  // Count
+  /// The count of ranges of a set element
+  UINTN  Count;
 
-      Index3  = 0;
-      CharP   = *Pattern++;
-      while (CharP != 0) {
-        if (CharP == ']') {
-          return FALSE;
-        }
+};
+// META_PATTERN
+/// Compiled pattern
+struct _META_PATTERN {
+
+  // SegmentCount
+  /// The count of segments, segments are separated by stars so there is one more segment than stars
+  UINTN         SegmentCount;
+  // ElementCount
+  /// The count of elements of all segments
+  UINTN         ElementCount;
+  // Segments
+  /// The count of elements in each segment
+  UINTN        *Segments;
+  // Elements
+  /// The elements of all segments
+  META_ELEMENT *Elements;
+  // Ranges
+  /// The folded low and high characters of the ranges of all set elements
+  CHAR16       *Ranges;
 
-        if (CharP == '-') {
-          //
-          // if range of chars, get high range
-          //
-          CharP = *Pattern;
-          if (CharP == 0 || CharP == ']') {
-            //
-            // syntax problem
-            //
-            return FALSE;
-          }
+};
 
-          if ((TO_UPPER(CharC) >= TO_UPPER(Index3)) && (TO_UPPER(CharC) <= TO_UPPER(CharP))) {
-            //
-            // if in range, it's a match
-            //
-            break;
-          }
+// MetaiCompileInternal
+/// Compile a pattern string
+/// @param Compiled On output, the compiled pattern, which must be freed with MetaiFreeCompiled
+/// @param Pattern  The pattern string
+/// @param Ascii    Whether the pattern string is ASCII or unicode
+/// @return Whether the pattern was compiled or not
+/// @retval EFI_INVALID_PARAMETER If Compiled or Pattern is NULL, *Compiled is not NULL, or a character set has a syntax problem
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the compiled pattern
+/// @retval EFI_SUCCESS           If the pattern was compiled successfully
+STATIC EFI_STATUS
+EFIAPI
+MetaiCompileInternal (
+  OUT META_PATTERN **Compiled,
+  IN  VOID          *Pattern,
+  IN  BOOLEAN        Ascii
+) {
+  META_PATTERN *Result;
+  META_ELEMENT *Element;
+  UINTN         Length;
+  UINTN         Index;
+  UINTN         ElementCount = 0;
+  UINTN         RangeCount = 0;
+  CHAR16        CharP;
+  CHAR16        Previous;
+  // Check parameters
+  if ((Compiled == NULL) || (*Compiled != NULL) || (Pattern == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Allocate for the most elements and ranges the pattern could have, every character could be a segment or
+  //  two ranges, the segment counts, elements and ranges follow the pattern in order of alignment
+  Length = Ascii ? AsciiStrWordLength((CHAR8 *)Pattern) : StrWordLength((CHAR16 *)Pattern);
+  Result = (META_PATTERN *)AllocateZeroPool(sizeof(META_PATTERN) + ((Length + 1) * sizeof(UINTN)) +
+                                            (Length * sizeof(META_ELEMENT)) + (Length * 4 * sizeof(CHAR16)));
+  if (Result == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Result->Segments = (UINTN *)(Result + 1);
+  Result->Elements = (META_ELEMENT *)(Result->Segments + Length + 1);
+  Result->Ranges = (CHAR16 *)(Result->Elements + Length);
+  Result->SegmentCount = 1;
+  // Parse each element of the pattern
+  for (Index = 0; Index < Length; ++Index) {
+    CharP = META_CHARACTER(Pattern, Index, Ascii);
+    if (CharP == '*') {
+      // Start a new segment
+      ++(Result->SegmentCount);
+      continue;
+    }
+    Element = Result->Elements + ElementCount++;
+    ++(Result->Segments[Result->SegmentCount - 1]);
+    if (CharP == '?') {
+      Element->Type = META_ELEMENT_ANY;
+    } else if (CharP != '[') {
+      Element->Type = META_ELEMENT_CHARACTER;
+      Element->Character = TO_FOLDED(CharP);
+    } else {
+      // Each character of the set is a range of one character, a range also includes its high character
+      Element->Type = META_ELEMENT_SET;
+      Element->Start = RangeCount;
+      Previous = 0;
+      while (TRUE) {
+        if (++Index >= Length) {
+          // Unterminated set
+          FreePool(Result);
+          return EFI_INVALID_PARAMETER;
         }
-
-        Index3 = CharP;
-        if (TO_UPPER(CharC) == TO_UPPER(CharP)) {
-          //
-          // if char matches
-          //
+        CharP = META_CHARACTER(Pattern, Index, Ascii);
+        if (CharP == ']') {
           break;
         }
-
-        CharP = *Pattern++;
+        if (CharP == '-') {
+          if ((++Index >= Length) || ((CharP = META_CHARACTER(Pattern, Index, Ascii)) == ']')) {
+            // Range without high character
+            FreePool(Result);
+            return EFI_INVALID_PARAMETER;
+          }
+          Result->Ranges[RangeCount << 1] = TO_FOLDED(Previous);
+          Result->Ranges[(RangeCount << 1) + 1] = TO_FOLDED(CharP);
+          ++RangeCount;
+        }
+        Previous = CharP;
+        Result->Ranges[RangeCount << 1] = Result->Ranges[(RangeCount << 1) + 1] = TO_FOLDED(CharP);
+        ++RangeCount;
       }
-      //
-      // skip to end of match char set
-      //
-      while ((CharP != 0) && (CharP != ']')) {
-        CharP = *Pattern++;
+      Element->Count = RangeCount - Element->Start;
+      if (Element->Count == 0) {
+        // Empty set
+        FreePool(Result);
+        return EFI_INVALID_PARAMETER;
       }
-
-      ++String;
-      break;
-
-    default:
-      CharC = *String;
-      if (TO_UPPER(CharC) != TO_UPPER(CharP)) {
+    }
+  }
+  Result->ElementCount = ElementCount;
+  *Compiled = Result;
+  return EFI_SUCCESS;
+}
+// MetaiMatchSegment
+/// Match a compiled pattern segment at a position in a string
+/// @param Compiled The compiled pattern
+/// @param Elements The elements of the segment
+/// @param Count    The count of elements of the segment
+/// @param String   The string at the position to match
+/// @param Ascii    Whether the string is ASCII or unicode
+/// @return Whether the segment matched or not, the string must have at least as many characters as the segment
+STATIC BOOLEAN
+EFIAPI
+MetaiMatchSegment (
+  IN META_PATTERN *Compiled,
+  IN META_ELEMENT *Elements,
+  IN UINTN         Count,
+  IN VOID         *String,
+  IN BOOLEAN       Ascii
+) {
+  CHAR16 *Range;
+  CHAR16  Character;
+  UINTN   Index;
+  UINTN   Remaining;
+  for (Index = 0; Index < Count; ++Index) {
+    if (Elements[Index].Type == META_ELEMENT_ANY) {
+      continue;
+    }
+    Character = TO_FOLDED(META_CHARACTER(String, Index, Ascii));
+    if (Elements[Index].Type == META_ELEMENT_CHARACTER) {
+      if (Character != Elements[Index].Character) {
         return FALSE;
       }
-
-      ++String;
-      break;
+      continue;
+    }
+    // Check each range of the set
+    Range = Compiled->Ranges + (Elements[Index].Start << 1);
+    for (Remaining = Elements[Index].Count; Remaining > 0; --Remaining, Range += 2) {
+      if ((Character >= Range[0]) && (Character <= Range[1])) {
+        break;
+      }
+    }
+    if (Remaining == 0) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+// MetaiMatchCompiledInternal
+/// Match a compiled pattern without backtracking, the first segment must match the start of the string and the last
+///  segment must match the end, each segment in between matches at the first position after the previous segment
+/// @param Compiled The compiled pattern
+/// @param String   The string to match
+/// @param Ascii    Whether the string is ASCII or unicode
+/// @retval TRUE  Pattern was found in String
+/// @retval FALSE Pattern was not found in String
+STATIC BOOLEAN
+EFIAPI
+MetaiMatchCompiledInternal (
+  IN META_PATTERN *Compiled,
+  IN VOID         *String,
+  IN BOOLEAN       Ascii
+) {
+  META_ELEMENT *Elements;
+  UINTN         Length;
+  UINTN         Start;
+  UINTN         End;
+  UINTN         Count;
+  UINTN         Index;
+  // Check parameters
+  if ((Compiled == NULL) || (String == NULL)) {
+    return FALSE;
+  }
+  Length = Ascii ? AsciiStrWordLength((CHAR8 *)String) : StrWordLength((CHAR16 *)String);
+  Elements = Compiled->Elements;
+  Count = Compiled->Segments[0];
+  // Without stars the only segment must match the whole string
+  if (Compiled->SegmentCount == 1) {
+    return (Length == Count) && MetaiMatchSegment(Compiled, Elements, Count, String, Ascii);
+  }
+  // Match the first segment to the start of the string
+  if ((Count > Length) || !MetaiMatchSegment(Compiled, Elements, Count, String, Ascii)) {
+    return FALSE;
+  }
+  Start = Count;
+  Elements += Count;
+  // Match the last segment to the end of the string
+  Count = Compiled->Segments[Compiled->SegmentCount - 1];
+  if ((Count > (Length - Start)) ||
+      !MetaiMatchSegment(Compiled, Compiled->Elements + (Compiled->ElementCount - Count), Count,
+                         Ascii ? (VOID *)((CHAR8 *)String + (Length - Count)) : (VOID *)((CHAR16 *)String + (Length - Count)), Ascii)) {
+    return FALSE;
+  }
+  End = Length - Count;
+  // Match each segment in between at the first position it matches
+  for (Index = 1; Index < (Compiled->SegmentCount - 1); ++Index) {
+    Count = Compiled->Segments[Index];
+    while (TRUE) {
+      if (Count > (End - Start)) {
+        return FALSE;
+      }
+      if (MetaiMatchSegment(Compiled, Elements, Count, Ascii ? (VOID *)((CHAR8 *)String + Start) : (VOID *)((CHAR16 *)String + Start), Ascii)) {
+        break;
+      }
+      ++Start;
     }
+    Start += Count;
+    Elements += Count;
+  }
+  return TRUE;
+}
+
+// MetaiCompile
+/// Compile a pattern string for repeated case-insensitive matching
+/// @param Compiled On output, the compiled pattern, which must be freed with MetaiFreeCompiled
+/// @param Pattern  The pattern string
+/// @return Whether the pattern was compiled or not
+/// @retval EFI_INVALID_PARAMETER If Compiled or Pattern is NULL, *Compiled is not NULL, or a character set has a syntax problem
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the compiled pattern
+/// @retval EFI_SUCCESS           If the pattern was compiled successfully
+EFI_STATUS
+EFIAPI
+MetaiCompile (
+  OUT META_PATTERN **Compiled,
+  IN  CHAR16        *Pattern
+) {
+  return MetaiCompileInternal(Compiled, (VOID *)Pattern, FALSE);
+}
+// MetaiMatchCompiled
+/// Performs a case-insensitive comparison of a compiled pattern and a string in time linear in the string length
+///  for each segment between stars
+/// @param Compiled The compiled pattern
+/// @param String   A pointer to a string
+/// @retval TRUE  Pattern was found in String
+/// @retval FALSE Pattern was not found in String
+BOOLEAN
+EFIAPI
+MetaiMatchCompiled (
+  IN META_PATTERN *Compiled,
+  IN CHAR16       *String
+) {
+  return MetaiMatchCompiledInternal(Compiled, (VOID *)String, FALSE);
+}
+// MetaiFreeCompiled
+/// Free a compiled pattern
+/// @param Compiled The compiled pattern to free
+/// @return Whether the compiled pattern was freed or not
+/// @retval EFI_INVALID_PARAMETER If Compiled is NULL
+/// @retval EFI_SUCCESS           If the compiled pattern was freed successfully
+EFI_STATUS
+EFIAPI
+MetaiFreeCompiled (
+  IN META_PATTERN *Compiled
+) {
+  // Check parameters
+  if (Compiled == NULL) {
+    return EFI_INVALID_PARAMETER;
   }
-  return (*String == L'\0');
+  // The segments, elements and ranges are in the same allocation
+  FreePool(Compiled);
+  return EFI_SUCCESS;
 }
 
 // StrLwr
@@ -488,6 +931,12 @@ StriStr (
   IN CHAR16 *String,
   IN CHAR16 *SearchString
 ) {
+  UINT8 Shift[0x100];
+  UINTN StringLen;
+  UINTN SearchLen;
+  UINTN Offset;
+  UINTN Index;
+  UINTN Last;
   // Check parameters
   if (String == NULL) {
     return NULL;
@@ -495,56 +944,28 @@ StriStr (
   if ((SearchString == NULL) || (*SearchString == L'\0')) {
     return String;
   }
+  StringLen = StrWordLength(String);
+  SearchLen = StrWordLength(SearchString);
+  if (StringLen < SearchLen) {
+    return NULL;
+  }
 
-  // Use collation protocol if present
-  if (mCollationProtocol != NULL) {
-    UINTN StringLen = StrLen(String);
-    UINTN SearchLen = StrLen(SearchString);
-    INTN  Result;
-
-    // Iterate through string for matches
-    while ((StringLen >= SearchLen) && (*String != L'\0')) {
-      // Duplicate substring
-      CHAR16 *SubString = StrnDup(String, SearchLen);
-      if (SubString == NULL) {
-        break;
-      }
-      // Check for match
-      Result = StriCmp(SubString, SearchString);
-      // Free substring
-      FreePool(SubString);
-      // Return this substring if match
-      if (Result == 0) {
-        return String;
-      }
-      // Advance string and decrement remaining string length
-      ++String;
-      --StringLen;
-    }
-  } else {
-    // Fallback to english collation
-
-    // Iterate through string for matches
-    while (*String != L'\0') {
-      CHAR16 *SearchStringTmp = SearchString;
-      CHAR16 *FirstMatch = String;
-
-      // Check for match
-      while ((TO_UPPER(*String) == TO_UPPER(*SearchStringTmp)) && (*String != L'\0')) {
-        ++String;
-        ++SearchStringTmp;
-      }
-
-      if (*SearchStringTmp == L'\0') {
+  // Boyer-Moore-Horspool search of the folded characters, the shift table is indexed by the low byte of the
+  //  folded character so characters that share a low byte use the smallest shift of any of them
+  Last = SearchLen - 1;
+  SetMem(Shift, sizeof(Shift), (UINT8)((SearchLen < 0xFF) ? SearchLen : 0xFF));
+  for (Index = 0; Index < Last; ++Index) {
+    Shift[TO_FOLDED(SearchString[Index]) & 0xFF] = (UINT8)(((Last - Index) < 0xFF) ? (Last - Index) : 0xFF);
+  }
+  // Compare from the end of the search string at each alignment
+  for (Offset = 0; Offset <= (StringLen - SearchLen); Offset += Shift[TO_FOLDED(String[Offset + Last]) & 0xFF]) {
+    Index = Last;
+    while (TO_FOLDED(String[Offset + Index]) == TO_FOLDED(SearchString[Index])) {
+      if (Index == 0) {
         // Found
-        return FirstMatch;
-      }
-      if (*String == L'\0') {
-        // Not found
-        return NULL;
+        return String + Offset;
       }
-
-      String = FirstMatch + 1;
+      --Index;
     }
   }
   // Not found
@@ -569,101 +990,869 @@ StrAppend (
   IN OUT UINTN   *Size,
   IN     UINT32   Character
 ) {
-  CHAR16 *Str;
-  UINTN   NewCount;
-  UINTN   NewSize;
+  EFI_STATUS  Status;
+  STR_BUILDER Builder;
   // Check parameters
-  if ((String == NULL) || (Count == NULL) || (Size == NULL) || !IsUnicodeCharacter(Character)) {
+  if ((String == NULL) || (Count == NULL) || (Size == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
   // Get the string information
-  Str = *String;
-  NewCount = *Count;
-  NewSize = *Size;
+  Builder.Buffer = *String;
+  Builder.Count = *Count;
+  Builder.Size = *Size;
   // Check if bounds are sane
-  if (NewCount >= NewSize) {
-    NewSize = NewCount = 0;
-  }
-  // Check if the string needs reallocated
-  if ((Str == NULL) || (NewSize == 0) || ((NewSize - NewCount) < 3)) {
-    CHAR16 *NewStr;
-    // Check the buffer size is valid
-    if (NewSize == 0) {
-      NewSize = 4;
-    }
-    // Increase the buffer size
-    while (((NewSize <<= 1) - NewCount) < 3);
-    // Reallocate the buffer
-    NewStr = (CHAR16 *)AllocateZeroPool(NewSize * sizeof(CHAR16));
-    if (NewStr == NULL) {
-      return EFI_OUT_OF_RESOURCES;
-    }
-    if (Str != NULL) {
-      if (NewCount > 0) {
-        CopyMem(NewStr, Str, NewCount * sizeof(CHAR16));
-      }
-      FreePool(Str);
-    }
-    *String = Str = NewStr;
-    *Size = NewSize;
+  if ((Builder.Buffer == NULL) || (Builder.Count >= Builder.Size)) {
+    Builder.Size = Builder.Count = 0;
+  }
+  // Append the character
+  Status = StrBuilderAppendCharacter(&Builder, Character);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  *String = Builder.Buffer;
+  *Count = Builder.Count;
+  *Size = Builder.Size;
+  return EFI_SUCCESS;
+}
+
+// StrBuilderReserve
+/// Reserve space in a string builder, the allocated size at least doubles when it grows
+/// @param Builder The string builder
+/// @param Count   The count of characters that must fit after the current string, excluding the null-terminator
+/// @return Whether the space was reserved or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the space was reserved successfully
+EFI_STATUS
+EFIAPI
+StrBuilderReserve (
+  IN OUT STR_BUILDER *Builder,
+  IN     UINTN        Count
+) {
+  CHAR16 *Buffer;
+  UINTN   NewSize;
+  // Check parameters
+  if (Builder == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Check if the characters and the null-terminator already fit
+  if ((Builder->Buffer != NULL) && (Builder->Count < Builder->Size) && ((Builder->Size - Builder->Count) > Count)) {
+    return EFI_SUCCESS;
+  }
+  if (Builder->Buffer == NULL) {
+    Builder->Count = Builder->Size = 0;
+  }
+  // Check the size does not overflow
+  if (Count >= ((MAX_UINTN / sizeof(CHAR16)) - Builder->Count)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Grow geometrically so appending is amortized constant time
+  NewSize = Builder->Size << 1;
+  if (NewSize < STR_BUILDER_MIN_SIZE) {
+    NewSize = STR_BUILDER_MIN_SIZE;
+  }
+  if (NewSize <= (Builder->Count + Count)) {
+    NewSize = Builder->Count + Count + 1;
+  }
+  // Only the string is copied and the new space is not zeroed
+  Buffer = (CHAR16 *)ReallocatePool((Builder->Buffer == NULL) ? 0 : ((Builder->Count + 1) * sizeof(CHAR16)), NewSize * sizeof(CHAR16), Builder->Buffer);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Buffer[Builder->Count] = L'\0';
+  Builder->Buffer = Buffer;
+  Builder->Size = NewSize;
+  return EFI_SUCCESS;
+}
+// StrBuilderAppend
+/// Append characters to a string builder
+/// @param Builder The string builder
+/// @param String  The characters to append
+/// @param Count   The count of characters to append
+/// @return Whether the characters were appended or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL or String is NULL and Count is not zero
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the characters were appended successfully
+EFI_STATUS
+EFIAPI
+StrBuilderAppend (
+  IN OUT STR_BUILDER *Builder,
+  IN     CHAR16      *String,
+  IN     UINTN        Count
+) {
+  EFI_STATUS Status;
+  // Check parameters
+  if ((Builder == NULL) || ((String == NULL) && (Count != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Count == 0) {
+    return EFI_SUCCESS;
+  }
+  // Reserve space for the characters
+  Status = StrBuilderReserve(Builder, Count);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Append the characters
+  CopyMem(Builder->Buffer + Builder->Count, String, Count * sizeof(CHAR16));
+  Builder->Count += Count;
+  Builder->Buffer[Builder->Count] = L'\0';
+  return EFI_SUCCESS;
+}
+// StrBuilderAppendCharacter
+/// Append a character to a string builder, characters outside the basic multilingual plane are appended as surrogate pairs
+/// @param Builder   The string builder
+/// @param Character The character to append
+/// @return Whether the character was appended or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL or Character is invalid
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the character was appended successfully
+EFI_STATUS
+EFIAPI
+StrBuilderAppendCharacter (
+  IN OUT STR_BUILDER *Builder,
+  IN     UINT32       Character
+) {
+  EFI_STATUS  Status;
+  CHAR16     *Str;
+  // Check parameters
+  if ((Builder == NULL) || !IsUnicodeCharacter(Character)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Reserve space for the character or surrogate pair
+  Status = StrBuilderReserve(Builder, (Character >= 0x10000) ? 2 : 1);
+  if (EFI_ERROR(Status)) {
+    return Status;
   }
   // Get offset into string to place character
-  Str += NewCount;
+  Str = Builder->Buffer + Builder->Count;
   // Check if surrogate pairs needed
   if (Character >= 0x10000) {
     // Append the surrogate pairs
-    *Str++ = (0xD800 | ((Character >> 10) & 0x3FF));
+    *Str++ = (0xD800 | (((Character - 0x10000) >> 10) & 0x3FF));
     *Str++ = (0xDC00 | (Character & 0x3FF));
-    *Str = L'\0';
-    *Count = NewCount + 2;
-    return EFI_SUCCESS;
+    Builder->Count += 2;
+  } else {
+    // Append character
+    *Str++ = (CHAR16)Character;
+    ++(Builder->Count);
   }
-  // Append character
-  *Str++ = (CHAR16)Character;
   *Str = L'\0';
-  *Count = NewCount + 1;
   return EFI_SUCCESS;
 }
-
-// StrSplit
-/// Split a string into a list
-/// @param List    On output, the string list, which must be freed with StrListFree
-/// @param Count   On output, the count of strings in the list
-/// @param Str     The string to split
-/// @param Split   The string that splits
-/// @param Options The options for the string list
-/// @return Whether the string was split or not
-/// @retval EFI_INVALID_PARAMETER If List, Count, Str, or Split is NULL or *List is not NULL
-/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string list
-/// @retval EFI_NOT_FOUND         If the split string could not be found
-/// @retval EFI_SUCCESS           If the string was split into a list successfully
+// StrBuilderAppendVSPrint
+/// Append formatted text to a string builder
+/// @param Builder The string builder
+/// @param Format  The format specifier for formatting the text
+/// @param Args    The variable arguments list for formatting
+/// @return Whether the formatted text was appended or not
+/// @retval EFI_INVALID_PARAMETER If Builder or Format is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the formatted text was appended successfully
 EFI_STATUS
 EFIAPI
-StrSplit (
-  OUT CHAR16 ***List,
-  OUT UINTN    *Count,
-  IN  CHAR16   *Str,
-  IN  CHAR16   *Split,
-  IN  UINTN     Options
+StrBuilderAppendVSPrint (
+  IN OUT STR_BUILDER *Builder,
+  IN     CHAR16      *Format,
+  IN     VA_LIST      Args
 ) {
-  CHAR16  *NextStr;
-  CHAR16 **NewList;
-  UINTN    NewCount;
-  UINTN    Length;
+  EFI_STATUS Status;
+  VA_LIST    Copy;
+  UINTN      Length;
   // Check parameters
-  if ((List == NULL) || (*List != NULL) || (Count == NULL) || (Str == NULL) || (Split == NULL)) {
+  if ((Builder == NULL) || (Format == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
-  Length = StrLen(Split);
+  // Get the length of the formatted text
+  VA_COPY(Copy, Args);
+  Length = SPrintLength(Format, Copy);
+  VA_END(Copy);
   if (Length == 0) {
-    return EFI_INVALID_PARAMETER;
+    return EFI_SUCCESS;
+  }
+  // Reserve space and format the text in place
+  Status = StrBuilderReserve(Builder, Length);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  Builder->Count += UnicodeVSPrint(Builder->Buffer + Builder->Count, (Builder->Size - Builder->Count) * sizeof(CHAR16), Format, Args);
+  return EFI_SUCCESS;
+}
+// StrBuilderAppendSPrint
+/// Append formatted text to a string builder
+/// @param Builder The string builder
+/// @param Format  The format specifier for formatting the text
+/// @param ...     The parameters for the format string
+/// @return Whether the formatted text was appended or not
+/// @retval EFI_INVALID_PARAMETER If Builder or Format is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the formatted text was appended successfully
+EFI_STATUS
+EFIAPI
+StrBuilderAppendSPrint (
+  IN OUT STR_BUILDER *Builder,
+  IN     CHAR16      *Format,
+  ...
+) {
+  EFI_STATUS Status;
+  VA_LIST    Args;
+  VA_START(Args, Format);
+  Status = StrBuilderAppendVSPrint(Builder, Format, Args);
+  VA_END(Args);
+  return Status;
+}
+// StrBuilderRemove
+/// Remove leading characters from a string builder
+/// @param Builder The string builder
+/// @param Count   The count of leading characters to remove, the string is emptied if this is not less than the string length
+/// @return Whether the characters were removed or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL
+/// @retval EFI_SUCCESS           If the characters were removed successfully
+EFI_STATUS
+EFIAPI
+StrBuilderRemove (
+  IN OUT STR_BUILDER *Builder,
+  IN     UINTN        Count
+) {
+  // Check parameters
+  if (Builder == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Builder->Buffer == NULL) {
+    return EFI_SUCCESS;
+  }
+  // Move the remaining characters to the start of the string
+  if (Count < Builder->Count) {
+    Builder->Count -= Count;
+    CopyMem(Builder->Buffer, Builder->Buffer + Count, Builder->Count * sizeof(CHAR16));
+  } else {
+    Builder->Count = 0;
+  }
+  Builder->Buffer[Builder->Count] = L'\0';
+  return EFI_SUCCESS;
+}
+// StrBuilderReset
+/// Empty a string builder and retain the allocated size for reuse
+/// @param Builder The string builder
+/// @return Whether the string builder was reset or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL
+/// @retval EFI_SUCCESS           If the string builder was reset successfully
+EFI_STATUS
+EFIAPI
+StrBuilderReset (
+  IN OUT STR_BUILDER *Builder
+) {
+  // Check parameters
+  if (Builder == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  Builder->Count = 0;
+  if (Builder->Buffer != NULL) {
+    Builder->Buffer[0] = L'\0';
+  }
+  return EFI_SUCCESS;
+}
+// StrBuilderFree
+/// Free the string of a string builder, the builder is empty afterwards and may be reused
+/// @param Builder The string builder
+/// @return Whether the string was freed or not
+/// @retval EFI_INVALID_PARAMETER If Builder is NULL
+/// @retval EFI_SUCCESS           If the string was freed successfully
+EFI_STATUS
+EFIAPI
+StrBuilderFree (
+  IN OUT STR_BUILDER *Builder
+) {
+  // Check parameters
+  if (Builder == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Builder->Buffer != NULL) {
+    FreePool(Builder->Buffer);
+  }
+  Builder->Buffer = NULL;
+  Builder->Count = Builder->Size = 0;
+  return EFI_SUCCESS;
+}
+
+// StrViewFromString
+/// Set a string view to an entire string
+/// @param View   On output, the string view
+/// @param String The string to view or NULL for an empty view
+/// @return Whether the string view was set or not
+/// @retval EFI_INVALID_PARAMETER If View is NULL
+/// @retval EFI_SUCCESS           If the string view was set successfully
+EFI_STATUS
+EFIAPI
+StrViewFromString (
+  OUT STR_VIEW *View,
+  IN  CHAR16   *String OPTIONAL
+) {
+  // Check parameters
+  if (View == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  View->String = String;
+  View->Count = (String == NULL) ? 0 : StrWordLength(String);
+  return EFI_SUCCESS;
+}
+// StrViewSplit
+/// Get the next token of a string view without allocating, the token is followed by any of the delimiter characters
+///  or the end of the view, empty tokens between consecutive delimiters are returned but a trailing delimiter does not
+///  produce an empty token
+/// @param View       The string view, which is advanced past the token and its delimiter
+/// @param Delimiters The delimiter characters
+/// @param Token      On output, the string view of the token
+/// @retval TRUE  If a token was returned
+/// @retval FALSE If there are no more tokens or a parameter is NULL
+BOOLEAN
+EFIAPI
+StrViewSplit (
+  IN OUT STR_VIEW *View,
+  IN     CHAR16   *Delimiters,
+  OUT    STR_VIEW *Token
+) {
+  CHAR16 *Delimiter;
+  UINTN   Index;
+  // Check parameters
+  if ((View == NULL) || (Delimiters == NULL) || (Token == NULL) || (View->String == NULL) || (View->Count == 0)) {
+    return FALSE;
+  }
+  // Find the first delimiter character
+  for (Index = 0; Index < View->Count; ++Index) {
+    for (Delimiter = Delimiters; *Delimiter != L'\0'; ++Delimiter) {
+      if (View->String[Index] == *Delimiter) {
+        break;
+      }
+    }
+    if (*Delimiter != L'\0') {
+      break;
+    }
+  }
+  // Return the token and advance past the delimiter
+  Token->String = View->String;
+  Token->Count = Index;
+  if (Index < View->Count) {
+    ++Index;
+  }
+  View->String += Index;
+  View->Count -= Index;
+  return TRUE;
+}
+// StrViewFind
+/// Find the first occurrence of a string in a string view
+/// @param View         The string view to search
+/// @param SearchString The string to search for
+/// @param Options      STR_SEARCH_CASE_INSENSITIVE to compare the characters case insensitively, otherwise zero
+/// @return The first occurrence of the search string in the string view or NULL if not found
+CHAR16 *
+EFIAPI
+StrViewFind (
+  IN STR_VIEW *View,
+  IN CHAR16   *SearchString,
+  IN UINTN     Options
+) {
+  UINTN Length;
+  UINTN Index;
+  UINTN Offset;
+  // Check parameters
+  if ((View == NULL) || (View->String == NULL) || (SearchString == NULL)) {
+    return NULL;
+  }
+  Length = StrWordLength(SearchString);
+  if (Length == 0) {
+    return View->String;
+  }
+  // Check each position the search string fits in the view
+  for (Index = 0; (View->Count - Index) >= Length; ++Index) {
+    if ((Options & STR_SEARCH_CASE_INSENSITIVE) != 0) {
+      for (Offset = 0; (Offset < Length) && (TO_FOLDED(View->String[Index + Offset]) == TO_FOLDED(SearchString[Offset])); ++Offset);
+    } else {
+      for (Offset = 0; (Offset < Length) && (View->String[Index + Offset] == SearchString[Offset]); ++Offset);
+    }
+    if (Offset == Length) {
+      return View->String + Index;
+    }
+  }
+  return NULL;
+}
+// StrViewTrim
+/// Trim the leading and trailing whitespace of a string view without modifying the string
+/// @param View The string view to trim
+/// @return Whether the string view was trimmed or not
+/// @retval EFI_INVALID_PARAMETER If View is NULL
+/// @retval EFI_SUCCESS           If the string view was trimmed successfully
+EFI_STATUS
+EFIAPI
+StrViewTrim (
+  IN OUT STR_VIEW *View
+) {
+  // Check parameters
+  if (View == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (View->String == NULL) {
+    View->Count = 0;
+    return EFI_SUCCESS;
+  }
+  while ((View->Count > 0) && ((*(View->String) == L' ') || (*(View->String) == L'\t') ||
+                               (*(View->String) == L'\r') || (*(View->String) == L'\n'))) {
+    ++(View->String);
+    --(View->Count);
+  }
+  while ((View->Count > 0) && ((View->String[View->Count - 1] == L' ') || (View->String[View->Count - 1] == L'\t') ||
+                               (View->String[View->Count - 1] == L'\r') || (View->String[View->Count - 1] == L'\n'))) {
+    --(View->Count);
+  }
+  return EFI_SUCCESS;
+}
+// StrViewCmp
+/// Performs a comparison of a string view and a string
+/// @param View   The string view to compare
+/// @param String The string to compare
+/// @retval 0  The string view is identical to the string
+/// @retval >0 The string view is lexically greater than the string
+/// @retval <0 The string view is lexically less than the string
+INTN
+EFIAPI
+StrViewCmp (
+  IN STR_VIEW *View,
+  IN CHAR16   *String
+) {
+  UINTN Index;
+  // Check parameters
+  if ((View == NULL) || (View->String == NULL)) {
+    return (String == NULL) ? 0 : -1;
+  } else if (String == NULL) {
+    return 1;
+  }
+  // Compare the characters in the view, the string is shorter if it ends first
+  for (Index = 0; Index < View->Count; ++Index) {
+    if (View->String[Index] != String[Index]) {
+      return (INTN)View->String[Index] - (INTN)String[Index];
+    }
+  }
+  return -(INTN)String[Index];
+}
+// StrViewiCmp
+/// Performs a case-insensitive comparison of a string view and a string, ordered the same as StriCmp
+/// @param View   The string view to compare
+/// @param String The string to compare
+/// @retval 0  The string view is identical to the string
+/// @retval >0 The string view is lexically greater than the string
+/// @retval <0 The string view is lexically less than the string
+INTN
+EFIAPI
+StrViewiCmp (
+  IN STR_VIEW *View,
+  IN CHAR16   *String
+) {
+  UINTN Index;
+  // Check parameters
+  if ((View == NULL) || (View->String == NULL)) {
+    return (String == NULL) ? 0 : -1;
+  } else if (String == NULL) {
+    return 1;
+  }
+  // Compare the folded characters in the view, the string is shorter if it ends first
+  for (Index = 0; Index < View->Count; ++Index) {
+    if (TO_FOLDED(View->String[Index]) != TO_FOLDED(String[Index])) {
+      return TO_FOLDED(View->String[Index]) - TO_FOLDED(String[Index]);
+    }
+  }
+  return -(INTN)TO_FOLDED(String[Index]);
+}
+// StrViewDup
+/// Duplicate the characters of a string view as a string
+/// @param View The string view to duplicate
+/// @return The duplicated string which needs freed or NULL if the string could not be duplicated
+CHAR16 *
+EFIAPI
+StrViewDup (
+  IN STR_VIEW *View
+) {
+  CHAR16 *Dup;
+  // Check parameters
+  if ((View == NULL) || (View->String == NULL) || (View->Count >= (MAX_UINTN / sizeof(CHAR16)))) {
+    return NULL;
+  }
+  Dup = (CHAR16 *)AllocatePool((View->Count + 1) * sizeof(CHAR16));
+  if (Dup != NULL) {
+    CopyMem(Dup, View->String, View->Count * sizeof(CHAR16));
+    Dup[View->Count] = L'\0';
+  }
+  return Dup;
+}
+// StrSmallSet
+/// Set the string of a small string, strings that do not fit in the inline buffer are allocated and the allocation
+///  is reused until the small string is freed
+/// @param Small  The small string
+/// @param String The characters to copy, which do not need to be null-terminated
+/// @param Count  The count of characters to copy
+/// @return Whether the string was set or not
+/// @retval EFI_INVALID_PARAMETER If Small is NULL or String is NULL and Count is not zero
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string
+/// @retval EFI_SUCCESS           If the string was set successfully
+EFI_STATUS
+EFIAPI
+StrSmallSet (
+  IN OUT STR_SMALL *Small,
+  IN     CHAR16    *String OPTIONAL,
+  IN     UINTN      Count
+) {
+  CHAR16 *Buffer;
+  // Check parameters
+  if ((Small == NULL) || ((String == NULL) && (Count != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Release an allocation that is too small
+  if ((Small->Buffer != NULL) && (Count >= Small->Size)) {
+    FreePool(Small->Buffer);
+    Small->Buffer = NULL;
+    Small->Size = 0;
+  }
+  // Allocate if the characters and the null-terminator do not fit in the inline buffer
+  if ((Small->Buffer == NULL) && (Count >= STR_SMALL_SIZE)) {
+    if (Count >= (MAX_UINTN / sizeof(CHAR16))) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Small->Buffer = (CHAR16 *)AllocatePool((Count + 1) * sizeof(CHAR16));
+    if (Small->Buffer == NULL) {
+      Small->Count = 0;
+      Small->Inline[0] = L'\0';
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Small->Size = Count + 1;
+  }
+  // Copy the characters
+  Buffer = STR_SMALL_BUFFER(Small);
+  if (Count != 0) {
+    CopyMem(Buffer, String, Count * sizeof(CHAR16));
+  }
+  Buffer[Count] = L'\0';
+  Small->Count = Count;
+  return EFI_SUCCESS;
+}
+// StrSmallFree
+/// Free the allocated string of a small string, the small string is empty afterwards and may be reused
+/// @param Small The small string
+/// @return Whether the string was freed or not
+/// @retval EFI_INVALID_PARAMETER If Small is NULL
+/// @retval EFI_SUCCESS           If the string was freed successfully
+EFI_STATUS
+EFIAPI
+StrSmallFree (
+  IN OUT STR_SMALL *Small
+) {
+  // Check parameters
+  if (Small == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Small->Buffer != NULL) {
+    FreePool(Small->Buffer);
+  }
+  Small->Buffer = NULL;
+  Small->Count = Small->Size = 0;
+  Small->Inline[0] = L'\0';
+  return EFI_SUCCESS;
+}
+
+// StrListHash
+/// Hash a string for a string list hash set, case insensitive hashes fold the characters like StriCmp
+/// @param Str             The string to hash
+/// @param CaseInsensitive Whether the hash is case insensitive or not
+/// @return The hash of the string
+STATIC UINTN
+EFIAPI
+StrListHash (
+  IN CHAR16  *Str,
+  IN BOOLEAN  CaseInsensitive
+) {
+  UINT32 Hash = 0x811C9DC5;
+  CHAR16 Character;
+  // Fowler-Noll-Vo hash of the characters
+  while ((Character = *Str++) != L'\0') {
+    if (CaseInsensitive) {
+      Character = TO_FOLDED(Character);
+    }
+    Hash = (Hash ^ Character) * 0x01000193;
+  }
+  return (UINTN)Hash;
+}
+// StrListFindSlot
+/// Find the hash set slot of a string in a string list object
+/// @param List The string list object which must have a hash set
+/// @param Str  The string to find
+/// @return The slot of the string if it is in the list or the unused slot where the string belongs
+STATIC CHAR16 **
+EFIAPI
+StrListFindSlot (
+  IN STR_LIST *List,
+  IN CHAR16   *Str
+) {
+  BOOLEAN CaseInsensitive = ((List->Options & STR_LIST_CASE_INSENSITIVE) != 0);
+  UINTN   Mask = List->HashSize - 1;
+  UINTN   Index = StrListHash(Str, CaseInsensitive) & Mask;
+  // Linear probe until the string or an unused slot is found
+  while (List->Hashes[Index] != NULL) {
+    if ((CaseInsensitive ? StriCmp(List->Hashes[Index], Str) : StrCmp(List->Hashes[Index], Str)) == 0) {
+      break;
+    }
+    Index = (Index + 1) & Mask;
+  }
+  return List->Hashes + Index;
+}
+// StrListGrowHashes
+/// Grow the hash set of a string list object so it stays at most half full after adding another string
+/// @param List The string list object
+/// @return Whether the hash set was grown or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated for the hash set
+/// @retval EFI_SUCCESS          If the hash set was grown successfully or did not need to grow
+STATIC EFI_STATUS
+EFIAPI
+StrListGrowHashes (
+  IN OUT STR_LIST *List
+) {
+  CHAR16 **Hashes;
+  UINTN    HashSize;
+  UINTN    Index;
+  if ((List->Hashes != NULL) && (((List->Count + 1) << 1) <= List->HashSize)) {
+    return EFI_SUCCESS;
+  }
+  HashSize = (List->Hashes == NULL) ? (STR_LIST_MIN_SIZE << 1) : List->HashSize;
+  while (HashSize < ((List->Count + 1) << 1)) {
+    HashSize <<= 1;
+  }
+  if (HashSize == List->HashSize) {
+    HashSize <<= 1;
+  }
+  if (HashSize > (MAX_UINTN / sizeof(CHAR16 *))) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Hashes = (CHAR16 **)AllocateZeroPool(HashSize * sizeof(CHAR16 *));
+  if (Hashes == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  if (List->Hashes != NULL) {
+    FreePool(List->Hashes);
+  }
+  List->Hashes = Hashes;
+  List->HashSize = HashSize;
+  // Rehash the strings already in the list
+  for (Index = 0; Index < List->Count; ++Index) {
+    *StrListFindSlot(List, List->Strings[Index]) = List->Strings[Index];
+  }
+  return EFI_SUCCESS;
+}
+
+// StrListAdd
+/// Add a string to a string list object, the list grows geometrically so adding is amortized constant time
+/// @param List   The string list object
+/// @param Str    The string to add to the list
+/// @param Length The maximum length of the string or zero to use the entire string
+/// @return Whether the string was added to the list or not
+/// @retval EFI_INVALID_PARAMETER If List or Str is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If the memory for the list could not be allocated
+/// @retval EFI_ACCESS_DENIED     If STR_LIST_NO_DUPLICATES was used and the string already exists
+/// @retval EFI_SUCCESS           If the string was added to the list successfully
+EFI_STATUS
+EFIAPI
+StrListAdd (
+  IN OUT STR_LIST *List,
+  IN     CHAR16   *Str,
+  IN     UINTN     Length
+) {
+  EFI_STATUS   Status;
+  CHAR16      *NewStr;
+  CHAR16     **Strings;
+  CHAR16     **Slot;
+  UINTN        Size;
+  UINTN        Index;
+  // Check parameters
+  if ((List == NULL) || (Str == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (List->Strings == NULL) {
+    List->Count = List->Size = 0;
+  }
+  // Duplicate the string
+  NewStr = (Length == 0) ? StrDup(Str) : StrnDup(Str, Length);
+  if (NewStr == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Check for duplicates if needed
+  Slot = NULL;
+  if ((List->Options & STR_LIST_NO_DUPLICATES) != 0) {
+    if ((List->Options & STR_LIST_HASHED) != 0) {
+      // Check for duplicates with the hash set
+      Status = StrListGrowHashes(List);
+      if (EFI_ERROR(Status)) {
+        FreePool(NewStr);
+        return Status;
+      }
+      Slot = StrListFindSlot(List, NewStr);
+      if (*Slot != NULL) {
+        // Already in list
+        FreePool(NewStr);
+        return EFI_ACCESS_DENIED;
+      }
+    } else {
+      // Check for duplicates case insensitively if needed
+      for (Index = 0; Index < List->Count; ++Index) {
+        if ((((List->Options & STR_LIST_CASE_INSENSITIVE) != 0) ? StriCmp(List->Strings[Index], NewStr) : StrCmp(List->Strings[Index], NewStr)) == 0) {
+          // Already in list
+          FreePool(NewStr);
+          return EFI_ACCESS_DENIED;
+        }
+      }
+    }
+  }
+  // Grow geometrically if there is no space for one more string
+  if (List->Count >= List->Size) {
+    Size = List->Size << 1;
+    if (Size < STR_LIST_MIN_SIZE) {
+      Size = STR_LIST_MIN_SIZE;
+    }
+    if ((Size <= List->Count) || (Size > (MAX_UINTN / sizeof(CHAR16 *)))) {
+      FreePool(NewStr);
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Strings = (CHAR16 **)ReallocatePool(List->Count * sizeof(CHAR16 *), Size * sizeof(CHAR16 *), List->Strings);
+    if (Strings == NULL) {
+      FreePool(NewStr);
+      return EFI_OUT_OF_RESOURCES;
+    }
+    List->Strings = Strings;
+    List->Size = Size;
+  }
+  // Check if the string list is sorted
+  Index = List->Count;
+  if ((List->Options & STR_LIST_SORTED) != 0) {
+    // Determine insertion point with binary search
+    UINTN Left = 0;
+    UINTN Right = List->Count;
+    while (Left < Right) {
+      Index = Left + ((Right - Left) >> 1);
+      if (StriColl(List->Strings[Index], NewStr) < 0) {
+        Left = Index + 1;
+      } else {
+        Right = Index;
+      }
+    }
+    Index = Left;
+    // Move the strings after the insertion point
+    if (Index < List->Count) {
+      CopyMem((VOID *)(List->Strings + Index + 1), (VOID *)(List->Strings + Index), (List->Count - Index) * sizeof(CHAR16 *));
+    }
+  }
+  // Insert string into list
+  List->Strings[Index] = NewStr;
+  ++(List->Count);
+  if (Slot != NULL) {
+    *Slot = NewStr;
+  }
+  return EFI_SUCCESS;
+}
+// StrListDetach
+/// Detach the strings from a string list object, the list is empty afterwards and may be reused
+/// @param List    The string list object
+/// @param Strings On output, the string list, which must be freed with StrListFree, or NULL if the list was empty
+/// @param Count   On output, the count of strings in the list
+/// @return Whether the strings were detached or not
+/// @retval EFI_INVALID_PARAMETER If List, Strings, or Count is NULL or *Strings is not NULL
+/// @retval EFI_SUCCESS           If the strings were detached successfully
+EFI_STATUS
+EFIAPI
+StrListDetach (
+  IN OUT STR_LIST   *List,
+  OUT    CHAR16   ***Strings,
+  OUT    UINTN      *Count
+) {
+  // Check parameters
+  if ((List == NULL) || (Strings == NULL) || (*Strings != NULL) || (Count == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if ((List->Strings != NULL) && (List->Count == 0)) {
+    FreePool(List->Strings);
+    List->Strings = NULL;
+  }
+  // Give the strings to the caller
+  *Strings = List->Strings;
+  *Count = (List->Strings == NULL) ? 0 : List->Count;
+  if (List->Hashes != NULL) {
+    FreePool(List->Hashes);
+  }
+  List->Strings = NULL;
+  List->Hashes = NULL;
+  List->Count = List->Size = List->HashSize = 0;
+  return EFI_SUCCESS;
+}
+// StrListClear
+/// Free the strings of a string list object, the list is empty afterwards and may be reused
+/// @param List The string list object
+/// @return Whether the strings were freed or not
+/// @retval EFI_INVALID_PARAMETER If List is NULL
+/// @retval EFI_SUCCESS           If the strings were freed successfully
+EFI_STATUS
+EFIAPI
+StrListClear (
+  IN OUT STR_LIST *List
+) {
+  EFI_STATUS   Status;
+  CHAR16     **Strings = NULL;
+  UINTN        Count = 0;
+  // Detach the strings and free them
+  Status = StrListDetach(List, &Strings, &Count);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  if (Strings != NULL) {
+    StrListFree(Strings, Count);
+  }
+  return EFI_SUCCESS;
+}
+
+// StrSplit
+/// Split a string into a list
+/// @param List    On output, the string list, which must be freed with StrListFree
+/// @param Count   On output, the count of strings in the list
+/// @param Str     The string to split
+/// @param Split   The string that splits
+/// @param Options The options for the string list
+/// @return Whether the string was split or not
+/// @retval EFI_INVALID_PARAMETER If List, Count, Str, or Split is NULL or *List is not NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the string list
+/// @retval EFI_NOT_FOUND         If the split string could not be found
+/// @retval EFI_SUCCESS           If the string was split into a list successfully
+EFI_STATUS
+EFIAPI
+StrSplit (
+  OUT CHAR16 ***List,
+  OUT UINTN    *Count,
+  IN  CHAR16   *Str,
+  IN  CHAR16   *Split,
+  IN  UINTN     Options
+) {
+  EFI_STATUS  Status;
+  CHAR16     *NextStr;
+  STR_LIST    NewList = { 0, 0, 0, NULL, 0, NULL };
+  UINTN       Length;
+  // Check parameters
+  if ((List == NULL) || (*List != NULL) || (Count == NULL) || (Str == NULL) || (Split == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  Length = StrLen(Split);
+  if (Length == 0) {
+    return EFI_INVALID_PARAMETER;
   }
   if (Length > StrLen(Str)) {
     return EFI_NOT_FOUND;
   }
-  // Start new string list
-  NewList = NULL;
-  NewCount = 0;
+  // Start new string list, duplicates are checked with a hash set
+  NewList.Options = Options;
+  if ((Options & STR_LIST_NO_DUPLICATES) != 0) {
+    NewList.Options |= STR_LIST_HASHED;
+  }
   // Iterate through the string
   do {
     // Get next instance of split string
@@ -674,25 +1863,31 @@ StrSplit (
     }
     // Check if the split string was found
     if (NextStr == NULL) {
-      if (NewCount == 0) {
+      if (NewList.Count == 0) {
         // No split string found
+        StrListClear(&NewList);
         return EFI_NOT_FOUND;
       }
       // Last string so done splitting
-      StrList(&NewList, &NewCount, Str, 0, Options);
+      Status = StrListAdd(&NewList, Str, 0);
+    } else {
+      // Add string to list
+      Status = StrListAdd(&NewList, Str, NextStr - Str);
+    }
+    if (Status == EFI_OUT_OF_RESOURCES) {
+      StrListClear(&NewList);
+      return Status;
+    }
+    if (NextStr == NULL) {
       break;
     }
-    // Add string to list
-    StrList(&NewList, &NewCount, Str, NextStr - Str, Options);
     // Advance string
     Str = NextStr + Length;
   // If we reach the null terminator then done splitting
   } while (*Str != '\0');
 
   // Return list and count
-  *List = NewList;
-  *Count = NewCount;
-  return EFI_SUCCESS;
+  return StrListDetach(&NewList, List, Count);
 }
 // StrList
 /// Append a string to a list
@@ -715,87 +1910,26 @@ StrList (
   IN     UINTN     Length,
   IN     UINTN     Options
 ) {
-  CHAR16  *NewStr;
-  CHAR16 **NewList;
-  CHAR16 **InitialList;
-  UINTN    InitialCount;
-  UINTN    NewCount;
-  UINTN    Index;
-
+  EFI_STATUS Status;
+  STR_LIST   Wrapper;
   // Check parameters
   if ((List == NULL) || (Count == NULL) || (Str == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
-  // Get the initial list and count
-  InitialList = *List;
-  InitialCount = (InitialList == NULL) ? 0 : *Count;
-  // Check for duplicates if needed
-  if ((Options & STR_LIST_NO_DUPLICATES) != 0) {
-    // Check case insensitively if needed
-    if ((Options & STR_LIST_CASE_INSENSITIVE) != 0) {
-      // Check for duplicates case insensitively
-      for (Index = 0; Index < InitialCount; ++Index) {
-        if (StriCmp(InitialList[Index], Str) == 0) {
-          // Already in list
-          return EFI_ACCESS_DENIED;
-        }
-      }
-    } else {
-      // Check for duplicates
-      for (Index = 0; Index < InitialCount; ++Index) {
-        if (StrCmp(InitialList[Index], Str) == 0) {
-          // Already in list
-          return EFI_ACCESS_DENIED;
-        }
-      }
-    }
-  }
-  // Duplicate the string
-  NewStr = (Length == 0) ? StrDup(Str) : StrnDup(Str, Length);
-  if (NewStr == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-  // Reallocate size in the list for one more string
-  NewCount = InitialCount + 1;
-  NewList = AllocateZeroPool(NewCount * sizeof(CHAR16 *));
-  if (NewList == NULL) {
-    FreePool(NewStr);
-    return EFI_OUT_OF_RESOURCES;
-  }
-  // Check if the string list is sorted
-  if ((Options & STR_LIST_SORTED) != 0) {
-    // Determine insertion point with binary search
-    UINTN Left = 0;
-    UINTN Right = InitialCount;
-    UINTN Index = 0;
-    while (Left < Right) {
-      Index = Left + ((Right - Left) >> 1);
-      if (StriColl(InitialList[Index], NewStr) < 0) {
-        Left = ++Index;
-      } else {
-        Right = Index;
-      }
-    }
-    // Copy old list before insertion point
-    if (Index > 0) {
-      CopyMem((VOID *)NewList, (VOID *)InitialList, Index * sizeof(CHAR16 *));
-    }
-    // Insert string into list
-    NewList[Index] = NewStr;
-    // Copy after insertion point
-    if (Index < InitialCount) {
-      CopyMem((VOID *)(NewList + Index + 1), (VOID *)(InitialList + Index), (InitialCount - Index) * sizeof(CHAR16 *));
-    }
-  } else {
-    // Copy old list
-    CopyMem((VOID *)NewList, (VOID *)InitialList, InitialCount * sizeof(CHAR16 *));
-    FreePool(InitialList);
-    // Append string to list
-    NewList[InitialCount] = NewStr;
+  // Wrap the list in a string list object without a hash set since it would be rebuilt for every string,
+  //  use a string list object directly to build a list with many strings
+  Wrapper.Options = Options & ~((UINTN)STR_LIST_HASHED);
+  Wrapper.Strings = *List;
+  Wrapper.Count = Wrapper.Size = (*List == NULL) ? 0 : *Count;
+  Wrapper.HashSize = 0;
+  Wrapper.Hashes = NULL;
+  Status = StrListAdd(&Wrapper, Str, Length);
+  if (EFI_ERROR(Status)) {
+    return Status;
   }
   // Set new list and count
-  *List = NewList;
-  *Count = NewCount;
+  *List = Wrapper.Strings;
+  *Count = Wrapper.Count;
   return EFI_SUCCESS;
 }
 // StrListDup
@@ -935,6 +2069,7 @@ AsciiStriColl (
   IN CHAR8 *Str1,
   IN CHAR8 *Str2
 ) {
+  INTN Result;
   if (Str1 == NULL) {
     if (Str2 == NULL) {
       return 0;
@@ -943,15 +2078,60 @@ AsciiStriColl (
   } else if (Str2 == NULL) {
     return 1;
   }
-  while (*Str1 != 0) {
-    if ((mEngUpperMap[*Str1] != mEngUpperMap[*Str2]) || (*Str1 != *Str2)) {
+  // Order by the folded characters first so strings equal to AsciiStrniCmp are adjacent
+  Result = AsciiStrniCmp(Str1, Str2, MAX_UINTN);
+  if (Result == 0) {
+    Result = AsciiStrCmp(Str1, Str2);
+  }
+  return Result;
+}
+// AsciiMetaiMatchSet
+/// Match a character against a pattern character set
+/// @param Character The character to match
+/// @param Pattern   On input, the pattern after the opening bracket, on output, the pattern after the set
+/// @return Whether the character is in the set or not, a set with a syntax problem matches no character
+STATIC BOOLEAN
+EFIAPI
+AsciiMetaiMatchSet (
+  IN     CHAR8   Character,
+  IN OUT CHAR8 **Pattern
+) {
+  CHAR8   *Ptr = *Pattern;
+  CHAR8    CharP;
+  CHAR8    Previous = 0;
+  BOOLEAN  Match = FALSE;
+  // Check each character or range of the set
+  while ((CharP = *Ptr) != 0) {
+    ++Ptr;
+    if (CharP == ']') {
       break;
     }
-
-    ++Str1;
-    ++Str2;
+    if (CharP == '-') {
+      // If range of chars, get high range
+      CharP = *Ptr;
+      if ((CharP == 0) || (CharP == ']')) {
+        // Syntax problem
+        Match = FALSE;
+        break;
+      }
+      if ((ASCII_TO_FOLDED(Character) >= ASCII_TO_FOLDED(Previous)) && (ASCII_TO_FOLDED(Character) <= ASCII_TO_FOLDED(CharP))) {
+        // If in range, it's a match
+        Match = TRUE;
+      }
+      ++Ptr;
+    }
+    Previous = CharP;
+    if (ASCII_TO_FOLDED(Character) == ASCII_TO_FOLDED(CharP)) {
+      // If char matches
+      Match = TRUE;
+    }
   }
-  return *Str1 - *Str2;
+  // An unterminated set is a syntax problem
+  if (CharP == 0) {
+    Match = FALSE;
+  }
+  *Pattern = Ptr;
+  return Match;
 }
 // AsciiMetaiMatch
 /// Performs a case-insensitive comparison of a pattern string and a string
@@ -965,114 +2145,87 @@ AsciiMetaiMatch (
   IN CHAR8 *String,
   IN CHAR8 *Pattern
 ) {
-  CHAR8 CharC;
-  CHAR8 CharP;
-  CHAR8 Index3;
+  CHAR8   *StarPattern = NULL;
+  CHAR8   *StarString = NULL;
+  CHAR8    CharP;
+  BOOLEAN  Match;
 
   if ((String == NULL) || (Pattern == NULL)) {
     return FALSE;
   }
 
-  while ((CharP = *Pattern++) != '\0') {
-
-    switch (CharP) {
-
-    case '*':
-      //
+  // Compare the folded characters, remember the last star and where it started matching in the string so a
+  //  mismatch only retries the last star with one more character instead of recursing for every star
+  while (TRUE) {
+    CharP = *Pattern;
+    if (CharP == '*') {
       // Match zero or more chars
-      //
-      while (*String != 0) {
-        if (AsciiMetaiMatch(String, Pattern)) {
-          return TRUE;
-        }
-
-        ++String;
-      }
-
-      return AsciiMetaiMatch(String, Pattern);
-
-    case '?':
-      //
+      StarPattern = ++Pattern;
+      StarString = String;
+      continue;
+    }
+    if (CharP == 0) {
+      Match = (*String == 0);
+    } else if (*String == 0) {
+      Match = FALSE;
+    } else if (CharP == '?') {
       // Match any one char
-      //
-      if (*String == 0) {
-        return FALSE;
-      }
-
-      ++String;
-      break;
-
-    case '[':
-      //
+      Match = TRUE;
+      ++Pattern;
+    } else if (CharP == '[') {
       // Match char set
-      //
-      CharC = *String;
-      if (CharC == 0) {
-        //
-        // syntax problem
-        //
-        return FALSE;
-      }
-
-      Index3  = 0;
-      CharP   = *Pattern++;
-      while (CharP != 0) {
-        if (CharP == ']') {
-          return FALSE;
-        }
-
-        if (CharP == '-') {
-          //
-          // if range of chars, get high range
-          //
-          CharP = *Pattern;
-          if (CharP == 0 || CharP == ']') {
-            //
-            // syntax problem
-            //
-            return FALSE;
-          }
-
-          if ((mEngUpperMap[CharC] >= mEngUpperMap[Index3]) && (mEngUpperMap[CharC] <= mEngUpperMap[CharP])) {
-            //
-            // if in range, it's a match
-            //
-            break;
-          }
-        }
-
-        Index3 = CharP;
-        if (mEngUpperMap[CharC] == mEngUpperMap[CharP]) {
-          //
-          // if char matches
-          //
-          break;
-        }
-
-        CharP = *Pattern++;
-      }
-      //
-      // skip to end of match char set
-      //
-      while ((CharP != 0) && (CharP != ']')) {
-        CharP = *Pattern;
-        ++Pattern;
-      }
-
-      ++String;
-      break;
-
-    default:
-      CharC = *String;
-      if (mEngUpperMap[CharC] != mEngUpperMap[CharP]) {
-        return FALSE;
+      ++Pattern;
+      Match = AsciiMetaiMatchSet(*String, &Pattern);
+    } else {
+      Match = (ASCII_TO_FOLDED(*String) == ASCII_TO_FOLDED(CharP));
+      ++Pattern;
+    }
+    if (Match) {
+      if (CharP == 0) {
+        return TRUE;
       }
-
       ++String;
-      break;
+      continue;
+    }
+    // Retry the last star with one more character
+    if ((StarPattern == NULL) || (*StarString == 0)) {
+      return FALSE;
     }
+    Pattern = StarPattern;
+    String = ++StarString;
   }
-  return (*String == '\0');
+}
+
+// AsciiMetaiCompile
+/// Compile an ASCII pattern string for repeated case-insensitive matching
+/// @param Compiled On output, the compiled pattern, which must be freed with MetaiFreeCompiled
+/// @param Pattern  The pattern string
+/// @return Whether the pattern was compiled or not
+/// @retval EFI_INVALID_PARAMETER If Compiled or Pattern is NULL, *Compiled is not NULL, or a character set has a syntax problem
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated for the compiled pattern
+/// @retval EFI_SUCCESS           If the pattern was compiled successfully
+EFI_STATUS
+EFIAPI
+AsciiMetaiCompile (
+  OUT META_PATTERN **Compiled,
+  IN  CHAR8         *Pattern
+) {
+  return MetaiCompileInternal(Compiled, (VOID *)Pattern, TRUE);
+};
+// AsciiMetaiMatchCompiled
+/// Performs a case-insensitive comparison of a compiled pattern and an ASCII string in time linear in the string
+///  length for each segment between stars
+/// @param Compiled The compiled pattern
+/// @param String   A pointer to a string
+/// @retval TRUE  Pattern was found in String
+/// @retval FALSE Pattern was not found in String
+BOOLEAN
+EFIAPI
+AsciiMetaiMatchCompiled (
+  IN META_PATTERN *Compiled,
+  IN CHAR8        *String
+) {
+  return MetaiMatchCompiledInternal(Compiled, (VOID *)String, TRUE);
 }
 
 // AsciiLwr
@@ -1087,7 +2240,7 @@ AsciiLwr (
     return;
   }
   while (*Str != 0) {
-    *Str = mEngLowerMap[*Str];
+    *Str = (CHAR8)mEngLowerMap[(UINT8)*Str];
     ++Str;
   }
 }
@@ -1103,7 +2256,7 @@ AsciiUpr (
     return;
   }
   while (*Str != 0) {
-    *Str = mEngUpperMap[*Str];
+    *Str = (CHAR8)mEngUpperMap[(UINT8)*Str];
     ++Str;
   }
 }
@@ -1149,73 +2302,344 @@ AsciiToUpper (
 /// @retval <0 Str1 is lexically less than Str2
 INTN
 EFIAPI
-AsciiStrniCmp (
-  IN CHAR8 *Str1,
-  IN CHAR8 *Str2,
-  IN UINTN  Count
+AsciiStrniCmp (
+  IN CHAR8 *Str1,
+  IN CHAR8 *Str2,
+  IN UINTN  Count
+) {
+  // Check parameters
+  if (Count == 0) {
+    return 0;
+  }
+  if (Str1 == NULL) {
+    if (Str2 == NULL) {
+      return 0;
+    }
+    return -1;
+  } else if (Str2 == NULL) {
+    return 1;
+  }
+  while (*Str1 != '\0') {
+#if STR_WORD_ACCESS
+    // Skip words of identical characters while both strings are aligned
+    if ((((UINTN)Str1 | (UINTN)Str2) & STR_WORD_MASK) == 0) {
+      while ((Count > ASCII_WORD_CHARS) && (*(UINTN *)Str1 == *(UINTN *)Str2) && !ASCII_WORD_HAS_NULL(*(UINTN *)Str1)) {
+        Str1 += ASCII_WORD_CHARS;
+        Str2 += ASCII_WORD_CHARS;
+        Count -= ASCII_WORD_CHARS;
+      }
+      if (*Str1 == '\0') {
+        break;
+      }
+    }
+#endif
+    if ((ASCII_TO_FOLDED(*Str1) != ASCII_TO_FOLDED(*Str2)) || (Count-- <= 1)) {
+      break;
+    }
+    ++Str1;
+    ++Str2;
+  }
+  return ASCII_TO_FOLDED(*Str1) - ASCII_TO_FOLDED(*Str2);
+}
+
+// AsciiStriStr
+/// Returns the first occurrence of a case-insensitive sub-string in a string
+/// @param String       A pointer to a string
+/// @param SearchString A pointer to a string for which to search
+/// @return A pointer to the matched sub-string in String
+/// @retval NULL If SearchString was not found in String
+CHAR8 *
+EFIAPI
+AsciiStriStr (
+  IN CHAR8 *String,
+  IN CHAR8 *SearchString
+) {
+  // Check parameters
+  if (String == NULL) {
+    return NULL;
+  }
+  if ((SearchString == NULL) || (*SearchString == '\0')) {
+    return String;
+  }
+  // Iterate through string for matches
+  while (*String != '\0') {
+    CHAR8 *SearchStringTmp = SearchString;
+    CHAR8 *FirstMatch = String;
+
+    // Check for match
+    while ((ASCII_TO_FOLDED(*String) == ASCII_TO_FOLDED(*SearchStringTmp)) && (*String != '\0')) {
+      ++String;
+      ++SearchStringTmp;
+    }
+
+    if (*SearchStringTmp == '\0') {
+      // Found
+      return FirstMatch;
+    }
+    if (*String == '\0') {
+      // Not found
+      return NULL;
+    }
+
+    String = FirstMatch + 1;
+  }
+  // Not found
+  return NULL;
+}
+
+// AsciiStrListHash
+/// Hash a string for a string list hash set, case insensitive hashes only fold the basic latin letters like AsciiStriCmp
+/// @param Str             The string to hash
+/// @param CaseInsensitive Whether the hash is case insensitive or not
+/// @return The hash of the string
+STATIC UINTN
+EFIAPI
+AsciiStrListHash (
+  IN CHAR8   *Str,
+  IN BOOLEAN  CaseInsensitive
+) {
+  UINT32 Hash = 0x811C9DC5;
+  CHAR8  Character;
+  // Fowler-Noll-Vo hash of the characters
+  while ((Character = *Str++) != '\0') {
+    if (CaseInsensitive && (Character >= 'a') && (Character <= 'z')) {
+      Character -= ('a' - 'A');
+    }
+    Hash = (Hash ^ (UINT8)Character) * 0x01000193;
+  }
+  return (UINTN)Hash;
+}
+// AsciiStrListFindSlot
+/// Find the hash set slot of a string in a string list object
+/// @param List The string list object which must have a hash set
+/// @param Str  The string to find
+/// @return The slot of the string if it is in the list or the unused slot where the string belongs
+STATIC CHAR8 **
+EFIAPI
+AsciiStrListFindSlot (
+  IN ASCII_STR_LIST *List,
+  IN CHAR8          *Str
+) {
+  BOOLEAN CaseInsensitive = ((List->Options & STR_LIST_CASE_INSENSITIVE) != 0);
+  UINTN   Mask = List->HashSize - 1;
+  UINTN   Index = AsciiStrListHash(Str, CaseInsensitive) & Mask;
+  // Linear probe until the string or an unused slot is found
+  while (List->Hashes[Index] != NULL) {
+    if ((CaseInsensitive ? AsciiStriCmp(List->Hashes[Index], Str) : AsciiStrCmp(List->Hashes[Index], Str)) == 0) {
+      break;
+    }
+    Index = (Index + 1) & Mask;
+  }
+  return List->Hashes + Index;
+}
+// AsciiStrListGrowHashes
+/// Grow the hash set of a string list object so it stays at most half full after adding another string
+/// @param List The string list object
+/// @return Whether the hash set was grown or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated for the hash set
+/// @retval EFI_SUCCESS          If the hash set was grown successfully or did not need to grow
+STATIC EFI_STATUS
+EFIAPI
+AsciiStrListGrowHashes (
+  IN OUT ASCII_STR_LIST *List
+) {
+  CHAR8 **Hashes;
+  UINTN   HashSize;
+  UINTN   Index;
+  if ((List->Hashes != NULL) && (((List->Count + 1) << 1) <= List->HashSize)) {
+    return EFI_SUCCESS;
+  }
+  HashSize = (List->Hashes == NULL) ? (STR_LIST_MIN_SIZE << 1) : List->HashSize;
+  while (HashSize < ((List->Count + 1) << 1)) {
+    HashSize <<= 1;
+  }
+  if (HashSize == List->HashSize) {
+    HashSize <<= 1;
+  }
+  if (HashSize > (MAX_UINTN / sizeof(CHAR8 *))) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Hashes = (CHAR8 **)AllocateZeroPool(HashSize * sizeof(CHAR8 *));
+  if (Hashes == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  if (List->Hashes != NULL) {
+    FreePool(List->Hashes);
+  }
+  List->Hashes = Hashes;
+  List->HashSize = HashSize;
+  // Rehash the strings already in the list
+  for (Index = 0; Index < List->Count; ++Index) {
+    *AsciiStrListFindSlot(List, List->Strings[Index]) = List->Strings[Index];
+  }
+  return EFI_SUCCESS;
+}
+
+// AsciiStrListAdd
+/// Add a string to a string list object, the list grows geometrically so adding is amortized constant time
+/// @param List   The string list object
+/// @param Str    The string to add to the list
+/// @param Length The maximum length of the string or zero to use the entire string
+/// @return Whether the string was added to the list or not
+/// @retval EFI_INVALID_PARAMETER If List or Str is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If the memory for the list could not be allocated
+/// @retval EFI_ACCESS_DENIED     If STR_LIST_NO_DUPLICATES was used and the string already exists
+/// @retval EFI_SUCCESS           If the string was added to the list successfully
+EFI_STATUS
+EFIAPI
+AsciiStrListAdd (
+  IN OUT ASCII_STR_LIST *List,
+  IN     CHAR8          *Str,
+  IN     UINTN           Length
+) {
+  EFI_STATUS   Status;
+  CHAR8       *NewStr;
+  CHAR8      **Strings;
+  CHAR8      **Slot;
+  UINTN        Size;
+  UINTN        Index;
+  // Check parameters
+  if ((List == NULL) || (Str == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (List->Strings == NULL) {
+    List->Count = List->Size = 0;
+  }
+  // Duplicate the string
+  NewStr = (Length == 0) ? AsciiStrDup(Str) : AsciiStrnDup(Str, Length);
+  if (NewStr == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Check for duplicates if needed
+  Slot = NULL;
+  if ((List->Options & STR_LIST_NO_DUPLICATES) != 0) {
+    if ((List->Options & STR_LIST_HASHED) != 0) {
+      // Check for duplicates with the hash set
+      Status = AsciiStrListGrowHashes(List);
+      if (EFI_ERROR(Status)) {
+        FreePool(NewStr);
+        return Status;
+      }
+      Slot = AsciiStrListFindSlot(List, NewStr);
+      if (*Slot != NULL) {
+        // Already in list
+        FreePool(NewStr);
+        return EFI_ACCESS_DENIED;
+      }
+    } else {
+      // Check for duplicates case insensitively if needed
+      for (Index = 0; Index < List->Count; ++Index) {
+        if ((((List->Options & STR_LIST_CASE_INSENSITIVE) != 0) ? AsciiStriCmp(List->Strings[Index], NewStr) : AsciiStrCmp(List->Strings[Index], NewStr)) == 0) {
+          // Already in list
+          FreePool(NewStr);
+          return EFI_ACCESS_DENIED;
+        }
+      }
+    }
+  }
+  // Grow geometrically if there is no space for one more string
+  if (List->Count >= List->Size) {
+    Size = List->Size << 1;
+    if (Size < STR_LIST_MIN_SIZE) {
+      Size = STR_LIST_MIN_SIZE;
+    }
+    if ((Size <= List->Count) || (Size > (MAX_UINTN / sizeof(CHAR8 *)))) {
+      FreePool(NewStr);
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Strings = (CHAR8 **)ReallocatePool(List->Count * sizeof(CHAR8 *), Size * sizeof(CHAR8 *), List->Strings);
+    if (Strings == NULL) {
+      FreePool(NewStr);
+      return EFI_OUT_OF_RESOURCES;
+    }
+    List->Strings = Strings;
+    List->Size = Size;
+  }
+  // Check if the string list is sorted
+  Index = List->Count;
+  if ((List->Options & STR_LIST_SORTED) != 0) {
+    // Determine insertion point with binary search
+    UINTN Left = 0;
+    UINTN Right = List->Count;
+    while (Left < Right) {
+      Index = Left + ((Right - Left) >> 1);
+      if (AsciiStriColl(List->Strings[Index], NewStr) < 0) {
+        Left = Index + 1;
+      } else {
+        Right = Index;
+      }
+    }
+    Index = Left;
+    // Move the strings after the insertion point
+    if (Index < List->Count) {
+      CopyMem((VOID *)(List->Strings + Index + 1), (VOID *)(List->Strings + Index), (List->Count - Index) * sizeof(CHAR8 *));
+    }
+  }
+  // Insert string into list
+  List->Strings[Index] = NewStr;
+  ++(List->Count);
+  if (Slot != NULL) {
+    *Slot = NewStr;
+  }
+  return EFI_SUCCESS;
+}
+// AsciiStrListDetach
+/// Detach the strings from a string list object, the list is empty afterwards and may be reused
+/// @param List    The string list object
+/// @param Strings On output, the string list, which must be freed with AsciiStrListFree, or NULL if the list was empty
+/// @param Count   On output, the count of strings in the list
+/// @return Whether the strings were detached or not
+/// @retval EFI_INVALID_PARAMETER If List, Strings, or Count is NULL or *Strings is not NULL
+/// @retval EFI_SUCCESS           If the strings were detached successfully
+EFI_STATUS
+EFIAPI
+AsciiStrListDetach (
+  IN OUT ASCII_STR_LIST   *List,
+  OUT    CHAR8          ***Strings,
+  OUT    UINTN           *Count
 ) {
   // Check parameters
-  if (Count == 0) {
-    return 0;
+  if ((List == NULL) || (Strings == NULL) || (*Strings != NULL) || (Count == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
-  if (Str1 == NULL) {
-    if (Str2 == NULL) {
-      return 0;
-    }
-    return -1;
-  } else if (Str2 == NULL) {
-    return 1;
+  if ((List->Strings != NULL) && (List->Count == 0)) {
+    FreePool(List->Strings);
+    List->Strings = NULL;
   }
-  while ((*Str1 != '\0') && (mEngUpperMap[*Str1] == mEngUpperMap[*Str2]) && (Count-- > 1)) {
-    ++Str1;
-    ++Str2;
+  // Give the strings to the caller
+  *Strings = List->Strings;
+  *Count = (List->Strings == NULL) ? 0 : List->Count;
+  if (List->Hashes != NULL) {
+    FreePool(List->Hashes);
   }
-  return mEngUpperMap[*Str1] - mEngUpperMap[*Str2];
+  List->Strings = NULL;
+  List->Hashes = NULL;
+  List->Count = List->Size = List->HashSize = 0;
+  return EFI_SUCCESS;
 }
-
-// AsciiStriStr
-/// Returns the first occurrence of a case-insensitive sub-string in a string
-/// @param String       A pointer to a string
-/// @param SearchString A pointer to a string for which to search
-/// @return A pointer to the matched sub-string in String
-/// @retval NULL If SearchString was not found in String
-CHAR8 *
+// AsciiStrListClear
+/// Free the strings of a string list object, the list is empty afterwards and may be reused
+/// @param List The string list object
+/// @return Whether the strings were freed or not
+/// @retval EFI_INVALID_PARAMETER If List is NULL
+/// @retval EFI_SUCCESS           If the strings were freed successfully
+EFI_STATUS
 EFIAPI
-AsciiStriStr (
-  IN CHAR8 *String,
-  IN CHAR8 *SearchString
+AsciiStrListClear (
+  IN OUT ASCII_STR_LIST *List
 ) {
-  // Check parameters
-  if (String == NULL) {
-    return NULL;
-  }
-  if ((SearchString == NULL) || (*SearchString == '\0')) {
-    return String;
+  EFI_STATUS  Status;
+  CHAR8     **Strings = NULL;
+  UINTN       Count = 0;
+  // Detach the strings and free them
+  Status = AsciiStrListDetach(List, &Strings, &Count);
+  if (EFI_ERROR(Status)) {
+    return Status;
   }
-  // Iterate through string for matches
-  while (*String != '\0') {
-    CHAR8 *SearchStringTmp = SearchString;
-    CHAR8 *FirstMatch = String;
-
-    // Check for match
-    while ((mEngUpperMap[*String] == mEngUpperMap[*SearchStringTmp]) && (*String != '\0')) {
-      ++String;
-      ++SearchStringTmp;
-    }
-
-    if (*SearchStringTmp == '\0') {
-      // Found
-      return FirstMatch;
-    }
-    if (*String == '\0') {
-      // Not found
-      return NULL;
-    }
-
-    String = FirstMatch + 1;
+  if (Strings != NULL) {
+    AsciiStrListFree(Strings, Count);
   }
-  // Not found
-  return NULL;
+  return EFI_SUCCESS;
 }
 
 // AsciiStrSplit
@@ -1239,10 +2663,10 @@ AsciiStrSplit (
   IN  CHAR8   *Split,
   IN  UINTN    Options
 ) {
-  CHAR8  *NextStr;
-  CHAR8 **NewList;
-  UINTN   NewCount;
-  UINTN   Length;
+  EFI_STATUS      Status;
+  CHAR8          *NextStr;
+  ASCII_STR_LIST  NewList = { 0, 0, 0, NULL, 0, NULL };
+  UINTN           Length;
   // Check parameters
   if ((List == NULL) || (*List != NULL) || (Count == NULL) || (Str == NULL) || (Split == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -1254,9 +2678,11 @@ AsciiStrSplit (
   if (Length > AsciiStrLen(Str)) {
     return EFI_NOT_FOUND;
   }
-  // Start new string list
-  NewList = NULL;
-  NewCount = 0;
+  // Start new string list, duplicates are checked with a hash set
+  NewList.Options = Options;
+  if ((Options & STR_LIST_NO_DUPLICATES) != 0) {
+    NewList.Options |= STR_LIST_HASHED;
+  }
   // Iterate through the string
   do {
     // Get next instance of split string
@@ -1267,27 +2693,27 @@ AsciiStrSplit (
     }
     // Check if the split string was found
     if (NextStr == NULL) {
-      if (NewCount == 0) {
-        // No split string found
-        //return EFI_NOT_FOUND;
-      }
       // Last string so done splitting
-      AsciiStrList(&NewList, &NewCount, Str, 0, Options);
+      Status = AsciiStrListAdd(&NewList, Str, 0);
+    } else {
+      // Add string to list
+      Status = AsciiStrListAdd(&NewList, Str, NextStr - Str);
+    }
+    if (Status == EFI_OUT_OF_RESOURCES) {
+      AsciiStrListClear(&NewList);
+      return Status;
+    }
+    if (NextStr == NULL) {
       break;
     }
-    // Add string to list
-    AsciiStrList(&NewList, &NewCount, Str, NextStr - Str, Options);
     // Advance string
     Str = NextStr + Length;
   // If we reach the null terminator then done splitting
   } while (*Str != '\0');
 
   // Return list and count
-  *List = NewList;
-  *Count = NewCount;
-  return EFI_SUCCESS;
+  return AsciiStrListDetach(&NewList, List, Count);
 }
-
 // AsciiStrList
 /// Append a string to a list
 /// @param List    The list to append the string, which must be freed with AsciiStrListFree, *List may be NULL to start new list
@@ -1309,87 +2735,26 @@ AsciiStrList (
   IN     UINTN    Length,
   IN     UINTN    Options
 ) {
-  CHAR8  *NewStr;
-  CHAR8 **NewList;
-  CHAR8 **InitialList;
-  UINTN   InitialCount;
-  UINTN   NewCount;
-  UINTN   Index;
-
+  EFI_STATUS     Status;
+  ASCII_STR_LIST Wrapper;
   // Check parameters
   if ((List == NULL) || (Count == NULL) || (Str == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
-  // Get the initial list and count
-  InitialList = *List;
-  InitialCount = (InitialList == NULL) ? 0 : *Count;
-  // Check for duplicates if needed
-  if ((Options & STR_LIST_NO_DUPLICATES) != 0) {
-    // Check case insensitively if needed
-    if ((Options & STR_LIST_CASE_INSENSITIVE) != 0) {
-      // Check for duplicates case insensitively
-      for (Index = 0; Index < InitialCount; ++Index) {
-        if (AsciiStriCmp(InitialList[Index], Str) == 0) {
-          // Already in list
-          return EFI_ACCESS_DENIED;
-        }
-      }
-    } else {
-      // Check for duplicates
-      for (Index = 0; Index < InitialCount; ++Index) {
-        if (AsciiStrCmp(InitialList[Index], Str) == 0) {
-          // Already in list
-          return EFI_ACCESS_DENIED;
-        }
-      }
-    }
-  }
-  // Duplicate the string
-  NewStr = (Length == 0) ? AsciiStrDup(Str) : AsciiStrnDup(Str, Length);
-  if (NewStr == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-  // Reallocate size in the list for one more string
-  NewCount = InitialCount + 1;
-  NewList = AllocateZeroPool(NewCount * sizeof(CHAR8 *));
-  if (NewList == NULL) {
-    FreePool(NewStr);
-    return EFI_OUT_OF_RESOURCES;
-  }
-  // Check if the string list is sorted
-  if ((Options & STR_LIST_SORTED) != 0) {
-    // Determine insertion point with binary search
-    UINTN Left = 0;
-    UINTN Right = InitialCount;
-    UINTN Index = 0;
-    while (Left < Right) {
-      Index = Left + ((Right - Left) >> 1);
-      if (AsciiStriColl(InitialList[Index], NewStr) < 0) {
-        Left = ++Index;
-      } else {
-        Right = Index;
-      }
-    }
-    // Copy old list before insertion point
-    if (Index > 0) {
-      CopyMem((VOID *)NewList, (VOID *)InitialList, Index * sizeof(CHAR8 *));
-    }
-    // Insert string into list
-    NewList[Index] = NewStr;
-    // Copy after insertion point
-    if (Index < InitialCount) {
-      CopyMem((VOID *)(NewList + Index + 1), (VOID *)(InitialList + Index), (InitialCount - Index) * sizeof(CHAR8 *));
-    }
-  } else {
-    // Copy old list
-    CopyMem((VOID *)NewList, (VOID *)InitialList, InitialCount * sizeof(CHAR8 *));
-    FreePool(InitialList);
-    // Append string to list
-    NewList[InitialCount] = NewStr;
+  // Wrap the list in a string list object without a hash set since it would be rebuilt for every string,
+  //  use a string list object directly to build a list with many strings
+  Wrapper.Options = Options & ~((UINTN)STR_LIST_HASHED);
+  Wrapper.Strings = *List;
+  Wrapper.Count = Wrapper.Size = (*List == NULL) ? 0 : *Count;
+  Wrapper.HashSize = 0;
+  Wrapper.Hashes = NULL;
+  Status = AsciiStrListAdd(&Wrapper, Str, Length);
+  if (EFI_ERROR(Status)) {
+    return Status;
   }
   // Set new list and count
-  *List = NewList;
-  *Count = NewCount;
+  *List = Wrapper.Strings;
+  *Count = Wrapper.Count;
   return EFI_SUCCESS;
 }
 // AsciiStrListFree
@@ -1422,32 +2787,52 @@ AsciiStrListFree (
 // ToAscii
 /// Convert string to ASCII
 /// @param String The string to convert
-/// @return The converted string or NULL if there was an error
+/// @return The converted string or NULL if there was an error or a character is not latin-1
 CHAR8 *
 EFIAPI
 ToAscii (
   IN CHAR16 *String
 ) {
   UINTN  Length;
+  UINTN  Index;
+  UINTN  Lane;
+  UINTN  Word;
   CHAR8 *Str;
   // Check parameters
   if (String == NULL) {
     return NULL;
   }
   // Get string length
-  Length = StrLen(String);
+  Length = StrWordLength(String);
   if (Length == 0) {
     return NULL;
   }
   // Allocate new string
-  Str = (CHAR8 *)AllocateZeroPool((Length + 1) * sizeof(CHAR8));
-  if (Str != NULL) {
-    // Convert the string
-    if (EFI_ERROR(UnicodeStrToAsciiStrS(String, Str, Length + 1))) {
+  Str = (CHAR8 *)AllocatePool((Length + 1) * sizeof(CHAR8));
+  if (Str == NULL) {
+    return NULL;
+  }
+  // Convert the string, a word of characters at a time while the string is aligned, all targets are little endian
+  Index = 0;
+  while (Index < Length) {
+    if ((((UINTN)(String + Index) & STR_WORD_MASK) == 0) && ((Length - Index) >= STR_WORD_CHARS)) {
+      Word = *(UINTN *)(String + Index);
+      if (STR_WORD_IS_LATIN1(Word)) {
+        for (Lane = 0; Lane < STR_WORD_CHARS; ++Lane) {
+          Str[Index++] = (CHAR8)(Word >> (Lane << 4));
+        }
+        continue;
+      }
+    }
+    // Characters that are not latin-1 can not be converted
+    if (String[Index] > 0xFF) {
       FreePool(Str);
-      Str = NULL;
+      return NULL;
     }
+    Str[Index] = (CHAR8)String[Index];
+    ++Index;
   }
+  Str[Length] = '\0';
   return Str;
 }
 // FromAscii
@@ -1460,28 +2845,386 @@ FromAscii (
   IN CHAR8 *String
 ) {
   UINTN   Length;
+  UINTN   Index;
   CHAR16 *Str;
   // Check parameters
   if (String == NULL) {
     return NULL;
   }
   // Get string length
-  Length = AsciiStrLen(String);
+  Length = AsciiStrWordLength(String);
   if (Length == 0) {
     return NULL;
   }
   // Allocate new string
-  Str = (CHAR16 *)AllocateZeroPool((Length + 1) * sizeof(CHAR16));
-  if (Str != NULL) {
-    // Convert the string
-    if (EFI_ERROR(AsciiStrToUnicodeStrS(String, Str, Length + 1))) {
-      FreePool(Str);
-      Str = NULL;
+  Str = (CHAR16 *)AllocatePool((Length + 1) * sizeof(CHAR16));
+  if (Str == NULL) {
+    return NULL;
+  }
+  // Convert the string
+  for (Index = 0; Index < Length; ++Index) {
+    Str[Index] = (CHAR16)(UINT8)String[Index];
+  }
+  Str[Length] = L'\0';
+  return Str;
+}
+// Utf16ToUtf8
+/// Convert UTF-16 characters to UTF-8 characters in a caller buffer, surrogate pairs are combined and unpaired surrogates are invalid
+/// @param Count  The count of UTF-16 characters to convert
+/// @param String The UTF-16 characters to convert
+/// @param Size   On input, the size, in bytes, of the buffer, on output, the exact size, in bytes, of the UTF-8 characters
+/// @param Utf8   The buffer for the UTF-8 characters, which is not null-terminated
+/// @return Whether the characters were converted or not
+/// @retval EFI_INVALID_PARAMETER If Size is NULL, String is NULL and Count is not zero, or there is an unpaired surrogate
+/// @retval EFI_BUFFER_TOO_SMALL  If Utf8 is NULL or the buffer is too small, *Size is updated with the size needed
+/// @retval EFI_SUCCESS           If the characters were converted successfully
+EFI_STATUS
+EFIAPI
+Utf16ToUtf8 (
+  IN     UINTN   Count,
+  IN     CHAR16 *String,
+  IN OUT UINTN  *Size,
+  OUT    CHAR8  *Utf8 OPTIONAL
+) {
+  UINTN  Capacity;
+  UINTN  Offset = 0;
+  UINTN  Index = 0;
+  UINTN  Length;
+  UINTN  Lane;
+  UINTN  Word;
+  UINT32 Character;
+  // Check parameters
+  if ((Size == NULL) || ((String == NULL) && (Count != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Characters are only written while they fit so the exact size is still counted when the buffer is too small
+  Capacity = (Utf8 == NULL) ? 0 : *Size;
+  while (Index < Count) {
+    // Convert a word of ASCII characters at a time while the string is aligned, all targets are little endian
+    if ((((UINTN)(String + Index) & STR_WORD_MASK) == 0) && ((Count - Index) >= STR_WORD_CHARS)) {
+      Word = *(UINTN *)(String + Index);
+      if (STR_WORD_IS_ASCII(Word)) {
+        if ((Offset + STR_WORD_CHARS) <= Capacity) {
+          for (Lane = 0; Lane < STR_WORD_CHARS; ++Lane) {
+            Utf8[Offset + Lane] = (CHAR8)(Word >> (Lane << 4));
+          }
+        }
+        Offset += STR_WORD_CHARS;
+        Index += STR_WORD_CHARS;
+        continue;
+      }
+    }
+    // Get the length of the sequence for the next character
+    Character = String[Index++];
+    if (Character < 0x80) {
+      Length = 1;
+    } else if (Character < 0x800) {
+      Length = 2;
+    } else if ((Character < 0xD800) || (Character >= 0xE000)) {
+      Length = 3;
+    } else {
+      // A high surrogate must be followed by a low surrogate
+      if ((Character >= 0xDC00) || (Index >= Count) || (String[Index] < 0xDC00) || (String[Index] >= 0xE000)) {
+        return EFI_INVALID_PARAMETER;
+      }
+      Character = (0x10000 + ((Character - 0xD800) << 10) + (String[Index++] - 0xDC00));
+      Length = 4;
+    }
+    // Write the sequence
+    if ((Offset + Length) <= Capacity) {
+      switch (Length) {
+        case 1:
+          Utf8[Offset] = (CHAR8)Character;
+          break;
+
+        case 2:
+          Utf8[Offset] = (CHAR8)(0xC0 | (Character >> 6));
+          Utf8[Offset + 1] = (CHAR8)(0x80 | (Character & 0x3F));
+          break;
+
+        case 3:
+          Utf8[Offset] = (CHAR8)(0xE0 | (Character >> 12));
+          Utf8[Offset + 1] = (CHAR8)(0x80 | ((Character >> 6) & 0x3F));
+          Utf8[Offset + 2] = (CHAR8)(0x80 | (Character & 0x3F));
+          break;
+
+        default:
+          Utf8[Offset] = (CHAR8)(0xF0 | (Character >> 18));
+          Utf8[Offset + 1] = (CHAR8)(0x80 | ((Character >> 12) & 0x3F));
+          Utf8[Offset + 2] = (CHAR8)(0x80 | ((Character >> 6) & 0x3F));
+          Utf8[Offset + 3] = (CHAR8)(0x80 | (Character & 0x3F));
+          break;
+      }
+    }
+    Offset += Length;
+  }
+  // Return the exact size
+  *Size = Offset;
+  if ((Offset > Capacity) || ((Utf8 == NULL) && (Offset != 0))) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  return EFI_SUCCESS;
+}
+// Utf8ToUtf16
+/// Convert UTF-8 characters to UTF-16 characters in a caller buffer, truncated, overlong and surrogate sequences
+///  and code points above the unicode range are invalid
+/// @param Size   The size, in bytes, of the UTF-8 characters to convert
+/// @param Utf8   The UTF-8 characters to convert
+/// @param Count  On input, the size, in characters, of the buffer, on output, the exact count of UTF-16 characters
+/// @param String The buffer for the UTF-16 characters, which is not null-terminated
+/// @return Whether the characters were converted or not
+/// @retval EFI_INVALID_PARAMETER If Count is NULL, Utf8 is NULL and Size is not zero, or there is an invalid sequence
+/// @retval EFI_BUFFER_TOO_SMALL  If String is NULL or the buffer is too small, *Count is updated with the size needed
+/// @retval EFI_SUCCESS           If the characters were converted successfully
+EFI_STATUS
+EFIAPI
+Utf8ToUtf16 (
+  IN     UINTN   Size,
+  IN     CHAR8  *Utf8,
+  IN OUT UINTN  *Count,
+  OUT    CHAR16 *String OPTIONAL
+) {
+  UINTN  Capacity;
+  UINTN  Offset = 0;
+  UINTN  Index = 0;
+  UINTN  Needed;
+  UINTN  Lane;
+  UINTN  Word;
+  UINT32 Minimum;
+  UINT32 Character;
+  UINT8  Byte;
+  // Check parameters
+  if ((Count == NULL) || ((Utf8 == NULL) && (Size != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Characters are only written while they fit so the exact count is still counted when the buffer is too small
+  Capacity = (String == NULL) ? 0 : *Count;
+  while (Index < Size) {
+    // Convert a word of ASCII characters at a time while the characters are aligned
+    if ((((UINTN)(Utf8 + Index) & STR_WORD_MASK) == 0) && ((Size - Index) >= ASCII_WORD_CHARS)) {
+      Word = *(UINTN *)(Utf8 + Index);
+      if (ASCII_WORD_IS_ASCII(Word)) {
+        if ((Offset + ASCII_WORD_CHARS) <= Capacity) {
+          for (Lane = 0; Lane < ASCII_WORD_CHARS; ++Lane) {
+            String[Offset + Lane] = (CHAR16)(UINT8)(Word >> (Lane << 3));
+          }
+        }
+        Offset += ASCII_WORD_CHARS;
+        Index += ASCII_WORD_CHARS;
+        continue;
+      }
+    }
+    // Decode the leading byte of the sequence
+    Byte = (UINT8)Utf8[Index++];
+    if (Byte < 0x80) {
+      if (Offset < Capacity) {
+        String[Offset] = (CHAR16)Byte;
+      }
+      ++Offset;
+      continue;
+    }
+    if ((Byte & 0xE0) == 0xC0) {
+      Needed = 1;
+      Minimum = 0x80;
+      Character = (Byte & 0x1F);
+    } else if ((Byte & 0xF0) == 0xE0) {
+      Needed = 2;
+      Minimum = 0x800;
+      Character = (Byte & 0x0F);
+    } else if ((Byte & 0xF8) == 0xF0) {
+      Needed = 3;
+      Minimum = 0x10000;
+      Character = (Byte & 0x07);
+    } else {
+      return EFI_INVALID_PARAMETER;
+    }
+    // Decode the continuation bytes
+    if ((Size - Index) < Needed) {
+      return EFI_INVALID_PARAMETER;
+    }
+    while (Needed-- > 0) {
+      Byte = (UINT8)Utf8[Index++];
+      if ((Byte & 0xC0) != 0x80) {
+        return EFI_INVALID_PARAMETER;
+      }
+      Character = ((Character << 6) | (Byte & 0x3F));
+    }
+    // Overlong sequences, surrogates and code points above the unicode range are invalid
+    if ((Character < Minimum) || (Character > 0x10FFFF) || ((Character >= 0xD800) && (Character < 0xE000))) {
+      return EFI_INVALID_PARAMETER;
+    }
+    // Write the character or surrogate pair
+    if (Character < 0x10000) {
+      if (Offset < Capacity) {
+        String[Offset] = (CHAR16)Character;
+      }
+      ++Offset;
+    } else {
+      if ((Offset + 2) <= Capacity) {
+        String[Offset] = (CHAR16)(0xD800 + ((Character - 0x10000) >> 10));
+        String[Offset + 1] = (CHAR16)(0xDC00 + (Character & 0x3FF));
+      }
+      Offset += 2;
     }
   }
+  // Return the exact count
+  *Count = Offset;
+  if ((Offset > Capacity) || ((String == NULL) && (Offset != 0))) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  return EFI_SUCCESS;
+}
+// ToUtf8
+/// Convert string to UTF-8
+/// @param String The string to convert
+/// @return The converted string, which must be freed, or NULL if there was an error or an unpaired surrogate
+CHAR8 *
+EFIAPI
+ToUtf8 (
+  IN CHAR16 *String
+) {
+  UINTN  Length;
+  UINTN  Size = 0;
+  CHAR8 *Str;
+  // Check parameters
+  if (String == NULL) {
+    return NULL;
+  }
+  // Get the exact size of the converted string
+  Length = StrWordLength(String);
+  if (Utf16ToUtf8(Length, String, &Size, NULL) == EFI_INVALID_PARAMETER) {
+    return NULL;
+  }
+  // Allocate new string
+  Str = (CHAR8 *)AllocatePool((Size + 1) * sizeof(CHAR8));
+  if (Str == NULL) {
+    return NULL;
+  }
+  // Convert the string
+  if (EFI_ERROR(Utf16ToUtf8(Length, String, &Size, Str))) {
+    FreePool(Str);
+    return NULL;
+  }
+  Str[Size] = '\0';
+  return Str;
+}
+// FromUtf8
+/// Convert string from UTF-8
+/// @param String The string to convert
+/// @return The converted string, which must be freed, or NULL if there was an error or an invalid sequence
+CHAR16 *
+EFIAPI
+FromUtf8 (
+  IN CHAR8 *String
+) {
+  UINTN   Size;
+  UINTN   Count = 0;
+  CHAR16 *Str;
+  // Check parameters
+  if (String == NULL) {
+    return NULL;
+  }
+  // Get the exact count of the converted string
+  Size = AsciiStrWordLength(String);
+  if (Utf8ToUtf16(Size, String, &Count, NULL) == EFI_INVALID_PARAMETER) {
+    return NULL;
+  }
+  // Allocate new string
+  Str = (CHAR16 *)AllocatePool((Count + 1) * sizeof(CHAR16));
+  if (Str == NULL) {
+    return NULL;
+  }
+  // Convert the string
+  if (EFI_ERROR(Utf8ToUtf16(Size, String, &Count, Str))) {
+    FreePool(Str);
+    return NULL;
+  }
+  Str[Count] = L'\0';
   return Str;
 }
 
+// FindCollationProtocol
+/// Find the collation protocol that supports a language, found protocols are cached for each language but languages
+///  without a protocol are searched again since a collation protocol may be installed later
+/// @param Language The language code
+/// @return The collation protocol that supports the language or NULL if none was found
+STATIC EFI_UNICODE_COLLATION_PROTOCOL *
+EFIAPI
+FindCollationProtocol (
+  IN CHAR8 *Language
+) {
+  EFI_UNICODE_COLLATION_PROTOCOL *Collation;
+  COLLATION_LANGUAGE             *Entry;
+  EFI_HANDLE                     *Handles = NULL;
+  CHAR8                          *LanguageCode;
+  UINTN                           Count = 0;
+  UINTN                           Index;
+  // Check if the language was already discovered
+  for (Entry = mCollationLanguages; Entry != NULL; Entry = Entry->Next) {
+    if (AsciiStriCmp(Entry->Language, Language) == 0) {
+      return Entry->Protocol;
+    }
+  }
+  // Locate collation protocols that give language codes in RFC 4646
+  Collation = NULL;
+  if (!EFI_ERROR(gBS->LocateHandleBuffer(ByProtocol, &gEfiUnicodeCollation2ProtocolGuid, NULL, &Count, &Handles)) && (Handles != NULL)) {
+    // On first pass try to exact match 
+    for (Index = 0; Index < Count; ++Index) {
+      // Get each collation protocol
+      Collation = NULL;
+      if (EFI_ERROR(gBS->HandleProtocol(Handles[Index], &gEfiUnicodeCollation2ProtocolGuid, (VOID **)&Collation))) {
+        continue;
+      }
+      // Check the collation protocol has valid language support
+      if ((Collation == NULL) || (Collation->SupportedLanguages == NULL)) {
+        Collation = NULL;
+        continue;
+      }
+      // Check if this protocol supports this language
+      LanguageCode = GetBestLanguage(Collation->SupportedLanguages, FALSE, Language, NULL);
+      if (LanguageCode == NULL) {
+        Collation = NULL;
+        continue;
+      }
+      FreePool(LanguageCode);
+      break;
+    }
+    FreePool(Handles);
+  }
+  if (Collation == NULL) {
+    return NULL;
+  }
+  // Remember the collation protocol for the language
+  Entry = (COLLATION_LANGUAGE *)AllocateZeroPool(sizeof(COLLATION_LANGUAGE));
+  if (Entry != NULL) {
+    Entry->Language = AsciiStrDup(Language);
+    if (Entry->Language == NULL) {
+      FreePool(Entry);
+    } else {
+      Entry->Protocol = Collation;
+      Entry->Next = mCollationLanguages;
+      mCollationLanguages = Entry;
+    }
+  }
+  return Collation;
+}
+// GetPlatformLanguages
+/// Get the supported platform languages, which are only retrieved once
+/// @return The supported platform languages, which must not be freed, or NULL if they could not be retrieved
+STATIC CHAR8 *
+EFIAPI
+GetPlatformLanguages (
+  VOID
+) {
+  if (mPlatformLanguages == NULL) {
+    CHAR8 *PlatformLanguages = NULL;
+    if (!EFI_ERROR(GetEfiGlobalVariable2(L"PlatformLangCodes", (VOID **)&PlatformLanguages, NULL))) {
+      mPlatformLanguages = PlatformLanguages;
+    }
+  }
+  return mPlatformLanguages;
+}
+
 // SetLanguage
 /// Set the language
 /// @param Language The language code to discover collation protocol or NULL for default english
@@ -1495,9 +3238,10 @@ SetLanguage (
 ) {
   EFI_STATUS  Status;
   UINT32      Options = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS;
-  CHAR8      *PlatformLanguages = NULL;
+  CHAR8      *PlatformLanguages;
   CHAR8      *RequestLanguage;
   CHAR8      *LanguageCode;
+  CHAR8      *CurrentLanguage;
   // Get the language to set
   if ((Language != NULL) && (AsciiStrLen(Language) > 0)) {
     RequestLanguage = Language;
@@ -1506,53 +3250,37 @@ SetLanguage (
     Language = NULL;
   }
   // Get the supported platform languages
-  Status = GetEfiGlobalVariable2(L"PlatformLangCodes", (VOID **)&PlatformLanguages, NULL);
-  if (EFI_ERROR(Status)) {
-    return Status;
-  }
-  if(PlatformLanguages == NULL) {
-    return EFI_OUT_OF_RESOURCES;
+  PlatformLanguages = GetPlatformLanguages();
+  if (PlatformLanguages == NULL) {
+    return EFI_NOT_FOUND;
   }
   // Get the best language code
   LanguageCode = GetBestLanguage(PlatformLanguages, FALSE, RequestLanguage, NULL);
-  FreePool(PlatformLanguages);
   if (LanguageCode == NULL) {
     return EFI_NOT_FOUND;
   }
-  // Set platform language
-  Status = gRT->SetVariable(L"PlatformLang", &gEfiGlobalVariableGuid, Options, AsciiStrSize(LanguageCode), (VOID *)LanguageCode);
+  // Get the current platform language to avoid writing a non-volatile variable that has not changed, it is read each
+  //  time since anything else may have changed it
+  CurrentLanguage = NULL;
+  GetEfiGlobalVariable2(L"PlatformLang", (VOID **)&CurrentLanguage, NULL);
+  if ((CurrentLanguage != NULL) && (AsciiStrCmp(CurrentLanguage, LanguageCode) == 0)) {
+    Status = EFI_SUCCESS;
+  } else {
+    // Set platform language
+    Status = gRT->SetVariable(L"PlatformLang", &gEfiGlobalVariableGuid, Options, AsciiStrSize(LanguageCode), (VOID *)LanguageCode);
+  }
+  if (CurrentLanguage != NULL) {
+    FreePool(CurrentLanguage);
+  }
   FreePool(LanguageCode);
   if (EFI_ERROR(Status)) {
     return Status;
   }
   // Search for collation protocol
   if ((Language != NULL) && (gBS != NULL) && (gBS->HandleProtocol != NULL) && (gBS->LocateHandleBuffer != NULL)) {
-    EFI_UNICODE_COLLATION_PROTOCOL *Collation;
-    EFI_HANDLE                     *Handles = NULL;
-    UINTN                           Count = 0;
-    UINTN                           Index;
-    // Locate collation protocols that give language codes in RFC 4646
-    if (!EFI_ERROR(gBS->LocateHandleBuffer(ByProtocol, &gEfiUnicodeCollation2ProtocolGuid, NULL, &Count, &Handles)) && (Handles != NULL)) {
-      // On first pass try to exact match 
-      for (Index = 0; Index < Count; ++Index) {
-        // Get each collation protocol
-        Collation = NULL;
-        if (EFI_ERROR(gBS->HandleProtocol(Handles[Index], &gEfiUnicodeCollation2ProtocolGuid, (VOID **)&Collation))) {
-          continue;
-        }
-        // Check the collation protocol has valid language support
-        if ((Collation == NULL) || (Collation->SupportedLanguages == NULL)) {
-          continue;
-        }
-        // Check if this protocol supports this language
-        LanguageCode = GetBestLanguage(Collation->SupportedLanguages, FALSE, RequestLanguage, NULL);
-        if (LanguageCode == NULL) {
-          continue;
-        }
-        FreePool(LanguageCode);
-        mCollationProtocol = Collation;
-        break;
-      }
+    EFI_UNICODE_COLLATION_PROTOCOL *Collation = FindCollationProtocol(RequestLanguage);
+    if (Collation != NULL) {
+      mCollationProtocol = Collation;
     }
   } else {
     // Set default collation protocol
@@ -1601,15 +3329,15 @@ GetLanguages (
 ) {
   EFI_STATUS   Status = EFI_SUCCESS;
   CHAR8      **AvailableLanguages = NULL;
-  CHAR8       *PlatformLanguages = NULL;
+  CHAR8       *PlatformLanguages;
   UINTN        LanguageCount = 0;
   if ((Languages == NULL) || (*Languages != NULL) || (Count == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
   // Get the languages from the platform
-  if (!EFI_ERROR(GetEfiGlobalVariable2(L"PlatformLangCodes", (VOID **)&PlatformLanguages, NULL)) && (PlatformLanguages != NULL)) {
+  PlatformLanguages = GetPlatformLanguages();
+  if (PlatformLanguages != NULL) {
     Status = AsciiStrSplit(&AvailableLanguages, &LanguageCount, PlatformLanguages, ";", STR_LIST_NO_DUPLICATES | STR_LIST_CASE_INSENSITIVE | STR_LIST_SORTED);
-    FreePool(PlatformLanguages);
   }
   if (!EFI_ERROR(Status)) {
     // Get the default language
@@ -1639,15 +3367,15 @@ StringLibInitialize (
 
   // Initialize unicode collation for english as fallback
   for (Index = 0; Index < MAP_TABLE_SIZE; ++Index) {
-    mEngUpperMap[Index] = (CHAR8)Index;
-    mEngLowerMap[Index] = (CHAR8)Index;
+    mEngUpperMap[Index] = (UINT8)Index;
+    mEngLowerMap[Index] = (UINT8)Index;
     mEngInfoMap[Index]  = 0;
 
     if (((Index >= 'a') && (Index <= 'z')) || ((Index >= 0xe0) && (Index <= 0xf6)) || ((Index >= 0xf8) && (Index <= 0xfe))) {
 
       Index2 = (Index - 0x20);
-      mEngUpperMap[Index] = (CHAR8)Index2;
-      mEngLowerMap[Index2] = (CHAR8)Index;
+      mEngUpperMap[Index] = (UINT8)Index2;
+      mEngLowerMap[Index2] = (UINT8)Index;
 
       mEngInfoMap[Index] |= CHAR_FAT_VALID;
       mEngInfoMap[Index2] |= CHAR_FAT_VALID;
@@ -1670,5 +3398,17 @@ EFIAPI
 StringLibFinish (
   VOID
 ) {
+  // Free the discovered collation languages
+  while (mCollationLanguages != NULL) {
+    COLLATION_LANGUAGE *Entry = mCollationLanguages;
+    mCollationLanguages = Entry->Next;
+    FreePool(Entry->Language);
+    FreePool(Entry);
+  }
+  // Free the cached platform languages
+  if (mPlatformLanguages != NULL) {
+    FreePool(mPlatformLanguages);
+    mPlatformLanguages = NULL;
+  }
   return EFI_SUCCESS;
 }
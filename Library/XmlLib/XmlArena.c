@@ -0,0 +1,303 @@
+//
+/// @file Library/XmlLib/XmlArena.c
+///
+/// XML arena
+///
+
+#include "XmlStates.h"
+
+// XmlArenaAlign
+/// Align a size to the XML arena allocation alignment
+/// @param Size The size, in bytes, to align
+/// @return The aligned size
+STATIC UINTN
+EFIAPI
+XmlArenaAlign (
+  IN UINTN Size
+) {
+  return (Size + (XML_ARENA_ALIGNMENT - 1)) & ~((UINTN)(XML_ARENA_ALIGNMENT - 1));
+}
+// XmlArenaBlockCreate
+/// Create an XML arena block
+/// @param Size The size, in bytes, available for allocations in the block
+/// @return The created block or NULL if memory could not be allocated
+STATIC XML_ARENA_BLOCK *
+EFIAPI
+XmlArenaBlockCreate (
+  IN UINTN Size
+) {
+  XML_ARENA_BLOCK *Block;
+  // Allocate the block with the allocations following the header
+  Block = (XML_ARENA_BLOCK *)AllocatePool(XmlArenaAlign(sizeof(XML_ARENA_BLOCK)) + Size);
+  if (Block == NULL) {
+    return NULL;
+  }
+  Block->Next = NULL;
+  Block->Size = Size;
+  Block->Used = 0;
+  Block->Last = 0;
+  return Block;
+}
+// XmlArenaBlockData
+/// Get the start of the allocations in an XML arena block
+/// @param Block The XML arena block
+/// @return The start of the allocations
+STATIC UINT8 *
+EFIAPI
+XmlArenaBlockData (
+  IN XML_ARENA_BLOCK *Block
+) {
+  return ((UINT8 *)Block) + XmlArenaAlign(sizeof(XML_ARENA_BLOCK));
+}
+
+// XmlHashName
+/// Hash a name
+/// @param Name   The name
+/// @param Length The length of the name in characters
+/// @param Seed   The seed of the hash
+/// @return The hash of the name
+UINT32
+EFIAPI
+XmlHashName (
+  IN CHAR16 *Name,
+  IN UINTN   Length,
+  IN UINT32  Seed
+) {
+  UINT32 Hash = XML_HASH_BASIS ^ Seed;
+  while (Length-- > 0) {
+    Hash ^= (UINT32)*Name++;
+    Hash *= XML_HASH_PRIME;
+  }
+  return Hash;
+}
+
+// XmlArenaAllocate
+/// Allocate zeroed memory from an XML arena
+/// @param Arena The XML arena
+/// @param Size  The size, in bytes, to allocate
+/// @return The allocated memory, which is released with the arena, or NULL if memory could not be allocated
+VOID *
+EFIAPI
+XmlArenaAllocate (
+  IN OUT XML_ARENA *Arena,
+  IN     UINTN      Size
+) {
+  XML_ARENA_BLOCK *Block;
+  UINT8           *Buffer;
+  // Check parameters
+  if ((Arena == NULL) || (Size == 0)) {
+    return NULL;
+  }
+  Size = XmlArenaAlign(Size);
+  // Check if the allocation fits in the current block
+  Block = Arena->Blocks;
+  if ((Block == NULL) || (Size > (Block->Size - Block->Used))) {
+    if (Size > (XML_ARENA_BLOCK_SIZE >> 2)) {
+      // Large allocations get their own block behind the current block so the current block keeps filling
+      Block = XmlArenaBlockCreate(Size);
+      if (Block == NULL) {
+        return NULL;
+      }
+      if (Arena->Blocks == NULL) {
+        Arena->Blocks = Block;
+      } else {
+        Block->Next = Arena->Blocks->Next;
+        Arena->Blocks->Next = Block;
+      }
+    } else {
+      // Start a new current block
+      Block = XmlArenaBlockCreate(XML_ARENA_BLOCK_SIZE);
+      if (Block == NULL) {
+        return NULL;
+      }
+      Block->Next = Arena->Blocks;
+      Arena->Blocks = Block;
+    }
+  }
+  // Allocate from the block
+  Block->Last = Block->Used;
+  Block->Used += Size;
+  Buffer = XmlArenaBlockData(Block) + Block->Last;
+  ZeroMem(Buffer, Size);
+  return Buffer;
+}
+// XmlArenaReallocate
+/// Reallocate memory from an XML arena, the memory grows in place if it was the last allocation
+/// @param Arena   The XML arena
+/// @param Buffer  The memory to reallocate
+/// @param OldSize The size, in bytes, of the memory to reallocate
+/// @param NewSize The size, in bytes, to reallocate
+/// @return The reallocated memory, which is released with the arena, or NULL if memory could not be allocated
+VOID *
+EFIAPI
+XmlArenaReallocate (
+  IN OUT XML_ARENA *Arena,
+  IN     VOID      *Buffer OPTIONAL,
+  IN     UINTN      OldSize,
+  IN     UINTN      NewSize
+) {
+  XML_ARENA_BLOCK *Block;
+  VOID            *Ptr;
+  // Check parameters
+  if (Arena == NULL) {
+    return NULL;
+  }
+  if (Buffer == NULL) {
+    return XmlArenaAllocate(Arena, NewSize);
+  }
+  if (NewSize <= OldSize) {
+    return Buffer;
+  }
+  // Grow in place if this was the last allocation of the current block
+  Block = Arena->Blocks;
+  if ((Block != NULL) && (Buffer == (VOID *)(XmlArenaBlockData(Block) + Block->Last))) {
+    UINTN Size = XmlArenaAlign(NewSize);
+    if (Size <= (Block->Size - Block->Last)) {
+      ZeroMem(((UINT8 *)Buffer) + OldSize, Size - OldSize);
+      Block->Used = Block->Last + Size;
+      return Buffer;
+    }
+  }
+  // Allocate new memory and copy, the old memory is released with the arena
+  Ptr = XmlArenaAllocate(Arena, NewSize);
+  if (Ptr == NULL) {
+    return NULL;
+  }
+  CopyMem(Ptr, Buffer, OldSize);
+  return Ptr;
+}
+// XmlArenaStrDup
+/// Duplicate a string into an XML arena
+/// @param Arena  The XML arena
+/// @param String The string to duplicate
+/// @return The duplicated string, which is released with the arena, or NULL if memory could not be allocated
+CHAR16 *
+EFIAPI
+XmlArenaStrDup (
+  IN OUT XML_ARENA *Arena,
+  IN     CHAR16    *String OPTIONAL
+) {
+  CHAR16 *Duplicate;
+  UINTN   Size;
+  // Check parameters
+  if ((Arena == NULL) || (String == NULL)) {
+    return NULL;
+  }
+  // Allocate and copy the string
+  Size = StrSize(String);
+  Duplicate = (CHAR16 *)XmlArenaAllocate(Arena, Size);
+  if (Duplicate != NULL) {
+    CopyMem(Duplicate, String, Size);
+  }
+  return Duplicate;
+}
+// XmlArenaIntern
+/// Intern a name into an XML arena
+/// @param Arena The XML arena
+/// @param Name  The name to intern
+/// @return The interned name, which is the same for equal names and released with the arena, or NULL if memory could not be allocated
+CHAR16 *
+EFIAPI
+XmlArenaIntern (
+  IN OUT XML_ARENA *Arena,
+  IN     CHAR16    *Name
+) {
+  XML_NAME  *Ptr;
+  XML_NAME  *Next;
+  XML_NAME **Names;
+  UINTN      Size;
+  UINTN      Index;
+  UINT32     Hash;
+  // Check parameters
+  if ((Arena == NULL) || (Name == NULL)) {
+    return NULL;
+  }
+  // Check if the name was already interned
+  Hash = XmlHashName(Name, StrLen(Name), 0);
+  if (Arena->Names != NULL) {
+    for (Ptr = Arena->Names[Hash & (Arena->NameSize - 1)]; Ptr != NULL; Ptr = Ptr->Next) {
+      if ((Ptr->Hash == Hash) && (StrCmp(Ptr->Name, Name) == 0)) {
+        return Ptr->Name;
+      }
+    }
+  }
+  // Grow the buckets if needed, the previous buckets are released with the arena
+  if (Arena->NameCount >= Arena->NameSize) {
+    Size = (Arena->NameSize == 0) ? XML_NAMES_SIZE : (Arena->NameSize << 1);
+    Names = (XML_NAME **)XmlArenaAllocate(Arena, Size * sizeof(XML_NAME *));
+    if (Names == NULL) {
+      return NULL;
+    }
+    // Rehash the interned names into the new buckets
+    for (Index = 0; Index < Arena->NameSize; ++Index) {
+      for (Ptr = Arena->Names[Index]; Ptr != NULL; Ptr = Next) {
+        Next = Ptr->Next;
+        Ptr->Next = Names[Ptr->Hash & (Size - 1)];
+        Names[Ptr->Hash & (Size - 1)] = Ptr;
+      }
+    }
+    Arena->Names = Names;
+    Arena->NameSize = Size;
+  }
+  // Allocate the interned name
+  Ptr = (XML_NAME *)XmlArenaAllocate(Arena, sizeof(XML_NAME));
+  if (Ptr == NULL) {
+    return NULL;
+  }
+  Ptr->Hash = Hash;
+  Ptr->Name = XmlArenaStrDup(Arena, Name);
+  if (Ptr->Name == NULL) {
+    return NULL;
+  }
+  // Add the name to its bucket
+  Ptr->Next = Arena->Names[Hash & (Arena->NameSize - 1)];
+  Arena->Names[Hash & (Arena->NameSize - 1)] = Ptr;
+  ++(Arena->NameCount);
+  return Ptr->Name;
+}
+// XmlArenaFindName
+/// Find an interned name in an XML arena
+/// @param Arena The XML arena
+/// @param Name  The name to find
+/// @return The interned name or NULL if the name was never interned
+CHAR16 *
+EFIAPI
+XmlArenaFindName (
+  IN XML_ARENA *Arena,
+  IN CHAR16    *Name
+) {
+  XML_NAME *Ptr;
+  UINT32    Hash;
+  // Check parameters
+  if ((Arena == NULL) || (Name == NULL) || (Arena->Names == NULL)) {
+    return NULL;
+  }
+  // Search the bucket of the name
+  Hash = XmlHashName(Name, StrLen(Name), 0);
+  for (Ptr = Arena->Names[Hash & (Arena->NameSize - 1)]; Ptr != NULL; Ptr = Ptr->Next) {
+    if ((Ptr->Hash == Hash) && (StrCmp(Ptr->Name, Name) == 0)) {
+      return Ptr->Name;
+    }
+  }
+  return NULL;
+}
+// XmlArenaFree
+/// Release all memory allocated from an XML arena
+/// @param Arena The XML arena
+VOID
+EFIAPI
+XmlArenaFree (
+  IN OUT XML_ARENA *Arena
+) {
+  if (Arena != NULL) {
+    while (Arena->Blocks != NULL) {
+      XML_ARENA_BLOCK *Block = Arena->Blocks;
+      Arena->Blocks = Block->Next;
+      FreePool(Block);
+    }
+    // The interned names were allocated from the arena
+    Arena->Names = NULL;
+    Arena->NameCount = 0;
+    Arena->NameSize = 0;
+  }
+}
@@ -0,0 +1,720 @@
+//
+/// @file Library/XmlLib/XmlEntities.c
+///
+/// XML character and declared entities
+///
+
+#include "XmlStates.h"
+
+// XML_NAMED_ENTITY_BUCKETS
+/// The count of buckets in the named entity perfect hash, must be a power of two
+#define XML_NAMED_ENTITY_BUCKETS 128
+// XML_NAMED_ENTITY_SLOTS
+/// The count of slots in the named entity perfect hash, must be a power of two
+#define XML_NAMED_ENTITY_SLOTS 512
+// XML_NAMED_ENTITY_FOLD_LENGTH
+/// The length of the longest named entity that matches in any case
+#define XML_NAMED_ENTITY_FOLD_LENGTH 4
+
+// XML_NAMED_ENTITY
+/// XML predefined named entity
+typedef struct _XML_NAMED_ENTITY XML_NAMED_ENTITY;
+struct _XML_NAMED_ENTITY {
+
+  // Name
+  /// The entity name
+  CHAR16  *Name;
+  // Character
+  /// The character to which the entity is replaced
+  CHAR16   Character;
+  // AnyCase
+  /// Whether the entity name matches in any case
+  BOOLEAN  AnyCase;
+
+};
+
+// mXmlNamedEntities
+/// The predefined XML and HTML named entities, the non-breaking space is replaced by a space as it always was
+STATIC XML_NAMED_ENTITY mXmlNamedEntities[] = {
+  { L"AElig",    0x00C6 },
+  { L"Aacute",   0x00C1 },
+  { L"Acirc",    0x00C2 },
+  { L"Agrave",   0x00C0 },
+  { L"Alpha",    0x0391 },
+  { L"Aring",    0x00C5 },
+  { L"Atilde",   0x00C3 },
+  { L"Auml",     0x00C4 },
+  { L"Beta",     0x0392 },
+  { L"Ccedil",   0x00C7 },
+  { L"Chi",      0x03A7 },
+  { L"Dagger",   0x2021 },
+  { L"Delta",    0x0394 },
+  { L"ETH",      0x00D0 },
+  { L"Eacute",   0x00C9 },
+  { L"Ecirc",    0x00CA },
+  { L"Egrave",   0x00C8 },
+  { L"Epsilon",  0x0395 },
+  { L"Eta",      0x0397 },
+  { L"Euml",     0x00CB },
+  { L"Gamma",    0x0393 },
+  { L"Iacute",   0x00CD },
+  { L"Icirc",    0x00CE },
+  { L"Igrave",   0x00CC },
+  { L"Iota",     0x0399 },
+  { L"Iuml",     0x00CF },
+  { L"Kappa",    0x039A },
+  { L"Lambda",   0x039B },
+  { L"Mu",       0x039C },
+  { L"Ntilde",   0x00D1 },
+  { L"Nu",       0x039D },
+  { L"OElig",    0x0152 },
+  { L"Oacute",   0x00D3 },
+  { L"Ocirc",    0x00D4 },
+  { L"Ograve",   0x00D2 },
+  { L"Omega",    0x03A9 },
+  { L"Omicron",  0x039F },
+  { L"Oslash",   0x00D8 },
+  { L"Otilde",   0x00D5 },
+  { L"Ouml",     0x00D6 },
+  { L"Phi",      0x03A6 },
+  { L"Pi",       0x03A0 },
+  { L"Prime",    0x2033 },
+  { L"Psi",      0x03A8 },
+  { L"Rho",      0x03A1 },
+  { L"Scaron",   0x0160 },
+  { L"Sigma",    0x03A3 },
+  { L"THORN",    0x00DE },
+  { L"Tau",      0x03A4 },
+  { L"Theta",    0x0398 },
+  { L"Uacute",   0x00DA },
+  { L"Ucirc",    0x00DB },
+  { L"Ugrave",   0x00D9 },
+  { L"Upsilon",  0x03A5 },
+  { L"Uuml",     0x00DC },
+  { L"Xi",       0x039E },
+  { L"Yacute",   0x00DD },
+  { L"Yuml",     0x0178 },
+  { L"Zeta",     0x0396 },
+  { L"aacute",   0x00E1 },
+  { L"acirc",    0x00E2 },
+  { L"acute",    0x00B4 },
+  { L"aelig",    0x00E6 },
+  { L"agrave",   0x00E0 },
+  { L"alefsym",  0x2135 },
+  { L"alpha",    0x03B1 },
+  { L"amp",      0x0026, TRUE },
+  { L"and",      0x2227 },
+  { L"ang",      0x2220 },
+  { L"apos",     0x0027, TRUE },
+  { L"aring",    0x00E5 },
+  { L"asymp",    0x2248 },
+  { L"atilde",   0x00E3 },
+  { L"auml",     0x00E4 },
+  { L"bdquo",    0x201E },
+  { L"beta",     0x03B2 },
+  { L"brvbar",   0x00A6 },
+  { L"bull",     0x2022 },
+  { L"cap",      0x2229 },
+  { L"ccedil",   0x00E7 },
+  { L"cedil",    0x00B8 },
+  { L"cent",     0x00A2 },
+  { L"chi",      0x03C7 },
+  { L"circ",     0x02C6 },
+  { L"clubs",    0x2663 },
+  { L"cong",     0x2245 },
+  { L"copy",     0x00A9 },
+  { L"crarr",    0x21B5 },
+  { L"cup",      0x222A },
+  { L"curren",   0x00A4 },
+  { L"dArr",     0x21D3 },
+  { L"dagger",   0x2020 },
+  { L"darr",     0x2193 },
+  { L"deg",      0x00B0 },
+  { L"delta",    0x03B4 },
+  { L"diams",    0x2666 },
+  { L"divide",   0x00F7 },
+  { L"eacute",   0x00E9 },
+  { L"ecirc",    0x00EA },
+  { L"egrave",   0x00E8 },
+  { L"empty",    0x2205 },
+  { L"emsp",     0x2003 },
+  { L"ensp",     0x2002 },
+  { L"epsilon",  0x03B5 },
+  { L"equiv",    0x2261 },
+  { L"eta",      0x03B7 },
+  { L"eth",      0x00F0 },
+  { L"euml",     0x00EB },
+  { L"euro",     0x20AC },
+  { L"exist",    0x2203 },
+  { L"fnof",     0x0192 },
+  { L"forall",   0x2200 },
+  { L"frac12",   0x00BD },
+  { L"frac14",   0x00BC },
+  { L"frac34",   0x00BE },
+  { L"frasl",    0x2044 },
+  { L"gamma",    0x03B3 },
+  { L"ge",       0x2265 },
+  { L"gt",       0x003E, TRUE },
+  { L"hArr",     0x21D4 },
+  { L"harr",     0x2194 },
+  { L"hearts",   0x2665 },
+  { L"hellip",   0x2026 },
+  { L"iacute",   0x00ED },
+  { L"icirc",    0x00EE },
+  { L"iexcl",    0x00A1 },
+  { L"igrave",   0x00EC },
+  { L"image",    0x2111 },
+  { L"infin",    0x221E },
+  { L"int",      0x222B },
+  { L"iota",     0x03B9 },
+  { L"iquest",   0x00BF },
+  { L"isin",     0x2208 },
+  { L"iuml",     0x00EF },
+  { L"kappa",    0x03BA },
+  { L"lArr",     0x21D0 },
+  { L"lambda",   0x03BB },
+  { L"lang",     0x2329 },
+  { L"laquo",    0x00AB },
+  { L"larr",     0x2190 },
+  { L"lceil",    0x2308 },
+  { L"ldquo",    0x201C },
+  { L"le",       0x2264 },
+  { L"lfloor",   0x230A },
+  { L"lowast",   0x2217 },
+  { L"loz",      0x25CA },
+  { L"lrm",      0x200E },
+  { L"lsaquo",   0x2039 },
+  { L"lsquo",    0x2018 },
+  { L"lt",       0x003C, TRUE },
+  { L"macr",     0x00AF },
+  { L"mdash",    0x2014 },
+  { L"micro",    0x00B5 },
+  { L"middot",   0x00B7 },
+  { L"minus",    0x2212 },
+  { L"mu",       0x03BC },
+  { L"nabla",    0x2207 },
+  { L"nbsp",     0x0020, TRUE },
+  { L"ndash",    0x2013 },
+  { L"ne",       0x2260 },
+  { L"ni",       0x220B },
+  { L"not",      0x00AC },
+  { L"notin",    0x2209 },
+  { L"nsub",     0x2284 },
+  { L"ntilde",   0x00F1 },
+  { L"nu",       0x03BD },
+  { L"oacute",   0x00F3 },
+  { L"ocirc",    0x00F4 },
+  { L"oelig",    0x0153 },
+  { L"ograve",   0x00F2 },
+  { L"oline",    0x203E },
+  { L"omega",    0x03C9 },
+  { L"omicron",  0x03BF },
+  { L"oplus",    0x2295 },
+  { L"or",       0x2228 },
+  { L"ordf",     0x00AA },
+  { L"ordm",     0x00BA },
+  { L"oslash",   0x00F8 },
+  { L"otilde",   0x00F5 },
+  { L"otimes",   0x2297 },
+  { L"ouml",     0x00F6 },
+  { L"para",     0x00B6 },
+  { L"part",     0x2202 },
+  { L"permil",   0x2030 },
+  { L"perp",     0x22A5 },
+  { L"phi",      0x03C6 },
+  { L"pi",       0x03C0 },
+  { L"piv",      0x03D6 },
+  { L"plusmn",   0x00B1 },
+  { L"pound",    0x00A3 },
+  { L"prime",    0x2032 },
+  { L"prod",     0x220F },
+  { L"prop",     0x221D },
+  { L"psi",      0x03C8 },
+  { L"quot",     0x0022, TRUE },
+  { L"rArr",     0x21D2 },
+  { L"radic",    0x221A },
+  { L"rang",     0x232A },
+  { L"raquo",    0x00BB },
+  { L"rarr",     0x2192 },
+  { L"rceil",    0x2309 },
+  { L"rdquo",    0x201D },
+  { L"real",     0x211C },
+  { L"reg",      0x00AE },
+  { L"rfloor",   0x230B },
+  { L"rho",      0x03C1 },
+  { L"rlm",      0x200F },
+  { L"rsaquo",   0x203A },
+  { L"rsquo",    0x2019 },
+  { L"sbquo",    0x201A },
+  { L"scaron",   0x0161 },
+  { L"sdot",     0x22C5 },
+  { L"sect",     0x00A7 },
+  { L"shy",      0x00AD },
+  { L"sigma",    0x03C3 },
+  { L"sigmaf",   0x03C2 },
+  { L"sim",      0x223C },
+  { L"spades",   0x2660 },
+  { L"sub",      0x2282 },
+  { L"sube",     0x2286 },
+  { L"sum",      0x2211 },
+  { L"sup",      0x2283 },
+  { L"sup1",     0x00B9 },
+  { L"sup2",     0x00B2 },
+  { L"sup3",     0x00B3 },
+  { L"supe",     0x2287 },
+  { L"szlig",    0x00DF },
+  { L"tau",      0x03C4 },
+  { L"there4",   0x2234 },
+  { L"theta",    0x03B8 },
+  { L"thetasym", 0x03D1 },
+  { L"thinsp",   0x2009 },
+  { L"thorn",    0x00FE },
+  { L"tilde",    0x02DC },
+  { L"times",    0x00D7 },
+  { L"trade",    0x2122 },
+  { L"uArr",     0x21D1 },
+  { L"uacute",   0x00FA },
+  { L"uarr",     0x2191 },
+  { L"ucirc",    0x00FB },
+  { L"ugrave",   0x00F9 },
+  { L"uml",      0x00A8 },
+  { L"upsih",    0x03D2 },
+  { L"upsilon",  0x03C5 },
+  { L"uuml",     0x00FC },
+  { L"weierp",   0x2118 },
+  { L"xi",       0x03BE },
+  { L"yacute",   0x00FD },
+  { L"yen",      0x00A5 },
+  { L"yuml",     0x00FF },
+  { L"zeta",     0x03B6 },
+  { L"zwj",      0x200D },
+  { L"zwnj",     0x200C },
+};
+// mXmlNamedEntityDisplacements
+/// The hash seed for each bucket of named entities, chosen so every named entity hashes to a distinct slot
+STATIC UINT16           mXmlNamedEntityDisplacements[XML_NAMED_ENTITY_BUCKETS] = {
+  1, 0, 2, 0, 1, 4, 1, 3, 1, 4, 1, 1, 1, 1, 1, 1,
+  3, 0, 2, 3, 2, 2, 1, 2, 1, 4, 1, 1, 3, 1, 2, 4,
+  5, 2, 1, 2, 2, 0, 1, 1, 1, 1, 1, 7, 2, 1, 1, 2,
+  1, 1, 3, 1, 1, 4, 0, 3, 0, 0, 2, 1, 1, 1, 6, 3,
+  1, 1, 1, 1, 1, 3, 1, 1, 4, 1, 5, 3, 1, 2, 1, 2,
+  6, 4, 2, 5, 0, 1, 3, 1, 1, 1, 2, 4, 0, 1, 1, 1,
+  0, 0, 0, 1, 3, 5, 1, 1, 3, 2, 1, 0, 0, 2, 1, 0,
+  2, 0, 3, 1, 4, 2, 2, 5, 2, 0, 6, 0, 3, 2, 3, 0,
+};
+// mXmlNamedEntitySlots
+/// The index plus one of the named entity in each slot or zero for an empty slot
+STATIC UINT16           mXmlNamedEntitySlots[XML_NAMED_ENTITY_SLOTS] = {
+  108,  51, 145,   0, 229,   0, 159,   0,   0,   0,   0,   0,   0,  49,   0, 113,
+  116,  29,   0,  77,   0,   0,  18,   0,   0,  11, 111, 204, 251, 164,   0, 121,
+  149,   6,   0,   0, 189,   0, 217,  73, 174, 147,   0, 225,   0,  40,   0,   0,
+  102, 176,  13, 127,  91,   0, 178,   0,   0, 216, 222, 190,  20, 208, 246,   0,
+   17,   0,  16, 205,   0, 207,  54,   7, 199,   0, 109,  57,  36,   0,   0,   0,
+  253,   0,   0,  24,  42,   0,   0,  12,   0,  52,   0, 188,  25,  96,   0,   0,
+    0, 233,   0,   0,   0,   0,   0,   0,  84, 110, 168,   0, 106,  34, 179,   0,
+    0,  15,   0,   0,   0,   0, 104, 228,  80,   0, 183, 115,  88,   0,   3, 231,
+    0,  71,   0,   0,  33,   0, 156,   0, 153,   0,  41,   0, 195,   0,   0,   0,
+    0,   0,   0,  37,   0,  22,   0, 137,   0,   0, 197, 191,  44, 155,   0, 150,
+  203, 123,   0,   0, 141, 126,   0, 143,   0,   0,   0,  99,  23,   2,   0,   0,
+    0,   0,   0,   0,  32,  86,   0,  58,  93,   0,   0,   0, 140,   0, 214, 100,
+    0,  48, 209,   0,   0,  78,   0,   0,   0,   0,   0, 219,   0, 184,   0,  27,
+    0,   0, 242, 223,   0, 161,   0,   0,   0,   0,   0,   0,   0,  39,   0,   0,
+  177,   0,   0, 133, 134,   0, 220,   0,   0, 114,  47,   4, 129, 154,  59,  43,
+    0, 187,   0,   0, 169, 117, 198,   0, 215, 124,   0, 181, 119,  53,   0,   0,
+    0,   0,   0,  55, 132, 173,   0, 201,   0,   0, 193,   0,  19,  14,  63,   0,
+  144,   0, 234,   0, 250,   0,  76, 172,  30,  26, 218,   0, 210,   0,  35,   0,
+  192, 160,   0,   0,   0,  68,   0, 247,  50,  70,   0, 171,   0,   0,   0, 135,
+  212, 202,   0,   0,   0, 162,   9, 221, 128,   0, 139, 227,   0,   0, 112,   0,
+   89, 105, 236,   0, 232, 101,   0, 252,   0,  81,   0,   0,   0,   0,  97,   0,
+    0,   0,   0,   0,   0,   0,  10,   0, 152,   0,  92, 136,   0, 146, 206,   0,
+    0,   0,   0,   0,   0,   0,   0, 148,   0,   0, 237,   0, 158, 103,   0,  90,
+  131,   0,  62,   0,   0,   0,   0,   0, 249, 175,  31,   0,   0,  65,   5,   0,
+  125, 185,  69, 142,   0,  67,   0,   0, 230,   0,   0, 157,   0,   0,   0, 226,
+    0,   0,   0,   0,   0,  21,   0,  98, 138, 196,   0,  72,   0,   0,   0, 167,
+    0, 122,  61,   0,   0,   0, 244, 163,   0,   0,   0,   0,  38,   0,   0, 151,
+   75,  82,   0,   0, 118,   0,   0,  28,   0, 240,  66,   0,   0,   0,  83, 120,
+    0,   0, 238,  45,   0,   1,   0,   0,   0,  87,   0,  64,  85,   0,  60,  95,
+    0, 235, 243,   0,   0, 239,   0,   0,   0,   0, 224, 211,   0, 130,   0,  74,
+    0, 180,   0, 245,   0,   0, 248,   0,   0, 213,   0,  94, 182, 107,   0, 186,
+  241, 166,   0,  56,  79,   0,   0,   0, 165, 200,   0,  46, 194,   0, 170,   8,
+};
+
+// XmlEntityNameCompare
+/// Check if an entity name matches a null-terminated name
+/// @param Name       The null-terminated name
+/// @param Entity     The entity name
+/// @param Length     The length of the entity name in characters
+/// @retval TRUE  If the names match
+/// @retval FALSE If the names do not match
+STATIC BOOLEAN
+EFIAPI
+XmlEntityNameCompare (
+  IN CHAR16 *Name,
+  IN CHAR16 *Entity,
+  IN UINTN   Length
+) {
+  while (Length-- > 0) {
+    if (*Name++ != *Entity++) {
+      return FALSE;
+    }
+  }
+  return (*Name == L'\0');
+}
+// XmlEntityCharacter
+/// Decode a numeric character entity
+/// @param Name      The entity name following the number sign
+/// @param Length    The length of the entity name in characters
+/// @param Buffer    On output, the character encoded as UTF-16, which must be at least XML_ENTITY_CHARACTER_SIZE characters
+/// @param Count     On output, the count of characters in the buffer
+/// @return Whether the character entity was decoded or not
+/// @retval EFI_NOT_FOUND If the character entity is not a valid unicode character
+/// @retval EFI_SUCCESS   If the character entity was decoded successfully
+STATIC EFI_STATUS
+EFIAPI
+XmlEntityCharacter (
+  IN  CHAR16 *Name,
+  IN  UINTN   Length,
+  OUT CHAR16 *Buffer,
+  OUT UINTN  *Count
+) {
+  UINT32 Character = 0;
+  UINT32 Digit;
+  UINT32 Base = 10;
+  // Check for hexadecimal representation of character
+  if ((Length > 0) && ((*Name == L'x') || (*Name == L'X'))) {
+    Base = 16;
+    ++Name;
+    --Length;
+  }
+  if (Length == 0) {
+    return EFI_NOT_FOUND;
+  }
+  // Decode the digits, stopping before the character could overflow
+  while (Length-- > 0) {
+    if ((*Name >= L'0') && (*Name <= L'9')) {
+      Digit = (UINT32)(*Name - L'0');
+    } else if ((Base == 16) && (*Name >= L'a') && (*Name <= L'f')) {
+      Digit = (UINT32)(*Name - L'a') + 10;
+    } else if ((Base == 16) && (*Name >= L'A') && (*Name <= L'F')) {
+      Digit = (UINT32)(*Name - L'A') + 10;
+    } else {
+      return EFI_NOT_FOUND;
+    }
+    Character = (Character * Base) + Digit;
+    if (Character > 0x10FFFF) {
+      return EFI_NOT_FOUND;
+    }
+    ++Name;
+  }
+  // Check the character is valid
+  if (!IsUnicodeCharacter(Character)) {
+    return EFI_NOT_FOUND;
+  }
+  // Encode the character as UTF-16
+  if (Character >= 0x10000) {
+    Character -= 0x10000;
+    Buffer[0] = (CHAR16)(((Character >> 10) & 0x3FF) + 0xD800);
+    Buffer[1] = (CHAR16)((Character & 0x3FF) + 0xDC00);
+    *Count = 2;
+  } else {
+    Buffer[0] = (CHAR16)Character;
+    *Count = 1;
+  }
+  return EFI_SUCCESS;
+}
+// XmlNamedEntityFind
+/// Find a predefined named entity
+/// @param Name   The entity name
+/// @param Length The length of the entity name in characters
+/// @return The predefined named entity or NULL if not found
+STATIC XML_NAMED_ENTITY *
+EFIAPI
+XmlNamedEntityFind (
+  IN CHAR16 *Name,
+  IN UINTN   Length
+) {
+  CHAR16  Folded[XML_NAMED_ENTITY_FOLD_LENGTH];
+  UINT32  Hash;
+  UINTN   Index;
+  BOOLEAN Fold = FALSE;
+  // The HTML entity names are case-sensitive, but the XML entities and the non-breaking space match in any case
+  while (TRUE) {
+    // Get the bucket seed and then the slot of the entity
+    Hash = XmlHashName(Name, Length, 0);
+    Hash = XmlHashName(Name, Length, mXmlNamedEntityDisplacements[Hash & (XML_NAMED_ENTITY_BUCKETS - 1)]);
+    Index = mXmlNamedEntitySlots[Hash & (XML_NAMED_ENTITY_SLOTS - 1)];
+    // The slot only holds a candidate, so compare the name
+    if ((Index != 0) && XmlEntityNameCompare(mXmlNamedEntities[Index - 1].Name, Name, Length) &&
+        (!Fold || mXmlNamedEntities[Index - 1].AnyCase)) {
+      return &(mXmlNamedEntities[Index - 1]);
+    }
+    if (Fold || (Length > XML_NAMED_ENTITY_FOLD_LENGTH)) {
+      return NULL;
+    }
+    // Search again with the name in lower case
+    for (Index = 0; Index < Length; ++Index) {
+      Folded[Index] = ((Name[Index] >= L'A') && (Name[Index] <= L'Z')) ? (CHAR16)(Name[Index] - L'A' + L'a') : Name[Index];
+    }
+    Name = Folded;
+    Fold = TRUE;
+  }
+}
+// XmlEntityFind
+/// Find a declared entity
+/// @param Entities The declared entities
+/// @param Name     The entity name
+/// @param Length   The length of the entity name in characters
+/// @param Hash     The hash of the entity name
+/// @return The declared entity or NULL if not found
+STATIC XML_ENTITY *
+EFIAPI
+XmlEntityFind (
+  IN XML_ENTITIES *Entities,
+  IN CHAR16       *Name,
+  IN UINTN         Length,
+  IN UINT32        Hash
+) {
+  XML_ENTITY *Entity;
+  if ((Entities == NULL) || (Entities->Buckets == NULL)) {
+    return NULL;
+  }
+  for (Entity = Entities->Buckets[Hash & (Entities->Size - 1)]; Entity != NULL; Entity = Entity->Next) {
+    if ((Entity->Hash == Hash) && XmlEntityNameCompare(Entity->Name, Name, Length)) {
+      return Entity;
+    }
+  }
+  return NULL;
+}
+// XmlEntityAppend
+/// Append to a string allocated from an XML arena
+/// @param Arena  The XML arena
+/// @param String On input, the string to which to append, on output, the appended string
+/// @param Count  On input, the length of the string in characters, on output, the appended length
+/// @param Value  The value to append
+/// @param Length The length of the value to append in characters
+/// @return Whether the value was appended or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the value was appended successfully
+STATIC EFI_STATUS
+EFIAPI
+XmlEntityAppend (
+  IN OUT XML_ARENA  *Arena,
+  IN OUT CHAR16    **String,
+  IN OUT UINTN      *Count,
+  IN     CHAR16     *Value,
+  IN     UINTN       Length
+) {
+  CHAR16 *Ptr;
+  // Grow the string, which happens in place while the string is the last arena allocation
+  Ptr = (CHAR16 *)XmlArenaReallocate(Arena, *String, (*String == NULL) ? 0 : ((*Count + 1) * sizeof(CHAR16)), (*Count + Length + 1) * sizeof(CHAR16));
+  if (Ptr == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  CopyMem(Ptr + *Count, Value, Length * sizeof(CHAR16));
+  *Count += Length;
+  Ptr[*Count] = L'\0';
+  *String = Ptr;
+  return EFI_SUCCESS;
+}
+
+// XmlEntityResolve
+/// Resolve an entity to its replacement text
+/// @param Entities The declared entities, which are searched before the predefined named entities
+/// @param Name     The entity name
+/// @param Length   The length of the entity name in characters
+/// @param Buffer   The buffer used for character replacements, which must be at least XML_ENTITY_CHARACTER_SIZE characters
+/// @param Value    On output, the replacement text, which is not null-terminated
+/// @param Count    On output, the length of the replacement text in characters
+/// @return Whether the entity was resolved or not
+/// @retval EFI_INVALID_PARAMETER If Name, Buffer, Value, or Count is NULL or Length is zero
+/// @retval EFI_NOT_FOUND         If the entity is not declared or is not a valid character
+/// @retval EFI_SUCCESS           If the entity was resolved successfully
+EFI_STATUS
+EFIAPI
+XmlEntityResolve (
+  IN  XML_ENTITIES  *Entities OPTIONAL,
+  IN  CHAR16        *Name,
+  IN  UINTN          Length,
+  OUT CHAR16        *Buffer,
+  OUT CHAR16       **Value,
+  OUT UINTN         *Count
+) {
+  EFI_STATUS        Status;
+  XML_ENTITY       *Entity;
+  XML_NAMED_ENTITY *Named;
+  // Check parameters
+  if ((Name == NULL) || (Length == 0) || (Buffer == NULL) || (Value == NULL) || (Count == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Numeric representation of character
+  if (*Name == L'#') {
+    Status = XmlEntityCharacter(Name + 1, Length - 1, Buffer, Count);
+    if (!EFI_ERROR(Status)) {
+      *Value = Buffer;
+    }
+    return Status;
+  }
+  // Declared entity
+  Entity = XmlEntityFind(Entities, Name, Length, XmlHashName(Name, Length, 0));
+  if (Entity != NULL) {
+    *Value = Entity->Value;
+    *Count = Entity->Length;
+    return EFI_SUCCESS;
+  }
+  // Predefined named entity
+  Named = XmlNamedEntityFind(Name, Length);
+  if (Named == NULL) {
+    return EFI_NOT_FOUND;
+  }
+  Buffer[0] = Named->Character;
+  *Value = Buffer;
+  *Count = 1;
+  return EFI_SUCCESS;
+}
+// XmlEntityDeclare
+/// Declare an entity, the first declaration of an entity is binding
+/// @param Arena    The XML arena from which to allocate
+/// @param Entities The declared entities
+/// @param Name     The entity name
+/// @param Entity   On output, the declared entity, which has no replacement text until set by XmlEntitySetValue
+/// @return Whether the entity was declared or not
+/// @retval EFI_INVALID_PARAMETER If Arena, Entities, Name, or Entity is NULL or Name is empty
+/// @retval EFI_ALREADY_STARTED   If the entity was already declared
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the entity was declared successfully
+EFI_STATUS
+EFIAPI
+XmlEntityDeclare (
+  IN OUT XML_ARENA     *Arena,
+  IN OUT XML_ENTITIES  *Entities,
+  IN     CHAR16        *Name,
+  OUT    XML_ENTITY   **Entity
+) {
+  XML_ENTITY  *Ptr;
+  XML_ENTITY  *Next;
+  XML_ENTITY **Buckets;
+  UINTN        Length;
+  UINTN        Size;
+  UINTN        Index;
+  UINT32       Hash;
+  // Check parameters
+  if ((Arena == NULL) || (Entities == NULL) || (Name == NULL) || (*Name == L'\0') || (Entity == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Check if the entity was already declared
+  Length = StrLen(Name);
+  Hash = XmlHashName(Name, Length, 0);
+  if (XmlEntityFind(Entities, Name, Length, Hash) != NULL) {
+    return EFI_ALREADY_STARTED;
+  }
+  // Grow the buckets if needed, the previous buckets are released with the arena
+  if (Entities->Count >= Entities->Size) {
+    Size = (Entities->Size == 0) ? XML_ENTITIES_SIZE : (Entities->Size << 1);
+    Buckets = (XML_ENTITY **)XmlArenaAllocate(Arena, Size * sizeof(XML_ENTITY *));
+    if (Buckets == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    // Rehash the declared entities into the new buckets
+    for (Index = 0; Index < Entities->Size; ++Index) {
+      for (Ptr = Entities->Buckets[Index]; Ptr != NULL; Ptr = Next) {
+        Next = Ptr->Next;
+        Ptr->Next = Buckets[Ptr->Hash & (Size - 1)];
+        Buckets[Ptr->Hash & (Size - 1)] = Ptr;
+      }
+    }
+    Entities->Buckets = Buckets;
+    Entities->Size = Size;
+  }
+  // Allocate the entity, the other members are zeroed by the arena
+  Ptr = (XML_ENTITY *)XmlArenaAllocate(Arena, sizeof(XML_ENTITY));
+  if (Ptr == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Ptr->Hash = Hash;
+  Ptr->Name = XmlArenaStrDup(Arena, Name);
+  if (Ptr->Name == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Add the entity to its bucket
+  Ptr->Next = Entities->Buckets[Hash & (Entities->Size - 1)];
+  Entities->Buckets[Hash & (Entities->Size - 1)] = Ptr;
+  ++(Entities->Count);
+  // Return the declared entity
+  *Entity = Ptr;
+  return EFI_SUCCESS;
+}
+// XmlEntitySetValue
+/// Set the replacement text of a declared entity, references in the value are replaced now so resolving the entity never recurses
+/// @param Arena     The XML arena from which to allocate
+/// @param Entities  The declared entities
+/// @param Entity    The declared entity
+/// @param Value     The literal value of the entity
+/// @param Expansion On input, the count of characters added by declared entity references, on output, including this value
+/// @return Whether the replacement text was set or not
+/// @retval EFI_INVALID_PARAMETER If Arena, Entities, Entity, Value, or Expansion is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated or the expansion exceeded XML_ENTITY_MAX_EXPANSION
+/// @retval EFI_SUCCESS           If the replacement text was set successfully
+EFI_STATUS
+EFIAPI
+XmlEntitySetValue (
+  IN OUT XML_ARENA    *Arena,
+  IN     XML_ENTITIES *Entities,
+  IN OUT XML_ENTITY   *Entity,
+  IN     CHAR16       *Value,
+  IN OUT UINTN        *Expansion
+) {
+  EFI_STATUS  Status;
+  CHAR16      Buffer[XML_ENTITY_CHARACTER_SIZE];
+  CHAR16     *Text = NULL;
+  CHAR16     *Replacement;
+  CHAR16     *End;
+  UINTN       Length = 0;
+  UINTN       Count;
+  // Check parameters
+  if ((Arena == NULL) || (Entities == NULL) || (Entity == NULL) || (Value == NULL) || (Expansion == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  while (*Value != L'\0') {
+    // Find the next reference
+    End = Value;
+    while ((*End != L'\0') && (*End != L'&')) {
+      ++End;
+    }
+    if (End != Value) {
+      Status = XmlEntityAppend(Arena, &Text, &Length, Value, (UINTN)(End - Value));
+      if (EFI_ERROR(Status)) {
+        return Status;
+      }
+      Value = End;
+      continue;
+    }
+    // Find the end of the reference
+    End = Value + 1;
+    while ((*End != L'\0') && (*End != L';')) {
+      ++End;
+    }
+    // Replace the reference or keep it as literal text if it is unknown
+    if ((*End == L';') && (End > (Value + 1)) &&
+        !EFI_ERROR(XmlEntityResolve(Entities, Value + 1, (UINTN)(End - Value) - 1, Buffer, &Replacement, &Count))) {
+      // Limit the replacement text of declared entities, which otherwise grows exponentially with nested references
+      if (Replacement != Buffer) {
+        *Expansion += Count;
+        if (*Expansion > XML_ENTITY_MAX_EXPANSION) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+      }
+      Status = XmlEntityAppend(Arena, &Text, &Length, Replacement, Count);
+      Value = End + 1;
+    } else {
+      Status = XmlEntityAppend(Arena, &Text, &Length, Value, 1);
+      ++Value;
+    }
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+  }
+  // Set the replacement text
+  Entity->Value = Text;
+  Entity->Length = Length;
+  return EFI_SUCCESS;
+}
@@ -6,104 +6,233 @@
 
 #include "XmlStates.h"
 
-// XmlAttributeDuplicateMembers
-/// @param Destination The destination XML document tree node attribute
-/// @param Source      The source XML document tree node attribute
+// mXmlWalkStack
+/// The XML document tree walk stack, reused by walks that do not overlap
+STATIC XML_WALK_LEVEL *mXmlWalkStack = NULL;
+// mXmlWalkStackSize
+/// The count of levels in the XML document tree walk stack
+STATIC UINTN           mXmlWalkStackSize = 0;
+
+// XmlAttributesSlot
+/// Get the first index slot of an interned attribute name
+/// @param Name The interned attribute name
+/// @param Size The count of slots in the index
+/// @return The first index slot of the attribute name
+STATIC UINTN
+EFIAPI
+XmlAttributesSlot (
+  IN CHAR16 *Name,
+  IN UINTN   Size
+) {
+  // Interned names are unique so the address is the hash
+  return (((UINTN)Name >> 3) ^ ((UINTN)Name >> 11)) & (Size - 1);
+}
+// XmlAttributesIndexInsert
+/// Insert an attribute into the index, only the first attribute with a name is indexed
+/// @param Attributes The XML document tree node attributes
+/// @param Index      The index of the attribute in the list
 STATIC VOID
 EFIAPI
-XmlAttributeDuplicateMembers (
-  IN XML_ATTRIBUTE *Destination,
-  IN XML_ATTRIBUTE *Source
+XmlAttributesIndexInsert (
+  IN OUT XML_ATTRIBUTES *Attributes,
+  IN     UINTN           Index
 ) {
-  if (Destination != NULL) {
-    if (Destination->Name != NULL) {
-      FreePool(Destination->Name);
-      Destination->Name = NULL;
-    }
-    if (Destination->Value != NULL) {
-      FreePool(Destination->Value);
-      Destination->Value = NULL;
-    }
-    if (Source != NULL) {
-      Destination->Name = StrDup(Source->Name);
-      Destination->Value = StrDup(Source->Value);
+  CHAR16 *Name = Attributes->List[Index].Name;
+  UINTN   Slot = XmlAttributesSlot(Name, Attributes->IndexSize);
+  // Probe for an empty slot, the index is never more than half full
+  while (Attributes->Index[Slot] != 0) {
+    if (Attributes->List[Attributes->Index[Slot] - 1].Name == Name) {
+      return;
     }
+    Slot = (Slot + 1) & (Attributes->IndexSize - 1);
   }
+  Attributes->Index[Slot] = Index + 1;
 }
-// XmlAttributeFreeMembers
-/// Free XML document tree node attribute
-/// @param Attribute The XML document tree node attribute
-STATIC VOID
+// XmlAttributesIndexBuild
+/// Build the index of the attributes
+/// @param Arena      The XML arena from which to allocate
+/// @param Attributes The XML document tree node attributes
+/// @return Whether the index was built or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the index was built successfully
+STATIC EFI_STATUS
 EFIAPI
-XmlAttributeFreeMembers (
-  IN XML_ATTRIBUTE *Attribute
+XmlAttributesIndexBuild (
+  IN OUT XML_ARENA      *Arena,
+  IN OUT XML_ATTRIBUTES *Attributes
 ) {
-  if (Attribute != NULL) {
-    if (Attribute->Name != NULL) {
-      FreePool(Attribute->Name);
-      Attribute->Name = NULL;
+  UINTN Size = Attributes->IndexSize;
+  UINTN Index;
+  // Keep the index at most half full, the previous index is released with the arena
+  if ((Size == 0) || ((Attributes->Count << 1) > Size)) {
+    if (Size == 0) {
+      Size = XML_ATTRIBUTES_INDEX_COUNT << 2;
     }
-    if (Attribute->Value != NULL) {
-      FreePool(Attribute->Value);
-      Attribute->Value = NULL;
+    while ((Attributes->Count << 1) > Size) {
+      Size <<= 1;
     }
+    Attributes->Index = (UINTN *)XmlArenaAllocate(Arena, Size * sizeof(UINTN));
+    if (Attributes->Index == NULL) {
+      Attributes->IndexSize = 0;
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Attributes->IndexSize = Size;
+  } else {
+    ZeroMem(Attributes->Index, Size * sizeof(UINTN));
   }
+  // Insert the attributes in document order
+  for (Index = 0; Index < Attributes->Count; ++Index) {
+    XmlAttributesIndexInsert(Attributes, Index);
+  }
+  return EFI_SUCCESS;
 }
-// XmlAttributeFree
-/// Free XML document tree node attribute
-/// @param Attribute The XML document tree node attribute
-STATIC VOID
+
+// XmlAttributesAdd
+/// Add an attribute to the inline attributes of an XML document tree node
+/// @param Arena      The XML arena from which to allocate
+/// @param Attributes The XML document tree node attributes
+/// @param Name       The name of the attribute to add
+/// @param Attribute  On output, the added attribute
+/// @return Whether the attribute was added or not
+/// @retval EFI_INVALID_PARAMETER If Arena, Attributes, Name, or Attribute is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the attribute was added successfully
+EFI_STATUS
 EFIAPI
-XmlAttributeFree (
-  IN XML_ATTRIBUTE *Attribute
+XmlAttributesAdd (
+  IN OUT XML_ARENA       *Arena,
+  IN OUT XML_ATTRIBUTES  *Attributes,
+  IN     CHAR16          *Name,
+  OUT    XML_ATTRIBUTE  **Attribute
 ) {
+  EFI_STATUS     Status;
+  XML_ATTRIBUTE *Ptr;
   // Check parameters
-  if (Attribute != NULL) {
-    XmlAttributeFreeMembers(Attribute);
-    FreePool(Attribute);
+  if ((Arena == NULL) || (Attributes == NULL) || (Name == NULL) || (*Name == L'\0') || (Attribute == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
+  // Grow the inline attributes if needed
+  if (Attributes->Count >= Attributes->Size) {
+    UINTN Size = (Attributes->Size == 0) ? XML_ATTRIBUTES_SIZE : (Attributes->Size << 1);
+    Ptr = (XML_ATTRIBUTE *)XmlArenaReallocate(Arena, Attributes->List, Attributes->Size * sizeof(XML_ATTRIBUTE), Size * sizeof(XML_ATTRIBUTE));
+    if (Ptr == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Attributes->List = Ptr;
+    Attributes->Size = Size;
+  }
+  // Set the attribute name
+  Ptr = &(Attributes->List[Attributes->Count]);
+  Ptr->Name = XmlArenaIntern(Arena, Name);
+  if (Ptr->Name == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Ptr->Value = NULL;
+  ++(Attributes->Count);
+  // Index the attributes when there are more than a few
+  if (Attributes->Count > XML_ATTRIBUTES_INDEX_COUNT) {
+    if ((Attributes->Index == NULL) || ((Attributes->Count << 1) > Attributes->IndexSize)) {
+      Status = XmlAttributesIndexBuild(Arena, Attributes);
+      if (EFI_ERROR(Status)) {
+        --(Attributes->Count);
+        ZeroMem(Ptr, sizeof(XML_ATTRIBUTE));
+        return Status;
+      }
+    } else {
+      XmlAttributesIndexInsert(Attributes, Attributes->Count - 1);
+    }
+  }
+  // Return the added attribute
+  *Attribute = Ptr;
+  return EFI_SUCCESS;
 }
-// XmlAttributeListFree
-/// Free XML document tree node attribute
-/// @param Attribute The XML document tree node attribute
-STATIC VOID
+// XmlAttributesFind
+/// Find an attribute in the inline attributes of an XML document tree node
+/// @param Arena      The XML arena from which the attributes were allocated
+/// @param Attributes The XML document tree node attributes
+/// @param Name       The name of the attribute to find
+/// @param Index      On output, the index of the attribute in the list
+/// @return Whether the attribute was found or not
+/// @retval EFI_INVALID_PARAMETER If Arena, Attributes, Name, or Index is NULL
+/// @retval EFI_NOT_FOUND         If the attribute was not found
+/// @retval EFI_SUCCESS           If the attribute was found successfully
+EFI_STATUS
 EFIAPI
-XmlAttributeListFree (
-  IN XML_LIST *Attribute
+XmlAttributesFind (
+  IN  XML_ARENA      *Arena,
+  IN  XML_ATTRIBUTES *Attributes,
+  IN  CHAR16         *Name,
+  OUT UINTN          *Index
 ) {
+  UINTN Slot;
   // Check parameters
-  if (Attribute != NULL) {
-    XmlAttributeFreeMembers(&(Attribute->Attribute));
-    FreePool(Attribute);
+  if ((Arena == NULL) || (Attributes == NULL) || (Name == NULL) || (Index == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
+  if (Attributes->Count == 0) {
+    return EFI_NOT_FOUND;
+  }
+  // A name that was never interned is not the name of any attribute
+  Name = XmlArenaFindName(Arena, Name);
+  if (Name == NULL) {
+    return EFI_NOT_FOUND;
+  }
+  // Search the index
+  if (Attributes->Index != NULL) {
+    Slot = XmlAttributesSlot(Name, Attributes->IndexSize);
+    while (Attributes->Index[Slot] != 0) {
+      if (Attributes->List[Attributes->Index[Slot] - 1].Name == Name) {
+        *Index = Attributes->Index[Slot] - 1;
+        return EFI_SUCCESS;
+      }
+      Slot = (Slot + 1) & (Attributes->IndexSize - 1);
+    }
+    return EFI_NOT_FOUND;
+  }
+  // Search the few attributes by interned name
+  for (Slot = 0; Slot < Attributes->Count; ++Slot) {
+    if (Attributes->List[Slot].Name == Name) {
+      *Index = Slot;
+      return EFI_SUCCESS;
+    }
+  }
+  return EFI_NOT_FOUND;
 }
-// XmlTreeFree
-/// Free XML document tree node
-/// @param Tree The XML document tree node
-STATIC VOID
+// XmlAttributesRemove
+/// Remove an attribute from the inline attributes of an XML document tree node, keeping document order
+/// @param Arena      The XML arena from which the attributes were allocated
+/// @param Attributes The XML document tree node attributes
+/// @param Index      The index of the attribute in the list
+/// @return Whether the attribute was removed or not
+/// @retval EFI_INVALID_PARAMETER If Arena or Attributes is NULL or Index is out of range
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the attribute was removed successfully
+EFI_STATUS
 EFIAPI
-XmlTreeFree (
-  IN XML_TREE *Tree
+XmlAttributesRemove (
+  IN OUT XML_ARENA      *Arena,
+  IN OUT XML_ATTRIBUTES *Attributes,
+  IN     UINTN           Index
 ) {
-  if (Tree != NULL) {
-    Tree->Next = NULL;
-    if (Tree->Name != NULL) {
-      FreePool(Tree->Name);
-      Tree->Name = NULL;
-    }
-    while (Tree->Attributes != NULL) {
-      XML_LIST *Attribute = Tree->Attributes;
-      Tree->Attributes = Attribute;
-      XmlAttributeListFree(Attribute);
-    }
-    while (Tree->Children != NULL) {
-      XML_TREE *Child = Tree->Children;
-      Tree->Children = Child->Next;
-      XmlTreeFree(Child);
-    }
-    FreePool(Tree);
+  // Check parameters
+  if ((Arena == NULL) || (Attributes == NULL) || (Index >= Attributes->Count)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Move the following attributes down to keep document order
+  --(Attributes->Count);
+  if (Index < Attributes->Count) {
+    CopyMem(Attributes->List + Index, Attributes->List + Index + 1, (Attributes->Count - Index) * sizeof(XML_ATTRIBUTE));
   }
+  ZeroMem(Attributes->List + Attributes->Count, sizeof(XML_ATTRIBUTE));
+  // The list indices moved so rebuild the index or drop it when there are only a few attributes
+  if (Attributes->Count > XML_ATTRIBUTES_INDEX_COUNT) {
+    return XmlAttributesIndexBuild(Arena, Attributes);
+  }
+  Attributes->Index = NULL;
+  Attributes->IndexSize = 0;
+  return EFI_SUCCESS;
 }
+
 // XmlSchemaDuplicate
 /// @param Schema The XML schema to duplicate
 /// @return The duplicated XML schema
@@ -149,10 +278,7 @@ XmlDocumentFree (
       FreePool(Document->Schema);
       Document->Schema = NULL;
     }
-    if (Document->Tree != NULL) {
-      FreePool(Document->Tree);
-      Document->Tree = NULL;
-    }
+    // The document tree and attributes are released with the arena
     FreePool(Document);
   }
 }
@@ -169,6 +295,12 @@ XmlParserFree (
       XmlDocumentFree(Parser->Document);
       Parser->Document = NULL;
     }
+    if (Parser->Parser != NULL) {
+      FreeParser(Parser->Parser);
+      Parser->Parser = NULL;
+    }
+    // Release the document tree wholesale
+    XmlArenaFree(&(Parser->Arena));
     FreePool(Parser);
   }
 }
@@ -200,7 +332,6 @@ XmlDocumentCreate (
   // Set the document defaults
   Doc->Schema = NULL;
   Doc->Tree = NULL;
-  Doc->ByteSwap = FALSE;
   Doc->Encoding = (Encoding == NULL) ? NULL : AsciiStrDup(Encoding);
   // Return the created document
   *Document = Doc;
@@ -224,6 +355,18 @@ XmlReset (
   }
   XmlDocumentFree(Parser->Document);
   Parser->Document = NULL;
+  Parser->LeadingSize = 0;
+  Parser->Detected = FALSE;
+  ParseClearMessages(Parser->Parser);
+  // Release the document tree wholesale, the stack objects were allocated from the arena
+  Parser->Stack = NULL;
+  Parser->Unused = NULL;
+  ZeroMem(&(Parser->Entities), sizeof(XML_ENTITIES));
+  Parser->Entity = NULL;
+  Parser->EntityName = NULL;
+  Parser->EntityIgnored = FALSE;
+  Parser->EntityExpansion = 0;
+  XmlArenaFree(&(Parser->Arena));
   return EFI_SUCCESS;
 }
 // XmlFree
@@ -241,6 +384,8 @@ XmlFree (
   if (Parser == NULL) {
     return EFI_INVALID_PARAMETER;
   }
+  // Log the parser profile in debug builds
+  ParseLogProfile(Parser->Parser, L"XML");
   XmlParserFree(Parser);
   return EFI_SUCCESS;
 }
@@ -267,6 +412,40 @@ XmlParse (
   // Finish XML document
   return XmlParseFinish(Parser);
 }
+// XmlParseLeading
+/// Detect the encoding from the buffered leading bytes and parse them
+/// @param Parser An XML parser used to parse
+/// @return Whether the leading bytes were parsed or not
+STATIC EFI_STATUS
+EFIAPI
+XmlParseLeading (
+  IN OUT XML_PARSER *Parser
+) {
+  EFI_STATUS  Status;
+  CHAR8      *Encoding = NULL;
+  UINTN       BomSize = 0;
+  Parser->Detected = TRUE;
+  if (Parser->LeadingSize == 0) {
+    return EFI_SUCCESS;
+  }
+  // Detect the encoding from the byte order mark or the leading characters, the encoding
+  //  declaration changes the encoding when parsed if the detected encoding is not unicode
+  ParseDetectEncoding(Parser->LeadingSize, Parser->Leading, &Encoding, &BomSize);
+  Status = ParseSetEncoding(Parser->Parser, Encoding);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  Status = XmlDocumentSetEncoding(Parser->Document, Encoding);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Skip the byte order mark
+  if (BomSize >= Parser->LeadingSize) {
+    return EFI_SUCCESS;
+  }
+  // Parse the leading bytes
+  return ParseBuffer(Parser->Parser, Parser->LeadingSize - BomSize, Parser->Leading + BomSize, NULL, Parser);
+}
 // XmlParseStart
 /// Start parsing multiple buffers for XML
 /// @param Parser An XML parser used to parse
@@ -282,387 +461,21 @@ XmlParseStart (
 ) {
   EFI_STATUS Status;
   // Check parameters
-  if ((Parser == NULL) || (Parser->Document != NULL) || (Buffer == NULL) || (Size <= sizeof(UINT32))) {
+  if ((Parser == NULL) || (Parser->Document != NULL) || (Buffer == NULL) || (Size == 0)) {
     return EFI_INVALID_PARAMETER;
   }
-  // Check for byte order
-  switch (*((UINT32 *)Buffer)) {
-
-    //
-    // Unicode detection
-    //
-    case 0x003CFEFF:
-      // BOM followed by <
-    case 0x0020FEFF:
-      // BOM followed by space
-    case 0x000DFEFF:
-      // BOM followed by carriage return
-    case 0x000AFEFF:
-      // BOM followed by line feed
-
-      // Skip the BOM mark
-      Size -= sizeof(CHAR16);
-      Buffer = (VOID *)(((CHAR16 *)Buffer) + 1);
-
-    case 0x003F003C:
-      // <?
-    case 0x003C0020:
-      // Space followed by <
-    case 0x003C000D:
-      // Carriage return followed by <
-    case 0x003C000A:
-      // Line feed followed by <
-    case 0x00200020:
-      // Two spaces
-    case 0x0020000D:
-      // Carriage return followed by space
-    case 0x0020000A:
-      // Line feed followed by space
-    case 0x000D0020:
-      // Space followed by carriage return
-    case 0x000D000D:
-      // Two carriage returns
-    case 0x000D000A:
-      // Line feed followed by carriage return
-    case 0x000A0020:
-      // Space followed by line feed
-    case 0x000A000D:
-      // Carriage return followed by line feed
-    case 0x000A000A:
-      // Two line feeds
-
-      // Create the XML document
-      Status = XmlDocumentCreate(&(Parser->Document), "UTF-16");
-      if (EFI_ERROR(Status)) {
-        return Status;
-      }
-      // Parse the buffer
-      return Parse(Parser->Parser, Size / sizeof(CHAR16), (CHAR16 *)Buffer, FALSE, Parser);
-
-    //
-    // Unicode with swapped byte order detection
-    //
-    case 0x3C00FFFE:
-      // BOM followed by <
-    case 0x2000FFFE:
-      // BOM followed by space
-    case 0x0D00FFFE:
-      // BOM followed by carriage return
-    case 0x0A00FFFE:
-      // BOM followed by line feed
-
-      // Skip the BOM mark
-      Size -= sizeof(CHAR16);
-      Buffer = (VOID *)(((CHAR16 *)Buffer) + 1);
-
-    case 0x3F003C00:
-      // <?
-    case 0x3C002000:
-      // Space followed by <
-    case 0x3C000D00:
-      // Carriage return followed by <
-    case 0x3C000A00:
-      // Line feed followed by <
-    case 0x20002000:
-      // Two spaces
-    case 0x20000D00:
-      // Carriage return followed by space
-    case 0x20000A00:
-      // Line feed followed by space
-    case 0x0D002000:
-      // Space followed by carriage return
-    case 0x0D000D00:
-      // Two carriage returns
-    case 0x0D000A00:
-      // Line feed followed by carriage return
-    case 0x0A002000:
-      // Space followed by line feed
-    case 0x0A000D00:
-      // Carriage return followed by line feed
-    case 0x0A000A00:
-      // Two line feeds
-
-      // Create the XML document
-      Status = XmlDocumentCreate(&(Parser->Document), "UTF-16");
-      if (EFI_ERROR(Status)) {
-        return Status;
-      }
-      Parser->Document->ByteSwap = TRUE;
-      // Parse the buffer
-      return Parse(Parser->Parser, Size / sizeof(CHAR16), (CHAR16 *)Buffer, TRUE, Parser);
-
-    //
-    // UTF-8 (also includes ASCII/Latin-1) detection
-    //
-    case 0x3CBFBBEF:
-      // BOM followed by <
-    case 0x20BFBBEF:
-      // BOM followed by space
-    case 0x0DBFBBEF:
-      // BOM followed by carriage return
-    case 0x0ABFBBEF:
-      // BOM followed by line feed
-
-      // Skip the BOM mark
-      Size -= (3 * sizeof(CHAR8));
-      Buffer = (VOID *)(((CHAR8 *)Buffer) + 3);
-
-    case 0x783F3C20:
-      // Space followed by <?x
-    case 0x783F3C0D:
-      // Carriage return followed by <?x
-    case 0x783F3C0A:
-      // Line feed followed by <?x
-    case 0x6D783F3C:
-      // <?xm
-    case 0x3F3C2020:
-      // Two spaces followed by <?
-    case 0x3F3C200D:
-      // Carriage return followed by space followed by <?
-    case 0x3F3C200A:
-      // Line feed followed space followed by <?
-    case 0x3F3C0D20:
-      // Space followed by carriage return followed by <?
-    case 0x3F3C0D0D:
-      // Two carriage returns followed by <?
-    case 0x3F3C0D0A:
-      // Line feed followed by carriage return followed by <?
-    case 0x3F3C0A20:
-      // Space followed by line feed followed by <?
-    case 0x3F3C0A0D:
-      // Carriage return followed by line feed followed by <?
-    case 0x3F3C0A0A:
-      // Two line feeds followed by <?
-    case 0x3C202020:
-      // Three spaces followed by <
-    case 0x3C20200D:
-      // Carriage return followed by two spaces followed by <
-    case 0x3C20200A:
-      // Line feed followed by two spaces followed by <
-    case 0x3C200D20:
-      // Space followed by carriage return followed by space followed by <
-    case 0x3C200D0D:
-      // Two carriage returns followed by space followed by <
-    case 0x3C200D0A:
-      // Line feed followed by carriage return followed by space followed by <
-    case 0x3C200A20:
-      // Space followed by line feed followed by space followed by <
-    case 0x3C200A0D:
-      // Carriage return followed by line feed followed by space followed by <
-    case 0x3C200A0A:
-      // Two line feeds followed by space followed by <
-    case 0x3C0D2020:
-      // Two spaces followed by carriage return followed by <
-    case 0x3C0D200D:
-      // Carriage return followed by space followed by carriage return followed by <
-    case 0x3C0D200A:
-      // Line feed followed by space followed by carriage return followed by <
-    case 0x3C0D0D20:
-      // Space followed by two carriage returns followed by <
-    case 0x3C0D0D0D:
-      // Three carriage returns followed by <
-    case 0x3C0D0D0A:
-      // Line feed followed by two carriage returns followed by <
-    case 0x3C0D0A20:
-      // Space followed by line feed followed by carriage return followed by <
-    case 0x3C0D0A0D:
-      // Carriage return followed by line feed followed by carriage return followed by <
-    case 0x3C0D0A0A:
-      // Two line feeds followed by carriage return followed by <
-    case 0x3C0A2020:
-      // Two spaces followed by line feed followed by <
-    case 0x3C0A200D:
-      // Carriage return followed by space followed by line feed followed by <
-    case 0x3C0A200A:
-      // Line feed followed by space followed by line feed followed by <
-    case 0x3C0A0D20:
-      // Space followed by carriage return followed by line feed followed by <
-    case 0x3C0A0D0D:
-      // Two carriage returns followed by line feed followed by <
-    case 0x3C0A0D0A:
-      // Line feed followed by carriage return followed by line feed followed by <
-    case 0x3C0A0A20:
-      // Space followed by two line feeds followed by <
-    case 0x3C0A0A0D:
-      // Carriage return followed by two line feeds followed by <
-    case 0x3C0A0A0A:
-      // Three line feeds followed by <
-    case 0x20202020:
-      // Four spaces
-    case 0x2020200D:
-      // Carriage return followed by three spaces
-    case 0x2020200A:
-      // Line feed followed by three spaces
-    case 0x20200D20:
-      // Space followed by carriage return followed by two spaces
-    case 0x20200D0D:
-      // Two carriage returns followed by two spaces
-    case 0x20200D0A:
-      // Line feed followed by carriage return followed by two spaces
-    case 0x20200A20:
-      // Space followed by line feed followed by two spaces
-    case 0x20200A0D:
-      // Carriage return followed by line feed followed by two spaces
-    case 0x20200A0A:
-      // Two line feeds followed by two spaces
-    case 0x200D2020:
-      // Two spaces followed by carriage return followed by space
-    case 0x200D200D:
-      // Carriage return followed by space followed by carriage return followed by space
-    case 0x200D200A:
-      // Line feed followed by space followed by carriage return followed by space
-    case 0x200D0D20:
-      // Space followed by two carriage returns followed by space
-    case 0x200D0D0D:
-      // Three carriage returns followed by space
-    case 0x200D0D0A:
-      // Line feed followed by two carriage returns followed by space
-    case 0x200D0A20:
-      // Space followed by line feed followed by carriage return followed by space
-    case 0x200D0A0D:
-      // Carriage return followed by line feed followed by carriage return followed by space
-    case 0x200D0A0A:
-      // Two line feeds followed by carriage return followed by space
-    case 0x200A2020:
-      // Two spaces followed by line feed followed by space
-    case 0x200A200D:
-      // Carriage return followed by space followed by line feed followed by space
-    case 0x200A200A:
-      // Line feed followed by space followed by line feed followed by space
-    case 0x200A0D20:
-      // Space followed by carriage return followed by line feed followed by space
-    case 0x200A0D0D:
-      // Two carriage returns followed by line feed followed by space
-    case 0x200A0D0A:
-      // Line feed followed by carriage return followed by line feed followed by space
-    case 0x200A0A20:
-      // Space followed by two line feeds followed by space
-    case 0x200A0A0D:
-      // Carriage return followed by two line feeds followed by space
-    case 0x200A0A0A:
-      // Three line feeds followed by space
-    case 0x0D202020:
-      // Three spaces followed by carriage return
-    case 0x0D20200D:
-      // Carriage return followed by two spaces followed by carriage return
-    case 0x0D20200A:
-      // Line feed followed by two spaces followed by carriage return
-    case 0x0D200D20:
-      // Space followed by carriage return followed by space followed by carriage return
-    case 0x0D200D0D:
-      // Two carriage returns followed by space followed by carriage return
-    case 0x0D200D0A:
-      // Line feed followed by carriage return followed by space followed by carriage return
-    case 0x0D200A20:
-      // Space followed by line feed followed by space followed by carriage return
-    case 0x0D200A0D:
-      // Carriage return followed by line feed followed by space followed by carriage return
-    case 0x0D200A0A:
-      // Two line feeds followed by space followed by carriage return
-    case 0x0D0D2020:
-      // Two spaces followed by two carriage returns
-    case 0x0D0D200D:
-      // Carriage return followed by space followed by two carriage returns
-    case 0x0D0D200A:
-      // Line feed followed by space followed by two carriage returns
-    case 0x0D0D0D20:
-      // Space followed by three carriage returns
-    case 0x0D0D0D0D:
-      // Four carriage returns
-    case 0x0D0D0D0A:
-      // Line feed followed by three carriage returns
-    case 0x0D0D0A20:
-      // Space followed by line feed followed by two carriage returns
-    case 0x0D0D0A0D:
-      // Carriage return followed by line feed followed by two carriage returns
-    case 0x0D0D0A0A:
-      // Two line feeds followed by two carriage returns
-    case 0x0D0A2020:
-      // Two spaces followed by line feed followed by carriage return
-    case 0x0D0A200D:
-      // Carriage return followed by space followed by line feed followed by carriage return
-    case 0x0D0A200A:
-      // Line feed followed by space followed by line feed followed by carriage return
-    case 0x0D0A0D20:
-      // Space followed by carriage return followed by line feed followed by carriage return
-    case 0x0D0A0D0D:
-      // Two carriage returns followed by line feed followed by carriage return
-    case 0x0D0A0D0A:
-      // Line feed followed by carriage return followed by line feed followed by carriage return
-    case 0x0D0A0A20:
-      // Space followed by two line feeds followed by carriage return
-    case 0x0D0A0A0D:
-      // Carriage return followed by two line feeds followed by carriage return
-    case 0x0D0A0A0A:
-      // Three line feeds followed by carriage return
-    case 0x0A202020:
-      // Three spaces followed by line feed
-    case 0x0A20200D:
-      // Carriage return followed by two spaces followed by line feed
-    case 0x0A20200A:
-      // Line feed followed by two spaces followed by line feed
-    case 0x0A200D20:
-      // Space followed by carriage return followed by space followed by line feed
-    case 0x0A200D0D:
-      // Two carriage returns followed by space followed by line feed
-    case 0x0A200D0A:
-      // Line feed followed by carriage return followed by space followed by line feed
-    case 0x0A200A20:
-      // Space followed by line feed followed by space followed by line feed
-    case 0x0A200A0D:
-      // Carriage return followed by line feed followed by space followed by line feed
-    case 0x0A200A0A:
-      // Two line feeds followed by space followed by line feed
-    case 0x0A0D2020:
-      // Two spaces followed by carriage return followed by line feed
-    case 0x0A0D200D:
-      // Carriage return followed by space followed by carriage return followed by line feed
-    case 0x0A0D200A:
-      // Line feed followed by space followed by carriage return followed by line feed
-    case 0x0A0D0D20:
-      // Space followed by two carriage returns followed by line feed
-    case 0x0A0D0D0D:
-      // Three carriage returns followed by line feed
-    case 0x0A0D0D0A:
-      // Line feed followed by two carriage returns followed by line feed
-    case 0x0A0D0A20:
-      // Space followed by line feed followed by carriage return followed by line feed
-    case 0x0A0D0A0D:
-      // Carriage return followed by line feed followed by carriage return followed by line feed
-    case 0x0A0D0A0A:
-      // Two line feeds followed by carriage return followed by line feed
-    case 0x0A0A2020:
-      // Two spaces followed by two line feeds
-    case 0x0A0A200D:
-      // Carriage return followed by space followed by two line feeds
-    case 0x0A0A200A:
-      // Line feed followed by space followed by two line feeds
-    case 0x0A0A0D20:
-      // Space followed by carriage return followed by two line feeds
-    case 0x0A0A0D0D:
-      // Two carriage returns followed by two line feeds
-    case 0x0A0A0D0A:
-      // Line feed followed by carriage return followed by two line feeds
-    case 0x0A0A0A20:
-      // Space followed by three line feeds
-    case 0x0A0A0A0D:
-      // Carriage return followed by three line feeds
-    case 0x0A0A0A0A:
-      // Four line feeds
-    default:
-      // Unknown encoding, assume ASCII
-      break;
-  }
-  // Create the XML document
-  Status = XmlDocumentCreate(&(Parser->Document), "UTF-8");
+  // Create the XML document, the encoding is set once detected
+  Status = XmlDocumentCreate(&(Parser->Document), NULL);
   if (EFI_ERROR(Status)) {
     return Status;
   }
+  Parser->LeadingSize = 0;
+  Parser->Detected = FALSE;
   // Parse the buffer
-  return ParseEncoding(Parser->Parser, Size / sizeof(CHAR8), (CHAR8 *)Buffer, "UTF-8", Parser);
+  return XmlParseNext(Parser, Size, Buffer);
 }
 // XmlParseNext
-/// The next buffer to parse in parsing multiple buffers for XML
+/// The next buffer to parse in parsing multiple buffers for XML, buffers may be split at any byte boundary
 /// @param Parser An XML parser used to parse
 /// @param Size   The size, in bytes, of the buffer to parse
 /// @param Buffer The buffer to parse, the buffer may not contain a leading byte order mark and must be the same encoding as the start buffer
@@ -674,16 +487,32 @@ XmlParseNext (
   IN     UINTN       Size,
   IN     VOID       *Buffer
 ) {
+  EFI_STATUS Status;
+  UINTN      Count;
   // Check parameters
   if ((Parser == NULL) || (Parser->Document == NULL) || (Buffer == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
-  if (Parser->Document->Encoding != NULL) {
-    if (AsciiStriCmp(Parser->Document->Encoding, "UTF-16") == 0) {
-      return Parse(Parser->Parser, Size / sizeof(CHAR16), (CHAR16 *)Buffer, Parser->Document->ByteSwap, Parser);
+  if (Size == 0) {
+    return EFI_SUCCESS;
+  }
+  if (!Parser->Detected) {
+    // Buffer the leading bytes until there are enough to detect the encoding, buffers may be as small as one byte
+    Count = MIN(Size, XML_LEADING_SIZE - Parser->LeadingSize);
+    CopyMem(Parser->Leading + Parser->LeadingSize, Buffer, Count);
+    Parser->LeadingSize += Count;
+    if (Parser->LeadingSize < XML_LEADING_SIZE) {
+      return EFI_SUCCESS;
+    }
+    Status = XmlParseLeading(Parser);
+    if (EFI_ERROR(Status) || (Count == Size)) {
+      return Status;
     }
+    Buffer = ((UINT8 *)Buffer) + Count;
+    Size -= Count;
   }
-  return ParseEncoding(Parser->Parser, Size / sizeof(CHAR8), (CHAR8 *)Buffer, Parser->Document->Encoding, Parser);
+  // Parse the buffer with the current encoding
+  return ParseBuffer(Parser->Parser, Size, Buffer, NULL, Parser);
 }
 // XmlParseFinish
 /// Finish parsing multiple buffers for XML and finish the XML document
@@ -699,6 +528,15 @@ XmlParseFinish (
   if ((Parser == NULL) || (Parser->Document == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
+  // Parse the leading bytes of a document shorter than the bytes needed to detect the encoding
+  if (!Parser->Detected) {
+    Status = XmlParseLeading(Parser);
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+  }
+  // Discard any character left incomplete by the last buffer
+  ParseFinish(Parser->Parser);
   // Parse a final space to finish any partially complete token
   Status = ParseCharacter(Parser->Parser, L' ', Parser);
   if (EFI_ERROR(Status)) {
@@ -706,7 +544,7 @@ XmlParseFinish (
   }
   // Check to make sure that there is an encoding
   if (Parser->Document->Encoding == NULL) {
-    Parser->Document->Encoding = AsciiStrDup("UTF-16");
+    Parser->Document->Encoding = AsciiStrDup("UTF-8");
     if (Parser->Document->Encoding == NULL) {
       return EFI_OUT_OF_RESOURCES;
     }
@@ -714,6 +552,131 @@ XmlParseFinish (
   return EFI_SUCCESS;
 }
 
+// XmlTreeVisit
+/// Visit an XML document tree node with either an inspection or walk callback
+/// @param Tree       The XML document tree node
+/// @param Level      The level of generation of tree nodes, zero for the root
+/// @param LevelIndex The index of the tree node relative to the previous level
+/// @param Inspector  The inspection callback
+/// @param Walker     The walk callback, if Inspector is NULL
+/// @param Context    The context to pass to the callback
+/// @retval TRUE  If the traversal should continue
+/// @retval FALSE If the traversal should stop
+STATIC BOOLEAN
+EFIAPI
+XmlTreeVisit (
+  IN XML_TREE    *Tree,
+  IN UINTN        Level,
+  IN UINTN        LevelIndex,
+  IN XML_INSPECT  Inspector OPTIONAL,
+  IN XML_WALK     Walker OPTIONAL,
+  IN VOID        *Context OPTIONAL
+) {
+  XML_TREE **Children = NULL;
+  UINTN      ChildCount = 0;
+  // Walk callback
+  if (Inspector == NULL) {
+    return Walker(Tree, Level, LevelIndex, Tree->Name, Tree->Value, Tree->Attributes.Count, Tree->Attributes.List, Tree->Children, Context);
+  }
+  // Get children view, which is only built once
+  XmlTreeGetChildren(Tree, &Children, &ChildCount);
+  // Inspection callback
+  return Inspector(Tree, Level, LevelIndex, Tree->Name, Tree->Value, Tree->Attributes.Count, Tree->Attributes.List, ChildCount, Children, Context);
+}
+// XmlTreeTraverse
+/// Traverse the XML document tree in document order with an explicit stack
+/// @param Tree       The XML document tree node
+/// @param Level      The level of generation of tree nodes, zero for the root
+/// @param LevelIndex The index of the tree node relative to the previous level
+/// @param Inspector  The inspection callback
+/// @param Walker     The walk callback, if Inspector is NULL
+/// @param Context    The context to pass to the callback
+/// @param Recursive  Whether the traversal should include child nodes
+/// @return Whether the traversal finished or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_ABORTED          If the traversal was aborted by the callback
+/// @retval EFI_SUCCESS          If the traversal finished
+STATIC EFI_STATUS
+EFIAPI
+XmlTreeTraverse (
+  IN XML_TREE    *Tree,
+  IN UINTN        Level,
+  IN UINTN        LevelIndex,
+  IN XML_INSPECT  Inspector OPTIONAL,
+  IN XML_WALK     Walker OPTIONAL,
+  IN VOID        *Context OPTIONAL,
+  IN BOOLEAN      Recursive
+) {
+  EFI_STATUS      Status = EFI_SUCCESS;
+  XML_WALK_LEVEL *Stack;
+  UINTN           StackSize;
+  UINTN           Depth;
+  // Visit the tree node
+  if (!XmlTreeVisit(Tree, Level, LevelIndex, Inspector, Walker, Context)) {
+    return EFI_ABORTED;
+  }
+  // Check if recursive traversal
+  if (!Recursive || (Tree->Children == NULL)) {
+    return EFI_SUCCESS;
+  }
+  // Take the reusable stack so a traversal started from a callback gets its own stack
+  Stack = mXmlWalkStack;
+  StackSize = mXmlWalkStackSize;
+  mXmlWalkStack = NULL;
+  mXmlWalkStackSize = 0;
+  if (Stack == NULL) {
+    Stack = (XML_WALK_LEVEL *)AllocatePool(XML_WALK_STACK_SIZE * sizeof(XML_WALK_LEVEL));
+    if (Stack == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    StackSize = XML_WALK_STACK_SIZE;
+  }
+  // Start with the children of the tree node
+  Stack[0].Tree = Tree->Children;
+  Stack[0].Index = 0;
+  Depth = 1;
+  while (Depth > 0) {
+    XML_TREE *Node = Stack[Depth - 1].Tree;
+    // Check if this level is finished
+    if (Node == NULL) {
+      --Depth;
+      continue;
+    }
+    // Visit the next tree node at this level
+    Stack[Depth - 1].Tree = Node->Next;
+    if (!XmlTreeVisit(Node, Level + Depth, Stack[Depth - 1].Index++, Inspector, Walker, Context)) {
+      Status = EFI_ABORTED;
+      break;
+    }
+    // Descend into the children of the tree node
+    if (Node->Children != NULL) {
+      if (Depth >= StackSize) {
+        XML_WALK_LEVEL *Grown = (XML_WALK_LEVEL *)ReallocatePool(StackSize * sizeof(XML_WALK_LEVEL), (StackSize << 1) * sizeof(XML_WALK_LEVEL), Stack);
+        if (Grown == NULL) {
+          Status = EFI_OUT_OF_RESOURCES;
+          break;
+        }
+        Stack = Grown;
+        StackSize <<= 1;
+      }
+      Stack[Depth].Tree = Node->Children;
+      Stack[Depth].Index = 0;
+      ++Depth;
+    }
+  }
+  // Return the stack for reuse, keeping the larger stack if another traversal returned one
+  if ((mXmlWalkStack != NULL) && (mXmlWalkStackSize >= StackSize)) {
+    FreePool(Stack);
+  } else {
+    if (mXmlWalkStack != NULL) {
+      FreePool(mXmlWalkStack);
+    }
+    mXmlWalkStack = Stack;
+    mXmlWalkStackSize = StackSize;
+  }
+  return Status;
+}
+
 // XmlInspect
 /// Inspect the XML document tree
 /// @param Parser    The XML parser
@@ -769,9 +732,10 @@ XmlDocumentInspect (
 /// @param LevelIndex The index of the tree node relative to the previous level
 /// @param Inspector  The inspection callback
 /// @param Context    The context to pass to the inspection callback
-/// @param Recursive Whether the inspection should include child nodes
+/// @param Recursive  Whether the inspection should include child nodes
 /// @return Whether the inspection finished or not
 /// @retval EFI_INVALID_PARAMETER If Tree or Inspector is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_ABORTED           If inspection was aborted by the callback
 /// @retval EFI_SUCCESS           If inspection finished
 EFI_STATUS
@@ -784,48 +748,91 @@ XmlTreeInspect (
   IN VOID        *Context OPTIONAL,
   IN BOOLEAN      Recursive
 ) {
-  BOOLEAN         Success;
-  XML_TREE      **Children;
-  XML_ATTRIBUTE **Attributes;
-  UINTN           ChildCount;
-  UINTN           AttributeCount;
   // Check parameters
   if ((Tree == NULL) || (Inspector == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
-  // Get attributes
-  Attributes = NULL;
-  AttributeCount = 0;
-  XmlTreeGetAttributes(Tree, &Attributes, &AttributeCount);
-  // Get children
-  Children = NULL;
-  ChildCount = 0;
-  XmlTreeGetChildren(Tree, &Children, &ChildCount);
-  // Inspection callback
-  Success = Inspector(Tree, Level, LevelIndex, Tree->Name, Tree->Value, AttributeCount, Attributes, ChildCount, Children, Context);
-  if (Attributes != NULL) {
-    FreePool(Attributes);
-  }
-  if (Children != NULL) {
-    FreePool(Children);
+  return XmlTreeTraverse(Tree, Level, LevelIndex, Inspector, NULL, Context, Recursive);
+}
+
+// XmlWalk
+/// Walk the XML document tree without recursion
+/// @param Parser    The XML parser
+/// @param Walker    The walk callback
+/// @param Context   The context to pass to the walk callback
+/// @param Recursive Whether the walk should include child nodes
+/// @return Whether the walk finished or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Walker is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_ABORTED           If the walk was aborted by the callback
+/// @retval EFI_SUCCESS           If the walk finished
+EFI_STATUS
+EFIAPI
+XmlWalk (
+  IN XML_PARSER *Parser,
+  IN XML_WALK    Walker,
+  IN VOID       *Context OPTIONAL,
+  IN BOOLEAN     Recursive
+) {
+  // Check parameters
+  if ((Parser == NULL) || (Walker == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
-  if (!Success) {
-    return EFI_ABORTED;
+  return XmlDocumentWalk(Parser->Document, Walker, Context, Recursive);
+}
+// XmlDocumentWalk
+/// Walk the XML document tree without recursion
+/// @param Document  The XML document
+/// @param Walker    The walk callback
+/// @param Context   The context to pass to the walk callback
+/// @param Recursive Whether the walk should include child nodes
+/// @return Whether the walk finished or not
+/// @retval EFI_INVALID_PARAMETER If Document or Walker is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_ABORTED           If the walk was aborted by the callback
+/// @retval EFI_SUCCESS           If the walk finished
+EFI_STATUS
+EFIAPI
+XmlDocumentWalk (
+  IN XML_DOCUMENT *Document,
+  IN XML_WALK      Walker,
+  IN VOID         *Context OPTIONAL,
+  IN BOOLEAN       Recursive
+) {
+  // Check parameters
+  if ((Document == NULL) || (Walker == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
-  // Check if recursive inspection
-  if (Recursive) {
-    UINTN     Index = 0;
-    XML_TREE *Child = Tree->Children;
-    while (Child != NULL) {
-      // Inspect each child
-      EFI_STATUS Status = XmlTreeInspect(Child, Level + 1, Index++, Inspector, Context, Recursive);
-      if (EFI_ERROR(Status)) {
-        return Status;
-      }
-      Child = Child->Next;
-    }
+  return XmlTreeWalk(Document->Tree, 0, 0, Walker, Context, Recursive);
+}
+// XmlTreeWalk
+/// Walk the XML document tree without recursion
+/// @param Tree       The XML document tree node
+/// @param Level      The level of generation of tree nodes, zero for the root
+/// @param LevelIndex The index of the tree node relative to the previous level
+/// @param Walker     The walk callback
+/// @param Context    The context to pass to the walk callback
+/// @param Recursive  Whether the walk should include child nodes
+/// @return Whether the walk finished or not
+/// @retval EFI_INVALID_PARAMETER If Tree or Walker is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_ABORTED           If the walk was aborted by the callback
+/// @retval EFI_SUCCESS           If the walk finished
+EFI_STATUS
+EFIAPI
+XmlTreeWalk (
+  IN XML_TREE *Tree,
+  IN UINTN     Level,
+  IN UINTN     LevelIndex,
+  IN XML_WALK  Walker,
+  IN VOID     *Context OPTIONAL,
+  IN BOOLEAN   Recursive
+) {
+  // Check parameters
+  if ((Tree == NULL) || (Walker == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
-  return EFI_SUCCESS;
+  return XmlTreeTraverse(Tree, Level, LevelIndex, NULL, Walker, Context, Recursive);
 }
 
 // XmlGetDocument
@@ -886,6 +893,53 @@ XmlGetTree (
   }
   return XmlDocumentGetTree(Parser->Document, Tree);
 }
+// XmlGetMessageCount
+/// Get the count of retained XML parser errors and warnings
+/// @param Parser  An XML parser
+/// @param Count   On output, the count of retained messages
+/// @param Dropped On output, the count of messages dropped because too many messages were added
+/// @return Whether the count of messages was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Count is NULL
+/// @retval EFI_SUCCESS           If the count of messages was retrieved successfully
+EFI_STATUS
+EFIAPI
+XmlGetMessageCount (
+  IN  XML_PARSER *Parser,
+  OUT UINTN      *Count,
+  OUT UINTN      *Dropped OPTIONAL
+) {
+  // Check parameters
+  if (Parser == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  return ParseGetMessageCount(Parser->Parser, Count, Dropped);
+}
+// XmlGetMessage
+/// Get a retained XML parser error or warning
+/// @param Parser   An XML parser
+/// @param Index    The index of the message, from the oldest retained message
+/// @param Flags    On output, the message flags, LANG_MESSAGE_ERROR or LANG_MESSAGE_WARNING
+/// @param Position On output, the input position at which the message was added
+/// @param Message  On output, the message, which must not be freed and is valid until the parser is reset or freed
+/// @return Whether the message was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Message is NULL
+/// @retval EFI_NOT_FOUND         If Index is not less than the count of retained messages
+/// @retval EFI_SUCCESS           If the message was retrieved successfully
+EFI_STATUS
+EFIAPI
+XmlGetMessage (
+  IN  XML_PARSER     *Parser,
+  IN  UINTN           Index,
+  OUT UINTN          *Flags OPTIONAL,
+  OUT LANG_POSITION  *Position OPTIONAL,
+  OUT CHAR16        **Message
+) {
+  // Check parameters
+  if (Parser == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  return ParseGetMessage(Parser->Parser, Index, Flags, Position, Message);
+}
 
 // XmlDocumentGetEncoding
 /// Get XML document encoding
@@ -1019,6 +1073,7 @@ XmlTreeGetTag (
 /// @param Tag  The XML document tree tag name to set
 /// @return Whether the XML document tree tag name was set or not
 /// @retval EFI_INVALID_PARAMETER If Tree or Tag is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_SUCCESS           If the XML document tree tag name was set successfully
 EFI_STATUS
 EFIAPI
@@ -1027,13 +1082,15 @@ XmlTreeSetTag (
   IN     CHAR16   *Tag
 ) {
   // Check parameters
-  if ((Tree == NULL) || (Tag == NULL)) {
+  if ((Tree == NULL) || (Tag == NULL) || (*Tag == L'\0')) {
     return EFI_INVALID_PARAMETER;
   }
-  if (Tree->Name != NULL) {
-    FreePool(Tree->Name);
+  // The previous tag name is released with the arena
+  Tag = XmlArenaStrDup(Tree->Arena, Tag);
+  if (Tag == NULL) {
+    return EFI_OUT_OF_RESOURCES;
   }
-  Tree->Name = StrDup(Tag);
+  Tree->Name = Tag;
   return EFI_SUCCESS;
 }
 // XmlTreeGetValue
@@ -1062,6 +1119,7 @@ XmlTreeGetValue (
 /// @param Tag  The XML document tree node value to set
 /// @return Whether the XML document tree node value was set or not
 /// @retval EFI_INVALID_PARAMETER If Tree or Value is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_SUCCESS           If the XML document tree node value was set successfully
 EFI_STATUS
 EFIAPI
@@ -1073,10 +1131,13 @@ XmlTreeSetValue (
   if ((Tree == NULL) || (Value == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
-  if (Tree->Value != NULL) {
-    FreePool(Tree->Value);
+  // The previous value is released with the arena
+  Value = XmlArenaStrDup(Tree->Arena, Value);
+  if (Value == NULL) {
+    return EFI_OUT_OF_RESOURCES;
   }
-  Tree->Value = StrDup(Value);
+  Tree->Value = Value;
+  Tree->ValueLength = StrLen(Value);
   return EFI_SUCCESS;
 }
 // XmlTreeHasChildren
@@ -1092,14 +1153,57 @@ XmlTreeHasChildren (
 ) {
   return ((Tree != NULL) && (Tree->Children != NULL));
 }
+// XmlTreeGetFirstChild
+/// Get XML document tree node first child node
+/// @param Tree  An XML document tree node
+/// @param Child On output, the XML document tree node first child node
+/// @return Whether the XML document tree node first child node was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Tree or Child is NULL
+/// @retval EFI_NOT_FOUND         If there are no XML document tree child nodes
+/// @retval EFI_SUCCESS           If the XML document tree node first child node was retrieved successfully
+EFI_STATUS
+EFIAPI
+XmlTreeGetFirstChild (
+  IN  XML_TREE  *Tree,
+  OUT XML_TREE **Child
+) {
+  // Check parameters
+  if ((Tree == NULL) || (Child == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  *Child = Tree->Children;
+  return (Tree->Children == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+// XmlTreeGetNextSibling
+/// Get XML document tree node next sibling node
+/// @param Tree    An XML document tree node
+/// @param Sibling On output, the XML document tree node next sibling node
+/// @return Whether the XML document tree node next sibling node was retrieved or not
+/// @retval EFI_INVALID_PARAMETER If Tree or Sibling is NULL
+/// @retval EFI_NOT_FOUND         If there are no more XML document tree sibling nodes
+/// @retval EFI_SUCCESS           If the XML document tree node next sibling node was retrieved successfully
+EFI_STATUS
+EFIAPI
+XmlTreeGetNextSibling (
+  IN  XML_TREE  *Tree,
+  OUT XML_TREE **Sibling
+) {
+  // Check parameters
+  if ((Tree == NULL) || (Sibling == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  *Sibling = Tree->Next;
+  return (Tree->Next == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
 // XmlTreeGetChildren
 /// Get XML document tree node child nodes
 /// @param Tree     An XML document tree
-/// @param Children On output, the XML document tree node child nodes, which must be freed
+/// @param Children On output, the XML document tree node child nodes view, which must not be freed and is valid until the parser is reset or freed
 /// @param Count    On output, the count of children
 /// @return Whether the XML document tree child nodes were retrieved or not
-/// @retval EFI_INVALID_PARAMETER If Tree, Children, or Count is NULL or *Children is not NULL
+/// @retval EFI_INVALID_PARAMETER If Tree, Children, or Count is NULL
 /// @retval EFI_NOT_FOUND         If there are no XML document tree child nodes
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_SUCCESS           If the XML document tree child nodes were retrieved successfully
 EFI_STATUS
 EFIAPI
@@ -1108,88 +1212,59 @@ XmlTreeGetChildren (
   OUT XML_TREE ***Children,
   OUT UINTN      *Count
 ) {
-  XML_TREE **ChildList;
-  XML_TREE  *List;
-  UINTN      ChildCount;
-  UINTN      ListCount;
+  XML_TREE *List;
+  UINTN     Index;
   // Check parameters
-  if ((Tree == NULL) || (Children == NULL) || (*Children != NULL) || (Count == NULL)) {
+  if ((Tree == NULL) || (Children == NULL) || (Count == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
-  // Count the child nodes
-  ListCount = 0;
-  for (List = Tree->Children; List != NULL; List = List->Next) {
-    ++ListCount;
-  }
   // If there are no children, return not found
-  if (ListCount == 0) {
+  if (Tree->ChildCount == 0) {
     return EFI_NOT_FOUND;
   }
-  // Allocate new list
-  ChildList = (XML_TREE **)AllocateZeroPool(ListCount * sizeof(XML_TREE *));
-  if (ChildList == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-  // Copy child nodes list
-  ChildCount = 0;
-  List = Tree->Children;
-  while ((List != NULL) && (ChildCount < ListCount)) {
-    ChildList[ChildCount++] = List;
-    List = List->Next;
+  // Build the child nodes view the first time it is requested
+  if (Tree->ChildList == NULL) {
+    Tree->ChildList = (XML_TREE **)XmlArenaAllocate(Tree->Arena, Tree->ChildCount * sizeof(XML_TREE *));
+    if (Tree->ChildList == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Index = 0;
+    for (List = Tree->Children; (List != NULL) && (Index < Tree->ChildCount); List = List->Next) {
+      Tree->ChildList[Index++] = List;
+    }
   }
-  // Return the child nodes list
-  *Children = ChildList;
-  *Count = ChildCount;
+  // Return the child nodes view
+  *Children = Tree->ChildList;
+  *Count = Tree->ChildCount;
   return EFI_SUCCESS;
 }
 // XmlTreeGetAttributes
 /// Get XML document tree node attributes
 /// @param Tree       An XML document tree
-/// @param Attributes On output, the XML document tree node attributes, which must be freed
+/// @param Attributes On output, the XML document tree node attributes view, which must not be freed and is valid until the tree node attributes change
 /// @param Count      On output, the count of attributes
 /// @return Whether the XML document tree attributes were retrieved or not
-/// @retval EFI_INVALID_PARAMETER If Tree, Attributes, or Count is NULL or *Attributes is not NULL
+/// @retval EFI_INVALID_PARAMETER If Tree, Attributes, or Count is NULL
 /// @retval EFI_NOT_FOUND         If there are no XML document tree attibutes
 /// @retval EFI_SUCCESS           If the XML document tree attributes were retrieved successfully
 EFI_STATUS
 EFIAPI
 XmlTreeGetAttributes (
-  IN  XML_TREE        *Tree,
-  OUT XML_ATTRIBUTE ***Attributes,
-  OUT UINTN           *Count
+  IN  XML_TREE       *Tree,
+  OUT XML_ATTRIBUTE **Attributes,
+  OUT UINTN          *Count
 ) {
-  XML_ATTRIBUTE **AttributeList;
-  XML_LIST       *List;
-  UINTN           AttributeCount;
-  UINTN           ListCount;
   // Check parameters
-  if ((Tree == NULL) || (Attributes == NULL) || (*Attributes != NULL) || (Count == NULL)) {
+  if ((Tree == NULL) || (Attributes == NULL) || (Count == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
-  // Count the attributes
-  ListCount = 0;
-  for (List = Tree->Attributes; List != NULL; List = List->Next) {
-    ++ListCount;
-  }
   // If there are no attributes, return not found
-  if (ListCount == 0) {
+  if (Tree->Attributes.Count == 0) {
     return EFI_NOT_FOUND;
   }
-  // Allocate new list
-  AttributeList = (XML_ATTRIBUTE **)AllocateZeroPool(ListCount * sizeof(XML_ATTRIBUTE *));
-  if (AttributeList == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-  // Copy attributes list
-  AttributeCount = 0;
-  List = Tree->Attributes;
-  while ((List != NULL) && (AttributeCount < ListCount)) {
-    AttributeList[AttributeCount++] = &(List->Attribute);
-    List = List->Next;
-  }
-  // Return the attributes list
-  *Attributes = AttributeList;
-  *Count = AttributeCount;
+  // Return the attributes view
+  *Attributes = Tree->Attributes.List;
+  *Count = Tree->Attributes.Count;
   return EFI_SUCCESS;
 }
 // XmlTreeGetAttribute
@@ -1208,20 +1283,19 @@ XmlTreeGetAttribute (
   IN  CHAR16         *Name,
   OUT XML_ATTRIBUTE **Attribute
 ) {
-  XML_LIST *List;
+  EFI_STATUS Status;
+  UINTN      Index = 0;
   // Check parameters
   if ((Tree == NULL) || (Name == NULL) || (Attribute == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
   // Search for attribute
-  for (List = Tree->Attributes; List != NULL; List = List->Next) {
-    if ((List->Attribute.Name != NULL) && (StrCmp(Name, List->Attribute.Name) == 0)) {
-      *Attribute = &(List->Attribute);
-      return EFI_SUCCESS;
-    }
+  Status = XmlAttributesFind(Tree->Arena, &(Tree->Attributes), Name, &Index);
+  if (EFI_ERROR(Status)) {
+    return Status;
   }
-  // Not found
-  return EFI_NOT_FOUND;
+  *Attribute = &(Tree->Attributes.List[Index]);
+  return EFI_SUCCESS;
 }
 // XmlTreeSetAttribute
 /// Set an XML document tree node attribute
@@ -1230,6 +1304,7 @@ XmlTreeGetAttribute (
 /// @param Attribute The XML document tree attribute to set
 /// @return Whether the XML document tree attribute was set or not
 /// @retval EFI_INVALID_PARAMETER If Tree, Name, Attribute, or Attribute->Name is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_SUCCESS           If the XML document tree attribute was set successfully
 EFI_STATUS
 EFIAPI
@@ -1238,34 +1313,42 @@ XmlTreeSetAttribute (
   IN     CHAR16        *Name,
   IN     XML_ATTRIBUTE *Attribute
 ) {
-  XML_LIST *List = NULL;
+  EFI_STATUS     Status;
+  XML_ATTRIBUTE *Ptr = NULL;
+  CHAR16        *NewName;
+  CHAR16        *Value = NULL;
   // Check parameters
   if ((Tree == NULL) || (Name == NULL) || (Attribute == NULL) || (Attribute->Name == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
-  // Search for attribute
-  for (List = Tree->Attributes; List != NULL; List = List->Next) {
-    if ((List->Attribute.Name != NULL) && (StrCmp(Name, List->Attribute.Name) == 0)) {
-      XmlAttributeDuplicateMembers(&(List->Attribute), Attribute);
-      return EFI_SUCCESS;
-    }
+  // Intern the name and duplicate the value first since the attribute may be a view of this tree node attributes
+  NewName = XmlArenaIntern(Tree->Arena, Attribute->Name);
+  if (NewName == NULL) {
+    return EFI_OUT_OF_RESOURCES;
   }
-  // Allocate a new attribute
-  if (List == NULL) {
-    if (Tree->Attributes == NULL) {
-      List = Tree->Attributes = (XML_LIST *)AllocateZeroPool(sizeof(XML_LIST));
-    } else {
-      for (List = Tree->Attributes; List->Next != NULL; List = List->Next);
-      List = List->Next = (XML_LIST *)AllocateZeroPool(sizeof(XML_LIST));
+  if (Attribute->Value != NULL) {
+    Value = XmlArenaStrDup(Tree->Arena, Attribute->Value);
+    if (Value == NULL) {
+      return EFI_OUT_OF_RESOURCES;
     }
   }
-  // Check the attribute was allocate
-  if (List == NULL) {
-    return EFI_INVALID_PARAMETER;
+  // Search for attribute or add a new attribute, the previous members are released with the arena
+  if (EFI_ERROR(XmlTreeGetAttribute(Tree, Name, &Ptr))) {
+    Status = XmlAttributesAdd(Tree->Arena, &(Tree->Attributes), NewName, &Ptr);
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+  } else if (Ptr->Name != NewName) {
+    // Renaming moves the attribute in the index
+    Ptr->Name = NewName;
+    if (Tree->Attributes.Index != NULL) {
+      Status = XmlAttributesIndexBuild(Tree->Arena, &(Tree->Attributes));
+      if (EFI_ERROR(Status)) {
+        return Status;
+      }
+    }
   }
-  // Return the new attribute
-  List->Next = NULL;
-  XmlAttributeDuplicateMembers(&(List->Attribute), Attribute);
+  Ptr->Value = Value;
   return EFI_SUCCESS;
 }
 // XmlTreeRemoveAttribute
@@ -1274,6 +1357,7 @@ XmlTreeSetAttribute (
 /// @param Name The name of the XML document tree node attribute to remove
 /// @return Whether the XML document tree attribute was removed or not
 /// @retval EFI_INVALID_PARAMETER If Tree or Name is NULL
+/// @retval EFI_NOT_FOUND         If the XML document tree attibute was not found
 /// @retval EFI_SUCCESS           If the XML document tree attribute was removed successfully
 EFI_STATUS
 EFIAPI
@@ -1281,29 +1365,18 @@ XmlTreeRemoveAttribute (
   IN OUT XML_TREE *Tree,
   IN     CHAR16   *Name
 ) {
-  XML_LIST *Attribute;
+  EFI_STATUS Status;
+  UINTN      Index = 0;
   // Check parameters
   if ((Tree == NULL) || (Name == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
-  if (Tree->Attributes != NULL) {
-    // Check if first attribute
-    if (StrCmp(Name, Tree->Attributes->Attribute.Name) == 0) {
-      Attribute = Tree->Attributes;
-      Tree->Attributes = Attribute->Next;
-      XmlAttributeListFree(Attribute);
-      return EFI_SUCCESS;
-    } else {
-      // Check rest of attributes
-      for (Attribute = Tree->Attributes; Attribute->Next != NULL; Attribute = Attribute->Next) {
-        if ((Attribute->Next->Attribute.Name!= NULL) && (StrCmp(Name, Attribute->Next->Attribute.Name) == 0)) {
-          return EFI_SUCCESS;
-        }
-      }
-    }
+  // Search for attribute
+  Status = XmlAttributesFind(Tree->Arena, &(Tree->Attributes), Name, &Index);
+  if (EFI_ERROR(Status)) {
+    return Status;
   }
-  // Not found
-  return EFI_NOT_FOUND;
+  return XmlAttributesRemove(Tree->Arena, &(Tree->Attributes), Index);
 }
 
 // XmlLibInitialize
@@ -1327,5 +1400,11 @@ EFIAPI
 XmlLibFinish (
   VOID
 ) {
+  // Free the tree walk stack
+  if (mXmlWalkStack != NULL) {
+    FreePool(mXmlWalkStack);
+    mXmlWalkStack = NULL;
+  }
+  mXmlWalkStackSize = 0;
   return EFI_SUCCESS;
 }
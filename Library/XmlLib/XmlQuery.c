@@ -0,0 +1,663 @@
+//
+/// @file Library/XmlLib/XmlQuery.c
+///
+/// XML query
+///
+
+#include "XmlStates.h"
+
+// XML_QUERY_MAX_STEPS
+/// The maximum count of steps in a query
+#define XML_QUERY_MAX_STEPS 32
+// XML_QUERY_MAX_PREDICATES
+/// The maximum count of predicates in a query step
+#define XML_QUERY_MAX_PREDICATES 8
+
+// XML_QUERY_AXIS
+/// XML query step axes
+typedef enum _XML_QUERY_AXIS XML_QUERY_AXIS;
+enum _XML_QUERY_AXIS {
+
+  XML_QUERY_AXIS_CHILD = 0,
+  XML_QUERY_AXIS_DESCENDANT,
+
+};
+// XML_QUERY_PREDICATE_TYPE
+/// XML query predicate types
+typedef enum _XML_QUERY_PREDICATE_TYPE XML_QUERY_PREDICATE_TYPE;
+enum _XML_QUERY_PREDICATE_TYPE {
+
+  XML_QUERY_PREDICATE_ATTRIBUTE = 0,
+  XML_QUERY_PREDICATE_VALUE,
+  XML_QUERY_PREDICATE_INDEX,
+
+};
+
+// XML_QUERY_PREDICATE
+/// XML query step predicate
+typedef struct _XML_QUERY_PREDICATE XML_QUERY_PREDICATE;
+struct _XML_QUERY_PREDICATE {
+
+  // Type
+  /// The predicate type
+  XML_QUERY_PREDICATE_TYPE  Type;
+  // Name
+  /// The attribute name for attribute predicates
+  CHAR16                   *Name;
+  // Value
+  /// The attribute value for attribute value predicates
+  CHAR16                   *Value;
+  // Index
+  /// The one based position for index predicates
+  UINTN                     Index;
+
+};
+// XML_QUERY_STEP
+/// XML query step
+typedef struct _XML_QUERY_STEP XML_QUERY_STEP;
+struct _XML_QUERY_STEP {
+
+  // Axis
+  /// The axis from the previous step
+  XML_QUERY_AXIS       Axis;
+  // Name
+  /// The tag name or NULL for any tag name
+  CHAR16              *Name;
+  // PredicateCount
+  /// The count of predicates
+  UINTN                PredicateCount;
+  // Predicates
+  /// The predicates
+  XML_QUERY_PREDICATE  Predicates[XML_QUERY_MAX_PREDICATES];
+
+};
+// XML_QUERY_LEVEL
+/// XML query stack level
+typedef struct _XML_QUERY_LEVEL XML_QUERY_LEVEL;
+struct _XML_QUERY_LEVEL {
+
+  // Tree
+  /// The tree node at this depth
+  XML_TREE *Tree;
+  // Matched
+  /// The bitmask of steps the tree node matches while the previous steps match its ancestors
+  UINT32    Matched;
+  // Reached
+  /// The bitmask of steps matched by the tree node or any of its ancestors
+  UINT32    Reached;
+
+};
+// XML_QUERY
+/// XML compiled query
+struct _XML_QUERY {
+
+  // Absolute
+  /// Whether the query starts from the tree node itself instead of its children
+  BOOLEAN          Absolute;
+  // MaxDepth
+  /// The maximum depth of a match or zero if the query has descendant steps
+  UINTN            MaxDepth;
+  // StepCount
+  /// The count of steps
+  UINTN            StepCount;
+  // Steps
+  /// The steps
+  XML_QUERY_STEP  *Steps;
+  // StackSize
+  /// The count of tree nodes that fit in the stack
+  UINTN            StackSize;
+  // Stack
+  /// The stack of tree nodes from the start of the query to the current tree node, reused by each run
+  XML_QUERY_LEVEL *Stack;
+
+};
+// XML_QUERY_SELECT
+/// XML query selection context
+typedef struct _XML_QUERY_SELECT XML_QUERY_SELECT;
+struct _XML_QUERY_SELECT {
+
+  // Size
+  /// The count of tree nodes that fit in the matches
+  UINTN      Size;
+  // Count
+  /// The count of matches
+  UINTN      Count;
+  // Matches
+  /// The matched tree nodes
+  XML_TREE **Matches;
+
+};
+
+// XmlQueryIsNameCharacter
+/// Check if a character can be part of a name in a query
+/// @param Character The character to check
+/// @retval TRUE  If the character can be part of a name
+/// @retval FALSE If the character can not be part of a name
+STATIC BOOLEAN
+EFIAPI
+XmlQueryIsNameCharacter (
+  IN CHAR16 Character
+) {
+  switch (Character) {
+    case L'\0':
+    case L'/':
+    case L'[':
+    case L']':
+    case L'@':
+    case L'=':
+    case L'*':
+    case L'\'':
+    case L'\"':
+    case L' ':
+    case L'\t':
+      return FALSE;
+
+    default:
+      break;
+  }
+  return TRUE;
+}
+// XmlQuerySkipSpace
+/// Skip white space in a query
+/// @param Path The query position
+/// @return The query position after white space
+STATIC CHAR16 *
+EFIAPI
+XmlQuerySkipSpace (
+  IN CHAR16 *Path
+) {
+  while ((*Path == L' ') || (*Path == L'\t')) {
+    ++Path;
+  }
+  return Path;
+}
+// XmlQueryName
+/// Duplicate a name in a query
+/// @param Path On input, the query position, on output, the query position after the name
+/// @param Name On output, the duplicated name, which must be freed
+/// @return Whether the name was duplicated or not
+/// @retval EFI_INVALID_PARAMETER If there is no name at the query position
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the name was duplicated successfully
+STATIC EFI_STATUS
+EFIAPI
+XmlQueryName (
+  IN OUT CHAR16 **Path,
+  OUT    CHAR16 **Name
+) {
+  CHAR16 *Start = *Path;
+  CHAR16 *End = Start;
+  while (XmlQueryIsNameCharacter(*End)) {
+    ++End;
+  }
+  if (End == Start) {
+    return EFI_INVALID_PARAMETER;
+  }
+  *Name = StrnDup(Start, (UINTN)(End - Start));
+  if (*Name == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  *Path = End;
+  return EFI_SUCCESS;
+}
+// XmlQueryPredicate
+/// Compile a query step predicate
+/// @param Path      On input, the query position after the opening bracket, on output, the query position after the closing bracket
+/// @param Predicate On output, the compiled predicate
+/// @return Whether the predicate was compiled or not
+/// @retval EFI_INVALID_PARAMETER If the predicate is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the predicate was compiled successfully
+STATIC EFI_STATUS
+EFIAPI
+XmlQueryPredicate (
+  IN OUT CHAR16              **Path,
+  OUT    XML_QUERY_PREDICATE  *Predicate
+) {
+  EFI_STATUS  Status;
+  CHAR16     *Ptr = XmlQuerySkipSpace(*Path);
+  if (*Ptr == L'@') {
+    // Attribute predicate
+    ++Ptr;
+    Status = XmlQueryName(&Ptr, &(Predicate->Name));
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+    Predicate->Type = XML_QUERY_PREDICATE_ATTRIBUTE;
+    Ptr = XmlQuerySkipSpace(Ptr);
+    if (*Ptr == L'=') {
+      // Attribute value predicate
+      CHAR16 Quote;
+      CHAR16 *Start;
+      Ptr = XmlQuerySkipSpace(Ptr + 1);
+      Quote = *Ptr;
+      if ((Quote != L'\'') && (Quote != L'\"')) {
+        return EFI_INVALID_PARAMETER;
+      }
+      Start = ++Ptr;
+      while ((*Ptr != Quote) && (*Ptr != L'\0')) {
+        ++Ptr;
+      }
+      if (*Ptr != Quote) {
+        return EFI_INVALID_PARAMETER;
+      }
+      Predicate->Value = StrnDup(Start, (UINTN)(Ptr - Start));
+      if (Predicate->Value == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      Predicate->Type = XML_QUERY_PREDICATE_VALUE;
+      Ptr = XmlQuerySkipSpace(Ptr + 1);
+    }
+  } else if ((*Ptr >= L'0') && (*Ptr <= L'9')) {
+    // Index predicate
+    Predicate->Type = XML_QUERY_PREDICATE_INDEX;
+    Predicate->Index = 0;
+    while ((*Ptr >= L'0') && (*Ptr <= L'9')) {
+      Predicate->Index = (Predicate->Index * 10) + (UINTN)(*Ptr++ - L'0');
+    }
+    if (Predicate->Index == 0) {
+      return EFI_INVALID_PARAMETER;
+    }
+    Ptr = XmlQuerySkipSpace(Ptr);
+  } else {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Check the predicate is closed
+  if (*Ptr != L']') {
+    return EFI_INVALID_PARAMETER;
+  }
+  *Path = Ptr + 1;
+  return EFI_SUCCESS;
+}
+
+// XmlQueryTest
+/// Test if a tree node matches the name and predicates of a query step
+/// @param Step   The query step
+/// @param Limit  The count of predicates to test
+/// @param Parent The parent tree node or NULL if the tree node is where the query started
+/// @param Tree   The tree node
+/// @retval TRUE  If the tree node matches
+/// @retval FALSE If the tree node does not match
+STATIC BOOLEAN
+EFIAPI
+XmlQueryTest (
+  IN XML_QUERY_STEP *Step,
+  IN UINTN           Limit,
+  IN XML_TREE       *Parent OPTIONAL,
+  IN XML_TREE       *Tree
+) {
+  UINTN Index;
+  // Check the name
+  if ((Step->Name != NULL) && ((Tree->Name == NULL) || (StrCmp(Step->Name, Tree->Name) != 0))) {
+    return FALSE;
+  }
+  // Check the predicates in order since positions are relative to the previous predicates
+  for (Index = 0; Index < Limit; ++Index) {
+    XML_QUERY_PREDICATE *Predicate = &(Step->Predicates[Index]);
+    XML_ATTRIBUTE       *Attribute = NULL;
+    XML_TREE            *Sibling;
+    UINTN                Position;
+    switch (Predicate->Type) {
+      case XML_QUERY_PREDICATE_ATTRIBUTE:
+        if (EFI_ERROR(XmlTreeGetAttribute(Tree, Predicate->Name, &Attribute))) {
+          return FALSE;
+        }
+        break;
+
+      case XML_QUERY_PREDICATE_VALUE:
+        if (EFI_ERROR(XmlTreeGetAttribute(Tree, Predicate->Name, &Attribute)) ||
+            (Attribute->Value == NULL) || (StrCmp(Predicate->Value, Attribute->Value) != 0)) {
+          return FALSE;
+        }
+        break;
+
+      case XML_QUERY_PREDICATE_INDEX:
+        // The tree node where the query started has no siblings
+        if (Parent == NULL) {
+          if (Predicate->Index != 1) {
+            return FALSE;
+          }
+          break;
+        }
+        // Count the preceding siblings that match so far
+        Position = 1;
+        for (Sibling = Parent->Children; (Sibling != NULL) && (Sibling != Tree); Sibling = Sibling->Next) {
+          if (XmlQueryTest(Step, Index, Parent, Sibling)) {
+            if (++Position > Predicate->Index) {
+              return FALSE;
+            }
+          }
+        }
+        if (Position != Predicate->Index) {
+          return FALSE;
+        }
+        break;
+
+      default:
+        return FALSE;
+    }
+  }
+  return TRUE;
+}
+// XmlQueryMatch
+/// Match the query steps against the tree node at a depth in the stack, the steps matched by its ancestors were already
+///  found when they were visited so every tree node is tested once for each step
+/// @param Query The compiled query
+/// @param Depth The depth in the stack of the tree node to match
+/// @retval TRUE  If the tree node matches the last step and the previous steps match its ancestors
+/// @retval FALSE If the tree node does not match
+STATIC BOOLEAN
+EFIAPI
+XmlQueryMatch (
+  IN XML_QUERY *Query,
+  IN UINTN      Depth
+) {
+  XML_QUERY_LEVEL *Level = &(Query->Stack[Depth]);
+  XML_QUERY_LEVEL *Parent = (Depth > 0) ? &(Query->Stack[Depth - 1]) : NULL;
+  XML_QUERY_STEP  *QueryStep;
+  UINTN            First = Query->Absolute ? 0 : 1;
+  UINTN            Step;
+  BOOLEAN          Candidate;
+  Level->Matched = 0;
+  for (Step = 0; Step < Query->StepCount; ++Step) {
+    QueryStep = &(Query->Steps[Step]);
+    if (Step == 0) {
+      // The first step is anchored to where the query started
+      Candidate = (QueryStep->Axis == XML_QUERY_AXIS_CHILD) ? (Depth == First) : (Depth >= First);
+    } else if (Parent == NULL) {
+      Candidate = FALSE;
+    } else if (QueryStep->Axis == XML_QUERY_AXIS_CHILD) {
+      // The parent matches the previous step
+      Candidate = ((Parent->Matched & (1U << (Step - 1))) != 0);
+    } else {
+      // Any ancestor matches the previous step
+      Candidate = ((Parent->Reached & (1U << (Step - 1))) != 0);
+    }
+    if (Candidate && XmlQueryTest(QueryStep, QueryStep->PredicateCount, (Parent != NULL) ? Parent->Tree : NULL, Level->Tree)) {
+      Level->Matched |= (1U << Step);
+    }
+  }
+  Level->Reached = Level->Matched | ((Parent != NULL) ? Parent->Reached : 0);
+  return ((Level->Matched & (1U << (Query->StepCount - 1))) != 0);
+}
+// XmlQuerySelectMatch
+/// XML query selection match callback
+/// @param Tree    The matched tree node
+/// @param Index   The index of the match
+/// @param Context The selection context
+/// @retval TRUE  If the query should continue
+/// @retval FALSE If the query should stop
+STATIC BOOLEAN
+EFIAPI
+XmlQuerySelectMatch (
+  IN XML_TREE *Tree,
+  IN UINTN     Index,
+  IN VOID     *Context OPTIONAL
+) {
+  XML_QUERY_SELECT *Select = (XML_QUERY_SELECT *)Context;
+  if ((Select->Matches != NULL) && (Select->Count < Select->Size)) {
+    Select->Matches[Select->Count] = Tree;
+  }
+  ++(Select->Count);
+  return TRUE;
+}
+
+// XmlQueryCompile
+/// Compile a query that can be reused for any number of runs
+/// @param Path  The query path, steps are separated by / for child steps or // for descendant steps, each step is a tag name or * and
+///               may be followed by predicates [@name], [@name='value'], or [index], a leading / starts at the tree node itself
+/// @param Query On output, the compiled query, which must be freed with XmlQueryFree
+/// @return Whether the query was compiled or not
+/// @retval EFI_INVALID_PARAMETER If Path or Query is NULL, *Query is not NULL, or the query is malformed
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the query was compiled successfully
+EFI_STATUS
+EFIAPI
+XmlQueryCompile (
+  IN  CHAR16     *Path,
+  OUT XML_QUERY **Query
+) {
+  EFI_STATUS      Status;
+  XML_QUERY      *Ptr;
+  XML_QUERY_STEP *Step;
+  XML_QUERY_AXIS  Axis = XML_QUERY_AXIS_CHILD;
+  BOOLEAN         HasDescendant = FALSE;
+  // Check parameters
+  if ((Path == NULL) || (Query == NULL) || (*Query != NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Allocate the query
+  Ptr = (XML_QUERY *)AllocateZeroPool(sizeof(XML_QUERY));
+  if (Ptr == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Ptr->Steps = (XML_QUERY_STEP *)AllocateZeroPool(XML_QUERY_MAX_STEPS * sizeof(XML_QUERY_STEP));
+  if (Ptr->Steps == NULL) {
+    FreePool(Ptr);
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Check where the query starts
+  Path = XmlQuerySkipSpace(Path);
+  if (*Path == L'/') {
+    Ptr->Absolute = TRUE;
+  } else if ((Path[0] == L'.') && (Path[1] == L'/')) {
+    ++Path;
+  }
+  Status = EFI_SUCCESS;
+  for (;;) {
+    // Get the step axis
+    if (*Path == L'/') {
+      Axis = XML_QUERY_AXIS_CHILD;
+      if (*(++Path) == L'/') {
+        Axis = XML_QUERY_AXIS_DESCENDANT;
+        HasDescendant = TRUE;
+        ++Path;
+      }
+    }
+    if (Ptr->StepCount >= XML_QUERY_MAX_STEPS) {
+      Status = EFI_INVALID_PARAMETER;
+      break;
+    }
+    Step = &(Ptr->Steps[Ptr->StepCount++]);
+    Step->Axis = Axis;
+    // Get the step name
+    if (*Path == L'*') {
+      Step->Name = NULL;
+      ++Path;
+    } else {
+      Status = XmlQueryName(&Path, &(Step->Name));
+      if (EFI_ERROR(Status)) {
+        break;
+      }
+    }
+    // Get the step predicates
+    while (*Path == L'[') {
+      if (Step->PredicateCount >= XML_QUERY_MAX_PREDICATES) {
+        Status = EFI_INVALID_PARAMETER;
+        break;
+      }
+      ++Path;
+      Status = XmlQueryPredicate(&Path, &(Step->Predicates[Step->PredicateCount++]));
+      if (EFI_ERROR(Status)) {
+        break;
+      }
+    }
+    if (EFI_ERROR(Status)) {
+      break;
+    }
+    // Check for the next step or the end of the query
+    Path = XmlQuerySkipSpace(Path);
+    if (*Path == L'\0') {
+      break;
+    }
+    if (*Path != L'/') {
+      Status = EFI_INVALID_PARAMETER;
+      break;
+    }
+  }
+  if (EFI_ERROR(Status)) {
+    XmlQueryFree(Ptr);
+    return Status;
+  }
+  // Matches can not be deeper than the steps without descendant steps
+  if (!HasDescendant) {
+    Ptr->MaxDepth = Ptr->Absolute ? (Ptr->StepCount - 1) : Ptr->StepCount;
+  }
+  // Return the compiled query
+  *Query = Ptr;
+  return EFI_SUCCESS;
+}
+// XmlQueryFree
+/// Free a compiled query
+/// @param Query The compiled query to free
+/// @return Whether the compiled query was freed or not
+/// @retval EFI_INVALID_PARAMETER If Query is NULL
+/// @retval EFI_SUCCESS           If the compiled query was freed successfully
+EFI_STATUS
+EFIAPI
+XmlQueryFree (
+  IN XML_QUERY *Query
+) {
+  UINTN Index;
+  UINTN Predicate;
+  // Check parameters
+  if (Query == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Free the steps
+  if (Query->Steps != NULL) {
+    for (Index = 0; Index < Query->StepCount; ++Index) {
+      XML_QUERY_STEP *Step = &(Query->Steps[Index]);
+      if (Step->Name != NULL) {
+        FreePool(Step->Name);
+      }
+      for (Predicate = 0; Predicate < Step->PredicateCount; ++Predicate) {
+        if (Step->Predicates[Predicate].Name != NULL) {
+          FreePool(Step->Predicates[Predicate].Name);
+        }
+        if (Step->Predicates[Predicate].Value != NULL) {
+          FreePool(Step->Predicates[Predicate].Value);
+        }
+      }
+    }
+    FreePool(Query->Steps);
+  }
+  // Free the stack
+  if (Query->Stack != NULL) {
+    FreePool(Query->Stack);
+  }
+  FreePool(Query);
+  return EFI_SUCCESS;
+}
+// XmlQueryRun
+/// Run a compiled query, matches are found in document order and are views that must not be freed
+/// @param Query    The compiled query, which must not be run by more than one caller at the same time
+/// @param Tree     The tree node where the query starts
+/// @param Callback The callback for each matched tree node
+/// @param Context  The context to pass to the callback
+/// @return Whether the query found matches or not
+/// @retval EFI_INVALID_PARAMETER If Query, Tree, or Callback is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_NOT_FOUND         If no tree nodes matched the query
+/// @retval EFI_ABORTED           If the query was stopped by the callback
+/// @retval EFI_SUCCESS           If the query finished with matches
+EFI_STATUS
+EFIAPI
+XmlQueryRun (
+  IN XML_QUERY       *Query,
+  IN XML_TREE        *Tree,
+  IN XML_QUERY_MATCH  Callback,
+  IN VOID            *Context OPTIONAL
+) {
+  XML_TREE *Node;
+  UINTN     Depth;
+  UINTN     Count;
+  // Check parameters
+  if ((Query == NULL) || (Tree == NULL) || (Callback == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Query->StepCount == 0) {
+    return EFI_NOT_FOUND;
+  }
+  // Allocate the stack the first time the query runs
+  if (Query->Stack == NULL) {
+    Query->Stack = (XML_QUERY_LEVEL *)AllocatePool(XML_WALK_STACK_SIZE * sizeof(XML_QUERY_LEVEL));
+    if (Query->Stack == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Query->StackSize = XML_WALK_STACK_SIZE;
+  }
+  // Visit the tree nodes in document order keeping the ancestors on the stack
+  Query->Stack[0].Tree = Tree;
+  Depth = 0;
+  Count = 0;
+  for (;;) {
+    Node = Query->Stack[Depth].Tree;
+    // Check if the tree node matches the query
+    if (XmlQueryMatch(Query, Depth)) {
+      if (!Callback(Node, Count++, Context)) {
+        return EFI_ABORTED;
+      }
+    }
+    // Descend into the children unless the matches can not be deeper
+    if ((Node->Children != NULL) && ((Query->MaxDepth == 0) || (Depth < Query->MaxDepth))) {
+      if ((Depth + 1) >= Query->StackSize) {
+        XML_QUERY_LEVEL *Grown = (XML_QUERY_LEVEL *)ReallocatePool(Query->StackSize * sizeof(XML_QUERY_LEVEL), (Query->StackSize << 1) * sizeof(XML_QUERY_LEVEL), Query->Stack);
+        if (Grown == NULL) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+        Query->Stack = Grown;
+        Query->StackSize <<= 1;
+      }
+      Query->Stack[++Depth].Tree = Node->Children;
+      continue;
+    }
+    // Advance to the next sibling or the next sibling of an ancestor
+    while ((Depth > 0) && (Query->Stack[Depth].Tree->Next == NULL)) {
+      --Depth;
+    }
+    if (Depth == 0) {
+      break;
+    }
+    Query->Stack[Depth].Tree = Query->Stack[Depth].Tree->Next;
+  }
+  return (Count == 0) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+// XmlQuerySelect
+/// Run a compiled query and return the matches in a caller supplied array
+/// @param Query   The compiled query, which must not be run by more than one caller at the same time
+/// @param Tree    The tree node where the query starts
+/// @param Count   On input, the count of tree nodes that fit in Matches, on output, the count of matched tree nodes
+/// @param Matches On output, the matched tree nodes in document order, which are views that must not be freed
+/// @return Whether the query found matches or not
+/// @retval EFI_INVALID_PARAMETER If Query, Tree, or Count is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_NOT_FOUND         If no tree nodes matched the query
+/// @retval EFI_BUFFER_TOO_SMALL  If there were more matches than fit in Matches, which was filled
+/// @retval EFI_SUCCESS           If the matches were returned successfully
+EFI_STATUS
+EFIAPI
+XmlQuerySelect (
+  IN     XML_QUERY  *Query,
+  IN     XML_TREE   *Tree,
+  IN OUT UINTN      *Count,
+  OUT    XML_TREE  **Matches OPTIONAL
+) {
+  EFI_STATUS       Status;
+  XML_QUERY_SELECT Select;
+  // Check parameters
+  if (Count == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Run the query
+  Select.Size = (Matches == NULL) ? 0 : *Count;
+  Select.Count = 0;
+  Select.Matches = Matches;
+  Status = XmlQueryRun(Query, Tree, XmlQuerySelectMatch, &Select);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Return the count of matches
+  *Count = Select.Count;
+  return (Select.Count > Select.Size) ? EFI_BUFFER_TOO_SMALL : EFI_SUCCESS;
+}
@@ -0,0 +1,803 @@
+//
+/// @file Library/XmlLib/XmlSerialize.c
+///
+/// XML serializer
+///
+
+#include "XmlStates.h"
+
+#include <Library/FileHandleLib.h>
+
+// XML_WRITER_BUFFER_SIZE
+/// The size, in bytes, of the serializer output buffer
+#define XML_WRITER_BUFFER_SIZE 0x1000
+// XML_WRITER_MAX_SEQUENCE
+/// The maximum size, in bytes, of one encoded character or character reference
+#define XML_WRITER_MAX_SEQUENCE 12
+// XML_WRITER_MEMORY_SIZE
+/// The initial size, in bytes, of serialization to memory
+#define XML_WRITER_MEMORY_SIZE 0x1000
+
+// XML_WRITER_ENCODING
+/// XML serializer output encodings
+typedef enum _XML_WRITER_ENCODING XML_WRITER_ENCODING;
+enum _XML_WRITER_ENCODING {
+
+  XML_WRITER_ENCODING_UTF8 = 0,
+  XML_WRITER_ENCODING_UTF16LE,
+  XML_WRITER_ENCODING_UTF16BE,
+  XML_WRITER_ENCODING_LATIN1,
+  XML_WRITER_ENCODING_ASCII,
+
+};
+// XML_WRITER_ESCAPE
+/// XML serializer escaping modes
+typedef enum _XML_WRITER_ESCAPE XML_WRITER_ESCAPE;
+enum _XML_WRITER_ESCAPE {
+
+  XML_WRITER_ESCAPE_NONE = 0,
+  XML_WRITER_ESCAPE_TEXT,
+  XML_WRITER_ESCAPE_ATTRIBUTE,
+
+};
+
+// XML_WRITER_ENCODING_NAME
+/// XML serializer output encoding name
+typedef struct _XML_WRITER_ENCODING_NAME XML_WRITER_ENCODING_NAME;
+struct _XML_WRITER_ENCODING_NAME {
+
+  // Name
+  /// The encoding name
+  CHAR8               *Name;
+  // Encoding
+  /// The output encoding
+  XML_WRITER_ENCODING  Encoding;
+
+};
+// XML_WRITER_LEVEL
+/// XML serializer stack level
+typedef struct _XML_WRITER_LEVEL XML_WRITER_LEVEL;
+struct _XML_WRITER_LEVEL {
+
+  // Parent
+  /// The tree node whose children are being written
+  XML_TREE *Parent;
+  // Next
+  /// The next child node to write
+  XML_TREE *Next;
+
+};
+// XML_WRITER
+/// XML serializer
+typedef struct _XML_WRITER XML_WRITER;
+struct _XML_WRITER {
+
+  // Write
+  /// The sink callback
+  XML_WRITE            Write;
+  // Context
+  /// The context passed to the sink callback
+  VOID                *Context;
+  // Encoding
+  /// The output encoding
+  XML_WRITER_ENCODING  Encoding;
+  // Indent
+  /// The count of spaces to indent each level or zero for no formatting
+  UINTN                Indent;
+  // Status
+  /// The first error that occured while writing
+  EFI_STATUS           Status;
+  // Used
+  /// The size, in bytes, used in the output buffer
+  UINTN                Used;
+  // Buffer
+  /// The output buffer, which is reused for each write to the sink
+  UINT8                Buffer[XML_WRITER_BUFFER_SIZE];
+
+};
+// XML_WRITER_MEMORY
+/// XML serializer memory sink
+typedef struct _XML_WRITER_MEMORY XML_WRITER_MEMORY;
+struct _XML_WRITER_MEMORY {
+
+  // Size
+  /// The size, in bytes, written
+  UINTN  Size;
+  // Capacity
+  /// The size, in bytes, allocated
+  UINTN  Capacity;
+  // Buffer
+  /// The written buffer
+  UINT8 *Buffer;
+
+};
+
+// mXmlWriterEncodings
+/// XML serializer output encoding names
+STATIC XML_WRITER_ENCODING_NAME mXmlWriterEncodings[] = {
+  { "UTF-8",       XML_WRITER_ENCODING_UTF8 },
+  { "UTF-16",      XML_WRITER_ENCODING_UTF16LE },
+  { "UTF-16LE",    XML_WRITER_ENCODING_UTF16LE },
+  { "UTF-16BE",    XML_WRITER_ENCODING_UTF16BE },
+  { "ISO-8859-1",  XML_WRITER_ENCODING_LATIN1 },
+  { "ISO-Latin-1", XML_WRITER_ENCODING_LATIN1 },
+  { "Latin-1",     XML_WRITER_ENCODING_LATIN1 },
+  { "US-ASCII",    XML_WRITER_ENCODING_ASCII },
+  { "ASCII",       XML_WRITER_ENCODING_ASCII },
+};
+
+// XmlWriterFlush
+/// Write the output buffer to the sink
+/// @param Writer The XML serializer
+STATIC VOID
+EFIAPI
+XmlWriterFlush (
+  IN OUT XML_WRITER *Writer
+) {
+  if (!EFI_ERROR(Writer->Status) && (Writer->Used > 0)) {
+    Writer->Status = Writer->Write(Writer->Used, Writer->Buffer, Writer->Context);
+  }
+  Writer->Used = 0;
+}
+// XmlWriterByte
+/// Write a byte to the output buffer, the output buffer must have room
+/// @param Writer The XML serializer
+/// @param Byte   The byte to write
+STATIC VOID
+EFIAPI
+XmlWriterByte (
+  IN OUT XML_WRITER *Writer,
+  IN     UINT8       Byte
+) {
+  Writer->Buffer[Writer->Used++] = Byte;
+}
+// XmlWriterUnit
+/// Write a code unit in the output encoding to the output buffer, the output buffer must have room
+/// @param Writer The XML serializer
+/// @param Unit   The code unit to write
+STATIC VOID
+EFIAPI
+XmlWriterUnit (
+  IN OUT XML_WRITER *Writer,
+  IN     UINT16      Unit
+) {
+  switch (Writer->Encoding) {
+    case XML_WRITER_ENCODING_UTF16LE:
+      XmlWriterByte(Writer, (UINT8)(Unit & 0xFF));
+      XmlWriterByte(Writer, (UINT8)(Unit >> 8));
+      break;
+
+    case XML_WRITER_ENCODING_UTF16BE:
+      XmlWriterByte(Writer, (UINT8)(Unit >> 8));
+      XmlWriterByte(Writer, (UINT8)(Unit & 0xFF));
+      break;
+
+    default:
+      XmlWriterByte(Writer, (UINT8)Unit);
+      break;
+  }
+}
+// XmlWriterAscii
+/// Write markup to the output buffer
+/// @param Writer The XML serializer
+/// @param Markup The markup to write
+STATIC VOID
+EFIAPI
+XmlWriterAscii (
+  IN OUT XML_WRITER *Writer,
+  IN     CHAR8      *Markup
+) {
+  while (*Markup != '\0') {
+    if ((Writer->Used + XML_WRITER_MAX_SEQUENCE) > XML_WRITER_BUFFER_SIZE) {
+      XmlWriterFlush(Writer);
+    }
+    XmlWriterUnit(Writer, (UINT16)(UINT8)*Markup++);
+  }
+}
+// XmlWriterReference
+/// Write a numeric character reference to the output buffer, the output buffer must have room
+/// @param Writer    The XML serializer
+/// @param Character The character to write
+STATIC VOID
+EFIAPI
+XmlWriterReference (
+  IN OUT XML_WRITER *Writer,
+  IN     UINT32      Character
+) {
+  UINTN Shift = 20;
+  XmlWriterUnit(Writer, '&');
+  XmlWriterUnit(Writer, '#');
+  XmlWriterUnit(Writer, 'x');
+  // Skip leading zeros
+  while ((Shift > 0) && (((Character >> Shift) & 0xF) == 0)) {
+    Shift -= 4;
+  }
+  // Write hexadecimal digits
+  for (;;) {
+    UINT32 Digit = (Character >> Shift) & 0xF;
+    XmlWriterUnit(Writer, (UINT16)((Digit < 10) ? ('0' + Digit) : ('A' + Digit - 10)));
+    if (Shift == 0) {
+      break;
+    }
+    Shift -= 4;
+  }
+  XmlWriterUnit(Writer, ';');
+}
+// XmlWriterCharacter
+/// Write a character in the output encoding to the output buffer
+/// @param Writer    The XML serializer
+/// @param Character The character to write
+STATIC VOID
+EFIAPI
+XmlWriterCharacter (
+  IN OUT XML_WRITER *Writer,
+  IN     UINT32      Character
+) {
+  if ((Writer->Used + XML_WRITER_MAX_SEQUENCE) > XML_WRITER_BUFFER_SIZE) {
+    XmlWriterFlush(Writer);
+  }
+  switch (Writer->Encoding) {
+    case XML_WRITER_ENCODING_UTF8:
+      if (Character < 0x80) {
+        XmlWriterByte(Writer, (UINT8)Character);
+      } else if (Character < 0x800) {
+        XmlWriterByte(Writer, (UINT8)(0xC0 | (Character >> 6)));
+        XmlWriterByte(Writer, (UINT8)(0x80 | (Character & 0x3F)));
+      } else if (Character < 0x10000) {
+        XmlWriterByte(Writer, (UINT8)(0xE0 | (Character >> 12)));
+        XmlWriterByte(Writer, (UINT8)(0x80 | ((Character >> 6) & 0x3F)));
+        XmlWriterByte(Writer, (UINT8)(0x80 | (Character & 0x3F)));
+      } else {
+        XmlWriterByte(Writer, (UINT8)(0xF0 | (Character >> 18)));
+        XmlWriterByte(Writer, (UINT8)(0x80 | ((Character >> 12) & 0x3F)));
+        XmlWriterByte(Writer, (UINT8)(0x80 | ((Character >> 6) & 0x3F)));
+        XmlWriterByte(Writer, (UINT8)(0x80 | (Character & 0x3F)));
+      }
+      break;
+
+    case XML_WRITER_ENCODING_UTF16LE:
+    case XML_WRITER_ENCODING_UTF16BE:
+      if (Character >= 0x10000) {
+        XmlWriterUnit(Writer, (UINT16)(0xD800 + ((Character - 0x10000) >> 10)));
+        XmlWriterUnit(Writer, (UINT16)(0xDC00 + (Character & 0x3FF)));
+      } else {
+        XmlWriterUnit(Writer, (UINT16)Character);
+      }
+      break;
+
+    case XML_WRITER_ENCODING_LATIN1:
+      if (Character < 0x100) {
+        XmlWriterByte(Writer, (UINT8)Character);
+      } else {
+        XmlWriterReference(Writer, Character);
+      }
+      break;
+
+    default:
+      if (Character < 0x80) {
+        XmlWriterByte(Writer, (UINT8)Character);
+      } else {
+        XmlWriterReference(Writer, Character);
+      }
+      break;
+  }
+}
+// XmlWriterString
+/// Write a string to the output buffer
+/// @param Writer The XML serializer
+/// @param String The string to write
+/// @param Escape How the string should be escaped
+STATIC VOID
+EFIAPI
+XmlWriterString (
+  IN OUT XML_WRITER        *Writer,
+  IN     CHAR16            *String,
+  IN     XML_WRITER_ESCAPE  Escape
+) {
+  while (*String != L'\0') {
+    UINT32 Character = *String++;
+    // Combine surrogate pairs
+    if ((Character >= 0xD800) && (Character < 0xDC00) && (*String >= 0xDC00) && (*String < 0xE000)) {
+      Character = 0x10000 + ((Character - 0xD800) << 10) + (*String++ - 0xDC00);
+    }
+    // Escape markup characters
+    if (Escape != XML_WRITER_ESCAPE_NONE) {
+      switch (Character) {
+        case L'&':
+          XmlWriterAscii(Writer, "&amp;");
+          continue;
+
+        case L'<':
+          XmlWriterAscii(Writer, "&lt;");
+          continue;
+
+        case L'>':
+          XmlWriterAscii(Writer, "&gt;");
+          continue;
+
+        case L'\"':
+          if (Escape == XML_WRITER_ESCAPE_ATTRIBUTE) {
+            XmlWriterAscii(Writer, "&quot;");
+            continue;
+          }
+          break;
+
+        case L'\t':
+        case L'\r':
+        case L'\n':
+          // Preserve whitespace that attribute value normalization would replace
+          if (Escape == XML_WRITER_ESCAPE_ATTRIBUTE) {
+            if ((Writer->Used + XML_WRITER_MAX_SEQUENCE) > XML_WRITER_BUFFER_SIZE) {
+              XmlWriterFlush(Writer);
+            }
+            XmlWriterReference(Writer, Character);
+            continue;
+          }
+          break;
+
+        default:
+          break;
+      }
+    }
+    XmlWriterCharacter(Writer, Character);
+  }
+}
+// XmlWriterLine
+/// Start a new indented line inside a tree node if the serializer is formatting, a tree node with a value has mixed
+///  content so whitespace inside it would become part of the value when parsed again
+/// @param Writer The XML serializer
+/// @param Parent The XML document tree node inside which the line starts
+/// @param Level  The level of generation of the tree node on the line
+STATIC VOID
+EFIAPI
+XmlWriterLine (
+  IN OUT XML_WRITER *Writer,
+  IN     XML_TREE   *Parent,
+  IN     UINTN       Level
+) {
+  UINTN Count;
+  if ((Writer->Indent == 0) || ((Parent->Value != NULL) && (*(Parent->Value) != L'\0'))) {
+    return;
+  }
+  XmlWriterCharacter(Writer, L'\n');
+  for (Count = Level * Writer->Indent; Count > 0; --Count) {
+    XmlWriterCharacter(Writer, L' ');
+  }
+}
+// XmlWriterStartTag
+/// Write the start tag of a tree node and its value
+/// @param Writer The XML serializer
+/// @param Tree   The XML document tree node
+STATIC VOID
+EFIAPI
+XmlWriterStartTag (
+  IN OUT XML_WRITER *Writer,
+  IN     XML_TREE   *Tree
+) {
+  UINTN Index;
+  // Write the tag name
+  XmlWriterCharacter(Writer, L'<');
+  XmlWriterString(Writer, Tree->Name, XML_WRITER_ESCAPE_NONE);
+  // Write the attributes
+  for (Index = 0; Index < Tree->Attributes.Count; ++Index) {
+    XML_ATTRIBUTE *Attribute = &(Tree->Attributes.List[Index]);
+    if (Attribute->Name != NULL) {
+      XmlWriterCharacter(Writer, L' ');
+      XmlWriterString(Writer, Attribute->Name, XML_WRITER_ESCAPE_NONE);
+      XmlWriterAscii(Writer, "=\"");
+      if (Attribute->Value != NULL) {
+        XmlWriterString(Writer, Attribute->Value, XML_WRITER_ESCAPE_ATTRIBUTE);
+      }
+      XmlWriterCharacter(Writer, L'\"');
+    }
+  }
+  // Check if the tag is empty
+  if ((Tree->Children == NULL) && ((Tree->Value == NULL) || (*(Tree->Value) == L'\0'))) {
+    XmlWriterAscii(Writer, "/>");
+    return;
+  }
+  XmlWriterCharacter(Writer, L'>');
+  // Write the value
+  if (Tree->Value != NULL) {
+    XmlWriterString(Writer, Tree->Value, XML_WRITER_ESCAPE_TEXT);
+  }
+}
+// XmlWriterEndTag
+/// Write the end tag of a tree node
+/// @param Writer The XML serializer
+/// @param Tree   The XML document tree node
+STATIC VOID
+EFIAPI
+XmlWriterEndTag (
+  IN OUT XML_WRITER *Writer,
+  IN     XML_TREE   *Tree
+) {
+  XmlWriterAscii(Writer, "</");
+  XmlWriterString(Writer, Tree->Name, XML_WRITER_ESCAPE_NONE);
+  XmlWriterCharacter(Writer, L'>');
+}
+// XmlWriterTree
+/// Write a tree node and its child nodes in document order with an explicit stack
+/// @param Writer The XML serializer
+/// @param Tree   The XML document tree node
+/// @param Level  The level of generation of the tree node
+STATIC VOID
+EFIAPI
+XmlWriterTree (
+  IN OUT XML_WRITER *Writer,
+  IN     XML_TREE   *Tree,
+  IN     UINTN       Level
+) {
+  XML_WRITER_LEVEL *Stack;
+  UINTN             StackSize;
+  UINTN             Depth;
+  // Write the tree node
+  XmlWriterStartTag(Writer, Tree);
+  if (Tree->Children == NULL) {
+    if ((Tree->Value != NULL) && (*(Tree->Value) != L'\0')) {
+      XmlWriterEndTag(Writer, Tree);
+    }
+    return;
+  }
+  // Allocate the stack
+  StackSize = XML_WALK_STACK_SIZE;
+  Stack = (XML_WRITER_LEVEL *)AllocatePool(StackSize * sizeof(XML_WRITER_LEVEL));
+  if (Stack == NULL) {
+    Writer->Status = EFI_OUT_OF_RESOURCES;
+    return;
+  }
+  Stack[0].Parent = Tree;
+  Stack[0].Next = Tree->Children;
+  Depth = 1;
+  while ((Depth > 0) && !EFI_ERROR(Writer->Status)) {
+    XML_TREE *Node = Stack[Depth - 1].Next;
+    // Check if this level is finished
+    if (Node == NULL) {
+      --Depth;
+      XmlWriterLine(Writer, Stack[Depth].Parent, Level + Depth);
+      XmlWriterEndTag(Writer, Stack[Depth].Parent);
+      continue;
+    }
+    Stack[Depth - 1].Next = Node->Next;
+    // Write the child node
+    XmlWriterLine(Writer, Stack[Depth - 1].Parent, Level + Depth);
+    XmlWriterStartTag(Writer, Node);
+    if (Node->Children == NULL) {
+      if ((Node->Value != NULL) && (*(Node->Value) != L'\0')) {
+        XmlWriterEndTag(Writer, Node);
+      }
+      continue;
+    }
+    // Descend into the children of the child node
+    if (Depth >= StackSize) {
+      XML_WRITER_LEVEL *Grown = (XML_WRITER_LEVEL *)ReallocatePool(StackSize * sizeof(XML_WRITER_LEVEL), (StackSize << 1) * sizeof(XML_WRITER_LEVEL), Stack);
+      if (Grown == NULL) {
+        Writer->Status = EFI_OUT_OF_RESOURCES;
+        break;
+      }
+      Stack = Grown;
+      StackSize <<= 1;
+    }
+    Stack[Depth].Parent = Node;
+    Stack[Depth].Next = Node->Children;
+    ++Depth;
+  }
+  FreePool(Stack);
+}
+// XmlWriterCreate
+/// Create an XML serializer
+/// @param Writer   On output, the XML serializer, which must be freed with FreePool
+/// @param Encoding The output encoding or NULL for UTF-8
+/// @param Indent   The count of spaces to indent each level or zero for no formatting
+/// @param Write    The sink callback
+/// @param Context  The context to pass to the sink callback
+/// @return Whether the XML serializer was created or not
+/// @retval EFI_UNSUPPORTED      If the encoding is not supported
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the XML serializer was created successfully
+STATIC EFI_STATUS
+EFIAPI
+XmlWriterCreate (
+  OUT XML_WRITER **Writer,
+  IN  CHAR8       *Encoding OPTIONAL,
+  IN  UINTN        Indent,
+  IN  XML_WRITE    Write,
+  IN  VOID        *Context OPTIONAL
+) {
+  XML_WRITER *Ptr;
+  UINTN       Index = 0;
+  // Find the output encoding
+  if (Encoding != NULL) {
+    for (Index = 0; Index < ARRAY_SIZE(mXmlWriterEncodings); ++Index) {
+      if (AsciiStriCmp(mXmlWriterEncodings[Index].Name, Encoding) == 0) {
+        break;
+      }
+    }
+    if (Index >= ARRAY_SIZE(mXmlWriterEncodings)) {
+      return EFI_UNSUPPORTED;
+    }
+  }
+  // Allocate the serializer
+  Ptr = (XML_WRITER *)AllocatePool(sizeof(XML_WRITER));
+  if (Ptr == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Ptr->Write = Write;
+  Ptr->Context = Context;
+  Ptr->Encoding = mXmlWriterEncodings[Index].Encoding;
+  Ptr->Indent = Indent;
+  Ptr->Status = EFI_SUCCESS;
+  Ptr->Used = 0;
+  *Writer = Ptr;
+  return EFI_SUCCESS;
+}
+// XmlWriterFinish
+/// Flush and free an XML serializer
+/// @param Writer The XML serializer
+/// @return The first error that occurred while writing
+STATIC EFI_STATUS
+EFIAPI
+XmlWriterFinish (
+  IN XML_WRITER *Writer
+) {
+  EFI_STATUS Status;
+  XmlWriterFlush(Writer);
+  Status = Writer->Status;
+  FreePool(Writer);
+  return Status;
+}
+
+// XmlWriteMemory
+/// XML serialization memory sink
+/// @param Size    The size, in bytes, of the buffer to write
+/// @param Buffer  The buffer to write
+/// @param Context The memory sink
+/// @return Whether the buffer was written or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the buffer was written successfully
+STATIC EFI_STATUS
+EFIAPI
+XmlWriteMemory (
+  IN UINTN  Size,
+  IN VOID  *Buffer,
+  IN VOID  *Context OPTIONAL
+) {
+  XML_WRITER_MEMORY *Memory = (XML_WRITER_MEMORY *)Context;
+  // Grow the memory by doubling
+  if ((Memory->Size + Size) > Memory->Capacity) {
+    UINTN  Capacity = (Memory->Capacity == 0) ? XML_WRITER_MEMORY_SIZE : Memory->Capacity;
+    UINT8 *Grown;
+    while ((Memory->Size + Size) > Capacity) {
+      Capacity <<= 1;
+    }
+    Grown = (UINT8 *)ReallocatePool(Memory->Capacity, Capacity, Memory->Buffer);
+    if (Grown == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Memory->Buffer = Grown;
+    Memory->Capacity = Capacity;
+  }
+  // Append the buffer
+  CopyMem(Memory->Buffer + Memory->Size, Buffer, Size);
+  Memory->Size += Size;
+  return EFI_SUCCESS;
+}
+// XmlWriteFile
+/// XML serialization file sink
+/// @param Size    The size, in bytes, of the buffer to write
+/// @param Buffer  The buffer to write
+/// @param Context The file handle
+/// @return Whether the buffer was written or not
+STATIC EFI_STATUS
+EFIAPI
+XmlWriteFile (
+  IN UINTN  Size,
+  IN VOID  *Buffer,
+  IN VOID  *Context OPTIONAL
+) {
+  EFI_STATUS Status;
+  UINTN      Written = Size;
+  Status = FileHandleWrite((EFI_FILE_HANDLE)Context, &Written, Buffer);
+  if (!EFI_ERROR(Status) && (Written != Size)) {
+    Status = EFI_VOLUME_FULL;
+  }
+  return Status;
+}
+
+// XmlWrite
+/// Serialize the XML document of an XML parser
+/// @param Parser   The XML parser
+/// @param Encoding The output encoding or NULL for the document encoding
+/// @param Indent   The count of spaces to indent each level or zero for no formatting
+/// @param Write    The sink callback
+/// @param Context  The context to pass to the sink callback
+/// @return Whether the XML document was serialized or not
+/// @retval EFI_INVALID_PARAMETER If Parser or Write is NULL
+/// @retval EFI_UNSUPPORTED       If the encoding is not supported
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the XML document was serialized successfully
+EFI_STATUS
+EFIAPI
+XmlWrite (
+  IN XML_PARSER *Parser,
+  IN CHAR8      *Encoding OPTIONAL,
+  IN UINTN       Indent,
+  IN XML_WRITE   Write,
+  IN VOID       *Context OPTIONAL
+) {
+  // Check parameters
+  if ((Parser == NULL) || (Write == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  return XmlDocumentSerialize(Parser->Document, Encoding, Indent, Write, Context);
+}
+// XmlDocumentSerialize
+/// Serialize an XML document in one pass through a reused output buffer
+/// @param Document The XML document
+/// @param Encoding The output encoding or NULL for the document encoding
+/// @param Indent   The count of spaces to indent each level or zero for no formatting
+/// @param Write    The sink callback
+/// @param Context  The context to pass to the sink callback
+/// @return Whether the XML document was serialized or not
+/// @retval EFI_INVALID_PARAMETER If Document or Write is NULL
+/// @retval EFI_UNSUPPORTED       If the encoding is not supported
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the XML document was serialized successfully
+EFI_STATUS
+EFIAPI
+XmlDocumentSerialize (
+  IN XML_DOCUMENT *Document,
+  IN CHAR8        *Encoding OPTIONAL,
+  IN UINTN         Indent,
+  IN XML_WRITE     Write,
+  IN VOID         *Context OPTIONAL
+) {
+  EFI_STATUS  Status;
+  XML_WRITER *Writer = NULL;
+  UINTN       Index;
+  // Check parameters
+  if ((Document == NULL) || (Write == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Encoding == NULL) {
+    Encoding = (Document->Encoding == NULL) ? "UTF-8" : Document->Encoding;
+  }
+  // Create the serializer
+  Status = XmlWriterCreate(&Writer, Encoding, Indent, Write, Context);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Write the byte order mark for unicode so the byte order can be detected
+  if ((Writer->Encoding == XML_WRITER_ENCODING_UTF16LE) || (Writer->Encoding == XML_WRITER_ENCODING_UTF16BE)) {
+    XmlWriterUnit(Writer, 0xFEFF);
+  }
+  // Write the declaration with the document attributes other than the encoding
+  XmlWriterAscii(Writer, "<?xml");
+  for (Index = 0; Index < Document->Attributes.Count; ++Index) {
+    XML_ATTRIBUTE *Attribute = &(Document->Attributes.List[Index]);
+    if ((Attribute->Name != NULL) && (StriCmp(Attribute->Name, L"encoding") != 0)) {
+      XmlWriterCharacter(Writer, L' ');
+      XmlWriterString(Writer, Attribute->Name, XML_WRITER_ESCAPE_NONE);
+      XmlWriterAscii(Writer, "=\"");
+      if (Attribute->Value != NULL) {
+        XmlWriterString(Writer, Attribute->Value, XML_WRITER_ESCAPE_ATTRIBUTE);
+      }
+      XmlWriterCharacter(Writer, L'\"');
+    }
+  }
+  if (Document->Attributes.Count == 0) {
+    XmlWriterAscii(Writer, " version=\"1.0\"");
+  }
+  XmlWriterAscii(Writer, " encoding=\"");
+  XmlWriterAscii(Writer, Encoding);
+  XmlWriterAscii(Writer, "\"?>");
+  // Write the document tree
+  if (Document->Tree != NULL) {
+    XmlWriterCharacter(Writer, L'\n');
+    XmlWriterTree(Writer, Document->Tree, 0);
+  }
+  XmlWriterCharacter(Writer, L'\n');
+  return XmlWriterFinish(Writer);
+}
+// XmlTreeSerialize
+/// Serialize an XML document tree node and its child nodes in one pass through a reused output buffer
+/// @param Tree     The XML document tree node
+/// @param Encoding The output encoding or NULL for UTF-8
+/// @param Indent   The count of spaces to indent each level or zero for no formatting
+/// @param Write    The sink callback
+/// @param Context  The context to pass to the sink callback
+/// @return Whether the XML document tree node was serialized or not
+/// @retval EFI_INVALID_PARAMETER If Tree or Write is NULL
+/// @retval EFI_UNSUPPORTED       If the encoding is not supported
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the XML document tree node was serialized successfully
+EFI_STATUS
+EFIAPI
+XmlTreeSerialize (
+  IN XML_TREE  *Tree,
+  IN CHAR8     *Encoding OPTIONAL,
+  IN UINTN      Indent,
+  IN XML_WRITE  Write,
+  IN VOID      *Context OPTIONAL
+) {
+  EFI_STATUS  Status;
+  XML_WRITER *Writer = NULL;
+  // Check parameters
+  if ((Tree == NULL) || (Write == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Create the serializer
+  Status = XmlWriterCreate(&Writer, Encoding, Indent, Write, Context);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  // Write the tree node
+  XmlWriterTree(Writer, Tree, 0);
+  return XmlWriterFinish(Writer);
+}
+// XmlDocumentSerializeToBuffer
+/// Serialize an XML document to memory
+/// @param Document The XML document
+/// @param Encoding The output encoding or NULL for the document encoding
+/// @param Indent   The count of spaces to indent each level or zero for no formatting
+/// @param Size     On output, the size, in bytes, of the serialized document
+/// @param Buffer   On output, the serialized document, which must be freed
+/// @return Whether the XML document was serialized or not
+/// @retval EFI_INVALID_PARAMETER If Document, Size, or Buffer is NULL or *Buffer is not NULL
+/// @retval EFI_UNSUPPORTED       If the encoding is not supported
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the XML document was serialized successfully
+EFI_STATUS
+EFIAPI
+XmlDocumentSerializeToBuffer (
+  IN  XML_DOCUMENT  *Document,
+  IN  CHAR8         *Encoding OPTIONAL,
+  IN  UINTN          Indent,
+  OUT UINTN         *Size,
+  OUT VOID         **Buffer
+) {
+  EFI_STATUS        Status;
+  XML_WRITER_MEMORY Memory = { 0, 0, NULL };
+  // Check parameters
+  if ((Document == NULL) || (Size == NULL) || (Buffer == NULL) || (*Buffer != NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Serialize to memory
+  Status = XmlDocumentSerialize(Document, Encoding, Indent, XmlWriteMemory, &Memory);
+  if (EFI_ERROR(Status)) {
+    if (Memory.Buffer != NULL) {
+      FreePool(Memory.Buffer);
+    }
+    return Status;
+  }
+  // Return the serialized document
+  *Size = Memory.Size;
+  *Buffer = Memory.Buffer;
+  return EFI_SUCCESS;
+}
+// XmlDocumentSerializeToFile
+/// Serialize an XML document to a file with buffered writes
+/// @param Document The XML document
+/// @param Encoding The output encoding or NULL for the document encoding
+/// @param Indent   The count of spaces to indent each level or zero for no formatting
+/// @param Handle   The file handle opened for writing at the position to write
+/// @return Whether the XML document was serialized or not
+/// @retval EFI_INVALID_PARAMETER If Document or Handle is NULL
+/// @retval EFI_UNSUPPORTED       If the encoding is not supported
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_VOLUME_FULL       If the file could not be completely written
+/// @retval EFI_SUCCESS           If the XML document was serialized successfully
+EFI_STATUS
+EFIAPI
+XmlDocumentSerializeToFile (
+  IN XML_DOCUMENT    *Document,
+  IN CHAR8           *Encoding OPTIONAL,
+  IN UINTN            Indent,
+  IN EFI_FILE_HANDLE  Handle
+) {
+  // Check parameters
+  if ((Document == NULL) || (Handle == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  return XmlDocumentSerialize(Document, Encoding, Indent, XmlWriteFile, (VOID *)Handle);
+}
@@ -16,15 +16,14 @@ DECL_LANG_STATES(mXmlStates)
     DECL_LANG_RULE(LANG_RULE_SKIP, XML_LANG_STATE_SIGNATURE, 4, L" ", L"\t", L"\r", L"\n"),
   END_LANG_STATE(),
   // XML_LANG_STATE_TAG
-  DECL_LANG_STATE(XML_LANG_STATE_TAG, 8)
+  DECL_LANG_STATE(XML_LANG_STATE_TAG, 7)
     DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP, XML_LANG_STATE_TAG_NAME, 1, L"<"),
     DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP, XML_LANG_STATE_CLOSE_TAG, 1, L"</"),
-    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP, XML_LANG_STATE_DOCUMENT_TAG, 1, L"<!"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_PUSH, XML_LANG_STATE_DOCUMENT_TAG, 1, L"<!"),
     DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_PUSH, XML_LANG_STATE_COMMENT, 1, L"<!--"),
     DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_PUSH, XML_LANG_STATE_ENTITY, 1, L"&"),
-    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP, XML_LANG_STATE_TAG, 2, L"\t", L"\r"),
-    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP_EMPTY, XML_LANG_STATE_TAG, 1, L" "),
-    DECL_LANG_RULE(LANG_RULE_TOKEN, XML_LANG_STATE_TAG, 1, L"\n"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP, XML_LANG_STATE_TAG, 1, L"\r"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN, XML_LANG_STATE_TAG, 3, L" ", L"\t", L"\n"),
   END_LANG_STATE(),
   // XML_LANG_STATE_TAG_NAME
   DECL_LANG_STATE(XML_LANG_STATE_TAG_NAME, 4)
@@ -59,8 +58,8 @@ DECL_LANG_STATES(mXmlStates)
   END_LANG_STATE(),
   // XML_LANG_STATE_ENTITY
   DECL_LANG_STATE(XML_LANG_STATE_ENTITY, 2)
-    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP, LANG_STATE_PREVIOUS, 4, L";", L" ", L"\t", L"\r"),
-    DECL_LANG_RULE(LANG_RULE_TOKEN, LANG_STATE_PREVIOUS, 1, L"\n"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP, LANG_STATE_PREVIOUS, 1, L";"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN, LANG_STATE_PREVIOUS, 4, L" ", L"\t", L"\r", L"\n"),
   END_LANG_STATE(),
   // XML_LANG_STATE_QUOTE
   DECL_LANG_STATE(XML_LANG_STATE_QUOTE, 2)
@@ -78,166 +77,399 @@ DECL_LANG_STATES(mXmlStates)
   END_LANG_STATE(),
   // XML_LANG_STATE_DOCUMENT_TAG
   DECL_LANG_STATE(XML_LANG_STATE_DOCUMENT_TAG, 5)
-    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, XML_LANG_STATE_TAG, 1, L">"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, LANG_STATE_PREVIOUS, 1, L">"),
     DECL_LANG_RULE(LANG_RULE_INSENSITIVE, XML_LANG_STATE_DOCUMENT_TYPE, 1, L"DOCTYPE"),
     DECL_LANG_RULE(LANG_RULE_INSENSITIVE, XML_LANG_STATE_DOCUMENT_ENTITY, 1, L"ENTITY"),
     DECL_LANG_RULE(LANG_RULE_INSENSITIVE, XML_LANG_STATE_DOCUMENT_ELEMENT, 1, L"ELEMENT"),
     DECL_LANG_RULE(LANG_RULE_INSENSITIVE, XML_LANG_STATE_DOCUMENT_ATTLIST, 1, L"ATTLIST"),
   END_LANG_STATE(),
   // XML_LANG_STATE_DOCUMENT_TYPE
-  DECL_LANG_STATE(XML_LANG_STATE_DOCUMENT_TYPE, 1)
-    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, XML_LANG_STATE_TAG, 1, L">"),
+  DECL_LANG_STATE(XML_LANG_STATE_DOCUMENT_TYPE, 2)
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, LANG_STATE_PREVIOUS, 1, L">"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, XML_LANG_STATE_DOCUMENT_SUBSET, 1, L"["),
   END_LANG_STATE(),
   // XML_LANG_STATE_DOCUMENT_ENTITY
-  DECL_LANG_STATE(XML_LANG_STATE_DOCUMENT_ENTITY, 1)
-    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, XML_LANG_STATE_TAG, 1, L">"),
+  DECL_LANG_STATE(XML_LANG_STATE_DOCUMENT_ENTITY, 4)
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, LANG_STATE_PREVIOUS, 1, L">"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP, XML_LANG_STATE_DOCUMENT_ENTITY, 4, L" ", L"\t", L"\r", L"\n"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_PUSH, XML_LANG_STATE_ENTITY_QUOTE, 1, L"\'"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_PUSH, XML_LANG_STATE_ENTITY_DOUBLE_QUOTE, 1, L"\""),
   END_LANG_STATE(),
   // XML_LANG_STATE_DOCUMENT_ELEMENT
-  DECL_LANG_STATE(XML_LANG_STATE_DOCUMENT_TYPE, 1)
-    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, XML_LANG_STATE_TAG, 1, L">"),
+  DECL_LANG_STATE(XML_LANG_STATE_DOCUMENT_ELEMENT, 1)
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, LANG_STATE_PREVIOUS, 1, L">"),
   END_LANG_STATE(),
   // XML_LANG_STATE_DOCUMENT_ATTLIST
   DECL_LANG_STATE(XML_LANG_STATE_DOCUMENT_ATTLIST, 1)
-    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, XML_LANG_STATE_DOCUMENT_ATTLIST, 1, L">"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, LANG_STATE_PREVIOUS, 1, L">"),
+  END_LANG_STATE(),
+  // XML_LANG_STATE_DOCUMENT_SUBSET
+  DECL_LANG_STATE(XML_LANG_STATE_DOCUMENT_SUBSET, 3)
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN, XML_LANG_STATE_DOCUMENT_TYPE, 1, L"]"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN | LANG_RULE_PUSH, XML_LANG_STATE_DOCUMENT_TAG, 1, L"<!"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP | LANG_RULE_SKIP_TOKEN | LANG_RULE_PUSH, XML_LANG_STATE_COMMENT, 1, L"<!--"),
+  END_LANG_STATE(),
+  // XML_LANG_STATE_ENTITY_QUOTE
+  DECL_LANG_STATE(XML_LANG_STATE_ENTITY_QUOTE, 1)
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP, LANG_STATE_PREVIOUS, 1, L"\'"),
+  END_LANG_STATE(),
+  // XML_LANG_STATE_ENTITY_DOUBLE_QUOTE
+  DECL_LANG_STATE(XML_LANG_STATE_ENTITY_DOUBLE_QUOTE, 1)
+    DECL_LANG_RULE(LANG_RULE_TOKEN | LANG_RULE_SKIP, LANG_STATE_PREVIOUS, 1, L"\""),
   END_LANG_STATE(),
 END_LANG_STATES();
 
 // XmlTreeCreate
 /// Create XML document tree node
-/// @param Tree On output, the created tree node, which needs freed with XmlTreeFree
-/// @param Name The name of the tree node
+/// @param Arena The XML arena from which to allocate the tree node
+/// @param Tree  On output, the created tree node, which is released with the arena
+/// @param Name  The name of the tree node
 /// @return Whether the XML document tree node was created or not
-/// @retval EFI_INVALID_PARAMETER If Tree or Name is NULL
+/// @retval EFI_INVALID_PARAMETER If Arena, Tree, or Name is NULL
 /// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
 /// @retval EFI_SUCCESS           If the XML document tree node was created successfully
 STATIC EFI_STATUS
 EFIAPI
 XmlTreeCreate (
-  OUT XML_TREE **Tree,
-  IN  CHAR16    *Name
+  IN OUT XML_ARENA  *Arena,
+  OUT    XML_TREE  **Tree,
+  IN     CHAR16     *Name
 ) {
   XML_TREE *Ptr;
   // Check parameters
-  if ((Tree == NULL) || (Name == NULL) || (*Name == '\0')) {
+  if ((Arena == NULL) || (Tree == NULL) || (Name == NULL) || (*Name == '\0')) {
     return EFI_INVALID_PARAMETER;
   }
-  // Allocate tree node
-  Ptr = (XML_TREE *)AllocateZeroPool(sizeof(XML_TREE));
+  // Allocate tree node, the other members are zeroed by the arena
+  Ptr = (XML_TREE *)XmlArenaAllocate(Arena, sizeof(XML_TREE));
   if (Ptr == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
+  Ptr->Arena = Arena;
   // Set name
-  Ptr->Name = StrDup(Name);
+  Ptr->Name = XmlArenaStrDup(Arena, Name);
   if (Ptr->Name == NULL) {
-    FreePool(Ptr);
     return EFI_OUT_OF_RESOURCES;
   }
-  // Set other members to NULL
-  Ptr->Next = NULL;
-  Ptr->Value = NULL;
-  Ptr->Children = NULL;
-  Ptr->Attributes = NULL;
   // Return created tree node
   *Tree = Ptr;
   return EFI_SUCCESS;
 }
-// XmlAttributeCreate
-/// Create XML document tree node attribute
-/// @param Attribute On output, the created tree node attribute, which needs freed with XmlAttributeFree
-/// @param Name      The name of the tree node attribute
-/// @return Whether the XML document tree node attribute was created or not
-/// @retval EFI_INVALID_PARAMETER If Attribute or Name is NULL
-/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
-/// @retval EFI_SUCCESS           If the XML document tree node attribute was created successfully
+// XmlTreeAppendValue
+/// Append to XML document tree node value
+/// @param Tree   The XML document tree node
+/// @param Value  The value to append
+/// @param Length The length of the value to append in characters
+/// @return Whether the value was appended or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the value was appended successfully
 STATIC EFI_STATUS
 EFIAPI
-XmlAttributeCreate (
-  OUT XML_LIST **Attribute,
-  IN  CHAR16    *Name
+XmlTreeAppendValue (
+  IN OUT XML_TREE *Tree,
+  IN     CHAR16   *Value,
+  IN     UINTN     Length
 ) {
-  XML_LIST *Ptr;
-  // Check parameters
-  if ((Attribute == NULL) || (Name == NULL) || (*Name == '\0')) {
-    return EFI_INVALID_PARAMETER;
-  }
-  // Allocate tree node attribute
-  Ptr = (XML_LIST *)AllocateZeroPool(sizeof(XML_LIST));
+  CHAR16 *Ptr;
+  // Grow the value, which happens in place while the value is the last arena allocation
+  Ptr = (CHAR16 *)XmlArenaReallocate(Tree->Arena, Tree->Value, (Tree->Value == NULL) ? 0 : ((Tree->ValueLength + 1) * sizeof(CHAR16)),
+                                     (Tree->ValueLength + Length + 1) * sizeof(CHAR16));
   if (Ptr == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
-  // Set name
-  Ptr->Attribute.Name = StrDup(Name);
-  if (Ptr->Attribute.Name == NULL) {
-    FreePool(Ptr);
-    return EFI_OUT_OF_RESOURCES;
+  // Append the value
+  CopyMem(Ptr + Tree->ValueLength, Value, Length * sizeof(CHAR16));
+  Tree->ValueLength += Length;
+  Ptr[Tree->ValueLength] = L'\0';
+  Tree->Value = Ptr;
+  return EFI_SUCCESS;
+}
+
+// XmlStackPush
+/// Push an XML document tree node onto the tree stack
+/// @param XmlParser The XML parser
+/// @param Tree      The XML document tree node
+/// @return Whether the tree node was pushed or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the tree node was pushed successfully
+STATIC EFI_STATUS
+EFIAPI
+XmlStackPush (
+  IN OUT XML_PARSER *XmlParser,
+  IN     XML_TREE   *Tree
+) {
+  XML_STACK *Stack;
+  // Reuse a stack object if possible
+  Stack = XmlParser->Unused;
+  if (Stack != NULL) {
+    XmlParser->Unused = Stack->Previous;
+  } else {
+    Stack = (XML_STACK *)XmlArenaAllocate(&(XmlParser->Arena), sizeof(XML_STACK));
+    if (Stack == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
   }
-  // Set other members to NULL
-  Ptr->Attribute.Value = NULL;
-  Ptr->Next = NULL;
-  // Return created tree node attribute
-  *Attribute = Ptr;
+  // Set the stack object
+  Stack->Previous = XmlParser->Stack;
+  Stack->Tree = Tree;
+  XmlParser->Stack = Stack;
   return EFI_SUCCESS;
 }
-// XmlAttributeFree
-/// Free XML document tree node attribute
-/// @param Attribute The tree node attribute to free
-/// @return Whether the XML document tree node attribute was freed or not
-/// @retval EFI_INVALID_PARAMETER If Attribute is NULL
-/// @retval EFI_SUCCESS           If the XML document tree node attribute was freed successfully
+// XmlStackPop
+/// Pop an XML document tree node from the tree stack
+/// @param XmlParser The XML parser
+/// @return Whether the tree node was popped or not
+/// @retval EFI_NOT_READY If the tree stack is empty
+/// @retval EFI_SUCCESS   If the tree node was popped successfully
 STATIC EFI_STATUS
 EFIAPI
-XmlAttributeFree (
-  IN XML_LIST *Attribute
+XmlStackPop (
+  IN OUT XML_PARSER *XmlParser
 ) {
-  // Check parameters
-  if (Attribute == NULL) {
-    return EFI_INVALID_PARAMETER;
+  XML_STACK *Stack = XmlParser->Stack;
+  if (Stack == NULL) {
+    return EFI_NOT_READY;
   }
-  if (Attribute->Attribute.Name != NULL) {
-    FreePool(Attribute->Attribute.Name);
-    Attribute->Attribute.Name = NULL;
+  // Keep the stack object for reuse
+  XmlParser->Stack = Stack->Previous;
+  Stack->Previous = XmlParser->Unused;
+  Stack->Tree = NULL;
+  XmlParser->Unused = Stack;
+  return EFI_SUCCESS;
+}
+
+// XmlDeclareEncoding
+/// Change the encoding of the document to the declared encoding, which only happens if
+///  the detected encoding is not unicode since the declaration could not be read otherwise
+/// @param Parser    The language parser
+/// @param XmlParser The XML parser
+/// @param Declared  The declared encoding
+/// @return Whether the declared encoding was valid or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the declared encoding was valid or ignored
+STATIC EFI_STATUS
+EFIAPI
+XmlDeclareEncoding (
+  IN OUT LANG_PARSER *Parser,
+  IN OUT XML_PARSER  *XmlParser,
+  IN     CHAR16      *Declared
+) {
+  EFI_STATUS  Status;
+  CHAR8      *Encoding;
+  CHAR8      *Current = NULL;
+  // Convert the declared encoding
+  Encoding = ToAscii(Declared);
+  if (Encoding == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // Get the current encoding
+  Status = ParseGetEncoding(Parser, &Current);
+  if (!EFI_ERROR(Status) && (Current != NULL) && (AsciiStrniCmp(Current, "UTF-16", 6) == 0)) {
+    // The byte order of unicode was already detected
+    if (AsciiStrniCmp(Encoding, "UTF-16", 6) != 0) {
+      ParseWarn(Parser, L"Declared encoding \"%s\" does not match detected encoding", Declared);
+    }
+    FreePool(Encoding);
+    return EFI_SUCCESS;
+  }
+  if (AsciiStrniCmp(Encoding, "UTF-16", 6) == 0) {
+    ParseWarn(Parser, L"Declared encoding \"%s\" does not match detected encoding", Declared);
+    FreePool(Encoding);
+    return EFI_SUCCESS;
   }
-  if (Attribute->Attribute.Value != NULL) {
-    FreePool(Attribute->Attribute.Value);
-    Attribute->Attribute.Value = NULL;
+  // Switch the decoder for the rest of the document
+  Status = ParseSetEncoding(Parser, Encoding);
+  if (EFI_ERROR(Status)) {
+    ParseWarn(Parser, L"Unsupported encoding \"%s\"", Declared);
+    FreePool(Encoding);
+    return EFI_SUCCESS;
   }
-  FreePool(Attribute);
+  // Set the document encoding
+  Status = XmlDocumentSetEncoding(XmlParser->Document, Encoding);
+  FreePool(Encoding);
+  return Status;
+}
+
+// XmlCurrentAttribute
+/// Get the current attribute, which is the last attribute of the current tree node or document
+/// @param XmlParser The XML parser
+/// @param Attribute On output, the current attribute
+/// @return Whether the current attribute was found or not
+/// @retval EFI_NOT_READY If there is no current attribute
+/// @retval EFI_SUCCESS   If the current attribute was found successfully
+STATIC EFI_STATUS
+EFIAPI
+XmlCurrentAttribute (
+  IN  XML_PARSER     *XmlParser,
+  OUT XML_ATTRIBUTE **Attribute
+) {
+  XML_ATTRIBUTES *Attributes;
+  XML_STACK      *Stack = XmlParser->Stack;
+  // Check if document attribute
+  if (Stack == NULL) {
+    if (XmlParser->Document->Tree != NULL) {
+      return EFI_NOT_READY;
+    }
+    Attributes = &(XmlParser->Document->Attributes);
+  } else if (Stack->Tree == NULL) {
+    return EFI_NOT_READY;
+  } else {
+    Attributes = &(Stack->Tree->Attributes);
+  }
+  // The current attribute is the last attribute
+  if (Attributes->Count == 0) {
+    return EFI_NOT_READY;
+  }
+  *Attribute = &(Attributes->List[Attributes->Count - 1]);
   return EFI_SUCCESS;
 }
-// XmlTreeFree
-/// Free XML document tree node
-/// @param Attribute The tree node to free
-/// @return Whether the XML document tree node was freed or not
-/// @retval EFI_INVALID_PARAMETER If Tree is NULL
-/// @retval EFI_SUCCESS           If the XML document tree node was freed successfully
+// XmlAppendText
+/// Append text to the value of the current tree node or attribute
+/// @param XmlParser The XML parser
+/// @param StateId   The language parser state identifier in which the text was parsed
+/// @param Text      The text to append
+/// @param Length    The length of the text in characters
+/// @return Whether the text was appended or not
+/// @retval EFI_NOT_FOUND        If there is no tree node to which to append
+/// @retval EFI_NOT_READY        If text is not allowed in the state or there is no attribute to which to append
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the text was appended successfully
 STATIC EFI_STATUS
 EFIAPI
-XmlTreeFree (
-  IN XML_TREE *Tree
+XmlAppendText (
+  IN OUT XML_PARSER *XmlParser,
+  IN     UINTN       StateId,
+  IN     CHAR16     *Text,
+  IN     UINTN       Length
 ) {
-  // Check parameters
-  if (Tree == NULL) {
-    return EFI_INVALID_PARAMETER;
+  EFI_STATUS     Status;
+  XML_STACK     *Stack;
+  XML_ATTRIBUTE *Attribute = NULL;
+  CHAR16        *Ptr;
+  UINTN          ValueLength;
+  if (Length == 0) {
+    return EFI_SUCCESS;
+  }
+  switch (StateId) {
+    case XML_LANG_STATE_TAG:
+      // Append to the current value
+      Stack = XmlParser->Stack;
+      if ((Stack == NULL) || (Stack->Tree == NULL)) {
+        return EFI_NOT_FOUND;
+      }
+      return XmlTreeAppendValue(Stack->Tree, Text, Length);
+
+    case XML_LANG_STATE_ATTRIBUTE_VALUE:
+    case XML_LANG_STATE_QUOTE:
+    case XML_LANG_STATE_DOUBLE_QUOTE:
+      // Append to the current attribute value
+      Status = XmlCurrentAttribute(XmlParser, &Attribute);
+      if (EFI_ERROR(Status)) {
+        return Status;
+      }
+      // Grow the value, which happens in place while the value is the last arena allocation
+      ValueLength = (Attribute->Value == NULL) ? 0 : XmlParser->AttributeLength;
+      Ptr = (CHAR16 *)XmlArenaReallocate(&(XmlParser->Arena), Attribute->Value, (Attribute->Value == NULL) ? 0 : ((ValueLength + 1) * sizeof(CHAR16)),
+                                         (ValueLength + Length + 1) * sizeof(CHAR16));
+      if (Ptr == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      CopyMem(Ptr + ValueLength, Text, Length * sizeof(CHAR16));
+      Ptr[ValueLength + Length] = L'\0';
+      Attribute->Value = Ptr;
+      XmlParser->AttributeLength = ValueLength + Length;
+      break;
+
+    default:
+      return EFI_NOT_READY;
   }
-  if (Tree->Name != NULL) {
-    FreePool(Tree->Name);
-    Tree->Name = NULL;
+  return EFI_SUCCESS;
+}
+// XmlAppendSpace
+/// Append whitespace to the value of the current tree node or attribute, whitespace in a
+///  tree node value is collapsed into a single space between words
+/// @param XmlParser The XML parser
+/// @param StateId   The language parser state identifier in which the whitespace was parsed
+/// @return Whether the whitespace was appended or not
+/// @retval EFI_NOT_READY        If whitespace is not allowed in the state or there is no attribute to which to append
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the whitespace was appended or ignored
+STATIC EFI_STATUS
+EFIAPI
+XmlAppendSpace (
+  IN OUT XML_PARSER *XmlParser,
+  IN     UINTN       StateId
+) {
+  XML_STACK *Stack;
+  if (StateId == XML_LANG_STATE_TAG) {
+    // Only append a space after a word
+    Stack = XmlParser->Stack;
+    if ((Stack == NULL) || (Stack->Tree == NULL) || (Stack->Tree->ValueLength == 0) ||
+        (Stack->Tree->Value[Stack->Tree->ValueLength - 1] == L' ')) {
+      return EFI_SUCCESS;
+    }
   }
-  if (Tree->Value != NULL) {
-    FreePool(Tree->Value);
-    Tree->Value = NULL;
+  return XmlAppendText(XmlParser, StateId, L" ", 1);
+}
+// XmlIsSpace
+/// Check if a token is a single whitespace character
+/// @param Token The token to check
+/// @retval TRUE  If the token is whitespace
+/// @retval FALSE If the token is not whitespace
+STATIC BOOLEAN
+EFIAPI
+XmlIsSpace (
+  IN CHAR16 *Token
+) {
+  return (((*Token == L' ') || (*Token == L'\t') || (*Token == L'\r') || (*Token == L'\n')) && (Token[1] == L'\0'));
+}
+
+// XmlDeclareEntity
+/// Declare an entity from the tokens of an entity declaration, parameter and external entities are ignored
+/// @param Parser    The language parser
+/// @param XmlParser The XML parser
+/// @param Token     The entity declaration token
+/// @return Whether the token was valid or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the token was valid or ignored
+STATIC EFI_STATUS
+EFIAPI
+XmlDeclareEntity (
+  IN OUT LANG_PARSER *Parser,
+  IN OUT XML_PARSER  *XmlParser,
+  IN     CHAR16      *Token
+) {
+  EFI_STATUS Status;
+  if (XmlParser->EntityIgnored) {
+    return EFI_SUCCESS;
   }
-  while (Tree->Attributes != NULL) {
-    XML_LIST *Attribute = Tree->Attributes;
-    Tree->Attributes = Attribute->Next;
-    XmlAttributeFree(Attribute);
+  // Check if this is the start of the entity value
+  if ((StrCmp(Token, L"\"") == 0) || (StrCmp(Token, L"\'") == 0)) {
+    // Only the first literal is the value
+    XmlParser->EntityIgnored = TRUE;
+    if (XmlParser->EntityName == NULL) {
+      return EFI_SUCCESS;
+    }
+    Status = XmlEntityDeclare(&(XmlParser->Arena), &(XmlParser->Entities), XmlParser->EntityName, &(XmlParser->Entity));
+    if (Status == EFI_ALREADY_STARTED) {
+      ParseWarn(Parser, L"Entity \"%s\" already declared", XmlParser->EntityName);
+      XmlParser->Entity = NULL;
+      return EFI_SUCCESS;
+    }
+    return Status;
   }
-  while (Tree->Children != NULL) {
-    XML_TREE *Child = Tree->Children;
-    Tree->Children = Child->Next;
-    XmlTreeFree(Child);
+  // Check if this is the entity name
+  if (XmlParser->EntityName == NULL) {
+    // Parameter entities are only used in the document type declaration
+    if (StrCmp(Token, L"%") == 0) {
+      XmlParser->EntityIgnored = TRUE;
+      return EFI_SUCCESS;
+    }
+    XmlParser->EntityName = XmlArenaStrDup(&(XmlParser->Arena), Token);
+    return (XmlParser->EntityName == NULL) ? EFI_OUT_OF_RESOURCES : EFI_SUCCESS;
   }
-  FreePool(Tree);
+  // External entities are not loaded
+  XmlParser->EntityIgnored = TRUE;
   return EFI_SUCCESS;
 }
 
@@ -255,13 +487,17 @@ XmlCallback (
   IN     CHAR16      *Token,
   IN     VOID        *Context
 ) {
-  EFI_STATUS  Status;
-  XML_STACK  *Stack;
-  XML_LIST   *List;
-  XML_TREE   *Tree;
-  XML_PARSER *XmlParser = (XML_PARSER *)Context;
-  UINTN       PreviousId = LANG_STATE_PREVIOUS;
-  UINTN       TokenLength;
+  EFI_STATUS      Status;
+  XML_STACK      *Stack;
+  XML_TREE       *Tree;
+  XML_ATTRIBUTES *Attributes;
+  XML_ATTRIBUTE  *Attribute;
+  CHAR16         *Value;
+  CHAR16          Buffer[XML_ENTITY_CHARACTER_SIZE];
+  XML_PARSER     *XmlParser = (XML_PARSER *)Context;
+  UINTN           PreviousId = LANG_STATE_PREVIOUS;
+  UINTN           ValueLength;
+  UINTN           TokenLength;
   if (XmlParser == NULL) {
     return EFI_INVALID_PARAMETER;
   }
@@ -274,214 +510,113 @@ XmlCallback (
   }
   switch (StateId) {
     case XML_LANG_STATE_TAG:
-      // Value
-      Stack = XmlParser->Stack;
-      // Check if this is a newline to insert a special space
-      if (StrCmp(Token, L"\n") == 0) {
-        if ((Stack != NULL) && (Stack->Tree != NULL) && (Stack->Tree->Value != NULL)) {
-          // Get the length of the current value
-          UINTN Length;
-          Length = StrLen(Stack->Tree->Value);
-          if (Length > 0) {
-            // Append a space
-            CHAR16 *Value = (CHAR16 *)AllocateZeroPool((++Length + 1) * sizeof(CHAR16));
-            if (Value == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
-            StrCpyS(Value, Length + 1, Stack->Tree->Value);
-            Value[Length - 1] = L' ';
-            Value[Length] = L'\0';
-            FreePool(Stack->Tree->Value);
-            Stack->Tree->Value = Value;
-          }
-        }
-      } else if ((Stack == NULL) || (Stack->Tree == NULL)) {
-        return EFI_NOT_FOUND;
-      } else {
-        // Append to the current value
-        if (Stack->Tree->Value != NULL) {
-          // Get the length of the current value
-          UINTN Length = StrLen(Stack->Tree->Value);
-          if (Length > 0) {
-            // Append the token
-            UINTN Size = (Length + 1) * sizeof(CHAR16);
-            Stack->Tree->Value = ReallocatePool(Size, Size + (TokenLength * sizeof(CHAR16)), Stack->Tree->Value);
-            if (Stack->Tree->Value == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
-            StrCpyS(Stack->Tree->Value + Length, TokenLength + 1, Token);
-            Stack->Tree->Value[Length + TokenLength + 1] = L'\0';
-          }
-        } else {
-          // Start a new value
-          Stack->Tree->Value = StrDup(Token);
-        }
+      // Value, whitespace is collapsed into a single space between words
+      if (XmlIsSpace(Token)) {
+        return XmlAppendSpace(XmlParser, StateId);
       }
-      break;
+      return XmlAppendText(XmlParser, StateId, Token, TokenLength);
 
     case XML_LANG_STATE_TAG_NAME:
       // Check if this is an immediate close tag
       if (StrCmp(Token, L"/>") == 0) {
-        if (XmlParser->Stack == NULL) {
+        return XmlStackPop(XmlParser);
+      }
+      // Check there is a node for the new tag
+      Stack = XmlParser->Stack;
+      if (Stack == NULL) {
+        // Check there is no document element
+        if (XmlParser->Document->Tree != NULL) {
           return EFI_NOT_READY;
         }
-        Stack = XmlParser->Stack;
-        XmlParser->Stack = Stack->Previous;
-        FreePool(Stack);
+      } else if (Stack->Tree == NULL) {
+        return EFI_NOT_READY;
+      }
+      // Create new tree node
+      Tree = NULL;
+      Status = XmlTreeCreate(&(XmlParser->Arena), &Tree, Token);
+      if (EFI_ERROR(Status)) {
+        return Status;
+      }
+      if (Stack == NULL) {
+        // Set the root node
+        XmlParser->Document->Tree = Tree;
       } else {
-        // New tag name
-        Tree = NULL;
-        // Create new tree node
-        Status = XmlTreeCreate(&Tree, Token);
-        if (EFI_ERROR(Status)) {
-          return Status;
-        }
-        // Allocate a new stack object
-        Stack = (XML_STACK *)AllocateZeroPool(sizeof(XML_STACK));
-        if (Stack == NULL) {
-          XmlTreeFree(Tree);
-          return EFI_OUT_OF_RESOURCES;
-        }
-        // Check if there is already a stack
-        if (XmlParser->Stack == NULL) {
-          // Check there is no document element
-          if (XmlParser->Document->Tree != NULL) {
-            XmlTreeFree(Tree);
-            FreePool(Stack);
-            return EFI_NOT_READY;
-          }
-          // Set the root node
-          XmlParser->Document->Tree = Tree;
-          // Set the stack object
-          Stack->Previous = NULL;
-          Stack->Tree = Tree;
-          XmlParser->Stack = Stack;
-        } else if (XmlParser->Stack->Tree == NULL) {
-          XmlTreeFree(Tree);
-          FreePool(Stack);
-          return EFI_NOT_READY;
-        } else if (XmlParser->Stack->Tree->Children == NULL) {
-          // Set tree as first child
-          XmlParser->Stack->Tree->Children = Tree;
+        // Add to end of children
+        if (Stack->Tree->LastChild == NULL) {
+          Stack->Tree->Children = Tree;
         } else {
-          // Add to end of children
-          XML_TREE *Child = XmlParser->Stack->Tree->Children;
-          while (Child->Next != NULL) {
-            Child = Child->Next;
-          }
-          Child->Next = Tree;
+          Stack->Tree->LastChild->Next = Tree;
         }
-        // Set the stack object
-        Stack->Previous = XmlParser->Stack;
-        Stack->Tree = Tree;
-        XmlParser->Stack = Stack;
+        Stack->Tree->LastChild = Tree;
+        Stack->Tree->ChildList = NULL;
+        ++(Stack->Tree->ChildCount);
       }
-      break;
+      // Push the new tree node
+      return XmlStackPush(XmlParser, Tree);
 
     case XML_LANG_STATE_ATTRIBUTE:
       // Check if this is an immdiate close tag
       if (StrCmp(Token, L"/>") == 0) {
-        if (XmlParser->Stack == NULL) {
+        return XmlStackPop(XmlParser);
+      }
+      // New tag attribute
+      Stack = XmlParser->Stack;
+      // Check if document attribute
+      if (Stack == NULL) {
+        if (XmlParser->Document->Tree != NULL) {
           return EFI_NOT_READY;
         }
-        Stack = XmlParser->Stack;
-        XmlParser->Stack = Stack->Previous;
-        FreePool(Stack);
+        Attributes = &(XmlParser->Document->Attributes);
+      } else if (Stack->Tree == NULL) {
+        // No node to add attribute
+        return EFI_NOT_READY;
       } else {
-        // New tag attribute
-        Stack = XmlParser->Stack;
-        // Create attribute
-        List = NULL;
-        Status = XmlAttributeCreate(&List, Token);
-        if (EFI_ERROR(Status)) {
-          return Status;
-        }
-        // Check if document attribute
-        if (Stack == NULL) {
-          if (XmlParser->Document->Tree != NULL) {
-            return EFI_NOT_READY;
-          }
-          // Add attribute to document
-          if (XmlParser->Document->Attributes == NULL) {
-            XmlParser->Document->Attributes = List;
-          } else {
-            XML_LIST *Attr = XmlParser->Document->Attributes;
-            while (Attr->Next != NULL) {
-              Attr = Attr->Next;
-            }
-            Attr->Next = List;
-          }
-        } else if (Stack->Tree == NULL) {
-          // No node to add attribute
-          return EFI_NOT_READY;
-        } else {
-          // Add attribute to tree node
-          if (Stack->Tree->Attributes == NULL) {
-            Stack->Tree->Attributes = List;
-          } else {
-            XML_LIST *Attr = Stack->Tree->Attributes;
-            while (Attr->Next != NULL) {
-              Attr = Attr->Next;
-            }
-            Attr->Next = List;
-          }
-        }
+        Attributes = &(Stack->Tree->Attributes);
       }
-      break;
+      // Add the attribute, which starts without a value
+      XmlParser->AttributeLength = 0;
+      return XmlAttributesAdd(&(XmlParser->Arena), Attributes, Token, &Attribute);
 
     case XML_LANG_STATE_ATTRIBUTE_VALUE:
       // Check if this is an immdiate close tag
       if (StrCmp(Token, L"/>") == 0) {
-        if (XmlParser->Stack == NULL) {
-          return EFI_NOT_READY;
-        }
-        Stack = XmlParser->Stack;
-        XmlParser->Stack = Stack->Previous;
-        FreePool(Stack);
-      } else {
-        // Tag attribute value
-        Stack = XmlParser->Stack;
-        // Check if document attribute
-        if (Stack == NULL) {
-          if ((XmlParser->Document->Tree != NULL) || (XmlParser->Document->Attributes == NULL)) {
-            return EFI_NOT_READY;
-          }
-          // Find the current document attribute
-          List = XmlParser->Document->Attributes;
-          while (List->Next != NULL) {
-            List = List->Next;
-          }
-        } else if ((Stack->Tree == NULL) || (Stack->Tree->Attributes == NULL)) {
-          return EFI_NOT_READY;
-        } else {
-          // Find the current attribute
-          List = Stack->Tree->Attributes;
-          while (List->Next != NULL) {
-            List = List->Next;
-          }
-        }
-        // Check to make sure there's not somehow already a value
-        if (List->Attribute.Value != NULL) {
-          return EFI_NOT_FOUND;
-        }
-        // Set the attribute value
-        List->Attribute.Value = StrDup(Token);
+        return XmlStackPop(XmlParser);
+      }
+      // Tag attribute value
+      Status = XmlCurrentAttribute(XmlParser, &Attribute);
+      if (EFI_ERROR(Status)) {
+        return Status;
+      }
+      Status = XmlAppendText(XmlParser, StateId, Token, TokenLength);
+      if (EFI_ERROR(Status)) {
+        return Status;
+      }
+      // Check if this is the document encoding declaration
+      if ((XmlParser->Stack == NULL) && (StriCmp(Attribute->Name, L"encoding") == 0)) {
+        return XmlDeclareEncoding(Parser, XmlParser, Attribute->Value);
       }
       break;
 
+    case XML_LANG_STATE_QUOTE:
+    case XML_LANG_STATE_DOUBLE_QUOTE:
+      // Tag attribute value before an entity
+      return XmlAppendText(XmlParser, StateId, Token, TokenLength);
+
     case XML_LANG_STATE_CLOSE_TAG:
       // Close tag name
       Stack = XmlParser->Stack;
-      if ((Stack == NULL) || (Stack->Tree == NULL) || (Stack->Tree->Name == NULL) ||
-          (StrCmp(Stack->Tree->Name, Token) != 0)) {
+      if ((Stack == NULL) || (Stack->Tree == NULL) || (Stack->Tree->Name == NULL)) {
+        // Error: there is no open tag
+        ParseError(Parser, L"Unexpected </%s>", Token);
+        return EFI_NOT_FOUND;
+      }
+      if (StrCmp(Stack->Tree->Name, Token) != 0) {
         // Error: expected a different tag closed first
-        Status = ParseError(Parser, L"Expected </%s> before </%s>", Stack->Tree->Name, Token);
+        ParseError(Parser, L"Expected </%s> before </%s>", Stack->Tree->Name, Token);
         return EFI_NOT_FOUND;
       }
-      // Free stack object
-      XmlParser->Stack = Stack->Previous;
-      FreePool(Stack);
-      break;
+      // Pop the tree node
+      return XmlStackPop(XmlParser);
 
     case XML_LANG_STATE_ENTITY:
       // Entity name
@@ -489,85 +624,54 @@ XmlCallback (
       if (EFI_ERROR(Status)) {
         return Status;
       }
-      // Ampersand
-      if (StriCmp(Token, L"amp") == 0) {
-        return XmlCallback(Parser, PreviousId, L"&", Context);
-      }
-      // Single quote
-      if (StriCmp(Token, L"apos") == 0) {
-        return XmlCallback(Parser, PreviousId, L"\'", Context);
-      }
-      // Greater than
-      if (StriCmp(Token, L"gt") == 0) {
-        return XmlCallback(Parser, PreviousId, L">", Context);
+      // Whitespace ended the entity
+      if (XmlIsSpace(Token)) {
+        return XmlAppendSpace(XmlParser, PreviousId);
       }
-      // Less than
-      if (StriCmp(Token, L"lt") == 0) {
-        return XmlCallback(Parser, PreviousId, L"<", Context);
+      // Replace the entity in the previous state
+      Status = XmlEntityResolve(&(XmlParser->Entities), Token, TokenLength, Buffer, &Value, &ValueLength);
+      if (EFI_ERROR(Status)) {
+        ParseWarn(Parser, L"Unknown entity \"&%s;\"", Token);
+        break;
       }
-      // Space
-      if (StriCmp(Token, L"nbsp") == 0) {
-        return XmlCallback(Parser, PreviousId, L" ", Context);
+      // Limit the text added by declared entities
+      if (Value != Buffer) {
+        XmlParser->EntityExpansion += ValueLength;
+        if (XmlParser->EntityExpansion > XML_ENTITY_MAX_EXPANSION) {
+          ParseError(Parser, L"Entity expansion limit exceeded by \"&%s;\"", Token);
+          return EFI_OUT_OF_RESOURCES;
+        }
       }
-      // Double quote
-      if (StriCmp(Token, L"quot") == 0) {
-        return XmlCallback(Parser, PreviousId, L"\"", Context);
+      return XmlAppendText(XmlParser, PreviousId, Value, ValueLength);
+
+    case XML_LANG_STATE_DOCUMENT_TAG:
+      // Document tag keyword, the following state handles the declaration
+      if (StriCmp(Token, L"ENTITY") == 0) {
+        XmlParser->Entity = NULL;
+        XmlParser->EntityName = NULL;
+        XmlParser->EntityIgnored = FALSE;
       }
-      // Numeral representation of character
-      if (*Token == L'#') {
-        UINT32 Character = 0;
-        ++Token;
-        if ((*Token == L'x') || (*Token == L'X')) {
-          // Hexadecimal representation of character
-          ++Token;
-          while (*Token != '\0') {
-            if ((*Token >= L'0') && (*Token <= L'9')) {
-              Character <<= 4;
-              Character |= (UINT32)(*Token - L'0');
-            } else if ((*Token >= 'a') || (*Token <= 'f')) {
-              Character <<= 4;
-              Character |= (UINT32)((*Token - L'a') + 10);
-            } else if ((*Token >= 'A') || (*Token <= 'F')) {
-              Character <<= 4;
-              Character |= (UINT32)((*Token - L'A') + 10);
-            } else {
-              break;
-            }
-            ++Token;
-          }
-        } else {
-          //Decimal representation of character
-          while (*Token != '\0') {
-            if ((*Token >= L'0') && (*Token <= L'9')) {
-              Character *= 10;
-              Character |= (UINT32)(*Token - L'0');
-            } else {
-              break;
-            }
-            ++Token;
-          }
-        }
-        // Replace the character entity with the character
-        if (IsUnicodeCharacter(Character)) {
-          CHAR16 Str[3] = { L'\0', L'\0', L'\0' };
-          if (Character >= 0x10000) {
-            Str[0] = (CHAR16)(((Character >> 10) & 0x3FF) + 0xD800);
-            Str[1] = (CHAR16)((Character & 0x3FF) + 0xDC00);
-          } else {
-            Str[0] = (CHAR16)Character;
-          }
-          return XmlCallback(Parser, PreviousId, Str, Context);
-        }
-      } else {
-        // TODO: Replace entity from schema
+      break;
+
+    case XML_LANG_STATE_DOCUMENT_ENTITY:
+      // Entity declaration
+      return XmlDeclareEntity(Parser, XmlParser, Token);
 
+    case XML_LANG_STATE_ENTITY_QUOTE:
+    case XML_LANG_STATE_ENTITY_DOUBLE_QUOTE:
+      // Entity value
+      if (XmlParser->Entity != NULL) {
+        Status = XmlEntitySetValue(&(XmlParser->Arena), &(XmlParser->Entities), XmlParser->Entity, Token, &(XmlParser->EntityExpansion));
+        if (XmlParser->EntityExpansion > XML_ENTITY_MAX_EXPANSION) {
+          ParseError(Parser, L"Entity expansion limit exceeded by \"%s\"", XmlParser->EntityName);
+        }
+        XmlParser->Entity = NULL;
+        return Status;
       }
       break;
 
     case XML_LANG_STATE_DOCUMENT_TYPE:
       // TODO: Schema document type
-    case XML_LANG_STATE_DOCUMENT_ENTITY:
-      // TODO: Schema entity
     case XML_LANG_STATE_DOCUMENT_ELEMENT:
       // TODO: Schema element
     case XML_LANG_STATE_DOCUMENT_ATTLIST:
@@ -30,20 +30,124 @@ enum _XML_STATE {
   XML_LANG_STATE_DOCUMENT_ENTITY,
   XML_LANG_STATE_DOCUMENT_ELEMENT,
   XML_LANG_STATE_DOCUMENT_ATTLIST,
+  XML_LANG_STATE_DOCUMENT_SUBSET,
+  XML_LANG_STATE_ENTITY_QUOTE,
+  XML_LANG_STATE_ENTITY_DOUBLE_QUOTE,
 
 };
 
-// XML_LIST
-/// XML document tree node attribute list
-typedef struct _XML_LIST XML_LIST;
-struct _XML_LIST {
+// XML_ARENA_BLOCK_SIZE
+/// The size, in bytes, of each XML arena block
+#define XML_ARENA_BLOCK_SIZE 0x4000
+// XML_ARENA_ALIGNMENT
+/// The alignment, in bytes, of each XML arena allocation
+#define XML_ARENA_ALIGNMENT sizeof(UINT64)
+// XML_ATTRIBUTES_SIZE
+/// The initial count of attributes stored inline for a tree node
+#define XML_ATTRIBUTES_SIZE 4
+// XML_ATTRIBUTES_INDEX_COUNT
+/// The count of attributes above which a tree node attributes are indexed by a hash
+#define XML_ATTRIBUTES_INDEX_COUNT 8
+// XML_NAMES_SIZE
+/// The initial count of buckets for interned names, must be a power of two
+#define XML_NAMES_SIZE 64
+// XML_HASH_BASIS
+/// The offset basis of the name hash
+#define XML_HASH_BASIS 0x811C9DC5
+// XML_HASH_PRIME
+/// The prime of the name hash
+#define XML_HASH_PRIME 0x01000193
+// XML_WALK_STACK_SIZE
+/// The initial count of levels in the XML document tree walk stack
+#define XML_WALK_STACK_SIZE 16
+// XML_ENTITIES_SIZE
+/// The initial count of buckets for declared entities, must be a power of two
+#define XML_ENTITIES_SIZE 16
+// XML_ENTITY_CHARACTER_SIZE
+/// The count of characters needed to replace a character entity
+#define XML_ENTITY_CHARACTER_SIZE 2
+// XML_ENTITY_MAX_EXPANSION
+/// The maximum count of characters that declared entity references may add while parsing a document
+#define XML_ENTITY_MAX_EXPANSION 0x100000
+// XML_LEADING_SIZE
+/// The count of leading bytes buffered to detect the encoding, enough for any byte order mark and two UTF-16 characters
+#define XML_LEADING_SIZE 4
+
+// XML_ARENA_BLOCK
+/// XML arena block, the allocations follow the block header
+typedef struct _XML_ARENA_BLOCK XML_ARENA_BLOCK;
+struct _XML_ARENA_BLOCK {
+
+  // Next
+  /// The next block in the arena
+  XML_ARENA_BLOCK *Next;
+  // Size
+  /// The size, in bytes, available for allocations in this block
+  UINTN            Size;
+  // Used
+  /// The size, in bytes, used by allocations in this block
+  UINTN            Used;
+  // Last
+  /// The offset of the last allocation in this block
+  UINTN            Last;
+
+};
+// XML_NAME
+/// XML interned name
+typedef struct _XML_NAME XML_NAME;
+struct _XML_NAME {
 
   // Next
-  /// The next attribute in the list
-  XML_LIST      *Next;
-  // Attribute
-  /// The XML document tree node attribute
-  XML_ATTRIBUTE  Attribute;
+  /// The next name in the bucket
+  XML_NAME *Next;
+  // Hash
+  /// The hash of the name
+  UINT32    Hash;
+  // Name
+  /// The name
+  CHAR16   *Name;
+
+};
+// XML_ARENA
+/// XML arena from which the document is allocated and released wholesale
+typedef struct _XML_ARENA XML_ARENA;
+struct _XML_ARENA {
+
+  // Blocks
+  /// The arena blocks, the first block is the current block
+  XML_ARENA_BLOCK  *Blocks;
+  // Names
+  /// The buckets of interned names, which are unique within the arena
+  XML_NAME        **Names;
+  // NameCount
+  /// The count of interned names
+  UINTN             NameCount;
+  // NameSize
+  /// The count of buckets of interned names
+  UINTN             NameSize;
+
+};
+// XML_ATTRIBUTES
+/// XML document tree node attributes stored inline with interned names
+typedef struct _XML_ATTRIBUTES XML_ATTRIBUTES;
+struct _XML_ATTRIBUTES {
+
+  // Count
+  /// The count of attributes
+  UINTN          Count;
+  // Size
+  /// The count of attributes that fit in the list
+  UINTN          Size;
+  // List
+  /// The list of attributes
+  XML_ATTRIBUTE *List;
+  // IndexSize
+  /// The count of slots in the index
+  UINTN          IndexSize;
+  // Index
+  /// The open addressed slots of attribute list index plus one or zero for an empty slot,
+  ///  only built when there are more than XML_ATTRIBUTES_INDEX_COUNT attributes
+  UINTN         *Index;
 
 };
 // XML_STACK
@@ -58,6 +162,57 @@ struct _XML_STACK {
   /// The XML document tree node
   XML_TREE  *Tree;
 
+};
+// XML_ENTITY
+/// XML declared entity
+typedef struct _XML_ENTITY XML_ENTITY;
+struct _XML_ENTITY {
+
+  // Next
+  /// The next entity in the bucket
+  XML_ENTITY *Next;
+  // Hash
+  /// The hash of the entity name
+  UINT32      Hash;
+  // Name
+  /// The entity name
+  CHAR16     *Name;
+  // Value
+  /// The replacement text, which has no references
+  CHAR16     *Value;
+  // Length
+  /// The length of the replacement text in characters
+  UINTN       Length;
+
+};
+// XML_ENTITIES
+/// XML declared entities
+typedef struct _XML_ENTITIES XML_ENTITIES;
+struct _XML_ENTITIES {
+
+  // Count
+  /// The count of declared entities
+  UINTN        Count;
+  // Size
+  /// The count of buckets
+  UINTN        Size;
+  // Buckets
+  /// The buckets of declared entities
+  XML_ENTITY **Buckets;
+
+};
+// XML_WALK_LEVEL
+/// XML document tree walk stack level
+typedef struct _XML_WALK_LEVEL XML_WALK_LEVEL;
+struct _XML_WALK_LEVEL {
+
+  // Tree
+  /// The next XML document tree node to walk at this level
+  XML_TREE *Tree;
+  // Index
+  /// The index of the next tree node relative to the previous level
+  UINTN     Index;
+
 };
 
 // XML_TREE
@@ -65,20 +220,35 @@ struct _XML_STACK {
 struct _XML_TREE {
 
   // Next
-  /// The next tree node
-  XML_TREE *Next;
+  /// The next sibling tree node
+  XML_TREE        *Next;
   // Children
-  /// The child nodes
-  XML_TREE *Children;
+  /// The first child node
+  XML_TREE        *Children;
+  // LastChild
+  /// The last child node
+  XML_TREE        *LastChild;
+  // ChildList
+  /// The child nodes view, built when first requested
+  XML_TREE       **ChildList;
+  // ChildCount
+  /// The count of child nodes
+  UINTN            ChildCount;
+  // Arena
+  /// The arena from which the tree node was allocated
+  XML_ARENA       *Arena;
   // Name
   /// The tag name
-  CHAR16   *Name;
+  CHAR16          *Name;
   // Attributes
-  /// List of attributes
-  XML_LIST *Attributes;
+  /// The attributes
+  XML_ATTRIBUTES   Attributes;
   // Value
   /// Value
-  CHAR16   *Value;
+  CHAR16          *Value;
+  // ValueLength
+  /// The length of the value in characters
+  UINTN            ValueLength;
 
 };
 // XML_SCHEMA
@@ -96,19 +266,16 @@ struct _XML_DOCUMENT {
 
   // Schema
   /// XML document schema
-  XML_SCHEMA *Schema;
+  XML_SCHEMA     *Schema;
   // Attributes
   /// XML document attributes
-  XML_LIST   *Attributes;
+  XML_ATTRIBUTES  Attributes;
   // Tree
   /// XML document tree root node
-  XML_TREE   *Tree;
+  XML_TREE       *Tree;
   // Encoding
   /// XML document encoding
-  CHAR8      *Encoding;
-  // ByteSwap
-  /// The encoding bytes for unicode are swapped
-  BOOLEAN     ByteSwap;
+  CHAR8          *Encoding;
 
 };
 // XML_PARSER
@@ -124,7 +291,237 @@ struct _XML_PARSER {
   // Stack
   /// XML document tree stack
   XML_STACK    *Stack;
+  // Unused
+  /// XML document tree stack objects available for reuse
+  XML_STACK    *Unused;
+  // AttributeLength
+  /// The length in characters of the value of the current attribute, which is the only attribute value that grows
+  UINTN         AttributeLength;
+  // Arena
+  /// XML arena from which the document tree is allocated
+  XML_ARENA     Arena;
+  // Entities
+  /// XML declared entities
+  XML_ENTITIES  Entities;
+  // Entity
+  /// The declared entity waiting for its replacement text
+  XML_ENTITY   *Entity;
+  // EntityName
+  /// The name of the entity being declared
+  CHAR16       *EntityName;
+  // EntityExpansion
+  /// The count of characters added by declared entity references
+  UINTN         EntityExpansion;
+  // EntityIgnored
+  /// Whether the remainder of the entity declaration is ignored
+  BOOLEAN       EntityIgnored;
+  // Leading
+  /// The leading bytes buffered until there are enough to detect the encoding
+  UINT8         Leading[XML_LEADING_SIZE];
+  // LeadingSize
+  /// The size, in bytes, of the buffered leading bytes
+  UINTN         LeadingSize;
+  // Detected
+  /// Whether the encoding was detected from the leading bytes
+  BOOLEAN       Detected;
 
 };
 
+// XmlArenaAllocate
+/// Allocate zeroed memory from an XML arena
+/// @param Arena The XML arena
+/// @param Size  The size, in bytes, to allocate
+/// @return The allocated memory, which is released with the arena, or NULL if memory could not be allocated
+VOID *
+EFIAPI
+XmlArenaAllocate (
+  IN OUT XML_ARENA *Arena,
+  IN     UINTN      Size
+);
+// XmlArenaReallocate
+/// Reallocate memory from an XML arena, the memory grows in place if it was the last allocation
+/// @param Arena   The XML arena
+/// @param Buffer  The memory to reallocate
+/// @param OldSize The size, in bytes, of the memory to reallocate
+/// @param NewSize The size, in bytes, to reallocate
+/// @return The reallocated memory, which is released with the arena, or NULL if memory could not be allocated
+VOID *
+EFIAPI
+XmlArenaReallocate (
+  IN OUT XML_ARENA *Arena,
+  IN     VOID      *Buffer OPTIONAL,
+  IN     UINTN      OldSize,
+  IN     UINTN      NewSize
+);
+// XmlArenaStrDup
+/// Duplicate a string into an XML arena
+/// @param Arena  The XML arena
+/// @param String The string to duplicate
+/// @return The duplicated string, which is released with the arena, or NULL if memory could not be allocated
+CHAR16 *
+EFIAPI
+XmlArenaStrDup (
+  IN OUT XML_ARENA *Arena,
+  IN     CHAR16    *String OPTIONAL
+);
+// XmlArenaIntern
+/// Intern a name into an XML arena
+/// @param Arena The XML arena
+/// @param Name  The name to intern
+/// @return The interned name, which is the same for equal names and released with the arena, or NULL if memory could not be allocated
+CHAR16 *
+EFIAPI
+XmlArenaIntern (
+  IN OUT XML_ARENA *Arena,
+  IN     CHAR16    *Name
+);
+// XmlArenaFindName
+/// Find an interned name in an XML arena
+/// @param Arena The XML arena
+/// @param Name  The name to find
+/// @return The interned name or NULL if the name was never interned
+CHAR16 *
+EFIAPI
+XmlArenaFindName (
+  IN XML_ARENA *Arena,
+  IN CHAR16    *Name
+);
+// XmlArenaFree
+/// Release all memory allocated from an XML arena
+/// @param Arena The XML arena
+VOID
+EFIAPI
+XmlArenaFree (
+  IN OUT XML_ARENA *Arena
+);
+
+// XmlHashName
+/// Hash a name
+/// @param Name   The name
+/// @param Length The length of the name in characters
+/// @param Seed   The seed of the hash
+/// @return The hash of the name
+UINT32
+EFIAPI
+XmlHashName (
+  IN CHAR16 *Name,
+  IN UINTN   Length,
+  IN UINT32  Seed
+);
+
+// XmlAttributesAdd
+/// Add an attribute to the inline attributes of an XML document tree node
+/// @param Arena      The XML arena from which to allocate
+/// @param Attributes The XML document tree node attributes
+/// @param Name       The name of the attribute to add
+/// @param Attribute  On output, the added attribute
+/// @return Whether the attribute was added or not
+/// @retval EFI_INVALID_PARAMETER If Arena, Attributes, Name, or Attribute is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the attribute was added successfully
+EFI_STATUS
+EFIAPI
+XmlAttributesAdd (
+  IN OUT XML_ARENA       *Arena,
+  IN OUT XML_ATTRIBUTES  *Attributes,
+  IN     CHAR16          *Name,
+  OUT    XML_ATTRIBUTE  **Attribute
+);
+// XmlAttributesFind
+/// Find an attribute in the inline attributes of an XML document tree node
+/// @param Arena      The XML arena from which the attributes were allocated
+/// @param Attributes The XML document tree node attributes
+/// @param Name       The name of the attribute to find
+/// @param Index      On output, the index of the attribute in the list
+/// @return Whether the attribute was found or not
+/// @retval EFI_INVALID_PARAMETER If Arena, Attributes, Name, or Index is NULL
+/// @retval EFI_NOT_FOUND         If the attribute was not found
+/// @retval EFI_SUCCESS           If the attribute was found successfully
+EFI_STATUS
+EFIAPI
+XmlAttributesFind (
+  IN  XML_ARENA      *Arena,
+  IN  XML_ATTRIBUTES *Attributes,
+  IN  CHAR16         *Name,
+  OUT UINTN          *Index
+);
+// XmlAttributesRemove
+/// Remove an attribute from the inline attributes of an XML document tree node, keeping document order
+/// @param Arena      The XML arena from which the attributes were allocated
+/// @param Attributes The XML document tree node attributes
+/// @param Index      The index of the attribute in the list
+/// @return Whether the attribute was removed or not
+/// @retval EFI_INVALID_PARAMETER If Arena or Attributes is NULL or Index is out of range
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the attribute was removed successfully
+EFI_STATUS
+EFIAPI
+XmlAttributesRemove (
+  IN OUT XML_ARENA      *Arena,
+  IN OUT XML_ATTRIBUTES *Attributes,
+  IN     UINTN           Index
+);
+
+// XmlEntityResolve
+/// Resolve an entity to its replacement text
+/// @param Entities The declared entities, which are searched before the predefined named entities
+/// @param Name     The entity name
+/// @param Length   The length of the entity name in characters
+/// @param Buffer   The buffer used for character replacements, which must be at least XML_ENTITY_CHARACTER_SIZE characters
+/// @param Value    On output, the replacement text, which is not null-terminated
+/// @param Count    On output, the length of the replacement text in characters
+/// @return Whether the entity was resolved or not
+/// @retval EFI_INVALID_PARAMETER If Name, Buffer, Value, or Count is NULL or Length is zero
+/// @retval EFI_NOT_FOUND         If the entity is not declared or is not a valid character
+/// @retval EFI_SUCCESS           If the entity was resolved successfully
+EFI_STATUS
+EFIAPI
+XmlEntityResolve (
+  IN  XML_ENTITIES  *Entities OPTIONAL,
+  IN  CHAR16        *Name,
+  IN  UINTN          Length,
+  OUT CHAR16        *Buffer,
+  OUT CHAR16       **Value,
+  OUT UINTN         *Count
+);
+// XmlEntityDeclare
+/// Declare an entity, the first declaration of an entity is binding
+/// @param Arena    The XML arena from which to allocate
+/// @param Entities The declared entities
+/// @param Name     The entity name
+/// @param Entity   On output, the declared entity, which has no replacement text until set by XmlEntitySetValue
+/// @return Whether the entity was declared or not
+/// @retval EFI_INVALID_PARAMETER If Arena, Entities, Name, or Entity is NULL or Name is empty
+/// @retval EFI_ALREADY_STARTED   If the entity was already declared
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the entity was declared successfully
+EFI_STATUS
+EFIAPI
+XmlEntityDeclare (
+  IN OUT XML_ARENA     *Arena,
+  IN OUT XML_ENTITIES  *Entities,
+  IN     CHAR16        *Name,
+  OUT    XML_ENTITY   **Entity
+);
+// XmlEntitySetValue
+/// Set the replacement text of a declared entity, references in the value are replaced now so resolving the entity never recurses
+/// @param Arena     The XML arena from which to allocate
+/// @param Entities  The declared entities
+/// @param Entity    The declared entity
+/// @param Value     The literal value of the entity
+/// @param Expansion On input, the count of characters added by declared entity references, on output, including this value
+/// @return Whether the replacement text was set or not
+/// @retval EFI_INVALID_PARAMETER If Arena, Entities, Entity, Value, or Expansion is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated or the expansion exceeded XML_ENTITY_MAX_EXPANSION
+/// @retval EFI_SUCCESS           If the replacement text was set successfully
+EFI_STATUS
+EFIAPI
+XmlEntitySetValue (
+  IN OUT XML_ARENA    *Arena,
+  IN     XML_ENTITIES *Entities,
+  IN OUT XML_ENTITY   *Entity,
+  IN     CHAR16       *Value,
+  IN OUT UINTN        *Expansion
+);
+
 #endif // __XML_LIBRARY_STATES_HEADER__
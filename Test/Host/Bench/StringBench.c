@@ -0,0 +1,975 @@
+///
+/// @file Test/Host/Bench/StringBench.c
+///
+/// String library micro-benchmarks on device paths, configuration keys and log lines, compared against a baseline
+///
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../HostLib.h"
+
+// STRING_BENCH_TIME
+/// The default time, in milliseconds, each benchmark runs
+#define STRING_BENCH_TIME 200
+// STRING_BENCH_TOLERANCE
+/// The percentage ns/op may exceed the baseline before a benchmark is reported slower
+#define STRING_BENCH_TOLERANCE 25
+// STRING_BENCH_MAX_RESULTS
+/// The maximum count of baseline results
+#define STRING_BENCH_MAX_RESULTS 64
+// STRING_BENCH_MAX_NAME
+/// The maximum size, in bytes, of a benchmark name
+#define STRING_BENCH_MAX_NAME 64
+// STRING_BENCH_DATA_SIZE
+/// The size, in bytes, of the data encoded as Base64, about the size of a configuration data value
+#define STRING_BENCH_DATA_SIZE 256
+// STRING_BENCH_CHECK_RUNS
+/// The count of runs whose results are checked before a benchmark is measured, enough to use every input
+#define STRING_BENCH_CHECK_RUNS 64
+
+// STRING_BENCH_RUN
+/// Run a benchmark once
+/// @param Index The index of the run
+/// @return The count of operations performed
+typedef UINTN
+(EFIAPI
+*STRING_BENCH_RUN) (
+  IN UINTN Index
+);
+
+// STRING_BENCH_CHECK
+/// Run a benchmark once and check the result
+/// @param Index The index of the run
+/// @return Whether the result was right or not
+typedef BOOLEAN
+(EFIAPI
+*STRING_BENCH_CHECK) (
+  IN UINTN Index
+);
+
+// STRING_BENCH
+/// String library benchmark
+typedef struct _STRING_BENCH STRING_BENCH;
+struct _STRING_BENCH {
+
+  // Name
+  /// The benchmark name
+  CHAR8              *Name;
+  // Run
+  /// The function that runs the benchmark once
+  STRING_BENCH_RUN    Run;
+  // Check
+  /// The function that runs the benchmark once and checks the result
+  STRING_BENCH_CHECK  Check;
+  // Collation
+  /// Whether the benchmark runs with the host collation protocol for the language
+  BOOLEAN             Collation;
+
+};
+// STRING_BENCH_RESULT
+/// String library benchmark result
+typedef struct _STRING_BENCH_RESULT STRING_BENCH_RESULT;
+struct _STRING_BENCH_RESULT {
+
+  // Name
+  /// The benchmark name
+  CHAR8  Name[STRING_BENCH_MAX_NAME];
+  // Time
+  /// The nanoseconds for each operation
+  double Time;
+  // Allocations
+  /// The allocations for each operation
+  double Allocations;
+
+};
+
+// mStringBenchDevicePaths
+/// Device paths of boot entries and drivers
+STATIC CHAR16 *mStringBenchDevicePaths[] = {
+  L"PciRoot(0x0)/Pci(0x1F,0x2)/Sata(0x0,0xFFFF,0x0)/HD(2,GPT,4A3B2C1D-0000-4000-8000-00A0C9E3F1B2,0x64028,0x3A386010)/\\EFI\\BOOT\\BOOTX64.EFI",
+  L"PciRoot(0x0)/Pci(0x1D,0x0)/Pci(0x0,0x0)/NVMe(0x1,00-25-38-5B-81-B0-6C-A2)/HD(1,GPT,B5E9A1C4-2F7D-4E1B-9C3A-6D8F0E2B4A71,0x28,0x64000)/\\System\\Library\\CoreServices\\boot.efi",
+  L"PciRoot(0x0)/Pci(0x14,0x0)/USB(0x3,0x0)/USB(0x1,0x0)/HD(1,MBR,0x0A1B2C3D,0x800,0x3B9E000)/\\EFI\\CLOVER\\drivers\\UEFI\\HfsPlus.efi",
+  L"PciRoot(0x0)/Pci(0x1F,0x2)/Sata(0x1,0xFFFF,0x0)/HD(4,GPT,7C0FEE12-3D4B-4A5C-8E9F-112233445566,0x1D1C5000,0x100000)/\\EFI\\Microsoft\\Boot\\bootmgfw.efi",
+  L"PciRoot(0x0)/Pci(0x1C,0x4)/Pci(0x0,0x0)/MAC(001B21A1B2C3,0x1)/IPv4(0.0.0.0,0x0,DHCP,0.0.0.0,0.0.0.0,0.0.0.0)",
+  L"PciRoot(0x0)/Pci(0x1F,0x2)/Sata(0x0,0xFFFF,0x0)/HD(3,GPT,0F1E2D3C-4B5A-6978-8796-A5B4C3D2E1F0,0x3A3EC038,0x135F20)/\\com.apple.recovery.boot\\boot.efi",
+};
+// mStringBenchConfigKeys
+/// Configuration keys in the order they appear in a configuration file
+STATIC CHAR16 *mStringBenchConfigKeys[] = {
+  L"\\Boot\\Timeout",
+  L"\\Boot\\DefaultVolume",
+  L"\\Boot\\DefaultLoader",
+  L"\\Boot\\Arguments",
+  L"\\GUI\\Theme",
+  L"\\GUI\\ScreenResolution",
+  L"\\GUI\\Mouse\\Enabled",
+  L"\\GUI\\Mouse\\Speed",
+  L"\\GUI\\Hide\\0",
+  L"\\GUI\\Scan\\Entries",
+  L"\\ACPI\\DSDT\\Name",
+  L"\\ACPI\\DSDT\\Fixes\\FixShutdown",
+  L"\\ACPI\\SSDT\\Generate\\PluginType",
+  L"\\ACPI\\SSDT\\DropOem",
+  L"\\Devices\\Audio\\Inject",
+  L"\\Devices\\USB\\FixOwnership",
+  L"\\Graphics\\Inject\\Intel",
+  L"\\Graphics\\EDID\\Inject",
+  L"\\KernelAndKextPatches\\KernelPm",
+  L"\\KernelAndKextPatches\\KextsToPatch\\0\\Name",
+  L"\\KernelAndKextPatches\\KextsToPatch\\0\\Find",
+  L"\\KernelAndKextPatches\\KextsToPatch\\0\\Replace",
+  L"\\SMBIOS\\ProductName",
+  L"\\SMBIOS\\SerialNumber",
+  L"\\SystemParameters\\InjectKexts",
+  L"\\RtVariables\\BooterConfig",
+};
+// mStringBenchLogLines
+/// Log lines written while scanning and starting
+STATIC CHAR16 *mStringBenchLogLines[] = {
+  L"0:100  0:000  Found bootable entry \"Boot macOS from Macintosh HD\" on volume \"Macintosh HD\"",
+  L"0:112  0:012  Loading driver \\EFI\\CLOVER\\drivers\\UEFI\\ApfsDriverLoader.efi, status Success",
+  L"0:245  0:133  SetScreenResolution: 1920x1080 - already set",
+  L"0:301  0:056  Volume 3: PciRoot(0x0)/Pci(0x1F,0x2)/Sata(0x0,0xFFFF,0x0)/HD(2,GPT,4A3B2C1D,0x64028,0x3A386010)",
+  L"0:455  0:154  KextsToPatch 0: IOAHCIBlockStorage (Trim enabler) replaced 1 time",
+  L"0:502  0:047  Custom entry 2 \"Windows\" matched \\EFI\\Microsoft\\Boot\\bootmgfw.efi",
+};
+// mStringBenchDevicePathMatches
+/// Whether each device path matches the boot file pattern
+STATIC BOOLEAN mStringBenchDevicePathMatches[ARRAY_SIZE(mStringBenchDevicePaths)] = {
+  TRUE, FALSE, FALSE, TRUE, FALSE, FALSE
+};
+// mStringBenchNames
+/// Volume and theme names that are not only ASCII
+STATIC CHAR16 *mStringBenchNames[] = {
+  L"Syst\x00E8me \x00C9l\x00E9ments",
+  L"\x0414\x0438\x0441\x043A \x0421\x0438\x0441\x0442\x0435\x043C\x0430",
+  L"\x30B7\x30B9\x30C6\x30E0 \x30C7\x30A3\x30B9\x30AF",
+  L"\x03A3\x03CD\x03C3\x03C4\x03B7\x03BC\x03B1 \x0394\x03AF\x03C3\x03BA\x03BF\x03C2",
+};
+
+// mStringBenchDevicePathsUpper
+/// The device paths in upper case
+STATIC CHAR16 *mStringBenchDevicePathsUpper[ARRAY_SIZE(mStringBenchDevicePaths)];
+// mStringBenchConfigKeysUpper
+/// The configuration keys in upper case
+STATIC CHAR16 *mStringBenchConfigKeysUpper[ARRAY_SIZE(mStringBenchConfigKeys)];
+// mStringBenchLogLinesAscii
+/// The log lines as ASCII
+STATIC CHAR8  *mStringBenchLogLinesAscii[ARRAY_SIZE(mStringBenchLogLines)];
+// mStringBenchData
+/// The data encoded as Base64
+STATIC UINT8   mStringBenchData[STRING_BENCH_DATA_SIZE];
+// mStringBenchBase64
+/// The data encoded as Base64
+STATIC CHAR16 *mStringBenchBase64 = NULL;
+// mStringBenchSink
+/// The results of the benchmarks, so they are not optimized away
+STATIC volatile UINTN mStringBenchSink = 0;
+
+// StringBenchFold
+/// Fold the case of a basic latin character without the string library
+/// @param Character The character to fold
+/// @return The character in lower case
+STATIC CHAR16
+StringBenchFold (
+  IN CHAR16 Character
+) {
+  return ((Character >= L'A') && (Character <= L'Z')) ? (CHAR16)(Character | 0x20) : Character;
+}
+// StringBenchCompare
+/// Compare two basic latin strings case-insensitively without the string library
+/// @param String1 The first string
+/// @param String2 The second string
+/// @return The difference of the first folded characters that differ
+STATIC INTN
+StringBenchCompare (
+  IN CONST CHAR16 *String1,
+  IN CONST CHAR16 *String2
+) {
+  while ((*String1 != L'\0') && (StringBenchFold(*String1) == StringBenchFold(*String2))) {
+    ++String1;
+    ++String2;
+  }
+  return (INTN)StringBenchFold(*String1) - (INTN)StringBenchFold(*String2);
+}
+// StringBenchFind
+/// Search a basic latin string case-insensitively without the string library
+/// @param String The string to search
+/// @param Search The string to find
+/// @return The first occurrence of the search string or NULL if it was not found
+STATIC CHAR16 *
+StringBenchFind (
+  IN CHAR16       *String,
+  IN CONST CHAR16 *Search
+) {
+  UINTN Index;
+  for (; *String != L'\0'; ++String) {
+    for (Index = 0; (Search[Index] != L'\0') && (StringBenchFold(String[Index]) == StringBenchFold(Search[Index])); ++Index);
+    if (Search[Index] == L'\0') {
+      return String;
+    }
+  }
+  return NULL;
+}
+// StringBenchEncode
+/// Encode data as Base64 without the string library
+/// @param Size The size, in bytes, of the data
+/// @param Data The data to encode
+/// @return The Base64 string, which must be freed, or NULL if memory could not be allocated
+STATIC CHAR16 *
+StringBenchEncode (
+  IN UINTN        Size,
+  IN CONST UINT8 *Data
+) {
+  STATIC CONST CHAR8 Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  CHAR16            *Base64 = AllocateZeroPool((((Size + 2) / 3) * 4 + 1) * sizeof(CHAR16));
+  UINT32             Bits;
+  UINTN              Index;
+  UINTN              Count = 0;
+  if (Base64 == NULL) {
+    return NULL;
+  }
+  for (Index = 0; Index < Size; Index += 3) {
+    Bits = ((UINT32)Data[Index] << 16);
+    if ((Index + 1) < Size) {
+      Bits |= ((UINT32)Data[Index + 1] << 8);
+    }
+    if ((Index + 2) < Size) {
+      Bits |= Data[Index + 2];
+    }
+    Base64[Count++] = Alphabet[(Bits >> 18) & 0x3F];
+    Base64[Count++] = Alphabet[(Bits >> 12) & 0x3F];
+    Base64[Count++] = ((Index + 1) < Size) ? Alphabet[(Bits >> 6) & 0x3F] : L'=';
+    Base64[Count++] = ((Index + 2) < Size) ? Alphabet[Bits & 0x3F] : L'=';
+  }
+  return Base64;
+}
+
+// StringBenchStrAppend
+/// Append each character of a log line to a new string
+STATIC UINTN
+EFIAPI
+StringBenchStrAppend (
+  IN UINTN Index
+) {
+  CHAR16 *Line = mStringBenchLogLines[Index % ARRAY_SIZE(mStringBenchLogLines)];
+  CHAR16 *String = NULL;
+  UINTN   Count = 0;
+  UINTN   Size = 0;
+  for (; *Line != L'\0'; ++Line) {
+    StrAppend(&String, &Count, &Size, *Line);
+  }
+  mStringBenchSink += Count;
+  if (String != NULL) {
+    FreePool(String);
+  }
+  return 1;
+}
+// StringBenchStriCmpKeys
+/// Compare a configuration key with the same key in upper case
+STATIC UINTN
+EFIAPI
+StringBenchStriCmpKeys (
+  IN UINTN Index
+) {
+  Index %= ARRAY_SIZE(mStringBenchConfigKeys);
+  mStringBenchSink += (UINTN)StriCmp(mStringBenchConfigKeys[Index], mStringBenchConfigKeysUpper[Index]);
+  return 1;
+}
+// StringBenchStriCmpPaths
+/// Compare a device path with the same device path in upper case
+STATIC UINTN
+EFIAPI
+StringBenchStriCmpPaths (
+  IN UINTN Index
+) {
+  Index %= ARRAY_SIZE(mStringBenchDevicePaths);
+  mStringBenchSink += (UINTN)StriCmp(mStringBenchDevicePaths[Index], mStringBenchDevicePathsUpper[Index]);
+  return 1;
+}
+// StringBenchStriStrPaths
+/// Search a device path for a file path
+STATIC UINTN
+EFIAPI
+StringBenchStriStrPaths (
+  IN UINTN Index
+) {
+  mStringBenchSink += (UINTN)StriStr(mStringBenchDevicePaths[Index % ARRAY_SIZE(mStringBenchDevicePaths)], L"\\efi\\boot\\");
+  return 1;
+}
+// StringBenchStriStrLines
+/// Search a log line for a word
+STATIC UINTN
+EFIAPI
+StringBenchStriStrLines (
+  IN UINTN Index
+) {
+  mStringBenchSink += (UINTN)StriStr(mStringBenchLogLines[Index % ARRAY_SIZE(mStringBenchLogLines)], L"VOLUME");
+  return 1;
+}
+// StringBenchMetaiMatchPaths
+/// Match a device path with a pattern
+STATIC UINTN
+EFIAPI
+StringBenchMetaiMatchPaths (
+  IN UINTN Index
+) {
+  mStringBenchSink += MetaiMatch(mStringBenchDevicePaths[Index % ARRAY_SIZE(mStringBenchDevicePaths)], L"*\\EFI\\*\\boot*.efi");
+  return 1;
+}
+// StringBenchMetaiMatchKeys
+/// Match a configuration key with a pattern
+STATIC UINTN
+EFIAPI
+StringBenchMetaiMatchKeys (
+  IN UINTN Index
+) {
+  mStringBenchSink += MetaiMatch(mStringBenchConfigKeys[Index % ARRAY_SIZE(mStringBenchConfigKeys)], L"\\kernel*\\*\\[0-9]\\*");
+  return 1;
+}
+// StringBenchStrListSorted
+/// Insert every configuration key into a sorted case-insensitive list without duplicates
+STATIC UINTN
+EFIAPI
+StringBenchStrListSorted (
+  IN UINTN Index
+) {
+  STR_LIST List;
+  UINTN    Key;
+  ZeroMem(&List, sizeof(List));
+  List.Options = STR_LIST_SORTED | STR_LIST_NO_DUPLICATES | STR_LIST_CASE_INSENSITIVE;
+  for (Key = 0; Key < ARRAY_SIZE(mStringBenchConfigKeys); ++Key) {
+    StrListAdd(&List, mStringBenchConfigKeys[Key], 0);
+  }
+  mStringBenchSink += List.Count;
+  StrListClear(&List);
+  return ARRAY_SIZE(mStringBenchConfigKeys);
+}
+// StringBenchStrSplitPaths
+/// Split a device path into its nodes
+STATIC UINTN
+EFIAPI
+StringBenchStrSplitPaths (
+  IN UINTN Index
+) {
+  CHAR16 **List = NULL;
+  UINTN    Count = 0;
+  if (!EFI_ERROR(StrSplit(&List, &Count, mStringBenchDevicePaths[Index % ARRAY_SIZE(mStringBenchDevicePaths)], L"/", 0))) {
+    mStringBenchSink += Count;
+    StrListFree(List, Count);
+  }
+  return 1;
+}
+// StringBenchStrSplitLines
+/// Split a log line into its words
+STATIC UINTN
+EFIAPI
+StringBenchStrSplitLines (
+  IN UINTN Index
+) {
+  CHAR16 **List = NULL;
+  UINTN    Count = 0;
+  if (!EFI_ERROR(StrSplit(&List, &Count, mStringBenchLogLines[Index % ARRAY_SIZE(mStringBenchLogLines)], L" ", 0))) {
+    mStringBenchSink += Count;
+    StrListFree(List, Count);
+  }
+  return 1;
+}
+// StringBenchIsUnicodeCharacter
+/// Check each character of a log line or a name in another script
+STATIC UINTN
+EFIAPI
+StringBenchIsUnicodeCharacter (
+  IN UINTN Index
+) {
+  CHAR16 *Line = mStringBenchNames[Index % ARRAY_SIZE(mStringBenchNames)];
+  UINTN   Count = 0;
+  if ((Index & 1) == 0) {
+    Line = mStringBenchLogLines[(Index >> 1) % ARRAY_SIZE(mStringBenchLogLines)];
+  }
+  for (; Line[Count] != L'\0'; ++Count) {
+    mStringBenchSink += IsUnicodeCharacter(Line[Count]);
+  }
+  return Count;
+}
+// StringBenchToBase64
+/// Encode data as Base64
+STATIC UINTN
+EFIAPI
+StringBenchToBase64 (
+  IN UINTN Index
+) {
+  CHAR16 *Base64 = NULL;
+  UINTN   Count = 0;
+  if (!EFI_ERROR(ToBase64(sizeof(mStringBenchData), mStringBenchData, &Count, &Base64)) && (Base64 != NULL)) {
+    mStringBenchSink += Count;
+    FreePool(Base64);
+  }
+  return 1;
+}
+// StringBenchFromBase64
+/// Decode data from Base64
+STATIC UINTN
+EFIAPI
+StringBenchFromBase64 (
+  IN UINTN Index
+) {
+  VOID  *Data = NULL;
+  UINTN  Size = 0;
+  if (!EFI_ERROR(FromBase64(mStringBenchBase64, &Size, &Data)) && (Data != NULL)) {
+    mStringBenchSink += Size;
+    FreePool(Data);
+  }
+  return 1;
+}
+// StringBenchToAscii
+/// Narrow a log line to ASCII
+STATIC UINTN
+EFIAPI
+StringBenchToAscii (
+  IN UINTN Index
+) {
+  CHAR8 *Ascii = ToAscii(mStringBenchLogLines[Index % ARRAY_SIZE(mStringBenchLogLines)]);
+  if (Ascii != NULL) {
+    mStringBenchSink += (UINT8)*Ascii;
+    FreePool(Ascii);
+  }
+  return 1;
+}
+// StringBenchFromAscii
+/// Widen an ASCII log line
+STATIC UINTN
+EFIAPI
+StringBenchFromAscii (
+  IN UINTN Index
+) {
+  CHAR16 *String = FromAscii(mStringBenchLogLinesAscii[Index % ARRAY_SIZE(mStringBenchLogLinesAscii)]);
+  if (String != NULL) {
+    mStringBenchSink += *String;
+    FreePool(String);
+  }
+  return 1;
+}
+
+// StringBenchCheckStrAppend
+/// Append each character of a log line to a new string and check the string is the log line
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckStrAppend (
+  IN UINTN Index
+) {
+  CHAR16  *Line = mStringBenchLogLines[Index % ARRAY_SIZE(mStringBenchLogLines)];
+  CHAR16  *String = NULL;
+  UINTN    Count = 0;
+  UINTN    Size = 0;
+  UINTN    Offset;
+  BOOLEAN  Right;
+  for (Offset = 0; Line[Offset] != L'\0'; ++Offset) {
+    StrAppend(&String, &Count, &Size, Line[Offset]);
+  }
+  Right = (String != NULL) && (Count == Offset) && (StrCmp(String, Line) == 0);
+  if (String != NULL) {
+    FreePool(String);
+  }
+  return Right;
+}
+// StringBenchCheckStriCmpKeys
+/// Compare a configuration key with the same key in upper case and with the next key
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckStriCmpKeys (
+  IN UINTN Index
+) {
+  CHAR16 *Next = mStringBenchConfigKeys[(Index + 1) % ARRAY_SIZE(mStringBenchConfigKeys)];
+  INTN    Result;
+  Index %= ARRAY_SIZE(mStringBenchConfigKeys);
+  Result = StriCmp(mStringBenchConfigKeys[Index], Next);
+  return (StriCmp(mStringBenchConfigKeys[Index], mStringBenchConfigKeysUpper[Index]) == 0) &&
+         ((Result < 0) == (StringBenchCompare(mStringBenchConfigKeys[Index], Next) < 0)) && (Result != 0);
+}
+// StringBenchCheckStriCmpPaths
+/// Compare a device path with the same device path in upper case and with the next device path
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckStriCmpPaths (
+  IN UINTN Index
+) {
+  CHAR16 *Next = mStringBenchDevicePaths[(Index + 1) % ARRAY_SIZE(mStringBenchDevicePaths)];
+  INTN    Result;
+  Index %= ARRAY_SIZE(mStringBenchDevicePaths);
+  Result = StriCmp(mStringBenchDevicePaths[Index], Next);
+  return (StriCmp(mStringBenchDevicePaths[Index], mStringBenchDevicePathsUpper[Index]) == 0) &&
+         ((Result < 0) == (StringBenchCompare(mStringBenchDevicePaths[Index], Next) < 0)) && (Result != 0);
+}
+// StringBenchCheckStriStrPaths
+/// Search a device path for a file path and check the occurrence found
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckStriStrPaths (
+  IN UINTN Index
+) {
+  CHAR16 *Path = mStringBenchDevicePaths[Index % ARRAY_SIZE(mStringBenchDevicePaths)];
+  return (StriStr(Path, L"\\efi\\boot\\") == StringBenchFind(Path, L"\\efi\\boot\\"));
+}
+// StringBenchCheckStriStrLines
+/// Search a log line for a word and check the occurrence found
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckStriStrLines (
+  IN UINTN Index
+) {
+  CHAR16 *Line = mStringBenchLogLines[Index % ARRAY_SIZE(mStringBenchLogLines)];
+  return (StriStr(Line, L"VOLUME") == StringBenchFind(Line, L"VOLUME"));
+}
+// StringBenchCheckMetaiMatchPaths
+/// Match a device path with a pattern and check whether it matched
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckMetaiMatchPaths (
+  IN UINTN Index
+) {
+  Index %= ARRAY_SIZE(mStringBenchDevicePaths);
+  return (MetaiMatch(mStringBenchDevicePaths[Index], L"*\\EFI\\*\\boot*.efi") == mStringBenchDevicePathMatches[Index]);
+}
+// StringBenchCheckMetaiMatchKeys
+/// Match a configuration key with a pattern and check only the keys of a patch entry matched
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckMetaiMatchKeys (
+  IN UINTN Index
+) {
+  CHAR16 *Key = mStringBenchConfigKeys[Index % ARRAY_SIZE(mStringBenchConfigKeys)];
+  return (MetaiMatch(Key, L"\\kernel*\\*\\[0-9]\\*") == (StringBenchFind(Key, L"\\KextsToPatch\\0\\") != NULL));
+}
+// StringBenchCheckStrListSorted
+/// Insert every configuration key into a sorted case-insensitive list without duplicates and check the order
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckStrListSorted (
+  IN UINTN Index
+) {
+  STR_LIST List;
+  UINTN    Key;
+  BOOLEAN  Right;
+  ZeroMem(&List, sizeof(List));
+  List.Options = STR_LIST_SORTED | STR_LIST_NO_DUPLICATES | STR_LIST_CASE_INSENSITIVE;
+  for (Key = 0; Key < ARRAY_SIZE(mStringBenchConfigKeys); ++Key) {
+    StrListAdd(&List, mStringBenchConfigKeys[Key], 0);
+  }
+  // Adding the keys again in upper case must not add duplicates
+  for (Key = 0; Key < ARRAY_SIZE(mStringBenchConfigKeys); ++Key) {
+    StrListAdd(&List, mStringBenchConfigKeysUpper[Key], 0);
+  }
+  Right = (List.Count == ARRAY_SIZE(mStringBenchConfigKeys));
+  for (Key = 1; Right && (Key < List.Count); ++Key) {
+    Right = (StringBenchCompare(List.Strings[Key - 1], List.Strings[Key]) < 0);
+  }
+  StrListClear(&List);
+  return Right;
+}
+// StringBenchCheckSplit
+/// Split a string and check each piece
+/// @param String    The string to split
+/// @param Separator The character that splits
+/// @return Whether the pieces were right or not
+STATIC BOOLEAN
+StringBenchCheckSplit (
+  IN CHAR16 *String,
+  IN CHAR16  Separator
+) {
+  CHAR16   Split[2] = { Separator, L'\0' };
+  CHAR16 **List = NULL;
+  UINTN    Count = 0;
+  UINTN    Piece = 0;
+  UINTN    Length;
+  BOOLEAN  Right;
+  if (EFI_ERROR(StrSplit(&List, &Count, String, Split, 0))) {
+    return FALSE;
+  }
+  Right = TRUE;
+  while (Right && (Piece < Count)) {
+    for (Length = 0; (String[Length] != L'\0') && (String[Length] != Separator); ++Length);
+    // An empty piece is added as the rest of the string, so only check the pieces that are not empty
+    Right = (Length == 0) || ((StrnCmp(List[Piece], String, Length) == 0) && (List[Piece][Length] == L'\0'));
+    ++Piece;
+    String += Length;
+    if (*String == L'\0') {
+      break;
+    }
+    ++String;
+  }
+  Right = Right && (Piece == Count) && (*String == L'\0');
+  StrListFree(List, Count);
+  return Right;
+}
+// StringBenchCheckStrSplitPaths
+/// Split a device path into its nodes and check each node
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckStrSplitPaths (
+  IN UINTN Index
+) {
+  return StringBenchCheckSplit(mStringBenchDevicePaths[Index % ARRAY_SIZE(mStringBenchDevicePaths)], L'/');
+}
+// StringBenchCheckStrSplitLines
+/// Split a log line into its words and check each word
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckStrSplitLines (
+  IN UINTN Index
+) {
+  return StringBenchCheckSplit(mStringBenchLogLines[Index % ARRAY_SIZE(mStringBenchLogLines)], L' ');
+}
+// StringBenchCheckIsUnicodeCharacter
+/// Check each character of a log line or a name in another script is a character
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckIsUnicodeCharacter (
+  IN UINTN Index
+) {
+  CHAR16 *Line = mStringBenchNames[Index % ARRAY_SIZE(mStringBenchNames)];
+  if ((Index & 1) == 0) {
+    Line = mStringBenchLogLines[(Index >> 1) % ARRAY_SIZE(mStringBenchLogLines)];
+  }
+  for (; *Line != L'\0'; ++Line) {
+    if (!IsUnicodeCharacter(*Line)) {
+      return FALSE;
+    }
+  }
+  // A lone surrogate and a noncharacter are not characters
+  return !IsUnicodeCharacter(0xD800) && !IsUnicodeCharacter(0xFFFF);
+}
+// StringBenchCheckToBase64
+/// Encode data as Base64 and check the encoding
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckToBase64 (
+  IN UINTN Index
+) {
+  CHAR16  *Base64 = NULL;
+  UINTN    Count = 0;
+  BOOLEAN  Right;
+  if (EFI_ERROR(ToBase64(sizeof(mStringBenchData), mStringBenchData, &Count, &Base64)) || (Base64 == NULL)) {
+    return FALSE;
+  }
+  Right = (Count == StrLen(mStringBenchBase64)) && (StrCmp(Base64, mStringBenchBase64) == 0);
+  FreePool(Base64);
+  return Right;
+}
+// StringBenchCheckFromBase64
+/// Decode data from Base64 and check the data
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckFromBase64 (
+  IN UINTN Index
+) {
+  VOID    *Data = NULL;
+  UINTN    Size = 0;
+  BOOLEAN  Right;
+  if (EFI_ERROR(FromBase64(mStringBenchBase64, &Size, &Data)) || (Data == NULL)) {
+    return FALSE;
+  }
+  Right = (Size == sizeof(mStringBenchData)) && (CompareMem(Data, mStringBenchData, Size) == 0);
+  FreePool(Data);
+  return Right;
+}
+// StringBenchCheckToAscii
+/// Narrow a log line to ASCII and check each character
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckToAscii (
+  IN UINTN Index
+) {
+  CHAR16  *Line = mStringBenchLogLines[Index % ARRAY_SIZE(mStringBenchLogLines)];
+  CHAR8   *Ascii = ToAscii(Line);
+  UINTN    Offset;
+  BOOLEAN  Right;
+  if (Ascii == NULL) {
+    return FALSE;
+  }
+  for (Offset = 0; (Line[Offset] != L'\0') && ((CHAR16)(UINT8)Ascii[Offset] == Line[Offset]); ++Offset);
+  Right = (Line[Offset] == L'\0') && (Ascii[Offset] == '\0');
+  FreePool(Ascii);
+  return Right;
+}
+// StringBenchCheckFromAscii
+/// Widen an ASCII log line and check it is the log line
+STATIC BOOLEAN
+EFIAPI
+StringBenchCheckFromAscii (
+  IN UINTN Index
+) {
+  CHAR16  *String = FromAscii(mStringBenchLogLinesAscii[Index % ARRAY_SIZE(mStringBenchLogLinesAscii)]);
+  BOOLEAN  Right;
+  if (String == NULL) {
+    return FALSE;
+  }
+  Right = (StrCmp(String, mStringBenchLogLines[Index % ARRAY_SIZE(mStringBenchLogLines)]) == 0);
+  FreePool(String);
+  return Right;
+}
+
+// mStringBenches
+/// The benchmarks
+STATIC STRING_BENCH mStringBenches[] = {
+  { "StrAppend/LogLine", StringBenchStrAppend, StringBenchCheckStrAppend, FALSE },
+  { "StriCmp/ConfigKey", StringBenchStriCmpKeys, StringBenchCheckStriCmpKeys, FALSE },
+  { "StriCmp/DevicePath", StringBenchStriCmpPaths, StringBenchCheckStriCmpPaths, FALSE },
+  { "StriStr/DevicePath", StringBenchStriStrPaths, StringBenchCheckStriStrPaths, FALSE },
+  { "StriStr/DevicePath/Collation", StringBenchStriStrPaths, StringBenchCheckStriStrPaths, TRUE },
+  { "StriStr/LogLine", StringBenchStriStrLines, StringBenchCheckStriStrLines, FALSE },
+  { "StriStr/LogLine/Collation", StringBenchStriStrLines, StringBenchCheckStriStrLines, TRUE },
+  { "MetaiMatch/DevicePath", StringBenchMetaiMatchPaths, StringBenchCheckMetaiMatchPaths, FALSE },
+  { "MetaiMatch/ConfigKey", StringBenchMetaiMatchKeys, StringBenchCheckMetaiMatchKeys, FALSE },
+  { "StrListAdd/Sorted/ConfigKey", StringBenchStrListSorted, StringBenchCheckStrListSorted, FALSE },
+  { "StrSplit/DevicePath", StringBenchStrSplitPaths, StringBenchCheckStrSplitPaths, FALSE },
+  { "StrSplit/LogLine", StringBenchStrSplitLines, StringBenchCheckStrSplitLines, FALSE },
+  { "IsUnicodeCharacter/Text", StringBenchIsUnicodeCharacter, StringBenchCheckIsUnicodeCharacter, FALSE },
+  { "ToBase64/Data", StringBenchToBase64, StringBenchCheckToBase64, FALSE },
+  { "FromBase64/Data", StringBenchFromBase64, StringBenchCheckFromBase64, FALSE },
+  { "ToAscii/LogLine", StringBenchToAscii, StringBenchCheckToAscii, FALSE },
+  { "FromAscii/LogLine", StringBenchFromAscii, StringBenchCheckFromAscii, FALSE },
+};
+// mStringBenchBaseline
+/// The baseline results
+STATIC STRING_BENCH_RESULT mStringBenchBaseline[STRING_BENCH_MAX_RESULTS];
+// mStringBenchBaselineCount
+/// The count of baseline results
+STATIC UINTN               mStringBenchBaselineCount = 0;
+
+// StringBenchSetup
+/// Create the upper case, ASCII and Base64 inputs
+/// @return Whether the inputs were created or not
+STATIC BOOLEAN
+StringBenchSetup (
+  VOID
+) {
+  UINTN Index;
+  for (Index = 0; Index < ARRAY_SIZE(mStringBenchDevicePaths); ++Index) {
+    mStringBenchDevicePathsUpper[Index] = StrToUpper(mStringBenchDevicePaths[Index]);
+    if (mStringBenchDevicePathsUpper[Index] == NULL) {
+      return FALSE;
+    }
+  }
+  for (Index = 0; Index < ARRAY_SIZE(mStringBenchConfigKeys); ++Index) {
+    mStringBenchConfigKeysUpper[Index] = StrToUpper(mStringBenchConfigKeys[Index]);
+    if (mStringBenchConfigKeysUpper[Index] == NULL) {
+      return FALSE;
+    }
+  }
+  for (Index = 0; Index < ARRAY_SIZE(mStringBenchLogLines); ++Index) {
+    mStringBenchLogLinesAscii[Index] = ToAscii(mStringBenchLogLines[Index]);
+    if (mStringBenchLogLinesAscii[Index] == NULL) {
+      return FALSE;
+    }
+  }
+  for (Index = 0; Index < sizeof(mStringBenchData); ++Index) {
+    mStringBenchData[Index] = (UINT8)((Index * 0x9D) ^ (Index >> 3));
+  }
+  mStringBenchBase64 = StringBenchEncode(sizeof(mStringBenchData), mStringBenchData);
+  return (mStringBenchBase64 != NULL);
+}
+// StringBenchCleanup
+/// Free the upper case, ASCII and Base64 inputs
+STATIC VOID
+StringBenchCleanup (
+  VOID
+) {
+  UINTN Index;
+  for (Index = 0; Index < ARRAY_SIZE(mStringBenchDevicePaths); ++Index) {
+    if (mStringBenchDevicePathsUpper[Index] != NULL) {
+      FreePool(mStringBenchDevicePathsUpper[Index]);
+    }
+  }
+  for (Index = 0; Index < ARRAY_SIZE(mStringBenchConfigKeys); ++Index) {
+    if (mStringBenchConfigKeysUpper[Index] != NULL) {
+      FreePool(mStringBenchConfigKeysUpper[Index]);
+    }
+  }
+  for (Index = 0; Index < ARRAY_SIZE(mStringBenchLogLines); ++Index) {
+    if (mStringBenchLogLinesAscii[Index] != NULL) {
+      FreePool(mStringBenchLogLinesAscii[Index]);
+    }
+  }
+  if (mStringBenchBase64 != NULL) {
+    FreePool(mStringBenchBase64);
+  }
+}
+
+// StringBenchLoadBaseline
+/// Load the baseline results, each line is the name, ns/op and allocs/op of a benchmark, lines starting with # are comments
+/// @param Path The path of the baseline file
+/// @return Whether the baseline was loaded or not
+STATIC BOOLEAN
+StringBenchLoadBaseline (
+  IN CONST char *Path
+) {
+  char                 Line[256];
+  FILE                *File = fopen(Path, "r");
+  STRING_BENCH_RESULT *Result;
+  if (File == NULL) {
+    return FALSE;
+  }
+  while ((mStringBenchBaselineCount < STRING_BENCH_MAX_RESULTS) && (fgets(Line, sizeof(Line), File) != NULL)) {
+    Result = mStringBenchBaseline + mStringBenchBaselineCount;
+    if ((Line[0] != '#') && (sscanf(Line, "%63s %lf %lf", Result->Name, &(Result->Time), &(Result->Allocations)) == 3)) {
+      ++mStringBenchBaselineCount;
+    }
+  }
+  fclose(File);
+  return TRUE;
+}
+// StringBenchFindBaseline
+/// Find the baseline result of a benchmark
+/// @param Name The benchmark name
+/// @return The baseline result or NULL if the benchmark has no baseline
+STATIC STRING_BENCH_RESULT *
+StringBenchFindBaseline (
+  IN CONST CHAR8 *Name
+) {
+  UINTN Index;
+  for (Index = 0; Index < mStringBenchBaselineCount; ++Index) {
+    if (strcmp(mStringBenchBaseline[Index].Name, Name) == 0) {
+      return mStringBenchBaseline + Index;
+    }
+  }
+  return NULL;
+}
+// StringBenchMeasure
+/// Check the results of a benchmark then run it for at least a time and measure each operation
+/// @param Bench  The benchmark
+/// @param Time   The minimum time, in nanoseconds, to run
+/// @param Result On output, the benchmark result
+/// @return Whether the benchmark results were right or not
+STATIC BOOLEAN
+StringBenchMeasure (
+  IN  STRING_BENCH        *Bench,
+  IN  UINT64               Time,
+  OUT STRING_BENCH_RESULT *Result
+) {
+  UINT64  Start;
+  UINT64  Elapsed;
+  UINT64  Allocations;
+  UINT64  Operations = 0;
+  UINTN   Index;
+  UINTN   Run = 0;
+  BOOLEAN Right = TRUE;
+  // Change to a language with a collation protocol if needed
+  HostSetCollation(Bench->Collation);
+  SetLanguage(Bench->Collation ? "fr" : NULL);
+  // Check the results with every input before timing, so a faster wrong result is not taken for an improvement
+  for (Index = 0; Index < STRING_BENCH_CHECK_RUNS; ++Index) {
+    if (!Bench->Check(Index)) {
+      Right = FALSE;
+    }
+  }
+  // Warm up the caches and the lazily created tables
+  for (Index = 0; Index < 64; ++Index) {
+    Bench->Run(Index);
+  }
+  // Run until the time passed, checking the time only every few runs
+  Allocations = HostGetAllocations();
+  Start = HostGetTime();
+  do {
+    for (Index = 0; Index < 64; ++Index) {
+      Operations += Bench->Run(Run++);
+    }
+    Elapsed = HostGetTime() - Start;
+  } while (Elapsed < Time);
+  Allocations = HostGetAllocations() - Allocations;
+  strncpy(Result->Name, Bench->Name, sizeof(Result->Name) - 1);
+  Result->Name[sizeof(Result->Name) - 1] = '\0';
+  Result->Time = (double)Elapsed / (double)Operations;
+  Result->Allocations = (double)Allocations / (double)Operations;
+  // Return to the default language
+  SetLanguage(NULL);
+  HostSetCollation(FALSE);
+  return Right;
+}
+
+int
+main (
+  int    argc,
+  char **argv
+) {
+  STRING_BENCH_RESULT  Results[ARRAY_SIZE(mStringBenches)];
+  STRING_BENCH_RESULT *Baseline;
+  CONST char          *BaselinePath = NULL;
+  FILE                *File;
+  UINT64               Time = STRING_BENCH_TIME;
+  UINTN                Index;
+  UINTN                Slower = 0;
+  UINTN                MoreAllocations = 0;
+  UINTN                Wrong = 0;
+  BOOLEAN              Update = FALSE;
+  int                  Arg;
+  for (Arg = 1; Arg < argc; ++Arg) {
+    if (strncmp(argv[Arg], "-baseline=", 10) == 0) {
+      BaselinePath = argv[Arg] + 10;
+    } else if (strncmp(argv[Arg], "-time=", 6) == 0) {
+      Time = strtoull(argv[Arg] + 6, NULL, 0);
+    } else if (strcmp(argv[Arg], "-update") == 0) {
+      Update = TRUE;
+    } else {
+      fprintf(stderr, "usage: %s [-baseline=File] [-time=Milliseconds] [-update]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (EFI_ERROR(HostLibInitialize()) || !StringBenchSetup()) {
+    fprintf(stderr, "StringBench: setup failed\n");
+    return 2;
+  }
+  if ((BaselinePath != NULL) && !Update && !StringBenchLoadBaseline(BaselinePath)) {
+    fprintf(stderr, "StringBench: no baseline %s\n", BaselinePath);
+  }
+  // Run each benchmark and compare with the baseline
+  printf("%-30s %10s %10s %10s %8s\n", argv[0], "ns/op", "allocs/op", "baseline", "change");
+  for (Index = 0; Index < ARRAY_SIZE(mStringBenches); ++Index) {
+    if (!StringBenchMeasure(mStringBenches + Index, Time * 1000000ULL, Results + Index)) {
+      printf("%-30s wrong results\n", Results[Index].Name);
+      ++Wrong;
+      continue;
+    }
+    printf("%-30s %10.1f %10.2f", Results[Index].Name, Results[Index].Time, Results[Index].Allocations);
+    Baseline = StringBenchFindBaseline(Results[Index].Name);
+    if (Baseline != NULL) {
+      printf(" %10.1f %+7.1f%%", Baseline->Time, ((Results[Index].Time - Baseline->Time) * 100.0) / Baseline->Time);
+      if (Results[Index].Time > (Baseline->Time * (100 + STRING_BENCH_TOLERANCE) / 100.0)) {
+        printf(" slower");
+        ++Slower;
+      }
+      // Allocations do not depend on the machine so any increase is a regression
+      if (Results[Index].Allocations > (Baseline->Allocations + 0.005)) {
+        printf(" more allocations than %.2f", Baseline->Allocations);
+        ++MoreAllocations;
+      }
+    }
+    printf("\n");
+  }
+  StringBenchCleanup();
+  HostLibFinish();
+  // Never write a baseline from wrong results
+  if (Wrong != 0) {
+    printf("StringBench: %u benchmarks returned wrong results\n", (unsigned)Wrong);
+    return 1;
+  }
+  // Write the results as the new baseline
+  if (Update && (BaselinePath != NULL)) {
+    File = fopen(BaselinePath, "w");
+    if (File == NULL) {
+      fprintf(stderr, "StringBench: could not write %s\n", BaselinePath);
+      return 2;
+    }
+    fprintf(File, "# %s baseline, the name, ns/op and allocs/op of each benchmark, written by make bench BENCH_ARGS=-update\n", argv[0]);
+    for (Index = 0; Index < ARRAY_SIZE(mStringBenches); ++Index) {
+      fprintf(File, "%s %.1f %.2f\n", Results[Index].Name, Results[Index].Time, Results[Index].Allocations);
+    }
+    fclose(File);
+    printf("StringBench: baseline written to %s\n", BaselinePath);
+  } else if (Slower != 0) {
+    printf("StringBench: %u benchmarks more than %u%% slower than the baseline\n", (unsigned)Slower, STRING_BENCH_TOLERANCE);
+  }
+  return (MoreAllocations == 0) ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+///
+/// @file Test/Host/Fuzz/ConfigFuzz.c
+///
+/// Fuzz target that drives the XML parser and every configuration front end with the same input
+///
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../HostLib.h"
+
+// CONFIG_FUZZ_QUERY
+/// The query run on every parsed XML document, descendant steps must stay linear in the document size
+#define CONFIG_FUZZ_QUERY L"//*//*//*"
+// CONFIG_FUZZ_SOURCE
+/// The source name used for configuration parsed by the fuzz target
+#define CONFIG_FUZZ_SOURCE L"fuzz"
+
+// ConfigFuzzParseXml
+/// Parse the input as an XML document, serialize it, and query it
+/// @param Size The size, in bytes, of the input
+/// @param Data The input
+STATIC VOID
+EFIAPI
+ConfigFuzzParseXml (
+  IN UINTN  Size,
+  IN VOID  *Data
+) {
+  XML_PARSER   *Parser = NULL;
+  XML_DOCUMENT *Document = NULL;
+  XML_TREE     *Tree = NULL;
+  XML_QUERY    *Query = NULL;
+  VOID         *Buffer = NULL;
+  UINTN         BufferSize = 0;
+  UINTN         Count = 0;
+  if (EFI_ERROR(XmlCreate(&Parser)) || (Parser == NULL)) {
+    return;
+  }
+  if (!EFI_ERROR(XmlParse(Parser, Size, Data))) {
+    // Serialize the document again
+    if (!EFI_ERROR(XmlGetDocument(Parser, &Document)) && (Document != NULL) &&
+        !EFI_ERROR(XmlDocumentSerializeToBuffer(Document, NULL, 2, &BufferSize, &Buffer)) && (Buffer != NULL)) {
+      FreePool(Buffer);
+    }
+    // Run a query with descendant steps
+    if (!EFI_ERROR(XmlGetTree(Parser, &Tree)) && (Tree != NULL) && !EFI_ERROR(XmlQueryCompile(CONFIG_FUZZ_QUERY, &Query))) {
+      XmlQuerySelect(Query, Tree, &Count, NULL);
+      XmlQueryFree(Query);
+    }
+  }
+  XmlFree(Parser);
+}
+// ConfigFuzzLoadStream
+/// Load the input as a configuration stream with small blocks and short reads
+/// @param Size The size, in bytes, of the input
+/// @param Data The input
+STATIC VOID
+EFIAPI
+ConfigFuzzLoadStream (
+  IN UINTN  Size,
+  IN VOID  *Data
+) {
+  EFI_FILE_HANDLE Handle = NULL;
+  UINTN           BlockSize;
+  UINTN           ReadLimit;
+  // Pick the block size and read limit from the input size so the corpus covers different block boundaries
+  BlockSize = CONFIG_BPLIST_MAGIC_SIZE + (Size % 61);
+  ReadLimit = 1 + (Size % 7);
+  if (!EFI_ERROR(HostFileOpenBuffer(&Handle, Size, Data, ReadLimit))) {
+    ConfigLoadStream(Handle, BlockSize, CONFIG_FUZZ_SOURCE);
+    FileHandleClose(Handle);
+    ConfigFree();
+  }
+}
+
+// LLVMFuzzerTestOneInput
+/// Run one input through the XML parser and the configuration front ends
+/// @param Data The input
+/// @param Size The size, in bytes, of the input
+/// @return Zero
+int
+LLVMFuzzerTestOneInput (
+  const UINT8 *Data,
+  size_t       Size
+) {
+  VOID *Copy;
+  if (Size == 0) {
+    return 0;
+  }
+  // The libraries are initialized for every input so the caches they build are freed before the leak check
+  if (EFI_ERROR(HostLibInitialize())) {
+    fprintf(stderr, "ConfigFuzz: failed to initialize the host libraries\n");
+    abort();
+  }
+  // Copy the input so reads past the end are caught by the sanitizers and the libraries may modify it
+  Copy = AllocateCopyPool(Size, Data);
+  if (Copy == NULL) {
+    return 0;
+  }
+  ConfigFuzzParseXml(Size, Copy);
+  ConfigParse(Size, Copy, CONFIG_FUZZ_SOURCE);
+  ConfigFree();
+  ConfigFuzzLoadStream(Size, Copy);
+  FreePool(Copy);
+  // Every allocation made for the input must have been freed
+  HostLibFinish();
+  if (HostGetLiveAllocations() != 0) {
+    fprintf(stderr, "ConfigFuzz: leaked %ld allocations\n", (long)HostGetLiveAllocations());
+    abort();
+  }
+  return 0;
+}
@@ -0,0 +1,361 @@
+///
+/// @file Test/Host/Fuzz/FuzzMain.c
+///
+/// Standalone fuzz driver for compilers without libFuzzer, runs the corpus then mutated inputs with timeout and leak checks
+///
+
+#include <dirent.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Base.h>
+
+#if defined(__SANITIZE_ADDRESS__)
+# include <sanitizer/common_interface_defs.h>
+#endif
+
+// FUZZ_MAX_INPUT_SIZE
+/// The maximum size, in bytes, of a mutated input
+#define FUZZ_MAX_INPUT_SIZE 0x10000
+// FUZZ_MAX_TOKENS
+/// The maximum count of dictionary tokens
+#define FUZZ_MAX_TOKENS 256
+// FUZZ_CRASH_FILE
+/// The file name, after the artifact prefix, where the input that crashed, leaked, or timed out is written
+#define FUZZ_CRASH_FILE "crash-input"
+
+// FUZZ_INPUT
+/// Fuzz input
+typedef struct _FUZZ_INPUT FUZZ_INPUT;
+struct _FUZZ_INPUT {
+
+  // Size
+  /// The size, in bytes, of the input
+  size_t  Size;
+  // Data
+  /// The input data
+  UINT8  *Data;
+
+};
+
+int LLVMFuzzerTestOneInput (const UINT8 *Data, size_t Size);
+
+// mFuzzCorpus
+/// The corpus inputs
+STATIC FUZZ_INPUT  *mFuzzCorpus = NULL;
+// mFuzzCorpusCount
+/// The count of corpus inputs
+STATIC size_t       mFuzzCorpusCount = 0;
+// mFuzzTokens
+/// The dictionary tokens
+STATIC FUZZ_INPUT   mFuzzTokens[FUZZ_MAX_TOKENS];
+// mFuzzTokenCount
+/// The count of dictionary tokens
+STATIC size_t       mFuzzTokenCount = 0;
+// mFuzzCurrent
+/// The input currently running
+STATIC FUZZ_INPUT   mFuzzCurrent = { 0, NULL };
+// mFuzzSeed
+/// The random state
+STATIC UINT64       mFuzzSeed = 0x9E3779B97F4A7C15ULL;
+// mFuzzArtifactPath
+/// The path where the input that crashed, leaked, or timed out is written
+STATIC char         mFuzzArtifactPath[4096] = FUZZ_CRASH_FILE;
+
+// FuzzRandom
+/// Get the next pseudo random number
+/// @param Limit The exclusive upper limit, which must not be zero
+/// @return A pseudo random number less than the limit
+STATIC size_t
+FuzzRandom (
+  IN size_t Limit
+) {
+  mFuzzSeed ^= mFuzzSeed << 13;
+  mFuzzSeed ^= mFuzzSeed >> 7;
+  mFuzzSeed ^= mFuzzSeed << 17;
+  return (size_t)(mFuzzSeed % Limit);
+}
+// FuzzSaveCurrent
+/// Write the input currently running so the failure can be reproduced
+STATIC VOID
+FuzzSaveCurrent (
+  VOID
+) {
+  FILE *File = fopen(mFuzzArtifactPath, "wb");
+  if (File != NULL) {
+    if (mFuzzCurrent.Size != 0) {
+      fwrite(mFuzzCurrent.Data, 1, mFuzzCurrent.Size, File);
+    }
+    fclose(File);
+    fprintf(stderr, "FuzzMain: input written to %s\n", mFuzzArtifactPath);
+  }
+}
+// FuzzOnSignal
+/// Save the running input when it times out or aborts
+/// @param Signal The signal
+STATIC VOID
+FuzzOnSignal (
+  IN int Signal
+) {
+  if (Signal == SIGALRM) {
+    fprintf(stderr, "FuzzMain: timeout\n");
+  }
+  FuzzSaveCurrent();
+  signal(SIGABRT, SIG_DFL);
+  abort();
+}
+// FuzzLoadFile
+/// Load a file into memory
+/// @param Path  The file path
+/// @param Input On output, the file contents
+/// @return Whether the file was loaded or not
+STATIC BOOLEAN
+FuzzLoadFile (
+  IN  CONST char *Path,
+  OUT FUZZ_INPUT *Input
+) {
+  FILE *File = fopen(Path, "rb");
+  long  Size;
+  if (File == NULL) {
+    return FALSE;
+  }
+  if ((fseek(File, 0, SEEK_END) != 0) || ((Size = ftell(File)) < 0) || (fseek(File, 0, SEEK_SET) != 0)) {
+    fclose(File);
+    return FALSE;
+  }
+  Input->Size = (size_t)Size;
+  Input->Data = (UINT8 *)malloc(Input->Size + 1);
+  if ((Input->Data == NULL) || (fread(Input->Data, 1, Input->Size, File) != Input->Size)) {
+    free(Input->Data);
+    fclose(File);
+    return FALSE;
+  }
+  fclose(File);
+  return TRUE;
+}
+// FuzzAddCorpus
+/// Add a file or every file in a directory to the corpus
+/// @param Path The file or directory path
+STATIC VOID
+FuzzAddCorpus (
+  IN CONST char *Path
+) {
+  struct stat    Info;
+  struct dirent *Entry;
+  DIR           *Directory;
+  char           Child[4096];
+  if (stat(Path, &Info) != 0) {
+    fprintf(stderr, "FuzzMain: %s not found\n", Path);
+    return;
+  }
+  if (S_ISDIR(Info.st_mode)) {
+    Directory = opendir(Path);
+    if (Directory == NULL) {
+      return;
+    }
+    while ((Entry = readdir(Directory)) != NULL) {
+      if (Entry->d_name[0] != '.') {
+        snprintf(Child, sizeof(Child), "%s/%s", Path, Entry->d_name);
+        FuzzAddCorpus(Child);
+      }
+    }
+    closedir(Directory);
+    return;
+  }
+  mFuzzCorpus = (FUZZ_INPUT *)realloc(mFuzzCorpus, (mFuzzCorpusCount + 1) * sizeof(FUZZ_INPUT));
+  if ((mFuzzCorpus != NULL) && FuzzLoadFile(Path, &mFuzzCorpus[mFuzzCorpusCount])) {
+    ++mFuzzCorpusCount;
+  }
+}
+// FuzzLoadDictionary
+/// Load dictionary tokens in the libFuzzer format, each line is a quoted string with hexadecimal escapes
+/// @param Path The dictionary file path
+STATIC VOID
+FuzzLoadDictionary (
+  IN CONST char *Path
+) {
+  FILE  *File = fopen(Path, "r");
+  char   Line[1024];
+  char  *Ptr;
+  UINT8  Token[1024];
+  size_t Size;
+  if (File == NULL) {
+    fprintf(stderr, "FuzzMain: dictionary %s not found\n", Path);
+    return;
+  }
+  while ((mFuzzTokenCount < FUZZ_MAX_TOKENS) && (fgets(Line, sizeof(Line), File) != NULL)) {
+    Ptr = strchr(Line, '"');
+    if ((Line[0] == '#') || (Ptr == NULL)) {
+      continue;
+    }
+    for (Size = 0, ++Ptr; (*Ptr != '\0') && (*Ptr != '"'); ++Ptr) {
+      if ((Ptr[0] == '\\') && (Ptr[1] == 'x') && (Ptr[2] != '\0') && (Ptr[3] != '\0')) {
+        char Hex[3] = { Ptr[2], Ptr[3], '\0' };
+        Token[Size++] = (UINT8)strtoul(Hex, NULL, 16);
+        Ptr += 3;
+      } else if ((Ptr[0] == '\\') && (Ptr[1] != '\0')) {
+        Token[Size++] = (UINT8)*++Ptr;
+      } else {
+        Token[Size++] = (UINT8)*Ptr;
+      }
+    }
+    if (Size != 0) {
+      mFuzzTokens[mFuzzTokenCount].Data = (UINT8 *)malloc(Size);
+      if (mFuzzTokens[mFuzzTokenCount].Data != NULL) {
+        memcpy(mFuzzTokens[mFuzzTokenCount].Data, Token, Size);
+        mFuzzTokens[mFuzzTokenCount++].Size = Size;
+      }
+    }
+  }
+  fclose(File);
+}
+// FuzzMutate
+/// Mutate an input with a few random byte and token edits
+/// @param Input The input to mutate, which must have room for FUZZ_MAX_INPUT_SIZE bytes
+STATIC VOID
+FuzzMutate (
+  IN OUT FUZZ_INPUT *Input
+) {
+  FUZZ_INPUT *Token;
+  size_t      Count = 1 + FuzzRandom(4);
+  size_t      Offset;
+  size_t      Length;
+  while (Count-- > 0) {
+    Offset = FuzzRandom(Input->Size + 1);
+    switch (FuzzRandom(6)) {
+      case 0:
+        // Flip a bit
+        if (Offset < Input->Size) {
+          Input->Data[Offset] ^= (UINT8)(1 << FuzzRandom(8));
+        }
+        break;
+
+      case 1:
+        // Set a random byte
+        if (Offset < Input->Size) {
+          Input->Data[Offset] = (UINT8)FuzzRandom(256);
+        }
+        break;
+
+      case 2:
+        // Remove some bytes
+        Length = FuzzRandom(16);
+        if ((Offset + Length) <= Input->Size) {
+          memmove(Input->Data + Offset, Input->Data + Offset + Length, Input->Size - Offset - Length);
+          Input->Size -= Length;
+        }
+        break;
+
+      case 3:
+        // Duplicate some bytes
+        Length = FuzzRandom(64);
+        if (((Offset + Length) <= Input->Size) && ((Input->Size + Length) <= FUZZ_MAX_INPUT_SIZE)) {
+          memmove(Input->Data + Offset + Length, Input->Data + Offset, Input->Size - Offset);
+          Input->Size += Length;
+        }
+        break;
+
+      default:
+        // Insert a dictionary token
+        if (mFuzzTokenCount != 0) {
+          Token = &mFuzzTokens[FuzzRandom(mFuzzTokenCount)];
+          if ((Input->Size + Token->Size) <= FUZZ_MAX_INPUT_SIZE) {
+            memmove(Input->Data + Offset + Token->Size, Input->Data + Offset, Input->Size - Offset);
+            memcpy(Input->Data + Offset, Token->Data, Token->Size);
+            Input->Size += Token->Size;
+          }
+        }
+        break;
+    }
+  }
+}
+// FuzzRun
+/// Run one input with the timeout
+/// @param Data    The input
+/// @param Size    The size, in bytes, of the input
+/// @param Timeout The timeout in seconds or zero for no timeout
+STATIC VOID
+FuzzRun (
+  IN UINT8  *Data,
+  IN size_t  Size,
+  IN UINTN   Timeout
+) {
+  mFuzzCurrent.Data = Data;
+  mFuzzCurrent.Size = Size;
+  alarm((unsigned)Timeout);
+  LLVMFuzzerTestOneInput(Data, Size);
+  alarm(0);
+}
+
+// main
+/// Run the corpus then mutated inputs, options match the libFuzzer options of the same name
+///  -runs=N, -timeout=N, -seed=N, -dict=FILE, -artifact_prefix=PATH
+int
+main (
+  int    argc,
+  char **argv
+) {
+  UINT8  *Buffer;
+  size_t  Runs = 0;
+  size_t  Index;
+  UINTN   Timeout = 10;
+  int     Arg;
+  signal(SIGALRM, FuzzOnSignal);
+  signal(SIGABRT, FuzzOnSignal);
+#if defined(__SANITIZE_ADDRESS__)
+  __sanitizer_set_death_callback(FuzzSaveCurrent);
+#endif
+  for (Arg = 1; Arg < argc; ++Arg) {
+    if (strncmp(argv[Arg], "-runs=", 6) == 0) {
+      Runs = strtoul(argv[Arg] + 6, NULL, 0);
+    } else if (strncmp(argv[Arg], "-timeout=", 9) == 0) {
+      Timeout = strtoul(argv[Arg] + 9, NULL, 0);
+    } else if (strncmp(argv[Arg], "-seed=", 6) == 0) {
+      mFuzzSeed = strtoull(argv[Arg] + 6, NULL, 0) | 1;
+    } else if (strncmp(argv[Arg], "-dict=", 6) == 0) {
+      FuzzLoadDictionary(argv[Arg] + 6);
+    } else if (strncmp(argv[Arg], "-artifact_prefix=", 17) == 0) {
+      snprintf(mFuzzArtifactPath, sizeof(mFuzzArtifactPath), "%s%s", argv[Arg] + 17, FUZZ_CRASH_FILE);
+    } else if (argv[Arg][0] != '-') {
+      FuzzAddCorpus(argv[Arg]);
+    }
+  }
+  if (mFuzzCorpusCount == 0) {
+    fprintf(stderr, "usage: %s [-runs=N] [-timeout=N] [-seed=N] [-dict=FILE] [-artifact_prefix=PATH] CORPUS...\n", argv[0]);
+    return 1;
+  }
+  // Run every corpus input first
+  for (Index = 0; Index < mFuzzCorpusCount; ++Index) {
+    FuzzRun(mFuzzCorpus[Index].Data, mFuzzCorpus[Index].Size, Timeout);
+  }
+  fprintf(stderr, "FuzzMain: %zu corpus inputs passed\n", mFuzzCorpusCount);
+  if (Runs == 0) {
+    return 0;
+  }
+  // Run mutated corpus inputs
+  Buffer = (UINT8 *)malloc(FUZZ_MAX_INPUT_SIZE);
+  if (Buffer == NULL) {
+    return 1;
+  }
+  for (Index = 0; Index < Runs; ++Index) {
+    FUZZ_INPUT *Seed = &mFuzzCorpus[FuzzRandom(mFuzzCorpusCount)];
+    FUZZ_INPUT  Input = { MIN(Seed->Size, (size_t)FUZZ_MAX_INPUT_SIZE), Buffer };
+    memcpy(Input.Data, Seed->Data, Input.Size);
+    FuzzMutate(&Input);
+    FuzzRun(Input.Data, Input.Size, Timeout);
+  }
+  fprintf(stderr, "FuzzMain: %zu mutated inputs passed\n", Runs);
+  free(Buffer);
+  for (Index = 0; Index < mFuzzCorpusCount; ++Index) {
+    free(mFuzzCorpus[Index].Data);
+  }
+  free(mFuzzCorpus);
+  for (Index = 0; Index < mFuzzTokenCount; ++Index) {
+    free(mFuzzTokens[Index].Data);
+  }
+  return 0;
+}
@@ -0,0 +1,1859 @@
+///
+/// @file Test/Host/HostLib.c
+///
+/// Host library to build and test the string, parse, XML, and configuration libraries outside of firmware
+///
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__SANITIZE_ADDRESS__)
+# include <sanitizer/common_interface_defs.h>
+#endif
+
+#include "HostLib.h"
+
+#include <Guid/GlobalVariable.h>
+
+#include <Protocol/UnicodeCollation.h>
+
+#include <Library/LogLib.h>
+#include <Library/PlatformLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+// HOST_PRINT_STACK
+/// Print the stack trace when built with the address sanitizer
+#if defined(__SANITIZE_ADDRESS__)
+# define HOST_PRINT_STACK() __sanitizer_print_stack_trace()
+#else
+# define HOST_PRINT_STACK()
+#endif
+// HOST_ASSERT
+/// Abort when a constraint that firmware debug builds assert is violated so the sanitizers and fuzzers report it
+#define HOST_ASSERT(Expression) do { \
+  if (!(Expression)) { \
+    fprintf(stderr, "%s:%u: %s: assertion failed: %s\n", __FILE__, __LINE__, __func__, #Expression); \
+    HOST_PRINT_STACK(); \
+    abort(); \
+  } \
+} while (0)
+// HOST_TO_UPPER
+/// Convert a basic latin or latin-1 character to upper case like the english collation protocol
+#define HOST_TO_UPPER(a) (CHAR16)(((((a) >= L'a') && ((a) <= L'z')) || (((a) >= 0xE0) && ((a) <= 0xFE) && ((a) != 0xF7))) ? ((a) - 0x20) : (a))
+// HOST_TO_LOWER
+/// Convert a basic latin or latin-1 character to lower case like the english collation protocol
+#define HOST_TO_LOWER(a) (CHAR16)(((((a) >= L'A') && ((a) <= L'Z')) || (((a) >= 0xC0) && ((a) <= 0xDE) && ((a) != 0xD7))) ? ((a) + 0x20) : (a))
+// ASCII_TO_UPPER
+/// Convert an ASCII character to upper case
+#define ASCII_TO_UPPER(a) (CHAR8)((((a) >= 'a') && ((a) <= 'z')) ? ((a) - 0x20) : (a))
+
+// HOST_VARIABLE
+/// Variable in the host variable store
+typedef struct _HOST_VARIABLE HOST_VARIABLE;
+struct _HOST_VARIABLE {
+
+  // Next
+  /// The next variable
+  HOST_VARIABLE *Next;
+  // Name
+  /// The variable name
+  CHAR16        *Name;
+  // Size
+  /// The size, in bytes, of the variable data
+  UINTN          Size;
+  // Data
+  /// The variable data
+  VOID          *Data;
+
+};
+
+// _EFI_FILE_PROTOCOL
+/// Host file handle backed by a standard library stream
+struct _EFI_FILE_PROTOCOL {
+
+  // File
+  /// The standard library stream
+  FILE   *File;
+  // Name
+  /// The file name
+  CHAR16 *Name;
+  // ReadLimit
+  /// The maximum size, in bytes, returned by each read or zero for no limit
+  UINTN   ReadLimit;
+
+};
+
+EFI_HANDLE            gImageHandle = NULL;
+EFI_SYSTEM_TABLE     *gST = NULL;
+EFI_BOOT_SERVICES    *gBS = NULL;
+EFI_RUNTIME_SERVICES *gRT = NULL;
+
+EFI_GUID gEfiGlobalVariableGuid = { 0x8BE4DF61, 0x93CA, 0x11D2, { 0xAA, 0x0D, 0x00, 0xE0, 0x98, 0x03, 0x2B, 0x8C } };
+EFI_GUID gEfiUnicodeCollation2ProtocolGuid = { 0xA4C751FC, 0x23AE, 0x4C3E, { 0x92, 0xE9, 0x49, 0x64, 0xCF, 0x63, 0xF3, 0x49 } };
+
+// mHostAllocations
+/// The count of allocations
+STATIC UINT64         mHostAllocations = 0;
+// mHostLiveAllocations
+/// The count of allocations that have not been freed
+STATIC INTN           mHostLiveAllocations = 0;
+// mHostVariables
+/// The host variable store
+STATIC HOST_VARIABLE *mHostVariables = NULL;
+// mHostVariableWrites
+/// The count of variable writes through the runtime services
+STATIC UINTN          mHostVariableWrites = 0;
+// mHostProtocolSearches
+/// The count of protocol handle searches through the boot services
+STATIC UINTN          mHostProtocolSearches = 0;
+// mHostCollationInstalled
+/// Whether the host collation protocol can be located
+STATIC BOOLEAN        mHostCollationInstalled = FALSE;
+// mHostVerbose
+/// Whether log output is printed
+STATIC BOOLEAN        mHostVerbose = FALSE;
+// mHostHandle
+/// The handle returned for installed protocols
+STATIC UINTN          mHostHandle = 0;
+
+extern EFI_STATUS EFIAPI StringLibInitialize (VOID);
+extern EFI_STATUS EFIAPI StringLibFinish (VOID);
+extern EFI_STATUS EFIAPI ParseLibInitialize (VOID);
+extern EFI_STATUS EFIAPI ParseLibFinish (VOID);
+extern EFI_STATUS EFIAPI XmlLibInitialize (VOID);
+extern EFI_STATUS EFIAPI XmlLibFinish (VOID);
+extern EFI_STATUS EFIAPI ConfigLibInitialize (VOID);
+extern EFI_STATUS EFIAPI ConfigLibFinish (VOID);
+
+//
+// Memory allocation library
+//
+
+VOID *
+EFIAPI
+AllocatePool (
+  IN UINTN AllocationSize
+) {
+  VOID *Buffer = malloc((AllocationSize == 0) ? 1 : AllocationSize);
+  if (Buffer != NULL) {
+    ++mHostAllocations;
+    ++mHostLiveAllocations;
+  }
+  return Buffer;
+}
+VOID *
+EFIAPI
+AllocateZeroPool (
+  IN UINTN AllocationSize
+) {
+  VOID *Buffer = AllocatePool(AllocationSize);
+  if (Buffer != NULL) {
+    memset(Buffer, 0, AllocationSize);
+  }
+  return Buffer;
+}
+VOID *
+EFIAPI
+AllocateCopyPool (
+  IN UINTN       AllocationSize,
+  IN CONST VOID *Buffer
+) {
+  VOID *Copy;
+  HOST_ASSERT(Buffer != NULL);
+  Copy = AllocatePool(AllocationSize);
+  if (Copy != NULL) {
+    memcpy(Copy, Buffer, AllocationSize);
+  }
+  return Copy;
+}
+VOID *
+EFIAPI
+ReallocatePool (
+  IN UINTN  OldSize,
+  IN UINTN  NewSize,
+  IN VOID  *OldBuffer OPTIONAL
+) {
+  // Allocate, copy, and free like firmware so the sanitizers check the old size
+  VOID *Buffer = AllocatePool(NewSize);
+  if ((Buffer != NULL) && (OldBuffer != NULL)) {
+    memcpy(Buffer, OldBuffer, MIN(OldSize, NewSize));
+    FreePool(OldBuffer);
+  }
+  return Buffer;
+}
+VOID
+EFIAPI
+FreePool (
+  IN VOID *Buffer
+) {
+  HOST_ASSERT(Buffer != NULL);
+  --mHostLiveAllocations;
+  free(Buffer);
+}
+
+//
+// Base memory library
+//
+
+VOID *
+EFIAPI
+CopyMem (
+  OUT VOID       *Destination,
+  IN  CONST VOID *Source,
+  IN  UINTN       Length
+) {
+  return (Length == 0) ? Destination : memmove(Destination, Source, Length);
+}
+VOID *
+EFIAPI
+SetMem (
+  OUT VOID  *Buffer,
+  IN  UINTN  Length,
+  IN  UINT8  Value
+) {
+  return (Length == 0) ? Buffer : memset(Buffer, Value, Length);
+}
+VOID *
+EFIAPI
+SetMem16 (
+  OUT VOID   *Buffer,
+  IN  UINTN   Length,
+  IN  UINT16  Value
+) {
+  UINTN Index;
+  for (Index = 0; Index < (Length / sizeof(UINT16)); ++Index) {
+    ((UINT16 *)Buffer)[Index] = Value;
+  }
+  return Buffer;
+}
+VOID *
+EFIAPI
+SetMem32 (
+  OUT VOID   *Buffer,
+  IN  UINTN   Length,
+  IN  UINT32  Value
+) {
+  UINTN Index;
+  for (Index = 0; Index < (Length / sizeof(UINT32)); ++Index) {
+    ((UINT32 *)Buffer)[Index] = Value;
+  }
+  return Buffer;
+}
+VOID *
+EFIAPI
+ZeroMem (
+  OUT VOID  *Buffer,
+  IN  UINTN  Length
+) {
+  return (Length == 0) ? Buffer : memset(Buffer, 0, Length);
+}
+INTN
+EFIAPI
+CompareMem (
+  IN CONST VOID *DestinationBuffer,
+  IN CONST VOID *SourceBuffer,
+  IN UINTN       Length
+) {
+  CONST UINT8 *Destination = (CONST UINT8 *)DestinationBuffer;
+  CONST UINT8 *Source = (CONST UINT8 *)SourceBuffer;
+  UINTN        Index;
+  for (Index = 0; Index < Length; ++Index) {
+    if (Destination[Index] != Source[Index]) {
+      return (INTN)Destination[Index] - (INTN)Source[Index];
+    }
+  }
+  return 0;
+}
+
+//
+// Base library
+//
+
+UINTN
+EFIAPI
+StrLen (
+  IN CONST CHAR16 *String
+) {
+  UINTN Length = 0;
+  HOST_ASSERT(String != NULL);
+  while (String[Length] != L'\0') {
+    ++Length;
+  }
+  return Length;
+}
+UINTN
+EFIAPI
+StrSize (
+  IN CONST CHAR16 *String
+) {
+  return (StrLen(String) + 1) * sizeof(CHAR16);
+}
+INTN
+EFIAPI
+StrCmp (
+  IN CONST CHAR16 *FirstString,
+  IN CONST CHAR16 *SecondString
+) {
+  HOST_ASSERT((FirstString != NULL) && (SecondString != NULL));
+  while ((*FirstString != L'\0') && (*FirstString == *SecondString)) {
+    ++FirstString;
+    ++SecondString;
+  }
+  return (INTN)*FirstString - (INTN)*SecondString;
+}
+INTN
+EFIAPI
+StrnCmp (
+  IN CONST CHAR16 *FirstString,
+  IN CONST CHAR16 *SecondString,
+  IN UINTN         Length
+) {
+  if (Length == 0) {
+    return 0;
+  }
+  HOST_ASSERT((FirstString != NULL) && (SecondString != NULL));
+  while ((*FirstString != L'\0') && (*FirstString == *SecondString) && (--Length > 0)) {
+    ++FirstString;
+    ++SecondString;
+  }
+  return (INTN)*FirstString - (INTN)*SecondString;
+}
+CHAR16 *
+EFIAPI
+StrStr (
+  IN CONST CHAR16 *String,
+  IN CONST CHAR16 *SearchString
+) {
+  UINTN Length = StrLen(SearchString);
+  HOST_ASSERT(String != NULL);
+  for (; *String != L'\0'; ++String) {
+    if (StrnCmp(String, SearchString, Length) == 0) {
+      return (CHAR16 *)String;
+    }
+  }
+  return (Length == 0) ? (CHAR16 *)String : NULL;
+}
+RETURN_STATUS
+EFIAPI
+StrnCpyS (
+  OUT CHAR16       *Destination,
+  IN  UINTN         DestMax,
+  IN  CONST CHAR16 *Source,
+  IN  UINTN         Length
+) {
+  UINTN Count = 0;
+  HOST_ASSERT((Destination != NULL) && (Source != NULL) && (DestMax != 0));
+  while ((Count < Length) && (Source[Count] != L'\0')) {
+    ++Count;
+  }
+  HOST_ASSERT(DestMax > Count);
+  HOST_ASSERT(((Destination + DestMax) <= Source) || ((Source + Count) < Destination));
+  memcpy(Destination, Source, Count * sizeof(CHAR16));
+  Destination[Count] = L'\0';
+  return RETURN_SUCCESS;
+}
+RETURN_STATUS
+EFIAPI
+StrCpyS (
+  OUT CHAR16       *Destination,
+  IN  UINTN         DestMax,
+  IN  CONST CHAR16 *Source
+) {
+  return StrnCpyS(Destination, DestMax, Source, MAX_UINTN);
+}
+RETURN_STATUS
+EFIAPI
+StrCatS (
+  IN OUT CHAR16       *Destination,
+  IN     UINTN         DestMax,
+  IN     CONST CHAR16 *Source
+) {
+  UINTN Length = StrLen(Destination);
+  HOST_ASSERT(DestMax > Length);
+  return StrCpyS(Destination + Length, DestMax - Length, Source);
+}
+UINTN
+EFIAPI
+StrDecimalToUintn (
+  IN CONST CHAR16 *String
+) {
+  UINTN Result = 0;
+  HOST_ASSERT(String != NULL);
+  while ((*String == L' ') || (*String == L'\t')) {
+    ++String;
+  }
+  for (; (*String >= L'0') && (*String <= L'9'); ++String) {
+    if (Result > ((MAX_UINTN - (*String - L'0')) / 10)) {
+      return MAX_UINTN;
+    }
+    Result = (Result * 10) + (*String - L'0');
+  }
+  return Result;
+}
+UINTN
+EFIAPI
+StrHexToUintn (
+  IN CONST CHAR16 *String
+) {
+  UINTN Result = 0;
+  UINTN Digit;
+  HOST_ASSERT(String != NULL);
+  while ((*String == L' ') || (*String == L'\t')) {
+    ++String;
+  }
+  while (*String == L'0') {
+    ++String;
+  }
+  if ((*String == L'x') || (*String == L'X')) {
+    // The prefix is only valid after a zero so anything else is not a number
+    if (String[-1] != L'0') {
+      return 0;
+    }
+    ++String;
+  }
+  for (;; ++String) {
+    if ((*String >= L'0') && (*String <= L'9')) {
+      Digit = *String - L'0';
+    } else if ((*String >= L'a') && (*String <= L'f')) {
+      Digit = *String - L'a' + 10;
+    } else if ((*String >= L'A') && (*String <= L'F')) {
+      Digit = *String - L'A' + 10;
+    } else {
+      break;
+    }
+    if (Result > (MAX_UINTN >> 4)) {
+      return MAX_UINTN;
+    }
+    Result = (Result << 4) | Digit;
+  }
+  return Result;
+}
+CHAR16
+EFIAPI
+CharToUpper (
+  IN CHAR16 Char
+) {
+  return ((Char >= L'a') && (Char <= L'z')) ? (CHAR16)(Char - 0x20) : Char;
+}
+
+UINTN
+EFIAPI
+AsciiStrLen (
+  IN CONST CHAR8 *String
+) {
+  HOST_ASSERT(String != NULL);
+  return strlen(String);
+}
+UINTN
+EFIAPI
+AsciiStrSize (
+  IN CONST CHAR8 *String
+) {
+  return AsciiStrLen(String) + 1;
+}
+INTN
+EFIAPI
+AsciiStrCmp (
+  IN CONST CHAR8 *FirstString,
+  IN CONST CHAR8 *SecondString
+) {
+  HOST_ASSERT((FirstString != NULL) && (SecondString != NULL));
+  while ((*FirstString != '\0') && (*FirstString == *SecondString)) {
+    ++FirstString;
+    ++SecondString;
+  }
+  return (INTN)(UINT8)*FirstString - (INTN)(UINT8)*SecondString;
+}
+INTN
+EFIAPI
+AsciiStrnCmp (
+  IN CONST CHAR8 *FirstString,
+  IN CONST CHAR8 *SecondString,
+  IN UINTN        Length
+) {
+  if (Length == 0) {
+    return 0;
+  }
+  HOST_ASSERT((FirstString != NULL) && (SecondString != NULL));
+  while ((*FirstString != '\0') && (*FirstString == *SecondString) && (--Length > 0)) {
+    ++FirstString;
+    ++SecondString;
+  }
+  return (INTN)(UINT8)*FirstString - (INTN)(UINT8)*SecondString;
+}
+INTN
+EFIAPI
+AsciiStriCmp (
+  IN CONST CHAR8 *FirstString,
+  IN CONST CHAR8 *SecondString
+) {
+  HOST_ASSERT((FirstString != NULL) && (SecondString != NULL));
+  while ((*FirstString != '\0') && (ASCII_TO_UPPER(*FirstString) == ASCII_TO_UPPER(*SecondString))) {
+    ++FirstString;
+    ++SecondString;
+  }
+  return (INTN)(UINT8)ASCII_TO_UPPER(*FirstString) - (INTN)(UINT8)ASCII_TO_UPPER(*SecondString);
+}
+CHAR8 *
+EFIAPI
+AsciiStrStr (
+  IN CONST CHAR8 *String,
+  IN CONST CHAR8 *SearchString
+) {
+  HOST_ASSERT((String != NULL) && (SearchString != NULL));
+  return strstr(String, SearchString);
+}
+RETURN_STATUS
+EFIAPI
+AsciiStrnCpyS (
+  OUT CHAR8       *Destination,
+  IN  UINTN        DestMax,
+  IN  CONST CHAR8 *Source,
+  IN  UINTN        Length
+) {
+  UINTN Count = 0;
+  HOST_ASSERT((Destination != NULL) && (Source != NULL) && (DestMax != 0));
+  while ((Count < Length) && (Source[Count] != '\0')) {
+    ++Count;
+  }
+  HOST_ASSERT(DestMax > Count);
+  HOST_ASSERT(((Destination + DestMax) <= Source) || ((Source + Count) < Destination));
+  memcpy(Destination, Source, Count);
+  Destination[Count] = '\0';
+  return RETURN_SUCCESS;
+}
+RETURN_STATUS
+EFIAPI
+AsciiStrCpyS (
+  OUT CHAR8       *Destination,
+  IN  UINTN        DestMax,
+  IN  CONST CHAR8 *Source
+) {
+  return AsciiStrnCpyS(Destination, DestMax, Source, MAX_UINTN);
+}
+RETURN_STATUS
+EFIAPI
+AsciiStrCatS (
+  IN OUT CHAR8       *Destination,
+  IN     UINTN        DestMax,
+  IN     CONST CHAR8 *Source
+) {
+  UINTN Length = AsciiStrLen(Destination);
+  HOST_ASSERT(DestMax > Length);
+  return AsciiStrCpyS(Destination + Length, DestMax - Length, Source);
+}
+CHAR8
+EFIAPI
+AsciiCharToUpper (
+  IN CHAR8 Char
+) {
+  return ASCII_TO_UPPER(Char);
+}
+
+RETURN_STATUS
+EFIAPI
+UnicodeStrnToAsciiStrS (
+  IN  CONST CHAR16 *Source,
+  IN  UINTN         Length,
+  OUT CHAR8        *Destination,
+  IN  UINTN         DestMax,
+  OUT UINTN        *DestinationLength
+) {
+  UINTN Count = 0;
+  HOST_ASSERT((Source != NULL) && (Destination != NULL) && (DestMax != 0));
+  while ((Count < Length) && (Source[Count] != L'\0')) {
+    HOST_ASSERT(Source[Count] < 0x100);
+    HOST_ASSERT(Count < (DestMax - 1));
+    Destination[Count] = (CHAR8)Source[Count];
+    ++Count;
+  }
+  Destination[Count] = '\0';
+  if (DestinationLength != NULL) {
+    *DestinationLength = Count;
+  }
+  return RETURN_SUCCESS;
+}
+RETURN_STATUS
+EFIAPI
+UnicodeStrToAsciiStrS (
+  IN  CONST CHAR16 *Source,
+  OUT CHAR8        *Destination,
+  IN  UINTN         DestMax
+) {
+  return UnicodeStrnToAsciiStrS(Source, MAX_UINTN, Destination, DestMax, NULL);
+}
+RETURN_STATUS
+EFIAPI
+AsciiStrnToUnicodeStrS (
+  IN  CONST CHAR8 *Source,
+  IN  UINTN        Length,
+  OUT CHAR16      *Destination,
+  IN  UINTN        DestMax,
+  OUT UINTN       *DestinationLength
+) {
+  UINTN Count = 0;
+  HOST_ASSERT((Source != NULL) && (Destination != NULL) && (DestMax != 0));
+  while ((Count < Length) && (Source[Count] != '\0')) {
+    HOST_ASSERT(Count < (DestMax - 1));
+    Destination[Count] = (UINT8)Source[Count];
+    ++Count;
+  }
+  Destination[Count] = L'\0';
+  if (DestinationLength != NULL) {
+    *DestinationLength = Count;
+  }
+  return RETURN_SUCCESS;
+}
+RETURN_STATUS
+EFIAPI
+AsciiStrToUnicodeStrS (
+  IN  CONST CHAR8 *Source,
+  OUT CHAR16      *Destination,
+  IN  UINTN        DestMax
+) {
+  return AsciiStrnToUnicodeStrS(Source, MAX_UINTN, Destination, DestMax, NULL);
+}
+
+UINT64
+EFIAPI
+LShiftU64 (
+  IN UINT64 Operand,
+  IN UINTN  Count
+) {
+  HOST_ASSERT(Count < 64);
+  return Operand << Count;
+}
+UINT64
+EFIAPI
+RShiftU64 (
+  IN UINT64 Operand,
+  IN UINTN  Count
+) {
+  HOST_ASSERT(Count < 64);
+  return Operand >> Count;
+}
+UINT64
+EFIAPI
+MultU64x32 (
+  IN UINT64 Multiplicand,
+  IN UINT32 Multiplier
+) {
+  return Multiplicand * Multiplier;
+}
+UINT64
+EFIAPI
+MultU64x64 (
+  IN UINT64 Multiplicand,
+  IN UINT64 Multiplier
+) {
+  return Multiplicand * Multiplier;
+}
+UINT64
+EFIAPI
+DivU64x32 (
+  IN UINT64 Dividend,
+  IN UINT32 Divisor
+) {
+  HOST_ASSERT(Divisor != 0);
+  return Dividend / Divisor;
+}
+UINT64
+EFIAPI
+DivU64x64Remainder (
+  IN  UINT64  Dividend,
+  IN  UINT64  Divisor,
+  OUT UINT64 *Remainder OPTIONAL
+) {
+  HOST_ASSERT(Divisor != 0);
+  if (Remainder != NULL) {
+    *Remainder = Dividend % Divisor;
+  }
+  return Dividend / Divisor;
+}
+
+//
+// Print library, the subset of format specifiers used by the libraries
+//
+
+// HostPrintCharacter
+/// Append a character to a print buffer, the count is always advanced so the required length is known
+/// @param Buffer The print buffer or NULL to only count
+/// @param Size   The count of characters available in the buffer, including the null-terminator
+/// @param Count  On input, the count of characters printed, on output, the count advanced by one
+/// @param Char   The character to print
+STATIC VOID
+EFIAPI
+HostPrintCharacter (
+  IN     CHAR16 *Buffer OPTIONAL,
+  IN     UINTN   Size,
+  IN OUT UINTN  *Count,
+  IN     CHAR16  Char
+) {
+  if ((Buffer != NULL) && ((*Count + 1) < Size)) {
+    Buffer[*Count] = Char;
+  }
+  ++(*Count);
+}
+// HostVSPrint
+/// Print formatted text to a buffer
+/// @param Buffer The print buffer or NULL to only count
+/// @param Size   The count of characters available in the buffer, including the null-terminator
+/// @param Format The format specifier for formatting the text
+/// @param Marker The parameters for the format string
+/// @return The count of characters needed for the formatted text, excluding the null-terminator
+STATIC UINTN
+EFIAPI
+HostVSPrint (
+  OUT CHAR16       *Buffer OPTIONAL,
+  IN  UINTN         Size,
+  IN  CONST CHAR16 *Format,
+  IN  VA_LIST       Marker
+) {
+  CHAR8   Number[32];
+  CHAR8   Specifier[16];
+  UINTN   Count = 0;
+  UINTN   Index;
+  UINTN   Width;
+  BOOLEAN LeftJustify;
+  BOOLEAN ZeroPad;
+  BOOLEAN Long;
+  HOST_ASSERT(Format != NULL);
+  for (; *Format != L'\0'; ++Format) {
+    if (*Format != L'%') {
+      HostPrintCharacter(Buffer, Size, &Count, *Format);
+      continue;
+    }
+    // Parse the flags, width, and size of the specifier
+    LeftJustify = FALSE;
+    ZeroPad = FALSE;
+    Long = FALSE;
+    Width = 0;
+    for (++Format; ; ++Format) {
+      if (*Format == L'-') {
+        LeftJustify = TRUE;
+      } else if (*Format == L'0') {
+        ZeroPad = TRUE;
+      } else if ((*Format == L',') || (*Format == L' ') || (*Format == L'+')) {
+        continue;
+      } else {
+        break;
+      }
+    }
+    if (*Format == L'*') {
+      Width = VA_ARG(Marker, UINTN);
+      ++Format;
+    } else {
+      while ((*Format >= L'0') && (*Format <= L'9')) {
+        Width = (Width * 10) + (*Format++ - L'0');
+      }
+    }
+    if ((*Format == L'l') || (*Format == L'L')) {
+      Long = TRUE;
+      ++Format;
+    }
+    *Number = '\0';
+    switch (*Format) {
+      case L's':
+      case L'S': {
+        CONST CHAR16 *String = VA_ARG(Marker, CONST CHAR16 *);
+        UINTN         Length;
+        if (String == NULL) {
+          String = L"<null string>";
+        }
+        Length = StrLen(String);
+        for (Index = Length; !LeftJustify && (Index < Width); ++Index) {
+          HostPrintCharacter(Buffer, Size, &Count, L' ');
+        }
+        for (Index = 0; Index < Length; ++Index) {
+          HostPrintCharacter(Buffer, Size, &Count, String[Index]);
+        }
+        for (Index = Length; LeftJustify && (Index < Width); ++Index) {
+          HostPrintCharacter(Buffer, Size, &Count, L' ');
+        }
+        continue;
+      }
+
+      case L'a': {
+        CONST CHAR8 *String = VA_ARG(Marker, CONST CHAR8 *);
+        UINTN        Length;
+        if (String == NULL) {
+          String = "<null string>";
+        }
+        Length = AsciiStrLen(String);
+        for (Index = Length; !LeftJustify && (Index < Width); ++Index) {
+          HostPrintCharacter(Buffer, Size, &Count, L' ');
+        }
+        for (Index = 0; Index < Length; ++Index) {
+          HostPrintCharacter(Buffer, Size, &Count, (UINT8)String[Index]);
+        }
+        for (Index = Length; LeftJustify && (Index < Width); ++Index) {
+          HostPrintCharacter(Buffer, Size, &Count, L' ');
+        }
+        continue;
+      }
+
+      case L'c':
+        HostPrintCharacter(Buffer, Size, &Count, (CHAR16)(VA_ARG(Marker, UINTN) & 0xFFFF));
+        continue;
+
+      case L'd':
+      case L'i':
+        snprintf(Specifier, sizeof(Specifier), "%%%s%s*lld", LeftJustify ? "-" : "", ZeroPad ? "0" : "");
+        snprintf(Number, sizeof(Number), Specifier, (int)Width, Long ? (long long)VA_ARG(Marker, INT64) : (long long)VA_ARG(Marker, int));
+        break;
+
+      case L'u':
+      case L'x':
+      case L'X':
+        snprintf(Specifier, sizeof(Specifier), "%%%s%s*ll%c", LeftJustify ? "-" : "", ZeroPad ? "0" : "", (*Format == L'u') ? 'u' : (CHAR8)*Format);
+        snprintf(Number, sizeof(Number), Specifier, (int)Width, Long ? (unsigned long long)VA_ARG(Marker, UINT64) : (unsigned long long)VA_ARG(Marker, unsigned int));
+        break;
+
+      case L'p':
+        snprintf(Number, sizeof(Number), "%p", VA_ARG(Marker, VOID *));
+        break;
+
+      case L'r':
+        snprintf(Number, sizeof(Number), "status 0x%llX", (unsigned long long)VA_ARG(Marker, RETURN_STATUS));
+        break;
+
+      case L'%':
+        HostPrintCharacter(Buffer, Size, &Count, L'%');
+        continue;
+
+      default:
+        // Unsupported specifiers are a bug in the caller or in this library so make them visible
+        HOST_ASSERT(*Format == L'%');
+        continue;
+    }
+    for (Index = 0; Number[Index] != '\0'; ++Index) {
+      HostPrintCharacter(Buffer, Size, &Count, (UINT8)Number[Index]);
+    }
+  }
+  if ((Buffer != NULL) && (Size != 0)) {
+    Buffer[MIN(Count, Size - 1)] = L'\0';
+  }
+  return Count;
+}
+
+UINTN
+EFIAPI
+SPrintLength (
+  IN CONST CHAR16 *FormatString,
+  IN VA_LIST       Marker
+) {
+  VA_LIST Copy;
+  UINTN   Length;
+  VA_COPY(Copy, Marker);
+  Length = HostVSPrint(NULL, 0, FormatString, Copy);
+  VA_END(Copy);
+  return Length;
+}
+UINTN
+EFIAPI
+UnicodeVSPrint (
+  OUT CHAR16       *StartOfBuffer,
+  IN  UINTN         BufferSize,
+  IN  CONST CHAR16 *FormatString,
+  IN  VA_LIST       Marker
+) {
+  UINTN Size = BufferSize / sizeof(CHAR16);
+  UINTN Length;
+  HOST_ASSERT((StartOfBuffer != NULL) && (Size != 0));
+  Length = HostVSPrint(StartOfBuffer, Size, FormatString, Marker);
+  return MIN(Length, Size - 1);
+}
+UINTN
+EFIAPI
+UnicodeSPrint (
+  OUT CHAR16       *StartOfBuffer,
+  IN  UINTN         BufferSize,
+  IN  CONST CHAR16 *FormatString,
+  ...
+) {
+  VA_LIST Marker;
+  UINTN   Length;
+  VA_START(Marker, FormatString);
+  Length = UnicodeVSPrint(StartOfBuffer, BufferSize, FormatString, Marker);
+  VA_END(Marker);
+  return Length;
+}
+
+//
+// UEFI library
+//
+
+CHAR16 *
+EFIAPI
+CatVSPrint (
+  IN CHAR16       *String OPTIONAL,
+  IN CONST CHAR16 *FormatString,
+  IN VA_LIST       Marker
+) {
+  CHAR16 *Result;
+  UINTN   Offset = (String == NULL) ? 0 : StrLen(String);
+  UINTN   Length = SPrintLength(FormatString, Marker);
+  Result = (CHAR16 *)AllocatePool((Offset + Length + 1) * sizeof(CHAR16));
+  if (Result == NULL) {
+    return NULL;
+  }
+  if (String != NULL) {
+    CopyMem(Result, String, Offset * sizeof(CHAR16));
+    FreePool(String);
+  }
+  HostVSPrint(Result + Offset, Length + 1, FormatString, Marker);
+  return Result;
+}
+CHAR16 *
+EFIAPI
+CatSPrint (
+  IN CHAR16       *String OPTIONAL,
+  IN CONST CHAR16 *FormatString,
+  ...
+) {
+  VA_LIST  Marker;
+  CHAR16  *Result;
+  VA_START(Marker, FormatString);
+  Result = CatVSPrint(String, FormatString, Marker);
+  VA_END(Marker);
+  return Result;
+}
+EFI_STATUS
+EFIAPI
+GetEfiGlobalVariable2 (
+  IN  CONST CHAR16  *Name,
+  OUT VOID         **Value,
+  OUT UINTN         *Size OPTIONAL
+) {
+  EFI_STATUS  Status;
+  UINTN       DataSize = 0;
+  VOID       *Data;
+  HOST_ASSERT((Name != NULL) && (Value != NULL));
+  *Value = NULL;
+  Status = gRT->GetVariable((CHAR16 *)Name, &gEfiGlobalVariableGuid, NULL, &DataSize, NULL);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return Status;
+  }
+  // Allocate an extra null-terminator like firmware does
+  Data = AllocateZeroPool(DataSize + sizeof(CHAR16));
+  if (Data == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Status = gRT->GetVariable((CHAR16 *)Name, &gEfiGlobalVariableGuid, NULL, &DataSize, Data);
+  if (EFI_ERROR(Status)) {
+    FreePool(Data);
+    return Status;
+  }
+  *Value = Data;
+  if (Size != NULL) {
+    *Size = DataSize;
+  }
+  return EFI_SUCCESS;
+}
+// HostFindLanguage
+/// Find a language code in a list of RFC 4646 language codes
+/// @param SupportedLanguages The semicolon separated language codes
+/// @param Language           The language code
+/// @param Length             The length of the language code to match
+/// @param MatchLength        On output, the length of the matching language code
+/// @return The matching language code in the list or NULL if there was no match
+STATIC CONST CHAR8 *
+EFIAPI
+HostFindLanguage (
+  IN  CONST CHAR8 *SupportedLanguages,
+  IN  CONST CHAR8 *Language,
+  IN  UINTN        Length,
+  OUT UINTN       *MatchLength
+) {
+  CONST CHAR8 *Supported = SupportedLanguages;
+  UINTN        Index;
+  while (*Supported != '\0') {
+    for (Index = 0; (Supported[Index] != '\0') && (Supported[Index] != ';'); ++Index);
+    if ((Index == Length) && (strncasecmp(Supported, Language, Length) == 0)) {
+      *MatchLength = Index;
+      return Supported;
+    }
+    Supported += Index;
+    if (*Supported == ';') {
+      ++Supported;
+    }
+  }
+  return NULL;
+}
+CHAR8 *
+EFIAPI
+GetBestLanguage (
+  IN CONST CHAR8 *SupportedLanguages,
+  IN UINTN        Iso639Language,
+  ...
+) {
+  VA_LIST      Marker;
+  CONST CHAR8 *Language;
+  CONST CHAR8 *Match = NULL;
+  CHAR8       *Best;
+  UINTN        Length;
+  UINTN        MatchLength = 0;
+  HOST_ASSERT(SupportedLanguages != NULL);
+  HOST_ASSERT(!Iso639Language);
+  // Try each language, removing subtags from the end until there is a match
+  VA_START(Marker, Iso639Language);
+  while ((Match == NULL) && ((Language = VA_ARG(Marker, CONST CHAR8 *)) != NULL)) {
+    for (Length = strcspn(Language, ";"); (Match == NULL) && (Length > 0); ) {
+      Match = HostFindLanguage(SupportedLanguages, Language, Length, &MatchLength);
+      while ((Length > 0) && (Language[--Length] != '-'));
+    }
+  }
+  VA_END(Marker);
+  if (Match == NULL) {
+    return NULL;
+  }
+  Best = (CHAR8 *)AllocatePool(MatchLength + 1);
+  if (Best != NULL) {
+    CopyMem(Best, Match, MatchLength);
+    Best[MatchLength] = '\0';
+  }
+  return Best;
+}
+
+//
+// File library
+//
+
+EFI_STATUS
+EFIAPI
+FileHandleOpen (
+  OUT EFI_FILE_HANDLE *Handle,
+  IN  EFI_FILE_HANDLE  Root OPTIONAL,
+  IN  CHAR16          *Path,
+  IN  UINT64           OpenMode,
+  IN  UINT64           Attributes
+) {
+  EFI_STATUS  Status;
+  CHAR8      *HostPath;
+  UINTN       Index;
+  if ((Handle == NULL) || (Path == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  // Paths are relative to the current directory on the host
+  while (*Path == L'\\') {
+    ++Path;
+  }
+  HostPath = ToUtf8(Path);
+  if (HostPath == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  for (Index = 0; HostPath[Index] != '\0'; ++Index) {
+    if (HostPath[Index] == '\\') {
+      HostPath[Index] = '/';
+    }
+  }
+  Status = HostFileOpen(Handle, HostPath);
+  FreePool(HostPath);
+  return Status;
+}
+EFI_STATUS
+EFIAPI
+FileHandleRead (
+  IN     EFI_FILE_HANDLE  FileHandle,
+  IN OUT UINTN           *BufferSize,
+  OUT    VOID            *Buffer
+) {
+  UINTN Size;
+  if ((FileHandle == NULL) || (BufferSize == NULL) || ((Buffer == NULL) && (*BufferSize != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+  Size = *BufferSize;
+  if ((FileHandle->ReadLimit != 0) && (Size > FileHandle->ReadLimit)) {
+    Size = FileHandle->ReadLimit;
+  }
+  *BufferSize = (Size == 0) ? 0 : fread(Buffer, 1, Size, FileHandle->File);
+  return ferror(FileHandle->File) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+}
+EFI_STATUS
+EFIAPI
+FileHandleWrite (
+  IN     EFI_FILE_HANDLE  FileHandle,
+  IN OUT UINTN           *BufferSize,
+  IN     VOID            *Buffer
+) {
+  if ((FileHandle == NULL) || (BufferSize == NULL) || ((Buffer == NULL) && (*BufferSize != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+  *BufferSize = (*BufferSize == 0) ? 0 : fwrite(Buffer, 1, *BufferSize, FileHandle->File);
+  return ferror(FileHandle->File) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+}
+EFI_STATUS
+EFIAPI
+FileHandleClose (
+  IN EFI_FILE_HANDLE FileHandle
+) {
+  if (FileHandle == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  fclose(FileHandle->File);
+  FreePool(FileHandle->Name);
+  FreePool(FileHandle);
+  return EFI_SUCCESS;
+}
+EFI_STATUS
+EFIAPI
+FileHandleFlush (
+  IN EFI_FILE_HANDLE FileHandle
+) {
+  if (FileHandle == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  return (fflush(FileHandle->File) == 0) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+EFI_STATUS
+EFIAPI
+FileHandleGetSize (
+  IN  EFI_FILE_HANDLE  FileHandle,
+  OUT UINT64          *Size
+) {
+  long Position;
+  long End;
+  if ((FileHandle == NULL) || (Size == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  Position = ftell(FileHandle->File);
+  if ((Position < 0) || (fseek(FileHandle->File, 0, SEEK_END) != 0)) {
+    return EFI_DEVICE_ERROR;
+  }
+  End = ftell(FileHandle->File);
+  if ((End < 0) || (fseek(FileHandle->File, Position, SEEK_SET) != 0)) {
+    return EFI_DEVICE_ERROR;
+  }
+  *Size = (UINT64)End;
+  return EFI_SUCCESS;
+}
+EFI_STATUS
+EFIAPI
+FileHandleSetPosition (
+  IN EFI_FILE_HANDLE FileHandle,
+  IN UINT64          Position
+) {
+  if (FileHandle == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  return (fseek(FileHandle->File, (long)Position, SEEK_SET) == 0) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+EFI_STATUS
+EFIAPI
+FileHandleGetFileName (
+  IN  CONST EFI_FILE_HANDLE   Handle,
+  OUT CHAR16                **FullFileName
+) {
+  if ((Handle == NULL) || (FullFileName == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  *FullFileName = StrDup(Handle->Name);
+  return (*FullFileName == NULL) ? EFI_OUT_OF_RESOURCES : EFI_SUCCESS;
+}
+CHAR16 *
+EFIAPI
+FileMakePath (
+  IN CHAR16 *Root OPTIONAL,
+  IN CHAR16 *Path
+) {
+  CHAR16 *FullPath;
+  UINTN   Length;
+  UINTN   Count;
+  // Same joining as the file library
+  if (Path == NULL) {
+    return (Root == NULL) ? NULL : StrDup(Root);
+  }
+  Count = StrLen(Path);
+  Length = (Root == NULL) ? 0 : StrLen(Root);
+  if ((Root != NULL) && (Length > 0) && (Root[Length - 1] == L'\\') && (*Path == L'\\')) {
+    ++Path;
+    --Count;
+  }
+  FullPath = (CHAR16 *)AllocateZeroPool((Length + Count + 2) * sizeof(CHAR16));
+  if (FullPath == NULL) {
+    return NULL;
+  }
+  if (Root != NULL) {
+    CopyMem(FullPath, Root, Length * sizeof(CHAR16));
+  }
+  if (((Root == NULL) || (Length == 0) || (Root[Length - 1] != L'\\')) && (*Path != L'\\')) {
+    FullPath[Length++] = L'\\';
+  }
+  CopyMem(FullPath + Length, Path, Count * sizeof(CHAR16));
+  return FullPath;
+}
+
+//
+// Log and platform library
+//
+
+UINTN
+EFIAPI
+Verbose (
+  UINTN   Level,
+  CHAR16 *Format,
+  ...
+) {
+  VA_LIST  Marker;
+  CHAR16  *Message;
+  UINTN    Length = 0;
+  // Always format the message so format arguments are checked even when not printed
+  VA_START(Marker, Format);
+  Message = CatVSPrint(NULL, Format, Marker);
+  VA_END(Marker);
+  if (Message != NULL) {
+    if (mHostVerbose) {
+      Length = HostPrint(L"%s", Message);
+    }
+    FreePool(Message);
+  }
+  return Length;
+}
+BOOLEAN
+EFIAPI
+IsCPUBigEndian (
+  VOID
+) {
+  UINT16 Value = 1;
+  return (*(UINT8 *)&Value == 0);
+}
+
+//
+// Host collation protocol, like the english collation protocol
+//
+
+STATIC INTN
+EFIAPI
+HostStriColl (
+  IN EFI_UNICODE_COLLATION_PROTOCOL *This,
+  IN CHAR16                         *Str1,
+  IN CHAR16                         *Str2
+) {
+  while ((*Str1 != L'\0') && (HOST_TO_UPPER(*Str1) == HOST_TO_UPPER(*Str2))) {
+    ++Str1;
+    ++Str2;
+  }
+  return (INTN)HOST_TO_UPPER(*Str1) - (INTN)HOST_TO_UPPER(*Str2);
+}
+STATIC BOOLEAN
+EFIAPI
+HostMetaiMatch (
+  IN EFI_UNICODE_COLLATION_PROTOCOL *This,
+  IN CHAR16                         *String,
+  IN CHAR16                         *Pattern
+) {
+  CHAR16  Char;
+  CHAR16  Previous;
+  BOOLEAN Found;
+  for (;;) {
+    Char = *Pattern++;
+    switch (Char) {
+      case L'\0':
+        return (*String == L'\0');
+
+      case L'*':
+        // Match zero or more characters
+        for (; *String != L'\0'; ++String) {
+          if (HostMetaiMatch(This, String, Pattern)) {
+            return TRUE;
+          }
+        }
+        return HostMetaiMatch(This, String, Pattern);
+
+      case L'?':
+        if (*String++ == L'\0') {
+          return FALSE;
+        }
+        break;
+
+      case L'[':
+        // Match one character of a set or range
+        if (*String == L'\0') {
+          return FALSE;
+        }
+        Found = FALSE;
+        Previous = L'\0';
+        for (Char = *Pattern++; (Char != L'\0') && (Char != L']'); Char = *Pattern++) {
+          if ((Char == L'-') && (Previous != L'\0') && (*Pattern != L'\0') && (*Pattern != L']')) {
+            Char = *Pattern++;
+            if ((HOST_TO_UPPER(*String) >= HOST_TO_UPPER(Previous)) && (HOST_TO_UPPER(*String) <= HOST_TO_UPPER(Char))) {
+              Found = TRUE;
+            }
+            Previous = L'\0';
+          } else {
+            if (HOST_TO_UPPER(*String) == HOST_TO_UPPER(Char)) {
+              Found = TRUE;
+            }
+            Previous = Char;
+          }
+        }
+        if (!Found || (Char == L'\0')) {
+          return FALSE;
+        }
+        ++String;
+        break;
+
+      default:
+        if (HOST_TO_UPPER(*String) != HOST_TO_UPPER(Char)) {
+          return FALSE;
+        }
+        ++String;
+        break;
+    }
+  }
+}
+STATIC VOID
+EFIAPI
+HostStrLwr (
+  IN     EFI_UNICODE_COLLATION_PROTOCOL *This,
+  IN OUT CHAR16                         *Str
+) {
+  for (; *Str != L'\0'; ++Str) {
+    *Str = HOST_TO_LOWER(*Str);
+  }
+}
+STATIC VOID
+EFIAPI
+HostStrUpr (
+  IN     EFI_UNICODE_COLLATION_PROTOCOL *This,
+  IN OUT CHAR16                         *Str
+) {
+  for (; *Str != L'\0'; ++Str) {
+    *Str = HOST_TO_UPPER(*Str);
+  }
+}
+STATIC VOID
+EFIAPI
+HostFatToStr (
+  IN  EFI_UNICODE_COLLATION_PROTOCOL *This,
+  IN  UINTN                           FatSize,
+  IN  CHAR8                          *Fat,
+  OUT CHAR16                         *String
+) {
+  for (; (FatSize > 0) && (*Fat != '\0'); --FatSize) {
+    *String++ = (UINT8)*Fat++;
+  }
+  *String = L'\0';
+}
+STATIC BOOLEAN
+EFIAPI
+HostStrToFat (
+  IN  EFI_UNICODE_COLLATION_PROTOCOL *This,
+  IN  CHAR16                         *String,
+  IN  UINTN                           FatSize,
+  OUT CHAR8                          *Fat
+) {
+  BOOLEAN Lossy = FALSE;
+  for (; (FatSize > 0) && (*String != L'\0'); --FatSize, ++String) {
+    if ((*String == L'.') || (*String == L' ')) {
+      continue;
+    }
+    if (*String > 0xFF) {
+      *Fat++ = '_';
+      Lossy = TRUE;
+    } else {
+      *Fat++ = (CHAR8)HOST_TO_UPPER(*String);
+    }
+  }
+  return Lossy;
+}
+
+// mHostCollation
+/// The host collation protocol
+STATIC EFI_UNICODE_COLLATION_PROTOCOL mHostCollation = {
+  HostStriColl,
+  HostMetaiMatch,
+  HostStrLwr,
+  HostStrUpr,
+  HostFatToStr,
+  HostStrToFat,
+  "en;fr;de"
+};
+
+//
+// Host boot and runtime services
+//
+
+STATIC EFI_STATUS
+EFIAPI
+HostLocateProtocol (
+  IN  EFI_GUID  *Protocol,
+  IN  VOID      *Registration OPTIONAL,
+  OUT VOID     **Interface
+) {
+  if ((Protocol == NULL) || (Interface == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (mHostCollationInstalled && (CompareMem(Protocol, &gEfiUnicodeCollation2ProtocolGuid, sizeof(EFI_GUID)) == 0)) {
+    *Interface = &mHostCollation;
+    return EFI_SUCCESS;
+  }
+  *Interface = NULL;
+  return EFI_NOT_FOUND;
+}
+STATIC EFI_STATUS
+EFIAPI
+HostInstallMultipleProtocolInterfaces (
+  IN OUT EFI_HANDLE *Handle,
+  ...
+) {
+  // Protocols installed by the libraries are not located again on the host
+  if (Handle == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (*Handle == NULL) {
+    *Handle = (EFI_HANDLE)&mHostHandle;
+  }
+  return EFI_SUCCESS;
+}
+STATIC EFI_STATUS
+EFIAPI
+HostUninstallMultipleProtocolInterfaces (
+  IN EFI_HANDLE Handle,
+  ...
+) {
+  return (Handle == NULL) ? EFI_INVALID_PARAMETER : EFI_SUCCESS;
+}
+STATIC EFI_STATUS
+EFIAPI
+HostLocateHandleBuffer (
+  IN  EFI_LOCATE_SEARCH_TYPE   SearchType,
+  IN  EFI_GUID                *Protocol OPTIONAL,
+  IN  VOID                    *SearchKey OPTIONAL,
+  OUT UINTN                   *Count,
+  OUT EFI_HANDLE             **Buffer
+) {
+  VOID *Interface = NULL;
+  if ((Count == NULL) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  *Count = 0;
+  *Buffer = NULL;
+  ++mHostProtocolSearches;
+  if ((SearchType != ByProtocol) || EFI_ERROR(HostLocateProtocol(Protocol, NULL, &Interface))) {
+    return EFI_NOT_FOUND;
+  }
+  *Buffer = (EFI_HANDLE *)AllocatePool(sizeof(EFI_HANDLE));
+  if (*Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  **Buffer = (EFI_HANDLE)&mHostHandle;
+  *Count = 1;
+  return EFI_SUCCESS;
+}
+STATIC EFI_STATUS
+EFIAPI
+HostHandleProtocol (
+  IN  EFI_HANDLE   Handle,
+  IN  EFI_GUID    *Protocol,
+  OUT VOID       **Interface
+) {
+  if (Handle != (EFI_HANDLE)&mHostHandle) {
+    return EFI_INVALID_PARAMETER;
+  }
+  return HostLocateProtocol(Protocol, NULL, Interface);
+}
+STATIC EFI_STATUS
+EFIAPI
+HostStall (
+  IN UINTN Microseconds
+) {
+  usleep((useconds_t)Microseconds);
+  return EFI_SUCCESS;
+}
+// HostFindVariable
+/// Find a variable in the host variable store
+/// @param Name The variable name
+/// @return The variable or NULL if not found
+STATIC HOST_VARIABLE *
+EFIAPI
+HostFindVariable (
+  IN CHAR16 *Name
+) {
+  HOST_VARIABLE *Variable;
+  for (Variable = mHostVariables; Variable != NULL; Variable = Variable->Next) {
+    if (StrCmp(Variable->Name, Name) == 0) {
+      return Variable;
+    }
+  }
+  return NULL;
+}
+STATIC EFI_STATUS
+EFIAPI
+HostGetVariable (
+  IN     CHAR16   *Name,
+  IN     EFI_GUID *Guid,
+  OUT    UINT32   *Attributes OPTIONAL,
+  IN OUT UINTN    *Size,
+  OUT    VOID     *Data OPTIONAL
+) {
+  HOST_VARIABLE *Variable;
+  if ((Name == NULL) || (Guid == NULL) || (Size == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  Variable = HostFindVariable(Name);
+  if (Variable == NULL) {
+    return EFI_NOT_FOUND;
+  }
+  if (Attributes != NULL) {
+    *Attributes = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS;
+  }
+  if ((*Size < Variable->Size) || (Data == NULL)) {
+    *Size = Variable->Size;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  *Size = Variable->Size;
+  CopyMem(Data, Variable->Data, Variable->Size);
+  return EFI_SUCCESS;
+}
+// HostStoreVariable
+/// Store a variable in the host variable store
+/// @param Name The variable name
+/// @param Size The size, in bytes, of the variable data or zero to delete the variable
+/// @param Data The variable data
+/// @return Whether the variable was stored or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_NOT_FOUND        If the variable to delete was not found
+/// @retval EFI_SUCCESS          If the variable was stored successfully
+STATIC EFI_STATUS
+EFIAPI
+HostStoreVariable (
+  IN CHAR16 *Name,
+  IN UINTN   Size,
+  IN VOID   *Data
+) {
+  HOST_VARIABLE **Previous;
+  HOST_VARIABLE  *Variable;
+  VOID           *Copy;
+  for (Previous = &mHostVariables; *Previous != NULL; Previous = &((*Previous)->Next)) {
+    if (StrCmp((*Previous)->Name, Name) == 0) {
+      break;
+    }
+  }
+  Variable = *Previous;
+  if (Size == 0) {
+    // Delete the variable
+    if (Variable == NULL) {
+      return EFI_NOT_FOUND;
+    }
+    *Previous = Variable->Next;
+    FreePool(Variable->Name);
+    FreePool(Variable->Data);
+    FreePool(Variable);
+    return EFI_SUCCESS;
+  }
+  Copy = AllocateCopyPool(Size, Data);
+  if (Copy == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  if (Variable == NULL) {
+    Variable = (HOST_VARIABLE *)AllocateZeroPool(sizeof(HOST_VARIABLE));
+    if (Variable == NULL) {
+      FreePool(Copy);
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Variable->Name = StrDup(Name);
+    if (Variable->Name == NULL) {
+      FreePool(Variable);
+      FreePool(Copy);
+      return EFI_OUT_OF_RESOURCES;
+    }
+    *Previous = Variable;
+  } else {
+    FreePool(Variable->Data);
+  }
+  Variable->Size = Size;
+  Variable->Data = Copy;
+  return EFI_SUCCESS;
+}
+STATIC EFI_STATUS
+EFIAPI
+HostRuntimeSetVariable (
+  IN CHAR16   *Name,
+  IN EFI_GUID *Guid,
+  IN UINT32    Attributes,
+  IN UINTN     Size,
+  IN VOID     *Data
+) {
+  if ((Name == NULL) || (Guid == NULL) || ((Size != 0) && (Data == NULL))) {
+    return EFI_INVALID_PARAMETER;
+  }
+  ++mHostVariableWrites;
+  return HostStoreVariable(Name, Size, Data);
+}
+
+// mHostBootServices
+/// The host boot services
+STATIC EFI_BOOT_SERVICES    mHostBootServices = {
+  HostLocateProtocol,
+  HostInstallMultipleProtocolInterfaces,
+  HostUninstallMultipleProtocolInterfaces,
+  HostLocateHandleBuffer,
+  HostHandleProtocol,
+  HostStall
+};
+// mHostRuntimeServices
+/// The host runtime services
+STATIC EFI_RUNTIME_SERVICES mHostRuntimeServices = {
+  HostGetVariable,
+  HostRuntimeSetVariable
+};
+// mHostSystemTable
+/// The host system table
+STATIC EFI_SYSTEM_TABLE     mHostSystemTable = {
+  &mHostRuntimeServices,
+  &mHostBootServices
+};
+
+//
+// Host library
+//
+
+EFI_STATUS
+EFIAPI
+HostLibInitialize (
+  VOID
+) {
+  EFI_STATUS Status;
+  gST = &mHostSystemTable;
+  gBS = &mHostBootServices;
+  gRT = &mHostRuntimeServices;
+  mHostVerbose = (getenv("HOST_VERBOSE") != NULL);
+  Status = StringLibInitialize();
+  if (!EFI_ERROR(Status)) {
+    Status = HostSetVariable(L"PlatformLangCodes", HOST_PLATFORM_LANGUAGES);
+  }
+  if (!EFI_ERROR(Status)) {
+    Status = ParseLibInitialize();
+  }
+  if (!EFI_ERROR(Status)) {
+    Status = XmlLibInitialize();
+  }
+  if (!EFI_ERROR(Status)) {
+    Status = ConfigLibInitialize();
+  }
+  return Status;
+}
+EFI_STATUS
+EFIAPI
+HostLibFinish (
+  VOID
+) {
+  ConfigLibFinish();
+  XmlLibFinish();
+  ParseLibFinish();
+  StringLibFinish();
+  while (mHostVariables != NULL) {
+    HostStoreVariable(mHostVariables->Name, 0, NULL);
+  }
+  mHostVariableWrites = 0;
+  mHostProtocolSearches = 0;
+  mHostCollationInstalled = FALSE;
+  return EFI_SUCCESS;
+}
+
+VOID
+EFIAPI
+HostSetCollation (
+  IN BOOLEAN Installed
+) {
+  mHostCollationInstalled = Installed;
+}
+UINTN
+EFIAPI
+HostGetVariableWrites (
+  VOID
+) {
+  return mHostVariableWrites;
+}
+UINTN
+EFIAPI
+HostGetProtocolSearches (
+  VOID
+) {
+  return mHostProtocolSearches;
+}
+EFI_STATUS
+EFIAPI
+HostSetVariable (
+  IN CHAR16 *Name,
+  IN CHAR8  *Value OPTIONAL
+) {
+  if (Name == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Value == NULL) {
+    HostStoreVariable(Name, 0, NULL);
+    return EFI_SUCCESS;
+  }
+  return HostStoreVariable(Name, AsciiStrSize(Value), Value);
+}
+
+UINT64
+EFIAPI
+HostGetAllocations (
+  VOID
+) {
+  return mHostAllocations;
+}
+INTN
+EFIAPI
+HostGetLiveAllocations (
+  VOID
+) {
+  return mHostLiveAllocations;
+}
+
+// HostFileCreate
+/// Create a host file handle for a standard library stream
+/// @param Handle On output, the file handle
+/// @param File   The standard library stream, which is closed on failure
+/// @param Name   The file name
+/// @return Whether the file handle was created or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the file handle was created successfully
+STATIC EFI_STATUS
+EFIAPI
+HostFileCreate (
+  OUT EFI_FILE_HANDLE *Handle,
+  IN  FILE            *File,
+  IN  CONST CHAR8     *Name
+) {
+  EFI_FILE_HANDLE FileHandle = (EFI_FILE_HANDLE)AllocateZeroPool(sizeof(EFI_FILE_PROTOCOL));
+  if (FileHandle != NULL) {
+    FileHandle->Name = FromUtf8((CHAR8 *)Name);
+    if (FileHandle->Name == NULL) {
+      FreePool(FileHandle);
+      FileHandle = NULL;
+    }
+  }
+  if (FileHandle == NULL) {
+    fclose(File);
+    return EFI_OUT_OF_RESOURCES;
+  }
+  FileHandle->File = File;
+  *Handle = FileHandle;
+  return EFI_SUCCESS;
+}
+EFI_STATUS
+EFIAPI
+HostFileOpen (
+  OUT EFI_FILE_HANDLE *Handle,
+  IN  CONST CHAR8     *Path
+) {
+  FILE *File;
+  if ((Handle == NULL) || (Path == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  *Handle = NULL;
+  File = fopen(Path, "rb");
+  if (File == NULL) {
+    return EFI_NOT_FOUND;
+  }
+  return HostFileCreate(Handle, File, Path);
+}
+EFI_STATUS
+EFIAPI
+HostFileOpenBuffer (
+  OUT EFI_FILE_HANDLE *Handle,
+  IN  UINTN            Size,
+  IN  VOID            *Buffer,
+  IN  UINTN            ReadLimit
+) {
+  EFI_STATUS  Status;
+  FILE       *File;
+  if ((Handle == NULL) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  *Handle = NULL;
+  // An empty memory stream is not allowed so an empty buffer is a stream that is already at the end
+  File = (Size == 0) ? fopen("/dev/null", "rb") : fmemopen(Buffer, Size, "rb");
+  if (File == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Status = HostFileCreate(Handle, File, "buffer");
+  if (!EFI_ERROR(Status)) {
+    (*Handle)->ReadLimit = ReadLimit;
+  }
+  return Status;
+}
+EFI_STATUS
+EFIAPI
+HostFileLoad (
+  IN  CONST CHAR8  *Path,
+  OUT UINTN        *Size,
+  OUT VOID        **Buffer
+) {
+  EFI_STATUS       Status;
+  EFI_FILE_HANDLE  Handle = NULL;
+  UINT64           FileSize = 0;
+  UINTN            ReadSize;
+  VOID            *Data;
+  if ((Path == NULL) || (Size == NULL) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  Status = HostFileOpen(&Handle, Path);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  Status = FileHandleGetSize(Handle, &FileSize);
+  if (!EFI_ERROR(Status)) {
+    Data = AllocatePool((UINTN)FileSize);
+    if (Data == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+    } else {
+      ReadSize = (UINTN)FileSize;
+      Status = FileHandleRead(Handle, &ReadSize, Data);
+      if (EFI_ERROR(Status) || (ReadSize != FileSize)) {
+        FreePool(Data);
+        Status = EFI_ERROR(Status) ? Status : EFI_DEVICE_ERROR;
+      } else {
+        *Size = ReadSize;
+        *Buffer = Data;
+      }
+    }
+  }
+  FileHandleClose(Handle);
+  return Status;
+}
+
+UINT64
+EFIAPI
+HostGetTime (
+  VOID
+) {
+  struct timespec Time;
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+  return ((UINT64)Time.tv_sec * 1000000000ULL) + (UINT64)Time.tv_nsec;
+}
+UINTN
+EFIAPI
+HostPrint (
+  IN CONST CHAR16 *Format,
+  ...
+) {
+  VA_LIST  Marker;
+  CHAR16  *Text;
+  CHAR8   *Utf8;
+  UINTN    Length = 0;
+  VA_START(Marker, Format);
+  Text = CatVSPrint(NULL, Format, Marker);
+  VA_END(Marker);
+  if (Text == NULL) {
+    return 0;
+  }
+  Utf8 = ToUtf8(Text);
+  if (Utf8 != NULL) {
+    Length = AsciiStrLen(Utf8);
+    fwrite(Utf8, 1, Length, stdout);
+    FreePool(Utf8);
+  }
+  FreePool(Text);
+  return Length;
+}
@@ -0,0 +1,171 @@
+//
+/// @file Test/Host/HostLib.h
+///
+/// Host library to build and test the string, parse, XML, and configuration libraries outside of firmware
+///
+
+#pragma once
+#ifndef __HOST_LIBRARY_HEADER__
+#define __HOST_LIBRARY_HEADER__
+
+#include <Uefi.h>
+
+#include <Library/StringLib.h>
+#include <Library/ParseLib.h>
+#include <Library/XmlLib.h>
+#include <Library/ConfigLib.h>
+
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/FileHandleLib.h>
+
+// HOST_PLATFORM_LANGUAGES
+/// The supported platform languages reported by the host variable store
+#define HOST_PLATFORM_LANGUAGES "en;en-US;fr;de"
+
+// HostLibInitialize
+/// Install the host services and initialize the string, parse, XML, and configuration libraries
+/// @return Whether the libraries initialized successfully or not
+/// @retval EFI_SUCCESS The libraries successfully initialized
+EFI_STATUS
+EFIAPI
+HostLibInitialize (
+  VOID
+);
+// HostLibFinish
+/// Finish the string, parse, XML, and configuration libraries and free the host variable store
+/// @return Whether the libraries finished successfully or not
+/// @retval EFI_SUCCESS The libraries successfully finished
+EFI_STATUS
+EFIAPI
+HostLibFinish (
+  VOID
+);
+
+// HostSetCollation
+/// Set whether the host collation protocol can be located, the protocol folds basic latin and latin-1 to upper case
+/// @param Installed Whether the host collation protocol is installed or not
+VOID
+EFIAPI
+HostSetCollation (
+  IN BOOLEAN Installed
+);
+// HostGetVariableWrites
+/// Get the count of variable writes made through the runtime services
+/// @return The count of variable writes
+UINTN
+EFIAPI
+HostGetVariableWrites (
+  VOID
+);
+// HostGetProtocolSearches
+/// Get the count of protocol handle searches made through the boot services
+/// @return The count of protocol handle searches
+UINTN
+EFIAPI
+HostGetProtocolSearches (
+  VOID
+);
+// HostSetVariable
+/// Set a global variable in the host variable store without counting it as a write
+/// @param Name  The variable name
+/// @param Value The null-terminated ASCII value or NULL to delete the variable
+/// @return Whether the variable was set or not
+/// @retval EFI_OUT_OF_RESOURCES If memory could not be allocated
+/// @retval EFI_SUCCESS          If the variable was set successfully
+EFI_STATUS
+EFIAPI
+HostSetVariable (
+  IN CHAR16 *Name,
+  IN CHAR8  *Value OPTIONAL
+);
+
+// HostGetAllocations
+/// Get the count of allocations made since the host library was initialized
+/// @return The count of allocations, reallocations count as allocations
+UINT64
+EFIAPI
+HostGetAllocations (
+  VOID
+);
+// HostGetLiveAllocations
+/// Get the count of allocations that have not been freed
+/// @return The count of allocations that have not been freed
+INTN
+EFIAPI
+HostGetLiveAllocations (
+  VOID
+);
+
+// HostFileOpen
+/// Open a host file as a file handle
+/// @param Handle On output, the opened file handle, which must be closed with FileHandleClose
+/// @param Path   The host path of the file to open
+/// @return Whether the file was opened or not
+/// @retval EFI_INVALID_PARAMETER If Handle or Path is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_NOT_FOUND         If the file could not be opened
+/// @retval EFI_SUCCESS           If the file was opened successfully
+EFI_STATUS
+EFIAPI
+HostFileOpen (
+  OUT EFI_FILE_HANDLE *Handle,
+  IN  CONST CHAR8     *Path
+);
+// HostFileOpenBuffer
+/// Open a memory buffer as a read only file handle
+/// @param Handle    On output, the opened file handle, which must be closed with FileHandleClose
+/// @param Size      The size, in bytes, of the buffer
+/// @param Buffer    The buffer, which must remain valid until the file handle is closed
+/// @param ReadLimit The maximum size, in bytes, returned by each read to simulate short reads or zero for no limit
+/// @return Whether the buffer was opened or not
+/// @retval EFI_INVALID_PARAMETER If Handle or Buffer is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_SUCCESS           If the buffer was opened successfully
+EFI_STATUS
+EFIAPI
+HostFileOpenBuffer (
+  OUT EFI_FILE_HANDLE *Handle,
+  IN  UINTN            Size,
+  IN  VOID            *Buffer,
+  IN  UINTN            ReadLimit
+);
+// HostFileLoad
+/// Load the contents of a host file
+/// @param Path   The host path of the file to load
+/// @param Size   On output, the size, in bytes, of the file contents
+/// @param Buffer On output, the file contents, which must be freed with FreePool
+/// @return Whether the file was loaded or not
+/// @retval EFI_INVALID_PARAMETER If Path, Size, or Buffer is NULL
+/// @retval EFI_OUT_OF_RESOURCES  If memory could not be allocated
+/// @retval EFI_NOT_FOUND         If the file could not be opened
+/// @retval EFI_SUCCESS           If the file was loaded successfully
+EFI_STATUS
+EFIAPI
+HostFileLoad (
+  IN  CONST CHAR8  *Path,
+  OUT UINTN        *Size,
+  OUT VOID        **Buffer
+);
+
+// HostGetTime
+/// Get the monotonic host time
+/// @return The monotonic host time in nanoseconds
+UINT64
+EFIAPI
+HostGetTime (
+  VOID
+);
+// HostPrint
+/// Print formatted text to the standard output as UTF-8
+/// @param Format The format specifier for formatting the text
+/// @param ...    The parameters for the format string
+/// @return The count of characters printed
+UINTN
+EFIAPI
+HostPrint (
+  IN CONST CHAR16 *Format,
+  ...
+);
+
+#endif // __HOST_LIBRARY_HEADER__
@@ -0,0 +1,77 @@
+//
+/// @file Test/Host/Include/Base.h
+///
+/// Host stub of the base types
+///
+
+#pragma once
+#ifndef __HOST_BASE_HEADER__
+#define __HOST_BASE_HEADER__
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t   UINT8;
+typedef int8_t    INT8;
+typedef uint16_t  UINT16;
+typedef int16_t   INT16;
+typedef uint32_t  UINT32;
+typedef int32_t   INT32;
+typedef uint64_t  UINT64;
+typedef int64_t   INT64;
+typedef uintptr_t UINTN;
+typedef intptr_t  INTN;
+typedef char      CHAR8;
+typedef UINT16    CHAR16;
+typedef UINT8     BOOLEAN;
+typedef void      VOID;
+
+typedef va_list   VA_LIST;
+
+#define VA_START va_start
+#define VA_END   va_end
+#define VA_ARG   va_arg
+#define VA_COPY  va_copy
+
+#define TRUE  ((BOOLEAN)1)
+#define FALSE ((BOOLEAN)0)
+
+#define IN
+#define OUT
+#define OPTIONAL
+#define CONST  const
+#define STATIC static
+#define EFIAPI
+
+#define MAX_INT8   ((INT8)0x7F)
+#define MAX_UINT8  ((UINT8)0xFF)
+#define MAX_INT16  ((INT16)0x7FFF)
+#define MAX_UINT16 ((UINT16)0xFFFF)
+#define MAX_INT32  ((INT32)0x7FFFFFFF)
+#define MAX_UINT32 ((UINT32)0xFFFFFFFF)
+#define MAX_INT64  ((INT64)0x7FFFFFFFFFFFFFFFULL)
+#define MAX_UINT64 ((UINT64)0xFFFFFFFFFFFFFFFFULL)
+#define MAX_INTN   ((INTN)(MAX_UINTN >> 1))
+#define MAX_UINTN  ((UINTN)UINTPTR_MAX)
+#define MIN_INT64  (-MAX_INT64 - 1)
+#define MIN_INTN   (-MAX_INTN - 1)
+
+#define ARRAY_SIZE(Array)             (sizeof(Array) / sizeof((Array)[0]))
+#define MIN(a, b)                     (((a) < (b)) ? (a) : (b))
+#define MAX(a, b)                     (((a) > (b)) ? (a) : (b))
+#define ALIGN_VALUE(Value, Alignment) ((Value) + (((Alignment) - (Value)) & ((Alignment) - 1)))
+#define OFFSET_OF(Type, Field)        offsetof(Type, Field)
+#define BASE_CR(Record, Type, Field)  ((Type *)((CHAR8 *)(Record) - OFFSET_OF(Type, Field)))
+#define SIGNATURE_16(A, B)            ((A) | ((B) << 8))
+#define SIGNATURE_32(A, B, C, D)      (SIGNATURE_16(A, B) | (SIGNATURE_16(C, D) << 16))
+
+typedef UINTN RETURN_STATUS;
+
+#define RETURN_SUCCESS       ((RETURN_STATUS)0)
+#define ENCODE_ERROR(Code)   ((RETURN_STATUS)(MAX_BIT | (Code)))
+#define ENCODE_WARNING(Code) ((RETURN_STATUS)(Code))
+#define RETURN_ERROR(Status) (((INTN)(RETURN_STATUS)(Status)) < 0)
+#define MAX_BIT              ((UINTN)1 << ((sizeof(UINTN) * 8) - 1))
+
+#endif // __HOST_BASE_HEADER__
@@ -0,0 +1,13 @@
+//
+/// @file Test/Host/Include/Guid/GlobalVariable.h
+///
+/// Host stub of the global variable GUID
+///
+
+#pragma once
+#ifndef __HOST_GLOBAL_VARIABLE_GUID_HEADER__
+#define __HOST_GLOBAL_VARIABLE_GUID_HEADER__
+
+extern EFI_GUID gEfiGlobalVariableGuid;
+
+#endif // __HOST_GLOBAL_VARIABLE_GUID_HEADER__
@@ -0,0 +1,19 @@
+//
+/// @file Test/Host/Include/IndustryStandard/SmBios.h
+///
+/// Host stub of the SMBIOS structures, which are opaque on the host
+///
+
+#pragma once
+#ifndef __HOST_SMBIOS_HEADER__
+#define __HOST_SMBIOS_HEADER__
+
+// SMBIOS_STRUCTURE_POINTER
+/// SMBIOS structure pointer
+typedef union {
+
+  UINT8 *Raw;
+
+} SMBIOS_STRUCTURE_POINTER;
+
+#endif // __HOST_SMBIOS_HEADER__
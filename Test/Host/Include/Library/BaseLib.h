@@ -0,0 +1,46 @@
+//
+/// @file Test/Host/Include/Library/BaseLib.h
+///
+/// Host stub of the base library string and math functions
+///
+
+#pragma once
+#ifndef __HOST_BASE_LIBRARY_HEADER__
+#define __HOST_BASE_LIBRARY_HEADER__
+
+UINTN   EFIAPI StrLen (IN CONST CHAR16 *String);
+UINTN   EFIAPI StrSize (IN CONST CHAR16 *String);
+INTN    EFIAPI StrCmp (IN CONST CHAR16 *FirstString, IN CONST CHAR16 *SecondString);
+INTN    EFIAPI StrnCmp (IN CONST CHAR16 *FirstString, IN CONST CHAR16 *SecondString, IN UINTN Length);
+CHAR16 *EFIAPI StrStr (IN CONST CHAR16 *String, IN CONST CHAR16 *SearchString);
+RETURN_STATUS EFIAPI StrCpyS (OUT CHAR16 *Destination, IN UINTN DestMax, IN CONST CHAR16 *Source);
+RETURN_STATUS EFIAPI StrnCpyS (OUT CHAR16 *Destination, IN UINTN DestMax, IN CONST CHAR16 *Source, IN UINTN Length);
+RETURN_STATUS EFIAPI StrCatS (IN OUT CHAR16 *Destination, IN UINTN DestMax, IN CONST CHAR16 *Source);
+UINTN   EFIAPI StrDecimalToUintn (IN CONST CHAR16 *String);
+UINTN   EFIAPI StrHexToUintn (IN CONST CHAR16 *String);
+CHAR16  EFIAPI CharToUpper (IN CHAR16 Char);
+
+UINTN   EFIAPI AsciiStrLen (IN CONST CHAR8 *String);
+UINTN   EFIAPI AsciiStrSize (IN CONST CHAR8 *String);
+INTN    EFIAPI AsciiStrCmp (IN CONST CHAR8 *FirstString, IN CONST CHAR8 *SecondString);
+INTN    EFIAPI AsciiStrnCmp (IN CONST CHAR8 *FirstString, IN CONST CHAR8 *SecondString, IN UINTN Length);
+INTN    EFIAPI AsciiStriCmp (IN CONST CHAR8 *FirstString, IN CONST CHAR8 *SecondString);
+CHAR8  *EFIAPI AsciiStrStr (IN CONST CHAR8 *String, IN CONST CHAR8 *SearchString);
+RETURN_STATUS EFIAPI AsciiStrCpyS (OUT CHAR8 *Destination, IN UINTN DestMax, IN CONST CHAR8 *Source);
+RETURN_STATUS EFIAPI AsciiStrnCpyS (OUT CHAR8 *Destination, IN UINTN DestMax, IN CONST CHAR8 *Source, IN UINTN Length);
+RETURN_STATUS EFIAPI AsciiStrCatS (IN OUT CHAR8 *Destination, IN UINTN DestMax, IN CONST CHAR8 *Source);
+CHAR8   EFIAPI AsciiCharToUpper (IN CHAR8 Char);
+
+RETURN_STATUS EFIAPI UnicodeStrToAsciiStrS (IN CONST CHAR16 *Source, OUT CHAR8 *Destination, IN UINTN DestMax);
+RETURN_STATUS EFIAPI UnicodeStrnToAsciiStrS (IN CONST CHAR16 *Source, IN UINTN Length, OUT CHAR8 *Destination, IN UINTN DestMax, OUT UINTN *DestinationLength);
+RETURN_STATUS EFIAPI AsciiStrToUnicodeStrS (IN CONST CHAR8 *Source, OUT CHAR16 *Destination, IN UINTN DestMax);
+RETURN_STATUS EFIAPI AsciiStrnToUnicodeStrS (IN CONST CHAR8 *Source, IN UINTN Length, OUT CHAR16 *Destination, IN UINTN DestMax, OUT UINTN *DestinationLength);
+
+UINT64  EFIAPI LShiftU64 (IN UINT64 Operand, IN UINTN Count);
+UINT64  EFIAPI RShiftU64 (IN UINT64 Operand, IN UINTN Count);
+UINT64  EFIAPI MultU64x32 (IN UINT64 Multiplicand, IN UINT32 Multiplier);
+UINT64  EFIAPI MultU64x64 (IN UINT64 Multiplicand, IN UINT64 Multiplier);
+UINT64  EFIAPI DivU64x32 (IN UINT64 Dividend, IN UINT32 Divisor);
+UINT64  EFIAPI DivU64x64Remainder (IN UINT64 Dividend, IN UINT64 Divisor, OUT UINT64 *Remainder OPTIONAL);
+
+#endif // __HOST_BASE_LIBRARY_HEADER__
@@ -0,0 +1,18 @@
+//
+/// @file Test/Host/Include/Library/BaseMemoryLib.h
+///
+/// Host stub of the base memory library
+///
+
+#pragma once
+#ifndef __HOST_BASE_MEMORY_LIBRARY_HEADER__
+#define __HOST_BASE_MEMORY_LIBRARY_HEADER__
+
+VOID *EFIAPI CopyMem (OUT VOID *Destination, IN CONST VOID *Source, IN UINTN Length);
+VOID *EFIAPI SetMem (OUT VOID *Buffer, IN UINTN Length, IN UINT8 Value);
+VOID *EFIAPI SetMem16 (OUT VOID *Buffer, IN UINTN Length, IN UINT16 Value);
+VOID *EFIAPI SetMem32 (OUT VOID *Buffer, IN UINTN Length, IN UINT32 Value);
+VOID *EFIAPI ZeroMem (OUT VOID *Buffer, IN UINTN Length);
+INTN  EFIAPI CompareMem (IN CONST VOID *DestinationBuffer, IN CONST VOID *SourceBuffer, IN UINTN Length);
+
+#endif // __HOST_BASE_MEMORY_LIBRARY_HEADER__
@@ -0,0 +1,23 @@
+//
+/// @file Test/Host/Include/Library/DevicePathLib.h
+///
+/// Host stub of the device path library
+///
+
+#pragma once
+#ifndef __HOST_DEVICE_PATH_LIBRARY_HEADER__
+#define __HOST_DEVICE_PATH_LIBRARY_HEADER__
+
+// EFI_DEVICE_PATH_PROTOCOL
+/// Device path node header
+typedef struct {
+
+  UINT8 Type;
+  UINT8 SubType;
+  UINT8 Length[2];
+
+} EFI_DEVICE_PATH_PROTOCOL;
+
+typedef EFI_DEVICE_PATH_PROTOCOL EFI_DEVICE_PATH;
+
+#endif // __HOST_DEVICE_PATH_LIBRARY_HEADER__
@@ -0,0 +1,21 @@
+//
+/// @file Test/Host/Include/Library/FileHandleLib.h
+///
+/// Host stub of the file handle library, file handles are host files
+///
+
+#pragma once
+#ifndef __HOST_FILE_HANDLE_LIBRARY_HEADER__
+#define __HOST_FILE_HANDLE_LIBRARY_HEADER__
+
+#include <Protocol/SimpleFileSystem.h>
+
+EFI_STATUS     EFIAPI FileHandleRead (IN EFI_FILE_HANDLE FileHandle, IN OUT UINTN *BufferSize, OUT VOID *Buffer);
+EFI_STATUS     EFIAPI FileHandleWrite (IN EFI_FILE_HANDLE FileHandle, IN OUT UINTN *BufferSize, IN VOID *Buffer);
+EFI_STATUS     EFIAPI FileHandleClose (IN EFI_FILE_HANDLE FileHandle);
+EFI_STATUS     EFIAPI FileHandleFlush (IN EFI_FILE_HANDLE FileHandle);
+EFI_STATUS     EFIAPI FileHandleGetSize (IN EFI_FILE_HANDLE FileHandle, OUT UINT64 *Size);
+EFI_STATUS     EFIAPI FileHandleSetPosition (IN EFI_FILE_HANDLE FileHandle, IN UINT64 Position);
+EFI_STATUS     EFIAPI FileHandleGetFileName (IN CONST EFI_FILE_HANDLE Handle, OUT CHAR16 **FullFileName);
+
+#endif // __HOST_FILE_HANDLE_LIBRARY_HEADER__
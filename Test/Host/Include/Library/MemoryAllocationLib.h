@@ -0,0 +1,17 @@
+//
+/// @file Test/Host/Include/Library/MemoryAllocationLib.h
+///
+/// Host stub of the memory allocation library, allocations are counted by the host library
+///
+
+#pragma once
+#ifndef __HOST_MEMORY_ALLOCATION_LIBRARY_HEADER__
+#define __HOST_MEMORY_ALLOCATION_LIBRARY_HEADER__
+
+VOID *EFIAPI AllocatePool (IN UINTN AllocationSize);
+VOID *EFIAPI AllocateZeroPool (IN UINTN AllocationSize);
+VOID *EFIAPI AllocateCopyPool (IN UINTN AllocationSize, IN CONST VOID *Buffer);
+VOID *EFIAPI ReallocatePool (IN UINTN OldSize, IN UINTN NewSize, IN VOID *OldBuffer OPTIONAL);
+VOID  EFIAPI FreePool (IN VOID *Buffer);
+
+#endif // __HOST_MEMORY_ALLOCATION_LIBRARY_HEADER__
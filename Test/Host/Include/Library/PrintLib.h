@@ -0,0 +1,15 @@
+//
+/// @file Test/Host/Include/Library/PrintLib.h
+///
+/// Host stub of the print library
+///
+
+#pragma once
+#ifndef __HOST_PRINT_LIBRARY_HEADER__
+#define __HOST_PRINT_LIBRARY_HEADER__
+
+UINTN EFIAPI SPrintLength (IN CONST CHAR16 *FormatString, IN VA_LIST Marker);
+UINTN EFIAPI UnicodeVSPrint (OUT CHAR16 *StartOfBuffer, IN UINTN BufferSize, IN CONST CHAR16 *FormatString, IN VA_LIST Marker);
+UINTN EFIAPI UnicodeSPrint (OUT CHAR16 *StartOfBuffer, IN UINTN BufferSize, IN CONST CHAR16 *FormatString, ...);
+
+#endif // __HOST_PRINT_LIBRARY_HEADER__
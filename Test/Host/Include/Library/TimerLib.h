@@ -0,0 +1,15 @@
+//
+/// @file Test/Host/Include/Library/TimerLib.h
+///
+/// Host stub of the timer library, the performance counter counts nanoseconds
+///
+
+#pragma once
+#ifndef __HOST_TIMER_LIBRARY_HEADER__
+#define __HOST_TIMER_LIBRARY_HEADER__
+
+UINT64 EFIAPI GetPerformanceCounter (VOID);
+UINT64 EFIAPI GetPerformanceCounterProperties (OUT UINT64 *StartValue OPTIONAL, OUT UINT64 *EndValue OPTIONAL);
+UINT64 EFIAPI GetTimeInNanoSecond (IN UINT64 Ticks);
+
+#endif // __HOST_TIMER_LIBRARY_HEADER__
@@ -0,0 +1,15 @@
+//
+/// @file Test/Host/Include/Library/UefiBootServicesTableLib.h
+///
+/// Host stub of the boot services table, the host library provides services without protocols
+///
+
+#pragma once
+#ifndef __HOST_UEFI_BOOT_SERVICES_TABLE_LIBRARY_HEADER__
+#define __HOST_UEFI_BOOT_SERVICES_TABLE_LIBRARY_HEADER__
+
+extern EFI_HANDLE         gImageHandle;
+extern EFI_SYSTEM_TABLE  *gST;
+extern EFI_BOOT_SERVICES *gBS;
+
+#endif // __HOST_UEFI_BOOT_SERVICES_TABLE_LIBRARY_HEADER__
@@ -0,0 +1,16 @@
+//
+/// @file Test/Host/Include/Library/UefiLib.h
+///
+/// Host stub of the UEFI library
+///
+
+#pragma once
+#ifndef __HOST_UEFI_LIBRARY_HEADER__
+#define __HOST_UEFI_LIBRARY_HEADER__
+
+CHAR16    *EFIAPI CatVSPrint (IN CHAR16 *String OPTIONAL, IN CONST CHAR16 *FormatString, IN VA_LIST Marker);
+CHAR16    *EFIAPI CatSPrint (IN CHAR16 *String OPTIONAL, IN CONST CHAR16 *FormatString, ...);
+EFI_STATUS EFIAPI GetEfiGlobalVariable2 (IN CONST CHAR16 *Name, OUT VOID **Value, OUT UINTN *Size OPTIONAL);
+CHAR8     *EFIAPI GetBestLanguage (IN CONST CHAR8 *SupportedLanguages, IN UINTN Iso639Language, ...);
+
+#endif // __HOST_UEFI_LIBRARY_HEADER__
@@ -0,0 +1,13 @@
+//
+/// @file Test/Host/Include/Library/UefiRuntimeServicesTableLib.h
+///
+/// Host stub of the runtime services table, the host library provides services without variables
+///
+
+#pragma once
+#ifndef __HOST_UEFI_RUNTIME_SERVICES_TABLE_LIBRARY_HEADER__
+#define __HOST_UEFI_RUNTIME_SERVICES_TABLE_LIBRARY_HEADER__
+
+extern EFI_RUNTIME_SERVICES *gRT;
+
+#endif // __HOST_UEFI_RUNTIME_SERVICES_TABLE_LIBRARY_HEADER__
@@ -0,0 +1,31 @@
+//
+/// @file Test/Host/Include/ProjectVersion.h
+///
+/// Host project version, generated by the package build configuration otherwise
+///
+
+#pragma once
+#ifndef __HOST_PROJECT_VERSION_HEADER__
+#define __HOST_PROJECT_VERSION_HEADER__
+
+#define _PROJECT_NAME          L"Host"
+#define _PROJECT_NAME_A        "Host"
+#define _PROJECT_SAFE_NAME     L"Host"
+#define _PROJECT_SAFE_NAME_A   "Host"
+#define _PROJECT_ARCH          L"Host"
+#define _PROJECT_ARCH_A        "Host"
+#define _PROJECT_SAFE_ARCH     L"Host"
+#define _PROJECT_SAFE_ARCH_A   "Host"
+#define _PROJECT_ROOT_PATH     L"\\EFI"
+#define _PROJECT_ROOT_PATH_A   "\\EFI"
+#define _PROJECT_VERSION       L"0.0.0"
+#define _PROJECT_VERSION_A     "0.0.0"
+#define _PROJECT_VERSIONCODE   PACK_VERSIONCODE_FULL(0, 0, 0)
+#define _PROJECT_DATETIME      L"Host"
+#define _PROJECT_DATETIME_A    "Host"
+
+#define _PROJECT_FIRMWARE_VERSION     L"2.70"
+#define _PROJECT_FIRMWARE_VERSION_A   "2.70"
+#define _PROJECT_FIRMWARE_VERSIONCODE PACK_VERSIONCODE_FULL(2, 70, 0)
+
+#endif // __HOST_PROJECT_VERSION_HEADER__
@@ -0,0 +1,13 @@
+//
+/// @file Test/Host/Include/Protocol/PciIo.h
+///
+/// Host stub of the PCI I/O protocol, which is opaque on the host
+///
+
+#pragma once
+#ifndef __HOST_PCI_IO_PROTOCOL_HEADER__
+#define __HOST_PCI_IO_PROTOCOL_HEADER__
+
+typedef struct _EFI_PCI_IO_PROTOCOL EFI_PCI_IO_PROTOCOL;
+
+#endif // __HOST_PCI_IO_PROTOCOL_HEADER__
@@ -0,0 +1,39 @@
+//
+/// @file Test/Host/Include/Protocol/SimpleFileSystem.h
+///
+/// Host stub of the simple file system protocol, file protocols are opaque host files
+///
+
+#pragma once
+#ifndef __HOST_SIMPLE_FILE_SYSTEM_PROTOCOL_HEADER__
+#define __HOST_SIMPLE_FILE_SYSTEM_PROTOCOL_HEADER__
+
+typedef struct _EFI_FILE_PROTOCOL EFI_FILE_PROTOCOL;
+typedef EFI_FILE_PROTOCOL        *EFI_FILE_HANDLE;
+
+#define EFI_FILE_MODE_READ   0x0000000000000001ULL
+#define EFI_FILE_MODE_WRITE  0x0000000000000002ULL
+#define EFI_FILE_MODE_CREATE 0x8000000000000000ULL
+
+#define EFI_FILE_READ_ONLY 0x0000000000000001ULL
+#define EFI_FILE_HIDDEN    0x0000000000000002ULL
+#define EFI_FILE_SYSTEM    0x0000000000000004ULL
+#define EFI_FILE_DIRECTORY 0x0000000000000010ULL
+#define EFI_FILE_ARCHIVE   0x0000000000000020ULL
+
+// EFI_FILE_INFO
+/// File information
+typedef struct {
+
+  UINT64   Size;
+  UINT64   FileSize;
+  UINT64   PhysicalSize;
+  EFI_TIME CreateTime;
+  EFI_TIME LastAccessTime;
+  EFI_TIME ModificationTime;
+  UINT64   Attribute;
+  CHAR16   FileName[1];
+
+} EFI_FILE_INFO;
+
+#endif // __HOST_SIMPLE_FILE_SYSTEM_PROTOCOL_HEADER__
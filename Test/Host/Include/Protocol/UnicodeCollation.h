@@ -0,0 +1,29 @@
+//
+/// @file Test/Host/Include/Protocol/UnicodeCollation.h
+///
+/// Host stub of the unicode collation protocol
+///
+
+#pragma once
+#ifndef __HOST_UNICODE_COLLATION_PROTOCOL_HEADER__
+#define __HOST_UNICODE_COLLATION_PROTOCOL_HEADER__
+
+typedef struct _EFI_UNICODE_COLLATION_PROTOCOL EFI_UNICODE_COLLATION_PROTOCOL;
+
+// EFI_UNICODE_COLLATION_PROTOCOL
+/// Unicode collation protocol
+struct _EFI_UNICODE_COLLATION_PROTOCOL {
+
+  INTN    (EFIAPI *StriColl)(IN EFI_UNICODE_COLLATION_PROTOCOL *This, IN CHAR16 *Str1, IN CHAR16 *Str2);
+  BOOLEAN (EFIAPI *MetaiMatch)(IN EFI_UNICODE_COLLATION_PROTOCOL *This, IN CHAR16 *String, IN CHAR16 *Pattern);
+  VOID    (EFIAPI *StrLwr)(IN EFI_UNICODE_COLLATION_PROTOCOL *This, IN OUT CHAR16 *Str);
+  VOID    (EFIAPI *StrUpr)(IN EFI_UNICODE_COLLATION_PROTOCOL *This, IN OUT CHAR16 *Str);
+  VOID    (EFIAPI *FatToStr)(IN EFI_UNICODE_COLLATION_PROTOCOL *This, IN UINTN FatSize, IN CHAR8 *Fat, OUT CHAR16 *String);
+  BOOLEAN (EFIAPI *StrToFat)(IN EFI_UNICODE_COLLATION_PROTOCOL *This, IN CHAR16 *String, IN UINTN FatSize, OUT CHAR8 *Fat);
+  CHAR8   *SupportedLanguages;
+
+};
+
+extern EFI_GUID gEfiUnicodeCollation2ProtocolGuid;
+
+#endif // __HOST_UNICODE_COLLATION_PROTOCOL_HEADER__
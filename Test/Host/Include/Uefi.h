@@ -0,0 +1,119 @@
+//
+/// @file Test/Host/Include/Uefi.h
+///
+/// Host stub of the UEFI types and services used by the libraries built on the host
+///
+
+#pragma once
+#ifndef __HOST_UEFI_HEADER__
+#define __HOST_UEFI_HEADER__
+
+#include <Base.h>
+
+typedef RETURN_STATUS EFI_STATUS;
+typedef VOID         *EFI_HANDLE;
+typedef VOID         *EFI_EVENT;
+typedef UINT64        EFI_PHYSICAL_ADDRESS;
+
+// EFI_GUID
+/// Globally unique identifier
+typedef struct {
+
+  UINT32 Data1;
+  UINT16 Data2;
+  UINT16 Data3;
+  UINT8  Data4[8];
+
+} EFI_GUID;
+
+// EFI_TIME
+/// Time representation
+typedef struct {
+
+  UINT16 Year;
+  UINT8  Month;
+  UINT8  Day;
+  UINT8  Hour;
+  UINT8  Minute;
+  UINT8  Second;
+  UINT8  Pad1;
+  UINT32 Nanosecond;
+  INT16  TimeZone;
+  UINT8  Daylight;
+  UINT8  Pad2;
+
+} EFI_TIME;
+
+#define EFI_ERROR(Status) RETURN_ERROR(Status)
+
+#define EFI_SUCCESS               ((EFI_STATUS)0)
+#define EFI_LOAD_ERROR            ENCODE_ERROR(1)
+#define EFI_INVALID_PARAMETER     ENCODE_ERROR(2)
+#define EFI_UNSUPPORTED           ENCODE_ERROR(3)
+#define EFI_BAD_BUFFER_SIZE       ENCODE_ERROR(4)
+#define EFI_BUFFER_TOO_SMALL      ENCODE_ERROR(5)
+#define EFI_NOT_READY             ENCODE_ERROR(6)
+#define EFI_DEVICE_ERROR          ENCODE_ERROR(7)
+#define EFI_WRITE_PROTECTED       ENCODE_ERROR(8)
+#define EFI_OUT_OF_RESOURCES      ENCODE_ERROR(9)
+#define EFI_VOLUME_CORRUPTED      ENCODE_ERROR(10)
+#define EFI_VOLUME_FULL           ENCODE_ERROR(11)
+#define EFI_NO_MEDIA              ENCODE_ERROR(12)
+#define EFI_MEDIA_CHANGED         ENCODE_ERROR(13)
+#define EFI_NOT_FOUND             ENCODE_ERROR(14)
+#define EFI_ACCESS_DENIED         ENCODE_ERROR(15)
+#define EFI_TIMEOUT               ENCODE_ERROR(18)
+#define EFI_ALREADY_STARTED       ENCODE_ERROR(20)
+#define EFI_ABORTED               ENCODE_ERROR(21)
+#define EFI_END_OF_FILE           ENCODE_ERROR(31)
+#define EFI_COMPROMISED_DATA      ENCODE_ERROR(33)
+#define EFI_WARN_BUFFER_TOO_SMALL ENCODE_WARNING(4)
+
+#define EFI_VARIABLE_NON_VOLATILE       0x00000001
+#define EFI_VARIABLE_BOOTSERVICE_ACCESS 0x00000002
+#define EFI_VARIABLE_RUNTIME_ACCESS     0x00000004
+
+// EFI_LOCATE_SEARCH_TYPE
+/// Handle search type
+typedef enum {
+
+  AllHandles = 0,
+  ByRegisterNotify,
+  ByProtocol,
+
+} EFI_LOCATE_SEARCH_TYPE;
+
+// EFI_RUNTIME_SERVICES
+/// The runtime services used on the host
+typedef struct {
+
+  EFI_STATUS (EFIAPI *GetVariable)(CHAR16 *Name, EFI_GUID *Guid, UINT32 *Attributes, UINTN *Size, VOID *Data);
+  EFI_STATUS (EFIAPI *SetVariable)(CHAR16 *Name, EFI_GUID *Guid, UINT32 Attributes, UINTN Size, VOID *Data);
+
+} EFI_RUNTIME_SERVICES;
+
+// EFI_BOOT_SERVICES
+/// The boot services used on the host
+typedef struct {
+
+  EFI_STATUS (EFIAPI *LocateProtocol)(EFI_GUID *Protocol, VOID *Registration, VOID **Interface);
+  EFI_STATUS (EFIAPI *InstallMultipleProtocolInterfaces)(EFI_HANDLE *Handle, ...);
+  EFI_STATUS (EFIAPI *UninstallMultipleProtocolInterfaces)(EFI_HANDLE Handle, ...);
+  EFI_STATUS (EFIAPI *LocateHandleBuffer)(EFI_LOCATE_SEARCH_TYPE SearchType, EFI_GUID *Protocol, VOID *SearchKey, UINTN *Count, EFI_HANDLE **Buffer);
+  EFI_STATUS (EFIAPI *HandleProtocol)(EFI_HANDLE Handle, EFI_GUID *Protocol, VOID **Interface);
+  EFI_STATUS (EFIAPI *Stall)(UINTN Microseconds);
+
+} EFI_BOOT_SERVICES;
+
+// EFI_SYSTEM_TABLE
+/// The system table used on the host
+typedef struct {
+
+  EFI_RUNTIME_SERVICES *RuntimeServices;
+  EFI_BOOT_SERVICES    *BootServices;
+
+} EFI_SYSTEM_TABLE;
+
+#include <Library/BaseLib.h>
+
+#endif // __HOST_UEFI_HEADER__
@@ -0,0 +1,383 @@
+///
+/// @file Test/Host/Regression/ConfigRegression.c
+///
+/// Configuration library regression tests
+///
+
+#include "Regression.h"
+
+#include <pthread.h>
+
+#include "../../../Library/ConfigLib/ConfigText.h"
+
+// CONFIG_REGRESSION_DEPTH
+/// The nesting depth of the deep configuration and property list documents
+#define CONFIG_REGRESSION_DEPTH 2000
+// CONFIG_REGRESSION_STACK_SIZE
+/// The stack size, in bytes, of the thread that maps the deep documents, too small for recursion to the nesting depth
+#define CONFIG_REGRESSION_STACK_SIZE 0x20000
+
+// mConfigRegressionIni
+/// INI with values that look like numbers but are not integers
+STATIC CHAR8 mConfigRegressionIni[] =
+  "[Boot]\n"
+  "Version = 10.15\n"
+  "Scale = 1e3\n"
+  "Mask = 0x1F\n"
+  "Offset = -3\n"
+  "Timeout = 5\n"
+  "Build = 21A5\n";
+// mConfigRegressionBadJson
+/// JSON that is malformed after its first value
+STATIC CHAR8 mConfigRegressionBadJson[] = "[1,]";
+// mConfigRegressionBadIni
+/// INI that is malformed after its first value
+STATIC CHAR8 mConfigRegressionBadIni[] = "Timeout = 5\n[Boot";
+// mConfigRegressionTextJson
+/// JSON fed one byte at a time as UTF-16
+STATIC CHAR16 mConfigRegressionTextJson[] = L"{\"Timeout\": 5, \"Theme\": \"\x00C9t\x00E9 \x30C6\x30FC\x30DE\"}";
+// mConfigRegressionTextIni
+/// INI fed one byte at a time as UTF-16
+STATIC CHAR16 mConfigRegressionTextIni[] = L"Timeout = 5\nTheme = \x00C9t\x00E9 \x30C6\x30FC\x30DE\n";
+// mConfigRegressionPlist
+/// Property list XML with integers at the limits and dates
+STATIC CHAR8 mConfigRegressionPlist[] =
+  "<?xml version=\"1.0\"?><plist version=\"1.0\"><dict>"
+  "<key>Big</key><integer>18446744073709551615</integer>"
+  "<key>Before</key><date>2000-12-31T23:59:59Z</date>"
+  "<key>Leap</key><date>2024-02-29T12:34:56Z</date>"
+  "<key>Min</key><integer>-9223372036854775808</integer>"
+  "</dict></plist>";
+// mConfigRegressionBplist
+/// The same property list as a binary property list, with a sixteen byte integer and real dates
+STATIC UINT8 mConfigRegressionBplist[] = {
+  0x62, 0x70, 0x6C, 0x69, 0x73, 0x74, 0x30, 0x30, 0xD4, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x53, 0x42, 0x69, 0x67, 0x56, 0x42, 0x65, 0x66, 0x6F, 0x72, 0x65, 0x54, 0x4C, 0x65, 0x61,
+  0x70, 0x53, 0x4D, 0x69, 0x6E, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x33, 0xBF, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x33,
+  0x41, 0xC5, 0xC8, 0x58, 0xB8, 0x00, 0x00, 0x00, 0x13, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x08, 0x11, 0x15, 0x1C, 0x21, 0x25, 0x36, 0x3F, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x51,
+};
+
+// ConfigRegressionIsString
+/// Check a configuration value is a string
+/// @param Path     The configuration path
+/// @param Expected The expected string
+/// @return Whether the configuration value is the expected string or not
+STATIC BOOLEAN
+EFIAPI
+ConfigRegressionIsString (
+  IN CHAR16 *Path,
+  IN CHAR16 *Expected
+) {
+  CHAR16 *Value = NULL;
+  return (!EFI_ERROR(ConfigGetString(L"%s", &Value, Path)) && (Value != NULL) && (StrCmp(Value, Expected) == 0));
+}
+// ConfigRegressionIsType
+/// Check the type of a configuration value
+/// @param Path     The configuration path
+/// @param Expected The expected configuration value type
+/// @return Whether the configuration value has the expected type or not
+STATIC BOOLEAN
+EFIAPI
+ConfigRegressionIsType (
+  IN CHAR16      *Path,
+  IN CONFIG_TYPE  Expected
+) {
+  CONFIG_TYPE Type = CONFIG_TYPE_UNKNOWN;
+  return (!EFI_ERROR(ConfigGetType(Path, &Type)) && (Type == Expected));
+}
+// ConfigRegressionTextBytes
+/// Parse configuration text encoded as UTF-16 one byte at a time
+/// @param Format    The configuration text format
+/// @param Text      The configuration text
+/// @param BigEndian Whether to encode big endian or little endian
+/// @param Bom       Whether to start with a byte order mark
+/// @return Whether the configuration text was parsed or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigRegressionTextBytes (
+  IN CONFIG_FORMAT  Format,
+  IN CHAR16        *Text,
+  IN BOOLEAN        BigEndian,
+  IN BOOLEAN        Bom
+) {
+  EFI_STATUS   Status;
+  CONFIG_TEXT *Parser = NULL;
+  UINT8        Bytes[2];
+  Status = ConfigTextCreate(&Parser, Format);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  if (Bom) {
+    Bytes[0] = BigEndian ? 0xFE : 0xFF;
+    Bytes[1] = BigEndian ? 0xFF : 0xFE;
+    Status = ConfigTextParse(Parser, 1, Bytes);
+    if (!EFI_ERROR(Status)) {
+      Status = ConfigTextParse(Parser, 1, Bytes + 1);
+    }
+  }
+  for (; !EFI_ERROR(Status) && (*Text != L'\0'); ++Text) {
+    Bytes[0] = (UINT8)(BigEndian ? (*Text >> 8) : *Text);
+    Bytes[1] = (UINT8)(BigEndian ? *Text : (*Text >> 8));
+    Status = ConfigTextParse(Parser, 1, Bytes);
+    if (!EFI_ERROR(Status)) {
+      Status = ConfigTextParse(Parser, 1, Bytes + 1);
+    }
+  }
+  if (!EFI_ERROR(Status)) {
+    Status = ConfigTextFinish(Parser);
+  }
+  ConfigTextFree(Parser);
+  return Status;
+}
+
+// ConfigRegressionUtf16Bytes
+/// JSON and INI encoded as UTF-16 and fed one byte at a time must be detected as UTF-16 with or without a byte order mark
+STATIC VOID
+EFIAPI
+ConfigRegressionUtf16Bytes (
+  VOID
+) {
+  INTN  Integer;
+  UINTN Case;
+  for (Case = 0; Case < 8; ++Case) {
+    // Each case is a combination of big endian, byte order mark and format
+    Integer = 0;
+    if ((Case & 4) != 0) {
+      REGRESSION_CHECK(!EFI_ERROR(ConfigRegressionTextBytes(CONFIG_FORMAT_INI, mConfigRegressionTextIni, ((Case & 1) != 0), ((Case & 2) != 0))));
+    } else {
+      REGRESSION_CHECK(!EFI_ERROR(ConfigRegressionTextBytes(CONFIG_FORMAT_JSON, mConfigRegressionTextJson, ((Case & 1) != 0), ((Case & 2) != 0))));
+    }
+    REGRESSION_CHECK(!EFI_ERROR(ConfigGetInteger(L"\\Timeout", &Integer)) && (Integer == 5));
+    REGRESSION_CHECK(ConfigRegressionIsString(L"\\Theme", L"\x00C9t\x00E9 \x30C6\x30FC\x30DE"));
+    ConfigFree();
+  }
+}
+// ConfigRegressionIniNumbers
+/// Only decimal and hexadecimal INI values are integers, numbers with a fraction or exponent stay strings
+STATIC VOID
+EFIAPI
+ConfigRegressionIniNumbers (
+  VOID
+) {
+  INTN  Integer = 0;
+  UINTN Unsigned = 0;
+  REGRESSION_CHECK(!EFI_ERROR(ConfigParseIni(sizeof(mConfigRegressionIni) - 1, mConfigRegressionIni, L"Regression.ini")));
+  REGRESSION_CHECK(ConfigRegressionIsString(L"\\Boot\\Version", L"10.15"));
+  REGRESSION_CHECK(ConfigRegressionIsString(L"\\Boot\\Scale", L"1e3"));
+  REGRESSION_CHECK(ConfigRegressionIsString(L"\\Boot\\Build", L"21A5"));
+  REGRESSION_CHECK(ConfigRegressionIsType(L"\\Boot\\Mask", CONFIG_TYPE_UNSIGNED));
+  REGRESSION_CHECK(!EFI_ERROR(ConfigGetUnsigned(L"\\Boot\\Mask", &Unsigned)) && (Unsigned == 0x1F));
+  REGRESSION_CHECK(ConfigRegressionIsType(L"\\Boot\\Offset", CONFIG_TYPE_INTEGER));
+  REGRESSION_CHECK(!EFI_ERROR(ConfigGetInteger(L"\\Boot\\Offset", &Integer)) && (Integer == -3));
+  REGRESSION_CHECK(!EFI_ERROR(ConfigGetInteger(L"\\Boot\\Timeout", &Integer)) && (Integer == 5));
+  ConfigFree();
+}
+// ConfigRegressionMalformed
+/// Malformed JSON and INI must not set the values parsed before the error, the same as XML
+STATIC VOID
+EFIAPI
+ConfigRegressionMalformed (
+  VOID
+) {
+  REGRESSION_CHECK(EFI_ERROR(ConfigParseJson(sizeof(mConfigRegressionBadJson) - 1, mConfigRegressionBadJson, L"Regression.json")));
+  REGRESSION_CHECK(ConfigExists(L"\\0") == EFI_NOT_FOUND);
+  REGRESSION_CHECK(EFI_ERROR(ConfigParseIni(sizeof(mConfigRegressionBadIni) - 1, mConfigRegressionBadIni, L"Regression.ini")));
+  REGRESSION_CHECK(ConfigExists(L"\\Timeout") == EFI_NOT_FOUND);
+  ConfigFree();
+}
+// ConfigRegressionPlistValues
+/// Check the values of the regression property list
+STATIC VOID
+EFIAPI
+ConfigRegressionPlistValues (
+  VOID
+) {
+  INTN  Integer = 0;
+  UINTN Unsigned = 0;
+  REGRESSION_CHECK(ConfigRegressionIsType(L"\\Big", CONFIG_TYPE_UNSIGNED));
+  REGRESSION_CHECK(!EFI_ERROR(ConfigGetUnsigned(L"\\Big", &Unsigned)) && (Unsigned == MAX_UINTN));
+  REGRESSION_CHECK(ConfigRegressionIsType(L"\\Min", CONFIG_TYPE_INTEGER));
+  REGRESSION_CHECK(!EFI_ERROR(ConfigGetInteger(L"\\Min", &Integer)) && (Integer == MIN_INTN));
+  REGRESSION_CHECK(ConfigRegressionIsString(L"\\Before", L"2000-12-31T23:59:59Z"));
+  REGRESSION_CHECK(ConfigRegressionIsString(L"\\Leap", L"2024-02-29T12:34:56Z"));
+  ConfigFree();
+}
+// ConfigRegressionPlists
+/// Property list XML and binary property lists must map integers above the largest integer and dates the same way
+STATIC VOID
+EFIAPI
+ConfigRegressionPlists (
+  VOID
+) {
+  REGRESSION_CHECK(!EFI_ERROR(ConfigParse(sizeof(mConfigRegressionPlist) - 1, mConfigRegressionPlist, L"Regression.plist")));
+  ConfigRegressionPlistValues();
+  REGRESSION_CHECK(!EFI_ERROR(ConfigParseBinaryPlist(sizeof(mConfigRegressionBplist), mConfigRegressionBplist, L"Regression.plist")));
+  ConfigRegressionPlistValues();
+}
+
+// CONFIG_REGRESSION_DEEP
+/// A deep document mapped on a small stack
+typedef struct _CONFIG_REGRESSION_DEEP CONFIG_REGRESSION_DEEP;
+struct _CONFIG_REGRESSION_DEEP {
+
+  // Tree
+  /// The XML document tree root node to map
+  XML_TREE   *Tree;
+  // Status
+  /// The status of mapping the document
+  EFI_STATUS  Status;
+
+};
+
+// ConfigRegressionDeepDocument
+/// Create a document nested to the regression depth
+/// @param Open  The text opening the document
+/// @param Begin The text opening each level
+/// @param Leaf  The text of the innermost value
+/// @param End   The text closing each level
+/// @param Close The text closing the document
+/// @param Size  On output, the size, in bytes, of the document
+/// @return The document which must be freed or NULL if memory could not be allocated
+STATIC CHAR8 *
+EFIAPI
+ConfigRegressionDeepDocument (
+  IN  CONST CHAR8 *Open,
+  IN  CONST CHAR8 *Begin,
+  IN  CONST CHAR8 *Leaf,
+  IN  CONST CHAR8 *End,
+  IN  CONST CHAR8 *Close,
+  OUT UINTN       *Size
+) {
+  CHAR8 *Document;
+  CHAR8 *Ptr;
+  UINTN  Index;
+  *Size = AsciiStrLen(Open) + (CONFIG_REGRESSION_DEPTH * (AsciiStrLen(Begin) + AsciiStrLen(End))) + AsciiStrLen(Leaf) + AsciiStrLen(Close);
+  Document = (CHAR8 *)AllocatePool(*Size + 1);
+  if (Document == NULL) {
+    return NULL;
+  }
+  Ptr = Document;
+  CopyMem(Ptr, Open, AsciiStrLen(Open));
+  Ptr += AsciiStrLen(Open);
+  for (Index = 0; Index < CONFIG_REGRESSION_DEPTH; ++Index) {
+    CopyMem(Ptr, Begin, AsciiStrLen(Begin));
+    Ptr += AsciiStrLen(Begin);
+  }
+  CopyMem(Ptr, Leaf, AsciiStrLen(Leaf));
+  Ptr += AsciiStrLen(Leaf);
+  for (Index = 0; Index < CONFIG_REGRESSION_DEPTH; ++Index) {
+    CopyMem(Ptr, End, AsciiStrLen(End));
+    Ptr += AsciiStrLen(End);
+  }
+  CopyMem(Ptr, Close, AsciiStrLen(Close));
+  Ptr += AsciiStrLen(Close);
+  *Ptr = '\0';
+  return Document;
+}
+// ConfigRegressionDeepThread
+/// Map a deep document tree to configuration values on the small stack thread
+/// @param Context The deep document
+/// @return NULL
+STATIC VOID *
+ConfigRegressionDeepThread (
+  IN VOID *Context
+) {
+  CONFIG_REGRESSION_DEEP *Deep = (CONFIG_REGRESSION_DEEP *)Context;
+  Deep->Status = ConfigParseXml(Deep->Tree, L"Regression.xml");
+  return NULL;
+}
+// ConfigRegressionDeepParse
+/// Parse a deep document and map it to configuration values on a small stack
+/// @param Size     The size, in bytes, of the document
+/// @param Document The document
+/// @return Whether the document was mapped or not
+STATIC EFI_STATUS
+EFIAPI
+ConfigRegressionDeepParse (
+  IN UINTN  Size,
+  IN CHAR8 *Document
+) {
+  CONFIG_REGRESSION_DEEP Deep = { NULL, EFI_ABORTED };
+  XML_PARSER             *Parser = NULL;
+  pthread_attr_t          Attributes;
+  pthread_t               Thread;
+  // The document is parsed without recursion so only the mapping needs the small stack
+  if (EFI_ERROR(XmlCreate(&Parser)) || (Parser == NULL)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  if (!EFI_ERROR(XmlParse(Parser, Size, Document)) && !EFI_ERROR(XmlGetTree(Parser, &Deep.Tree)) && (Deep.Tree != NULL) &&
+      (pthread_attr_init(&Attributes) == 0)) {
+    if ((pthread_attr_setstacksize(&Attributes, CONFIG_REGRESSION_STACK_SIZE) == 0) &&
+        (pthread_create(&Thread, &Attributes, ConfigRegressionDeepThread, &Deep) == 0)) {
+      pthread_join(Thread, NULL);
+    }
+    pthread_attr_destroy(&Attributes);
+  }
+  XmlFree(Parser);
+  return Deep.Status;
+}
+// ConfigRegressionDeep
+/// Configuration XML nested deeper than the stack allows recursion is mapped, deep property lists are rejected at their depth limit
+STATIC VOID
+EFIAPI
+ConfigRegressionDeep (
+  VOID
+) {
+  CHAR16 *Path;
+  CHAR16 *Ptr;
+  CHAR8  *Document;
+  CHAR16 *Value = NULL;
+  UINTN   Size = 0;
+  UINTN   Index;
+  // Deep configuration with a value at the bottom
+  Document = ConfigRegressionDeepDocument("<?xml version=\"1.0\"?><configuration>", "<a>", "<Value>7</Value>", "</a>", "</configuration>", &Size);
+  REGRESSION_CHECK(Document != NULL);
+  Path = (CHAR16 *)AllocatePool(((CONFIG_REGRESSION_DEPTH * 2) + 7) * sizeof(CHAR16));
+  REGRESSION_CHECK(Path != NULL);
+  if ((Document != NULL) && (Path != NULL)) {
+    REGRESSION_CHECK(!EFI_ERROR(ConfigRegressionDeepParse(Size, Document)));
+    Ptr = Path;
+    for (Index = 0; Index < CONFIG_REGRESSION_DEPTH; ++Index) {
+      *Ptr++ = L'\\';
+      *Ptr++ = L'a';
+    }
+    StrCpyS(Ptr, 7, L"\\Value");
+    REGRESSION_CHECK(!EFI_ERROR(ConfigGetString(L"%s", &Value, Path)) && (Value != NULL) && (StrCmp(Value, L"7") == 0));
+  }
+  if (Path != NULL) {
+    FreePool(Path);
+  }
+  if (Document != NULL) {
+    FreePool(Document);
+  }
+  ConfigFree();
+  // Deep property list arrays
+  Document = ConfigRegressionDeepDocument("<?xml version=\"1.0\"?><plist version=\"1.0\">", "<array>", "<integer>7</integer>", "</array>", "</plist>", &Size);
+  REGRESSION_CHECK(Document != NULL);
+  if (Document != NULL) {
+    REGRESSION_CHECK(ConfigRegressionDeepParse(Size, Document) == EFI_INVALID_PARAMETER);
+    REGRESSION_CHECK(ConfigExists(L"\\0") == EFI_NOT_FOUND);
+    FreePool(Document);
+  }
+  ConfigFree();
+}
+
+// ConfigRegressionRun
+/// Run the configuration library regression tests
+STATIC VOID
+EFIAPI
+ConfigRegressionRun (
+  VOID
+) {
+  ConfigRegressionUtf16Bytes();
+  ConfigRegressionIniNumbers();
+  ConfigRegressionMalformed();
+  ConfigRegressionPlists();
+  ConfigRegressionDeep();
+}
+
+REGRESSION_MAIN("ConfigRegression", ConfigRegressionRun)
@@ -0,0 +1,95 @@
+///
+/// @file Test/Host/Regression/ParseRegression.c
+///
+/// Parse library regression tests
+///
+
+#include "Regression.h"
+
+// PARSE_REGRESSION_STATE
+/// The only state of the regression parser
+#define PARSE_REGRESSION_STATE 0
+// PARSE_REGRESSION_MAX_TOKENS
+/// The maximum length of the joined tokens
+#define PARSE_REGRESSION_MAX_TOKENS 256
+
+// mParseRegressionStates
+/// A markup open with a longer token that starts with a shorter token
+DECL_LANG_STATES(mParseRegressionStates)
+  DECL_LANG_STATE(PARSE_REGRESSION_STATE, 3)
+    DECL_LANG_RULE(LANG_RULE_TOKEN, PARSE_REGRESSION_STATE, 1, L"<!"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN, PARSE_REGRESSION_STATE, 1, L"<!--"),
+    DECL_LANG_RULE(LANG_RULE_TOKEN, PARSE_REGRESSION_STATE, 1, L">"),
+  END_LANG_STATE(),
+END_LANG_STATES();
+
+// ParseRegressionCallback
+/// Join every parsed token with a separator
+/// @param Parser  The language parser
+/// @param StateId The current language parser state identifier
+/// @param Token   The parsed token
+/// @param Context The joined tokens
+/// @return EFI_SUCCESS
+STATIC EFI_STATUS
+EFIAPI
+ParseRegressionCallback (
+  IN OUT LANG_PARSER *Parser,
+  IN     UINTN        StateId,
+  IN     CHAR16      *Token,
+  IN     VOID        *Context OPTIONAL
+) {
+  CHAR16 *Tokens = (CHAR16 *)Context;
+  UINTN   Length = StrLen(Tokens);
+  UnicodeSPrint(Tokens + Length, (PARSE_REGRESSION_MAX_TOKENS - Length) * sizeof(CHAR16), L"%s|", Token);
+  return EFI_SUCCESS;
+}
+// ParseRegressionTokens
+/// Parse a string with the regression parser and check the joined tokens
+/// @param String   The string to parse
+/// @param Expected The expected joined tokens
+/// @return Whether the joined tokens matched or not
+STATIC BOOLEAN
+EFIAPI
+ParseRegressionTokens (
+  IN CHAR16 *String,
+  IN CHAR16 *Expected
+) {
+  LANG_PARSER *Parser = NULL;
+  CHAR16       Tokens[PARSE_REGRESSION_MAX_TOKENS] = { 0 };
+  BOOLEAN      Result;
+  if (EFI_ERROR(CreateParserFromStates(&Parser, ParseRegressionCallback, PARSE_REGRESSION_STATE,
+                                       ARRAY_SIZE(mParseRegressionStates), mParseRegressionStates))) {
+    return FALSE;
+  }
+  Result = !EFI_ERROR(Parse(Parser, 0, String, FALSE, Tokens)) && (StrCmp(Tokens, Expected) == 0);
+  if (!Result) {
+    HostPrint(L"  parsed \"%s\" as \"%s\", expected \"%s\"\n", String, Tokens, Expected);
+  }
+  FreeParser(Parser);
+  return Result;
+}
+
+// ParseRegressionDeferredMatch
+/// A shorter token deferred while a longer token was still possible must match once the longer token is no longer possible,
+///  the last token is never matched because the next character could still extend it
+STATIC VOID
+EFIAPI
+ParseRegressionDeferredMatch (
+  VOID
+) {
+  REGRESSION_CHECK(ParseRegressionTokens(L"<!-x>.", L"<!|-x|>|"));
+  REGRESSION_CHECK(ParseRegressionTokens(L"<!x>.", L"<!|x|>|"));
+  REGRESSION_CHECK(ParseRegressionTokens(L"<!--x>.", L"<!--|x|>|"));
+  REGRESSION_CHECK(ParseRegressionTokens(L"a<!-x>.", L"a|<!|-x|>|"));
+}
+// ParseRegressionRun
+/// Run the parse library regression tests
+STATIC VOID
+EFIAPI
+ParseRegressionRun (
+  VOID
+) {
+  ParseRegressionDeferredMatch();
+}
+
+REGRESSION_MAIN("ParseRegression", ParseRegressionRun)
@@ -0,0 +1,53 @@
+//
+/// @file Test/Host/Regression/Regression.h
+///
+/// Regression test helpers
+///
+
+#pragma once
+#ifndef __HOST_REGRESSION_HEADER__
+#define __HOST_REGRESSION_HEADER__
+
+#include <stdio.h>
+
+#include "../HostLib.h"
+
+#include <Library/PrintLib.h>
+
+// REGRESSION_CHECK
+/// Check a regression condition and report it if it failed
+/// @param Condition The condition that must be true
+#define REGRESSION_CHECK(Condition) \
+  do { \
+    ++mRegressionChecks; \
+    if (!(Condition)) { \
+      ++mRegressionFailures; \
+      fprintf(stderr, "%s:%d: %s: check failed: %s\n", __FILE__, __LINE__, __func__, #Condition); \
+    } \
+  } while (0)
+
+// REGRESSION_MAIN
+/// Define the main function of a regression test that initializes the host libraries, runs the cases, and checks every allocation was freed
+/// @param Name The name of the regression test
+/// @param Run  The function that runs the cases
+#define REGRESSION_MAIN(Name, Run) \
+  int \
+  main ( \
+    VOID \
+  ) { \
+    REGRESSION_CHECK(!EFI_ERROR(HostLibInitialize())); \
+    Run(); \
+    HostLibFinish(); \
+    REGRESSION_CHECK(HostGetLiveAllocations() == 0); \
+    fprintf(stderr, "%s: %u of %u checks passed\n", Name, mRegressionChecks - mRegressionFailures, mRegressionChecks); \
+    return (mRegressionFailures == 0) ? 0 : 1; \
+  }
+
+// mRegressionChecks
+/// The count of checks
+STATIC UINT32 mRegressionChecks = 0;
+// mRegressionFailures
+/// The count of failed checks
+STATIC UINT32 mRegressionFailures = 0;
+
+#endif // __HOST_REGRESSION_HEADER__
@@ -0,0 +1,196 @@
+///
+/// @file Test/Host/Regression/StringRegression.c
+///
+/// String library regression tests
+///
+
+#include "Regression.h"
+
+// STRING_REGRESSION_WORD_LENGTH
+/// The longest string compared at each alignment, long enough for several words of characters
+#define STRING_REGRESSION_WORD_LENGTH 24
+// STRING_REGRESSION_WORD_SIZE
+/// The count of words in each aligned buffer, enough for the longest string at the last alignment
+#define STRING_REGRESSION_WORD_SIZE (((STRING_REGRESSION_WORD_LENGTH + 1) * sizeof(CHAR16) / sizeof(UINTN)) + 2)
+
+// StringRegressionFoldOrder
+/// Case-insensitive order must not change when a collation protocol is found for the language
+STATIC VOID
+EFIAPI
+StringRegressionFoldOrder (
+  VOID
+) {
+  STR_LIST  List;
+  INTN      Order;
+  CHAR16   *Value = NULL;
+  // Insert configuration keys that fold between upper and lower case letters with the default language
+  REGRESSION_CHECK(!EFI_ERROR(ConfigSetString(L"\\Boot\\BootA", L"A", TRUE)));
+  REGRESSION_CHECK(!EFI_ERROR(ConfigSetString(L"\\Boot\\Boot_x", L"x", TRUE)));
+  Order = StriCmp(L"Boot_x", L"BootA");
+  REGRESSION_CHECK(Order < 0);
+  // Change to a language with a collation protocol
+  HostSetCollation(TRUE);
+  REGRESSION_CHECK(!EFI_ERROR(SetLanguage("fr")));
+  REGRESSION_CHECK(StriCmp(L"Boot_x", L"BootA") == Order);
+  REGRESSION_CHECK(StriColl(L"Boot_x", L"BootA") == Order);
+  REGRESSION_CHECK(StriCmp(L"\x00C9" L"cole", L"\x00E9" L"COLE") == 0);
+  REGRESSION_CHECK(MetaiMatch(L"\x00C9" L"cole", L"*\x00C9" L"COLE"));
+  // Find the keys inserted before the language changed
+  REGRESSION_CHECK(!EFI_ERROR(ConfigGetString(L"\\Boot\\BootA", &Value)) && (Value != NULL) && (StrCmp(Value, L"A") == 0));
+  Value = NULL;
+  REGRESSION_CHECK(!EFI_ERROR(ConfigGetString(L"\\Boot\\Boot_x", &Value)) && (Value != NULL) && (StrCmp(Value, L"x") == 0));
+  ConfigFree();
+  // Hashed case-insensitive lists find duplicates folded the same way as StriCmp
+  ZeroMem(&List, sizeof(List));
+  List.Options = STR_LIST_NO_DUPLICATES | STR_LIST_CASE_INSENSITIVE | STR_LIST_HASHED;
+  REGRESSION_CHECK(!EFI_ERROR(StrListAdd(&List, L"\x00C9" L"cole", 0)));
+  REGRESSION_CHECK(!EFI_ERROR(StrListAdd(&List, L"Boot_x", 0)));
+  REGRESSION_CHECK(StrListAdd(&List, L"\x00E9" L"COLE", 0) == EFI_ACCESS_DENIED);
+  REGRESSION_CHECK(StrListAdd(&List, L"BOOT_X", 0) == EFI_ACCESS_DENIED);
+  StrListClear(&List);
+  // Return to the default language
+  REGRESSION_CHECK(!EFI_ERROR(SetLanguage(NULL)));
+  HostSetCollation(FALSE);
+}
+// StringRegressionLanguage
+/// Setting the language must only write the platform language when it changed, even when changed elsewhere, and must
+///  search again for a collation protocol that was not found
+STATIC VOID
+EFIAPI
+StringRegressionLanguage (
+  VOID
+) {
+  CHAR8 *Language = NULL;
+  UINTN  Writes;
+  UINTN  Searches;
+  // Only changed languages are written
+  Writes = HostGetVariableWrites();
+  REGRESSION_CHECK(!EFI_ERROR(SetLanguage("fr")));
+  REGRESSION_CHECK(HostGetVariableWrites() == (Writes + 1));
+  REGRESSION_CHECK(!EFI_ERROR(SetLanguage("fr")));
+  REGRESSION_CHECK(HostGetVariableWrites() == (Writes + 1));
+  // The platform language changed elsewhere is written again
+  REGRESSION_CHECK(!EFI_ERROR(HostSetVariable(L"PlatformLang", "de")));
+  REGRESSION_CHECK(!EFI_ERROR(SetLanguage("fr")));
+  REGRESSION_CHECK(HostGetVariableWrites() == (Writes + 2));
+  REGRESSION_CHECK(!EFI_ERROR(GetLanguage(&Language)) && (Language != NULL) && (AsciiStrCmp(Language, "fr") == 0));
+  if (Language != NULL) {
+    FreePool(Language);
+  }
+  // Languages without a collation protocol are searched again until one is installed
+  HostSetCollation(FALSE);
+  Searches = HostGetProtocolSearches();
+  REGRESSION_CHECK(!EFI_ERROR(SetLanguage("de")));
+  REGRESSION_CHECK(!EFI_ERROR(SetLanguage("de")));
+  REGRESSION_CHECK(HostGetProtocolSearches() == (Searches + 2));
+  HostSetCollation(TRUE);
+  REGRESSION_CHECK(!EFI_ERROR(SetLanguage("de")));
+  REGRESSION_CHECK(!EFI_ERROR(SetLanguage("de")));
+  REGRESSION_CHECK(HostGetProtocolSearches() == (Searches + 3));
+  // Return to the default language
+  REGRESSION_CHECK(!EFI_ERROR(SetLanguage(NULL)));
+  HostSetCollation(FALSE);
+}
+
+// StringRegressionSign
+/// Get the sign of a comparison
+/// @param Order The comparison
+/// @return -1, 0, or 1
+STATIC INTN
+EFIAPI
+StringRegressionSign (
+  IN INTN Order
+) {
+  return (Order < 0) ? -1 : ((Order > 0) ? 1 : 0);
+}
+// StringRegressionWordAccess
+/// Comparisons and searches must give the same results at every alignment of both strings, with the first difference at
+///  every position, so the word at a time loops are checked against the expected character at a time results
+STATIC VOID
+EFIAPI
+StringRegressionWordAccess (
+  VOID
+) {
+  UINTN    Buffer1[STRING_REGRESSION_WORD_SIZE];
+  UINTN    Buffer2[STRING_REGRESSION_WORD_SIZE];
+  CHAR16  *Str1;
+  CHAR16  *Str2;
+  CHAR8   *Ascii1;
+  CHAR8   *Ascii2;
+  UINTN    Offset1;
+  UINTN    Offset2;
+  UINTN    Length;
+  UINTN    Diff;
+  UINTN    Index;
+  INTN     Expected;
+  BOOLEAN  Compare = TRUE;
+  BOOLEAN  CompareCount = TRUE;
+  BOOLEAN  AsciiCompareCount = TRUE;
+  BOOLEAN  Search = TRUE;
+  for (Offset1 = 0; Offset1 < sizeof(UINTN); ++Offset1) {
+    for (Offset2 = 0; Offset2 < sizeof(UINTN); ++Offset2) {
+      for (Length = 0; Length <= STRING_REGRESSION_WORD_LENGTH; ++Length) {
+        for (Diff = 0; Diff <= Length; ++Diff) {
+          // The strings differ only in case before the first difference, which sorts before the letters
+          SetMem(Buffer1, sizeof(Buffer1), 0xFF);
+          SetMem(Buffer2, sizeof(Buffer2), 0xFF);
+          Str1 = ((CHAR16 *)Buffer1) + (Offset1 >> 1);
+          Str2 = ((CHAR16 *)Buffer2) + (Offset2 >> 1);
+          for (Index = 0; Index < Length; ++Index) {
+            Str1[Index] = (CHAR16)(L'a' + Index);
+            Str2[Index] = (CHAR16)(((Index & 1) != 0) ? (L'A' + Index) : (L'a' + Index));
+          }
+          if (Diff < Length) {
+            Str2[Diff] = L'0';
+          }
+          Str1[Length] = L'\0';
+          Str2[Length] = L'\0';
+          Expected = (Diff < Length) ? 1 : 0;
+          if (StringRegressionSign(StriCmp(Str1, Str2)) != Expected) {
+            HostPrint(L"  StriCmp %u %u %u %u\n", Offset1 >> 1, Offset2 >> 1, Length, Diff);
+            Compare = FALSE;
+          }
+          if ((StrniCmp(Str1, Str2, Diff) != 0) || (StringRegressionSign(StrniCmp(Str1, Str2, Diff + 1)) != Expected) ||
+              (StringRegressionSign(StrniCmp(Str2, Str1, Length + 1)) != -Expected)) {
+            HostPrint(L"  StrniCmp %u %u %u %u\n", Offset1 >> 1, Offset2 >> 1, Length, Diff);
+            CompareCount = FALSE;
+          }
+          if ((Diff == Length) && (Length > 0) && (StriStr(Str2, Str1 + (Length >> 1)) != (Str2 + (Length >> 1)))) {
+            HostPrint(L"  StriStr %u %u %u\n", Offset1 >> 1, Offset2 >> 1, Length);
+            Search = FALSE;
+          }
+          // The same strings as ASCII at every byte alignment
+          Ascii1 = ((CHAR8 *)Buffer1) + Offset1;
+          Ascii2 = ((CHAR8 *)Buffer2) + Offset2;
+          for (Index = 0; Index <= Length; ++Index) {
+            Ascii1[Index] = (CHAR8)((Index < Length) ? Str1[Index] : 0);
+            Ascii2[Index] = (CHAR8)((Index < Length) ? Str2[Index] : 0);
+          }
+          if ((AsciiStrniCmp(Ascii1, Ascii2, Diff) != 0) || (StringRegressionSign(AsciiStrniCmp(Ascii1, Ascii2, Diff + 1)) != Expected) ||
+              (StringRegressionSign(AsciiStrniCmp(Ascii2, Ascii1, Length + 1)) != -Expected)) {
+            HostPrint(L"  AsciiStrniCmp %u %u %u %u\n", Offset1, Offset2, Length, Diff);
+            AsciiCompareCount = FALSE;
+          }
+        }
+      }
+    }
+  }
+  REGRESSION_CHECK(Compare);
+  REGRESSION_CHECK(CompareCount);
+  REGRESSION_CHECK(Search);
+  REGRESSION_CHECK(AsciiCompareCount);
+}
+
+// StringRegressionRun
+/// Run the string library regression tests
+STATIC VOID
+EFIAPI
+StringRegressionRun (
+  VOID
+) {
+  StringRegressionFoldOrder();
+  StringRegressionLanguage();
+  StringRegressionWordAccess();
+}
+
+REGRESSION_MAIN("StringRegression", StringRegressionRun)
@@ -0,0 +1,479 @@
+///
+/// @file Test/Host/Regression/XmlRegression.c
+///
+/// XML library regression tests
+///
+
+#include "Regression.h"
+
+// XML_REGRESSION_DEPTH
+/// The depth of the deeply nested document
+#define XML_REGRESSION_DEPTH 400
+// XML_REGRESSION_DECLARATION
+/// The XML declaration that starts each document
+#define XML_REGRESSION_DECLARATION "<?xml version=\"1.0\"?>"
+// XML_REGRESSION_UTF16_BODY
+/// The body of the UTF-16 documents
+#define XML_REGRESSION_UTF16_BODY "<r><a id=\"1\">x</a><a id=\"2\"/></r>"
+// XML_REGRESSION_ATTRIBUTE_PIECES
+/// The count of text and entity pieces in the long attribute value
+#define XML_REGRESSION_ATTRIBUTE_PIECES 4000
+
+// XML_REGRESSION_QUERY
+/// XML query and the count of matches expected
+typedef struct _XML_REGRESSION_QUERY XML_REGRESSION_QUERY;
+struct _XML_REGRESSION_QUERY {
+
+  // Path
+  /// The query path
+  CHAR16 *Path;
+  // Count
+  /// The count of matches expected
+  UINTN   Count;
+
+};
+
+// mXmlRegressionDocument
+/// Document with nested tags of the same name
+STATIC CHAR8                mXmlRegressionDocument[] =
+  XML_REGRESSION_DECLARATION "<r><a id=\"1\"><b/><a id=\"2\"><b/><c><b/><a id=\"3\"/></c></a></a><b/><c><a/></c></r>";
+// mXmlRegressionMixed
+/// Document with tree nodes that have both values and child nodes
+STATIC CHAR8                mXmlRegressionMixed[] =
+  XML_REGRESSION_DECLARATION "<r><p>Hello <b>bold</b> world</p><q><s>v</s><t/><u><w>x<i/>y</w></u></q><m a=\"1\">x<i><j/></i>y</m></r>";
+// mXmlRegressionEntities
+/// Document with XML entities in any case, a non-breaking space, and case-sensitive HTML entities
+STATIC CHAR8                mXmlRegressionEntities[] =
+  XML_REGRESSION_DECLARATION "<r><a>&AMP;&Lt;&gT;&QUOT;&Apos;&NBSP;x&nbsp;y</a><b>&Aacute;&aacute;</b><c v=\"&LT;&Nbsp;\"/></r>";
+// mXmlRegressionQueries
+/// Queries of the document
+STATIC XML_REGRESSION_QUERY mXmlRegressionQueries[] = {
+  { L"/r", 1 },
+  { L"/a", 0 },
+  { L".//c", 2 },
+  { L"a", 1 },
+  { L"b", 1 },
+  { L"//a", 4 },
+  { L"//a//a", 2 },
+  { L"//a/a", 1 },
+  { L"//a//b", 3 },
+  { L"//a/b", 2 },
+  { L"//c/a", 2 },
+  { L"//a//c//a", 1 },
+  { L"//a[@id='2']//a", 1 },
+  { L"//a//a//a//a", 0 },
+  { L"//*", 11 },
+  { L"//*//*//*", 7 },
+  { L"a/a/c/a", 1 },
+  { L"*[2]", 1 },
+  { L"//b[1]", 4 },
+};
+
+// XmlRegressionUtf16
+/// Encode an ASCII document as UTF-16
+/// @param Document  The ASCII document
+/// @param BigEndian Whether to encode big endian or little endian
+/// @param Bom       Whether to start with a byte order mark
+/// @param Size      On output, the size, in bytes, of the encoded document
+/// @return The encoded document, which must be freed, or NULL if memory could not be allocated
+STATIC UINT8 *
+EFIAPI
+XmlRegressionUtf16 (
+  IN  CHAR8   *Document,
+  IN  BOOLEAN  BigEndian,
+  IN  BOOLEAN  Bom,
+  OUT UINTN   *Size
+) {
+  UINT8 *Encoded;
+  UINTN  Length = AsciiStrLen(Document);
+  UINTN  Index = 0;
+  *Size = (Length + (Bom ? 1 : 0)) * sizeof(CHAR16);
+  Encoded = (UINT8 *)AllocatePool(*Size);
+  if (Encoded == NULL) {
+    return NULL;
+  }
+  if (Bom) {
+    Encoded[0] = BigEndian ? 0xFE : 0xFF;
+    Encoded[1] = BigEndian ? 0xFF : 0xFE;
+    Index = 2;
+  }
+  for (; *Document != '\0'; ++Document, Index += 2) {
+    Encoded[Index] = BigEndian ? 0 : (UINT8)*Document;
+    Encoded[Index + 1] = BigEndian ? (UINT8)*Document : 0;
+  }
+  return Encoded;
+}
+// XmlRegressionParse
+/// Parse an XML document
+/// @param Size     The size, in bytes, of the document
+/// @param Document The document
+/// @param Parser   On output, the parser with the document tree, which must be freed with XmlFree
+/// @return The document tree or NULL if the document could not be parsed
+STATIC XML_TREE *
+EFIAPI
+XmlRegressionParse (
+  IN  UINTN        Size,
+  IN  VOID        *Document,
+  OUT XML_PARSER **Parser
+) {
+  XML_TREE *Tree = NULL;
+  *Parser = NULL;
+  if (EFI_ERROR(XmlCreate(Parser))) {
+    return NULL;
+  }
+  if (EFI_ERROR(XmlParse(*Parser, Size, Document)) || EFI_ERROR(XmlGetTree(*Parser, &Tree))) {
+    return NULL;
+  }
+  return Tree;
+}
+// XmlRegressionQueryCount
+/// Count the matches of a query
+/// @param Tree The tree node where the query starts
+/// @param Path The query path
+/// @return The count of matches
+STATIC UINTN
+EFIAPI
+XmlRegressionQueryCount (
+  IN XML_TREE *Tree,
+  IN CHAR16   *Path
+) {
+  XML_QUERY *Query = NULL;
+  UINTN      Count = 0;
+  if (EFI_ERROR(XmlQueryCompile(Path, &Query))) {
+    return (UINTN)-1;
+  }
+  XmlQuerySelect(Query, Tree, &Count, NULL);
+  XmlQueryFree(Query);
+  return Count;
+}
+
+// XmlRegressionQuerySteps
+/// Child and descendant steps must match the same tree nodes after descendant matching became linear
+STATIC VOID
+EFIAPI
+XmlRegressionQuerySteps (
+  VOID
+) {
+  XML_PARSER *Parser;
+  XML_TREE   *Tree;
+  UINTN       Index;
+  UINTN       Count;
+  Tree = XmlRegressionParse(sizeof(mXmlRegressionDocument) - 1, mXmlRegressionDocument, &Parser);
+  REGRESSION_CHECK(Tree != NULL);
+  if (Tree != NULL) {
+    for (Index = 0; Index < ARRAY_SIZE(mXmlRegressionQueries); ++Index) {
+      Count = XmlRegressionQueryCount(Tree, mXmlRegressionQueries[Index].Path);
+      if (Count != mXmlRegressionQueries[Index].Count) {
+        HostPrint(L"  %s matched %u, expected %u\n", mXmlRegressionQueries[Index].Path, Count, mXmlRegressionQueries[Index].Count);
+      }
+      REGRESSION_CHECK(Count == mXmlRegressionQueries[Index].Count);
+    }
+  }
+  if (Parser != NULL) {
+    XmlFree(Parser);
+  }
+}
+// XmlRegressionDeepDescendants
+/// Descendant steps in a deeply nested document must not take time exponential in the count of steps
+STATIC VOID
+EFIAPI
+XmlRegressionDeepDescendants (
+  VOID
+) {
+  XML_PARSER *Parser;
+  XML_TREE   *Tree;
+  CHAR8      *Document;
+  UINTN       Index;
+  UINT64      Time;
+  UINTN       Size = sizeof(XML_REGRESSION_DECLARATION) - 1;
+  Document = (CHAR8 *)AllocatePool(Size + (XML_REGRESSION_DEPTH * 7));
+  REGRESSION_CHECK(Document != NULL);
+  if (Document == NULL) {
+    return;
+  }
+  CopyMem(Document, XML_REGRESSION_DECLARATION, Size);
+  for (Index = 0; Index < XML_REGRESSION_DEPTH; ++Index) {
+    CopyMem(Document + Size + (Index * 3), "<a>", 3);
+    CopyMem(Document + Size + (XML_REGRESSION_DEPTH * 3) + (Index * 4), "</a>", 4);
+  }
+  Tree = XmlRegressionParse(Size + (XML_REGRESSION_DEPTH * 7), Document, &Parser);
+  REGRESSION_CHECK(Tree != NULL);
+  if (Tree != NULL) {
+    Time = HostGetTime();
+    REGRESSION_CHECK(XmlRegressionQueryCount(Tree, L"//a//a//a//a//a//a//a//a") == (XML_REGRESSION_DEPTH - 7));
+    REGRESSION_CHECK(XmlRegressionQueryCount(Tree, L"//b//a//a//a//a//a//a//a") == 0);
+    // Far less than the time of one step for each path through the ancestors
+    REGRESSION_CHECK((HostGetTime() - Time) < 2000000000ULL);
+  }
+  if (Parser != NULL) {
+    XmlFree(Parser);
+  }
+  FreePool(Document);
+}
+// XmlRegressionParseBytes
+/// Parse an XML document one byte at a time
+/// @param Size     The size, in bytes, of the document
+/// @param Document The document
+/// @param Parser   On output, the parser with the document tree, which must be freed with XmlFree
+/// @return Whether the document was parsed or not
+STATIC EFI_STATUS
+EFIAPI
+XmlRegressionParseBytes (
+  IN  UINTN        Size,
+  IN  UINT8       *Document,
+  OUT XML_PARSER **Parser
+) {
+  EFI_STATUS Status;
+  UINTN      Index;
+  *Parser = NULL;
+  Status = XmlCreate(Parser);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  Status = XmlParseStart(*Parser, 1, Document);
+  for (Index = 1; !EFI_ERROR(Status) && (Index < Size); ++Index) {
+    Status = XmlParseNext(*Parser, 1, Document + Index);
+  }
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  return XmlParseFinish(*Parser);
+}
+// XmlRegressionUtf16Bytes
+/// UTF-16 documents fed one byte at a time must be detected as UTF-16 with or without a byte order mark and parse the
+///  same as the whole document, documents without a declaration are not well formed for this parser either way
+STATIC VOID
+EFIAPI
+XmlRegressionUtf16Bytes (
+  VOID
+) {
+  EFI_STATUS    Status;
+  XML_PARSER   *Parser;
+  XML_DOCUMENT *Xml;
+  XML_TREE     *Tree;
+  CHAR8        *Encoding;
+  UINT8        *Document;
+  UINTN         Size;
+  UINTN         Case;
+  BOOLEAN       Declaration;
+  for (Case = 0; Case < 8; ++Case) {
+    // Each case is a combination of big endian, byte order mark and declaration
+    Declaration = ((Case & 4) != 0);
+    Document = XmlRegressionUtf16(Declaration ? XML_REGRESSION_DECLARATION XML_REGRESSION_UTF16_BODY : XML_REGRESSION_UTF16_BODY,
+                                  ((Case & 1) != 0), ((Case & 2) != 0), &Size);
+    REGRESSION_CHECK(Document != NULL);
+    if (Document == NULL) {
+      continue;
+    }
+    // Parse the whole document
+    Tree = XmlRegressionParse(Size, Document, &Parser);
+    Status = (Tree != NULL) ? EFI_SUCCESS : EFI_LOAD_ERROR;
+    REGRESSION_CHECK((Tree != NULL) == Declaration);
+    if (Parser != NULL) {
+      XmlFree(Parser);
+    }
+    // Parse the document one byte at a time
+    Xml = NULL;
+    Tree = NULL;
+    Encoding = NULL;
+    REGRESSION_CHECK(EFI_ERROR(XmlRegressionParseBytes(Size, Document, &Parser)) == EFI_ERROR(Status));
+    if (Declaration) {
+      REGRESSION_CHECK(!EFI_ERROR(XmlGetTree(Parser, &Tree)) && (Tree != NULL));
+      if (Tree != NULL) {
+        REGRESSION_CHECK(XmlRegressionQueryCount(Tree, L"/r/a") == 2);
+        REGRESSION_CHECK(XmlRegressionQueryCount(Tree, L"//a[@id='2']") == 1);
+      }
+    }
+    REGRESSION_CHECK(!EFI_ERROR(XmlGetDocument(Parser, &Xml)) && !EFI_ERROR(XmlDocumentGetEncoding(Xml, &Encoding)) &&
+                     (Encoding != NULL) && (AsciiStrCmp(Encoding, ((Case & 1) != 0) ? "UTF-16BE" : "UTF-16LE") == 0));
+    if (Parser != NULL) {
+      XmlFree(Parser);
+    }
+    FreePool(Document);
+  }
+}
+
+// XmlRegressionIsAttribute
+/// Check an attribute value
+/// @param Tree     The tree node with the attribute
+/// @param Name     The attribute name
+/// @param Expected The expected attribute value
+/// @return Whether the attribute has the expected value or not
+STATIC BOOLEAN
+EFIAPI
+XmlRegressionIsAttribute (
+  IN XML_TREE *Tree,
+  IN CHAR16   *Name,
+  IN CHAR16   *Expected
+) {
+  XML_ATTRIBUTE *Attribute = NULL;
+  return (!EFI_ERROR(XmlTreeGetAttribute(Tree, Name, &Attribute)) && (Attribute != NULL) &&
+          (Attribute->Value != NULL) && (StrCmp(Attribute->Value, Expected) == 0));
+}
+// XmlRegressionLongAttribute
+/// An attribute value appended from many text and entity pieces must keep every piece, parsed whole or one byte at a time,
+///  and the length of the value must start again for the next attribute
+STATIC VOID
+EFIAPI
+XmlRegressionLongAttribute (
+  VOID
+) {
+  XML_PARSER *Parser;
+  XML_TREE   *Tree;
+  XML_TREE   *Child;
+  CHAR8      *Document;
+  CHAR16     *Expected;
+  UINTN       Size;
+  UINTN       Index;
+  UINTN       Pass;
+  // Each piece is text followed by an entity reference
+  Size = sizeof(XML_REGRESSION_DECLARATION "<r><a v=\"") - 1;
+  Document = (CHAR8 *)AllocatePool(Size + (XML_REGRESSION_ATTRIBUTE_PIECES * 7) + sizeof("\" w=\"z\"/><b v=\"q&lt;\"/></r>"));
+  Expected = (CHAR16 *)AllocatePool(((XML_REGRESSION_ATTRIBUTE_PIECES * 3) + 1) * sizeof(CHAR16));
+  REGRESSION_CHECK((Document != NULL) && (Expected != NULL));
+  if ((Document == NULL) || (Expected == NULL)) {
+    if (Document != NULL) {
+      FreePool(Document);
+    }
+    if (Expected != NULL) {
+      FreePool(Expected);
+    }
+    return;
+  }
+  CopyMem(Document, XML_REGRESSION_DECLARATION "<r><a v=\"", Size);
+  for (Index = 0; Index < XML_REGRESSION_ATTRIBUTE_PIECES; ++Index) {
+    CopyMem(Document + Size, "ab&amp;", 7);
+    Size += 7;
+    Expected[(Index * 3)] = L'a';
+    Expected[(Index * 3) + 1] = L'b';
+    Expected[(Index * 3) + 2] = L'&';
+  }
+  Expected[XML_REGRESSION_ATTRIBUTE_PIECES * 3] = L'\0';
+  CopyMem(Document + Size, "\" w=\"z\"/><b v=\"q&lt;\"/></r>", sizeof("\" w=\"z\"/><b v=\"q&lt;\"/></r>") - 1);
+  Size += sizeof("\" w=\"z\"/><b v=\"q&lt;\"/></r>") - 1;
+  for (Pass = 0; Pass < 2; ++Pass) {
+    Tree = NULL;
+    if (Pass == 0) {
+      Tree = XmlRegressionParse(Size, Document, &Parser);
+    } else if (EFI_ERROR(XmlRegressionParseBytes(Size, (UINT8 *)Document, &Parser)) || EFI_ERROR(XmlGetTree(Parser, &Tree))) {
+      Tree = NULL;
+    }
+    REGRESSION_CHECK(Tree != NULL);
+    if (Tree != NULL) {
+      Child = NULL;
+      REGRESSION_CHECK(!EFI_ERROR(XmlTreeGetFirstChild(Tree, &Child)) && (Child != NULL));
+      if (Child != NULL) {
+        REGRESSION_CHECK(XmlRegressionIsAttribute(Child, L"v", Expected));
+        REGRESSION_CHECK(XmlRegressionIsAttribute(Child, L"w", L"z"));
+        REGRESSION_CHECK(!EFI_ERROR(XmlTreeGetNextSibling(Child, &Child)) && (Child != NULL) && XmlRegressionIsAttribute(Child, L"v", L"q<"));
+      }
+    }
+    if (Parser != NULL) {
+      XmlFree(Parser);
+    }
+  }
+  FreePool(Expected);
+  FreePool(Document);
+}
+
+// XmlRegressionSerializeIndented
+/// Serializing with indentation must not add whitespace to the values of tree nodes with mixed content, so the document
+///  parsed again serializes the same as the original without indentation
+STATIC VOID
+EFIAPI
+XmlRegressionSerializeIndented (
+  VOID
+) {
+  XML_PARSER   *Parser;
+  XML_PARSER   *Reparsed = NULL;
+  XML_DOCUMENT *Document = NULL;
+  VOID         *Indented = NULL;
+  VOID         *Original = NULL;
+  VOID         *Again = NULL;
+  UINTN         IndentedSize = 0;
+  UINTN         OriginalSize = 0;
+  UINTN         AgainSize = 0;
+  if (XmlRegressionParse(sizeof(mXmlRegressionMixed) - 1, mXmlRegressionMixed, &Parser) != NULL) {
+    REGRESSION_CHECK(!EFI_ERROR(XmlGetDocument(Parser, &Document)) && (Document != NULL));
+    REGRESSION_CHECK(!EFI_ERROR(XmlDocumentSerializeToBuffer(Document, NULL, 0, &OriginalSize, &Original)));
+    REGRESSION_CHECK(!EFI_ERROR(XmlDocumentSerializeToBuffer(Document, NULL, 2, &IndentedSize, &Indented)));
+    // The tree nodes without values are still formatted
+    REGRESSION_CHECK((Indented != NULL) && (IndentedSize > OriginalSize));
+    if (Indented != NULL) {
+      Document = NULL;
+      REGRESSION_CHECK(XmlRegressionParse(IndentedSize, Indented, &Reparsed) != NULL);
+      REGRESSION_CHECK(!EFI_ERROR(XmlGetDocument(Reparsed, &Document)) && (Document != NULL));
+      REGRESSION_CHECK(!EFI_ERROR(XmlDocumentSerializeToBuffer(Document, NULL, 0, &AgainSize, &Again)));
+      REGRESSION_CHECK((Original != NULL) && (Again != NULL) && (AgainSize == OriginalSize) && (CompareMem(Again, Original, OriginalSize) == 0));
+    }
+  } else {
+    REGRESSION_CHECK(FALSE);
+  }
+  if (Again != NULL) {
+    FreePool(Again);
+  }
+  if (Original != NULL) {
+    FreePool(Original);
+  }
+  if (Indented != NULL) {
+    FreePool(Indented);
+  }
+  if (Reparsed != NULL) {
+    XmlFree(Reparsed);
+  }
+  if (Parser != NULL) {
+    XmlFree(Parser);
+  }
+}
+
+// XmlRegressionEntities
+/// The XML entities and the non-breaking space must resolve in any case, the non-breaking space to a space, and the
+///  HTML entities must resolve only in their own case
+STATIC VOID
+EFIAPI
+XmlRegressionEntities (
+  VOID
+) {
+  XML_PARSER *Parser;
+  XML_TREE   *Tree;
+  XML_TREE   *Child = NULL;
+  CHAR16     *Value = NULL;
+  Tree = XmlRegressionParse(sizeof(mXmlRegressionEntities) - 1, mXmlRegressionEntities, &Parser);
+  REGRESSION_CHECK(Tree != NULL);
+  if ((Tree != NULL) && !EFI_ERROR(XmlTreeGetFirstChild(Tree, &Child)) && (Child != NULL)) {
+    REGRESSION_CHECK(!EFI_ERROR(XmlTreeGetValue(Child, &Value)) && (Value != NULL) && (StrCmp(Value, L"&<>\"\' x y") == 0));
+    Value = NULL;
+    REGRESSION_CHECK(!EFI_ERROR(XmlTreeGetNextSibling(Child, &Child)) && (Child != NULL) &&
+                     !EFI_ERROR(XmlTreeGetValue(Child, &Value)) && (Value != NULL) && (StrCmp(Value, L"\x00C1\x00E1") == 0));
+    REGRESSION_CHECK(!EFI_ERROR(XmlTreeGetNextSibling(Child, &Child)) && (Child != NULL) && XmlRegressionIsAttribute(Child, L"v", L"< "));
+  } else {
+    REGRESSION_CHECK(FALSE);
+  }
+  if (Parser != NULL) {
+    XmlFree(Parser);
+  }
+  // An HTML entity in another case is not an entity
+  Tree = XmlRegressionParse(sizeof(XML_REGRESSION_DECLARATION "<r>&AACUTE;</r>") - 1, XML_REGRESSION_DECLARATION "<r>&AACUTE;</r>", &Parser);
+  Value = NULL;
+  REGRESSION_CHECK((Tree == NULL) || EFI_ERROR(XmlTreeGetValue(Tree, &Value)) || (Value == NULL) || (StrCmp(Value, L"\x00C1") != 0));
+  if (Parser != NULL) {
+    XmlFree(Parser);
+  }
+}
+
+// XmlRegressionRun
+/// Run the XML library regression tests
+STATIC VOID
+EFIAPI
+XmlRegressionRun (
+  VOID
+) {
+  XmlRegressionQuerySteps();
+  XmlRegressionDeepDescendants();
+  XmlRegressionUtf16Bytes();
+  XmlRegressionLongAttribute();
+  XmlRegressionSerializeIndented();
+  XmlRegressionEntities();
+}
+
+REGRESSION_MAIN("XmlRegression", XmlRegressionRun)